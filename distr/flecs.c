@@ -7,6 +7,12 @@
 #ifndef _POSIX_C_SOURCE
 #define _POSIX_C_SOURCE 200809L
 #endif
+#ifdef FLECS_HUGE_PAGES
+/* Exposes mmap flags and madvise, used to allocate huge pages */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#endif
 #endif
 
 #include <ctype.h>
@@ -200,9 +206,16 @@ typedef struct ecs_entity_index_page_t {
     ecs_record_t records[FLECS_ENTITY_PAGE_SIZE];
 } ecs_entity_index_page_t;
 
+/* Array that was replaced while the index was shared between threads */
+typedef struct ecs_entity_index_retired_t {
+    void *array;
+    ecs_size_t size;                 /* Size of array in bytes */
+} ecs_entity_index_retired_t;
+
 typedef struct ecs_entity_index_t {
     ecs_vec_t dense;
     ecs_vec_t pages;
+    ecs_vec_t retired;               /* vec<ecs_entity_index_retired_t> */
     ecs_vec_t ranges;                /* vec<ecs_entity_range_t*> - sorted by min */
     ecs_entity_range_t *active_range;       /* Currently active range (NULL = off) */
     int32_t alive_count;
@@ -249,6 +262,17 @@ void flecs_entity_index_remove(
     ecs_entity_index_t *index,
     uint64_t entity);
 
+/* Make entity not alive without increasing its generation. Used for ids that
+ * were made alive, but that were never handed out to the application. */
+void flecs_entity_index_release(
+    ecs_entity_index_t *index,
+    uint64_t entity);
+
+/* Prefetch record for entity, if it exists */
+void flecs_entity_index_prefetch(
+    const ecs_entity_index_t *index,
+    uint64_t entity);
+
 /* Make entity alive */
 void flecs_entity_index_make_alive(
     ecs_entity_index_t *index,
@@ -283,6 +307,19 @@ uint64_t* flecs_entity_index_new_ids(
     ecs_entity_index_t *index,
     int32_t count);
 
+/* Grow index so that count ids can be created without reallocating the
+ * dense and page arrays. When shared is true, other threads may be reading the
+ * index, and arrays are copied instead of reallocated. The old arrays are freed
+ * by flecs_entity_index_free_retired(). */
+void flecs_entity_index_reserve(
+    ecs_entity_index_t *index,
+    int32_t count,
+    bool shared);
+
+/* Free arrays that were replaced while the index was shared */
+void flecs_entity_index_free_retired(
+    ecs_entity_index_t *index);
+
 /* Set size of index */
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
@@ -331,6 +368,8 @@ const uint64_t* flecs_entity_index_ids(
 #define flecs_entities_get_any(world, entity) flecs_entity_index_get_any(ecs_eis(world), entity)
 #define flecs_entities_ensure(world, entity) flecs_entity_index_ensure(ecs_eis(world), entity)
 #define flecs_entities_remove(world, entity) flecs_entity_index_remove(ecs_eis(world), entity)
+#define flecs_entities_prefetch(world, entity) flecs_entity_index_prefetch(ecs_eis(world), entity)
+#define flecs_entities_release(world, entity) flecs_entity_index_release(ecs_eis(world), entity)
 #define flecs_entities_make_alive(world, entity) flecs_entity_index_make_alive(ecs_eis(world), entity)
 #define flecs_entities_get_alive(world, entity) flecs_entity_index_get_alive(ecs_eis(world), entity)
 #define flecs_entities_is_alive(world, entity) flecs_entity_index_is_alive(ecs_eis(world), entity)
@@ -338,6 +377,8 @@ const uint64_t* flecs_entity_index_ids(
 #define flecs_entities_exists(world, entity) flecs_entity_index_exists(ecs_eis(world), entity)
 #define flecs_entities_new_id(world) flecs_entity_index_new_id(ecs_eis(world))
 #define flecs_entities_new_ids(world, count) flecs_entity_index_new_ids(ecs_eis(world), count)
+#define flecs_entities_reserve(world, count, shared) flecs_entity_index_reserve(ecs_eis(world), count, shared)
+#define flecs_entities_free_retired(world) flecs_entity_index_free_retired(ecs_eis(world))
 #define flecs_entities_max_id(world) (ecs_eis(world)->max_id)
 #define flecs_entities_set_size(world, size) flecs_entity_index_set_size(ecs_eis(world), size)
 #define flecs_entities_count(world) flecs_entity_index_count(ecs_eis(world))
@@ -426,10 +467,22 @@ typedef struct ecs_reachable_elem_t {
 #endif
 } ecs_reachable_elem_t;
 
+/* Source of a component found by up traversal, starting from the target of a
+ * pair record. */
+typedef struct ecs_reachable_up_t {
+    ecs_id_t with;                  /* Component that was searched for */
+    ecs_id_t rel;                   /* Traversed relationship, (R, *) */
+    ecs_entity_t src;               /* Entity with component, 0 if not found */
+    ecs_id_t id;                    /* Matched id on source */
+    ecs_table_record_t *tr;         /* Table record of id in source table */
+} ecs_reachable_up_t;
+
 typedef struct ecs_reachable_cache_t {
     int32_t generation;
     int32_t current;
+    int32_t up_current;             /* Generation for which up index is valid */
     ecs_vec_t ids; /* vec<reachable_elem_t> */
+    ecs_vec_t up;  /* vec<reachable_up_t> */
 } ecs_reachable_cache_t;
 
 /* Component index data that just applies to pairs */
@@ -658,6 +711,42 @@ typedef struct ecs_graph_node_t {
     ecs_graph_edge_hdr_t refs;
 } ecs_graph_node_t;
 
+/* Number of sets and ways of the table graph transition cache */
+#define FLECS_GRAPH_CACHE_SETS (128)
+#define FLECS_GRAPH_CACHE_WAYS (4)
+
+/* Transition that adds multiple ids at once */
+typedef struct ecs_graph_multi_edge_t {
+    ecs_table_t *to;                 /* Destination table */
+    ecs_table_diff_t diff;           /* Combined diff of the individual edges */
+    ecs_type_t ids;                  /* Added ids */
+} ecs_graph_multi_edge_t;
+
+/* Element in transition cache */
+typedef struct ecs_graph_cache_elem_t {
+    uint64_t table;                  /* Source table id (includes generation) */
+    uint64_t key;                    /* Id, or hash of ids for multi edges */
+    uint32_t epoch;                  /* Cache epoch at which elem was stored */
+    int32_t kind;                    /* Add, remove or multi add (0 if unused) */
+    union {
+        ecs_graph_edge_t *edge;
+        ecs_graph_multi_edge_t *multi;
+    } is;
+} ecs_graph_cache_elem_t;
+
+/* Set associative cache for table transitions. Lookups for ids that don't use
+ * the low edge array of a table otherwise require a map lookup per transition.
+ * 
+ * Elements are only written while the world is not readonly, as that's also
+ * when edges are created. Lookups don't modify the cache, which means that
+ * threads can read it concurrently while the world is readonly. When an edge 
+ * is removed or its diff changes, the epoch is incremented which invalidates
+ * all existing elements. */
+typedef struct ecs_graph_cache_t {
+    ecs_graph_cache_elem_t *elems;   /* FLECS_GRAPH_CACHE_SETS * WAYS elems */
+    uint32_t epoch;
+} ecs_graph_cache_t;
+
 /** Add to existing type */
 void flecs_type_add(
     ecs_world_t *world,
@@ -721,6 +810,31 @@ ecs_table_t* flecs_find_table_add(
     ecs_id_t id,
     ecs_table_diff_builder_t *diff);
 
+/* Find table by adding multiple ids to current table. The transition is cached
+ * as a single edge, so that adding the same ids again only requires a single 
+ * lookup. */
+ecs_table_t* flecs_find_table_add_ids(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    const ecs_id_t *ids,
+    int32_t count,
+    ecs_table_diff_builder_t *diff);
+
+/* Find existing add edge without creating it. This doesn't modify the table 
+ * graph or transition cache, and is safe to call from multiple threads while
+ * the world is readonly. Returns NULL if the edge doesn't exist. */
+const ecs_graph_edge_t* flecs_table_find_add_edge(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    ecs_id_t id);
+
+/* Init and fini transition cache */
+void flecs_graph_cache_init(
+    ecs_world_t *world);
+
+void flecs_graph_cache_fini(
+    ecs_world_t *world);
+
 void flecs_table_hashmap_init(
     ecs_world_t *world,
     ecs_hashmap_t *hm);
@@ -732,6 +846,9 @@ void flecs_table_clear_edges_for_id(
 
 #endif
 
+/* Maximum value for ecs_set_column_alignment() */
+#define FLECS_MAX_COLUMN_ALIGNMENT (4096)
+
 #ifdef FLECS_SANITIZE
 #define ecs_vec_from_column(arg_column, table, arg_elem_size) {\
     .array = (arg_column)->data,\
@@ -829,6 +946,10 @@ typedef struct ecs_table__t {
 
     int16_t bs_count;
     int16_t bs_offset;
+    int16_t column_alignment;        /* Minimum alignment of column storage */
+    int16_t dense_toggle;            /* Bitset column of dense toggle */
+    int32_t dense_toggle_count;      /* Enabled rows of dense toggle, -1 if rows
+                                      * are not partitioned. */
     ecs_bitset_t *bs_columns;        /* Bitset columns */
 
     struct ecs_table_record_t *records; /* Array with table records */
@@ -936,18 +1057,33 @@ void flecs_table_move(
     ecs_id_t emplace_id);
 
 /* Grow table with specified number of records. Populate table with the
- * specified entity ids. */
+ * specified entity ids. If construct is false, the new elements are neither
+ * constructed nor passed to OnAdd hooks, which is then up to the caller. */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
     ecs_table_t *table,
     int32_t count,
-    const ecs_entity_t *ids);
+    const ecs_entity_t *ids,
+    bool construct);
+
+/* Invoke OnAdd hooks for elements that were appended without constructing */
+void flecs_table_invoke_on_add(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count);
 
 /* Shrink table to contents */
 bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Shrink table storage to size, which must not be less than the table count */
+bool flecs_table_shrink_to(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size);
+
 /* Get dirty state for table columns */
 int32_t* flecs_table_get_dirty_state(
     ecs_world_t *world,
@@ -998,6 +1134,25 @@ ecs_bitset_t* flecs_table_get_toggle(
     ecs_table_t *table,
     ecs_id_t id);
 
+/* Move row to the enabled or disabled rows of a table with a dense toggle,
+ * depending on the value of its toggle bit. Partitions the entire table if the
+ * rows are not partitioned. */
+void flecs_table_dense_toggle_sync(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row);
+
+/* Mark rows of table with dense toggle as not partitioned */
+void flecs_table_dense_toggle_invalidate(
+    ecs_table_t *table);
+
+/* Prepare deleting a row from a table with a dense toggle. Returns the row that
+ * contains the deleted entity after preserving the partition. */
+int32_t flecs_table_dense_toggle_delete(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row);
+
 ecs_id_t flecs_column_id(
     ecs_table_t *table,
     int32_t column_index);
@@ -1546,14 +1701,36 @@ typedef struct {
     int32_t first_to_eval;
 } ecs_query_trivial_ctx_t;
 
+/* Partition of the tables found by an uncached query. Worker iterators use a
+ * partition to only evaluate a query for the tables of the worker. */
+typedef struct ecs_query_partition_t {
+    int32_t *cursor;            /* Shared table counter (dynamic partition) */
+    int32_t index;              /* Index of worker (static partition) */
+    int32_t count;              /* Number of workers (static partition) */
+    int32_t table;              /* Number of tables found by partitioned op */
+    int32_t claimed;            /* Last claimed table (dynamic partition) */
+    ecs_query_lbl_t op;         /* Partitioned op, -1 for trivial iterator */
+} ecs_query_partition_t;
+
 /* Trivial sparse iterator context */
 #define FLECS_QUERY_SPARSE_BATCH_SIZE (1024)
 
+/* Number of elements ahead of the iterated element that are prefetched */
+#define FLECS_QUERY_SPARSE_PREFETCH (8)
+
 typedef struct {
     ecs_sparse_t **sparse;
     ecs_entity_t *entities;
     int32_t cur;
+    int32_t end;                /* End of the iterated range in dense array */
     int8_t lead;
+
+    /* Worker partitioning of the dense array of the lead component. Set by
+     * worker iterators before iteration starts. */
+    int32_t worker_index;
+    int32_t worker_count;
+    int32_t *cursor;            /* Shared chunk counter (dynamic) */
+    int32_t chunk_size;
 } ecs_query_sparse_trivial_ctx_t;
 
 /* *From operator iterator context */
@@ -1701,6 +1878,13 @@ int flecs_query_compile(
     ecs_stage_t *stage,
     ecs_query_impl_t *query);
 
+/* Estimate the number of tables matched by a term. Returns -1 if the term can't
+ * be reordered by the cost based planner. */
+int32_t flecs_query_term_cost(
+    const ecs_world_t *world,
+    const ecs_query_t *q,
+    const ecs_term_t *term);
+
 /* Compile single term */
 int flecs_query_compile_term(
     ecs_world_t *world,
@@ -2287,6 +2471,28 @@ bool flecs_query_trivial_sparse_search(
     const ecs_query_run_ctx_t *ctx,
     bool redo);
 
+/* Let a trivial sparse iterator only return the results for a worker. Returns
+ * false if the iterator can't be split up. */
+bool flecs_query_trivial_sparse_split(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor,
+    int32_t chunk_size);
+
+/* Let an uncached query iterator only find the tables for a worker. Returns 
+ * false if the iterator can't be partitioned. */
+bool flecs_query_partition_init(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor);
+
+/* Advance partition to the next table found by the partitioned operation.
+ * Returns true if the table belongs to another worker. */
+bool flecs_query_partition_skip(
+    ecs_query_partition_t *partition);
+
 /* Hierarchy evaluation */
 
 const EcsParent* flecs_query_tree_get_parents(
@@ -2925,6 +3131,17 @@ void flecs_enqueue(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_event_desc_t *desc);
+
+/* Partition commands in stage queue by entity for parallel merge. */
+void flecs_commands_partition(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t partition_count);
+
+/* Move component values of commands in partition into component storage. */
+void flecs_commands_merge_partition(
+    ecs_world_t *world,
+    int32_t partition);
  
 #endif
 
@@ -2959,6 +3176,13 @@ flecs_component_ptr_t flecs_get_mut(
     ecs_record_t *r,
     ecs_size_t size);
 
+/* Mark component returned by ensure/get_mut as changed if the world has 
+ * forks, as the value can be written without calling modified. */
+void flecs_mark_dirty_if_forked(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_id_t component);
+
 /* Get component pointer. */
 void* flecs_get_component(
     const ecs_world_t *world,
@@ -2979,6 +3203,7 @@ const ecs_entity_t* flecs_bulk_new(
     int32_t count,
     void **c_info,
     bool move,
+    bool parallel,
     int32_t *row_out,
     ecs_table_diff_t *diff);
 
@@ -3169,6 +3394,9 @@ typedef struct ecs_observer_impl_t {
     ecs_query_t *not_query;     /**< Query used to populate observer data when a
                                      term with a not operator triggers. */
 
+    ecs_map_t coalesced;        /**< Events stored by coalesced observer, 
+                                     map<entity, event flags> */
+
     /* Mixins */
     flecs_poly_dtor_t dtor;
 } ecs_observer_impl_t;
@@ -3481,12 +3709,22 @@ struct ecs_stage_t {
     ecs_commands_t *cmd;
     ecs_commands_t cmd_stack[2];     /* Two so we can flush one & populate the other */
     bool cmd_flushing;               /* Ensures only one defer_end call flushes */
+    bool cmd_merge_serial;           /* Queue can't be merged in parallel */
+    int32_t cmd_merged_count;        /* Commands merged in parallel by stage */
+    ecs_vec_t cmd_partitions;        /* vec<vec<int32_t>> commands by partition */
 
     /* Thread context */
     ecs_world_t *thread_ctx;         /* Points to stage when used as a thread stage */
     ecs_world_t *world;              /* Reference to world */
     ecs_os_thread_t thread;          /* Thread handle (0 if no threading is used) */
 
+    /* Block of entity ids claimed from the entity index to create entities in
+     * multithreaded mode, and entities created from them that must be added to
+     * the root table when the stage is merged. */
+    ecs_vec_t reserved_ids;
+    int32_t reserved_cur;
+    ecs_vec_t new_ids;
+
     /* One-shot actions to be executed after the merge */
     ecs_vec_t post_frame_actions;
 
@@ -3523,6 +3761,21 @@ ecs_entity_t flecs_stage_set_system(
     ecs_stage_t *stage,
     ecs_entity_t system);
 
+/* Defer operations on all stages and enter multithreaded mode, so that a job
+ * can invoke operations on the stages of worker threads while the world is not
+ * in readonly mode. */
+void flecs_stage_job_begin(
+    ecs_world_t *world);
+
+/* Leave multithreaded mode and merge the stages. */
+void flecs_stage_job_end(
+    ecs_world_t *world);
+
+/* Create entity id in multithreaded mode. */
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
 /* Get allocator from stage/world. */
 ecs_allocator_t* flecs_stage_get_allocator(
     ecs_world_t *world);
@@ -3595,6 +3848,9 @@ typedef struct ecs_store_t {
     /* Root table */
     ecs_table_t root;
 
+    /* Cache for table graph transitions */
+    ecs_graph_cache_t graph_cache;
+
     /* Records cache */
     ecs_vec_t records;
 
@@ -3615,6 +3871,14 @@ typedef struct ecs_action_elem_t {
 
 typedef struct ecs_pipeline_state_t ecs_pipeline_state_t;
 
+/* Job that worker threads run instead of the pipeline. Each thread is passed
+ * its stage index, so that the job can split up the work. */
+typedef void (*flecs_worker_job_t)(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx);
+
 /** The world stores and manages all ECS data. An application can have more than
  * one world, but data is not shared between worlds. */
 struct ecs_world_t {
@@ -3703,12 +3967,25 @@ struct ecs_world_t {
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
     ecs_os_cond_t sync_cond;         /* Signal that worker thread job is done */
+    ecs_os_cond_t barrier_cond;      /* Signal that threads passed a barrier */
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t barrier_waiting;         /* Number of threads waiting on barrier */
+    int32_t barrier_generation;      /* Number of barriers passed */
+    int32_t workers_epoch;           /* Number of times workers were signaled */
+    int32_t worker_spin_count;       /* Iterations to poll before yielding */
+    int32_t worker_yield_count;      /* Iterations to yield before blocking */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
+    flecs_worker_job_t worker_job;   /* Job for the workers to execute, if set */
+    void *worker_job_ctx;            /* Context passed to worker job */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
 
+    /* Entity ids that stages create in multithreaded mode */
+    ecs_os_mutex_t reserved_mutex;   /* Mutex for claiming ids from entity index */
+    int32_t reserved_count;          /* Ids to reserve entity index storage for */
+    int32_t reserved_used;           /* Ids used during multithreaded phase */
+
     /* -- Exclusive access -- */
     ecs_os_thread_id_t exclusive_access; /* If set, world can only be mutated by thread */
     const char *exclusive_thread_name;   /* Name of thread with exclusive access (used for debugging) */
@@ -3727,9 +4004,24 @@ struct ecs_world_t {
     /* -- Default query flags -- */
     ecs_flags32_t default_query_flags;
 
+    /* -- Minimum alignment of component columns in new tables -- */
+    int32_t column_alignment;
+
     /* Count that increases when component monitors change */
     int32_t monitor_generation;
 
+    /* Number of forks that weren't freed yet. While forks exist, values of
+     * components returned by ensure/get_mut are marked as changed. */
+    int32_t fork_count;
+
+    /* -- Incremental compaction -- */
+    struct {
+        ecs_compact_desc_t desc;     /* Settings for compaction at end of frame */
+        bool enabled;                /* Compact at end of frame */
+        int32_t phase;               /* Phase of current compaction pass */
+        int32_t offset;              /* Position in current phase */
+    } compact;
+
     /* -- Allocators -- */
     ecs_world_allocators_t allocators; /* Static allocation sizes */
     ecs_allocator_t allocator;       /* Dynamic allocation sizes */
@@ -3743,6 +4035,20 @@ struct ecs_world_t {
     ecs_vec_t fini_actions;          /* Callbacks to execute when world exits */
 };
 
+/* Run job on main thread and worker threads outside of a pipeline. Returns
+ * false without running the job if the world has no idle worker threads. */
+bool flecs_workers_run(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx);
+
+/* Same as flecs_workers_run, but operations invoked by the job on the stage of
+ * a thread are deferred, and merged after the job has finished. */
+bool flecs_workers_run_deferred(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx);
+
 /* Get current stage. */
 ecs_stage_t* flecs_stage_from_world(
     ecs_world_t **world_ptr);
@@ -4061,6 +4367,13 @@ uint64_t flecs_ito_(
 #define flecs_itoi16(value) flecs_ito(int16_t, (value))
 #define flecs_itoi32(value) flecs_ito(int32_t, (value))
 
+/* Hint to the CPU that memory will be read soon */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_prefetch(ptr) __builtin_prefetch(ptr)
+#else
+#define flecs_prefetch(ptr) (void)(ptr)
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Utilities
 ////////////////////////////////////////////////////////////////////////////////
@@ -4274,6 +4587,11 @@ bool flecs_set_id_flag(
             flecs_component_record_init_exclusive(world, cr);
         }
 
+        if (flag == EcsIdSoA) {
+            /* SoA components don't have a column of their own */
+            flecs_component_set_type_info(world, cr, NULL);
+        }
+
         return true;
     }
 
@@ -5147,6 +5465,8 @@ void flecs_bootstrap(
     flecs_bootstrap_trait(world, EcsOnInstantiate);
     flecs_bootstrap_trait(world, EcsSparse);
     flecs_bootstrap_trait(world, EcsDontFragment);
+    flecs_bootstrap_trait(world, EcsSoA);
+    flecs_bootstrap_trait(world, EcsDenseToggle);
 
     flecs_bootstrap_tag(world, EcsRemove);
     flecs_bootstrap_tag(world, EcsDelete);
@@ -5287,6 +5607,16 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t dense_toggle_trait = { EcsIdDenseToggle, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsDenseToggle }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &dense_toggle_trait,
+        .global_observer = true
+    });
+
     static ecs_on_trait_ctx_t with_trait = { EcsIdWith, 0 };
     ecs_observer(world, {
         .query.terms = {
@@ -5309,6 +5639,16 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t soa_trait = { EcsIdSoA, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsSoA }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &soa_trait,
+        .global_observer = true
+    });
+
     static ecs_on_trait_ctx_t dont_fragment_trait = { EcsIdDontFragment, 0 };
     ecs_observer(world, {
         .query.terms = {{ .id = EcsDontFragment }},
@@ -5412,6 +5752,9 @@ void flecs_bootstrap(
 
     /* DontFragment components are always sparse */
     ecs_add_pair(world, EcsDontFragment, EcsWith, EcsSparse);
+
+    /* DenseToggle components can be toggled */
+    ecs_add_pair(world, EcsDenseToggle, EcsWith, EcsCanToggle);
     
     /* Modules are singletons */
     ecs_add_pair(world, EcsModule, EcsWith, EcsSingleton);
@@ -5422,6 +5765,7 @@ void flecs_bootstrap(
     ecs_add_pair(world, EcsOnDelete, EcsOnInstantiate, EcsDontInherit);
     ecs_add_pair(world, EcsExclusive, EcsOnInstantiate, EcsDontInherit);
     ecs_add_pair(world, EcsDontFragment, EcsOnInstantiate, EcsDontInherit);
+    ecs_add_pair(world, EcsSoA, EcsOnInstantiate, EcsDontInherit);
 
     /* Acyclic/Traversable components */
     ecs_add_id(world, EcsIsA, EcsTraversable);
@@ -5893,6 +6237,14 @@ void* flecs_defer_ensure(
         "bad size for component in ensure");
 
     ecs_table_t *table = r->table;
+
+    /* If the world has forks, return a copy of an existing value so that the
+     * column is marked as changed when the value is merged. */
+    void *existing = world->fork_count ? ptr.ptr : NULL;
+    if (existing) {
+        ptr.ptr = NULL;
+    }
+
     if (!ptr.ptr) {
         ecs_stack_t *stack = &stage->cmd->stack;
         cmd->kind = EcsCmdEnsure;
@@ -5901,8 +6253,8 @@ void* flecs_defer_ensure(
             flecs_stack_alloc(stack, size, ti->alignment);
 
         /* Check if entity inherits component */
-        void *base = NULL;
-        if (table && (table->flags & EcsTableHasIsA)) {
+        void *base = existing;
+        if (!base && table && (table->flags & EcsTableHasIsA)) {
             ecs_component_record_t *cr = flecs_components_get(world, id);
             base = flecs_get_base_component(world, table, id, cr, 0);
         }
@@ -5911,7 +6263,7 @@ void* flecs_defer_ensure(
             /* Normal ctor */
             flecs_type_info_ctor(ptr.ptr, 1, ti);
         } else {
-            /* Override */
+            /* Override, or copy of existing value */
             flecs_type_info_copy_ctor(ptr.ptr, base, 1, ti);
         }
     } else {
@@ -6508,6 +6860,7 @@ void flecs_cmd_batch_for_entity(
                         cmd->kind = EcsCmdModified;
                     } else {
                         /* If this was an ensure, nothing's left to be done */
+                        flecs_mark_dirty_if_forked(world, r->table, cmd->id);
                         cmd->kind = EcsCmdSkip;
                     }
                 } else {
@@ -6837,6 +7190,357 @@ bool flecs_defer_end(
     return false;
 }
 
+/* Test if there are observers for an id for any of the builtin events. */
+static
+bool flecs_cmd_observers_exist(
+    ecs_world_t *world,
+    ecs_id_t id)
+{
+    const ecs_observable_t *o = &world->observable;
+    return flecs_observers_exist(o, id, EcsOnAdd) ||
+        flecs_observers_exist(o, id, EcsOnRemove) ||
+        flecs_observers_exist(o, id, EcsOnSet) ||
+        flecs_observers_exist(o, id, EcsWildcard);
+}
+
+/* Test if an id is matched by observers for wildcard ids. These don't set the
+ * observer flags on the component record of the id itself. */
+static
+bool flecs_cmd_wildcard_observers_exist(
+    ecs_world_t *world,
+    ecs_id_t id)
+{
+    if (flecs_cmd_observers_exist(world, EcsAny)) {
+        return true;
+    }
+
+    if (ECS_IS_PAIR(id)) {
+        return flecs_cmd_observers_exist(world, 
+                ecs_pair(EcsWildcard, ECS_PAIR_SECOND(id))) ||
+            flecs_cmd_observers_exist(world, 
+                ecs_pair(ECS_PAIR_FIRST(id), EcsWildcard)) ||
+            flecs_cmd_observers_exist(world, 
+                ecs_pair(EcsWildcard, EcsWildcard));
+    }
+
+    return flecs_cmd_observers_exist(world, EcsWildcard);
+}
+
+/* Test if merging a command can invoke hooks or observers. These can read and
+ * write any component of any entity, so values may only be moved into storage
+ * before the (serial) merge if no command has side effects. */
+static
+bool flecs_cmd_has_side_effects(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    switch(cmd->kind) {
+    case EcsCmdSkip:
+        return false;
+    case EcsCmdClone:
+    case EcsCmdBulkNew:
+    case EcsCmdPath:
+    case EcsCmdDelete:
+    case EcsCmdClear:
+    case EcsCmdOnDeleteAction:
+    case EcsCmdEvent:
+        return true;
+    case EcsCmdSet:
+    case EcsCmdEnsure:
+    case EcsCmdAdd:
+    case EcsCmdAddModified:
+    case EcsCmdRemove:
+    case EcsCmdModified:
+    case EcsCmdModifiedNoHook:
+    case EcsCmdSetDontFragment:
+    case EcsCmdEmplace:
+    case EcsCmdEnsureDontFragment:
+    case EcsCmdEnable:
+    case EcsCmdDisable:
+        break;
+    }
+
+    if (!cmd->id) {
+        return false;
+    }
+
+    if (flecs_cmd_wildcard_observers_exist(world, cmd->id)) {
+        return true;
+    }
+
+    ecs_component_record_t *cr = flecs_components_get(world, cmd->id);
+    if (!cr) {
+        return false;
+    }
+
+    if (cr->flags & (EcsIdHasOnAdd|EcsIdHasOnRemove|EcsIdHasOnSet)) {
+        return true;
+    }
+
+    const ecs_type_info_t *ti = cr->type_info;
+    return ti && (ti->hooks.on_add || ti->hooks.on_set || 
+        ti->hooks.on_remove || ti->hooks.on_replace);
+}
+
+void flecs_commands_partition(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t partition_count)
+{
+    ecs_allocator_t *a = &stage->allocator;
+    ecs_vec_t *partitions = &stage->cmd_partitions;
+    int32_t i, count = ecs_vec_count(partitions);
+    if (count < partition_count) {
+        ecs_vec_set_count_t(a, partitions, ecs_vec_t, partition_count);
+        for (i = count; i < partition_count; i ++) {
+            ecs_vec_init_t(a, ecs_vec_get_t(partitions, ecs_vec_t, i), 
+                int32_t, 0);
+        }
+    }
+
+    ecs_vec_t *p = ecs_vec_first_t(partitions, ecs_vec_t);
+    for (i = 0; i < partition_count; i ++) {
+        ecs_vec_clear(&p[i]);
+    }
+
+    stage->cmd_merge_serial = false;
+
+    ecs_vec_t *queue = &stage->cmd->queue;
+    ecs_cmd_t *cmds = ecs_vec_first_t(queue, ecs_cmd_t);
+    count = ecs_vec_count(queue);
+    for (i = 0; i < count; i ++) {
+        ecs_cmd_t *cmd = &cmds[i];
+        if (flecs_cmd_has_side_effects(world, cmd)) {
+            /* Hooks, observers and OnDelete actions invoked by the merge could
+             * read or write values that would already have been moved. */
+            stage->cmd_merge_serial = true;
+            return;
+        }
+
+        ecs_entity_t e = cmd->entity;
+        if (!e) {
+            continue;
+        }
+
+        /* Partition by entity index, so that all commands for an entity end 
+         * up in the same partition regardless of which stage enqueued them. */
+        int32_t index = (int32_t)((uint32_t)e % (uint32_t)partition_count);
+        ecs_vec_append_t(a, &p[index], int32_t)[0] = i;
+    }
+}
+
+/* Return component storage for a command if the entity already has the 
+ * component in a table column, so that the command doesn't change the table of
+ * the entity. */
+static
+void* flecs_cmd_merge_dst(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd,
+    const ecs_type_info_t **ti_out)
+{
+    ecs_entity_t e = cmd->entity;
+    if (!flecs_entities_is_alive(world, e)) {
+        return NULL;
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_table_t *table = r->table;
+    if (!table) {
+        return NULL;
+    }
+
+    ecs_component_record_t *cr = flecs_components_get(world, cmd->id);
+    if (!cr || (cr->flags & (EcsIdSparse|EcsIdDontFragment))) {
+        return NULL;
+    }
+
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+    if (!tr || tr->column == -1) {
+        return NULL;
+    }
+
+    ecs_column_t *column = &table->data.columns[tr->column];
+    *ti_out = column->ti;
+    return ECS_ELEM(column->data, column->ti->size, ECS_RECORD_TO_ROW(r->row));
+}
+
+/* Test if an add command doesn't change the table of the entity because it 
+ * already has the component. This uses existing edges in the table graph, which
+ * can be read concurrently while the merge runs in parallel. */
+static
+bool flecs_cmd_add_is_noop(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    if (!cmd->id || !flecs_entities_is_alive(world, e)) {
+        return false;
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_table_t *table = r->table;
+    if (!table) {
+        return false;
+    }
+
+    const ecs_graph_edge_t *edge = flecs_table_find_add_edge(
+        world, table, cmd->id);
+    return edge && (edge->to == table) && !edge->diff;
+}
+
+/* Test if command can be merged in parallel */
+static
+bool flecs_cmd_can_merge(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    const ecs_type_info_t *ti = NULL;
+    switch(cmd->kind) {
+    case EcsCmdSet:
+    case EcsCmdEnsure:
+        /* Value must be moved from the command into storage. Don't merge if 
+         * the component has an on_replace hook, as it must be invoked with the
+         * previous value before it's overwritten. */
+        if (!cmd->is._1.value) {
+            return false;
+        }
+        if (!flecs_cmd_merge_dst(world, cmd, &ti)) {
+            return false;
+        }
+        if (cmd->kind == EcsCmdEnsure && world->fork_count) {
+            /* Column must be marked as changed, which is not thread safe */
+            return false;
+        }
+        return !ti->hooks.on_replace && (ti->size == cmd->is._1.size);
+    case EcsCmdAddModified:
+        /* Value was already assigned, only check that add is a noop */
+        return flecs_cmd_merge_dst(world, cmd, &ti) != NULL;
+    case EcsCmdModified:
+    case EcsCmdModifiedNoHook:
+        return true;
+    case EcsCmdAdd:
+        return flecs_cmd_add_is_noop(world, cmd);
+    case EcsCmdClone:
+    case EcsCmdBulkNew:
+    case EcsCmdRemove:
+    case EcsCmdSetDontFragment:
+    case EcsCmdEmplace:
+    case EcsCmdEnsureDontFragment:
+    case EcsCmdPath:
+    case EcsCmdDelete:
+    case EcsCmdClear:
+    case EcsCmdOnDeleteAction:
+    case EcsCmdEnable:
+    case EcsCmdDisable:
+    case EcsCmdEvent:
+    case EcsCmdSkip:
+        break;
+    }
+    return false;
+}
+
+/* Move values of set/ensure commands in a partition into component storage.
+ * This is only done for entities for which all commands in the partition are
+ * value commands for components the entity already has, which guarantees that
+ * the commands don't change the table of the entity. Commands are processed in stage
+ * order, so that the last enqueued value wins, like with a serial merge. Set
+ * commands are converted to modified commands, so that the merge that follows
+ * still marks the columns as changed. Partitions are only merged in parallel if
+ * none of the commands have hooks or observers. */
+void flecs_commands_merge_partition(
+    ecs_world_t *world,
+    int32_t partition)
+{
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        if (world->stages[s]->cmd_merge_serial) {
+            return;
+        }
+    }
+
+    ecs_stage_t *stage = world->stages[partition];
+    ecs_map_t serial;
+    ecs_map_init(&serial, &stage->allocator);
+
+    /* Find entities with commands that can't be merged in parallel */
+    for (s = 0; s < stage_count; s ++) {
+        ecs_stage_t *src = world->stages[s];
+        ecs_cmd_t *cmds = ecs_vec_first_t(&src->cmd->queue, ecs_cmd_t);
+        ecs_vec_t *indices = ecs_vec_get_t(
+            &src->cmd_partitions, ecs_vec_t, partition);
+        int32_t *index = ecs_vec_first_t(indices, int32_t);
+        int32_t i, count = ecs_vec_count(indices);
+
+        for (i = 0; i < count; i ++) {
+            ecs_cmd_t *cmd = &cmds[index[i]];
+            if (!flecs_cmd_can_merge(world, cmd)) {
+                ecs_map_ensure(&serial, cmd->entity);
+            }
+        }
+    }
+
+    /* Move values into storage */
+    for (s = 0; s < stage_count; s ++) {
+        ecs_stage_t *src = world->stages[s];
+        ecs_cmd_t *cmds = ecs_vec_first_t(&src->cmd->queue, ecs_cmd_t);
+        ecs_vec_t *indices = ecs_vec_get_t(
+            &src->cmd_partitions, ecs_vec_t, partition);
+        int32_t *index = ecs_vec_first_t(indices, int32_t);
+        int32_t i, count = ecs_vec_count(indices);
+
+        for (i = 0; i < count; i ++) {
+            ecs_cmd_t *cmd = &cmds[index[i]];
+            if (ecs_map_get(&serial, cmd->entity)) {
+                continue;
+            }
+
+            /* All commands for the entity are handled here, so the merge
+             * doesn't need to batch them. */
+            if (cmd->next_for_entity < 0) {
+                cmd->next_for_entity *= -1;
+            }
+
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind == EcsCmdAddModified) {
+                /* Entity already has the component */
+                cmd->kind = EcsCmdModified;
+                continue;
+            }
+
+            if (kind == EcsCmdAdd) {
+                /* Entity already has the component */
+                cmd->kind = EcsCmdSkip;
+                continue;
+            }
+
+            if (kind != EcsCmdSet && kind != EcsCmdEnsure) {
+                continue;
+            }
+
+            const ecs_type_info_t *ti = NULL;
+            void *dst = flecs_cmd_merge_dst(world, cmd, &ti);
+            ecs_assert(dst != NULL, ECS_INTERNAL_ERROR, NULL);
+
+            void *ptr = cmd->is._1.value;
+            bool move_hook = ti->hooks.move != NULL;
+            flecs_type_info_move(dst, ptr, 1, ti);
+            if (move_hook) {
+                flecs_type_info_dtor(ptr, 1, ti);
+            }
+
+            flecs_stack_free(ptr, cmd->is._1.size);
+            cmd->is._1.value = NULL;
+
+            /* Same as batched commands: set is reduced to modified, and there 
+             * is nothing left to do for ensure. */
+            cmd->kind = (kind == EcsCmdSet) ? EcsCmdModified : EcsCmdSkip;
+            stage->cmd_merged_count ++;
+        }
+    }
+
+    ecs_map_fini(&serial);
+}
+
 /* Discard commands from queue without executing them. */
 bool flecs_defer_purge(
     ecs_world_t *world,
@@ -8052,6 +8756,16 @@ void flecs_move_entity(
     record->table = dst_table;
     record->row = ECS_ROW_TO_RECORD(dst_row, record->row & ECS_ROW_FLAGS_MASK);
 
+    if (dst_table->flags & EcsTableHasDenseToggle) {
+        if (emplace_id) {
+            /* Emplaced value isn't constructed yet, so it can't be swapped */
+            flecs_table_dense_toggle_invalidate(dst_table);
+        } else {
+            flecs_table_dense_toggle_sync(world, dst_table, dst_row);
+            dst_row = ECS_RECORD_TO_ROW(record->row);
+        }
+    }
+
     flecs_table_delete(world, src_table, src_row, false);
 
     flecs_actions_move_add(world, dst_table, src_table, dst_row, 1, diff,
@@ -8126,6 +8840,96 @@ void flecs_commit(
     return;
 }
 
+/* Range of new component values in a table that is initialized in parallel */
+typedef struct flecs_bulk_init_t {
+    ecs_table_t *table;
+    void **column_data;         /* Values per column, NULL to construct */
+    int32_t row;
+    int32_t count;
+    bool is_move;
+} flecs_bulk_init_t;
+
+/* Construct or initialize the part of the range that belongs to a thread */
+static
+void flecs_bulk_init_range(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    (void)world;
+    flecs_bulk_init_t *job = ctx;
+    ecs_table_t *table = job->table;
+    int32_t start = (int32_t)(
+        (int64_t)job->count * stage_index / stage_count);
+    int32_t end = (int32_t)(
+        (int64_t)job->count * (stage_index + 1) / stage_count);
+    int32_t count = end - start;
+    if (!count) {
+        return;
+    }
+
+    int32_t i, column_count = table->column_count;
+    for (i = 0; i < column_count; i ++) {
+        ecs_column_t *column = &table->data.columns[i];
+        const ecs_type_info_t *ti = column->ti;
+        void *ptr = ECS_ELEM(column->data, ti->size, job->row + start);
+
+        if (!job->column_data) {
+            flecs_type_info_ctor(ptr, count, ti);
+            continue;
+        }
+
+        void *src_ptr = job->column_data[i];
+        if (!src_ptr) {
+            continue;
+        }
+
+        src_ptr = ECS_ELEM(src_ptr, ti->size, start);
+        if (job->is_move) {
+            flecs_type_info_move(ptr, src_ptr, count, ti);
+        } else {
+            flecs_type_info_copy(ptr, src_ptr, count, ti);
+        }
+    }
+}
+
+/* Run bulk initialization job on worker threads, or on the calling thread if 
+ * the world has no worker threads. */
+static
+void flecs_bulk_init_run(
+    ecs_world_t *world,
+    flecs_bulk_init_t *job)
+{
+#ifdef FLECS_PIPELINE
+    if (flecs_workers_run(world, flecs_bulk_init_range, job)) {
+        return;
+    }
+#endif
+    flecs_bulk_init_range(world, 0, 1, job);
+}
+
+/* Test if the component values of a bulk operation should be initialized by
+ * worker threads. Tables with inherited components are excluded, as their
+ * values are constructed from the base component. */
+static
+bool flecs_bulk_init_parallel(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t count)
+{
+    if (!table->column_count || (table->flags & EcsTableHasIsA)) {
+        return false;
+    }
+
+    int32_t stage_count = ecs_get_stage_count(world);
+    if (stage_count <= 1) {
+        return false;
+    }
+
+    return (count / stage_count) >= FLECS_BULK_PARALLEL_MIN_COUNT;
+}
+
 const ecs_entity_t* flecs_bulk_new(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -8134,6 +8938,7 @@ const ecs_entity_t* flecs_bulk_new(
     int32_t count,
     void **component_data,
     bool is_move,
+    bool parallel,
     int32_t *row_out,
     ecs_table_diff_t *diff)
 {
@@ -8147,7 +8952,25 @@ const ecs_entity_t* flecs_bulk_new(
 
     flecs_defer_begin(world, world->stages[0]);
 
-    int32_t row = flecs_table_appendn(world, table, count, entities);
+    if (parallel) {
+        parallel = flecs_bulk_init_parallel(world, table, count);
+    }
+
+    int32_t row = flecs_table_appendn(world, table, count, entities, !parallel);
+
+    flecs_bulk_init_t job = {
+        .table = table,
+        .row = row,
+        .count = count,
+        .is_move = is_move
+    };
+
+    if (parallel) {
+        /* Construct values on worker threads, then invoke OnAdd hooks for the
+         * entire batch on this thread. */
+        flecs_bulk_init_run(world, &job);
+        flecs_table_invoke_on_add(world, table, row, count);
+    }
 
     ecs_type_t type = table->type;
     if (!type.count && !component_data) {
@@ -8166,6 +8989,11 @@ const ecs_entity_t* flecs_bulk_new(
         (component_data == NULL) ? 0 : EcsEventNoOnSet, true, 0, true);
 
     if (component_data) {
+        if (parallel) {
+            job.column_data = flecs_wcalloc_n(
+                world, void*, table->column_count);
+        }
+
         int32_t c_i;
         for (c_i = 0; c_i < component_ids->count; c_i ++) {
             void *src_ptr = component_data[c_i];
@@ -8221,6 +9049,13 @@ const ecs_entity_t* flecs_bulk_new(
                 int32_t index = tr->column;
                 ecs_column_t *column = &table->data.columns[index];
                 ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+
+                if (parallel) {
+                    /* Value is copied by worker threads */
+                    job.column_data[index] = src_ptr;
+                    continue;
+                }
+
                 ptr = ECS_ELEM(column->data, size, row);
 
                 if (is_move) {
@@ -8231,6 +9066,11 @@ const ecs_entity_t* flecs_bulk_new(
             }
         };
 
+        if (parallel) {
+            flecs_bulk_init_run(world, &job);
+            flecs_wfree_n(world, void*, table->column_count, job.column_data);
+        }
+
         int32_t j, storage_count = table->column_count;
         for (j = 0; j < storage_count; j ++) {
             ecs_id_t component = flecs_column_id(table, j);
@@ -8332,12 +9172,12 @@ void flecs_add_ids(
     flecs_table_diff_builder_init(world, &diff);
 
     ecs_table_t *table = ecs_get_table(world, entity);
-    int32_t i;
-    for (i = 0; i < count; i ++) {
-        ecs_id_t component = ids[i];
-        table = flecs_find_table_add(world, table, component, &diff);
+    if (!table) {
+        table = &world->store.root;
     }
 
+    table = flecs_find_table_add_ids(world, table, ids, count, &diff);
+
     ecs_table_diff_t table_diff;
     flecs_table_diff_build_noalloc(&diff, &table_diff);
     flecs_commit(world, entity, r, table, &table_diff, 0, 0);
@@ -8425,10 +9265,14 @@ flecs_component_ptr_t flecs_get_mut(
 
     flecs_component_ptr_t result;
 
+    if (!r->table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return (flecs_component_ptr_t){0};
+    }
+
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[id]) {
             ecs_table_t *table = r->table;
-            ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
             ecs_assert(table->component_map != NULL, ECS_INTERNAL_ERROR, NULL);
             int16_t column_index = table->component_map[id];
             if (column_index > 0) {
@@ -8539,6 +9383,26 @@ const char* flecs_entity_invalid_reason(
             flecs_errstr_1(ecs_get_path(world, entity)), \
             flecs_id_invalid_reason(world, component))
 
+/* SoA components don't have a column, their data is stored in the columns of
+ * the member components. */
+#define flecs_assert_component_not_soa(world, component, function)\
+    ecs_check(!(flecs_component_get_flags(ecs_get_world(world), component) \
+        & EcsIdSoA), \
+        ECS_INVALID_OPERATION, \
+        "cannot call %s() for SoA component '%s' (use its members instead)", \
+            function, \
+            flecs_errstr(ecs_id_str(world, component)))
+
+void flecs_mark_dirty_if_forked(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_id_t component)
+{
+    if (world->fork_count) {
+        flecs_table_mark_dirty(world, table, component);
+    }
+}
+
 /* -- Public functions -- */
 
 bool ecs_commit(
@@ -8587,7 +9451,12 @@ ecs_entity_t ecs_new(
 {
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    flecs_stage_from_world(&world);
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    if (world->flags & EcsWorldMultiThreaded) {
+        /* Entity is added to the root table when the stage is merged */
+        return flecs_stage_new_id(world, stage);
+    }
+
     ecs_entity_t e = flecs_new_id(world);
     flecs_add_to_root_table(world, e);
     return e;
@@ -8666,8 +9535,8 @@ ecs_entity_t ecs_new_w_id(
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
     if (flecs_defer_cmd(stage)) {
-        ecs_entity_t e = ecs_new(world);
-        ecs_add_id(world, e, component);
+        ecs_entity_t e = ecs_new((ecs_world_t*)stage);
+        ecs_add_id((ecs_world_t*)stage, e, component);
         return e;
     }
 
@@ -8851,12 +9720,12 @@ int flecs_traverse_add(
 
     /* Add components from the 'add' array */
     if (desc->add) {
-        int32_t i = 0;
-        ecs_id_t component;
-
-        while ((component = desc->add[i ++])) {
-            table = flecs_find_table_add(world, table, component, &diff);
+        int32_t count = 0;
+        while (desc->add[count]) {
+            count ++;
         }
+
+        table = flecs_find_table_add_ids(world, table, desc->add, count, &diff);
     }
 
     /* Add components from the 'set' array */
@@ -9263,19 +10132,19 @@ const ecs_entity_t* ecs_bulk_init(
         flecs_table_diff_builder_init(world, &diff);
 
         int32_t i = 0;
-        ecs_id_t component;
-        while ((component = desc->ids[i])) {
-            table = flecs_find_table_add(world, table, component, &diff);
+        while (desc->ids[i]) {
             i ++;
         }
 
+        table = flecs_find_table_add_ids(world, table, desc->ids, i, &diff);
+
         ids.array = ECS_CONST_CAST(ecs_id_t*, desc->ids);
         ids.count = i;
 
         ecs_table_diff_t table_diff;
         flecs_table_diff_build_noalloc(&diff, &table_diff);
-        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, NULL, 
-            &table_diff);
+        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, 
+            desc->parallel, NULL, &table_diff);
         flecs_table_diff_builder_fini(world, &diff);
     } else {
         ecs_table_diff_t diff = {
@@ -9291,8 +10160,8 @@ const ecs_entity_t* ecs_bulk_init(
         ids.array = ECS_CONST_CAST(ecs_id_t*, desc->ids);
         ids.count = i;
 
-        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, NULL, 
-            &diff);
+        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, 
+            desc->parallel, NULL, &diff);
     }
 
     if (!sparse_count) {
@@ -9329,7 +10198,8 @@ const ecs_entity_t* ecs_bulk_new_w_id(
 
     ecs_table_diff_t td;
     flecs_table_diff_build_noalloc(&diff, &td);
-    ids = flecs_bulk_new(world, table, NULL, NULL, count, NULL, false, NULL, &td);
+    ids = flecs_bulk_new(
+        world, table, NULL, NULL, count, NULL, false, false, NULL, &td);
     flecs_table_diff_builder_fini(world, &diff);
     flecs_defer_end(world, stage);
 
@@ -9730,7 +10600,10 @@ const void* ecs_get_id(
     ecs_assert(r != NULL, ECS_INVALID_PARAMETER, NULL);
 
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return NULL;
+    }
 
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
@@ -9744,6 +10617,8 @@ const void* ecs_get_id(
         return NULL;
     }
 
+    flecs_assert_component_not_soa(world, component, "get");
+
     if (cr->flags & EcsIdDontFragment) {
         void *ptr = flecs_component_sparse_get(world, cr, table, entity);
         if (ptr) {
@@ -9769,6 +10644,111 @@ error:
     return NULL;
 }
 
+/* Number of entities for which records are fetched ahead in ecs_get_many_id */
+#define FLECS_GET_MANY_PREFETCH (8)
+
+void ecs_get_many_id(
+    const ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t component,
+    const void **ptrs_out)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || entities != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || ptrs_out != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_id_is_valid(world, component) || ecs_id_is_wildcard(component), 
+        ECS_INVALID_PARAMETER, NULL);
+
+    world = ecs_get_world(world);
+
+    int32_t i;
+    ecs_component_record_t *cr = NULL;
+    if (component >= FLECS_HI_COMPONENT_ID || 
+        world->non_trivial_lookup[component]) 
+    {
+        cr = flecs_components_get(world, component);
+        if (!cr) {
+            ecs_os_memset_n(ptrs_out, 0, void*, count);
+            return;
+        }
+
+        if (cr->flags & (EcsIdDontFragment|EcsIdSparse)) {
+            /* Components not stored in table columns */
+            for (i = 0; i < count; i ++) {
+                ptrs_out[i] = ecs_get_id(world, entities[i], component);
+            }
+            return;
+        }
+    }
+
+    /* Looking up a component is a chain of dependent loads (entity index page, 
+     * record, table column), which for entities that are scattered across 
+     * tables are likely all cache misses. Fetch records ahead of the entity 
+     * that is being resolved, and prefetch the component value so it is (more 
+     * likely) cached when the application reads it. */
+    for (i = 0; i < count && i < FLECS_GET_MANY_PREFETCH; i ++) {
+        flecs_entities_prefetch(world, entities[i]);
+    }
+
+    ecs_table_t *last_table = NULL;
+    const ecs_table_record_t *tr = NULL;
+
+    for (i = 0; i < count; i ++) {
+        if ((i + FLECS_GET_MANY_PREFETCH) < count) {
+            flecs_entities_prefetch(world, 
+                entities[i + FLECS_GET_MANY_PREFETCH]);
+        }
+
+        ecs_entity_t e = entities[i];
+        flecs_assert_entity_valid(world, e, "get_many");
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r != NULL, ECS_INVALID_PARAMETER, NULL);
+
+        ecs_table_t *table = r->table;
+        int32_t row = ECS_RECORD_TO_ROW(r->row);
+        void *ptr = NULL;
+
+        if (!table) {
+            ptrs_out[i] = NULL;
+            continue;
+        }
+
+        if (!cr) {
+            int16_t column_index = table->component_map[component];
+            if (column_index > 0) {
+                ecs_column_t *column = &table->data.columns[column_index - 1];
+                ptr = ECS_ELEM(column->data, column->ti->size, row);
+            }
+        } else {
+            /* Entities are often stored in a small number of tables, so only
+             * look up the table record when the table changes. */
+            if (table != last_table) {
+                tr = flecs_component_get_table(cr, table);
+                last_table = table;
+                ecs_check(!tr || tr->column != -1, ECS_INVALID_PARAMETER,
+                    "component '%s' passed to get_many() is a tag/zero sized",
+                        flecs_errstr(ecs_id_str(world, component)));
+            }
+
+            if (tr) {
+                ptr = flecs_table_get_component(table, tr->column, row).ptr;
+            } else {
+                ptr = flecs_get_base_component(world, table, component, cr, 0);
+            }
+        }
+
+        if (ptr) {
+            flecs_prefetch(ptr);
+        }
+
+        ptrs_out[i] = ptr;
+    }
+error:
+    return;
+}
+
 #ifdef FLECS_DEBUG
 static
 bool flecs_component_has_on_replace(
@@ -9794,6 +10774,7 @@ void* ecs_get_mut_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "get_mut");
     flecs_assert_component_valid(world, entity, component, "get_mut");
+    flecs_assert_component_not_soa(world, component, "get_mut");
     ecs_dbg_assert(!flecs_component_has_on_replace(world, component, "get_mut"), 
         ECS_INVALID_PARAMETER,
         "cannot call get_mut() for component '%s' which has an on_replace hook "
@@ -9807,6 +10788,13 @@ void* ecs_get_mut_id(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INVALID_PARAMETER, NULL);
 
+    if (!r->table) {
+        return NULL;
+    }
+
+    flecs_mark_dirty_if_forked(
+        ECS_CONST_CAST(ecs_world_t*, world), r->table, component);
+
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
             ecs_get_low_id(r->table, r, component);
@@ -9865,6 +10853,7 @@ void* ecs_ensure_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "ensure");
     flecs_assert_component_valid(world, entity, component, "ensure");
+    flecs_assert_component_not_soa(world, component, "ensure");
     ecs_dbg_assert(!flecs_component_has_on_replace(world, component, "ensure"),
         ECS_INVALID_PARAMETER,
         "cannot call ensure() for component '%s' which has an on_replace hook "
@@ -9887,6 +10876,7 @@ void* ecs_ensure_id(
             flecs_errstr(ecs_id_str(world, component)),
             flecs_errstr_2(ecs_get_path(world, entity)));
 
+    flecs_mark_dirty_if_forked(world, r->table, component);
     flecs_defer_end(world, stage);
     return result;
 error:
@@ -9903,6 +10893,7 @@ void* ecs_emplace_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "emplace");
     flecs_assert_component_valid(world, entity, component, "emplace");
+    flecs_assert_component_not_soa(world, component, "emplace");
     ecs_dbg_assert(!flecs_component_has_on_replace(world, component, "emplace"),
         ECS_INVALID_PARAMETER,
         "cannot call emplace() for component '%s' which has an on_replace hook "
@@ -9958,6 +10949,7 @@ void* ecs_emplace_id(
         *is_new = table != r->table;
     }
 
+    flecs_mark_dirty_if_forked(world, r->table, component);
     return ptr;
 error:
     return NULL;
@@ -10090,6 +11082,7 @@ void flecs_modified_id_if(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "modified");
     flecs_assert_component_valid(world, entity, component, "modified");
+    flecs_assert_component_not_soa(world, component, "modified");
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
@@ -10129,6 +11122,7 @@ void ecs_modified_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "modified");
     flecs_assert_component_valid(world, entity, component, "modified");
+    flecs_assert_component_not_soa(world, component, "modified");
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
@@ -10227,6 +11221,7 @@ void ecs_set_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "set");
     flecs_assert_component_valid(world, entity, component, "set");
+    flecs_assert_component_not_soa(world, component, "set");
     ecs_check(size != 0, ECS_INVALID_PARAMETER, NULL);
     ecs_check(ptr != NULL, ECS_INVALID_PARAMETER, 
         "invalid call to set() for component '%s' and entity '%s': no "
@@ -10316,6 +11311,10 @@ void ecs_enable_id(
 
     flecs_bitset_set(bs, ECS_RECORD_TO_ROW(r->row), enable);
 
+    if (table->flags & EcsTableHasDenseToggle) {
+        flecs_table_dense_toggle_sync(world, table, ECS_RECORD_TO_ROW(r->row));
+    }
+
     flecs_defer_end(world, stage);
 error:
     return;
@@ -10336,7 +11335,9 @@ bool ecs_is_enabled_id(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        return false;
+    }
 
     ecs_bitset_t *bs = flecs_table_get_toggle(table, component);
     if (!bs) {
@@ -10424,7 +11425,10 @@ bool ecs_has_id(
     ecs_record_t *r = flecs_entities_get_any(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return false;
+    }
 
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
@@ -10502,7 +11506,10 @@ bool ecs_owns_id(
     ecs_record_t *r = flecs_entities_get_any(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return false;
+    }
 
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
@@ -10629,7 +11636,9 @@ ecs_entity_t ecs_get_target(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        return 0;
+    }
 
     ecs_id_t wc = ecs_pair(rel, EcsWildcard);
     ecs_component_record_t *cr = flecs_components_get(world, wc);
@@ -10716,7 +11725,9 @@ ecs_entity_t ecs_get_parent(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        return 0;
+    }
 
     if (table->flags & EcsTableHasParent) {
         int32_t column = table->component_map[ecs_id(EcsParent)];
@@ -11286,8 +12297,7 @@ bool flecs_path_append(
     if (child && ecs_is_alive(world, child)) {
         ecs_record_t *r = flecs_entities_get(world, child);
         ecs_assert(r != NULL, ECS_INVALID_OPERATION, NULL);
-        ecs_assert(r->table != NULL, ECS_INTERNAL_ERROR, NULL);
-        bool hasName = r->table->flags & EcsTableHasName;
+        bool hasName = r->table && (r->table->flags & EcsTableHasName);
 
         if (hasName) {
             cur = ecs_get_target(world, child, EcsChildOf, 0);
@@ -13181,7 +14191,8 @@ void flecs_instantiate_children(
     int32_t child_row;
     diff.added_flags |= EcsTableEdgeReparent;
     const ecs_entity_t *i_children = flecs_bulk_new(world, i_table, child_ids,
-        &diff.added, child_range.count, component_data, false, &child_row, &diff);
+        &diff.added, child_range.count, component_data, false, false, &child_row,
+        &diff);
 
     flecs_instantiate_sparse(
         world, &child_range, children, i_table, i_children, child_row, false);
@@ -14338,6 +15349,22 @@ error:
     return false;
 }
 
+/* Forward results of a chained iterator that was split up per worker. */
+static
+bool flecs_worker_split_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    if (!ecs_iter_next(chain_it)) {
+        return false;
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    return true;
+}
+
 ecs_iter_t ecs_worker_iter(
     const ecs_iter_t *it,
     int32_t index,
@@ -14361,6 +15388,13 @@ ecs_iter_t ecs_worker_iter(
     result.fini = ecs_chained_iter_fini;
     result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
 
+    /* Iterators for sparse components and partitioned queries can be split up
+     * by the chained iterator, so that each worker only iterates its own 
+     * elements. */
+    result.priv_.iter.worker.split = flecs_query_trivial_sparse_split(
+        result.chain_it, index, count, NULL, 0) ||
+            flecs_query_partition_init(result.chain_it, index, count, NULL);
+
     return result;
 error:
     return (ecs_iter_t){ 0 };
@@ -14378,6 +15412,10 @@ bool ecs_worker_next(
     int32_t res_count = iter->count, res_index = iter->index;
     int32_t per_worker, first;
 
+    if (iter->split) {
+        return flecs_worker_split_next(it);
+    }
+
     do {
         if (!ecs_iter_next(chain_it)) {
             return false;
@@ -14427,6 +15465,151 @@ error:
     return false;
 }
 
+ecs_iter_t ecs_dynamic_worker_iter(
+    const ecs_iter_t *it,
+    int32_t *cursor,
+    int32_t chunk_size)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(cursor != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunk_size > 0, ECS_INVALID_PARAMETER,
+        "invalid chunk size %d", chunk_size);
+
+    ecs_iter_t result = *it;
+    result.priv_.stack_cursor = NULL; /* Don't copy allocator cursor */
+
+    result.priv_.iter.worker = (ecs_worker_iter_t){
+        .cursor = cursor,
+        .chunk_size = chunk_size
+    };
+    result.next = ecs_dynamic_worker_next;
+    result.fini = ecs_chained_iter_fini;
+    result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
+    result.priv_.iter.worker.split = flecs_query_trivial_sparse_split(
+        result.chain_it, 0, 1, cursor, chunk_size) ||
+            flecs_query_partition_init(result.chain_it, 0, 1, cursor);
+
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+/* Forward results of a chained iterator that was split up per worker, in 
+ * chunks of at most chunk_size entities. */
+static
+bool flecs_dynamic_worker_split_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t first = iter->chunk;
+
+    /* A nonzero offset means that the current result has chunks left */
+    if (!first && !ecs_iter_next(chain_it)) {
+        return false;
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    int32_t count = it->count - first;
+    if (count > iter->chunk_size) {
+        count = iter->chunk_size;
+        iter->chunk = first + count;
+    } else {
+        iter->chunk = 0;
+    }
+
+    if (first) {
+        it->frame_offset += first;
+        it->count = count;
+        it->offset += first;
+
+        if (it->table) {
+            it->entities = &(ecs_table_entities(it->table)[it->offset]);
+        } else {
+            it->entities = &it->entities[first];
+        }
+    } else {
+        it->count = count;
+    }
+
+    return true;
+}
+
+static
+int32_t flecs_dynamic_worker_chunk_count(
+    const ecs_iter_t *it,
+    int32_t chunk_size)
+{
+    if (!it->count) {
+        /* Results without a table are passed to a single worker */
+        return it->table == NULL;
+    }
+
+    return (it->count + chunk_size - 1) / chunk_size;
+}
+
+bool ecs_dynamic_worker_next(
+    ecs_iter_t *it)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_dynamic_worker_next, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t chunk_size = iter->chunk_size;
+
+    if (iter->split) {
+        return flecs_dynamic_worker_split_next(it);
+    }
+
+    /* Claim the next chunk. All workers walk the results of the chained
+     * iterator in the same order, so a chunk index refers to the same entities
+     * for each worker. The iterator keeps track of the index of the first
+     * chunk after the current result of the chained iterator. */
+    int32_t claimed = ecs_os_ainc(iter->cursor) - 1;
+    while (claimed >= iter->chunk) {
+        if (!ecs_iter_next(chain_it)) {
+            return false;
+        }
+
+        iter->chunk += flecs_dynamic_worker_chunk_count(chain_it, chunk_size);
+    }
+
+    int32_t chunk_count = flecs_dynamic_worker_chunk_count(
+        chain_it, chunk_size);
+    int32_t first = (claimed - (iter->chunk - chunk_count)) * chunk_size;
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    if (!it->count) {
+        return true;
+    }
+
+    int32_t count = it->count - first;
+    if (count > chunk_size) {
+        count = chunk_size;
+    }
+
+    it->frame_offset += first;
+    it->count = count;
+    it->offset += first;
+
+    if (it->table) {
+        it->entities = &(ecs_table_entities(it->table)[it->offset]);
+    } else {
+        it->entities = &it->entities[first];
+    }
+
+    return true;
+error:
+    return false;
+}
+
  
 #include <time.h>
 #include <errno.h>
@@ -15380,7 +16563,9 @@ void flecs_emit_propagate_invalidate_tables(
     ecs_component_record_t *cur = tgt_cr;
     while ((cur = flecs_component_trav_next(cur))) {
         ecs_reachable_cache_t *rc = &cur->pair->reachable;
-        if (rc->current != rc->generation) {
+        if (rc->current != rc->generation && 
+            rc->up_current != rc->generation) 
+        {
             /* Subtree is already marked invalid */
             continue;
         }
@@ -17010,6 +18195,44 @@ void flecs_observer_invoke(
     }
 }
 
+/* Events received by a coalesced observer for an entity */
+#define FLECS_COALESCE_ADD    (1u << 0) /* Received OnAdd */
+#define FLECS_COALESCE_REMOVE (1u << 1) /* Received OnRemove */
+#define FLECS_COALESCE_SET    (1u << 2) /* Received OnSet */
+#define FLECS_COALESCE_NEW    (1u << 3) /* First received event was OnAdd */
+
+/* Store event for coalesced observer, to be delivered by ecs_observer_flush */
+static
+void flecs_observer_coalesce(
+    ecs_world_t *world,
+    ecs_observer_t *o,
+    ecs_entity_t event,
+    const ecs_entity_t *entities,
+    int32_t count)
+{
+    ecs_observer_impl_t *impl = flecs_observer_impl(o);
+    ecs_flags32_t flag;
+    if (event == EcsOnAdd) {
+        flag = FLECS_COALESCE_ADD;
+    } else if (event == EcsOnRemove) {
+        flag = FLECS_COALESCE_REMOVE;
+    } else {
+        ecs_assert(event == EcsOnSet, ECS_INTERNAL_ERROR, NULL);
+        flag = FLECS_COALESCE_SET;
+    }
+
+    ecs_map_init_if(&impl->coalesced, &world->allocator);
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_map_val_t *events = ecs_map_ensure(&impl->coalesced, entities[i]);
+        if (!events[0] && (flag == FLECS_COALESCE_ADD)) {
+            events[0] = FLECS_COALESCE_NEW;
+        }
+        events[0] |= flag;
+    }
+}
+
 static
 void flecs_uni_observer_invoke(
     ecs_world_t *world,
@@ -17067,7 +18290,11 @@ void flecs_uni_observer_invoke(
 
         bool match_this = query->flags & EcsQueryMatchThis;
 
-        if (match_this) {
+        if (impl->flags & EcsObserverCoalesce) {
+            ecs_assert(match_this, ECS_INTERNAL_ERROR, NULL);
+            flecs_observer_coalesce(world, o, it->event, it->entities, 
+                it->count);
+        } else if (match_this) {
             /* Invoke observer for $this field */
             flecs_observer_invoke(o, it);
             ecs_os_inc(&query->eval_count);
@@ -17256,6 +18483,14 @@ void flecs_multi_observer_invoke(
         impl->last_event_id[0] = it->event_cur;
         impl->last_event_field = pivot_field_bit;
 
+        if (impl->flags & EcsObserverCoalesce) {
+            flecs_observer_coalesce(world, o, it->event, it->entities, 
+                it->count);
+            user_it.flags |= EcsIterSkip; /* Prevent change detection on fini */
+            ecs_iter_fini(&user_it);
+            goto done;
+        }
+
         /* Patch data from original iterator. If the observer query has
          * wildcards which triggered the original event, the component id that
          * got matched by ecs_query_has_range may not be the same as the one
@@ -17526,6 +18761,9 @@ int flecs_multi_observer_init(
     child_desc.run_ctx = NULL;
     child_desc.run_ctx_free = NULL;
     child_desc.yield_existing = false;
+    child_desc.coalesce = false;
+    child_desc.coalesce_phase = 0;
+    child_desc.multi_threaded = false;
     child_desc.flags_ &= ~(EcsObserverYieldOnCreate|EcsObserverYieldOnDelete);
     ecs_os_zeromem(&child_desc.entity);
     ecs_os_zeromem(&child_desc.query.terms);
@@ -17818,7 +19056,8 @@ ecs_observer_t* flecs_observer_init(
         .ids = ids
     };
 
-    if (desc->events[0] != EcsMonitor) {
+    /* Coalesced observers use the query to get the data for flushed events */
+    if (desc->events[0] != EcsMonitor && !desc->coalesce) {
         bool simple = false;
 #ifndef FLECS_SANITIZE
         simple = flecs_query_finalize_simple(
@@ -17947,6 +19186,25 @@ ecs_observer_t* flecs_observer_init(
     ecs_check(o->event_count != 0, ECS_INVALID_PARAMETER,
         "observer must have at least one event");
 
+    if (desc->coalesce) {
+        ecs_check(!(impl->flags & EcsObserverIsMonitor), ECS_INVALID_PARAMETER,
+            "monitor observers cannot be coalesced");
+        ecs_check(query->flags & EcsQueryMatchOnlyThis, ECS_UNSUPPORTED,
+            "coalesced observers can only match $this");
+        for (i = 0; i < o->event_count; i ++) {
+            ecs_entity_t event = o->events[i];
+            ecs_check(event == EcsOnAdd || event == EcsOnRemove || 
+                event == EcsOnSet, ECS_UNSUPPORTED,
+                    "coalesced observers only support OnAdd, OnRemove and "
+                    "OnSet events");
+        }
+
+        impl->flags |= EcsObserverCoalesce;
+        if (desc->multi_threaded) {
+            impl->flags |= EcsObserverMultiThreaded;
+        }
+    }
+
     bool multi = false;
 
     if (query->term_count == 1 && !desc->last_event_id) {
@@ -17982,6 +19240,431 @@ error:
     return NULL;
 }
 
+/* Entity stored by a coalesced observer, ordered by table and row on flush */
+typedef struct ecs_coalesced_elem_t {
+    ecs_table_t *table;
+    int32_t row;
+    ecs_flags32_t events;
+    bool matched;
+    ecs_entity_t entity;
+} ecs_coalesced_elem_t;
+
+static
+int flecs_coalesced_elem_cmp(
+    const void *ptr_a,
+    const void *ptr_b)
+{
+    const ecs_coalesced_elem_t *a = ptr_a;
+    const ecs_coalesced_elem_t *b = ptr_b;
+
+    if (a->table != b->table) {
+        /* Deleted entities are ordered first */
+        if (!a->table) {
+            return -1;
+        }
+        if (!b->table) {
+            return 1;
+        }
+        return (a->table->id > b->table->id) - (a->table->id < b->table->id);
+    }
+
+    return (a->row > b->row) - (a->row < b->row);
+}
+
+/* An entity that was removed and added again is delivered as OnSet if the
+ * observer observes OnSet, and as OnRemove followed by OnAdd otherwise. */
+static
+bool flecs_observer_coalesce_delivers(
+    ecs_flags32_t events,
+    ecs_flags32_t observed,
+    ecs_entity_t event,
+    bool matched)
+{
+    bool readded = (events & FLECS_COALESCE_REMOVE) && 
+        !(events & FLECS_COALESCE_NEW);
+    if (event == EcsOnAdd) {
+        return (events & FLECS_COALESCE_NEW) || (readded && 
+            (events & FLECS_COALESCE_ADD) && !(observed & FLECS_COALESCE_SET));
+    } else if (event == EcsOnSet) {
+        return (observed & FLECS_COALESCE_SET) && 
+            ((events & FLECS_COALESCE_SET) || readded);
+    } else {
+        return readded && (!matched || !(observed & FLECS_COALESCE_SET));
+    }
+}
+
+static
+void flecs_observer_coalesce_invoke(
+    ecs_observer_t *o,
+    ecs_iter_t *it,
+    ecs_entity_t event)
+{
+    it->event = event;
+    it->event_id = it->ids[0];
+    if (o->world->flags & EcsWorldMultiThreaded) {
+        it->event_cur = ecs_os_ainc(&o->world->event_id);
+    } else {
+        it->event_cur = ++ o->world->event_id;
+    }
+    it->system = o->entity;
+    it->ctx = o->ctx;
+    it->callback_ctx = o->callback_ctx;
+    it->run_ctx = o->run_ctx;
+    it->callback = o->callback;
+
+    if (o->run) {
+        ecs_iter_next_action_t next = it->next;
+        it->next = flecs_default_next_callback;
+        it->interrupted_by = 0;
+        o->run(it);
+        it->next = next;
+        it->interrupted_by = 0;
+    } else {
+        it->callback(it);
+    }
+}
+
+/* Deliver OnAdd and OnSet events for the entities of a query result */
+static
+int32_t flecs_observer_flush_result(
+    ecs_observer_t *o,
+    ecs_iter_t *it,
+    ecs_coalesced_elem_t *elems,
+    ecs_flags32_t observed)
+{
+    const ecs_entity_t events[] = { EcsOnAdd, EcsOnSet };
+    int32_t delivered = 0, i, count = it->count;
+
+    for (i = 0; i < count; i ++) {
+        elems[i].matched = true;
+    }
+
+    int32_t e;
+    for (e = 0; e < 2; e ++) {
+        ecs_entity_t event = events[e];
+
+        /* Invoke observer for each run of adjacent entities with the event */
+        i = 0;
+        while (i < count) {
+            if (!flecs_observer_coalesce_delivers(
+                elems[i].events, observed, event, true)) 
+            {
+                i ++;
+                continue;
+            }
+
+            int32_t start = i;
+            while (i < count && flecs_observer_coalesce_delivers(
+                elems[i].events, observed, event, true)) 
+            {
+                i ++;
+            }
+
+            ecs_iter_t user_it = *it;
+            user_it.offset = it->offset + start;
+            user_it.count = i - start;
+            user_it.entities = &it->entities[start];
+            flecs_observer_coalesce_invoke(o, &user_it, event);
+            delivered += user_it.count;
+        }
+    }
+
+    return delivered;
+}
+
+/* Deliver OnRemove events for the coalesced entities of a single table */
+static
+int32_t flecs_observer_flush_removed(
+    ecs_world_t *world,
+    ecs_observer_t *o,
+    ecs_table_t *table,
+    ecs_coalesced_elem_t *elems,
+    int32_t count,
+    ecs_flags32_t observed)
+{
+    int32_t i, delivered = 0;
+    ecs_allocator_t *a = flecs_stage_get_allocator(world);
+    ecs_vec_t removed;
+    ecs_vec_init_t(a, &removed, ecs_entity_t, 0);
+
+    for (i = 0; i < count; i ++) {
+        if (flecs_observer_coalesce_delivers(
+            elems[i].events, observed, EcsOnRemove, elems[i].matched)) 
+        {
+            ecs_vec_append_t(a, &removed, ecs_entity_t)[0] = elems[i].entity;
+        }
+    }
+
+    int32_t removed_count = ecs_vec_count(&removed);
+    if (removed_count) {
+        ecs_query_t *q = o->query;
+        ecs_iter_t it = ecs_query_iter(world, q);
+        it.table = table;
+        it.offset = 0;
+        it.count = removed_count;
+        it.entities = ecs_vec_first(&removed);
+        it.flags |= EcsIterIsValid | EcsIterSkip;
+        it.set_fields = 0;
+
+        /* Component values are no longer available */
+        int8_t f;
+        for (f = 0; f < q->field_count; f ++) {
+            it.ids[f] = q->ids[f];
+            ECS_CONST_CAST(int16_t*, it.columns)[f] = -1;
+        }
+
+        flecs_observer_coalesce_invoke(o, &it, EcsOnRemove);
+        ecs_iter_fini(&it);
+        delivered += removed_count;
+    }
+
+    ecs_vec_fini_t(a, &removed, ecs_entity_t);
+
+    return delivered;
+}
+
+/* Deliver events for the coalesced entities of a single table */
+static
+int32_t flecs_observer_flush_table(
+    ecs_world_t *world,
+    ecs_observer_t *o,
+    ecs_table_t *table,
+    ecs_coalesced_elem_t *elems,
+    int32_t count,
+    ecs_flags32_t observed)
+{
+    int32_t delivered = 0, i = 0;
+
+    /* Entities that were removed and added again get OnRemove before OnAdd */
+    if (!(observed & FLECS_COALESCE_SET)) {
+        delivered += flecs_observer_flush_removed(
+            world, o, table, elems, count, observed);
+    }
+
+    while (table && (i < count)) {
+        /* Find run of adjacent rows */
+        int32_t start = i ++;
+        while (i < count && (elems[i].row == (elems[i - 1].row + 1))) {
+            i ++;
+        }
+
+        ecs_table_range_t range = {
+            .table = table,
+            .offset = elems[start].row,
+            .count = i - start
+        };
+
+        ecs_iter_t it = ecs_query_iter(world, o->query);
+        ecs_iter_set_var_as_range(&it, 0, &range);
+        while (ecs_query_next(&it)) {
+            ecs_iter_skip(&it); /* Prevent change detection */
+            delivered += flecs_observer_flush_result(o, &it, 
+                &elems[start + it.offset - range.offset], observed);
+        }
+    }
+
+    /* Entities that no longer match get OnRemove */
+    if (observed & FLECS_COALESCE_SET) {
+        delivered += flecs_observer_flush_removed(
+            world, o, table, elems, count, observed);
+    }
+
+    return delivered;
+}
+
+typedef struct flecs_observer_flush_ctx_t {
+    ecs_world_t *world;             /* World, if single threaded */
+    ecs_observer_t *o;
+    ecs_coalesced_elem_t *elems;    /* Coalesced entities, sorted by table */
+    int32_t count;
+    ecs_flags32_t observed;
+    int32_t *delivered;             /* Delivered entities per thread */
+} flecs_observer_flush_ctx_t;
+
+/* Deliver events for the tables assigned to a thread. */
+static
+void flecs_observer_flush_run(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    flecs_observer_flush_ctx_t *fctx = ctx;
+    ecs_world_t *stage_world = fctx->world;
+    if (!stage_world) {
+        stage_world = ecs_get_stage(world, stage_index);
+    }
+
+    ecs_world_t *real_world = stage_world;
+    ecs_stage_t *stage = flecs_stage_from_world(&real_world);
+    ecs_entity_t old_system = flecs_stage_set_system(stage, fctx->o->entity);
+
+    ecs_coalesced_elem_t *elems = fctx->elems;
+    int32_t i, count = fctx->count, t = 0, delivered = 0;
+    for (i = 0; i < count; t ++) {
+        ecs_table_t *table = elems[i].table;
+        int32_t start = i ++;
+        while (i < count && elems[i].table == table) {
+            i ++;
+        }
+
+        /* Tables are assigned to threads round robin */
+        if ((t % stage_count) != stage_index) {
+            continue;
+        }
+
+        delivered += flecs_observer_flush_table(stage_world, fctx->o, table, 
+            &elems[start], i - start, fctx->observed);
+    }
+
+    flecs_stage_set_system(stage, old_system);
+
+    fctx->delivered[stage_index] = delivered;
+}
+
+int32_t ecs_observer_flush(
+    ecs_world_t *world,
+    ecs_entity_t observer)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_WHILE_READONLY,
+        NULL);
+
+    ecs_observer_t *o = ECS_CONST_CAST(ecs_observer_t*, 
+        ecs_observer_get(world, observer));
+    ecs_check(o != NULL, ECS_INVALID_PARAMETER, "entity is not an observer");
+
+    ecs_observer_impl_t *impl = flecs_observer_impl(o);
+    ecs_check(impl->flags & EcsObserverCoalesce, ECS_INVALID_PARAMETER,
+        "observer is not coalesced");
+
+    int32_t i, count = ecs_map_count(&impl->coalesced);
+    if (!count) {
+        return 0;
+    }
+
+    /* Copy stored entities, so that events emitted by the observer callback
+     * are stored for the next flush. */
+    ecs_allocator_t *a = &world->allocator;
+    ecs_coalesced_elem_t *elems = flecs_alloc_n(a, ecs_coalesced_elem_t, count);
+    ecs_map_iter_t mit = ecs_map_iter(&impl->coalesced);
+    i = 0;
+    while (ecs_map_next(&mit)) {
+        ecs_coalesced_elem_t *elem = &elems[i ++];
+        ecs_entity_t e = ecs_map_key(&mit);
+        elem->entity = e;
+        elem->events = (ecs_flags32_t)ecs_map_value(&mit);
+        elem->matched = false;
+        elem->table = NULL;
+        elem->row = 0;
+
+        if (ecs_is_alive(world, e)) {
+            ecs_record_t *r = flecs_entities_get(world, e);
+            elem->table = r->table;
+            elem->row = ECS_RECORD_TO_ROW(r->row);
+        }
+    }
+
+    ecs_map_clear(&impl->coalesced);
+
+    qsort(elems, flecs_itosize(count), ECS_SIZEOF(ecs_coalesced_elem_t), 
+        flecs_coalesced_elem_cmp);
+
+    ecs_flags32_t observed = 0;
+    for (i = 0; i < o->event_count; i ++) {
+        ecs_entity_t event = o->events[i];
+        if (event == EcsOnAdd) {
+            observed |= FLECS_COALESCE_ADD;
+        } else if (event == EcsOnRemove) {
+            observed |= FLECS_COALESCE_REMOVE;
+        } else if (event == EcsOnSet) {
+            observed |= FLECS_COALESCE_SET;
+        }
+    }
+
+    int32_t stage_count = ecs_get_stage_count(world);
+    int32_t *delivered = flecs_calloc_n(a, int32_t, stage_count);
+
+    flecs_observer_flush_ctx_t ctx = {
+        .world = world,
+        .o = o,
+        .elems = elems,
+        .count = count,
+        .observed = observed,
+        .delivered = delivered
+    };
+
+    bool ran = false;
+#ifdef FLECS_PIPELINE
+    /* Only use worker threads if there is more than one table */
+    if ((impl->flags & EcsObserverMultiThreaded) && 
+        (elems[0].table != elems[count - 1].table)) 
+    {
+        ctx.world = NULL;
+        ran = flecs_workers_run_deferred(world, flecs_observer_flush_run, &ctx);
+        ctx.world = world;
+    }
+#endif
+
+    if (!ran) {
+        ecs_defer_begin(world);
+        flecs_observer_flush_run(world, 0, 1, &ctx);
+        ecs_defer_end(world);
+    }
+
+    int32_t result = 0;
+    for (i = 0; i < stage_count; i ++) {
+        result += delivered[i];
+    }
+
+    flecs_free_n(a, int32_t, stage_count, delivered);
+    flecs_free_n(a, ecs_coalesced_elem_t, count, elems);
+
+    return result;
+error:
+    return 0;
+}
+
+#ifdef FLECS_SYSTEM
+static
+void flecs_observer_flush_system(
+    ecs_iter_t *it)
+{
+    ecs_observer_flush(it->world, ecs_get_parent(it->world, it->system));
+}
+#endif
+
+static
+int flecs_observer_flush_system_init(
+    ecs_world_t *world,
+    ecs_entity_t observer,
+    ecs_entity_t phase)
+{
+#ifdef FLECS_SYSTEM
+    ecs_entity_t system = ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .parent = observer,
+            .name = "Flush",
+            .add = ecs_ids( ecs_dependson(phase), phase )
+        }),
+        .callback = flecs_observer_flush_system,
+        .immediate = true
+    });
+
+    if (!system) {
+        return -1;
+    }
+
+    return 0;
+#else
+    (void)world;
+    (void)observer;
+    (void)phase;
+    ecs_err("coalesce_phase requires the system addon");
+    return -1;
+#endif
+}
+
 ecs_entity_t ecs_observer_init(
     ecs_world_t *world,
     const ecs_observer_desc_t *desc)
@@ -17994,6 +19677,13 @@ ecs_entity_t ecs_observer_init(
     ecs_check(!(world->flags & EcsWorldFini), ECS_INVALID_OPERATION,
         "cannot create observer while world is being deleted");
 
+    ecs_check(!desc->coalesce_phase || desc->coalesce, ECS_INVALID_PARAMETER,
+        "coalesce_phase requires coalesce");
+    ecs_check(!desc->multi_threaded || desc->coalesce, ECS_INVALID_PARAMETER,
+        "multi_threaded observers require coalesce");
+    ecs_check(!desc->coalesce || !desc->global_observer, 
+        ECS_INVALID_PARAMETER, "global observers cannot be coalesced");
+
     bool entity_created = false;
     entity = desc->entity;
     if (!entity && !desc->global_observer) {
@@ -18037,6 +19727,14 @@ ecs_entity_t ecs_observer_init(
         }
 
         flecs_poly_modified(world, entity, ecs_observer_t);
+
+        if (desc->coalesce_phase) {
+            if (flecs_observer_flush_system_init(
+                world, entity, desc->coalesce_phase)) 
+            {
+                goto error;
+            }
+        }
     }
 
     return entity;
@@ -18184,6 +19882,8 @@ void flecs_observer_fini(
         ecs_query_fini(impl->not_query);
     }
 
+    ecs_map_fini(&impl->coalesced);
+
     /* Cleanup context */
     if (o->ctx_free) {
         o->ctx_free(o->ctx);
@@ -19969,6 +21669,11 @@ ecs_ref_t ecs_ref_init_id(
 
     world = ecs_get_world(world);
 
+    ecs_check(!(flecs_component_get_flags(world, id) & EcsIdSoA), 
+        ECS_INVALID_OPERATION, 
+        "cannot create ref for SoA component '%s' (use its members instead)",
+            flecs_errstr(ecs_id_str(world, id)));
+
     flecs_check_exclusive_world_access_read(world);
 
     ecs_record_t *record = flecs_entities_get(world, entity);
@@ -20509,6 +22214,112 @@ int32_t flecs_relation_depth(
     return flecs_relation_depth_walk(world, cr, table, table);
 }
 
+/* Number of reserved entity ids a stage claims at a time */
+#define FLECS_ENTITY_RESERVE_BLOCK (64)
+
+static
+void flecs_stage_commit_new_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    int32_t i, count = ecs_vec_count(&stage->new_ids);
+    ecs_entity_t *ids = ecs_vec_first_t(&stage->new_ids, ecs_entity_t);
+    for (i = 0; i < count; i ++) {
+        /* Entities created in multithreaded mode don't have a table yet. Add
+         * them to the root table before commands are merged, unless a command
+         * for the stage already deleted the entity. */
+        ecs_record_t *r = flecs_entities_try(world, ids[i]);
+        if (r && !r->table) {
+            flecs_add_to_root_table(world, ids[i]);
+        }
+    }
+
+    world->reserved_used += count;
+    ecs_vec_clear(&stage->new_ids);
+}
+
+/* Grow the entity index so that stages can claim ids without reallocating
+ * storage that other threads may be reading. */
+static
+void flecs_stage_reserve_ids(
+    ecs_world_t *world)
+{
+    int32_t count = world->reserved_count + 
+        ecs_get_stage_count(world) * FLECS_ENTITY_RESERVE_BLOCK;
+    flecs_entities_reserve(world, count, false);
+    world->reserved_used = 0;
+
+    if (!world->reserved_mutex && ecs_os_has_threading()) {
+        world->reserved_mutex = ecs_os_mutex_new();
+    }
+}
+
+static
+void flecs_stage_release_ids(
+    ecs_world_t *world)
+{
+    /* Release ids in reverse order, so that ids that weren't used are recycled
+     * in the same order as if they were never claimed. */
+    int32_t s, stage_count = ecs_get_stage_count(world);
+    for (s = stage_count - 1; s >= 0; s --) {
+        ecs_stage_t *stage = world->stages[s];
+        int32_t i, count = ecs_vec_count(&stage->reserved_ids);
+        ecs_entity_t *ids = ecs_vec_first_t(
+            &stage->reserved_ids, ecs_entity_t);
+        for (i = count - 1; i >= stage->reserved_cur; i --) {
+            flecs_entities_release(world, ids[i]);
+        }
+
+        ecs_vec_clear(&stage->reserved_ids);
+        stage->reserved_cur = 0;
+    }
+
+    flecs_entities_free_retired(world);
+
+    int32_t used = world->reserved_used * 2;
+    world->reserved_count = ECS_MAX(FLECS_ENTITY_RESERVE_COUNT, used);
+}
+
+/* Claim a block of ids from the entity index. Other threads may read the entity
+ * index at the same time, so its storage is grown without freeing arrays. */
+static
+void flecs_stage_claim_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (world->reserved_mutex) {
+        ecs_os_mutex_lock(world->reserved_mutex);
+    }
+
+    flecs_entities_reserve(world, FLECS_ENTITY_RESERVE_BLOCK, true);
+    const uint64_t *ids = flecs_entities_new_ids(
+        world, FLECS_ENTITY_RESERVE_BLOCK);
+
+    ecs_vec_set_count_t(&stage->allocator, &stage->reserved_ids, 
+        ecs_entity_t, FLECS_ENTITY_RESERVE_BLOCK);
+    ecs_os_memcpy_n(ecs_vec_first(&stage->reserved_ids), ids, 
+        ecs_entity_t, FLECS_ENTITY_RESERVE_BLOCK);
+    stage->reserved_cur = 0;
+
+    if (world->reserved_mutex) {
+        ecs_os_mutex_unlock(world->reserved_mutex);
+    }
+}
+
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (stage->reserved_cur == ecs_vec_count(&stage->reserved_ids)) {
+        flecs_stage_claim_ids(world, stage);
+    }
+
+    ecs_entity_t e = ecs_vec_get_t(&stage->reserved_ids, ecs_entity_t, 
+        stage->reserved_cur ++)[0];
+    ecs_vec_append_t(&stage->allocator, &stage->new_ids, ecs_entity_t)[0] = e;
+    return e;
+}
+
 static
 void flecs_stage_merge(
     ecs_world_t *world)
@@ -20531,6 +22342,7 @@ void flecs_stage_merge(
         /* Check for consistency when merging a single stage. */
         ecs_assert(stage->defer == 1, ECS_INVALID_OPERATION, 
             "mismatching defer_begin/defer_end detected");
+        flecs_stage_commit_new_ids(world, stage);
         flecs_defer_end(world, stage);
     } else {
         /* Merge all stages */
@@ -20538,6 +22350,7 @@ void flecs_stage_merge(
         for (i = 0; i < count; i ++) {
             ecs_stage_t *s = (ecs_stage_t*)ecs_get_stage(world, i);
             flecs_poly_assert(s, ecs_stage_t);
+            flecs_stage_commit_new_ids(world, s);
             flecs_defer_end(world, s);
         }
     }
@@ -20601,6 +22414,9 @@ ecs_stage_t* flecs_stage_new(
 
     ecs_allocator_t *a = &stage->allocator;
     ecs_vec_init_t(a, &stage->post_frame_actions, ecs_action_elem_t, 0);
+    ecs_vec_init_t(a, &stage->cmd_partitions, ecs_vec_t, 0);
+    ecs_vec_init_t(a, &stage->reserved_ids, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &stage->new_ids, ecs_entity_t, 0);
 
     int32_t i;
     for (i = 0; i < 2; i ++) {
@@ -20626,6 +22442,15 @@ void flecs_stage_free(
     
     ecs_vec_fini_t(a, &stage->post_frame_actions, ecs_action_elem_t);
     ecs_vec_fini(NULL, &stage->variables, 0);
+
+    int32_t p, p_count = ecs_vec_count(&stage->cmd_partitions);
+    ecs_vec_t *partitions = ecs_vec_first_t(&stage->cmd_partitions, ecs_vec_t);
+    for (p = 0; p < p_count; p ++) {
+        ecs_vec_fini_t(a, &partitions[p], int32_t);
+    }
+    ecs_vec_fini_t(a, &stage->cmd_partitions, ecs_vec_t);
+    ecs_vec_fini_t(a, &stage->reserved_ids, ecs_entity_t);
+    ecs_vec_fini_t(a, &stage->new_ids, ecs_entity_t);
     ecs_vec_fini(NULL, &stage->operations, 0);
 
     int32_t i;
@@ -20804,6 +22629,12 @@ bool ecs_readonly_begin(
 
     bool is_readonly = ECS_BIT_IS_SET(world->flags, EcsWorldReadonly);
 
+    /* Make room in the entity index for entities created by stages, so that
+     * claiming ids doesn't reallocate the entity index while it's shared. */
+    if (multi_threaded && !is_readonly) {
+        flecs_stage_reserve_ids(world);
+    }
+
     /* From this point on, the world is "locked" for mutations, and it is only 
      * allowed to enqueue commands from stages */
     ECS_BIT_SET(world->flags, EcsWorldReadonly);
@@ -20826,10 +22657,36 @@ void ecs_readonly_end(
     ecs_log_pop_3();
 
     flecs_stage_merge(world);
+    flecs_stage_release_ids(world);
 error:
     return;
 }
 
+void flecs_stage_job_begin(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i, count = ecs_get_stage_count(world);
+    for (i = 0; i < count; i ++) {
+        flecs_defer_begin(world, world->stages[i]);
+    }
+
+    flecs_stage_reserve_ids(world);
+
+    ECS_BIT_SET(world->flags, EcsWorldMultiThreaded);
+}
+
+void flecs_stage_job_end(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ECS_BIT_CLEAR(world->flags, EcsWorldMultiThreaded);
+    flecs_stage_merge(world);
+    flecs_stage_release_ids(world);
+}
+
 ecs_world_t* flecs_suspend_readonly(
     const ecs_world_t *stage_world,
     ecs_suspend_readonly_state_t *state)
@@ -22300,9 +24157,10 @@ const ecs_type_info_t* ecs_get_type_info(
     world = ecs_get_world(world);
 
     ecs_component_record_t *cr = flecs_components_get(world, id);
-    if (cr) {
+    if (cr && !(cr->flags & EcsIdSoA)) {
         return cr->type_info;
     } else {
+        /* SoA components don't store data, but still have a type */
         return flecs_determine_type_info_for_component(world, id);
     }
 error:
@@ -22403,6 +24261,8 @@ const ecs_entity_t EcsPanic =                       FLECS_HI_COMPONENT_ID + 56;
 /* Storage */
 const ecs_entity_t EcsSparse =                      FLECS_HI_COMPONENT_ID + 57;
 const ecs_entity_t EcsDontFragment =                FLECS_HI_COMPONENT_ID + 58;
+const ecs_entity_t EcsSoA =                         FLECS_HI_COMPONENT_ID + 124;
+const ecs_entity_t EcsDenseToggle =                 FLECS_HI_COMPONENT_ID + 125;
 
 /* Misc */
 const ecs_entity_t ecs_id(EcsDefaultChildComponent) = FLECS_HI_COMPONENT_ID + 59;
@@ -22861,6 +24721,9 @@ void flecs_init_store(
 
     /* Initialize table map */
     flecs_table_hashmap_init(world, &world->store.table_map);
+
+    /* Initialize table transition cache */
+    flecs_graph_cache_init(world);
 }
 
 static
@@ -23021,6 +24884,7 @@ void flecs_fini_store(ecs_world_t *world) {
     flecs_table_fini(world, &world->store.root);
     flecs_entities_clear(world);
     flecs_hashmap_fini(&world->store.table_map);
+    flecs_graph_cache_fini(world);
 
     ecs_assert(ecs_vec_count(&world->store.marked_ids) == 0, 
         ECS_INTERNAL_ERROR, NULL);
@@ -23121,6 +24985,9 @@ static const char *flecs_addons_info[] = {
 #ifdef FLECS_JSON
     "FLECS_JSON",
 #endif
+#ifdef FLECS_SNAPSHOT
+    "FLECS_SNAPSHOT",
+#endif
 #ifdef FLECS_DOC
     "FLECS_DOC",
 #endif
@@ -23365,6 +25232,7 @@ ecs_world_t *ecs_mini(void) {
     flecs_name_index_init(&world->symbols, a);
     ecs_vec_init_t(a, &world->fini_actions, ecs_action_elem_t, 0);
     ecs_vec_init_t(a, &world->component_ids, ecs_id_t, 0);
+    world->reserved_count = FLECS_ENTITY_RESERVE_COUNT;
 
     world->info.time_scale = 1.0;
     if (ecs_os_has_time()) {
@@ -23687,6 +25555,9 @@ int ecs_fini(
     ecs_set_stage_count(world, 0);
     ecs_map_fini(&world->prefab_child_indices);
     ecs_vec_fini_t(&world->allocator, &world->component_ids, ecs_id_t);
+    if (world->reserved_mutex) {
+        ecs_os_mutex_free(world->reserved_mutex);
+    }
     ecs_log_pop_1();
 
     flecs_world_allocators_fini(world);
@@ -23770,6 +25641,21 @@ void ecs_set_default_query_flags(
     world->default_query_flags = flags;
 }
 
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    int32_t alignment)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(alignment >= 0 && alignment <= FLECS_MAX_COLUMN_ALIGNMENT,
+        ECS_INVALID_PARAMETER, "column alignment must be between 0 and %d",
+            FLECS_MAX_COLUMN_ALIGNMENT);
+    ecs_check(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER,
+        "column alignment must be a power of two");
+    world->column_alignment = alignment;
+error:
+    return;
+}
+
 void* ecs_get_ctx(
     const ecs_world_t *world)
 {
@@ -24226,6 +26112,258 @@ done:
     return result;
 }
 
+/* Phases of a compaction pass */
+#define FLECS_COMPACT_TABLES (0)
+#define FLECS_COMPACT_STORAGE (1)
+#define FLECS_COMPACT_ALLOCATORS (2)
+
+/* Number of tables to compact before checking the time budget */
+#define FLECS_COMPACT_TABLES_PER_MEASURE (16)
+
+static
+int64_t flecs_compact_table_size(
+    const ecs_table_t *table)
+{
+    int64_t size = table->data.size;
+    int64_t result = size * ECS_SIZEOF(ecs_entity_t);
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        result += size * table->data.columns[i].ti->size;
+    }
+    return result;
+}
+
+static
+bool flecs_compact_budget_exceeded(
+    const ecs_time_t *start,
+    double time_budget_seconds)
+{
+    if (ECS_EQZERO(time_budget_seconds)) {
+        return false;
+    }
+
+    ecs_time_t cur = *start;
+    return ecs_time_measure(&cur) > time_budget_seconds;
+}
+
+static
+bool flecs_compact_tables(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc,
+    const ecs_time_t *start,
+    int64_t *reclaimed)
+{
+    int32_t i = world->compact.offset;
+    int32_t measure_after = FLECS_COMPACT_TABLES_PER_MEASURE;
+
+    while (i < flecs_sparse_count(&world->store.tables)) {
+        if (!(-- measure_after)) {
+            if (flecs_compact_budget_exceeded(
+                start, desc->time_budget_seconds)) 
+            {
+                world->compact.offset = i;
+                return false;
+            }
+            measure_after = FLECS_COMPACT_TABLES_PER_MEASURE;
+        }
+
+        ecs_table_t *table = flecs_sparse_get_dense_t(&world->store.tables,
+            ecs_table_t, i);
+        if (!table->id || table->_->lock) {
+            i ++;
+            continue;
+        }
+
+        int32_t count = ecs_table_count(table);
+        if (count) {
+            /* Table is in use, restart counting empty passes */
+            table->_->generation = 0;
+            if (count <= (table->data.size / 2)) {
+                /* Leave room to grow, so that a table with a count that 
+                 * fluctuates isn't shrunk and grown again on every pass. */
+                int64_t size = flecs_compact_table_size(table);
+                flecs_table_shrink_to(world, table, count + count / 2);
+                reclaimed[0] += size - flecs_compact_table_size(table);
+            }
+            i ++;
+            continue;
+        }
+
+        if (table->keep) {
+            i ++;
+            continue;
+        }
+
+        uint16_t gen = ++ table->_->generation;
+        if (desc->delete_generation && (gen > desc->delete_generation)) {
+            reclaimed[0] += flecs_compact_table_size(table) + 
+                ECS_SIZEOF(ecs_table_t);
+            /* Deleting the table moves the last table to this index */
+            flecs_table_fini(world, table);
+            continue;
+        }
+
+        if (desc->clear_generation && (gen > desc->clear_generation)) {
+            int64_t size = flecs_compact_table_size(table);
+            flecs_table_shrink(world, table);
+            reclaimed[0] += size - flecs_compact_table_size(table);
+        }
+
+        i ++;
+    }
+
+    return true;
+}
+
+static
+int64_t flecs_compact_storage(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc)
+{
+    ecs_entity_index_t *index = &world->store.entity_index;
+    int32_t i, page_count = ecs_vec_count(&index->pages);
+    ecs_entity_index_page_t **pages = ecs_vec_first_t(&index->pages,
+        ecs_entity_index_page_t*);
+
+    int64_t size = ecs_vec_size(&index->dense) * ECS_SIZEOF(uint64_t);
+    size += ecs_vec_size(&index->pages) * ECS_SIZEOF(ecs_entity_index_page_t*);
+    for (i = 0; i < page_count; i ++) {
+        if (pages[i]) {
+            size += ECS_SIZEOF(ecs_entity_index_page_t);
+        }
+    }
+
+    if (desc->shrink_entity_index) {
+        flecs_entity_index_shrink(index);
+    } else {
+        ecs_vec_reclaim_t(index->allocator, &index->dense, uint64_t);
+    }
+
+    page_count = ecs_vec_count(&index->pages);
+    pages = ecs_vec_first_t(&index->pages, ecs_entity_index_page_t*);
+    size -= ecs_vec_size(&index->dense) * ECS_SIZEOF(uint64_t);
+    size -= ecs_vec_size(&index->pages) * ECS_SIZEOF(ecs_entity_index_page_t*);
+    for (i = 0; i < page_count; i ++) {
+        if (pages[i]) {
+            size -= ECS_SIZEOF(ecs_entity_index_page_t);
+        }
+    }
+
+    ecs_map_reclaim(&world->store.table_map.impl);
+    flecs_sparse_shrink(&world->store.tables);
+
+    return size;
+}
+
+static
+int64_t flecs_compact_allocator(
+    ecs_allocator_t *a)
+{
+    int64_t result = 0;
+#ifndef FLECS_USE_OS_ALLOC
+    int32_t i, count = flecs_sparse_count(&a->sizes);
+    for (i = 0; i < count; i ++) {
+        ecs_block_allocator_t *ba = flecs_sparse_get_dense_t(
+            &a->sizes, ecs_block_allocator_t, i);
+        result += flecs_ballocator_reclaim(ba);
+    }
+#else
+    (void)a;
+#endif
+    return result;
+}
+
+static
+bool flecs_compact_allocators(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc,
+    const ecs_time_t *start,
+    int64_t *reclaimed)
+{
+    /* Offset 0 is the world allocator, the other offsets are stages */
+    int32_t i = world->compact.offset;
+    for (; i <= world->stage_count; i ++) {
+        if (flecs_compact_budget_exceeded(start, desc->time_budget_seconds)) {
+            world->compact.offset = i;
+            return false;
+        }
+
+        if (!i) {
+            reclaimed[0] += flecs_compact_allocator(&world->allocator);
+        } else {
+            reclaimed[0] += flecs_compact_allocator(
+                &world->stages[i - 1]->allocator);
+        }
+    }
+
+    return true;
+}
+
+int64_t ecs_compact(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot compact while world is in readonly mode");
+    ecs_check(!world->stages[0]->defer, ECS_INVALID_OPERATION,
+        "cannot compact while world is deferred");
+
+    ecs_os_perf_trace_push("flecs.compact");
+
+    ecs_time_t start = {0};
+    if (ECS_NEQZERO(desc->time_budget_seconds)) {
+        ecs_time_measure(&start);
+    }
+
+    int64_t reclaimed = 0;
+
+    if (world->compact.phase == FLECS_COMPACT_TABLES) {
+        if (!flecs_compact_tables(world, desc, &start, &reclaimed)) {
+            goto done;
+        }
+        world->compact.phase = FLECS_COMPACT_STORAGE;
+        world->compact.offset = 0;
+    }
+
+    if (world->compact.phase == FLECS_COMPACT_STORAGE) {
+        reclaimed += flecs_compact_storage(world, desc);
+        world->compact.phase = FLECS_COMPACT_ALLOCATORS;
+        world->compact.offset = 0;
+    }
+
+    if (world->compact.phase == FLECS_COMPACT_ALLOCATORS) {
+        if (!flecs_compact_allocators(world, desc, &start, &reclaimed)) {
+            goto done;
+        }
+        world->compact.phase = FLECS_COMPACT_TABLES;
+        world->compact.offset = 0;
+    }
+
+done:
+    world->info.compact_reclaimed_total += reclaimed;
+    ecs_os_perf_trace_pop("flecs.compact");
+    return reclaimed;
+error:
+    return 0;
+}
+
+void ecs_set_compaction(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+
+    if (desc) {
+        world->compact.desc = *desc;
+        world->compact.enabled = true;
+    } else {
+        ecs_os_zeromem(&world->compact.desc);
+        world->compact.enabled = false;
+    }
+}
+
 ecs_entities_t ecs_get_entities(
     const ecs_world_t *world)
 {
@@ -28472,6 +30610,7 @@ typedef struct ecs_pipeline_op_t {
     int32_t count;              /* Number of systems to run before next op */
     double time_spent;          /* Time spent merging commands for sync point */
     int64_t commands_enqueued;  /* Number of commands enqueued for sync point */
+    double wait_time;           /* Time main thread waited for workers */
     bool multi_threaded;        /* Whether systems can be run multi-threaded */
     bool immediate;           /* Whether systems run in immediate mode */
 } ecs_pipeline_op_t;
@@ -28480,6 +30619,7 @@ struct ecs_pipeline_state_t {
     ecs_query_t *query;         /* Pipeline query */
     ecs_vec_t ops;              /* Pipeline schedule */
     ecs_vec_t systems;          /* Vector with system ids */
+    ecs_vec_t barriers;         /* Whether threads sync before system (bool) */
 
     ecs_entity_t last_system;   /* Last system run by pipeline */
     int32_t match_count;        /* Used to track if rebuild is necessary */
@@ -28534,6 +30674,9 @@ void flecs_signal_workers(
 void flecs_wait_for_sync(
     ecs_world_t *world);
 
+void flecs_worker_barrier(
+    ecs_world_t *world);
+
 #endif
 
 #ifndef FLECS_JSON_PRIVATE_H
@@ -29983,6 +32126,7 @@ void flecs_world_stats_to_json(
     ECS_COUNTER_APPEND(reply, stats, memory.stack_alloc_count, "Pages allocated by stack allocators");
     ECS_COUNTER_APPEND(reply, stats, memory.stack_free_count, "Pages freed by stack allocators");
     ECS_GAUGE_APPEND(reply, stats, memory.stack_outstanding_alloc_count, "Outstanding page allocations");
+    ECS_COUNTER_APPEND(reply, stats, memory.compact_reclaimed_bytes, "Bytes reclaimed by compaction");
 
     ECS_COUNTER_APPEND(reply, stats, http.request_received_count, "Received requests");
     ECS_COUNTER_APPEND(reply, stats, http.request_invalid_count, "Received invalid requests");
@@ -30038,6 +32182,7 @@ void flecs_sync_stats_to_json(
 
     ECS_GAUGE_APPEND_T(&reply->body, stats, time_spent, pstats->t, "");
     ECS_GAUGE_APPEND_T(&reply->body, stats, commands_enqueued, pstats->t, "");
+    ECS_GAUGE_APPEND_T(&reply->body, stats, wait_time, pstats->t, "");
 
     ecs_strbuf_list_pop(&reply->body, "}");
 }
@@ -31305,220 +33450,2906 @@ void FlecsRestImport(
 
 #endif
 
-#ifndef FLECS_SYSTEM_PRIVATE_H
-#define FLECS_SYSTEM_PRIVATE_H
-
-#ifdef FLECS_SYSTEM
-
-#define ecs_system_t_magic     (0x65637383)
-#define ecs_system_t_tag       EcsSystem
+#ifdef FLECS_SNAPSHOT
+
+#define FLECS_SNAPSHOT_MAGIC (0x4e534c46) /* "FLSN" */
+#define FLECS_SNAPSHOT_BYTE_ORDER (0x01020304)
+#define FLECS_SNAPSHOT_COLUMN_ALIGN (16)
+#define FLECS_SNAPSHOT_ALIGN (8)
+#define FLECS_SNAPSHOT_DIFF_MAGIC (0x46444c46) /* "FLDF" */
+#define FLECS_REPLICATOR_MAX_PENDING (64)
+
+/* How the values for an id in a table block are stored */
+typedef enum ecs_snapshot_kind_t {
+    EcsSnapshotTag,        /* No values */
+    EcsSnapshotRaw,        /* Raw column data */
+    EcsSnapshotParent,     /* Raw EcsParent values, restored with ecs_set() */
+    EcsSnapshotName,       /* (Identifier, Name) strings */
+    EcsSnapshotSymbol,     /* (Identifier, Symbol) strings */
+    EcsSnapshotAlias,      /* (Identifier, Alias) strings */
+    EcsSnapshotJson,       /* Values serialized with reflection data */
+    EcsSnapshotSkip        /* Id is not stored (writer only) */
+} ecs_snapshot_kind_t;
+
+/* Common start of snapshot and diff headers */
+typedef struct ecs_snapshot_preamble_t {
+    uint32_t magic;
+    uint32_t byte_order;
+    uint32_t version;
+    uint32_t pointer_size;
+} ecs_snapshot_preamble_t;
+
+typedef struct ecs_snapshot_header_t {
+    ecs_snapshot_preamble_t preamble;
+    uint32_t table_count;
+    uint32_t component_count;
+    uint64_t components_offset;
+    uint64_t max_id;
+} ecs_snapshot_header_t;
+
+typedef struct ecs_snapshot_component_t {
+    uint64_t id;
+    int32_t size;
+    int32_t alignment;
+    int32_t name_length;
+    int32_t reserved;
+} ecs_snapshot_component_t;
+
+typedef struct ecs_snapshot_diff_header_t {
+    ecs_snapshot_preamble_t preamble;
+    uint32_t table_count;       /* Blocks with entities that are new in table */
+    uint32_t update_count;      /* Blocks with changed columns */
+    uint32_t deleted_count;
+    uint32_t component_count;
+    uint64_t components_offset;
+    uint64_t frame;
+} ecs_snapshot_diff_header_t;
+
+typedef struct ecs_snapshot_table_header_t {
+    int32_t id_count;
+    int32_t count;
+} ecs_snapshot_table_header_t;
 
-extern ecs_mixins_t ecs_system_t_mixins;
+/* Table block in a snapshot that is being restored */
+typedef struct ecs_snapshot_table_t {
+    int32_t id_count;
+    int32_t count;
+    const ecs_id_t *ids;
+    const uint8_t *kinds;
+    const ecs_entity_t *entities;
+    int32_t blocks;        /* Offset into blocks vector of reader */
+} ecs_snapshot_table_t;
+
+typedef struct ecs_snapshot_reader_t {
+    const char *start;
+    const char *ptr;
+    const char *end;
+} ecs_snapshot_reader_t;
 
-/* Internal function to run a system */
-ecs_entity_t flecs_run_system(
-    ecs_world_t *world,
-    ecs_stage_t *stage,
-    ecs_entity_t system,
-    ecs_system_t *system_data,
-    int32_t stage_current,
-    int32_t stage_count,
-    ecs_ftime_t delta_time,
-    void *param);
+/* Table that is being serialized, with sort key */
+typedef struct ecs_snapshot_sort_t {
+    ecs_table_t *table;
+    int32_t depth;
+} ecs_snapshot_sort_t;
 
-#endif
+static
+void* flecs_snapshot_write(
+    ecs_vec_t *buf,
+    const void *data,
+    ecs_size_t size)
+{
+    void *dst = ecs_vec_grow_t(NULL, buf, char, size);
+    if (data) {
+        ecs_os_memcpy(dst, data, size);
+    } else {
+        ecs_os_memset(dst, 0, size);
+    }
+    return dst;
+}
 
-#endif
+/* Snapshot sizes are stored as ecs_size_t, which limits a snapshot to 2GB.
+ * Check that data of the specified size fits before writing it. */
+static
+int flecs_snapshot_write_check(
+    const ecs_vec_t *buf,
+    int64_t size)
+{
+    if (size > (int64_t)INT32_MAX - ecs_vec_count(buf)) {
+        ecs_err("snapshot: data exceeds maximum snapshot size of 2GB");
+        return -1;
+    }
+    return 0;
+}
 
-#ifdef FLECS_TIMER
+static
+void flecs_snapshot_write_align(
+    ecs_vec_t *buf,
+    ecs_size_t alignment)
+{
+    int32_t count = ecs_vec_count(buf);
+    int32_t padding = ECS_ALIGN(count, alignment) - count;
+    if (padding) {
+        flecs_snapshot_write(buf, NULL, padding);
+    }
+}
 
 static
-void ProgressTimers(ecs_iter_t *it) {
-    EcsTimer *timer = ecs_field(it, EcsTimer, 0);
-    EcsTickSource *tick_source = ecs_field(it, EcsTickSource, 1);
+bool flecs_snapshot_skip_parent(
+    const ecs_world_t *world,
+    ecs_entity_t parent)
+{
+    while (parent) {
+        if (parent == EcsFlecs || ecs_has_id(world, parent, EcsModule) ||
+            ecs_has(world, parent, EcsComponent))
+        {
+            return true;
+        }
+        parent = ecs_get_target(world, parent, EcsChildOf, 0);
+    }
+    return false;
+}
 
-    ecs_assert(timer != NULL, ECS_INTERNAL_ERROR, NULL);
+/* Skip tables with builtin entities, modules, components and entities with
+ * poly objects (queries, observers, systems), which are created by code. */
+static
+bool flecs_snapshot_skip_table(
+    const ecs_world_t *world,
+    const ecs_table_t *table)
+{
+    if (!ecs_table_count(table)) {
+        return true;
+    }
 
-    int i;
-    for (i = 0; i < it->count; i ++) {
-        tick_source[i].tick = false;
+    if (table->flags & EcsTableHasBuiltins) {
+        return true;
+    }
 
-        if (!timer[i].active) {
-            continue;
+    int32_t i, count = table->type.count;
+    for (i = 0; i < count; i ++) {
+        ecs_id_t id = table->type.array[i];
+        if (id == ecs_id(EcsComponent) || id == EcsModule) {
+            return true;
+        }
+        if (ECS_IS_PAIR(id) && ECS_PAIR_FIRST(id) == ecs_id(EcsPoly)) {
+            return true;
         }
+    }
 
-        const ecs_world_info_t *info = ecs_get_world_info(it->world);
-        ecs_ftime_t time_elapsed = timer[i].time + info->delta_time_raw;
-        ecs_ftime_t timeout = timer[i].timeout;
-        
-        if (time_elapsed >= timeout) {
-            ecs_ftime_t t = time_elapsed - timeout;
-            if (t > timeout) {
-                t = 0;
-            }
+    if (table->flags & EcsTableHasChildOf) {
+        ecs_entity_t parent = ecs_pair_second(world,
+            table->type.array[table->childof_index]);
+        return flecs_snapshot_skip_parent(world, parent);
+    }
 
-            timer[i].time = t; /* Initialize with remainder */
-            tick_source[i].tick = true;
-            tick_source[i].time_elapsed = time_elapsed - timer[i].overshoot;
-            timer[i].overshoot = t;
+    return false;
+}
 
-            if (timer[i].single_shot) {
-                timer[i].active = false;
+/* Tables are stored in order of hierarchy depth, so that parents are restored
+ * before their children. Prefabs are stored before other tables at the same
+ * depth, so that they are restored before their instances. */
+static
+int32_t flecs_snapshot_table_depth(
+    const ecs_world_t *world,
+    const ecs_table_t *table)
+{
+    int32_t depth = 0;
+
+    if (table->flags & EcsTableHasParent) {
+        int32_t i, count = table->type.count;
+        for (i = 0; i < count; i ++) {
+            ecs_id_t id = table->type.array[i];
+            if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+                depth = flecs_uto(int32_t, ECS_PAIR_SECOND(id));
+                break;
             }
-        } else {
-            timer[i].time = time_elapsed;
-        }  
+        }
+    } else if (table->flags & EcsTableHasChildOf) {
+        ecs_entity_t parent = ecs_pair_second(world,
+            table->type.array[table->childof_index]);
+        depth = ecs_get_depth(world, parent, EcsChildOf) + 1;
     }
+
+    return depth * 2 + !(table->flags & EcsTableIsPrefab);
 }
 
 static
-void ProgressRateFilters(ecs_iter_t *it) {
-    EcsRateFilter *filter = ecs_field(it, EcsRateFilter, 0);
-    EcsTickSource *tick_dst = ecs_field(it, EcsTickSource, 1);
+int flecs_snapshot_compare_table(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_snapshot_sort_t *t1 = ptr_1;
+    const ecs_snapshot_sort_t *t2 = ptr_2;
+    if (t1->depth != t2->depth) {
+        return (t1->depth > t2->depth) - (t1->depth < t2->depth);
+    }
+    return (t1->table->id > t2->table->id) - (t1->table->id < t2->table->id);
+}
 
-    int i;
-    for (i = 0; i < it->count; i ++) {
-        ecs_entity_t src = filter[i].src;
-        bool inc = false;
+static
+ecs_snapshot_kind_t flecs_snapshot_id_kind(
+    const ecs_world_t *world,
+    ecs_id_t id,
+    const ecs_type_info_t **ti_out)
+{
+    *ti_out = NULL;
 
-        filter[i].time_elapsed += it->delta_time;
+    if (ECS_IS_VALUE_PAIR(id)) {
+        return EcsSnapshotTag;
+    }
 
-        if (src) {
-            const EcsTickSource *tick_src = ecs_get(
-                it->world, src, EcsTickSource);
-            if (tick_src) {
-                inc = tick_src->tick;
-            } else {
-                inc = true;
+    if (ECS_IS_PAIR(id)) {
+        if (ECS_PAIR_FIRST(id) == ecs_id(EcsIdentifier)) {
+            *ti_out = ecs_get_type_info(world, id);
+            if (id == ecs_pair_t(EcsIdentifier, EcsName)) {
+                return EcsSnapshotName;
+            } else if (id == ecs_pair_t(EcsIdentifier, EcsSymbol)) {
+                return EcsSnapshotSymbol;
+            } else if (id == ecs_pair_t(EcsIdentifier, EcsAlias)) {
+                return EcsSnapshotAlias;
             }
-        } else {
-            inc = true;
-        }
-
-        if (inc) {
-            filter[i].tick_count ++;
-            bool triggered = !(filter[i].tick_count % filter[i].rate);
-            tick_dst[i].tick = triggered;
-            tick_dst[i].time_elapsed = filter[i].time_elapsed;
-
-            if (triggered) {
-                filter[i].time_elapsed = 0;
-            }            
-        } else {
-            tick_dst[i].tick = false;
+            return EcsSnapshotSkip;
         }
+    } else if (id & ECS_ID_FLAGS_MASK) {
+        return EcsSnapshotTag;
     }
-}
 
-static
-void ProgressTickSource(ecs_iter_t *it) {
-    EcsTickSource *tick_src = ecs_field(it, EcsTickSource, 0);
+    /* SoA components don't have a column. Their data is stored in the columns
+     * of the member components, which are serialized separately. */
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    if (cr && (cr->flags & EcsIdSoA)) {
+        return EcsSnapshotTag;
+    }
 
-    /* If tick source has no filters, tick unconditionally */
-    int i;
-    for (i = 0; i < it->count; i ++) {
-        tick_src[i].tick = true;
-        tick_src[i].time_elapsed = it->delta_time;
+    const ecs_type_info_t *ti = ecs_get_type_info(world, id);
+    if (!ti) {
+        return EcsSnapshotTag;
     }
-}
 
-ecs_entity_t ecs_set_timeout(
-    ecs_world_t *world,
-    ecs_entity_t timer,
-    ecs_ftime_t timeout)
-{
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    *ti_out = ti;
 
-    if (!timer) {
-        timer = ecs_entity(world, {0});
+    if (id == ecs_id(EcsParent)) {
+        return EcsSnapshotParent;
     }
 
-    ecs_set(world, timer, EcsTimer, {
-        .timeout = timeout,
-        .single_shot = true,
-        .active = true
-    });
+    if (!ti->hooks.copy && !ti->hooks.move && !ti->hooks.dtor &&
+        !(ti->hooks.flags & ECS_TYPE_HOOK_COPY_ILLEGAL))
+    {
+        return EcsSnapshotRaw;
+    }
 
-    ecs_system_t *system_data = flecs_poly_get(world, timer, ecs_system_t);
-    if (system_data) {
-        system_data->tick_source = timer;
+    if (ecs_has(world, ti->component, EcsTypeSerializer)) {
+        return EcsSnapshotJson;
     }
 
-error:
-    return timer;
+    return EcsSnapshotSkip;
 }
 
-ecs_ftime_t ecs_get_timeout(
+static
+const void* flecs_snapshot_get_ptr(
     const ecs_world_t *world,
-    ecs_entity_t timer)
+    const ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    ecs_id_t id,
+    ecs_size_t size)
 {
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
-    ecs_check(timer != 0, ECS_INVALID_PARAMETER, NULL);
-
-    const EcsTimer *value = ecs_get(world, timer, EcsTimer);
-    if (value) {
-        return value->timeout;
+    if (column != -1) {
+        return ECS_ELEM(ecs_table_get_column(table, column, 0), size, row);
+    } else {
+        /* Sparse component */
+        return ecs_get_id(world, ecs_table_entities(table)[row], id);
     }
-error:
-    return 0;
 }
 
-ecs_entity_t ecs_set_interval(
-    ecs_world_t *world,
-    ecs_entity_t timer,
-    ecs_ftime_t interval)
+static
+int32_t flecs_snapshot_row(
+    const int32_t *rows,
+    int32_t index)
 {
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    return rows ? rows[index] : index;
+}
 
-    if (!timer) {
-        timer = ecs_new_w(world, EcsTimer);
+static
+int flecs_snapshot_write_strings(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    const int32_t *rows,
+    int32_t count,
+    ecs_id_t id,
+    ecs_snapshot_kind_t kind,
+    const ecs_type_info_t *ti,
+    ecs_vec_t *buf)
+{
+    int32_t i;
+    int32_t column = ecs_table_get_column_index(world, table, id);
+    int32_t lengths = ecs_vec_count(buf);
+    if (flecs_snapshot_write_check(buf, 
+        (int64_t)count * ECS_SIZEOF(int32_t) + FLECS_SNAPSHOT_ALIGN)) 
+    {
+        return -1;
     }
 
-    EcsTimer *t = ecs_ensure(world, timer, EcsTimer);
-    ecs_check(t != NULL, ECS_INTERNAL_ERROR, NULL);
-    t->timeout = interval;
-    t->active = true;
-    ecs_modified(world, timer, EcsTimer);
+    flecs_snapshot_write(buf, NULL, count * ECS_SIZEOF(int32_t));
+    flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
 
-    ecs_system_t *system_data = flecs_poly_get(world, timer, ecs_system_t);
-    if (system_data) {
-        system_data->tick_source = timer;
+    for (i = 0; i < count; i ++) {
+        const void *ptr = flecs_snapshot_get_ptr(world, table, column,
+            flecs_snapshot_row(rows, i), id, ti->size);
+        const char *str = NULL;
+        char *json = NULL;
+
+        if (kind == EcsSnapshotJson) {
+            json = ecs_ptr_to_json(world, ti->component, ptr);
+            if (!json) {
+                char *id_str = ecs_id_str(world, id);
+                ecs_err("snapshot: failed to serialize value of '%s'", id_str);
+                ecs_os_free(id_str);
+                return -1;
+            }
+            str = json;
+        } else {
+            str = ((const EcsIdentifier*)ptr)->value;
+        }
+
+        int32_t length = -1;
+        if (str) {
+            length = ecs_os_strlen(str);
+            if (flecs_snapshot_write_check(buf, 
+                (int64_t)length + 1 + FLECS_SNAPSHOT_ALIGN)) 
+            {
+                ecs_os_free(json);
+                return -1;
+            }
+            flecs_snapshot_write(buf, str, length + 1);
+        }
+
+        int32_t *lengths_ptr = ECS_OFFSET(ecs_vec_first(buf), lengths);
+        lengths_ptr[i] = length;
+
+        ecs_os_free(json);
     }
-error:
-    return timer;  
+
+    flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+
+    return 0;
 }
 
-ecs_ftime_t ecs_get_interval(
+/* Write a table block. When rows is NULL, all rows of the table are written,
+ * otherwise only the specified rows. When include is not NULL, only ids for
+ * which include is true are written. */
+static
+int flecs_snapshot_write_table(
     const ecs_world_t *world,
-    ecs_entity_t timer)
+    const ecs_table_t *table,
+    const int32_t *rows,
+    int32_t count,
+    const bool *include,
+    ecs_map_t *components,
+    ecs_vec_t *buf)
 {
-    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    int32_t i, id_count = 0, type_count = table->type.count;
+    uint8_t *kinds = ecs_os_malloc_n(uint8_t, type_count + 1);
+    const ecs_type_info_t **type_info = ecs_os_malloc_n(
+        const ecs_type_info_t*, type_count + 1);
 
-    if (!timer) {
-        return 0;
+    /* Size of the block without strings, including worst case padding */
+    int64_t block_size = ECS_SIZEOF(ecs_snapshot_table_header_t) + 
+        FLECS_SNAPSHOT_ALIGN + (int64_t)count * ECS_SIZEOF(ecs_entity_t);
+
+    for (i = 0; i < type_count; i ++) {
+        kinds[i] = flecs_ito(uint8_t, flecs_snapshot_id_kind(
+            world, table->type.array[i], &type_info[i]));
+        if (include && !include[i]) {
+            kinds[i] = EcsSnapshotSkip;
+        }
+        if (kinds[i] != EcsSnapshotSkip) {
+            id_count ++;
+            block_size += ECS_SIZEOF(ecs_id_t) + 1;
+        }
+        if (kinds[i] == EcsSnapshotRaw || kinds[i] == EcsSnapshotParent) {
+            block_size += (int64_t)type_info[i]->size * count + 
+                FLECS_SNAPSHOT_COLUMN_ALIGN + FLECS_SNAPSHOT_ALIGN;
+        }
     }
 
-    const EcsTimer *value = ecs_get(world, timer, EcsTimer);
-    if (value) {
-        return value->timeout;
+    if (flecs_snapshot_write_check(buf, block_size)) {
+        goto error;
     }
-error:
-    return 0;
-}
 
-void ecs_start_timer(
-    ecs_world_t *world,
-    ecs_entity_t timer)
-{
-    EcsTimer *ptr = ecs_ensure(world, timer, EcsTimer);
-    ecs_check(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
-    ptr->active = true;
-    ptr->time = 0;
-error:
-    return;
-}
+    ecs_snapshot_table_header_t hdr = {
+        .id_count = id_count,
+        .count = count
+    };
 
-void ecs_stop_timer(
+    flecs_snapshot_write(buf, &hdr, ECS_SIZEOF(hdr));
+
+    for (i = 0; i < type_count; i ++) {
+        if (kinds[i] != EcsSnapshotSkip) {
+            flecs_snapshot_write(buf, &table->type.array[i], ECS_SIZEOF(ecs_id_t));
+        }
+    }
+
+    for (i = 0; i < type_count; i ++) {
+        if (kinds[i] != EcsSnapshotSkip) {
+            flecs_snapshot_write(buf, &kinds[i], 1);
+        }
+    }
+
+    flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    if (!rows) {
+        flecs_snapshot_write(buf, entities, count * ECS_SIZEOF(ecs_entity_t));
+    } else {
+        for (i = 0; i < count; i ++) {
+            flecs_snapshot_write(buf, &entities[rows[i]], ECS_SIZEOF(ecs_entity_t));
+        }
+    }
+
+    for (i = 0; i < type_count; i ++) {
+        ecs_snapshot_kind_t kind = kinds[i];
+        if (kind == EcsSnapshotSkip || kind == EcsSnapshotTag) {
+            continue;
+        }
+
+        ecs_id_t id = table->type.array[i];
+        const ecs_type_info_t *ti = type_info[i];
+        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_map_ensure(components, id);
+
+        if (kind == EcsSnapshotRaw || kind == EcsSnapshotParent) {
+            ecs_size_t size = ti->size;
+            int32_t column = ecs_table_get_column_index(world, table, id);
+            flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_COLUMN_ALIGN);
+            if (column != -1 && !rows) {
+                flecs_snapshot_write(buf,
+                    ecs_table_get_column(table, column, 0), size * count);
+            } else {
+                int32_t row;
+                for (row = 0; row < count; row ++) {
+                    flecs_snapshot_write(buf, flecs_snapshot_get_ptr(world,
+                        table, column, flecs_snapshot_row(rows, row), id, size),
+                            size);
+                }
+            }
+            flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+        } else {
+            if (flecs_snapshot_write_strings(
+                world, table, rows, count, id, kind, ti, buf))
+            {
+                goto error;
+            }
+        }
+    }
+
+    ecs_os_free(kinds);
+    ecs_os_free(type_info);
+    return 0;
+error:
+    ecs_os_free(kinds);
+    ecs_os_free(type_info);
+    return -1;
+}
+
+static
+void flecs_snapshot_write_components(
+    const ecs_world_t *world,
+    ecs_map_t *components,
+    ecs_vec_t *buf)
+{
+    ecs_map_iter_t it = ecs_map_iter(components);
+    while (ecs_map_next(&it)) {
+        ecs_id_t id = ecs_map_key(&it);
+        const ecs_type_info_t *ti = ecs_get_type_info(world, id);
+        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        char *path = ecs_get_path(world, ti->component);
+        ecs_snapshot_component_t c = {
+            .id = id,
+            .size = ti->size,
+            .alignment = ti->alignment,
+            .name_length = ecs_os_strlen(path) + 1
+        };
+
+        flecs_snapshot_write(buf, &c, ECS_SIZEOF(c));
+        flecs_snapshot_write(buf, path, c.name_length);
+        flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+        ecs_os_free(path);
+    }
+}
+
+static
+void flecs_snapshot_init_preamble(
+    ecs_snapshot_preamble_t *preamble,
+    uint32_t magic)
+{
+    preamble->magic = magic;
+    preamble->byte_order = FLECS_SNAPSHOT_BYTE_ORDER;
+    preamble->version = ECS_SNAPSHOT_VERSION;
+    preamble->pointer_size = (uint32_t)sizeof(void*);
+}
+
+void* ecs_world_to_binary(
+    const ecs_world_t *world,
+    ecs_size_t *size_out)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size_out != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    world = ecs_get_world(world);
+    ecs_world_t *mut_world = ECS_CONST_CAST(ecs_world_t*, world);
+
+    /* Collect tables and sort them so parents are stored before children */
+    ecs_vec_t tables;
+    ecs_vec_init_t(NULL, &tables, ecs_snapshot_sort_t, 0);
+
+    const ecs_sparse_t *store = &world->store.tables;
+    int32_t i, table_count = flecs_sparse_count(store);
+    for (i = -1; i < table_count; i ++) {
+        ecs_table_t *table = i == -1 ? &mut_world->store.root :
+            flecs_sparse_get_dense_t(store, ecs_table_t, i);
+        if (i != -1 && table == &world->store.root) {
+            continue;
+        }
+        if (flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_snapshot_sort_t *elem = ecs_vec_append_t(
+            NULL, &tables, ecs_snapshot_sort_t);
+        elem->table = table;
+        elem->depth = flecs_snapshot_table_depth(world, table);
+    }
+
+    table_count = ecs_vec_count(&tables);
+    ecs_snapshot_sort_t *sorted = ecs_vec_first(&tables);
+    if (table_count > 1) {
+        qsort(sorted, flecs_itosize(table_count), sizeof(ecs_snapshot_sort_t),
+            flecs_snapshot_compare_table);
+    }
+
+    ecs_vec_t buf;
+    ecs_vec_init_t(NULL, &buf, char, 4096);
+
+    ecs_map_t components;
+    ecs_map_init(&components, &mut_world->allocator);
+
+    flecs_snapshot_write(&buf, NULL, ECS_SIZEOF(ecs_snapshot_header_t));
+
+    for (i = 0; i < table_count; i ++) {
+        if (flecs_snapshot_write_table(world, sorted[i].table, NULL,
+            ecs_table_count(sorted[i].table), NULL, &components, &buf))
+        {
+            goto error;
+        }
+    }
+
+    uint64_t components_offset = flecs_ito(uint64_t, ecs_vec_count(&buf));
+    flecs_snapshot_write_components(world, &components, &buf);
+
+    ecs_snapshot_header_t *hdr = ecs_vec_first(&buf);
+    flecs_snapshot_init_preamble(&hdr->preamble, FLECS_SNAPSHOT_MAGIC);
+    hdr->table_count = flecs_ito(uint32_t, table_count);
+    hdr->component_count = flecs_ito(uint32_t, components.count);
+    hdr->components_offset = components_offset;
+    hdr->max_id = flecs_entities_max_id(world);
+
+    ecs_map_fini(&components);
+    ecs_vec_fini_t(NULL, &tables, ecs_snapshot_sort_t);
+
+    *size_out = ecs_vec_count(&buf);
+    return ecs_vec_first(&buf);
+error:
+    ecs_map_fini(&components);
+    ecs_vec_fini_t(NULL, &tables, ecs_snapshot_sort_t);
+    ecs_vec_fini_t(NULL, &buf, char);
+    return NULL;
+}
+
+static
+const void* flecs_snapshot_read(
+    ecs_snapshot_reader_t *r,
+    ecs_size_t size)
+{
+    if (size < 0 || (r->end - r->ptr) < size) {
+        ecs_err("snapshot: unexpected end of data");
+        return NULL;
+    }
+
+    const void *result = r->ptr;
+    r->ptr += size;
+    return result;
+}
+
+/* Read an array. The count is checked against the remaining data before the
+ * size of the array is computed, so that a corrupt count can't overflow. */
+static
+const void* flecs_snapshot_read_n(
+    ecs_snapshot_reader_t *r,
+    ecs_size_t elem_size,
+    int64_t count)
+{
+    if (count < 0 || count > (r->end - r->ptr) / elem_size) {
+        ecs_err("snapshot: unexpected end of data");
+        return NULL;
+    }
+
+    return flecs_snapshot_read(r, (ecs_size_t)count * elem_size);
+}
+
+static
+int flecs_snapshot_read_align(
+    ecs_snapshot_reader_t *r,
+    ecs_size_t alignment)
+{
+    ecs_size_t offset = flecs_ito(ecs_size_t, r->ptr - r->start);
+    ecs_size_t padding = ECS_ALIGN(offset, alignment) - offset;
+    if (padding && !flecs_snapshot_read(r, padding)) {
+        return -1;
+    }
+    return 0;
+}
+
+static
+int flecs_snapshot_read_preamble(
+    const ecs_snapshot_preamble_t *preamble,
+    uint32_t magic,
+    const char *what)
+{
+    if (preamble->magic != magic) {
+        ecs_err("snapshot: data is not a %s", what);
+        return -1;
+    }
+
+    if (preamble->byte_order != FLECS_SNAPSHOT_BYTE_ORDER ||
+        preamble->pointer_size != sizeof(void*))
+    {
+        ecs_err("snapshot: %s was created on an incompatible platform", what);
+        return -1;
+    }
+
+    if (preamble->version != ECS_SNAPSHOT_VERSION) {
+        ecs_err("snapshot: unsupported version %u (expected %u)",
+            preamble->version, ECS_SNAPSHOT_VERSION);
+        return -1;
+    }
+
+    return 0;
+}
+
+static
+int flecs_snapshot_read_components(
+    ecs_world_t *world,
+    uint32_t component_count,
+    ecs_snapshot_reader_t *r)
+{
+    uint32_t i;
+    for (i = 0; i < component_count; i ++) {
+        const ecs_snapshot_component_t *c = flecs_snapshot_read(
+            r, ECS_SIZEOF(ecs_snapshot_component_t));
+        if (!c) {
+            return -1;
+        }
+
+        const char *name = flecs_snapshot_read(r, c->name_length);
+        if (!name || !c->name_length || name[c->name_length - 1]) {
+            ecs_err("snapshot: invalid component name");
+            return -1;
+        }
+
+        if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+            return -1;
+        }
+
+        const ecs_type_info_t *ti = NULL;
+        if (ecs_id_is_valid(world, c->id)) {
+            ti = ecs_get_type_info(world, c->id);
+        }
+
+        if (!ti) {
+            ecs_err("snapshot: component '%s' is not registered", name);
+            return -1;
+        }
+
+        if (ti->size != c->size || ti->alignment != c->alignment) {
+            ecs_err("snapshot: component '%s' has size %d and alignment %d, "
+                "snapshot has %d and %d", name, ti->size, ti->alignment,
+                c->size, c->alignment);
+            return -1;
+        }
+
+        char *path = ecs_get_path(world, ti->component);
+        bool match = !ecs_os_strcmp(path, name);
+        if (!match) {
+            ecs_err("snapshot: component id %u is '%s', snapshot has '%s'",
+                (uint32_t)ti->component, path, name);
+        }
+        ecs_os_free(path);
+        if (!match) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static
+int flecs_snapshot_read_strings(
+    ecs_snapshot_reader_t *r,
+    int32_t count)
+{
+    const int32_t *lengths = flecs_snapshot_read_n(
+        r, ECS_SIZEOF(int32_t), count);
+    if (!lengths || flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+        return -1;
+    }
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        int32_t length = lengths[i];
+        if (length < -1) {
+            ecs_err("snapshot: invalid string length");
+            return -1;
+        }
+        if (length == -1) {
+            continue;
+        }
+
+        const char *str = flecs_snapshot_read_n(r, 1, (int64_t)length + 1);
+        if (!str || str[length]) {
+            ecs_err("snapshot: invalid string");
+            return -1;
+        }
+    }
+
+    return flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN);
+}
+
+static
+bool flecs_snapshot_entity_exists(
+    const ecs_world_t *world,
+    const ecs_map_t *entities,
+    ecs_entity_t e)
+{
+    if (!e) {
+        return false;
+    }
+    return ecs_get_alive(world, (uint32_t)e) != 0 ||
+        ecs_map_get(entities, (uint32_t)e) != NULL;
+}
+
+static
+bool flecs_snapshot_id_exists(
+    const ecs_world_t *world,
+    const ecs_map_t *entities,
+    ecs_id_t id)
+{
+    if (ECS_IS_PAIR(id)) {
+        if (!flecs_snapshot_entity_exists(world, entities, ECS_PAIR_FIRST(id))) {
+            return false;
+        }
+        if (ECS_IS_VALUE_PAIR(id)) {
+            return true;
+        }
+        return flecs_snapshot_entity_exists(
+            world, entities, ECS_PAIR_SECOND(id));
+    }
+    return flecs_snapshot_entity_exists(world, entities, id & ECS_COMPONENT_MASK);
+}
+
+/* Parse a table block and verify that it can be restored. Entities that are
+ * alive with a different generation are only allowed if they are in the
+ * deleted map, which contains the entities that a diff deletes. */
+static
+int flecs_snapshot_read_table(
+    ecs_world_t *world,
+    ecs_snapshot_reader_t *r,
+    ecs_snapshot_table_t *t,
+    ecs_vec_t *blocks,
+    ecs_map_t *entities,
+    const ecs_map_t *deleted)
+{
+    const ecs_snapshot_table_header_t *hdr = flecs_snapshot_read(
+        r, ECS_SIZEOF(ecs_snapshot_table_header_t));
+    if (!hdr) {
+        return -1;
+    }
+
+    if (hdr->id_count < 0 || hdr->count < 0) {
+        ecs_err("snapshot: invalid table");
+        return -1;
+    }
+
+    t->id_count = hdr->id_count;
+    t->count = hdr->count;
+    t->ids = flecs_snapshot_read_n(r, ECS_SIZEOF(ecs_id_t), t->id_count);
+    t->kinds = flecs_snapshot_read(r, t->id_count);
+    if (!t->ids || !t->kinds) {
+        return -1;
+    }
+
+    if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+        return -1;
+    }
+
+    t->entities = flecs_snapshot_read_n(
+        r, ECS_SIZEOF(ecs_entity_t), t->count);
+    if (!t->entities) {
+        return -1;
+    }
+
+    int32_t i;
+    for (i = 0; i < t->count; i ++) {
+        ecs_entity_t e = t->entities[i];
+        ecs_entity_t alive = ecs_get_alive(world, (uint32_t)e);
+        if (alive && alive != e && !(deleted && ecs_map_get(deleted, alive))) {
+            ecs_err("snapshot: entity %u is alive with a different "
+                "generation (%u vs %u)", (uint32_t)e,
+                    (uint32_t)(alive >> 32), (uint32_t)(e >> 32));
+            return -1;
+        }
+
+        ecs_map_ensure(entities, (uint32_t)e);
+    }
+
+    t->blocks = ecs_vec_count(blocks);
+
+    for (i = 0; i < t->id_count; i ++) {
+        ecs_id_t id = t->ids[i];
+        ecs_snapshot_kind_t kind = t->kinds[i];
+        const void **block = ecs_vec_append_t(NULL, blocks, const void*);
+        *block = NULL;
+
+        if (kind == EcsSnapshotTag) {
+            continue;
+        }
+
+        if (kind >= EcsSnapshotSkip) {
+            ecs_err("snapshot: invalid value encoding");
+            return -1;
+        }
+
+        const ecs_type_info_t *ti = NULL;
+        if (ecs_id_is_valid(world, id)) {
+            ti = ecs_get_type_info(world, id);
+        }
+
+        if (!ti || !ti->size) {
+            ecs_err("snapshot: no component registered for table column");
+            return -1;
+        }
+
+        if (kind == EcsSnapshotRaw || kind == EcsSnapshotParent) {
+            if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_COLUMN_ALIGN)) {
+                return -1;
+            }
+
+            *block = flecs_snapshot_read_n(r, ti->size, t->count);
+            if (!*block) {
+                return -1;
+            }
+
+            if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+                return -1;
+            }
+        } else {
+            *block = r->ptr;
+            if (flecs_snapshot_read_strings(r, t->count)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Entities that are used in a type must have a table before the type is
+ * created, as creating a component record can add flags to entities. */
+static
+void flecs_snapshot_ensure_table(
+    ecs_world_t *world,
+    ecs_entity_t e)
+{
+    ecs_record_t *r = flecs_entities_get_any(world, e);
+    if (r && !r->table) {
+        flecs_add_to_root_table(world, ecs_get_alive(world, e));
+    }
+}
+
+static
+void flecs_snapshot_ensure_id(
+    ecs_world_t *world,
+    ecs_id_t id)
+{
+    if (ECS_IS_PAIR(id)) {
+        flecs_snapshot_ensure_table(world, ECS_PAIR_FIRST(id));
+        if (!ECS_IS_VALUE_PAIR(id)) {
+            flecs_snapshot_ensure_table(world, ECS_PAIR_SECOND(id));
+        }
+    } else {
+        flecs_snapshot_ensure_table(world, id & ECS_COMPONENT_MASK);
+    }
+}
+
+/* Cursor that walks the values of a string block, one row at a time */
+typedef struct ecs_snapshot_strings_t {
+    const int32_t *lengths;
+    const char *cur;
+} ecs_snapshot_strings_t;
+
+static
+void flecs_snapshot_strings_init(
+    ecs_snapshot_strings_t *s,
+    const char *start,
+    const void *block,
+    int32_t count)
+{
+    s->lengths = block;
+    ecs_size_t offset = flecs_ito(ecs_size_t,
+        ((const char*)block - start) + count * ECS_SIZEOF(int32_t));
+    s->cur = ECS_OFFSET(start, ECS_ALIGN(offset, FLECS_SNAPSHOT_ALIGN));
+}
+
+static
+const char* flecs_snapshot_strings_next(
+    ecs_snapshot_strings_t *s,
+    int32_t row)
+{
+    int32_t length = s->lengths[row];
+    if (length == -1) {
+        return NULL;
+    }
+
+    const char *result = s->cur;
+    s->cur += length + 1;
+    return result;
+}
+
+/* Restore values that are not copied in bulk for a single entity. When all is
+ * true, all ids of the table are restored with regular operations. */
+static
+int flecs_snapshot_restore_row(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    const void **blocks,
+    ecs_snapshot_strings_t *strings,
+    int32_t row,
+    bool all)
+{
+    ecs_entity_t e = t->entities[row];
+    int32_t i;
+
+    for (i = 0; i < t->id_count; i ++) {
+        ecs_id_t id = t->ids[i];
+        ecs_snapshot_kind_t kind = t->kinds[i];
+        const ecs_type_info_t *ti = NULL;
+        const char *str = NULL;
+
+        if ((kind == EcsSnapshotRaw && all) || kind == EcsSnapshotJson) {
+            ti = ecs_get_type_info(world, id);
+            ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+        }
+
+        if (kind == EcsSnapshotJson || (all && kind >= EcsSnapshotName)) {
+            str = flecs_snapshot_strings_next(&strings[i], row);
+        }
+
+        switch(kind) {
+        case EcsSnapshotTag:
+            if (all && !(ECS_IS_VALUE_PAIR(id) &&
+                ECS_PAIR_FIRST(id) == EcsParentDepth))
+            {
+                ecs_add_id(world, e, id);
+            }
+            break;
+        case EcsSnapshotRaw:
+            if (all) {
+                ecs_set_id(world, e, id, flecs_itosize(ti->size),
+                    ECS_ELEM(blocks[i], ti->size, row));
+            }
+            break;
+        case EcsSnapshotParent: {
+            const EcsParent *p = ECS_ELEM_T(blocks[i], EcsParent, row);
+            if (p->value) {
+                flecs_snapshot_ensure_table(world, p->value);
+            }
+            ecs_set_id(world, e, id, sizeof(EcsParent), p);
+            break;
+        }
+        case EcsSnapshotName:
+            if (all && str) {
+                ecs_set_name(world, e, str);
+            }
+            break;
+        case EcsSnapshotSymbol:
+            if (all && str) {
+                ecs_set_symbol(world, e, str);
+            }
+            break;
+        case EcsSnapshotAlias:
+            if (all && str) {
+                ecs_set_alias(world, e, str);
+            }
+            break;
+        case EcsSnapshotJson: {
+            void *ptr = ecs_ensure_id(world, e, id, flecs_itosize(ti->size));
+            if (str && !ecs_ptr_from_json(world, ti->component, ptr, str, NULL)) {
+                return -1;
+            }
+            ecs_modified_id(world, e, id);
+            break;
+        }
+        case EcsSnapshotSkip:
+        default:
+            ecs_abort(ECS_INTERNAL_ERROR, NULL);
+        }
+    }
+
+    return 0;
+}
+
+/* Remove ids from an entity that would have been stored, but that are not in
+ * the table block. Used by diffs, where an entity block contains all ids. */
+static
+void flecs_snapshot_remove_missing(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    ecs_entity_t e)
+{
+    const ecs_type_t *type = ecs_get_type(world, e);
+    if (!type || !type->count) {
+        return;
+    }
+
+    ecs_id_t *remove = ecs_os_malloc_n(ecs_id_t, type->count);
+    int32_t i, j, remove_count = 0;
+
+    for (i = 0; i < type->count; i ++) {
+        ecs_id_t id = type->array[i];
+        const ecs_type_info_t *ti;
+        if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+            continue;
+        }
+        if (flecs_snapshot_id_kind(world, id, &ti) == EcsSnapshotSkip) {
+            continue;
+        }
+        for (j = 0; j < t->id_count; j ++) {
+            if (t->ids[j] == id) {
+                break;
+            }
+        }
+        if (j == t->id_count) {
+            remove[remove_count ++] = id;
+        }
+    }
+
+    for (i = 0; i < remove_count; i ++) {
+        ecs_remove_id(world, e, remove[i]);
+    }
+
+    ecs_os_free(remove);
+}
+
+static
+int flecs_snapshot_restore_table(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    const void **blocks,
+    const char *start,
+    bool exact)
+{
+    int32_t i, id_count = t->id_count, count = t->count;
+    if (!count) {
+        return 0;
+    }
+
+    /* Ids that are restored in bulk. The Parent component is assigned with
+     * ecs_set(), which moves the entity to the table with the right depth. */
+    ecs_id_t *ids = ecs_os_malloc_n(ecs_id_t, id_count + 1);
+    int32_t *columns = ecs_os_malloc_n(int32_t, id_count + 1);
+    ecs_size_t *sizes = ecs_os_calloc_n(ecs_size_t, id_count + 1);
+    void **data = ecs_os_calloc_n(void*, id_count + 1);
+    ecs_snapshot_strings_t *strings = ecs_os_calloc_n(
+        ecs_snapshot_strings_t, id_count + 1);
+    uint32_t *flags = ecs_os_malloc_n(uint32_t, count);
+    int32_t bulk_count = 0;
+    bool restore_rows = false;
+    int result = -1;
+
+    for (i = 0; i < id_count; i ++) {
+        ecs_id_t id = t->ids[i];
+        ecs_snapshot_kind_t kind = t->kinds[i];
+
+        if (kind >= EcsSnapshotName) {
+            flecs_snapshot_strings_init(&strings[i], start, blocks[i], count);
+        }
+
+        if (kind == EcsSnapshotParent || kind == EcsSnapshotJson) {
+            restore_rows = true;
+        }
+
+        if (kind == EcsSnapshotParent) {
+            continue;
+        }
+        if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+            continue;
+        }
+
+        flecs_snapshot_ensure_id(world, id);
+
+        ids[bulk_count] = id;
+        columns[bulk_count] = i;
+        if (kind == EcsSnapshotRaw) {
+            sizes[bulk_count] = ecs_get_type_info(world, id)->size;
+        } else if (kind >= EcsSnapshotName && kind <= EcsSnapshotAlias) {
+            data[bulk_count] = ecs_os_malloc_n(EcsIdentifier, count);
+        }
+        bulk_count ++;
+    }
+
+    ecs_table_t *table = ecs_table_find(world, ids, bulk_count);
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_type_t bulk_type = { .array = ids, .count = bulk_count };
+    void **run_data = ecs_os_calloc_n(void*, bulk_count + 1);
+
+    int32_t row = 0;
+    while (row < count) {
+        ecs_record_t *r = flecs_entities_get(world, t->entities[row]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (r->table) {
+            /* Entity already existed before the snapshot was restored */
+            if (exact) {
+                flecs_snapshot_remove_missing(world, t, t->entities[row]);
+            }
+            if (flecs_snapshot_restore_row(
+                world, t, blocks, strings, row, true))
+            {
+                goto error;
+            }
+            row ++;
+            continue;
+        }
+
+        /* Find run of entities that don't have a table yet */
+        int32_t run_start = row, run_count;
+        for (; row < count; row ++) {
+            r = flecs_entities_get(world, t->entities[row]);
+            if (r->table) {
+                break;
+            }
+            flags[row - run_start] = ECS_RECORD_TO_ROW_FLAGS(r->row);
+        }
+
+        run_count = row - run_start;
+
+        for (i = 0; i < bulk_count; i ++) {
+            int32_t column = columns[i];
+            ecs_snapshot_kind_t kind = t->kinds[column];
+            if (kind == EcsSnapshotRaw) {
+                run_data[i] = ECS_ELEM(ECS_CONST_CAST(void*, blocks[column]),
+                    sizes[i], run_start);
+            } else if (data[i]) {
+                /* Names are copied in bulk, so that they are added to the name
+                 * index by the OnSet hook of the identifier component. */
+                EcsIdentifier *names = data[i];
+                int32_t j;
+                for (j = 0; j < run_count; j ++) {
+                    ecs_os_zeromem(&names[j]);
+                    names[j].value = ECS_CONST_CAST(char*,
+                        flecs_snapshot_strings_next(
+                            &strings[column], run_start + j));
+                }
+                run_data[i] = names;
+            }
+        }
+
+        ecs_table_diff_t diff = {
+            .added.array = table->type.array,
+            .added.count = table->type.count,
+            .added_flags = table->flags & EcsTableAddEdgeFlags
+        };
+
+        flecs_bulk_new(world, table, &t->entities[run_start], &bulk_type,
+            run_count, run_data, false, false, NULL, &diff);
+
+        /* Restore flags that were added to records before the entities were
+         * added to the table, for example when used as a pair target. */
+        for (i = 0; i < run_count; i ++) {
+            r = flecs_entities_get(world, t->entities[run_start + i]);
+            r->row |= flags[i];
+        }
+
+        for (i = run_start; restore_rows && i < row; i ++) {
+            if (flecs_snapshot_restore_row(
+                world, t, blocks, strings, i, false))
+            {
+                goto error;
+            }
+        }
+    }
+
+    result = 0;
+error:
+    for (i = 0; i < bulk_count; i ++) {
+        ecs_os_free(data[i]);
+    }
+    ecs_os_free(run_data);
+    ecs_os_free(ids);
+    ecs_os_free(columns);
+    ecs_os_free(sizes);
+    ecs_os_free(data);
+    ecs_os_free(strings);
+    ecs_os_free(flags);
+    return result;
+}
+
+/* Make entities alive without adding them to a table, so they can be added to
+ * their tables in bulk. */
+static
+void flecs_snapshot_make_alive(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *tables,
+    uint32_t table_count)
+{
+    uint32_t i;
+    for (i = 0; i < table_count; i ++) {
+        const ecs_snapshot_table_t *t = &tables[i];
+        int32_t j;
+        for (j = 0; j < t->count; j ++) {
+            ecs_entity_t e = t->entities[j];
+            if (!ecs_is_alive(world, e)) {
+                flecs_entities_make_alive(world, e);
+                flecs_entities_ensure(world, e);
+            }
+        }
+    }
+}
+
+int ecs_world_from_binary(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(data != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot restore snapshot while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION,
+        "cannot restore snapshot while world is deferred");
+
+    if (((uintptr_t)data % FLECS_SNAPSHOT_ALIGN) != 0) {
+        ecs_err("snapshot: data must be aligned to %d bytes",
+            FLECS_SNAPSHOT_ALIGN);
+        return -1;
+    }
+
+    ecs_snapshot_reader_t r = {
+        .start = data,
+        .ptr = data,
+        .end = ECS_OFFSET(data, size)
+    };
+
+    const ecs_snapshot_header_t *hdr = flecs_snapshot_read(
+        &r, ECS_SIZEOF(ecs_snapshot_header_t));
+    if (!hdr) {
+        return -1;
+    }
+
+    if (flecs_snapshot_read_preamble(
+        &hdr->preamble, FLECS_SNAPSHOT_MAGIC, "snapshot"))
+    {
+        return -1;
+    }
+
+    if (hdr->components_offset > (uint64_t)size) {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    /* Verify that the snapshot can be restored before modifying the world */
+    ecs_snapshot_reader_t cr = r;
+    cr.ptr = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+    if (flecs_snapshot_read_components(world, hdr->component_count, &cr)) {
+        return -1;
+    }
+
+    r.end = cr.ptr = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+
+    /* Each table block starts with a header */
+    if (r.end < r.ptr || hdr->table_count > (uint64_t)(r.end - r.ptr) / 
+        sizeof(ecs_snapshot_table_header_t)) 
+    {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    int result = -1;
+    uint32_t i, table_count = hdr->table_count;
+    ecs_snapshot_table_t *tables = ecs_os_calloc_n(
+        ecs_snapshot_table_t, (int32_t)table_count + 1);
+    ecs_vec_t blocks;
+    ecs_vec_init_t(NULL, &blocks, const void*, 0);
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    for (i = 0; i < table_count; i ++) {
+        if (flecs_snapshot_read_table(world, &r, &tables[i], &blocks,
+            &entities, NULL))
+        {
+            goto cleanup;
+        }
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        int32_t j;
+        for (j = 0; j < t->id_count; j ++) {
+            if (!flecs_snapshot_id_exists(world, &entities, t->ids[j])) {
+                ecs_err("snapshot: table type contains entity that is not "
+                    "alive and not stored in snapshot");
+                goto cleanup;
+            }
+        }
+    }
+
+    flecs_snapshot_make_alive(world, tables, table_count);
+
+    /* Instance children are stored in the snapshot, so prevent adding an IsA
+     * relationship from instantiating prefab hierarchies. */
+    ecs_stage_t *stage = world->stages[0];
+    ecs_entity_t base = stage->base;
+    stage->base = EcsWildcard;
+
+    const void **block_ptrs = ecs_vec_first(&blocks);
+    for (i = 0; i < table_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        if (flecs_snapshot_restore_table(world, t, &block_ptrs[t->blocks],
+            data, false))
+        {
+            stage->base = base;
+            goto cleanup;
+        }
+    }
+
+    stage->base = base;
+
+    if (flecs_entities_max_id(world) < hdr->max_id) {
+        flecs_entities_max_id(world) = (uint32_t)hdr->max_id;
+    }
+
+    result = 0;
+cleanup:
+    ecs_map_fini(&entities);
+    ecs_vec_fini_t(NULL, &blocks, const void*);
+    ecs_os_free(tables);
+    return result;
+error:
+    return -1;
+}
+
+int ecs_world_from_binary_file(
+    ecs_world_t *world,
+    const char *filename)
+{
+    ecs_check(filename != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    FILE* file = ecs_os_fopen(filename, "rb");
+    if (!file) {
+        ecs_err("%s (%s)", ecs_os_strerror(errno), filename);
+        return -1;
+    }
+
+    ecs_vec_t buf;
+    ecs_vec_init_t(NULL, &buf, char, 0);
+    ecs_size_t read_size = 4096;
+    size_t read;
+
+    do {
+        void *dst = ecs_vec_grow_t(NULL, &buf, char, read_size);
+        read = ecs_os_fread(dst, 1, flecs_itosize(read_size), file);
+        ecs_vec_set_count_t(NULL, &buf, char,
+            ecs_vec_count(&buf) - read_size + flecs_uto(ecs_size_t, read));
+        read_size = ecs_vec_size(&buf);
+    } while (read);
+
+    ecs_os_fclose(file);
+
+    int result = ecs_world_from_binary(
+        world, ecs_vec_first(&buf), ecs_vec_count(&buf));
+    ecs_vec_fini_t(NULL, &buf, char);
+    return result;
+error:
+    return -1;
+}
+
+/* State of the replicated entities at a frame */
+typedef struct ecs_replicator_state_t {
+    ecs_map_t entities;        /* map<entity, table id> */
+    ecs_map_t tables;          /* map<table id, int32_t*> column dirty state */
+    uint64_t frame;
+} ecs_replicator_state_t;
+
+struct ecs_replicator_t {
+    ecs_world_t *world;
+    ecs_query_t *query;
+    ecs_replicator_state_t acked;
+    ecs_vec_t pending;         /* vec<ecs_replicator_state_t> unacked frames */
+    ecs_map_t sent;            /* map<entity, frame> sent since acked frame */
+    uint64_t frame;
+};
+
+/* Table matched by the replicator query while creating a diff */
+typedef struct ecs_replicator_table_t {
+    ecs_snapshot_sort_t sort;
+    ecs_vec_t added;           /* vec<int32_t> rows of entities new in table */
+    ecs_vec_t updated;         /* vec<int32_t> rows of acknowledged entities */
+} ecs_replicator_table_t;
+
+static
+void flecs_replicator_state_init(
+    ecs_world_t *world,
+    ecs_replicator_state_t *state)
+{
+    ecs_map_init(&state->entities, &world->allocator);
+    ecs_map_init(&state->tables, &world->allocator);
+    state->frame = 0;
+}
+
+static
+void flecs_replicator_state_fini(
+    ecs_replicator_state_t *state)
+{
+    ecs_map_iter_t it = ecs_map_iter(&state->tables);
+    while (ecs_map_next(&it)) {
+        ecs_os_free(ecs_map_ptr(&it));
+    }
+    ecs_map_fini(&state->tables);
+    ecs_map_fini(&state->entities);
+}
+
+ecs_replicator_t* ecs_replicator_new(
+    ecs_world_t *world,
+    ecs_query_t *query)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(query != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_replicator_t *result = ecs_os_calloc_t(ecs_replicator_t);
+    result->world = world;
+    result->query = query;
+    flecs_replicator_state_init(world, &result->acked);
+    ecs_vec_init_t(NULL, &result->pending, ecs_replicator_state_t, 0);
+    ecs_map_init(&result->sent, &world->allocator);
+    return result;
+error:
+    return NULL;
+}
+
+void ecs_replicator_free(
+    ecs_replicator_t *replicator)
+{
+    if (replicator) {
+        flecs_replicator_state_fini(&replicator->acked);
+        int32_t i, count = ecs_vec_count(&replicator->pending);
+        ecs_replicator_state_t *pending = ecs_vec_first(&replicator->pending);
+        for (i = 0; i < count; i ++) {
+            flecs_replicator_state_fini(&pending[i]);
+        }
+        ecs_vec_fini_t(NULL, &replicator->pending, ecs_replicator_state_t);
+        ecs_map_fini(&replicator->sent);
+        ecs_os_free(replicator);
+    }
+}
+
+void ecs_replicator_ack(
+    ecs_replicator_t *replicator,
+    uint64_t frame)
+{
+    ecs_check(replicator != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    /* Pending frames are stored in the order they were created */
+    int32_t i, count = ecs_vec_count(&replicator->pending);
+    ecs_replicator_state_t *pending = ecs_vec_first(&replicator->pending);
+    for (i = 0; i < count; i ++) {
+        if (pending[i].frame == frame) {
+            break;
+        }
+    }
+
+    if (!frame || i == count) {
+        return; /* Frame is already acknowledged, superseded or unknown */
+    }
+
+    /* Frames older than the acknowledged frame can no longer be acked */
+    flecs_replicator_state_fini(&replicator->acked);
+    replicator->acked = pending[i];
+    int32_t j;
+    for (j = 0; j < i; j ++) {
+        flecs_replicator_state_fini(&pending[j]);
+    }
+
+    int32_t remaining = count - i - 1;
+    ecs_os_memmove_n(pending, &pending[i + 1], ecs_replicator_state_t, 
+        remaining);
+    ecs_vec_set_count_t(NULL, &replicator->pending, ecs_replicator_state_t,
+        remaining);
+
+    /* Entities sent up to the acknowledged frame are either in the acked
+     * state, or were deleted by the acknowledged diff. */
+    ecs_vec_t removed;
+    ecs_vec_init_t(NULL, &removed, ecs_entity_t, 0);
+    ecs_map_iter_t it = ecs_map_iter(&replicator->sent);
+    while (ecs_map_next(&it)) {
+        if (ecs_map_value(&it) <= frame) {
+            ecs_vec_append_t(NULL, &removed, ecs_entity_t)[0] = 
+                ecs_map_key(&it);
+        }
+    }
+
+    count = ecs_vec_count(&removed);
+    ecs_entity_t *entities = ecs_vec_first(&removed);
+    for (i = 0; i < count; i ++) {
+        ecs_map_remove(&replicator->sent, entities[i]);
+    }
+    ecs_vec_fini_t(NULL, &removed, ecs_entity_t);
+error:
+    return;
+}
+
+static
+int flecs_replicator_compare_table(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_replicator_table_t *t1 = ptr_1;
+    const ecs_replicator_table_t *t2 = ptr_2;
+    return flecs_snapshot_compare_table(&t1->sort, &t2->sort);
+}
+
+/* Set operations skip change detection for components that aren't used by
+ * queries that detect changes. Flag the components of a replicated or forked
+ * table in the same way as a query with change detection does. */
+static
+void flecs_snapshot_track_table(
+    ecs_world_t *world,
+    const ecs_table_t *table)
+{
+    int32_t i, count = table->type.count;
+    for (i = 0; i < count; i ++) {
+        if (ecs_table_type_to_column_index(table, i) == -1) {
+            continue;
+        }
+
+        ecs_id_t id = table->type.array[i];
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+        cr->flags |= EcsIdHasOnSet;
+
+        if (id < FLECS_HI_COMPONENT_ID) {
+            world->non_trivial_set[id] = true;
+        }
+    }
+}
+
+/* Collect the rows of the tables matched by the query, and store the state
+ * that the diff is created for as pending state. */
+static
+void flecs_replicator_collect(
+    ecs_replicator_t *replicator,
+    ecs_replicator_state_t *pending,
+    ecs_vec_t *tables)
+{
+    ecs_world_t *world = replicator->world;
+    ecs_replicator_state_t *acked = &replicator->acked;
+
+    ecs_map_t table_index;
+    ecs_map_init(&table_index, &world->allocator);
+
+    ecs_iter_t it = ecs_query_iter(world, replicator->query);
+
+    /* Don't mark fields as dirty, this would make them show up as changed in
+     * the next diff. */
+    it.flags |= EcsIterNoData;
+
+    while (ecs_query_next(&it)) {
+        ecs_table_t *table = it.table;
+        if (!table || !it.count || flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_map_val_t *index = ecs_map_ensure(&table_index, table->id);
+        if (!index[0]) {
+            ecs_replicator_table_t *elem = ecs_vec_append_t(
+                NULL, tables, ecs_replicator_table_t);
+            elem->sort.table = table;
+            elem->sort.depth = flecs_snapshot_table_depth(world, table);
+            ecs_vec_init_t(NULL, &elem->added, int32_t, 0);
+            ecs_vec_init_t(NULL, &elem->updated, int32_t, 0);
+            index[0] = flecs_ito(uint64_t, ecs_vec_count(tables));
+
+            if (!ecs_map_get(&acked->tables, table->id)) {
+                flecs_snapshot_track_table(world, table);
+            }
+
+            int32_t *dirty_state = flecs_table_get_dirty_state(world, table);
+            int32_t *copy = ecs_os_memdup_n(
+                dirty_state, int32_t, table->column_count + 1);
+            ecs_map_insert_ptr(&pending->tables, table->id, copy);
+        }
+
+        ecs_replicator_table_t *elem = ecs_vec_get_t(tables,
+            ecs_replicator_table_t, flecs_uto(int32_t, index[0] - 1));
+
+        int32_t i;
+        for (i = 0; i < it.count; i ++) {
+            ecs_entity_t e = it.entities[i];
+            if (ecs_map_get(&pending->entities, e)) {
+                continue; /* Table is matched more than once */
+            }
+
+            ecs_map_insert(&pending->entities, e, table->id);
+
+            int32_t row = it.offset + i;
+            ecs_map_val_t *prev = ecs_map_get(&acked->entities, e);
+            if (prev && prev[0] == table->id) {
+                ecs_vec_append_t(NULL, &elem->updated, int32_t)[0] = row;
+            } else {
+                ecs_vec_append_t(NULL, &elem->added, int32_t)[0] = row;
+            }
+        }
+    }
+
+    ecs_map_fini(&table_index);
+}
+
+/* Determine which ids of a table have values that changed since the
+ * acknowledged frame. Returns whether any value changed. */
+static
+bool flecs_replicator_changed(
+    ecs_replicator_t *replicator,
+    const ecs_table_t *table,
+    bool *changed)
+{
+    const ecs_world_t *world = replicator->world;
+    const int32_t *prev = ecs_map_get_deref(
+        &replicator->acked.tables, int32_t, table->id);
+    const int32_t *dirty_state = table->dirty_state;
+    ecs_assert(dirty_state != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    bool result = false;
+    int32_t i, count = table->type.count;
+    for (i = 0; i < count; i ++) {
+        const ecs_type_info_t *ti;
+        ecs_snapshot_kind_t kind = flecs_snapshot_id_kind(
+            world, table->type.array[i], &ti);
+        if (kind == EcsSnapshotTag || kind == EcsSnapshotSkip) {
+            changed[i] = false;
+            continue;
+        }
+
+        int32_t column = ecs_table_type_to_column_index(table, i);
+        if (column == -1) {
+            /* Sparse components don't have change detection */
+            changed[i] = true;
+        } else {
+            changed[i] = !prev || prev[column + 1] != dirty_state[column + 1];
+        }
+
+        result |= changed[i];
+    }
+
+    return result;
+}
+
+static
+int flecs_replicator_write_rows(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    const ecs_vec_t *rows,
+    const bool *include,
+    ecs_map_t *components,
+    ecs_vec_t *buf)
+{
+    int32_t count = ecs_vec_count(rows);
+
+    /* Rows are collected in order, so if all rows of the table are written
+     * columns can be copied in bulk. */
+    const int32_t *row_ptr = NULL;
+    if (count != ecs_table_count(table)) {
+        row_ptr = ecs_vec_first_t(rows, int32_t);
+    }
+
+    return flecs_snapshot_write_table(
+        world, table, row_ptr, count, include, components, buf);
+}
+
+void* ecs_replicator_diff(
+    ecs_replicator_t *replicator,
+    ecs_size_t *size_out,
+    uint64_t *frame_out)
+{
+    ecs_check(replicator != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size_out != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_world_t *world = replicator->world;
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot create diff while world is in readonly mode");
+
+    /* Drop the oldest unacknowledged frame if there are too many */
+    if (ecs_vec_count(&replicator->pending) == FLECS_REPLICATOR_MAX_PENDING) {
+        ecs_replicator_state_t *oldest = ecs_vec_first(&replicator->pending);
+        flecs_replicator_state_fini(oldest);
+        ecs_vec_remove_ordered(&replicator->pending, 
+            ECS_SIZEOF(ecs_replicator_state_t), 0);
+    }
+
+    ecs_replicator_state_t *pending = ecs_vec_append_t(
+        NULL, &replicator->pending, ecs_replicator_state_t);
+    flecs_replicator_state_init(world, pending);
+    pending->frame = ++ replicator->frame;
+
+    ecs_vec_t tables;
+    ecs_vec_init_t(NULL, &tables, ecs_replicator_table_t, 0);
+    flecs_replicator_collect(replicator, pending, &tables);
+
+    int32_t i, table_count = ecs_vec_count(&tables);
+    ecs_replicator_table_t *sorted = ecs_vec_first(&tables);
+    if (table_count > 1) {
+        qsort(sorted, flecs_itosize(table_count),
+            sizeof(ecs_replicator_table_t), flecs_replicator_compare_table);
+    }
+
+    ecs_vec_t buf;
+    ecs_vec_init_t(NULL, &buf, char, 4096);
+    ecs_map_t components;
+    ecs_map_init(&components, &world->allocator);
+    uint32_t added_count = 0, updated_count = 0, deleted_count = 0;
+    bool *changed = NULL;
+
+    flecs_snapshot_write(&buf, NULL, ECS_SIZEOF(ecs_snapshot_diff_header_t));
+
+    /* Entities that were deleted or no longer match the query. This includes
+     * entities that were sent in diffs that weren't acknowledged yet, so that
+     * a client can skip diffs. */
+    ecs_map_iter_t it = ecs_map_iter(&replicator->acked.entities);
+    while (ecs_map_next(&it)) {
+        ecs_entity_t e = ecs_map_key(&it);
+        if (!ecs_map_get(&pending->entities, e)) {
+            flecs_snapshot_write(&buf, &e, ECS_SIZEOF(ecs_entity_t));
+            deleted_count ++;
+        }
+    }
+
+    it = ecs_map_iter(&replicator->sent);
+    while (ecs_map_next(&it)) {
+        ecs_entity_t e = ecs_map_key(&it);
+        if (!ecs_map_get(&pending->entities, e) &&
+            !ecs_map_get(&replicator->acked.entities, e))
+        {
+            flecs_snapshot_write(&buf, &e, ECS_SIZEOF(ecs_entity_t));
+            deleted_count ++;
+        }
+    }
+
+    it = ecs_map_iter(&pending->entities);
+    while (ecs_map_next(&it)) {
+        ecs_map_ensure(&replicator->sent, ecs_map_key(&it))[0] = 
+            pending->frame;
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_replicator_table_t *t = &sorted[i];
+        if (!ecs_vec_count(&t->added)) {
+            continue;
+        }
+
+        if (flecs_replicator_write_rows(
+            world, t->sort.table, &t->added, NULL, &components, &buf))
+        {
+            goto error;
+        }
+
+        added_count ++;
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_replicator_table_t *t = &sorted[i];
+        const ecs_table_t *table = t->sort.table;
+        if (!ecs_vec_count(&t->updated)) {
+            continue;
+        }
+
+        changed = ecs_os_realloc_n(changed, bool, table->type.count);
+        if (!flecs_replicator_changed(replicator, table, changed)) {
+            continue;
+        }
+
+        if (flecs_replicator_write_rows(
+            world, table, &t->updated, changed, &components, &buf))
+        {
+            goto error;
+        }
+
+        updated_count ++;
+    }
+
+    uint64_t components_offset = flecs_ito(uint64_t, ecs_vec_count(&buf));
+    flecs_snapshot_write_components(world, &components, &buf);
+
+    ecs_snapshot_diff_header_t *hdr = ecs_vec_first(&buf);
+    flecs_snapshot_init_preamble(&hdr->preamble, FLECS_SNAPSHOT_DIFF_MAGIC);
+    hdr->table_count = added_count;
+    hdr->update_count = updated_count;
+    hdr->deleted_count = deleted_count;
+    hdr->component_count = flecs_ito(uint32_t, components.count);
+    hdr->components_offset = components_offset;
+    hdr->frame = replicator->frame;
+
+    if (frame_out) {
+        *frame_out = replicator->frame;
+    }
+
+    *size_out = ecs_vec_count(&buf);
+
+    ecs_os_free(changed);
+    ecs_map_fini(&components);
+    for (i = 0; i < table_count; i ++) {
+        ecs_vec_fini_t(NULL, &sorted[i].added, int32_t);
+        ecs_vec_fini_t(NULL, &sorted[i].updated, int32_t);
+    }
+    ecs_vec_fini_t(NULL, &tables, ecs_replicator_table_t);
+    return ecs_vec_first(&buf);
+error:
+    ecs_os_free(changed);
+    ecs_map_fini(&components);
+    for (i = 0; i < table_count; i ++) {
+        ecs_vec_fini_t(NULL, &sorted[i].added, int32_t);
+        ecs_vec_fini_t(NULL, &sorted[i].updated, int32_t);
+    }
+    ecs_vec_fini_t(NULL, &tables, ecs_replicator_table_t);
+    ecs_vec_fini_t(NULL, &buf, char);
+    return NULL;
+}
+
+/* Assign changed values to entities that are already in the right table */
+static
+int flecs_snapshot_update_table(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    const void **blocks,
+    const char *start)
+{
+    ecs_snapshot_strings_t *strings = ecs_os_calloc_n(
+        ecs_snapshot_strings_t, t->id_count + 1);
+    int32_t i, result = 0;
+
+    for (i = 0; i < t->id_count; i ++) {
+        if (t->kinds[i] >= EcsSnapshotName) {
+            flecs_snapshot_strings_init(&strings[i], start, blocks[i], t->count);
+        }
+    }
+
+    for (i = 0; i < t->count; i ++) {
+        if (flecs_snapshot_restore_row(world, t, blocks, strings, i, true)) {
+            result = -1;
+            break;
+        }
+    }
+
+    ecs_os_free(strings);
+    return result;
+}
+
+int ecs_world_apply_diff(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(data != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot apply diff while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION,
+        "cannot apply diff while world is deferred");
+
+    if (((uintptr_t)data % FLECS_SNAPSHOT_ALIGN) != 0) {
+        ecs_err("snapshot: data must be aligned to %d bytes",
+            FLECS_SNAPSHOT_ALIGN);
+        return -1;
+    }
+
+    ecs_snapshot_reader_t r = {
+        .start = data,
+        .ptr = data,
+        .end = ECS_OFFSET(data, size)
+    };
+
+    const ecs_snapshot_diff_header_t *hdr = flecs_snapshot_read(
+        &r, ECS_SIZEOF(ecs_snapshot_diff_header_t));
+    if (!hdr) {
+        return -1;
+    }
+
+    if (flecs_snapshot_read_preamble(
+        &hdr->preamble, FLECS_SNAPSHOT_DIFF_MAGIC, "diff"))
+    {
+        return -1;
+    }
+
+    if (hdr->components_offset > (uint64_t)size) {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    ecs_snapshot_reader_t cr = r;
+    cr.ptr = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+    if (flecs_snapshot_read_components(world, hdr->component_count, &cr)) {
+        return -1;
+    }
+
+    r.end = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+
+    /* Counts are validated against the remaining data, after which they fit
+     * in a 32 bit integer. */
+    const ecs_entity_t *deleted = flecs_snapshot_read_n(&r,
+        ECS_SIZEOF(ecs_entity_t), hdr->deleted_count);
+    if (!deleted) {
+        return -1;
+    }
+
+    /* Each table block starts with a header */
+    uint64_t block_count = (uint64_t)hdr->table_count + hdr->update_count;
+    if (r.end < r.ptr || block_count > (uint64_t)(r.end - r.ptr) / 
+        sizeof(ecs_snapshot_table_header_t)) 
+    {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    int result = -1;
+    int32_t i, deleted_count = (int32_t)hdr->deleted_count;
+    int32_t table_count = (int32_t)hdr->table_count;
+    int32_t total_count = (int32_t)block_count;
+    ecs_snapshot_table_t *tables = ecs_os_calloc_n(
+        ecs_snapshot_table_t, total_count + 1);
+    ecs_vec_t blocks;
+    ecs_vec_init_t(NULL, &blocks, const void*, 0);
+    ecs_map_t entities, deleted_map;
+    ecs_map_init(&entities, &world->allocator);
+    ecs_map_init(&deleted_map, &world->allocator);
+
+    for (i = 0; i < deleted_count; i ++) {
+        ecs_entity_t e = deleted[i];
+        if (e && ecs_is_alive(world, e)) {
+            ecs_map_ensure(&deleted_map, e);
+        }
+    }
+
+    /* Verify that the diff can be applied before modifying the world */
+    for (i = 0; i < total_count; i ++) {
+        if (flecs_snapshot_read_table(world, &r, &tables[i], &blocks,
+            &entities, &deleted_map))
+        {
+            goto cleanup;
+        }
+    }
+
+    for (i = 0; i < total_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        int32_t j;
+        for (j = 0; j < t->id_count; j ++) {
+            if (!flecs_snapshot_id_exists(world, &entities, t->ids[j])) {
+                ecs_err("snapshot: table type contains entity that is not "
+                    "alive and not stored in diff");
+                goto cleanup;
+            }
+        }
+
+        for (j = 0; i >= table_count && j < t->count; j ++) {
+            ecs_entity_t e = t->entities[j];
+            if (!ecs_is_alive(world, e) || ecs_map_get(&deleted_map, e)) {
+                ecs_err("snapshot: diff updates entity %u that is not alive",
+                    (uint32_t)e);
+                goto cleanup;
+            }
+        }
+    }
+
+    for (i = 0; i < deleted_count; i ++) {
+        ecs_entity_t e = deleted[i];
+        if (e && ecs_is_alive(world, e)) {
+            ecs_delete(world, e);
+        }
+    }
+
+    flecs_snapshot_make_alive(world, tables, flecs_ito(uint32_t, table_count));
+
+    /* Instance children are replicated, so prevent adding an IsA relationship
+     * from instantiating prefab hierarchies. */
+    ecs_stage_t *stage = world->stages[0];
+    ecs_entity_t base = stage->base;
+    stage->base = EcsWildcard;
+
+    const void **block_ptrs = ecs_vec_first(&blocks);
+    for (i = 0; i < total_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        int res;
+        if (i < table_count) {
+            res = flecs_snapshot_restore_table(world, t,
+                &block_ptrs[t->blocks], data, true);
+        } else {
+            res = flecs_snapshot_update_table(world, t,
+                &block_ptrs[t->blocks], data);
+        }
+        if (res) {
+            stage->base = base;
+            goto cleanup;
+        }
+    }
+
+    stage->base = base;
+    result = 0;
+cleanup:
+    ecs_map_fini(&deleted_map);
+    ecs_map_fini(&entities);
+    ecs_vec_fini_t(NULL, &blocks, const void*);
+    ecs_os_free(tables);
+    return result;
+error:
+    return -1;
+}
+
+/* Copy of the entity ids or component values of a table column. A copy is
+ * shared between forks for as long as the column doesn't change. */
+typedef struct ecs_fork_column_t {
+    const ecs_type_info_t *ti; /* NULL for entity ids */
+    void *data;
+    int32_t count;
+    int32_t dirty;             /* Dirty state of the column when copied */
+    int32_t refcount;
+} ecs_fork_column_t;
+
+/* How the values of a column are restored */
+typedef enum ecs_fork_kind_t {
+    EcsForkSkip,               /* Values are not restored */
+    EcsForkCopy,               /* Values are copied into the column */
+    EcsForkSet                 /* Values are assigned with a set operation */
+} ecs_fork_kind_t;
+
+typedef struct ecs_fork_table_t {
+    ecs_snapshot_sort_t sort;  /* Table pointer is only valid while forking */
+    uint64_t table_id;
+    ecs_type_t type;           /* Used to recreate the table if deleted */
+    ecs_fork_column_t *entities;
+    ecs_fork_column_t **columns; /* NULL for columns that aren't restored */
+    int32_t column_count;
+} ecs_fork_table_t;
+
+struct ecs_world_fork_t {
+    ecs_world_t *world;
+    ecs_vec_t tables;          /* vec<ecs_fork_table_t>, parents first */
+    ecs_map_t table_index;     /* map<table id, index in tables + 1> */
+};
+
+static
+ecs_fork_kind_t flecs_fork_column_kind(
+    ecs_table_t *table,
+    int32_t column)
+{
+    const ecs_type_info_t *ti = table->data.columns[column].ti;
+    if (ti->hooks.flags & ECS_TYPE_HOOK_COPY_ILLEGAL) {
+        return EcsForkSkip;
+    }
+
+    /* Components that are indexed by hooks must be assigned with regular
+     * operations, so that the indices stay in sync. */
+    ecs_id_t id = flecs_column_id(table, column);
+    if (id == ecs_id(EcsParent) ||
+        id == ecs_pair_t(EcsIdentifier, EcsName) ||
+        id == ecs_pair_t(EcsIdentifier, EcsSymbol) ||
+        id == ecs_pair_t(EcsIdentifier, EcsAlias))
+    {
+        return EcsForkSet;
+    }
+
+    if (ECS_IS_PAIR(id) && ECS_PAIR_FIRST(id) == ecs_id(EcsIdentifier)) {
+        return EcsForkSkip;
+    }
+
+    return EcsForkCopy;
+}
+
+static
+ecs_fork_column_t* flecs_fork_column_copy(
+    const void *src,
+    int32_t count,
+    int32_t dirty,
+    const ecs_type_info_t *ti)
+{
+    ecs_fork_column_t *result = ecs_os_calloc_t(ecs_fork_column_t);
+    result->ti = ti;
+    result->count = count;
+    result->dirty = dirty;
+    result->refcount = 1;
+
+    if (count) {
+        ecs_size_t size = ti ? ti->size : ECS_SIZEOF(ecs_entity_t);
+        result->data = ecs_os_malloc(size * count);
+        if (ti) {
+            flecs_type_info_copy_ctor(result->data, src, count, ti);
+        } else {
+            ecs_os_memcpy(result->data, src, size * count);
+        }
+    }
+
+    return result;
+}
+
+static
+ecs_fork_column_t* flecs_fork_column_share(
+    ecs_fork_column_t *column)
+{
+    column->refcount ++;
+    return column;
+}
+
+static
+void flecs_fork_column_release(
+    ecs_fork_column_t *column)
+{
+    if (!column || -- column->refcount) {
+        return;
+    }
+
+    if (column->ti && column->count) {
+        flecs_type_info_dtor(column->data, column->count, column->ti);
+    }
+
+    ecs_os_free(column->data);
+    ecs_os_free(column);
+}
+
+static
+const ecs_fork_table_t* flecs_fork_get_table(
+    const ecs_world_fork_t *fork,
+    const ecs_table_t *table)
+{
+    if (!fork) {
+        return NULL;
+    }
+
+    ecs_map_val_t *index = ecs_map_get(&fork->table_index, table->id);
+    if (!index) {
+        return NULL;
+    }
+
+    return ecs_vec_get_t(&fork->tables,
+        ecs_fork_table_t, flecs_uto(int32_t, index[0] - 1));
+}
+
+/* Get the table of a fork table if it wasn't deleted. Table ids contain a
+ * generation, so a recreated table doesn't match the id in the fork. */
+static
+ecs_table_t* flecs_fork_table_get_alive(
+    ecs_world_t *world,
+    const ecs_fork_table_t *ft)
+{
+    if (!ft->table_id) {
+        return &world->store.root;
+    }
+
+    ecs_table_t *table = flecs_sparse_get_t(
+        &world->store.tables, ecs_table_t, ft->table_id);
+    if (!table || table->id != ft->table_id) {
+        return NULL;
+    }
+
+    return table;
+}
+
+/* Copy the entity ids and values of a table. Copies of the previous fork are
+ * reused if the rows and column didn't change since the previous fork. */
+static
+void flecs_fork_table_init(
+    ecs_world_t *world,
+    ecs_fork_table_t *ft,
+    const ecs_fork_table_t *prev)
+{
+    ecs_table_t *table = ft->sort.table;
+    if (!prev) {
+        flecs_snapshot_track_table(world, table);
+    }
+
+    ft->table_id = table->id;
+    ft->type.count = table->type.count;
+    ft->type.array = ecs_os_memdup_n(
+        table->type.array, ecs_id_t, table->type.count);
+
+    int32_t *dirty = flecs_table_get_dirty_state(world, table);
+    int32_t i, count = ecs_table_count(table);
+
+    if (prev && prev->entities->dirty == dirty[0]) {
+        ft->entities = flecs_fork_column_share(prev->entities);
+    } else {
+        ft->entities = flecs_fork_column_copy(
+            ecs_table_entities(table), count, dirty[0], NULL);
+        prev = NULL; /* Rows changed, so values can't be shared */
+    }
+
+    int32_t column_count = table->column_count;
+    if (!column_count) {
+        return;
+    }
+
+    ft->columns = ecs_os_calloc_n(ecs_fork_column_t*, column_count);
+    ft->column_count = column_count;
+    for (i = 0; i < column_count; i ++) {
+        if (flecs_fork_column_kind(table, i) == EcsForkSkip) {
+            continue;
+        }
+
+        ecs_fork_column_t *prev_column = prev ? prev->columns[i] : NULL;
+        if (prev_column && prev_column->dirty == dirty[i + 1]) {
+            ft->columns[i] = flecs_fork_column_share(prev_column);
+        } else {
+            ecs_column_t *column = &table->data.columns[i];
+            ft->columns[i] = flecs_fork_column_copy(
+                column->data, count, dirty[i + 1], column->ti);
+        }
+    }
+}
+
+static
+void flecs_fork_table_fini(
+    ecs_fork_table_t *ft)
+{
+    int32_t i;
+    for (i = 0; ft->columns && i < ft->column_count; i ++) {
+        flecs_fork_column_release(ft->columns[i]);
+    }
+
+    ecs_os_free(ft->columns);
+    ecs_os_free(ft->type.array);
+    flecs_fork_column_release(ft->entities);
+}
+
+static
+int flecs_fork_compare_table(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_fork_table_t *t1 = ptr_1;
+    const ecs_fork_table_t *t2 = ptr_2;
+    return flecs_snapshot_compare_table(&t1->sort, &t2->sort);
+}
+
+ecs_world_fork_t* ecs_world_fork(
+    ecs_world_t *world,
+    const ecs_world_fork_t *prev)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot fork world while in readonly mode");
+    ecs_check(!prev || prev->world == world, ECS_INVALID_PARAMETER,
+        "previous fork was created for a different world");
+
+    ecs_world_fork_t *result = ecs_os_calloc_t(ecs_world_fork_t);
+    result->world = world;
+    world->fork_count ++;
+    ecs_vec_init_t(NULL, &result->tables, ecs_fork_table_t, 0);
+    ecs_map_init(&result->table_index, &world->allocator);
+
+    const ecs_sparse_t *store = &world->store.tables;
+    int32_t i, table_count = flecs_sparse_count(store);
+    for (i = -1; i < table_count; i ++) {
+        ecs_table_t *table = i == -1 ? &world->store.root :
+            flecs_sparse_get_dense_t(store, ecs_table_t, i);
+        if (i != -1 && table == &world->store.root) {
+            continue;
+        }
+        if (flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_fork_table_t *ft = ecs_vec_append_t(
+            NULL, &result->tables, ecs_fork_table_t);
+        ecs_os_zeromem(ft);
+        ft->sort.table = table;
+        ft->sort.depth = flecs_snapshot_table_depth(world, table);
+        flecs_fork_table_init(world, ft, flecs_fork_get_table(prev, table));
+    }
+
+    table_count = ecs_vec_count(&result->tables);
+    ecs_fork_table_t *tables = ecs_vec_first(&result->tables);
+    if (table_count > 1) {
+        qsort(tables, flecs_itosize(table_count), sizeof(ecs_fork_table_t),
+            flecs_fork_compare_table);
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_map_insert(&result->table_index, tables[i].sort.table->id,
+            flecs_ito(uint64_t, i + 1));
+    }
+
+    return result;
+error:
+    return NULL;
+}
+
+void ecs_world_fork_free(
+    ecs_world_fork_t *fork)
+{
+    if (!fork) {
+        return;
+    }
+
+    int32_t i, count = ecs_vec_count(&fork->tables);
+    ecs_fork_table_t *tables = ecs_vec_first(&fork->tables);
+    for (i = 0; i < count; i ++) {
+        flecs_fork_table_fini(&tables[i]);
+    }
+
+    ecs_map_fini(&fork->table_index);
+    ecs_vec_fini_t(NULL, &fork->tables, ecs_fork_table_t);
+    fork->world->fork_count --;
+    ecs_os_free(fork);
+}
+
+/* Compute the ids that are added and removed when moving between tables */
+static
+void flecs_fork_type_diff(
+    const ecs_type_t *src,
+    const ecs_type_t *dst,
+    ecs_id_t *ids,
+    ecs_type_t *added,
+    ecs_type_t *removed)
+{
+    int32_t i_src = 0, i_dst = 0;
+    int32_t src_count = src->count, dst_count = dst->count;
+    added->array = ids;
+    added->count = 0;
+
+    /* Removed ids are stored at the end of the ids array */
+    removed->array = &ids[dst_count];
+    removed->count = 0;
+
+    while (i_src < src_count || i_dst < dst_count) {
+        ecs_id_t id_src = i_src < src_count ? src->array[i_src] : 0;
+        ecs_id_t id_dst = i_dst < dst_count ? dst->array[i_dst] : 0;
+        if (i_src < src_count && (i_dst == dst_count || id_src < id_dst)) {
+            removed->array[removed->count ++] = id_src;
+            i_src ++;
+        } else if (i_src == src_count || id_dst < id_src) {
+            added->array[added->count ++] = id_dst;
+            i_dst ++;
+        } else {
+            i_src ++;
+            i_dst ++;
+        }
+    }
+}
+
+/* Get the table that an entity is moved to before its Parent component is
+ * assigned, which moves the entity to the table with the right depth. */
+static
+ecs_table_t* flecs_fork_commit_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    if (!(table->flags & EcsTableHasParent)) {
+        return table;
+    }
+
+    int32_t i, count = 0;
+    ecs_id_t *ids = ecs_os_malloc_n(ecs_id_t, table->type.count);
+    for (i = 0; i < table->type.count; i ++) {
+        ecs_id_t id = table->type.array[i];
+        if (id == ecs_id(EcsParent)) {
+            continue;
+        }
+        if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+            continue;
+        }
+        ids[count ++] = id;
+    }
+
+    ecs_table_t *result = ecs_table_find(world, ids, count);
+    ecs_os_free(ids);
+    return result;
+}
+
+/* Make the entities of a table alive and move them to the table. If the table
+ * was deleted, it is recreated from the type stored in the fork. */
+static
+ecs_table_t* flecs_fork_restore_entities(
+    ecs_world_t *world,
+    const ecs_fork_table_t *ft,
+    ecs_table_t *table)
+{
+    ecs_table_t *dst = NULL;
+    const ecs_entity_t *entities = ft->entities->data;
+    int32_t i, count = ft->entities->count;
+    ecs_id_t *ids = NULL;
+    int32_t ids_size = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = entities[i];
+        if (!ecs_is_alive(world, e)) {
+            ecs_entity_t cur = ecs_get_alive(world, (uint32_t)e);
+            if (cur) {
+                ecs_delete(world, cur);
+            }
+            ecs_make_alive(world, e);
+        }
+    }
+
+    if (!table) {
+        table = flecs_table_find_or_create(world, 
+            &(ecs_type_t){ .array = ft->type.array, .count = ft->type.count });
+        flecs_snapshot_track_table(world, table);
+    }
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = entities[i];
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (r->table == table) {
+            continue;
+        }
+
+        if (!dst) {
+            dst = flecs_fork_commit_table(world, table);
+        }
+
+        ecs_type_t src_type = { 0 };
+        if (r->table) {
+            src_type = r->table->type;
+        }
+
+        int32_t size = src_type.count + dst->type.count;
+        if (size > ids_size) {
+            ids = ecs_os_realloc_n(ids, ecs_id_t, size);
+            ids_size = size;
+        }
+
+        ecs_type_t added, removed;
+        flecs_fork_type_diff(&src_type, &dst->type, ids, &added, &removed);
+        ecs_commit(world, e, NULL, dst, &added, &removed);
+
+        if (dst != table) {
+            int32_t column = table->component_map[ecs_id(EcsParent)] - 1;
+            ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+            ecs_set_id(world, e, ecs_id(EcsParent), sizeof(EcsParent),
+                ECS_ELEM_T(ft->columns[column]->data, EcsParent, i));
+        }
+    }
+
+    ecs_os_free(ids);
+    return table;
+}
+
+static
+bool flecs_fork_value_equals(
+    ecs_id_t id,
+    const void *a,
+    const void *b)
+{
+    if (id == ecs_id(EcsParent)) {
+        return ((const EcsParent*)a)->value == ((const EcsParent*)b)->value;
+    }
+
+    const char *str_a = ((const EcsIdentifier*)a)->value;
+    const char *str_b = ((const EcsIdentifier*)b)->value;
+    if (!str_a || !str_b) {
+        return str_a == str_b;
+    }
+
+    return !ecs_os_strcmp(str_a, str_b);
+}
+
+static
+void flecs_fork_set_value(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    ecs_id_t id,
+    const void *value)
+{
+    if (id == ecs_id(EcsParent)) {
+        ecs_set_id(world, e, id, sizeof(EcsParent), value);
+        return;
+    }
+
+    const char *str = ((const EcsIdentifier*)value)->value;
+    if (id == ecs_pair_t(EcsIdentifier, EcsName)) {
+        ecs_set_name(world, e, str);
+    } else if (id == ecs_pair_t(EcsIdentifier, EcsSymbol)) {
+        ecs_set_symbol(world, e, str);
+    } else {
+        ecs_set_alias(world, e, str);
+    }
+}
+
+/* Restore the values of a table. If the rows of the table are the same as
+ * when the fork was created, only columns that changed are copied. */
+static
+void flecs_fork_restore_values(
+    ecs_world_t *world,
+    const ecs_fork_table_t *ft,
+    ecs_table_t *table,
+    bool rows_changed)
+{
+    const int32_t *dirty = flecs_table_get_dirty_state(world, table);
+    const ecs_entity_t *entities = ft->entities->data;
+    int32_t i, count = ft->entities->count;
+
+    /* Rows were changed, but entities could be in the same order again, for 
+     * example when an entity was created and deleted. */
+    bool same_order = !rows_changed || (ecs_table_count(table) == count &&
+        !ecs_os_memcmp(ecs_table_entities(table), entities, 
+            ECS_SIZEOF(ecs_entity_t) * count));
+
+    int32_t c, column_count = table->column_count;
+    for (c = 0; c < column_count; c ++) {
+        const ecs_fork_column_t *fc = ft->columns ? ft->columns[c] : NULL;
+        if (!fc || (!rows_changed && dirty[c + 1] == fc->dirty)) {
+            continue;
+        }
+
+        ecs_column_t *column = &table->data.columns[c];
+        const ecs_type_info_t *ti = column->ti;
+        ecs_size_t size = ti->size;
+
+        if (flecs_fork_column_kind(table, c) == EcsForkSet) {
+            ecs_id_t id = flecs_column_id(table, c);
+            for (i = 0; i < count; i ++) {
+                ecs_record_t *r = flecs_entities_get(world, entities[i]);
+                ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+                int32_t row = ECS_RECORD_TO_ROW(r->row);
+                const void *src = ECS_ELEM(fc->data, size, i);
+                if (!flecs_fork_value_equals(
+                    id, ECS_ELEM(column->data, size, row), src))
+                {
+                    flecs_fork_set_value(world, entities[i], id, src);
+                }
+            }
+            continue;
+        }
+
+        if (same_order) {
+            flecs_type_info_copy(column->data, fc->data, count, ti);
+        } else {
+            for (i = 0; i < count; i ++) {
+                ecs_record_t *r = flecs_entities_get(world, entities[i]);
+                ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+                int32_t row = ECS_RECORD_TO_ROW(r->row);
+                flecs_type_info_copy(ECS_ELEM(column->data, size, row),
+                    ECS_ELEM(fc->data, size, i), 1, ti);
+            }
+        }
+
+        flecs_table_mark_dirty(world, table, flecs_column_id(table, c));
+    }
+}
+
+void ecs_world_fork_restore(
+    const ecs_world_fork_t *fork)
+{
+    ecs_check(fork != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_world_t *world = fork->world;
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot restore fork while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION,
+        "cannot restore fork while world is deferred");
+
+    int32_t i, count = ecs_vec_count(&fork->tables);
+    const ecs_fork_table_t *tables = ecs_vec_first(&fork->tables);
+    bool *changed = ecs_os_calloc_n(bool, count + 1);
+    ecs_table_t **alive = ecs_os_calloc_n(ecs_table_t*, count + 1);
+
+    /* Entities of tables with rows that changed since the fork was created */
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    for (i = 0; i < count; i ++) {
+        const ecs_fork_table_t *ft = &tables[i];
+        ecs_table_t *table = alive[i] = flecs_fork_table_get_alive(world, ft);
+        if (table && 
+            flecs_table_get_dirty_state(world, table)[0] == ft->entities->dirty)
+        {
+            continue;
+        }
+
+        changed[i] = true;
+        const ecs_entity_t *ids = ft->entities->data;
+        int32_t j;
+        for (j = 0; j < ft->entities->count; j ++) {
+            ecs_map_ensure(&entities, ids[j]);
+        }
+    }
+
+    /* Delete entities that were created after the fork. Only tables that are
+     * not in the fork or that have changed rows can contain such entities. */
+    ecs_vec_t deleted;
+    ecs_vec_init_t(NULL, &deleted, ecs_entity_t, 0);
+
+    const ecs_sparse_t *store = &world->store.tables;
+    int32_t table_count = flecs_sparse_count(store);
+    for (i = -1; i < table_count; i ++) {
+        ecs_table_t *table = i == -1 ? &world->store.root :
+            flecs_sparse_get_dense_t(store, ecs_table_t, i);
+        if (i != -1 && table == &world->store.root) {
+            continue;
+        }
+        if (flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_map_val_t *index = ecs_map_get(&fork->table_index, table->id);
+        if (index && !changed[index[0] - 1]) {
+            continue;
+        }
+
+        const ecs_entity_t *ids = ecs_table_entities(table);
+        int32_t j, table_entity_count = ecs_table_count(table);
+        for (j = 0; j < table_entity_count; j ++) {
+            if (!ecs_map_get(&entities, ids[j])) {
+                ecs_vec_append_t(NULL, &deleted, ecs_entity_t)[0] = ids[j];
+            }
+        }
+    }
+
+    const ecs_entity_t *deleted_ids = ecs_vec_first(&deleted);
+    for (i = 0; i < ecs_vec_count(&deleted); i ++) {
+        if (ecs_is_alive(world, deleted_ids[i])) {
+            ecs_delete(world, deleted_ids[i]);
+        }
+    }
+
+    /* Instance children are part of the fork, so prevent adding an IsA 
+     * relationship from instantiating prefab hierarchies. */
+    ecs_stage_t *stage = world->stages[0];
+    ecs_entity_t base = stage->base;
+    stage->base = EcsWildcard;
+
+    for (i = 0; i < count; i ++) {
+        if (changed[i]) {
+            alive[i] = flecs_fork_restore_entities(world, &tables[i], alive[i]);
+        }
+    }
+
+    stage->base = base;
+
+    for (i = 0; i < count; i ++) {
+        flecs_fork_restore_values(world, &tables[i], alive[i], changed[i]);
+    }
+
+    ecs_vec_fini_t(NULL, &deleted, ecs_entity_t);
+    ecs_map_fini(&entities);
+    ecs_os_free(alive);
+    ecs_os_free(changed);
+error:
+    return;
+}
+
+#endif
+
+#ifndef FLECS_SYSTEM_PRIVATE_H
+#define FLECS_SYSTEM_PRIVATE_H
+
+#ifdef FLECS_SYSTEM
+
+#define ecs_system_t_magic     (0x65637383)
+#define ecs_system_t_tag       EcsSystem
+
+extern ecs_mixins_t ecs_system_t_mixins;
+
+/* Internal function to run a system */
+ecs_entity_t flecs_run_system(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    ecs_entity_t system,
+    ecs_system_t *system_data,
+    int32_t stage_current,
+    int32_t stage_count,
+    int32_t *chunk_cursor,
+    ecs_ftime_t delta_time,
+    void *param);
+
+#endif
+
+#endif
+
+#ifdef FLECS_TIMER
+
+static
+void ProgressTimers(ecs_iter_t *it) {
+    EcsTimer *timer = ecs_field(it, EcsTimer, 0);
+    EcsTickSource *tick_source = ecs_field(it, EcsTickSource, 1);
+
+    ecs_assert(timer != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        tick_source[i].tick = false;
+
+        if (!timer[i].active) {
+            continue;
+        }
+
+        const ecs_world_info_t *info = ecs_get_world_info(it->world);
+        ecs_ftime_t time_elapsed = timer[i].time + info->delta_time_raw;
+        ecs_ftime_t timeout = timer[i].timeout;
+        
+        if (time_elapsed >= timeout) {
+            ecs_ftime_t t = time_elapsed - timeout;
+            if (t > timeout) {
+                t = 0;
+            }
+
+            timer[i].time = t; /* Initialize with remainder */
+            tick_source[i].tick = true;
+            tick_source[i].time_elapsed = time_elapsed - timer[i].overshoot;
+            timer[i].overshoot = t;
+
+            if (timer[i].single_shot) {
+                timer[i].active = false;
+            }
+        } else {
+            timer[i].time = time_elapsed;
+        }  
+    }
+}
+
+static
+void ProgressRateFilters(ecs_iter_t *it) {
+    EcsRateFilter *filter = ecs_field(it, EcsRateFilter, 0);
+    EcsTickSource *tick_dst = ecs_field(it, EcsTickSource, 1);
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_entity_t src = filter[i].src;
+        bool inc = false;
+
+        filter[i].time_elapsed += it->delta_time;
+
+        if (src) {
+            const EcsTickSource *tick_src = ecs_get(
+                it->world, src, EcsTickSource);
+            if (tick_src) {
+                inc = tick_src->tick;
+            } else {
+                inc = true;
+            }
+        } else {
+            inc = true;
+        }
+
+        if (inc) {
+            filter[i].tick_count ++;
+            bool triggered = !(filter[i].tick_count % filter[i].rate);
+            tick_dst[i].tick = triggered;
+            tick_dst[i].time_elapsed = filter[i].time_elapsed;
+
+            if (triggered) {
+                filter[i].time_elapsed = 0;
+            }            
+        } else {
+            tick_dst[i].tick = false;
+        }
+    }
+}
+
+static
+void ProgressTickSource(ecs_iter_t *it) {
+    EcsTickSource *tick_src = ecs_field(it, EcsTickSource, 0);
+
+    /* If tick source has no filters, tick unconditionally */
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        tick_src[i].tick = true;
+        tick_src[i].time_elapsed = it->delta_time;
+    }
+}
+
+ecs_entity_t ecs_set_timeout(
+    ecs_world_t *world,
+    ecs_entity_t timer,
+    ecs_ftime_t timeout)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!timer) {
+        timer = ecs_entity(world, {0});
+    }
+
+    ecs_set(world, timer, EcsTimer, {
+        .timeout = timeout,
+        .single_shot = true,
+        .active = true
+    });
+
+    ecs_system_t *system_data = flecs_poly_get(world, timer, ecs_system_t);
+    if (system_data) {
+        system_data->tick_source = timer;
+    }
+
+error:
+    return timer;
+}
+
+ecs_ftime_t ecs_get_timeout(
+    const ecs_world_t *world,
+    ecs_entity_t timer)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(timer != 0, ECS_INVALID_PARAMETER, NULL);
+
+    const EcsTimer *value = ecs_get(world, timer, EcsTimer);
+    if (value) {
+        return value->timeout;
+    }
+error:
+    return 0;
+}
+
+ecs_entity_t ecs_set_interval(
+    ecs_world_t *world,
+    ecs_entity_t timer,
+    ecs_ftime_t interval)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!timer) {
+        timer = ecs_new_w(world, EcsTimer);
+    }
+
+    EcsTimer *t = ecs_ensure(world, timer, EcsTimer);
+    ecs_check(t != NULL, ECS_INTERNAL_ERROR, NULL);
+    t->timeout = interval;
+    t->active = true;
+    ecs_modified(world, timer, EcsTimer);
+
+    ecs_system_t *system_data = flecs_poly_get(world, timer, ecs_system_t);
+    if (system_data) {
+        system_data->tick_source = timer;
+    }
+error:
+    return timer;  
+}
+
+ecs_ftime_t ecs_get_interval(
+    const ecs_world_t *world,
+    ecs_entity_t timer)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    if (!timer) {
+        return 0;
+    }
+
+    const EcsTimer *value = ecs_get(world, timer, EcsTimer);
+    if (value) {
+        return value->timeout;
+    }
+error:
+    return 0;
+}
+
+void ecs_start_timer(
+    ecs_world_t *world,
+    ecs_entity_t timer)
+{
+    EcsTimer *ptr = ecs_ensure(world, timer, EcsTimer);
+    ecs_check(ptr != NULL, ECS_INTERNAL_ERROR, NULL);
+    ptr->active = true;
+    ptr->time = 0;
+error:
+    return;
+}
+
+void ecs_stop_timer(
     ecs_world_t *world,
     ecs_entity_t timer)
 {
@@ -32663,6 +37494,10 @@ void flecs_allocator_init(
     flecs_ballocator_init_n(&a->chunks, ecs_block_allocator_t,
         FLECS_SPARSE_PAGE_SIZE);
     flecs_sparse_init_t(&a->sizes, NULL, &a->chunks, ecs_block_allocator_t);
+#ifdef FLECS_HUGE_PAGES
+    ecs_os_zeromem(&a->arena);
+    a->chunks.arena = &a->arena;
+#endif
 #endif
 }
 
@@ -32682,6 +37517,9 @@ void flecs_allocator_fini(
     flecs_sparse_fini(&a->sizes);
 
     flecs_ballocator_fini(&a->chunks);
+#ifdef FLECS_HUGE_PAGES
+    flecs_page_arena_fini(&a->arena);
+#endif
 #endif
 }
 
@@ -32706,6 +37544,9 @@ ecs_block_allocator_t* flecs_allocator_get(
         result = flecs_sparse_ensure_fast_t(&a->sizes, 
             ecs_block_allocator_t, (uint32_t)hash);
         flecs_ballocator_init(result, size);
+#ifdef FLECS_HUGE_PAGES
+        result->arena = &a->arena;
+#endif
     }
 
     ecs_assert(result->data_size == size, ECS_INTERNAL_ERROR, NULL);
@@ -32941,6 +37782,82 @@ int64_t ecs_block_allocator_free_count = 0;
  * allocation sizes, which are more likely to be reused. */
 #define FLECS_MIN_CHUNKS_PER_BLOCK 1
 
+#ifdef FLECS_HUGE_PAGES
+
+/* Header of a slab allocated by a page arena */
+typedef struct ecs_page_slab_t {
+    struct ecs_page_slab_t *next;
+    bool os_page; /* Allocated with ecs_os_page_alloc */
+} ecs_page_slab_t;
+
+#define FLECS_PAGE_SLAB_HEADER ECS_ALIGN(ECS_SIZEOF(ecs_page_slab_t), 16)
+
+static
+void* flecs_page_alloc(
+    ecs_size_t size,
+    bool *os_page)
+{
+    if (ecs_os_api.page_alloc_) {
+        void *result = ecs_os_page_alloc(size);
+        if (result) {
+            *os_page = true;
+            return result;
+        }
+    }
+
+    *os_page = false;
+    return ecs_os_malloc(size);
+}
+
+static
+void* flecs_page_arena_alloc(
+    ecs_page_arena_t *arena,
+    ecs_size_t size)
+{
+    ecs_assert(size <= (FLECS_HUGE_PAGE_SIZE - FLECS_PAGE_SLAB_HEADER),
+        ECS_INTERNAL_ERROR, NULL);
+
+    /* Blocks are never returned to the arena, they're owned by the block
+     * allocator until the arena is freed. */
+    if (!arena->slab || ((arena->used + size) > FLECS_HUGE_PAGE_SIZE)) {
+        bool os_page;
+        ecs_page_slab_t *slab = flecs_page_alloc(FLECS_HUGE_PAGE_SIZE, &os_page);
+        slab->next = arena->slab;
+        slab->os_page = os_page;
+        arena->slab = slab;
+        arena->used = FLECS_PAGE_SLAB_HEADER;
+    }
+
+    void *result = ECS_OFFSET(arena->slab, arena->used);
+    arena->used += ECS_ALIGN(size, 16);
+    return result;
+}
+
+void flecs_page_arena_fini(
+    ecs_page_arena_t *arena)
+{
+    ecs_page_slab_t *slab = arena->slab, *next;
+    for (; slab; slab = next) {
+        next = slab->next;
+        if (slab->os_page) {
+            ecs_os_page_free(slab, FLECS_HUGE_PAGE_SIZE);
+        } else {
+            ecs_os_free(slab);
+        }
+    }
+
+    arena->slab = NULL;
+    arena->used = 0;
+}
+
+/* Large allocations from an allocator with an arena are directly allocated as
+ * pages, which avoids fragmenting huge pages with large table columns. */
+#define flecs_balloc_is_page(ba)\
+    ((ba)->arena && ecs_os_api.page_alloc_ &&\
+        ((ba)->data_size >= FLECS_HUGE_PAGE_SIZE))
+
+#endif
+
 static
 ecs_block_allocator_chunk_header_t* flecs_balloc_block(
     ecs_block_allocator_t *allocator)
@@ -32949,9 +37866,17 @@ ecs_block_allocator_chunk_header_t* flecs_balloc_block(
         return NULL;
     }
 
-    ecs_block_allocator_block_t *block = 
-        ecs_os_malloc(ECS_SIZEOF(ecs_block_allocator_block_t) +
+    ecs_block_allocator_block_t *block;
+#ifdef FLECS_HUGE_PAGES
+    if (allocator->arena) {
+        block = flecs_page_arena_alloc(allocator->arena, 
+            ECS_SIZEOF(ecs_block_allocator_block_t) + allocator->block_size);
+    } else
+#endif
+    {
+        block = ecs_os_malloc(ECS_SIZEOF(ecs_block_allocator_block_t) +
             allocator->block_size);
+    }
     ecs_block_allocator_chunk_header_t *first_chunk = ECS_OFFSET(block, 
         ECS_SIZEOF(ecs_block_allocator_block_t));
 
@@ -33000,6 +37925,9 @@ void flecs_ballocator_init(
     ba->block_size = ba->chunks_per_block * ba->chunk_size;
     ba->head = NULL;
     ba->block_head = NULL;
+#ifdef FLECS_HUGE_PAGES
+    ba->arena = NULL;
+#endif
 #endif
 }
 
@@ -33043,6 +37971,58 @@ void flecs_ballocator_fini(
 #endif
 
     ecs_block_allocator_block_t *block;
+    for (block = ba->block_head; block;) {
+        ecs_block_allocator_block_t *next = block->next;
+#ifdef FLECS_HUGE_PAGES
+        /* Blocks from an arena are freed together with the arena */
+        if (!ba->arena)
+#endif
+        {
+            ecs_os_free(block);
+        }
+        ecs_os_linc(&ecs_block_allocator_free_count);
+        block = next;
+    }
+
+    ba->block_head = NULL;
+#endif
+}
+
+int64_t flecs_ballocator_reclaim(
+    ecs_block_allocator_t *ba)
+{
+    ecs_assert(ba != NULL, ECS_INTERNAL_ERROR, NULL);
+    (void)ba;
+
+#ifndef FLECS_USE_OS_ALLOC
+#ifdef FLECS_HUGE_PAGES
+    if (ba->arena) {
+        /* Blocks can only be returned by freeing the arena */
+        return 0;
+    }
+#endif
+
+    int32_t block_count = 0;
+    ecs_block_allocator_block_t *block;
+    for (block = ba->block_head; block; block = block->next) {
+        block_count ++;
+    }
+
+    if (!block_count) {
+        return 0;
+    }
+
+    /* Blocks can only be freed if all chunks are in the free list */
+    int32_t free_count = 0;
+    ecs_block_allocator_chunk_header_t *chunk;
+    for (chunk = ba->head; chunk; chunk = chunk->next) {
+        free_count ++;
+    }
+
+    if (free_count != (block_count * ba->chunks_per_block)) {
+        return 0;
+    }
+
     for (block = ba->block_head; block;) {
         ecs_block_allocator_block_t *next = block->next;
         ecs_os_free(block);
@@ -33050,7 +38030,13 @@ void flecs_ballocator_fini(
         block = next;
     }
 
+    ba->head = NULL;
     ba->block_head = NULL;
+
+    return (int64_t)block_count * 
+        (ba->block_size + ECS_SIZEOF(ecs_block_allocator_block_t));
+#else
+    return 0;
 #endif
 }
 
@@ -33081,6 +38067,16 @@ void* flecs_balloc_w_dbg_info(
 #else
 
     if (ba->chunks_per_block <= FLECS_MIN_CHUNKS_PER_BLOCK) {
+#ifdef FLECS_HUGE_PAGES
+        if (flecs_balloc_is_page(ba)) {
+            result = ecs_os_page_alloc(ba->data_size);
+            if (result) {
+                return result;
+            }
+            /* Don't fall back to malloc, as the chunk couldn't be freed */
+            ecs_abort(ECS_OUT_OF_MEMORY, NULL);
+        }
+#endif
         return ecs_os_malloc(ba->data_size);
     }
 
@@ -33164,6 +38160,12 @@ void flecs_bfree_w_dbg_info(
     }
 
     if (ba->chunks_per_block <= FLECS_MIN_CHUNKS_PER_BLOCK) {
+#ifdef FLECS_HUGE_PAGES
+        if (flecs_balloc_is_page(ba)) {
+            ecs_os_page_free(memory, ba->data_size);
+            return;
+        }
+#endif
         ecs_os_free(memory);
         return;
     }
@@ -35002,6 +40004,26 @@ bool flecs_sparse_has(
     return dense && (dense < sparse->count);
 }
 
+void flecs_sparse_prefetch(
+    const ecs_sparse_t *sparse,
+    uint64_t id)
+{
+    ecs_assert(sparse != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    uint64_t index = (uint32_t)id;
+    ecs_sparse_page_t *page = flecs_sparse_get_page(sparse, 
+        FLECS_SPARSE_PAGE(index));
+    if (!page || !page->sparse) {
+        return;
+    }
+
+    int32_t offset = FLECS_SPARSE_OFFSET(id);
+    flecs_prefetch(&page->sparse[offset]);
+    if (page->data) {
+        flecs_prefetch(DATA(page->data, sparse->size, offset));
+    }
+}
+
 int32_t flecs_sparse_count(
     const ecs_sparse_t *sparse)
 {
@@ -37420,6 +42442,44 @@ void flecs_query_str_append_bitset(
     ecs_strbuf_list_pop(buf, "}");
 }
 
+/* Append the terms reordered by the cost based planner, in the order of their
+ * current estimated number of tables. */
+static
+void flecs_query_plan_cost(
+    const ecs_query_t *q,
+    ecs_strbuf_t *buf)
+{
+    int32_t i, j, count = 0, term_count = q->term_count;
+    int32_t cost[FLECS_TERM_COUNT_MAX], order[FLECS_TERM_COUNT_MAX];
+
+    for (i = 0; i < term_count; i ++) {
+        cost[i] = flecs_query_term_cost(q->real_world, q, &q->terms[i]);
+        if (cost[i] == -1) {
+            continue;
+        }
+
+        for (j = count; j > 0 && cost[order[j - 1]] > cost[i]; j --) {
+            order[j] = order[j - 1];
+        }
+
+        order[j] = i;
+        count ++;
+    }
+
+    if (!count) {
+        return;
+    }
+
+    ecs_strbuf_appendlit(buf, "#[normal]planned by cost (estimated tables):\n");
+    for (i = 0; i < count; i ++) {
+        const ecs_term_t *term = &q->terms[order[i]];
+        char *id_str = ecs_id_str(q->world, term->id);
+        ecs_strbuf_append(buf, "  #[yellow]%s#[reset] (%d)\n", 
+            id_str, cost[order[i]]);
+        ecs_os_free(id_str);
+    }
+}
+
 static
 void flecs_query_plan_w_profile(
     const ecs_query_t *q,
@@ -37431,6 +42491,9 @@ void flecs_query_plan_w_profile(
     int32_t i, count = impl->op_count, indent = 0;
     if (!count) {
         ecs_strbuf_append(buf, "");
+        if (q->flags & EcsQueryPlanByCost) {
+            flecs_query_plan_cost(q, buf);
+        }
         return; /* No plan */
     }
 
@@ -37556,6 +42619,10 @@ void flecs_query_plan_w_profile(
 
         ecs_strbuf_appendch(buf, '\n');
     }
+
+    if (q->flags & EcsQueryPlanByCost) {
+        flecs_query_plan_cost(q, buf);
+    }
 }
 
 char* ecs_query_plan_w_profile(
@@ -38796,7 +43863,13 @@ int flecs_term_finalize(
         if (ecs_id(EcsMember) != 0) {
             if (first_entity) {
                 if (ecs_has(world, first_entity, EcsMember)) {
-                    term->flags_ |= EcsTermIsMember;
+                    /* Members of SoA structs are components. They are only
+                     * matched as member when comparing the member value. */
+                    if (!ecs_has(world, first_entity, EcsComponent) || 
+                        ECS_TERM_REF_ID(second))
+                    {
+                        term->flags_ |= EcsTermIsMember;
+                    }
                 }
             }
         }
@@ -39183,6 +44256,10 @@ int flecs_query_finalize_terms(
             nodata_term = true;
         } else if (!ecs_get_type_info(world, term->id)) {
             nodata_term = true;
+        } else if (!ECS_IS_PAIR(term->id) && 
+            (flecs_component_get_flags(world, term->id) & EcsIdSoA)) 
+        {
+            nodata_term = true;
         } else if (term->flags_ & EcsTermIsMember) {
             nodata_term = true;
         } else if (scope_nesting) {
@@ -39690,6 +44767,11 @@ bool flecs_query_finalize_simple(
             type_info = flecs_determine_type_info_for_component(world, id);
         }
 
+        if (cr_flags & EcsIdSoA) {
+            /* Data of SoA component is stored in separate components */
+            type_info = NULL;
+        }
+
         bool cacheable = true, trivial = true;
 
         if (type_info) {
@@ -40524,6 +45606,7 @@ ecs_component_record_t* flecs_component_new(
         cr->pair = flecs_bcalloc_w_dbg_info(
             &world->allocators.pair_record, "ecs_pair_record_t");
         cr->pair->reachable.current = -1;
+        cr->pair->reachable.up_current = -1;
 
         rel = ECS_PAIR_FIRST(id);
         if (!is_value_pair) {
@@ -40617,6 +45700,11 @@ ecs_component_record_t* flecs_component_new(
         cr->flags |= flecs_component_get_flags_intern(
             world, id, rel, tgt, cr->type_info);
 
+        if (cr->flags & EcsIdSoA) {
+            /* Data of SoA components is stored in other components */
+            cr->type_info = NULL;
+        }
+
         /* Set flag that indicates entity is used as component/relationship. */
         flecs_add_flag(world, rel, EcsEntityIsId);
 
@@ -40758,6 +45846,8 @@ void flecs_component_free(
         flecs_name_index_free(cr->pair->name_index);
         ecs_vec_fini_t(&world->allocator, &cr->pair->reachable.ids, 
             ecs_reachable_elem_t);
+        ecs_vec_fini_t(&world->allocator, &cr->pair->reachable.up, 
+            ecs_reachable_up_t);
         flecs_bfree_w_dbg_info(&world->allocators.pair_record, 
                 cr->pair, "ecs_pair_record_t");
     }
@@ -40869,6 +45959,10 @@ bool flecs_component_set_type_info(
     ecs_component_record_t *cr,
     const ecs_type_info_t *ti)
 {
+    if (cr->flags & EcsIdSoA) {
+        ti = NULL;
+    }
+
     bool is_wildcard = ecs_id_is_wildcard(cr->id);
     if (!is_wildcard) {
         if (ti) {
@@ -41313,6 +46407,7 @@ void flecs_entity_index_init(
     ecs_vec_set_count_t(allocator, &index->dense, uint64_t, 1);
     ecs_vec_init_t(allocator, &index->pages, ecs_entity_index_page_t*, 0);
     ecs_vec_init_t(allocator, &index->ranges, ecs_entity_range_t*, 0);
+    ecs_vec_init_t(NULL, &index->retired, ecs_entity_index_retired_t, 0);
 }
 
 void flecs_entity_index_fini(
@@ -41326,6 +46421,9 @@ void flecs_entity_index_fini(
     }
     ecs_vec_fini_t(index->allocator, &index->pages, ecs_entity_index_page_t*);
 
+    flecs_entity_index_free_retired(index);
+    ecs_vec_fini_t(NULL, &index->retired, ecs_entity_index_retired_t);
+
     /* Free entity id ranges */
     {
         int32_t r, range_count = ecs_vec_count(&index->ranges);
@@ -41388,6 +46486,23 @@ ecs_record_t* flecs_entity_index_try_get_any(
     return r;
 }
 
+void flecs_entity_index_prefetch(
+    const ecs_entity_index_t *index,
+    uint64_t entity)
+{
+    uint32_t id = (uint32_t)entity;
+    int32_t page_index = (int32_t)(id >> FLECS_ENTITY_PAGE_BITS);
+    if (page_index >= ecs_vec_count(&index->pages)) {
+        return;
+    }
+
+    ecs_entity_index_page_t *page = ecs_vec_get_t(&index->pages,
+        ecs_entity_index_page_t*, page_index)[0];
+    if (page) {
+        flecs_prefetch(&page->records[id & FLECS_ENTITY_PAGE_MASK]);
+    }
+}
+
 ecs_record_t* flecs_entity_index_try_get(
     const ecs_entity_index_t *index,
     uint64_t entity)
@@ -41498,7 +46613,8 @@ ecs_entity_range_t* flecs_entity_index_find_range(
 static
 ecs_record_t* flecs_entity_index_remove_intern(
     ecs_entity_index_t *index,
-    uint64_t entity)
+    uint64_t entity,
+    bool inc_generation)
 {
     ecs_record_t *r = flecs_entity_index_try_get(index, entity);
     if (!r) {
@@ -41517,7 +46633,7 @@ ecs_record_t* flecs_entity_index_remove_intern(
     r->row = 0;
     r->dense = i_swap;
     ecs_vec_get_t(&index->dense, uint64_t, dense)[0] = e_swap;
-    e_swap_ptr[0] = ECS_GENERATION_INC(entity);
+    e_swap_ptr[0] = inc_generation ? ECS_GENERATION_INC(entity) : entity;
 
     ecs_assert(!flecs_entity_index_is_alive(index, entity),
         ECS_INTERNAL_ERROR, NULL);
@@ -41529,7 +46645,7 @@ void flecs_entity_index_remove(
     ecs_entity_index_t *index,
     uint64_t entity)
 {
-    ecs_record_t *r = flecs_entity_index_remove_intern(index, entity);
+    ecs_record_t *r = flecs_entity_index_remove_intern(index, entity, true);
     if (!r) {
         /* Entity was not alive, nothing else to be done. */
         return;
@@ -41560,6 +46676,13 @@ void flecs_entity_index_remove(
     }
 }
 
+void flecs_entity_index_release(
+    ecs_entity_index_t *index,
+    uint64_t entity)
+{
+    flecs_entity_index_remove_intern(index, entity, false);
+}
+
 void flecs_entity_index_set_range(
     ecs_entity_index_t *index,
     ecs_entity_range_t *range)
@@ -41775,6 +46898,65 @@ uint64_t* flecs_entity_index_new_ids(
     return ecs_vec_get_t(&index->dense, uint64_t, alive_count);
 }
 
+static
+void flecs_entity_index_grow(
+    ecs_entity_index_t *index,
+    ecs_vec_t *vec,
+    ecs_size_t elem_size,
+    int32_t elem_count,
+    bool shared)
+{
+    if (ecs_vec_size(vec) >= elem_count) {
+        return;
+    }
+
+    if (!shared) {
+        ecs_vec_set_min_size(index->allocator, vec, elem_size, elem_count);
+        return;
+    }
+
+    /* Other threads may be reading the array, so don't free it until the
+     * index is no longer shared. */
+    ecs_vec_t copy = ecs_vec_copy(index->allocator, vec, elem_size);
+    ecs_vec_set_min_size(index->allocator, &copy, elem_size, elem_count);
+
+    if (vec->array) {
+        ecs_entity_index_retired_t *retired = ecs_vec_append_t(
+            NULL, &index->retired, ecs_entity_index_retired_t);
+        retired->array = vec->array;
+        retired->size = elem_size * vec->size;
+    }
+
+    vec->size = copy.size;
+    vec->array = copy.array;
+}
+
+void flecs_entity_index_reserve(
+    ecs_entity_index_t *index,
+    int32_t count,
+    bool shared)
+{
+    flecs_entity_index_grow(index, &index->dense, ECS_SIZEOF(uint64_t), 
+        index->alive_count + count, shared);
+
+    uint64_t max_id = (uint64_t)index->max_id + flecs_ito(uint64_t, count);
+    max_id = ECS_MIN(max_id, UINT32_MAX);
+    flecs_entity_index_grow(index, &index->pages, 
+        ECS_SIZEOF(ecs_entity_index_page_t*), 
+        (int32_t)(max_id >> FLECS_ENTITY_PAGE_BITS) + 1, shared);
+}
+
+void flecs_entity_index_free_retired(
+    ecs_entity_index_t *index)
+{
+    int32_t i, count = ecs_vec_count(&index->retired);
+    ecs_entity_index_retired_t *retired = ecs_vec_first(&index->retired);
+    for (i = 0; i < count; i ++) {
+        flecs_free(index->allocator, retired[i].size, retired[i].array);
+    }
+    ecs_vec_clear(&index->retired);
+}
+
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
     int32_t size)
@@ -42143,6 +47325,14 @@ void flecs_on_replace_parent(ecs_iter_t *it) {
             flecs_update_component_monitors(world, 
                 &(ecs_type_t){ .count = 1, .array = &added },
                 &(ecs_type_t) { .count = 1, .array = &removed });
+
+            /* Entity didn't change tables, so reachable caches of its subtree
+             * aren't invalidated by the table move. */
+            ecs_component_record_t *cr_t = flecs_components_get(
+                world, ecs_pair(EcsWildcard, e));
+            if (cr_t) {
+                flecs_emit_propagate_invalidate_tables(world, cr_t);
+            }
         }
 
         flecs_journal_end();
@@ -43109,6 +48299,142 @@ void* flecs_component_sparse_emplace(
 
 const int16_t flecs_table_empty_component_map[FLECS_HI_COMPONENT_ID] = {0};
 
+/* Alignment that is assumed to be guaranteed by ecs_os_malloc(). */
+#define FLECS_TABLE_MALLOC_ALIGN (2 * ECS_SIZEOF(void*))
+
+/* Get alignment of column storage. Returns 0 if the storage can be allocated
+ * with ecs_os_malloc(), which is the case for most columns. A column requires
+ * aligned storage when its component has a large alignment, or when the world
+ * had a column alignment configured when the table was created. */
+static
+int32_t flecs_table_column_align(
+    const ecs_table_t *table,
+    const ecs_type_info_t *ti)
+{
+    int32_t align = table->_->column_alignment;
+    if (ti->alignment > align) {
+        align = ti->alignment;
+    }
+
+    if (align <= FLECS_TABLE_MALLOC_ALIGN) {
+        return 0;
+    }
+
+    return align;
+}
+
+/* Allocate column storage. Aligned storage is over-allocated, and stores the
+ * pointer returned by ecs_os_malloc() right before the column array. The size
+ * is padded to a multiple of the alignment so that vector loads for the last
+ * elements in a column never read past the end of the allocation. */
+static
+void* flecs_table_column_alloc(
+    ecs_size_t size,
+    int32_t align)
+{
+    if (!align) {
+        return ecs_os_malloc(size);
+    }
+
+    ecs_assert(!(align & (align - 1)), ECS_INTERNAL_ERROR, NULL);
+
+    size = ECS_ALIGN(size, align);
+    char *ptr = ecs_os_malloc(size + align + ECS_SIZEOF(void*));
+    uintptr_t addr = (uintptr_t)(ptr + ECS_SIZEOF(void*));
+    addr = (addr + flecs_ito(uintptr_t, align - 1)) &
+        ~flecs_ito(uintptr_t, align - 1);
+
+    void **result = (void**)addr;
+    result[-1] = ptr;
+    return result;
+}
+
+static
+void flecs_table_column_free(
+    void *ptr,
+    int32_t align)
+{
+    if (ptr && align) {
+        ptr = ((void**)ptr)[-1];
+    }
+    ecs_os_free(ptr);
+}
+
+/* Same as ecs_vec_init(), but for column storage. */
+static
+void flecs_table_column_init(
+    ecs_vec_t *v,
+    ecs_size_t elem_size,
+    int32_t align,
+    int32_t elem_count)
+{
+    if (!align) {
+        ecs_vec_init(NULL, v, elem_size, elem_count);
+        return;
+    }
+
+    ecs_vec_init(NULL, v, elem_size, 0);
+    if (elem_count) {
+        v->array = flecs_table_column_alloc(elem_size * elem_count, align);
+        v->size = elem_count;
+    }
+}
+
+/* Same as ecs_vec_fini(), but for column storage. */
+static
+void flecs_table_column_fini(
+    ecs_vec_t *v,
+    ecs_size_t elem_size,
+    int32_t align)
+{
+    if (!align) {
+        ecs_vec_fini(NULL, v, elem_size);
+        return;
+    }
+
+    flecs_table_column_free(v->array, align);
+    v->array = NULL;
+    v->count = 0;
+    v->size = 0;
+}
+
+/* Same as ecs_vec_set_size(), but for column storage. */
+static
+void flecs_table_column_set_size(
+    ecs_vec_t *v,
+    ecs_size_t elem_size,
+    int32_t align,
+    int32_t elem_count)
+{
+    if (!align) {
+        ecs_vec_set_size(NULL, v, elem_size, elem_count);
+        return;
+    }
+
+    if (v->size == elem_count) {
+        return;
+    }
+
+    if (elem_count < v->count) {
+        elem_count = v->count;
+    }
+
+    elem_count = flecs_next_pow_of_2(elem_count);
+    if (elem_count < 2) {
+        elem_count = 2;
+    }
+
+    if (elem_count != v->size) {
+        void *array = flecs_table_column_alloc(elem_size * elem_count, align);
+        if (v->count) {
+            ecs_os_memcpy(array, v->array, elem_size * v->count);
+        }
+        flecs_table_column_free(v->array, align);
+        v->array = array;
+        v->size = elem_count;
+    }
+}
+
 /* Table sanity check to detect storage issues. Only enabled in SANITIZE mode as
  * this can severely slow down many ECS operations. */
 #ifdef FLECS_SANITIZE
@@ -43147,8 +48473,12 @@ void flecs_table_check_sanity(
             ecs_assert(table->data.columns[i].ti != NULL,
                 ECS_INTERNAL_ERROR, NULL);
             if (size) {
-                ecs_assert(table->data.columns[i].data != NULL, 
+                ecs_assert(table->data.columns[i].data != NULL,
                     ECS_INTERNAL_ERROR, NULL);
+                int32_t align = flecs_table_column_align(
+                    table, table->data.columns[i].ti);
+                ecs_assert(!align || !((uintptr_t)table->data.columns[i].data
+                    % flecs_ito(uintptr_t, align)), ECS_INTERNAL_ERROR, NULL);
             } else {
                 ecs_assert(table->data.columns[i].data == NULL, 
                     ECS_INTERNAL_ERROR, NULL);
@@ -43398,6 +48728,10 @@ void flecs_table_init_flags(
             table->trait_flags |= EcsIdSparse;
         } else if (id == EcsDontFragment) {
             table->trait_flags |= EcsIdDontFragment;
+        } else if (id == EcsSoA) {
+            table->trait_flags |= EcsIdSoA;
+        } else if (id == EcsDenseToggle) {
+            table->trait_flags |= EcsIdDenseToggle;
         } else if (id ==  EcsExclusive) {
             table->trait_flags |= EcsIdExclusive;   
         } else if (id == EcsTraversable) {
@@ -43455,6 +48789,17 @@ void flecs_table_init_flags(
                 if (!meta->bs_count) {
                     meta->bs_offset = flecs_ito(int16_t, i);
                 }
+
+                /* Rows are partitioned on the first dense toggle component.
+                 * Other dense toggle components use regular bitset toggles. */
+                if (!(table->flags & EcsTableHasDenseToggle) &&
+                    (flecs_component_get_flags(world, id & ECS_COMPONENT_MASK) 
+                        & EcsIdDenseToggle))
+                {
+                    table->flags |= EcsTableHasDenseToggle;
+                    meta->dense_toggle = meta->bs_count;
+                }
+
                 meta->bs_count ++;
             }
             if (ECS_HAS_ID_FLAG(id, AUTO_OVERRIDE)) {
@@ -43648,6 +48993,9 @@ void flecs_table_init(
     /* Make sure table->flags is initialized */
     flecs_table_init_flags(world, table);
 
+    /* Column alignment can't change for the lifetime of the table */
+    table->_->column_alignment = flecs_ito(int16_t, world->column_alignment);
+
     /* The following code walks the table type to discover which id records the
      * table needs to register table records with. 
      *
@@ -44274,7 +49622,8 @@ void flecs_table_fini_data(
             for (c = 0; c < column_count; c ++) {
                 ecs_column_t *column = &columns[c];
                 ecs_vec_t v = ecs_vec_from_column(column, table, column->ti->size);
-                ecs_vec_fini(NULL, &v, column->ti->size);
+                flecs_table_column_fini(&v, column->ti->size,
+                    flecs_table_column_align(table, column->ti));
                 column->data = NULL;
             }
 
@@ -44318,6 +49667,7 @@ void flecs_table_fini_data(
 
     table->data.count = 0;
     table->_->traversable_count = 0;
+    table->_->dense_toggle_count = 0;
     table->flags &= ~EcsTableHasTraversable;
     table->flags |= EcsTableEmpty;
     table->flags &= ~EcsTableNotEmpty;
@@ -44632,6 +49982,7 @@ void flecs_table_grow_column(
     int32_t column_index,
     ecs_vec_t *column,
     const ecs_type_info_t *ti,
+    int32_t align,
     int32_t to_add,
     int32_t dst_size,
     bool construct)
@@ -44653,7 +50004,7 @@ void flecs_table_grow_column(
 
         /* Create vector */
         ecs_vec_t dst;
-        ecs_vec_init(NULL, &dst, elem_size, dst_size);
+        flecs_table_column_init(&dst, elem_size, align, dst_size);
         dst.count = dst_count;
 
         void *src_buffer = column->array;
@@ -44669,13 +50020,13 @@ void flecs_table_grow_column(
         }
 
         /* Free old vector */
-        ecs_vec_fini(NULL, column, elem_size);
+        flecs_table_column_fini(column, elem_size, align);
 
         *column = dst;
     } else {
         /* If array won't realloc or has no move, simply add new elements */
         if (can_realloc) {
-            ecs_vec_set_size(NULL, column, elem_size, dst_size);
+            flecs_table_column_set_size(column, elem_size, align, dst_size);
         }
 
         ecs_vec_grow(NULL, column, elem_size, to_add);
@@ -44696,7 +50047,8 @@ int32_t flecs_table_grow_data(
     ecs_table_t *table,
     int32_t to_add,
     int32_t size,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     flecs_poly_assert(world, ecs_world_t);
 
@@ -44750,13 +50102,14 @@ int32_t flecs_table_grow_data(
         ecs_column_t *column = &columns[i];
         const ecs_type_info_t *ti = column->ti;
         ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, to_add, size, true);
+        flecs_table_grow_column(world, table, i, &v_column, ti,
+            flecs_table_column_align(table, ti), to_add, size, construct);
         ecs_assert(v_column.size == size, ECS_INTERNAL_ERROR, NULL);
         ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
         ecs_assert(v_column.count == v_entities.count, ECS_INTERNAL_ERROR, NULL);
         column->data = v_column.array;
 
-        if (to_add) {
+        if (to_add && construct) {
             flecs_table_invoke_add_hooks(
                 world, table, i, e, count, to_add, false);
         }
@@ -44826,7 +50179,10 @@ void flecs_table_fast_append(
         ecs_column_t *column = &columns[i];
         const ecs_type_info_t *ti = column->ti;
         ecs_vec_t v = ecs_vec_from_column(column, table, ti->size);
-        ecs_vec_append(NULL, &v, ti->size);
+        if (v.count == v.size) {
+            flecs_table_column_set_size(&v, ti->size,
+                flecs_table_column_align(table, ti), v.count + 1);
+        }
         column->data = v.array;
     }
 }
@@ -44897,7 +50253,8 @@ void flecs_table_append(
         ecs_column_t *column = &columns[i];
         const ecs_type_info_t *ti = column->ti;
         ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, 1, size, construct);
+        flecs_table_grow_column(world, table, i, &v_column, ti,
+            flecs_table_column_align(table, ti), 1, size, construct);
         column->data = v_column.array;
 
         ecs_iter_action_t on_add_hook;
@@ -44962,6 +50319,10 @@ void flecs_table_delete(
     count --;
     ecs_assert(row <= count, ECS_INTERNAL_ERROR, NULL);
 
+    if (table->flags & EcsTableHasDenseToggle) {
+        row = flecs_table_dense_toggle_delete(world, table, row);
+    }
+
     /* Move last entity id to row */
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t entity_to_move = entities[count];
@@ -45198,7 +50559,8 @@ int32_t flecs_table_appendn(
     ecs_world_t *world,
     ecs_table_t *table,
     int32_t to_add,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table bulk append"));
@@ -45214,20 +50576,44 @@ int32_t flecs_table_appendn(
     flecs_table_check_sanity(table);
     int32_t cur_count = ecs_table_count(table);
     int32_t result = flecs_table_grow_data(
-        world, table, to_add, cur_count + to_add, ids);
+        world, table, to_add, cur_count + to_add, ids, construct);
     flecs_table_check_sanity(table);
 
     return result;
 }
 
+/* Invoke OnAdd hooks for elements appended without constructing them */
+void flecs_table_invoke_on_add(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count)
+{
+    ecs_entity_t *entities = &table->data.entities[row];
+    int32_t i, column_count = table->column_count;
+    for (i = 0; i < column_count; i ++) {
+        flecs_table_invoke_add_hooks(
+            world, table, i, entities, row, count, false);
+    }
+}
+
 /* Shrink table storage to fit number of entities */
 bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table)
+{
+    return flecs_table_shrink_to(world, table, table->data.count);
+}
+
+bool flecs_table_shrink_to(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size)
 {
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table shrink"));
+    ecs_assert(size >= table->data.count, ECS_INTERNAL_ERROR, NULL);
     (void)world;
 
     flecs_table_check_sanity(table);
@@ -45235,16 +50621,16 @@ bool flecs_table_shrink(
     bool has_payload = table->data.entities != NULL;
 
     int32_t count = table->data.count;
-    if (count == table->data.size) {
+    if (size >= table->data.size) {
         return has_payload;
     }
 
     ecs_column_t *columns = table->data.columns;
     ecs_entity_t *entities = table->data.entities;
 
-    if (count) {
+    if (size) {
         ecs_assert(table->data.entities != NULL, ECS_INTERNAL_ERROR, NULL);
-        table->data.entities = ecs_os_malloc_n(ecs_entity_t, count);
+        table->data.entities = ecs_os_malloc_n(ecs_entity_t, size);
         ecs_os_memcpy_n(table->data.entities, entities, ecs_entity_t, count);
     } else {
         table->data.entities = NULL;
@@ -45258,17 +50644,20 @@ bool flecs_table_shrink(
         ecs_size_t component_size = ti->size;
         void *data = columns[i].data;
 
-        if (count) {
-            columns[i].data = ecs_os_malloc(component_size * count);
+        int32_t align = flecs_table_column_align(table, ti);
+
+        if (size) {
+            columns[i].data = flecs_table_column_alloc(
+                component_size * size, align);
             flecs_type_info_ctor_move_dtor(columns[i].data, data, count, ti);
         } else {
             columns[i].data = NULL;
         }
 
-        ecs_os_free(data);
+        flecs_table_column_free(data, align);
     }
 
-    table->data.size = count;
+    table->data.size = size;
 
     flecs_table_mark_table_dirty(world, table, 0);
 
@@ -45297,55 +50686,23 @@ void flecs_table_swap_bitset_columns(
     }
 }
 
-/* Swap two rows in a table. Used for table sorting. */
+/* Swap entity ids, toggle bits and component values of two rows, without
+ * updating the entity records. */
 static
-void flecs_table_swap(
-    ecs_world_t *world,
+void flecs_table_swap_data(
     ecs_table_t *table,
     int32_t row_1,
     int32_t row_2)
-{    
-    (void)world;
-
-    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
-        FLECS_LOCKED_STORAGE_MSG("table swap"));
-    ecs_assert(row_1 >= 0, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(row_2 >= 0, ECS_INTERNAL_ERROR, NULL);
-
-    flecs_table_check_sanity(table);
-    
-    if (row_1 == row_2) {
-        return;
-    }
-
-    /* If the table is monitored, indicate that there has been a change */
-    flecs_table_mark_table_dirty(world, table, 0);    
-
+{
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t e1 = entities[row_1];
-    ecs_entity_t e2 = entities[row_2];
-
-    ecs_record_t *record_ptr_1 = flecs_entities_get(world, e1);
-    ecs_record_t *record_ptr_2 = flecs_entities_get(world, e2);
-
-    ecs_assert(record_ptr_1 != NULL, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(record_ptr_2 != NULL, ECS_INTERNAL_ERROR, NULL);
-
-    /* Keep track of row flags */
-    uint32_t flags_1 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_1->row);
-    uint32_t flags_2 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_2->row);
-
-    /* Swap entities & records */
-    entities[row_1] = e2;
+    entities[row_1] = entities[row_2];
     entities[row_2] = e1;
-    record_ptr_1->row = ECS_ROW_TO_RECORD(row_2, flags_1);
-    record_ptr_2->row = ECS_ROW_TO_RECORD(row_1, flags_2);
 
     flecs_table_swap_bitset_columns(table, row_1, row_2);
 
     ecs_column_t *columns = table->data.columns;
     if (!columns) {
-        flecs_table_check_sanity(table);
         return;
     }
 
@@ -45382,8 +50739,133 @@ void flecs_table_swap(
             flecs_type_info_move_dtor(el_2, tmp, 1, ti);
         }
     }
+}
+
+/* Swap two rows in a table. Used for table sorting. */
+static
+void flecs_table_swap(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row_1,
+    int32_t row_2)
+{    
+    (void)world;
+
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("table swap"));
+    ecs_assert(row_1 >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row_2 >= 0, ECS_INTERNAL_ERROR, NULL);
 
     flecs_table_check_sanity(table);
+    
+    if (row_1 == row_2) {
+        return;
+    }
+
+    /* If the table is monitored, indicate that there has been a change */
+    flecs_table_mark_table_dirty(world, table, 0);    
+
+    ecs_entity_t *entities = table->data.entities;
+    ecs_record_t *record_ptr_1 = flecs_entities_get(world, entities[row_1]);
+    ecs_record_t *record_ptr_2 = flecs_entities_get(world, entities[row_2]);
+
+    ecs_assert(record_ptr_1 != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(record_ptr_2 != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    /* Keep track of row flags */
+    uint32_t flags_1 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_1->row);
+    uint32_t flags_2 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_2->row);
+
+    record_ptr_1->row = ECS_ROW_TO_RECORD(row_2, flags_1);
+    record_ptr_2->row = ECS_ROW_TO_RECORD(row_1, flags_2);
+
+    flecs_table_swap_data(table, row_1, row_2);
+
+    flecs_table_check_sanity(table);
+}
+
+/* Partition all rows of a table on its dense toggle */
+static
+void flecs_table_dense_toggle_partition(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table__t *meta = table->_;
+    ecs_bitset_t *bs = &meta->bs_columns[meta->dense_toggle];
+    int32_t first = 0, last = ecs_table_count(table) - 1;
+
+    while (first <= last) {
+        if (flecs_bitset_get(bs, first)) {
+            first ++;
+        } else if (!flecs_bitset_get(bs, last)) {
+            last --;
+        } else {
+            flecs_table_swap(world, table, first, last);
+        }
+    }
+
+    meta->dense_toggle_count = first;
+}
+
+void flecs_table_dense_toggle_sync(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row)
+{
+    if (!(table->flags & EcsTableHasDenseToggle)) {
+        return;
+    }
+
+    ecs_table__t *meta = table->_;
+    if (meta->dense_toggle_count == -1) {
+        flecs_table_dense_toggle_partition(world, table);
+        return;
+    }
+
+    ecs_bitset_t *bs = &meta->bs_columns[meta->dense_toggle];
+    int32_t enabled = meta->dense_toggle_count;
+    if (flecs_bitset_get(bs, row)) {
+        if (row >= enabled) {
+            flecs_table_swap(world, table, row, enabled);
+            meta->dense_toggle_count ++;
+        }
+    } else if (row < enabled) {
+        enabled = -- meta->dense_toggle_count;
+        flecs_table_swap(world, table, row, enabled);
+    }
+}
+
+void flecs_table_dense_toggle_invalidate(
+    ecs_table_t *table)
+{
+    if (table->flags & EcsTableHasDenseToggle) {
+        table->_->dense_toggle_count = -1;
+    }
+}
+
+int32_t flecs_table_dense_toggle_delete(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row)
+{
+    ecs_table__t *meta = table->_;
+    if (row >= meta->dense_toggle_count) {
+        /* Row is disabled, or rows are not partitioned */
+        return row;
+    }
+
+    /* Move the last enabled row to the deleted row, so the deleted row becomes
+     * the first disabled row. The record of the deleted entity is not updated,
+     * as it may already point to another table. */
+    int32_t last = -- meta->dense_toggle_count;
+    if (row != last) {
+        ecs_record_t *r = flecs_entities_get(world, table->data.entities[last]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        r->row = ECS_ROW_TO_RECORD(row, ECS_RECORD_TO_ROW_FLAGS(r->row));
+        flecs_table_swap_data(table, row, last);
+    }
+
+    return last;
 }
 
 static
@@ -45425,6 +50907,8 @@ void flecs_table_merge_column(
     ecs_vec_t *src_vec,
     ecs_column_t *dst,
     ecs_column_t *src,
+    int32_t dst_align,
+    int32_t src_align,
     int32_t column_size)
 {
     const ecs_type_info_t *ti = dst->ti;
@@ -45432,8 +50916,9 @@ void flecs_table_merge_column(
     ecs_size_t elem_size = ti->size;
     int32_t dst_count = ecs_vec_count(dst_vec);
 
-    if (!dst_count) {
-        ecs_vec_fini(NULL, dst_vec, elem_size);
+    /* Storage can only be moved if both columns use the same alignment */
+    if (!dst_count && dst_align == src_align) {
+        flecs_table_column_fini(dst_vec, elem_size, dst_align);
         *dst_vec = *src_vec;
 
     /* If the new table is not empty, move the contents from the
@@ -45441,7 +50926,8 @@ void flecs_table_merge_column(
     } else {
         int32_t src_count = src_vec->count;
 
-        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, src_count, column_size, false);
+        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, dst_align, 
+            src_count, column_size, false);
         void *dst_ptr = ECS_ELEM(dst_vec->array, elem_size, dst_count);
         void *src_ptr = src_vec->array;
 
@@ -45449,7 +50935,7 @@ void flecs_table_merge_column(
         ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
         flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
 
-        ecs_vec_fini(NULL, src_vec, elem_size);
+        flecs_table_column_fini(src_vec, elem_size, src_align);
     }
 
     dst->data = dst_vec->array;
@@ -45500,20 +50986,25 @@ void flecs_table_merge_data(
 
         if (dst_id == src_id) {
             flecs_table_merge_column(world, &dst_vec, &src_vec, dst_column, 
-                src_column, column_size);
+                src_column, flecs_table_column_align(dst_table, dst_column->ti),
+                flecs_table_column_align(src_table, src_column->ti),
+                column_size);
             flecs_table_mark_table_dirty(world, dst_table, i_new + 1);
             i_new ++;
             i_old ++;
         } else if (dst_id < src_id) {
             /* New column, make sure vector is large enough. */
-            ecs_vec_set_size(NULL, &dst_vec, dst_elem_size, column_size);
+            flecs_table_column_set_size(&dst_vec, dst_elem_size, 
+                flecs_table_column_align(dst_table, dst_column->ti),
+                column_size);
             dst_column->data = dst_vec.array;
             flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
             i_new ++;
         } else if (dst_id > src_id) {
             /* Old column does not occur in new table, destruct */
             flecs_table_invoke_dtor(src_column, 0, src_count);
-            ecs_vec_fini(NULL, &src_vec, src_elem_size);
+            flecs_table_column_fini(&src_vec, src_elem_size, 
+                flecs_table_column_align(src_table, src_column->ti));
             src_column->data = NULL;
             i_old ++;
         }
@@ -45528,7 +51019,8 @@ void flecs_table_merge_data(
         int32_t elem_size = column->ti->size;
         ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
         ecs_vec_t vec = ecs_vec_from_column(column, dst_table, elem_size);
-        ecs_vec_set_size(NULL, &vec, elem_size, column_size);
+        flecs_table_column_set_size(&vec, elem_size, 
+            flecs_table_column_align(dst_table, column->ti), column_size);
         column->data = vec.array;
         flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
     }
@@ -45540,7 +51032,8 @@ void flecs_table_merge_data(
         ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
         flecs_table_invoke_dtor(column, 0, src_count);
         ecs_vec_t vec = ecs_vec_from_column(column, src_table, elem_size);
-        ecs_vec_fini(NULL, &vec, elem_size);
+        flecs_table_column_fini(&vec, elem_size, 
+            flecs_table_column_align(src_table, column->ti));
         column->data = vec.array;
     }    
 
@@ -45590,6 +51083,14 @@ void flecs_table_merge(
     /* Merge table columns */
     flecs_table_merge_data(world, dst_table, src_table, dst_count, src_count);
 
+    if (dst_table->flags & EcsTableHasDenseToggle) {
+        for (i = 0; i < src_count; i ++) {
+            flecs_table_dense_toggle_sync(world, dst_table, dst_count + i);
+        }
+    }
+
+    src_table->_->dense_toggle_count = 0;
+
     if (src_count) {
         flecs_table_traversable_add(dst_table, src_table->_->traversable_count);
         flecs_table_traversable_add(src_table, -src_table->_->traversable_count);
@@ -46009,6 +51510,28 @@ error:
     return 0;
 }
 
+int32_t ecs_table_get_column_alignment(
+    const ecs_table_t *table,
+    int32_t column)
+{
+    ecs_check(table != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(column < table->column_count, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(table->column_map != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    const ecs_type_info_t *ti = table->data.columns[column].ti;
+    int32_t align = flecs_table_column_align(table, ti);
+    if (!align) {
+        align = table->_->column_alignment;
+        if (ti->alignment > align) {
+            align = ti->alignment;
+        }
+    }
+
+    return align;
+error:
+    return 0;
+}
+
 int32_t ecs_table_count(
     const ecs_table_t *table)
 {
@@ -46099,6 +51622,9 @@ void ecs_table_swap_rows(
     int32_t row_2)
 {
     flecs_table_swap(world, table, row_1, row_2);
+
+    /* Rows are no longer partitioned until the next toggle */
+    flecs_table_dense_toggle_invalidate(table);
 }
 
 void* ecs_record_get_by_column(
@@ -46920,6 +52446,144 @@ void flecs_table_diff_free(
     flecs_bfree(&world->allocators.table_diff, diff);
 }
 
+/* Kinds of transition cache elements */
+#define EcsGraphCacheAdd (1)
+#define EcsGraphCacheRemove (2)
+#define EcsGraphCacheAddMulti (3)
+
+static
+void flecs_graph_multi_edge_free(
+    ecs_world_t *world,
+    ecs_graph_multi_edge_t *multi)
+{
+    ecs_table_diff_t *diff = &multi->diff;
+    if (diff->added.count) {
+        flecs_wfree_n(world, ecs_id_t, diff->added.count, diff->added.array);
+    }
+    if (diff->removed.count) {
+        flecs_wfree_n(world, ecs_id_t, diff->removed.count, diff->removed.array);
+    }
+    flecs_wfree_n(world, ecs_id_t, multi->ids.count, multi->ids.array);
+    flecs_wfree_t(world, ecs_graph_multi_edge_t, multi);
+}
+
+static
+void flecs_graph_cache_elem_fini(
+    ecs_world_t *world,
+    ecs_graph_cache_elem_t *elem)
+{
+    if (elem->kind == EcsGraphCacheAddMulti) {
+        flecs_graph_multi_edge_free(world, elem->is.multi);
+    }
+    ecs_os_memset_t(elem, 0, ecs_graph_cache_elem_t);
+}
+
+static
+ecs_graph_cache_elem_t* flecs_graph_cache_set(
+    const ecs_graph_cache_t *cache,
+    uint64_t table,
+    uint64_t key,
+    int32_t kind)
+{
+    uint64_t h = (table * 0x9E3779B97F4A7C15) ^ key ^ (uint32_t)kind;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9;
+    h ^= h >> 29;
+    return &cache->elems[
+        (h & (FLECS_GRAPH_CACHE_SETS - 1)) * FLECS_GRAPH_CACHE_WAYS];
+}
+
+/* Find element in transition cache. Does not modify the cache. */
+static
+ecs_graph_cache_elem_t* flecs_graph_cache_get(
+    const ecs_graph_cache_t *cache,
+    uint64_t table,
+    uint64_t key,
+    int32_t kind)
+{
+    ecs_graph_cache_elem_t *set = flecs_graph_cache_set(
+        cache, table, key, kind);
+    int32_t i;
+    for (i = 0; i < FLECS_GRAPH_CACHE_WAYS; i ++) {
+        ecs_graph_cache_elem_t *elem = &set[i];
+        if (elem->key == key && elem->table == table && elem->kind == kind &&
+            elem->epoch == cache->epoch) 
+        {
+            return elem;
+        }
+    }
+    return NULL;
+}
+
+/* Insert element into the first way of a set. Existing elements move to the
+ * next way, the element in the last way is evicted. */
+static
+ecs_graph_cache_elem_t* flecs_graph_cache_insert(
+    ecs_world_t *world,
+    uint64_t table,
+    uint64_t key,
+    int32_t kind)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    ecs_graph_cache_elem_t *set = flecs_graph_cache_set(
+        cache, table, key, kind);
+
+    const int32_t last = FLECS_GRAPH_CACHE_WAYS - 1;
+    flecs_graph_cache_elem_fini(world, &set[last]);
+    ecs_os_memmove_n(&set[1], &set[0], ecs_graph_cache_elem_t, last);
+
+    ecs_graph_cache_elem_t *elem = &set[0];
+    elem->table = table;
+    elem->key = key;
+    elem->kind = kind;
+    elem->epoch = cache->epoch;
+    elem->is.edge = NULL;
+    return elem;
+}
+
+static
+void flecs_graph_cache_clear(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    int32_t i;
+    for (i = 0; i < FLECS_GRAPH_CACHE_SETS * FLECS_GRAPH_CACHE_WAYS; i ++) {
+        flecs_graph_cache_elem_fini(world, &cache->elems[i]);
+    }
+}
+
+/* Invalidate all elements in the transition cache. This happens when an edge
+ * is removed, or when flags are added to the diff of an edge. */
+static
+void flecs_graph_cache_invalidate(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    if (!(++ cache->epoch)) {
+        /* Don't match elements with an old epoch after wrapping around */
+        flecs_graph_cache_clear(world);
+    }
+}
+
+void flecs_graph_cache_init(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    cache->elems = flecs_wcalloc_n(world, ecs_graph_cache_elem_t, 
+        FLECS_GRAPH_CACHE_SETS * FLECS_GRAPH_CACHE_WAYS);
+    cache->epoch = 0;
+}
+
+void flecs_graph_cache_fini(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    flecs_graph_cache_clear(world);
+    flecs_wfree_n(world, ecs_graph_cache_elem_t, 
+        FLECS_GRAPH_CACHE_SETS * FLECS_GRAPH_CACHE_WAYS, cache->elems);
+    cache->elems = NULL;
+}
+
 static
 ecs_graph_edge_t* flecs_table_ensure_hi_edge(
     ecs_world_t *world,
@@ -46977,6 +52641,9 @@ void flecs_table_disconnect_edge(
     ecs_assert(edge->id == id, ECS_INTERNAL_ERROR, NULL);
     (void)id;
 
+    /* Edge may be stored in transition cache */
+    flecs_graph_cache_invalidate(world);
+
     /* Remove backref from destination table */
     ecs_graph_edge_hdr_t *next = edge->hdr.next;
     ecs_graph_edge_hdr_t *prev = edge->hdr.prev;
@@ -47461,6 +53128,46 @@ void flecs_add_with_property(
     }
 }
 
+/* Remove member columns added with (With, member) pairs together with a SoA
+ * component, as they store the data of the SoA component. Other (With, id)
+ * pairs of the component are not removed. */
+static
+void flecs_remove_soa_with_property(
+    ecs_world_t *world,
+    ecs_type_t *dst_type,
+    ecs_entity_t r)
+{
+    ecs_component_record_t *cr_with_wildcard = flecs_components_get(world,
+        ecs_pair(EcsWith, EcsWildcard));
+    if (!cr_with_wildcard) {
+        return;
+    }
+
+    ecs_table_t *table = ecs_get_table(world, r);
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_table_record_t *tr = flecs_component_get_table(
+        cr_with_wildcard, table);
+    if (tr) {
+        int32_t i = tr->index, end = i + tr->count;
+        ecs_id_t *ids = table->type.array;
+
+        for (; i < end; i ++) {
+            ecs_entity_t member = ecs_get_alive(world, 
+                ECS_PAIR_SECOND(ids[i]));
+            if (!member || !ecs_has_pair(world, member, EcsChildOf, r)) {
+                continue;
+            }
+#ifdef FLECS_META
+            if (!ecs_has(world, member, EcsMember)) {
+                continue;
+            }
+#endif
+            flecs_type_remove(world, dst_type, member);
+        }
+    }
+}
+
 static
 ecs_table_t* flecs_find_table_with(
     ecs_world_t *world,
@@ -47579,6 +53286,8 @@ ecs_table_t* flecs_find_table_without(
     if (without == ecs_id(EcsParent)) {
         flecs_type_remove(world, &dst_type, 
             ecs_pair(EcsParentDepth, EcsWildcard));
+    } else if (cr && (cr->flags & EcsIdSoA) && !ECS_IS_PAIR(without)) {
+        flecs_remove_soa_with_property(world, &dst_type, without);
     }
 
     return flecs_table_ensure(world, &dst_type, true, node);
@@ -47688,6 +53397,34 @@ ecs_table_t* flecs_create_edge_for_add(
     return to;
 }
 
+/* Get edge for id. Edges for ids that don't use the low edge array are looked
+ * up in the transition cache before the edge map of the table. */
+static
+ecs_graph_edge_t* flecs_table_get_cached_edge(
+    ecs_world_t *world,
+    ecs_table_t *node,
+    ecs_graph_edges_t *edges,
+    ecs_id_t id,
+    int32_t kind)
+{
+    if (id < FLECS_HI_COMPONENT_ID) {
+        return flecs_table_ensure_edge(world, edges, id);
+    }
+
+    ecs_graph_cache_elem_t *elem = flecs_graph_cache_get(
+        &world->store.graph_cache, node->id, id, kind);
+    if (elem) {
+        ecs_assert(elem->is.edge->id == id, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(elem->is.edge->from == node, ECS_INTERNAL_ERROR, NULL);
+        return elem->is.edge;
+    }
+
+    ecs_graph_edge_t *edge = flecs_table_ensure_hi_edge(world, edges, id);
+    elem = flecs_graph_cache_insert(world, node->id, id, kind);
+    elem->is.edge = edge;
+    return edge;
+}
+
 ecs_table_t* flecs_table_traverse_remove(
     ecs_world_t *world,
     ecs_table_t *node,
@@ -47702,7 +53439,8 @@ ecs_table_t* flecs_table_traverse_remove(
     ecs_check(id_ptr[0] != 0, ECS_INVALID_PARAMETER, NULL);
 
     ecs_id_t id = id_ptr[0];
-    ecs_graph_edge_t *edge = flecs_table_ensure_edge(world, &node->node.remove, id);
+    ecs_graph_edge_t *edge = flecs_table_get_cached_edge(
+        world, node, &node->node.remove, id, EcsGraphCacheRemove);
     ecs_table_t *to = edge->to;
 
     if (!to) {
@@ -47741,7 +53479,8 @@ ecs_table_t* flecs_table_traverse_add(
     ecs_check(id_ptr[0] != 0, ECS_INVALID_PARAMETER, NULL);
 
     ecs_id_t id = id_ptr[0];
-    ecs_graph_edge_t *edge = flecs_table_ensure_edge(world, &node->node.add, id);
+    ecs_graph_edge_t *edge = flecs_table_get_cached_edge(
+        world, node, &node->node.add, id, EcsGraphCacheAdd);
     ecs_table_t *to = edge->to;
 
     if (!to) {
@@ -47797,6 +53536,9 @@ void flecs_table_edges_add_flags(
     ecs_graph_node_t *table_node = &table->node;
     ecs_graph_edge_hdr_t *node_refs = &table_node->refs;
 
+    /* Multi edges in the transition cache contain a copy of the flags */
+    flecs_graph_cache_invalidate(world);
+
     /* Add flags to incoming matching add edges */
     if (flags == EcsTableHasOnAdd) {
         ecs_graph_edge_hdr_t *next, *cur = node_refs->next;
@@ -47964,6 +53706,123 @@ error:
     return NULL;
 }
 
+static
+bool flecs_graph_multi_edge_match(
+    const ecs_graph_multi_edge_t *multi,
+    const ecs_id_t *ids,
+    int32_t count)
+{
+    if (multi->ids.count != count) {
+        return false;
+    }
+    return !ecs_os_memcmp(
+        multi->ids.array, ids, count * ECS_SIZEOF(ecs_id_t));
+}
+
+static
+ecs_id_t* flecs_graph_ids_copy(
+    ecs_world_t *world,
+    const ecs_id_t *ids,
+    int32_t count)
+{
+    if (!count) {
+        return NULL;
+    }
+    ecs_id_t *result = flecs_walloc_n(world, ecs_id_t, count);
+    ecs_os_memcpy_n(result, ids, ecs_id_t, count);
+    return result;
+}
+
+ecs_table_t* flecs_find_table_add_ids(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    const ecs_id_t *ids,
+    int32_t count,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (count < 2) {
+        if (count) {
+            table = flecs_find_table_add(world, table, ids[0], diff);
+        }
+        return table;
+    }
+
+    uint64_t key = flecs_hash(ids, count * ECS_SIZEOF(ecs_id_t));
+    ecs_graph_cache_elem_t *elem = flecs_graph_cache_get(
+        &world->store.graph_cache, table->id, key, EcsGraphCacheAddMulti);
+    if (elem && flecs_graph_multi_edge_match(elem->is.multi, ids, count)) {
+        ecs_graph_multi_edge_t *multi = elem->is.multi;
+        flecs_table_diff_build_append_table(world, diff, &multi->diff);
+        return multi->to;
+    }
+
+    /* Traverse edges for individual ids */
+    ecs_table_diff_builder_t multi_diff = ECS_TABLE_DIFF_INIT;
+    flecs_table_diff_builder_init(world, &multi_diff);
+
+    uint64_t table_id = table->id;
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        table = flecs_find_table_add(world, table, ids[i], &multi_diff);
+        ecs_check(table != NULL, ECS_INVALID_PARAMETER, NULL);
+    }
+
+    ecs_table_diff_t td;
+    flecs_table_diff_build_noalloc(&multi_diff, &td);
+    flecs_table_diff_build_append_table(world, diff, &td);
+
+    ecs_graph_multi_edge_t *multi = flecs_walloc_t(
+        world, ecs_graph_multi_edge_t);
+    multi->to = table;
+    multi->diff = td;
+    multi->diff.added.array = flecs_graph_ids_copy(
+        world, td.added.array, td.added.count);
+    multi->diff.removed.array = flecs_graph_ids_copy(
+        world, td.removed.array, td.removed.count);
+    multi->ids.array = flecs_graph_ids_copy(world, ids, count);
+    multi->ids.count = count;
+
+    elem = flecs_graph_cache_insert(
+        world, table_id, key, EcsGraphCacheAddMulti);
+    elem->is.multi = multi;
+
+    flecs_table_diff_builder_fini(world, &multi_diff);
+    return table;
+error:
+    flecs_table_diff_builder_fini(world, &multi_diff);
+    return NULL;
+}
+
+const ecs_graph_edge_t* flecs_table_find_add_edge(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    ecs_id_t id)
+{
+    const ecs_graph_edges_t *edges = &table->node.add;
+    const ecs_graph_edge_t *edge = NULL;
+
+    if (id < FLECS_HI_COMPONENT_ID) {
+        if (edges->lo) {
+            edge = &edges->lo[id];
+        }
+    } else {
+        const ecs_graph_cache_elem_t *elem = flecs_graph_cache_get(
+            &world->store.graph_cache, table->id, id, EcsGraphCacheAdd);
+        if (elem) {
+            edge = elem->is.edge;
+        } else if (edges->hi) {
+            edge = ecs_map_get_deref(edges->hi, ecs_graph_edge_t, id);
+        }
+    }
+
+    if (edge && !edge->to) {
+        return NULL;
+    }
+
+    return edge;
+}
+
 /* Public convenience functions for traversing table graph */
 ecs_table_t* ecs_table_add_id(
     ecs_world_t *world,
@@ -64465,6 +70324,10 @@ void ecs_set_os_api_impl(void) {
 #include "pthread.h"
 #include <dlfcn.h>
 
+#if defined(__linux__) && defined(FLECS_HUGE_PAGES)
+#include <sys/mman.h>
+#endif
+
 #if defined(__APPLE__) && defined(__MACH__)
 #include <mach/mach_time.h>
 #elif defined(__EMSCRIPTEN__)
@@ -64778,6 +70641,56 @@ void posix_dlclose(ecs_os_dl_t lib) {
     dlclose((void*)(uintptr_t)lib);
 }
 
+#if defined(__linux__) && defined(FLECS_HUGE_PAGES)
+static
+void* posix_page_alloc(ecs_size_t size) {
+    size_t len = (size_t)size;
+    void *result;
+
+#ifdef MAP_HUGETLB
+    /* Use explicit huge pages if the system has reserved them */
+    if (!(len % FLECS_HUGE_PAGE_SIZE)) {
+        result = mmap(NULL, len, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (result != MAP_FAILED) {
+            return result;
+        }
+    }
+#endif
+
+    /* Transparent huge pages require memory that is aligned to the huge page
+     * size, so map more than requested and unmap the unaligned part. */
+    size_t align = (size_t)FLECS_HUGE_PAGE_SIZE;
+    void *ptr = mmap(NULL, len + align, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+    if (aligned != start) {
+        munmap(ptr, aligned - start);
+    }
+
+    size_t tail = (start + len + align) - (aligned + len);
+    if (tail) {
+        munmap((void*)(aligned + len), tail);
+    }
+
+    result = (void*)aligned;
+#ifdef MADV_HUGEPAGE
+    madvise(result, len, MADV_HUGEPAGE);
+#endif
+    return result;
+}
+
+static
+void posix_page_free(void *ptr, ecs_size_t size) {
+    munmap(ptr, (size_t)size);
+}
+#endif
+
 void ecs_set_os_api_impl(void) {
     ecs_os_set_api_defaults();
 
@@ -64806,6 +70719,10 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = posix_dlopen;
     api.dlproc_ = posix_dlproc;
     api.dlclose_ = posix_dlclose;
+#if defined(__linux__) && defined(FLECS_HUGE_PAGES)
+    api.page_alloc_ = posix_page_alloc;
+    api.page_free_ = posix_page_free;
+#endif
 
     posix_time_setup();
 
@@ -65916,6 +71833,10 @@ void ecs_frame_end(
         flecs_stage_merge_post_frame(world, world->stages[i]);
     }
 
+    if (world->compact.enabled) {
+        ecs_compact(world, &world->compact.desc);
+    }
+
     flecs_stop_measure_frame(world);
 
     /* Reset command handler each frame */
@@ -65942,6 +71863,7 @@ static void flecs_pipeline_state_free(
         ecs_allocator_t *a = &world->allocator;
         ecs_vec_fini_t(a, &p->ops, ecs_pipeline_op_t);
         ecs_vec_fini_t(a, &p->systems, ecs_system_t*);
+        ecs_vec_fini_t(a, &p->barriers, bool);
         ecs_os_free(p);
     }
 }
@@ -66173,6 +72095,101 @@ bool flecs_pipeline_check_terms(
     return needs_merge;
 }
 
+/* Component access of a system that runs in a multithreaded operation. Used to
+ * determine whether systems in the same operation can run at the same time. */
+typedef struct ecs_pipeline_access_t {
+    ecs_id_t id;
+    bool write;
+    bool dynamic;               /* Whether system uses dynamic scheduling */
+} ecs_pipeline_access_t;
+
+static
+bool flecs_pipeline_system_is_dynamic(
+    const ecs_system_t *sys)
+{
+    return sys->multi_threaded && sys->chunk_size;
+}
+
+static
+bool flecs_pipeline_access_conflicts(
+    const ecs_pipeline_access_t *a,
+    const ecs_pipeline_access_t *b)
+{
+    if (!a->write && !b->write) {
+        return false;
+    }
+
+    return a->id == b->id || ecs_id_match(a->id, b->id) || 
+        ecs_id_match(b->id, a->id);
+}
+
+/* Test if a system conflicts with systems that may still be running on other
+ * threads. Systems that both use static scheduling never conflict, as they
+ * process the same entities on the same thread. */
+static
+bool flecs_pipeline_check_access(
+    ecs_allocator_t *a,
+    ecs_vec_t *running,
+    ecs_system_t *sys)
+{
+    bool dynamic = flecs_pipeline_system_is_dynamic(sys);
+    bool conflict = false;
+    int32_t added = ecs_vec_count(running);
+
+    ecs_query_t *q = sys->query;
+    int32_t t, term_count = q->term_count;
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &q->terms[t];
+        int16_t inout = term->inout;
+        if (inout == EcsInOutFilter || inout == EcsInOutNone) {
+            continue;
+        }
+
+        if (inout == EcsInOutDefault) {
+            if (ecs_term_match_0(term)) {
+                continue;
+            } else if (!ecs_term_match_this(term) || 
+                !(term->src.id & EcsSelf)) 
+            {
+                inout = EcsIn;
+            } else {
+                inout = EcsInOut;
+            }
+        }
+
+        ecs_pipeline_access_t access = {
+            .id = term->id,
+            .write = inout != EcsIn,
+            .dynamic = dynamic
+        };
+
+        int32_t i;
+        ecs_pipeline_access_t *cur = ecs_vec_first(running);
+        for (i = 0; i < added; i ++) {
+            if (!dynamic && !cur[i].dynamic) {
+                continue;
+            }
+            if (flecs_pipeline_access_conflicts(&access, &cur[i])) {
+                conflict = true;
+                break;
+            }
+        }
+
+        ecs_vec_append_t(a, running, ecs_pipeline_access_t)[0] = access;
+    }
+
+    if (conflict) {
+        /* Threads are synchronized before system runs, so only the access of
+         * this system remains relevant for subsequent systems. */
+        int32_t count = ecs_vec_count(running) - added;
+        ecs_pipeline_access_t *cur = ecs_vec_first(running);
+        ecs_os_memmove_n(cur, &cur[added], ecs_pipeline_access_t, count);
+        ecs_vec_set_count_t(a, running, ecs_pipeline_access_t, count);
+    }
+
+    return conflict;
+}
+
 static
 EcsPoly* flecs_pipeline_term_system(
     ecs_iter_t *it)
@@ -66210,6 +72227,11 @@ bool flecs_pipeline_build(
 
     ecs_vec_reset_t(a, &pq->ops, ecs_pipeline_op_t);
     ecs_vec_reset_t(a, &pq->systems, ecs_system_t*);
+    ecs_vec_reset_t(a, &pq->barriers, bool);
+
+    /* Access of systems in current operation since the last barrier */
+    ecs_vec_t running;
+    ecs_vec_init_t(a, &running, ecs_pipeline_access_t, 0);
 
     bool multi_threaded = false;
     bool immediate = false;
@@ -66280,6 +72302,7 @@ bool flecs_pipeline_build(
             }
 
             if (!op) {
+                ecs_vec_clear(&running);
                 op = ecs_vec_append_t(a, &pq->ops, ecs_pipeline_op_t);
                 op->offset = ecs_vec_count(&pq->systems);
                 op->count = 0;
@@ -66287,6 +72310,7 @@ bool flecs_pipeline_build(
                 op->immediate = false;
                 op->time_spent = 0;
                 op->commands_enqueued = 0;
+                op->wait_time = 0;
             }
 
             /* Don't increase count for inactive systems, as they are ignored by
@@ -66297,6 +72321,17 @@ bool flecs_pipeline_build(
                     op->multi_threaded = multi_threaded;
                     op->immediate = immediate;
                 }
+
+                /* Threads don't sync between systems in the same operation. If
+                 * a system conflicts with a system that could still be running
+                 * on another thread, insert a barrier. */
+                bool barrier = false;
+                if (op->multi_threaded) {
+                    barrier = flecs_pipeline_check_access(a, &running, sys);
+                }
+                ecs_vec_append_t(a, &pq->barriers, bool)[0] = 
+                    barrier && op->count;
+
                 op->count ++;
             }
         }
@@ -66308,6 +72343,7 @@ bool flecs_pipeline_build(
 
     ecs_map_fini(&ws.ids);
     ecs_map_fini(&ws.wildcard_ids);
+    ecs_vec_fini_t(a, &running, ecs_pipeline_access_t);
 
     op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
 
@@ -66326,9 +72362,14 @@ bool flecs_pipeline_build(
         int32_t i, count = ecs_vec_count(&pq->systems);
         int32_t op_index = 0, ran_since_merge = 0;
         ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+        bool *barriers = ecs_vec_first_t(&pq->barriers, bool);
         for (i = 0; i < count; i ++) {
             ecs_system_t *sys = systems[i];
             ecs_entity_t system = sys->query->entity;
+
+            if (barriers[i]) {
+                ecs_dbg("#[magenta]barrier#[reset]");
+            }
             ecs_assert(system != 0, ECS_INTERNAL_ERROR, NULL);
             (void)system;
 
@@ -66466,6 +72507,26 @@ void ecs_run_pipeline(
     }
 }
 
+/* Move values of commands enqueued by all threads into component storage, 
+ * before the main thread merges the remaining commands. Each thread first 
+ * partitions the commands of its own stage by entity, after which each thread 
+ * merges a single partition from all stages. */
+static
+void flecs_pipeline_merge_partition(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t stage_index,
+    int32_t stage_count)
+{
+    /* Wait until all threads are done enqueueing commands */
+    flecs_worker_barrier(world);
+    flecs_commands_partition(world, stage, stage_count);
+
+    /* Wait until all queues are partitioned */
+    flecs_worker_barrier(world);
+    flecs_commands_merge_partition(world, stage_index);
+}
+
 int32_t flecs_run_pipeline_ops(
     ecs_world_t* world,
     ecs_stage_t* stage,
@@ -66481,11 +72542,20 @@ int32_t flecs_run_pipeline_ops(
 
     int32_t count = ecs_vec_count(&pq->systems);
     ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    bool *barriers = ecs_vec_first_t(&pq->barriers, bool);
+    bool multi_threaded = world->flags & EcsWorldMultiThreaded;
     int32_t ran_since_merge = i - op->offset;
+    int32_t first = i;
 
     for (; i < count; i++) {
         ecs_system_t* sys = systems[i];
 
+        /* Wait for other threads if system conflicts with a system that could
+         * still be running on another thread. */
+        if (multi_threaded && barriers[i] && i != first) {
+            flecs_worker_barrier(world);
+        }
+
         /* Keep track of the last frame for which the system has run, so we
          * know from where to resume the schedule in case the schedule
          * changes during a merge. */
@@ -66500,8 +72570,15 @@ int32_t flecs_run_pipeline_ops(
             s = stage;
         }
 
+        /* If the system distributes its entities in chunks, workers claim
+         * chunks from a counter that was reset before the workers started */
+        int32_t *chunk_cursor = NULL;
+        if (sys->chunk_size && (world->flags & EcsWorldMultiThreaded)) {
+            chunk_cursor = &sys->chunk_cursor;
+        }
+
         flecs_run_system(world, s, sys->query->entity, sys, stage_index,
-            stage_count, delta_time, NULL);
+            stage_count, chunk_cursor, delta_time, NULL);
 
         ecs_os_linc(&world->info.systems_ran_total);
         ran_since_merge++;
@@ -66512,9 +72589,29 @@ int32_t flecs_run_pipeline_ops(
         }
     }
 
+    if (multi_threaded && !op->immediate && 
+        (world->flags & EcsWorldParallelMerge)) 
+    {
+        flecs_pipeline_merge_partition(world, stage, stage_index, stage_count);
+    }
+
     return i;
 }
 
+/* Reset chunk counters of systems in the current operation. Must be called
+ * before workers are signaled, as workers claim chunks from the counters. */
+static
+void flecs_pipeline_reset_chunks(
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, end = op->offset + op->count;
+    for (i = pq->cur_i; i < end; i ++) {
+        systems[i]->chunk_cursor = 0;
+    }
+}
+
 void flecs_run_pipeline(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -66562,6 +72659,7 @@ void flecs_run_pipeline(
         ecs_assert(world->workers_waiting == 0, ECS_INTERNAL_ERROR, NULL);
 
         if (op_multi_threaded) {
+            flecs_pipeline_reset_chunks(pq);
             flecs_signal_workers(world);
         }
 
@@ -66580,7 +72678,16 @@ void flecs_run_pipeline(
         }
 
         if (op_multi_threaded) {
+            ecs_time_t wt = { 0 };
+            if (measure_time) {
+                ecs_time_measure(&wt);
+            }
+
             flecs_wait_for_sync(world);
+
+            if (measure_time) {
+                pq->cur_op->wait_time += ecs_time_measure(&wt);
+            }
         }
 
         if (!immediate) {
@@ -66593,6 +72700,8 @@ void flecs_run_pipeline(
             for (si = 0; si < stage_count; si ++) {
                 ecs_stage_t *s = world->stages[si];
                 pq->cur_op->commands_enqueued += ecs_vec_count(&s->cmd->queue);
+                world->info.cmd.parallel_merged_count += s->cmd_merged_count;
+                s->cmd_merged_count = 0;
             }
 
             ecs_readonly_end(world);
@@ -66947,6 +73056,66 @@ void FlecsPipelineImport(
 
 #ifdef FLECS_PIPELINE
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Read value that is concurrently modified by other threads with a relaxed
+ * atomic load. The value is only used as a hint to stop spinning, threads
+ * always check the actual condition while holding the sync mutex. */
+static
+int32_t flecs_worker_poll(
+    const int32_t *value)
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return (int32_t)__iso_volatile_load32((const volatile int*)value);
+#else
+    return *(const volatile int32_t*)value;
+#endif
+}
+
+/* Tell the CPU that the thread is in a spin loop, which reduces power usage
+ * and frees up resources for the other thread on the same core. */
+static
+void flecs_worker_pause(void) {
+#if (defined(__clang__) || defined(__GNUC__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__clang__) || defined(__GNUC__)) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __yield();
+#endif
+}
+
+/* Spin and then yield until (*value == expect) equals the provided condition,
+ * or until the spin and yield budget runs out. */
+static
+void flecs_worker_spin(
+    const ecs_world_t *world,
+    const int32_t *value,
+    int32_t expect,
+    bool equal)
+{
+    int32_t i, spin_count = world->worker_spin_count;
+    int32_t count = spin_count + world->worker_yield_count;
+    for (i = 0; i < count; i ++) {
+        if ((flecs_worker_poll(value) == expect) == equal) {
+            break;
+        }
+
+        if (i >= spin_count) {
+            ecs_os_sleep(0, 0);
+        } else {
+            flecs_worker_pause();
+        }
+    }
+}
+
 /* Synchronize workers */
 static
 void flecs_sync_worker(
@@ -66959,13 +73128,22 @@ void flecs_sync_worker(
 
     /* Signal that thread is waiting */
     ecs_os_mutex_lock(world->sync_mutex);
+    int32_t epoch = world->workers_epoch;
     if (++world->workers_waiting == (stage_count - 1)) {
         /* Only signal main thread when all threads are waiting */
         ecs_os_cond_signal(world->sync_cond);
     }
 
+    if (world->worker_spin_count || world->worker_yield_count) {
+        ecs_os_mutex_unlock(world->sync_mutex);
+        flecs_worker_spin(world, &world->workers_epoch, epoch, false);
+        ecs_os_mutex_lock(world->sync_mutex);
+    }
+
     /* Wait until main thread signals that thread can continue */
-    ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+    while (epoch == world->workers_epoch) {
+        ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+    }
     ecs_os_mutex_unlock(world->sync_mutex);
 }
 
@@ -66995,8 +73173,13 @@ void* flecs_worker(void *arg) {
         ecs_entity_t old_scope = ecs_set_scope((ecs_world_t*)stage, 0);
 
         ecs_dbg_3("worker %d: run", stage->id);
-        flecs_run_pipeline_ops(world, stage, stage->id, world->stage_count, 
-            world->info.delta_time);
+        flecs_worker_job_t job = world->worker_job;
+        if (job) {
+            job(world, stage->id, world->stage_count, world->worker_job_ctx);
+        } else {
+            flecs_run_pipeline_ops(world, stage, stage->id, 
+                world->stage_count, world->info.delta_time);
+        }
 
         ecs_set_scope((ecs_world_t*)stage, old_scope);
 
@@ -67087,8 +73270,10 @@ void flecs_wait_for_sync(
 
     ecs_dbg_3("#[bold]pipeline: waiting for worker sync");
 
+    flecs_worker_spin(world, &world->workers_waiting, stage_count - 1, true);
+
     ecs_os_mutex_lock(world->sync_mutex);
-    if (world->workers_waiting != (stage_count - 1)) {
+    while (world->workers_waiting != (stage_count - 1)) {
         ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
     }
 
@@ -67102,6 +73287,38 @@ void flecs_wait_for_sync(
     ecs_dbg_3("#[bold]pipeline: workers synced");
 }
 
+/* Wait until all threads (main thread and workers) reach the barrier. Used to
+ * order systems within a pipeline operation that have conflicting access. */
+void flecs_worker_barrier(
+    ecs_world_t *world)
+{
+    int32_t stage_count = ecs_get_stage_count(world);
+    if (stage_count <= 1) {
+        return;
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    int32_t generation = world->barrier_generation;
+    if (++world->barrier_waiting == stage_count) {
+        /* Last thread to arrive releases the others */
+        world->barrier_waiting = 0;
+        world->barrier_generation ++;
+        ecs_os_cond_broadcast(world->barrier_cond);
+    } else {
+        if (world->worker_spin_count || world->worker_yield_count) {
+            ecs_os_mutex_unlock(world->sync_mutex);
+            flecs_worker_spin(world, &world->barrier_generation, 
+                generation, false);
+            ecs_os_mutex_lock(world->sync_mutex);
+        }
+
+        while (generation == world->barrier_generation) {
+            ecs_os_cond_wait(world->barrier_cond, world->sync_mutex);
+        }
+    }
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
 /* Signal workers that they can start/resume work */
 void flecs_signal_workers(
     ecs_world_t *world)
@@ -67113,6 +73330,7 @@ void flecs_signal_workers(
 
     ecs_dbg_3("#[bold]pipeline: signal workers");
     ecs_os_mutex_lock(world->sync_mutex);
+    world->workers_epoch ++;
     ecs_os_cond_broadcast(world->worker_cond);
     ecs_os_mutex_unlock(world->sync_mutex);
 }
@@ -67161,7 +73379,70 @@ void flecs_join_worker_threads(
     ecs_assert(world->workers_running == 0, ECS_INTERNAL_ERROR, NULL);
 }
 
+/* Test if world has worker threads that can run a job */
+static
+bool flecs_workers_idle(
+    ecs_world_t *world)
+{
+    /* Task threads only exist while a pipeline is running */
+    return ecs_get_stage_count(world) > 1 && world->worker_cond && 
+        !ecs_using_task_threads(world) && !(world->flags & EcsWorldReadonly);
+}
+
 /* -- Private functions -- */
+bool flecs_workers_run(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    int32_t stage_count = ecs_get_stage_count(world);
+
+    if (!flecs_workers_idle(world)) {
+        return false;
+    }
+
+    /* Make sure workers are running and ready */
+    flecs_wait_for_workers(world);
+
+    world->worker_job = job;
+    world->worker_job_ctx = ctx;
+    flecs_signal_workers(world);
+
+    job(world, 0, stage_count, ctx);
+
+    flecs_wait_for_sync(world);
+    world->worker_job = NULL;
+    world->worker_job_ctx = NULL;
+
+    return true;
+}
+
+bool flecs_workers_run_deferred(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx)
+{
+    flecs_poly_assert(world, ecs_world_t);
+
+    if (!flecs_workers_idle(world)) {
+        return false;
+    }
+
+    /* Stages can't be merged into a deferred world, so suspend deferring of
+     * the world while the job is running. */
+    ecs_suspend_readonly_state_t srs;
+    flecs_suspend_readonly(world, &srs);
+
+    flecs_stage_job_begin(world);
+    flecs_workers_run(world, job, ctx);
+    flecs_stage_job_end(world);
+
+    flecs_resume_readonly(world, &srs);
+
+    return true;
+}
+
 void flecs_workers_progress(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -67207,6 +73488,9 @@ void flecs_set_threads_internal(
             if (world->sync_cond) {
                 ecs_os_cond_free(world->sync_cond);
             }
+            if (world->barrier_cond) {
+                ecs_os_cond_free(world->barrier_cond);
+            }
             if (world->sync_mutex) {
                 ecs_os_mutex_free(world->sync_mutex);
             }
@@ -67218,6 +73502,7 @@ void flecs_set_threads_internal(
         if (threads > 1) {
             world->worker_cond = ecs_os_cond_new();
             world->sync_cond = ecs_os_cond_new();
+            world->barrier_cond = ecs_os_cond_new();
             world->sync_mutex = ecs_os_mutex_new();
             flecs_start_workers(world, threads);
         }
@@ -67246,6 +73531,36 @@ bool ecs_using_task_threads(
     return world->workers_use_task_api;
 }
 
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot change parallel merge while running a pipeline");
+    ECS_BIT_COND(world->flags, EcsWorldParallelMerge, enable);
+error:
+    return;
+}
+
+void ecs_set_worker_spin(
+    ecs_world_t *world,
+    int32_t spin_count,
+    int32_t yield_count)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(spin_count >= 0, ECS_INVALID_PARAMETER, 
+        "spin count cannot be negative");
+    ecs_check(yield_count >= 0, ECS_INVALID_PARAMETER, 
+        "yield count cannot be negative");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot change worker spin while running a pipeline");
+    world->worker_spin_count = spin_count;
+    world->worker_yield_count = yield_count;
+error:
+    return;
+}
+
 #endif
 
 #ifndef FLECS_PARSER_GRAMMAR_H
@@ -78800,7 +85115,8 @@ void ecs_component_record_memory_get(
         
         const ecs_reachable_cache_t *reachable = &pair->reachable;
         result->bytes_reachable_cache += 
-            ecs_vec_size(&reachable->ids) * ECS_SIZEOF(ecs_reachable_elem_t);
+            ecs_vec_size(&reachable->ids) * ECS_SIZEOF(ecs_reachable_elem_t) +
+            ecs_vec_size(&reachable->up) * ECS_SIZEOF(ecs_reachable_up_t);
     }
 }
 
@@ -80809,6 +87125,7 @@ void ecs_world_stats_get(
     ECS_COUNTER_RECORD(&s->memory.stack_alloc_count, t, ecs_stack_allocator_alloc_count);
     ECS_COUNTER_RECORD(&s->memory.stack_free_count, t, ecs_stack_allocator_free_count);
     ECS_GAUGE_RECORD(&s->memory.stack_outstanding_alloc_count, t, outstanding_allocs);
+    ECS_COUNTER_RECORD(&s->memory.compact_reclaimed_bytes, t, world->info.compact_reclaimed_total);
 
 #ifdef FLECS_HTTP
     ECS_COUNTER_RECORD(&s->http.request_received_count, t, ecs_http_request_received_count);
@@ -81079,6 +87396,7 @@ bool ecs_pipeline_stats_get(
                 ECS_COUNTER_RECORD(&el->time_spent, s->t, cur->time_spent);
                 ECS_COUNTER_RECORD(&el->commands_enqueued, s->t, 
                     cur->commands_enqueued);
+                ECS_COUNTER_RECORD(&el->wait_time, s->t, cur->wait_time);
 
                 el->system_count = cur->count;
                 el->multi_threaded = cur->multi_threaded;
@@ -81662,6 +87980,7 @@ ecs_entity_t flecs_run_system(
     ecs_system_t *system_data,
     int32_t stage_index,
     int32_t stage_count,    
+    int32_t *chunk_cursor,
     ecs_ftime_t delta_time,
     void *param) 
 {
@@ -81734,7 +88053,12 @@ ecs_entity_t flecs_run_system(
     }
 
     if (stage_count > 1 && system_data->multi_threaded) {
-        wit = ecs_worker_iter(it, stage_index, stage_count);
+        if (chunk_cursor) {
+            wit = ecs_dynamic_worker_iter(
+                it, chunk_cursor, system_data->chunk_size);
+        } else {
+            wit = ecs_worker_iter(it, stage_index, stage_count);
+        }
         it = &wit;
     }
 
@@ -81806,7 +88130,7 @@ ecs_entity_t ecs_run_worker(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
-        world, stage, system, system_data, stage_index, stage_count, 
+        world, stage, system, system_data, stage_index, stage_count, NULL,
         delta_time, param);
     flecs_defer_end(world, stage);
     return result;
@@ -81823,7 +88147,7 @@ ecs_entity_t ecs_run(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
-        world, stage, system, system_data, 0, 0, delta_time, param);
+        world, stage, system, system_data, 0, 0, NULL, delta_time, param);
     flecs_defer_end(world, stage);
     return result;
 }
@@ -81914,6 +88238,9 @@ ecs_entity_t ecs_system_init(
         "entity %s already is a system, use ecs_system_update() to modify",
             flecs_errstr(ecs_get_path(world, entity)));
 
+    ecs_check(desc->chunk_size >= 0, ECS_INVALID_PARAMETER,
+        "invalid chunk_size %d", desc->chunk_size);
+
     ecs_check(desc->callback != NULL || desc->run != NULL,
         ECS_INVALID_PARAMETER,
         "missing implementation for system %s (set .callback or .run)",
@@ -81960,6 +88287,7 @@ ecs_entity_t ecs_system_init(
     system->tick_source = desc->tick_source;
 
     system->multi_threaded = desc->multi_threaded;
+    system->chunk_size = desc->chunk_size;
     system->immediate = desc->immediate;
 
     system->name = ecs_get_path(world, entity);
@@ -82070,6 +88398,10 @@ ecs_entity_t ecs_system_update(
         system->multi_threaded = desc->multi_threaded;
     }
 
+    if (desc->chunk_size) {
+        system->chunk_size = desc->chunk_size;
+    }
+
     if (desc->immediate) {
         system->immediate = desc->immediate;
     }
@@ -84678,6 +91010,46 @@ done:
 
 ECS_SORT_TABLE_WITH_COMPARE(_, flecs_query_cache_sort_table_generic, order_by, static)
 
+/* Maximum number of out of order rows for which a table is sorted with 
+ * insertion sort instead of quicksort. */
+#define FLECS_QUERY_SORT_INSERTION_MAX(count) (((count) >> 4) + 1)
+
+/* Sort a table that was sorted before with insertion sort. When only a few
+ * rows changed since the last time the table was sorted, this is much cheaper
+ * than sorting the entire table, as only the rows that are out of order are
+ * moved. The number of swaps is capped by the number of rows in the table, so
+ * that a table in which many rows changed falls back to a regular sort. 
+ * Returns false if the table is not sorted when the budget is exhausted. */
+static
+bool flecs_query_cache_insertion_sort_table(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_entity_t *entities,
+    void *ptr,
+    int32_t size,
+    int32_t count,
+    ecs_order_by_action_t compare)
+{
+    int32_t i, budget = count;
+
+    for (i = 1; i < count; i ++) {
+        int32_t j = i;
+        while (j && compare(entities[j - 1], ECS_ELEM(ptr, size, j - 1), 
+            entities[j], ECS_ELEM(ptr, size, j)) > 0) 
+        {
+            if (!budget) {
+                return false;
+            }
+
+            ecs_table_swap_rows(world, table, j - 1, j);
+            budget --;
+            j --;
+        }
+    }
+
+    return true;
+}
+
 static
 void flecs_query_cache_sort_table(
     ecs_world_t *world,
@@ -84706,6 +91078,32 @@ void flecs_query_cache_sort_table(
         ptr = column->data;
     }
 
+    /* Count rows that are out of order. Tables are re-sorted when any of
+     * their rows changed, which is often a small fraction of the table. */
+    int32_t i, unsorted = 0;
+    bool has_equal = false;
+    for (i = 1; i < count; i ++) {
+        int cmp = compare(entities[i - 1], ECS_ELEM(ptr, size, i - 1), 
+            entities[i], ECS_ELEM(ptr, size, i));
+        unsorted += cmp > 0;
+        has_equal |= cmp == 0;
+    }
+
+    /* Quicksort is not stable, and can reorder rows with equal values even if
+     * the table is already sorted. Only take the shortcuts if rows have 
+     * distinct values, so that the result is the same as with quicksort. */
+    if (!has_equal && !unsorted) {
+        return;
+    }
+
+    if (!has_equal && unsorted <= FLECS_QUERY_SORT_INSERTION_MAX(count)) {
+        if (flecs_query_cache_insertion_sort_table(
+            world, table, entities, ptr, size, count, compare))
+        {
+            return;
+        }
+    }
+
     if (sort) {
         sort(world, table, entities, ptr, size, 0, count - 1, compare);
     } else {
@@ -84750,6 +91148,57 @@ ecs_entity_t e_from_helper(
     }
 }
 
+/* Compare the current rows of two sort helpers. Rows that compare equal are
+ * ordered by helper index, so that entities with equal values are returned
+ * in the order of the tables in the cache. */
+static
+int flecs_query_cache_helper_compare(
+    sort_helper_t *helper,
+    int32_t h1,
+    int32_t h2,
+    ecs_order_by_action_t compare)
+{
+    int result = compare(
+        e_from_helper(&helper[h1]), ptr_from_helper(&helper[h1]),
+        e_from_helper(&helper[h2]), ptr_from_helper(&helper[h2]));
+    if (result) {
+        return result;
+    }
+
+    return (h1 > h2) - (h1 < h2);
+}
+
+static
+void flecs_query_cache_heap_sift_down(
+    sort_helper_t *helper,
+    int32_t *heap,
+    int32_t heap_count,
+    int32_t i,
+    ecs_order_by_action_t compare)
+{
+    for (;;) {
+        int32_t min = i, left = i * 2 + 1, right = left + 1;
+        if (left < heap_count && flecs_query_cache_helper_compare(
+            helper, heap[left], heap[min], compare) < 0) 
+        {
+            min = left;
+        }
+        if (right < heap_count && flecs_query_cache_helper_compare(
+            helper, heap[right], heap[min], compare) < 0) 
+        {
+            min = right;
+        }
+        if (min == i) {
+            break;
+        }
+
+        int32_t tmp = heap[i];
+        heap[i] = heap[min];
+        heap[min] = tmp;
+        i = min;
+    }
+}
+
 static
 void flecs_query_cache_build_sorted_table_range(
     ecs_query_cache_t *cache,
@@ -84832,54 +91281,51 @@ void flecs_query_cache_build_sorted_table_range(
         goto done;
     }
 
-    ecs_query_cache_match_t *cur = NULL;
-
-    bool proceed;
-    do {
-        int32_t j, min = 0;
-        proceed = true;
-
-        ecs_entity_t e1;
-        while (!(e1 = e_from_helper(&helper[min]))) {
-            min ++;
-            if (min == to_sort) {
-                proceed = false;
-                break;
-            }
-        }
+    /* Merge the sorted tables with a k-way merge. The heap contains the
+     * helpers that have rows left, with the helper that has the lowest row at
+     * the top. While the rows of the top helper remain lower than the rows of
+     * the other helpers, the heap doesn't change, which makes appending runs
+     * of rows from the same table cheap. */
+    int32_t *heap = flecs_alloc_n(&world->allocator, int32_t, to_sort);
+    int32_t heap_count = to_sort;
+    for (i = 0; i < to_sort; i ++) {
+        heap[i] = i;
+    }
 
-        if (!proceed) {
-            break;
-        }
+    for (i = heap_count / 2 - 1; i >= 0; i --) {
+        flecs_query_cache_heap_sift_down(helper, heap, heap_count, i, compare);
+    }
 
-        for (j = min + 1; j < to_sort; j++) {
-            ecs_entity_t e2 = e_from_helper(&helper[j]);
-            if (!e2) {
-                continue;
-            }
+    ecs_query_cache_match_t *cur = NULL;
 
-            const void *ptr1 = ptr_from_helper(&helper[min]);
-            const void *ptr2 = ptr_from_helper(&helper[j]);
+    while (heap_count) {
+        sort_helper_t *cur_helper = &helper[heap[0]];
 
-            if (compare(e1, ptr1, e2, ptr2) > 0) {
-                min = j;
-                e1 = e_from_helper(&helper[min]);
-            }
+        int32_t row_count = 1;
+        if (heap_count == 1) {
+            /* Last table with rows left, append remaining rows at once */
+            row_count = cur_helper->count - cur_helper->row;
         }
 
-        sort_helper_t *cur_helper = &helper[min];
         if (!cur || cur->base.columns != cur_helper->match->base.columns) {
             cur = ecs_vec_append_t(NULL, &cache->table_slices, 
                 ecs_query_cache_match_t);
             *cur = *(cur_helper->match);
             cur->_offset = cur_helper->row;
-            cur->_count = 1;
+            cur->_count = row_count;
         } else {
-            cur->_count ++;
+            cur->_count += row_count;
+        }
+
+        cur_helper->row += row_count;
+        if (cur_helper->row == cur_helper->count) {
+            heap[0] = heap[-- heap_count];
         }
 
-        cur_helper->row ++;
-    } while (proceed);
+        flecs_query_cache_heap_sift_down(helper, heap, heap_count, 0, compare);
+    }
+
+    flecs_free_n(&world->allocator, int32_t, to_sort, heap);
 
 done:
     flecs_free_n(&world->allocator, sort_helper_t, table_count, helper);
@@ -84990,6 +91436,224 @@ void flecs_query_cache_sort_tables(
     }
 }
 
+/* Minimum number of entities per thread for which results are split up across
+ * threads. Smaller results are assigned to a single thread. */
+#define FLECS_QUERY_PROPAGATE_SPLIT (64)
+
+typedef struct flecs_query_propagate_ctx_t {
+    ecs_world_t *world;             /* World or stage, if single threaded */
+    ecs_query_t *query;
+    const ecs_query_propagate_desc_t *desc;
+    uint64_t group_id;
+    const bool *selected;           /* Results selected for the group */
+    int32_t result_count;           /* Number of results in the group */
+} flecs_query_propagate_ctx_t;
+
+/* Test if the parent of a result was processed for a previous depth. This
+ * catches changes to parents for which the query doesn't keep a monitor, like
+ * parents of entities in non-fragmenting hierarchies. */
+static
+bool flecs_query_propagate_parent_written(
+    const ecs_iter_t *it,
+    const ecs_map_t *written)
+{
+    ecs_termset_t up_fields = it->up_fields;
+    if (!up_fields) {
+        return false;
+    }
+
+    int8_t i, field_count = it->field_count;
+    for (i = 0; i < field_count; i ++) {
+        if (!(up_fields & (1llu << i))) {
+            continue;
+        }
+
+        ecs_entity_t src = it->sources[i];
+        if (!src) {
+            continue;
+        }
+
+        ecs_record_t *r = flecs_entities_get(it->real_world, src);
+        if (r && r->table && ecs_map_get(written, r->table->id)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Select the results of a group that need to be processed. */
+static
+int32_t flecs_query_propagate_select(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    uint64_t group_id,
+    ecs_vec_t *selected,
+    ecs_map_t *written)
+{
+    ecs_allocator_t *a = &query->real_world->allocator;
+    bool detect_changes = query->flags & EcsQueryDetectChanges;
+    int32_t count = 0;
+
+    ecs_vec_clear(selected);
+
+    ecs_iter_t it = ecs_query_iter(world, query);
+    it.flags |= EcsIterMatchEmptyTables;
+    ecs_iter_set_group(&it, group_id);
+
+    while (ecs_query_next(&it)) {
+        bool select = it.count != 0;
+        if (select && detect_changes) {
+            select = ecs_iter_changed(&it) ||
+                flecs_query_propagate_parent_written(&it, written);
+        }
+
+        if (select) {
+            if (it.table) {
+                ecs_map_ensure(written, it.table->id);
+            }
+        } else {
+            ecs_iter_skip(&it);
+        }
+
+        ecs_vec_append_t(a, selected, bool)[0] = select;
+        count ++;
+    }
+
+    return count;
+}
+
+/* Invoke callback for the selected results of a group. */
+static
+void flecs_query_propagate_run(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    flecs_query_propagate_ctx_t *pctx = ctx;
+    const ecs_query_propagate_desc_t *desc = pctx->desc;
+    ecs_world_t *stage = pctx->world;
+    if (!stage) {
+        stage = ecs_get_stage(world, stage_index);
+    }
+
+    ecs_iter_t it = ecs_query_iter(stage, pctx->query);
+    it.flags |= EcsIterMatchEmptyTables;
+    ecs_iter_set_group(&it, pctx->group_id);
+
+    /* Only iterate the results found by the first pass. Don't let the iterator
+     * run to completion, as that updates state for fixed query terms. */
+    int32_t r, result_count = pctx->result_count;
+    for (r = 0; r < result_count; r ++) {
+        if (!ecs_query_next(&it)) {
+            return;
+        }
+
+        /* Change detection was done by the first pass */
+        ecs_iter_skip(&it);
+
+        if (!pctx->selected[r]) {
+            continue;
+        }
+
+        ecs_iter_t slice = it;
+        slice.ctx = desc->ctx;
+
+        if (it.count >= (stage_count * FLECS_QUERY_PROPAGATE_SPLIT)) {
+            int32_t first = (int32_t)(
+                (int64_t)it.count * stage_index / stage_count);
+            int32_t last = (int32_t)(
+                (int64_t)it.count * (stage_index + 1) / stage_count);
+            slice.offset += first;
+            slice.count = last - first;
+            slice.entities = &it.entities[first];
+        } else if ((r % stage_count) != stage_index) {
+            continue;
+        }
+
+        desc->callback(&slice);
+    }
+
+    ecs_iter_fini(&it);
+}
+
+int ecs_query_propagate(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    const ecs_query_propagate_desc_t *desc)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_poly_assert(query, ecs_query_t);
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->callback != NULL, ECS_INVALID_PARAMETER,
+        "missing callback for propagate");
+
+    ecs_query_impl_t *impl = flecs_query_impl(query);
+    ecs_query_cache_t *cache = impl->cache;
+    ecs_check(cache != NULL && cache->cascade_by, ECS_INVALID_PARAMETER,
+        "propagate requires a cached query with a cascade term");
+    ecs_check(!(cache->query->terms[cache->cascade_by - 1].src.id & EcsDesc),
+        ECS_INVALID_PARAMETER,
+        "propagate requires a cascade term with ascending order");
+
+    ecs_world_t *real_world = query->real_world;
+    ecs_allocator_t *a = &real_world->allocator;
+
+    /* Make sure the cache is up to date before iterating its groups */
+    if (!(ecs_world_get_flags(world) & EcsWorldReadonly) && 
+        (query->flags & EcsQueryHasRefs)) 
+    {
+        flecs_eval_component_monitors(real_world);
+    }
+
+    bool multi_threaded = desc->multi_threaded &&
+        flecs_poly_is(world, ecs_world_t) &&
+        !(world->flags & EcsWorldReadonly);
+
+    ecs_vec_t selected;
+    ecs_vec_init_t(a, &selected, bool, 0);
+    ecs_map_t written;
+    ecs_map_init(&written, a);
+
+    flecs_query_propagate_ctx_t ctx = {
+        .world = world,
+        .query = query,
+        .desc = desc
+    };
+
+    ecs_query_cache_group_t *group = cache->first_group;
+    for (; group; group = group->next) {
+        ctx.group_id = group->info.id;
+        ctx.result_count = flecs_query_propagate_select(
+            world, query, ctx.group_id, &selected, &written);
+        ctx.selected = ecs_vec_first_t(&selected, bool);
+
+#ifdef FLECS_PIPELINE
+        if (multi_threaded) {
+            ctx.world = NULL;
+            if (flecs_workers_run(real_world,
+                flecs_query_propagate_run, &ctx))
+            {
+                continue;
+            }
+            ctx.world = world;
+        }
+#else
+        (void)multi_threaded;
+#endif
+
+        flecs_query_propagate_run(world, 0, 1, &ctx);
+    }
+
+    ecs_map_fini(&written);
+    ecs_vec_fini_t(a, &selected, bool);
+
+    return 0;
+error:
+    return -1;
+}
+
 static
 bool flecs_query_var_is_anonymous(
     const ecs_query_impl_t *query,
@@ -85544,6 +92208,103 @@ int32_t flecs_query_term_next_known(
     return -1;
 }
 
+int32_t flecs_query_term_cost(
+    const ecs_world_t *world,
+    const ecs_query_t *q,
+    const ecs_term_t *term)
+{
+    if (term->oper != EcsAnd || flecs_term_is_or(q, term)) {
+        return -1;
+    }
+
+    if (term->flags_ & (EcsTermIsScope|EcsTermIsMember|EcsTermIsToggle|
+        EcsTermDontFragment|EcsTermNonFragmentingChildOf|EcsTermTransitive|
+        EcsTermIdInherited|EcsTermReflexive|EcsTermMatchAny|EcsTermMatchAnySrc))
+    {
+        return -1;
+    }
+
+    if (!ecs_term_match_this(term) || 
+        ((term->src.id & EcsTraverseFlags) != EcsSelf)) 
+    {
+        return -1;
+    }
+
+    /* Only reorder terms with fixed ids. Terms with variables or predicates
+     * may depend on the order in which terms are evaluated. */
+    if (ecs_id_is_wildcard(term->id) || (term->first.id & EcsIsVariable) ||
+        (term->second.id & EcsIsVariable)) 
+    {
+        return -1;
+    }
+
+    ecs_entity_t first = ECS_TERM_REF_ID(&term->first);
+    if (first == EcsPredEq || first == EcsPredMatch || first == EcsPredLookup ||
+        first == EcsChildOf) 
+    {
+        return -1;
+    }
+
+    ecs_component_record_t *cr = flecs_components_get(world, term->id);
+    if (!cr) {
+        return 0;
+    }
+
+    return flecs_table_cache_count(&cr->cache);
+}
+
+/* Order the terms of a query by their estimated number of matched tables. Terms
+ * that can be reordered are moved to the front, and terms are never moved 
+ * across optional terms, which protects short-circuiting behavior. */
+static
+void flecs_query_order_by_cost(
+    ecs_world_t *world,
+    ecs_query_impl_t *query,
+    int32_t *order)
+{
+    ecs_query_t *q = &query->pub;
+    ecs_term_t *terms = q->terms;
+    int32_t i, j, term_count = q->term_count, start = 0;
+    int32_t cost[FLECS_TERM_COUNT_MAX];
+
+    for (i = 0; i < term_count; i ++) {
+        cost[i] = flecs_query_term_cost(world, q, &terms[i]);
+    }
+
+    for (i = 0; i <= term_count; i ++) {
+        if (i != term_count && terms[i].oper != EcsOptional) {
+            continue;
+        }
+
+        /* Terms that can be reordered go first, ordered by cost. Insertion 
+         * sort keeps the original order for terms with the same cost. */
+        int32_t count = 0;
+        for (j = start; j < i; j ++) {
+            if (cost[j] == -1) {
+                continue;
+            }
+
+            int32_t k = start + count;
+            while (k > start && cost[order[k - 1]] > cost[j]) {
+                order[k] = order[k - 1];
+                k --;
+            }
+
+            order[k] = j;
+            count ++;
+        }
+
+        for (j = start; j < i; j ++) {
+            if (cost[j] == -1) {
+                order[start + count] = j;
+                count ++;
+            }
+        }
+
+        start = i + 1;
+    }
+}
+
 /* If the first part of a query contains more than one trivial term, insert a
  * special instruction which batch-evaluates multiple terms. */
 static
@@ -85993,6 +92754,16 @@ int flecs_query_compile(
     /* Insert trivial term search if query allows for it */
     flecs_query_insert_trivial_search(query, &compiled, &ctx);
 
+    /* Order in which the remaining terms are compiled */
+    int32_t order[FLECS_TERM_COUNT_MAX];
+    for (i = 0; i < term_count; i ++) {
+        order[i] = i;
+    }
+
+    if (q->flags & EcsQueryPlanByCost) {
+        flecs_query_order_by_cost(world, query, order);
+    }
+
     /* If a query starts with one or more optional terms, first compile the non
      * optional terms. This prevents having to insert an instruction that 
      * matches the query against every entity in the storage. 
@@ -86009,10 +92780,10 @@ int flecs_query_compile(
     do {
         /* Compile remaining query terms to instructions */
         for (i = start_term; i < term_count; i ++) {
-            ecs_term_t *term = &terms[i];
-            int32_t compile = i;
+            ecs_term_t *term = &terms[order[i]];
+            int32_t compile = order[i];
 
-            if (compiled & (1ull << i)) {
+            if (compiled & (1ull << compile)) {
                 continue; /* Already compiled */
             }
 
@@ -86039,8 +92810,13 @@ int flecs_query_compile(
             if (can_reorder && ctx.written && 
                 flecs_query_term_is_unknown(query, term, &ctx)) 
             {
+                int32_t offset = i + 1;
+                if (q->flags & EcsQueryPlanByCost) {
+                    offset = 0; /* Terms are not compiled in term order */
+                }
+
                 int32_t term_index = flecs_query_term_next_known(
-                    query, &ctx, i + 1, compiled);
+                    query, &ctx, offset, compiled);
                 if (term_index != -1) {
                     term = &q->terms[term_index];
                     compile = term_index;
@@ -87080,6 +93856,11 @@ int flecs_query_compile_begin_member_term(
         return -1;
     }
 
+    /* Members of SoA structs are stored as separate components */
+    if (ecs_owns_id(world, component, EcsSoA)) {
+        component = first_id;
+    }
+
     if (!ecs_has(world, component, EcsComponent)) {
         ecs_err("parent of member is not a component");
         return -1;
@@ -87131,6 +93912,12 @@ int flecs_query_compile_end_member_term(
     first_id = ECS_TERM_REF_ID(&term->first);
     const EcsMember *member = ecs_get(world, first_id, EcsMember);
     ecs_assert(member != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    /* Members of SoA structs are stored at the start of their own column */
+    int32_t offset = member->offset;
+    if (component == first_id) {
+        offset = 0;
+    }
     ecs_query_var_t *var = &impl->vars[op->src.var];
     const char *var_name = flecs_term_ref_var_name(&term->src);
     ecs_var_id_t evar = flecs_query_find_var_id(
@@ -87148,7 +93935,7 @@ int flecs_query_compile_end_member_term(
     ecs_query_op_t mbr_op = *op;
     mbr_op.kind = EcsQueryMemberEq;
     mbr_op.first.entity = /* Encode type size and member offset */
-        flecs_ito(uint32_t, member->offset) | 
+        flecs_ito(uint32_t, offset) | 
         (flecs_ito(uint64_t, comp->size) << 32);
 
     /* If this is a term with a Not operator, conditionally evaluate member on
@@ -87841,6 +94628,14 @@ repeat:
             return false;
         }
 
+        ecs_query_partition_t *partition = ctx->qit->partition;
+        if (partition && (partition->op == ctx->op_index) &&
+            flecs_query_partition_skip(partition))
+        {
+            redo = false;
+            goto repeat;
+        }
+
         tr = elem->tr;
         op_ctx->column = elem->index;
         op_ctx->remaining = flecs_ito(int16_t, tr->count - 1);
@@ -89969,6 +96764,115 @@ bool flecs_query_trivial_cached_next(
     return false;
 }
 
+/* Find the operation that selects the tables for $this. Returns -1 if the
+ * query can't be partitioned. */
+static
+ecs_query_lbl_t flecs_query_partition_op(
+    const ecs_query_impl_t *impl)
+{
+    const ecs_query_op_t *ops = impl->ops;
+    int32_t i, count = impl->op_count;
+
+    for (i = 0; i < count; i ++) {
+        const ecs_query_op_t *op = &ops[i];
+        if (op->kind == EcsQuerySetIds || op->kind == EcsQuerySetId) {
+            continue;
+        }
+
+        /* The first operation must find tables for $this. Operations inside
+         * of control flow blocks could find tables for $this more than once. */
+        if (op->kind == EcsQueryTriv) {
+            return flecs_itolbl(i);
+        }
+
+        if (op->kind != EcsQueryAnd) {
+            return -1;
+        }
+
+        if (!(op->flags & (EcsQueryIsVar << EcsQuerySrc)) || 
+            (op->src.var != 0)) 
+        {
+            return -1;
+        }
+
+        /* Wildcards can match non-fragmenting components, which are returned
+         * per entity and not per table. */
+        ecs_id_t id = impl->pub.terms[op->term_index].id;
+        if (!ECS_IS_PAIR(id) && ecs_id_is_wildcard(id)) {
+            return -1;
+        }
+
+        return flecs_itolbl(i);
+    }
+
+    return -1;
+}
+
+bool flecs_query_partition_init(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor)
+{
+    if (it->next != ecs_query_next) {
+        return false;
+    }
+
+    if (!(it->query->flags & EcsQueryPartitionTables)) {
+        return false;
+    }
+
+    if (!cursor && count < 2) {
+        return false;
+    }
+
+    if (it->flags & (EcsIterIsValid|EcsIterCached|EcsIterTrivialSparse|
+        EcsIterTrivialTest)) 
+    {
+        return false;
+    }
+
+    if (it->constrained_vars & 1) {
+        return false; /* $this is not found by the query */
+    }
+
+    ecs_query_lbl_t op = -1;
+    if (!(it->flags & EcsIterTrivialSearch)) {
+        op = flecs_query_partition_op(flecs_query_impl(it->query));
+        if (op == -1) {
+            return false;
+        }
+    }
+
+    ecs_query_partition_t *partition = flecs_iter_calloc_t(
+        it, ecs_query_partition_t);
+    partition->cursor = cursor;
+    partition->index = index;
+    partition->count = count;
+    partition->claimed = -1;
+    partition->op = op;
+    it->priv_.iter.query.partition = partition;
+
+    return true;
+}
+
+bool flecs_query_partition_skip(
+    ecs_query_partition_t *partition)
+{
+    int32_t table = partition->table ++;
+    if (!partition->cursor) {
+        return (table % partition->count) != partition->index;
+    }
+
+    /* All workers walk the tables in the same order, so a claimed index refers
+     * to the same table for each worker. */
+    if (partition->claimed < table) {
+        partition->claimed = ecs_os_ainc(partition->cursor) - 1;
+    }
+
+    return partition->claimed != table;
+}
+
 void flecs_query_op_ctx_fini(
     ecs_iter_t *it,
     const ecs_query_op_t *op,
@@ -90064,6 +96968,11 @@ void flecs_query_iter_fini(
         }
     }
 
+    if (qit->partition) {
+        flecs_iter_free_t(qit->partition, ecs_query_partition_t);
+        qit->partition = NULL;
+    }
+
     flecs_query_iter_fini_ctx(it, qit);
     flecs_iter_free_n(qit->vars, ecs_var_t, var_count);
     flecs_iter_free_n(qit->written, ecs_write_flags_t, op_count);
@@ -91502,6 +98411,32 @@ bool flecs_query_sparse(
     }
 }
 
+/* Claim the next range of the dense array of the lead component. */
+static
+bool flecs_query_trivial_sparse_next_range(
+    ecs_query_sparse_trivial_ctx_t *op_ctx,
+    int32_t count)
+{
+    if (!op_ctx->cursor) {
+        return false;
+    }
+
+    int32_t chunk_size = op_ctx->chunk_size;
+    int32_t claimed = ecs_os_ainc(op_ctx->cursor) - 1;
+    int32_t first = claimed * chunk_size;
+    if (first >= count) {
+        return false;
+    }
+
+    op_ctx->cur = first;
+    op_ctx->end = first + chunk_size;
+    if (op_ctx->end > count) {
+        op_ctx->end = count;
+    }
+
+    return true;
+}
+
 bool flecs_query_trivial_sparse_search(
     const ecs_query_run_ctx_t *ctx,
     bool redo)
@@ -91531,46 +98466,86 @@ bool flecs_query_trivial_sparse_search(
         }
 
         op_ctx->lead = lead;
-        op_ctx->cur = 0;
+
+        /* Each worker iterates its own part of the dense array */
+        int32_t count = flecs_sparse_count(op_ctx->sparse[lead]);
+        if (op_ctx->cursor) {
+            op_ctx->cur = op_ctx->end = 0;
+        } else if (op_ctx->worker_count > 1) {
+            int32_t index = op_ctx->worker_index;
+            int32_t worker_count = op_ctx->worker_count;
+            op_ctx->cur = (int32_t)((int64_t)count * index / worker_count);
+            op_ctx->end = (int32_t)(
+                (int64_t)count * (index + 1) / worker_count);
+        } else {
+            op_ctx->cur = 0;
+            op_ctx->end = count;
+        }
     }
 
     int8_t lead = op_ctx->lead;
     ecs_sparse_t *lead_sparse = op_ctx->sparse[lead];
     const uint64_t *ids = flecs_sparse_ids(lead_sparse);
-    int32_t cur = op_ctx->cur, count = flecs_sparse_count(lead_sparse);
+    int32_t count = flecs_sparse_count(lead_sparse);
     ecs_entity_t *entities = op_ctx->entities;
     int32_t n = 0;
 
-    for (; cur < count && n < FLECS_QUERY_SPARSE_BATCH_SIZE; cur ++) {
-        ecs_entity_t e = ids[cur];
+next_range: {
+        int32_t cur = op_ctx->cur, end = op_ctx->end;
+        if (end > count) {
+            end = count;
+        }
 
-        for (i = 0; i < field_count; i ++) {
-            if (i == lead) {
-                continue;
+        for (; cur < end && n < FLECS_QUERY_SPARSE_BATCH_SIZE; cur ++) {
+            /* Sparse elements are stored in pages indexed by entity id, which 
+             * means that iterating the dense array accesses them in random
+             * order. Prefetch elements before they are accessed. */
+            if ((cur + FLECS_QUERY_SPARSE_PREFETCH) < end) {
+                ecs_entity_t pe = ids[cur + FLECS_QUERY_SPARSE_PREFETCH];
+                for (i = 0; i < field_count; i ++) {
+                    flecs_sparse_prefetch(op_ctx->sparse[i], pe);
+                }
+                flecs_entities_prefetch(ctx->world, pe);
             }
-            if (!flecs_sparse_has(op_ctx->sparse[i], e)) {
-                goto next;
+
+            ecs_entity_t e = ids[cur];
+
+            for (i = 0; i < field_count; i ++) {
+                if (i == lead) {
+                    continue;
+                }
+                if (!flecs_sparse_has(op_ctx->sparse[i], e)) {
+                    goto next;
+                }
             }
-        }
 
-        {
-            ecs_record_t *r = flecs_entities_get(ctx->world, e);
-            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
-            ecs_table_t *table = r->table;
-            ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
-            if (table->flags & 
-                (EcsTableNotQueryable|EcsTableIsPrefab|EcsTableIsDisabled))
             {
-                goto next;
+                ecs_record_t *r = flecs_entities_get(ctx->world, e);
+                ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+                ecs_table_t *table = r->table;
+                ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+                if (table->flags & 
+                    (EcsTableNotQueryable|EcsTableIsPrefab|EcsTableIsDisabled))
+                {
+                    goto next;
+                }
             }
-        }
 
-        entities[n ++] = e;
+            entities[n ++] = e;
 next:
-        continue;
-    }
+            continue;
+        }
 
-    op_ctx->cur = cur;
+        op_ctx->cur = cur;
+
+        /* When iterating chunks, don't return empty results for chunks that
+         * didn't match anything */
+        if (!n && cur >= end) {
+            if (flecs_query_trivial_sparse_next_range(op_ctx, count)) {
+                goto next_range;
+            }
+        }
+    }
 
     if (!n) {
         return false;
@@ -91584,6 +98559,36 @@ next:
     return true;
 }
 
+bool flecs_query_trivial_sparse_split(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor,
+    int32_t chunk_size)
+{
+    if (it->next != ecs_query_next || !(it->flags & EcsIterTrivialSparse)) {
+        return false;
+    }
+
+    ecs_query_iter_t *qit = &it->priv_.iter.query;
+    if (!qit->op_ctx) {
+        return false;
+    }
+
+    ecs_query_sparse_trivial_ctx_t *op_ctx = &qit->op_ctx[0].is.sparse_trivial;
+    if (op_ctx->sparse) {
+        /* Iteration already started */
+        return false;
+    }
+
+    op_ctx->worker_index = index;
+    op_ctx->worker_count = count;
+    op_ctx->cursor = cursor;
+    op_ctx->chunk_size = chunk_size;
+
+    return true;
+}
+
 typedef struct {
     ecs_flags64_t mask;
     bool has_bitset;
@@ -91660,6 +98665,68 @@ flecs_query_row_mask_t flecs_query_get_row_mask(
     return (flecs_query_row_mask_t){ mask, has_bitset };
 }
 
+/* Evaluate toggle fields for a table that stores rows with an enabled dense
+ * toggle before rows with a disabled dense toggle. If the dense toggle is the
+ * only toggle field with a bitset, the matching rows are a single range.
+ * Returns -1 if fields can't be evaluated with the partition, 0 if no rows
+ * match and 1 if the rows in range match. */
+static
+int32_t flecs_query_toggle_dense(
+    ecs_iter_t *it,
+    ecs_table_t *table,
+    ecs_flags64_t and_fields,
+    ecs_flags64_t not_fields,
+    ecs_query_toggle_ctx_t *op_ctx,
+    ecs_table_range_t *range)
+{
+    ecs_table__t *meta = table->_;
+    int32_t enabled = meta->dense_toggle_count;
+    if (enabled == -1) {
+        return -1;
+    }
+
+    ecs_bitset_t *dense = &meta->bs_columns[meta->dense_toggle];
+    int32_t first = range->offset, last = range->offset + range->count;
+    int32_t i, field_count = it->field_count;
+    ecs_flags64_t fields = and_fields | not_fields;
+
+    for (i = 0; i < field_count; i ++) {
+        uint64_t field_bit = 1llu << i;
+        if (!(fields & field_bit)) {
+            continue;
+        }
+
+        ecs_bitset_t *bs = flecs_table_get_toggle(table, it->ids[i]);
+        if (!bs) {
+            if ((not_fields & field_bit) && 
+                (op_ctx->prev_set_fields & field_bit)) 
+            {
+                return 0;
+            }
+            continue;
+        }
+
+        if (bs != dense) {
+            return -1;
+        }
+
+        if (not_fields & field_bit) {
+            it->set_fields &= (ecs_termset_t)~field_bit;
+            first = ECS_MAX(first, enabled);
+        } else {
+            last = ECS_MIN(last, enabled);
+        }
+    }
+
+    if (first >= last) {
+        return 0;
+    }
+
+    range->offset = first;
+    range->count = last - first;
+    return 1;
+}
+
 static
 bool flecs_query_toggle_for_up(
     ecs_iter_t *it,
@@ -91761,6 +98828,21 @@ bool flecs_query_toggle_cmp(
         cur = op_ctx->cur = range.offset;
         block_index = op_ctx->block_index = -1;
         last = range.offset + range.count;
+
+        if (table->flags & EcsTableHasDenseToggle) {
+            int32_t dense = flecs_query_toggle_dense(
+                it, table, and_fields, not_fields, op_ctx, &range);
+            if (dense != -1) {
+                /* Matching rows are a single range, no need to redo */
+                op_ctx->has_bitset = false;
+                if (!dense) {
+                    goto done;
+                }
+
+                flecs_query_src_set_range(op, &range, ctx);
+                return true;
+            }
+        }
     } else {
         if (!op_ctx->has_bitset) {
             goto done;
@@ -94552,6 +101634,67 @@ int32_t flecs_trav_type_offset_search(
     return -1;
 }
 
+/* Results of up traversal are stored in the reachable cache of the pair record
+ * for the traversed relationship and target, so that they can be reused by
+ * other iterators and in later frames. Results are stored for each visited
+ * target, which guarantees that an entity changing tables invalidates the
+ * results that depend on it (see flecs_emit_propagate_invalidate_tables). */
+static
+bool flecs_trav_up_index_get(
+    ecs_component_record_t *cr,
+    ecs_id_t with,
+    ecs_id_t rel,
+    ecs_trav_up_t *up)
+{
+    ecs_reachable_cache_t *rc = &cr->pair->reachable;
+    if (rc->up_current != rc->generation) {
+        return false;
+    }
+
+    ecs_reachable_up_t *elems = ecs_vec_first_t(&rc->up, ecs_reachable_up_t);
+    int32_t i, count = ecs_vec_count(&rc->up);
+    for (i = 0; i < count; i ++) {
+        ecs_reachable_up_t *elem = &elems[i];
+        if (elem->with == with && elem->rel == rel) {
+            up->src = elem->src;
+            up->id = elem->id;
+            up->tr = elem->tr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static
+void flecs_trav_up_index_set(
+    const ecs_world_t *world,
+    ecs_component_record_t *cr,
+    ecs_id_t with,
+    ecs_id_t rel,
+    const ecs_trav_up_t *up)
+{
+    /* Other threads may be reading from the index */
+    if ((world->flags & EcsWorldMultiThreaded) || world->worker_job) {
+        return;
+    }
+
+    ecs_world_t *unsafe_world = ECS_CONST_CAST(ecs_world_t*, world);
+    ecs_reachable_cache_t *rc = &cr->pair->reachable;
+    if (rc->up_current != rc->generation) {
+        ecs_vec_clear(&rc->up);
+        rc->up_current = rc->generation;
+    }
+
+    ecs_reachable_up_t *elem = ecs_vec_append_t(
+        &unsafe_world->allocator, &rc->up, ecs_reachable_up_t);
+    elem->with = with;
+    elem->rel = rel;
+    elem->src = up->src;
+    elem->id = up->id;
+    elem->tr = up->tr;
+}
+
 static
 ecs_trav_up_t* flecs_trav_table_up(
     const ecs_query_run_ctx_t *ctx,
@@ -94711,12 +101854,56 @@ ecs_trav_up_t* flecs_trav_table_up(
         return up;
     }
 
-    flecs_trav_table_up_w(ctx, a, cache, world, src, with, rel, cr_with,
-        cr_trav, up);
+    /* Sparse components can be added without changing tables, which doesn't
+     * invalidate the index. */
+    ecs_component_record_t *cr = NULL;
+    if (!(cr_with->flags & EcsIdDontFragment)) {
+        cr = flecs_components_get(world, 
+            ecs_pair(ECS_PAIR_FIRST(cr_trav->id), src));
+    }
+
+    if (!cr || !flecs_trav_up_index_get(cr, with, rel, up)) {
+        flecs_trav_table_up_w(ctx, a, cache, world, src, with, rel, cr_with,
+            cr_trav, up);
+        if (cr) {
+            flecs_trav_up_index_set(world, cr, with, rel, up);
+        }
+    }
+
     up->ready = true;
     return up;
 }
 
+static
+void flecs_trav_table_up_indexed(
+    const ecs_query_run_ctx_t *ctx,
+    ecs_allocator_t *a,
+    ecs_trav_up_cache_t *cache,
+    const ecs_world_t *world,
+    ecs_component_record_t *cr,
+    ecs_entity_t tgt,
+    ecs_id_t with,
+    ecs_id_t rel,
+    ecs_component_record_t *cr_with,
+    ecs_component_record_t *cr_trav,
+    ecs_trav_up_t *up)
+{
+    if (cr_with->flags & EcsIdDontFragment) {
+        cr = NULL;
+    }
+
+    if (cr && flecs_trav_up_index_get(cr, with, rel, up)) {
+        return;
+    }
+
+    flecs_trav_table_up_w(ctx, a, cache, world, tgt, with, rel, cr_with, 
+        cr_trav, up);
+
+    if (cr) {
+        flecs_trav_up_index_set(world, cr, with, rel, up);
+    }
+}
+
 ecs_trav_up_t* flecs_query_get_up_cache(
     const ecs_query_run_ctx_t *ctx,
     ecs_trav_up_cache_t *cache,
@@ -94756,7 +101943,8 @@ ecs_trav_up_t* flecs_query_get_up_cache(
             ecs_entity_t tgt = (uint32_t)p->value;
             ecs_trav_up_t *result = &cache->up;
             *result = (ecs_trav_up_t){0};
-            flecs_trav_table_up_w(ctx, a, cache, world, tgt,
+            flecs_trav_table_up_indexed(ctx, a, cache, world, 
+                flecs_components_get(world, ecs_childof(tgt)), tgt,
                 with, ecs_pair(trav, EcsWildcard), cr_with, cr_trav, result);
             if (result->src != 0) {
                 return result;
@@ -94777,7 +101965,8 @@ ecs_trav_up_t* flecs_query_get_up_cache(
         ecs_entity_t tgt = ECS_PAIR_SECOND(id);
         ecs_trav_up_t *result = &cache->up;
         *result = (ecs_trav_up_t){0};
-        flecs_trav_table_up_w(ctx, a, cache, world, tgt,
+        flecs_trav_table_up_indexed(ctx, a, cache, world, 
+            table->_->records[i].hdr.cr, tgt,
             with, ecs_pair(trav, EcsWildcard), cr_with, cr_trav, result);
         if (result->src != 0) {
             return result;
@@ -94813,13 +102002,35 @@ bool flecs_query_trivial_search_init(
         }
 
         ecs_assert(t != query->term_count, ECS_INTERNAL_ERROR, NULL);
-        op_ctx->start_from = t;
 
         ecs_component_record_t *cr = flecs_components_get(ctx->world, query->terms[t].id);
         if (!cr) {
             return false;
         }
 
+        if (query->flags & EcsQueryPlanByCost) {
+            /* Start from the term that matches the fewest tables */
+            int32_t i, first = t;
+            for (i = first + 1; i < query->term_count; i ++) {
+                if (term_set && !(term_set & (1llu << i))) {
+                    continue;
+                }
+
+                ecs_component_record_t *cr_i = flecs_components_get(
+                    ctx->world, query->terms[i].id);
+                if (!cr_i) {
+                    return false;
+                }
+
+                if (cr_i->cache.queryable_count < cr->cache.queryable_count) {
+                    cr = cr_i;
+                    t = i;
+                }
+            }
+        }
+
+        op_ctx->start_from = t;
+
         if (query->flags & EcsQueryMatchEmptyTables) {
             if (!flecs_table_cache_queryable_iter(&cr->cache, &op_ctx->it, 
                 EcsTableEmpty|EcsTableNotEmpty))
@@ -94835,8 +102046,11 @@ bool flecs_query_trivial_search_init(
         }
 
         /* Find next term to evaluate once */
-        for (t = t + 1; t < query->term_count; t ++) {
-            if (term_set & (1llu << t)) {
+        for (t = 0; t < query->term_count; t ++) {
+            if (t == op_ctx->start_from) {
+                continue;
+            }
+            if (!term_set || (term_set & (1llu << t))) {
                 break;
             }
         }
@@ -94884,6 +102098,13 @@ bool flecs_query_trivial_search(
             return false;
         }
 
+        ecs_query_partition_t *partition = ctx->qit->partition;
+        if (partition && (partition->op == ctx->op_index) &&
+            flecs_query_partition_skip(partition))
+        {
+            continue;
+        }
+
         ecs_table_t *table = elem->table;
         if (!flecs_table_bloom_filter_test(table, q_filter)) {
             continue;
@@ -94891,7 +102112,7 @@ bool flecs_query_trivial_search(
 
         int16_t *columns = ECS_CONST_CAST(int16_t*, it->columns);
         for (t = op_ctx->first_to_eval; t < term_count; t ++) {
-            if (!(term_set & (1llu << t))) {
+            if (!(term_set & (1llu << t)) || (t == op_ctx->start_from)) {
                 continue;
             }
 
@@ -94939,6 +102160,7 @@ bool flecs_query_is_trivial_search(
 
     uint64_t q_filter = q->bloom_filter;
     ecs_component_record_t **cr_cache = query->cr_cache;
+    int32_t start_from = op_ctx->start_from;
 
 next:
     {
@@ -94948,13 +102170,23 @@ next:
             return false;
         }
 
+        if (ctx->qit->partition && 
+            flecs_query_partition_skip(ctx->qit->partition)) 
+        {
+            goto next;
+        }
+
         ecs_table_t *table = elem->table;
         if (!flecs_table_bloom_filter_test(table, q_filter)) {
             goto next;
         }
 
         int16_t *columns = ECS_CONST_CAST(int16_t*, it->columns);
-        for (t = 1; t < term_count; t ++) {
+        for (t = op_ctx->first_to_eval; t < term_count; t ++) {
+            if (t == start_from) {
+                continue;
+            }
+
             ecs_component_record_t *cr = cr_cache[t];
             ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -94971,8 +102203,8 @@ next:
         it->table = table;
         it->count = ecs_table_count(table);
         it->entities = ecs_table_entities(table);
-        it->trs[0] = elem->tr;
-        columns[0] = elem->column;
+        it->trs[start_from] = elem->tr;
+        columns[start_from] = elem->column;
     }
 
     return true;
@@ -96685,6 +103917,105 @@ void flecs_set_struct_member(
     member->warning_range = m->warning_range;
 }
 
+/* Register the members of a struct with the SoA trait as components. Each
+ * member is added to the struct with a (With, member) pair, which stores the
+ * member in its own table column when the struct is added to an entity. */
+static
+int flecs_struct_init_soa(
+    ecs_world_t *world,
+    ecs_entity_t type)
+{
+    const EcsStruct *s = ecs_get(world, type, EcsStruct);
+    if (!s) {
+        return 0;
+    }
+
+    int32_t i, count = ecs_vec_count(&s->members);
+    for (i = 0; i < count; i ++) {
+        /* Reobtain struct, as registering members can modify the world */
+        EcsStruct *st = ecs_get_mut(world, type, EcsStruct);
+        ecs_assert(st != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_member_t *m = ecs_vec_get_t(&st->members, ecs_member_t, i);
+        ecs_entity_t member = m->member;
+
+        if (member == type) {
+            continue;
+        }
+
+        if (m->count > 1) {
+            char *path = ecs_get_path(world, type);
+            ecs_err("member '%s.%s' of SoA struct cannot be an array",
+                path, m->name);
+            ecs_os_free(path);
+            return -1;
+        }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, m->type);
+        if (!ti) {
+            char *path = ecs_get_path(world, type);
+            ecs_err("type of member '%s.%s' is not a component", 
+                path, m->name);
+            ecs_os_free(path);
+            return -1;
+        }
+
+        if (!member) {
+            /* Member entity is used as component. EcsMember is assigned without
+             * calling modified, as the struct already contains the member. */
+            member = ecs_new_from_path(world, type, m->name);
+            EcsMember *mbr = ecs_ensure(world, member, EcsMember);
+            mbr->type = m->type;
+            mbr->count = m->count;
+            mbr->offset = m->offset;
+            mbr->unit = m->unit;
+
+            st = ecs_get_mut(world, type, EcsStruct);
+            ecs_vec_get_t(&st->members, ecs_member_t, i)->member = member;
+        }
+
+        if (!ecs_has(world, member, EcsComponent)) {
+            /* Use lifecycle callbacks of the member type. Contexts are owned
+             * by the member type, and are not freed by the member component. */
+            ecs_type_hooks_t hooks = ti->hooks;
+            hooks.on_add = NULL;
+            hooks.on_set = NULL;
+            hooks.on_remove = NULL;
+            hooks.on_replace = NULL;
+            hooks.on_validate = NULL;
+            hooks.ctx_free = NULL;
+            hooks.binding_ctx_free = NULL;
+            hooks.lifecycle_ctx_free = NULL;
+
+            ecs_component_init(world, &(ecs_component_desc_t){
+                .entity = member,
+                .type.size = ti->size,
+                .type.alignment = ti->alignment,
+                .type.hooks = hooks
+            });
+        }
+
+        /* Serialize member component with the serializer of the member type,
+         * so that member columns can be (de)serialized as values. */
+        const EcsTypeSerializer *ser = ecs_get(
+            world, m->type, EcsTypeSerializer);
+        if (ser && !ecs_has(world, member, EcsTypeSerializer)) {
+            ecs_set_ptr(world, member, EcsTypeSerializer, ser);
+        }
+
+        ecs_add_pair(world, type, EcsWith, member);
+    }
+
+    return 0;
+}
+
+static
+void flecs_struct_soa_on_add(ecs_iter_t *it) {
+    int32_t i, count = it->count;
+    for (i = 0; i < count; i ++) {
+        flecs_struct_init_soa(it->world, it->entities[i]);
+    }
+}
+
 static
 int flecs_add_member_to_struct(
     ecs_world_t *world,
@@ -96916,6 +104247,13 @@ int flecs_add_member_to_struct(
         ecs_modified(world, struct_type, EcsMember);
     }
 
+    /* Members added to SoA structs are stored in their own column */
+    if (ecs_owns_id(world, struct_type, EcsSoA)) {
+        if (flecs_struct_init_soa(world, struct_type)) {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -97331,6 +104669,16 @@ void flecs_meta_struct_init(
         .global_observer = true
     });
 
+    ecs_observer(world, {
+        .query.terms = {
+            { .id = EcsSoA }, 
+            { .id = ecs_id(EcsStruct), .inout = EcsInOutNone }
+        },
+        .events = {EcsOnAdd},
+        .callback = flecs_struct_soa_on_add,
+        .global_observer = true
+    });
+
     ecs_set(world, ecs_id(EcsStruct),  EcsDefaultChildComponent, {ecs_id(EcsMember)});
     ecs_add_pair(world, ecs_id(EcsStruct), EcsWith, ecs_id(EcsComponent));
     ecs_set(world, ecs_id(EcsMember),  EcsDefaultChildComponent, {ecs_id(EcsMember)});
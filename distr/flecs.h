@@ -237,6 +237,7 @@
 #define FLECS_SCRIPT         /**< Flecs entity notation language. */
 // #define FLECS_SCRIPT_MATH /**< Math functions for Flecs script (may require linking with libm). */
 // #define FLECS_SCRIPT_PLATFORM /**< Platform constants for Flecs script. */
+#define FLECS_SNAPSHOT       /**< Binary world snapshots. */
 #define FLECS_SYSTEM         /**< System support. */
 #define FLECS_STATS          /**< Track runtime statistics. */
 #define FLECS_TIMER          /**< Timer support. */
@@ -298,12 +299,53 @@
 #define FLECS_ENTITY_PAGE_BITS 10
 #endif
 
+/** @def FLECS_ENTITY_RESERVE_COUNT
+ * Minimum number of entity ids for which storage is reserved in the entity
+ * index when the world enters multithreaded mode. Stages claim blocks of ids
+ * from the entity index when they create entities, and creating up to this
+ * number of entities doesn't reallocate entity index storage. If more entities
+ * were created during the previous multithreaded phase, storage for twice that
+ * number is reserved. */
+#ifndef FLECS_ENTITY_RESERVE_COUNT
+#define FLECS_ENTITY_RESERVE_COUNT 1024
+#endif
+
+/** @def FLECS_BULK_PARALLEL_MIN_COUNT
+ * Minimum number of entities per worker thread for which ecs_bulk_init() with
+ * the parallel option splits up initialization across worker threads. Below
+ * this number, the cost of waking up worker threads exceeds the gains. */
+#ifndef FLECS_BULK_PARALLEL_MIN_COUNT
+#define FLECS_BULK_PARALLEL_MIN_COUNT 1024
+#endif
+
 /** @def FLECS_USE_OS_ALLOC
  * When enabled, Flecs will use the OS allocator provided in the OS API directly
  * instead of the built-in block allocator. This can decrease memory utilization
  * as memory will be freed more often, at the cost of decreased performance. */
 // #define FLECS_USE_OS_ALLOC
 
+/** @def FLECS_HUGE_PAGES
+ * When enabled, world and stage allocators carve the blocks of their block
+ * allocators from large slabs, and allocate large objects (such as table
+ * columns with many entities) directly from the OS. Slabs and large objects 
+ * are allocated with the page_alloc_ callback of the OS API, which in the 
+ * POSIX implementation maps memory that is backed by huge pages on Linux. This
+ * reduces TLB misses when iterating worlds with many entities. 
+ * 
+ * Slabs are allocated lazily by the thread that first uses an allocator, which
+ * means that with the default first-touch NUMA policy of the OS, the memory of
+ * a stage allocator is placed on the node of the thread that uses the stage.
+ * Applications can provide their own page_alloc_ callback to explicitly bind
+ * memory to a node. */
+// #define FLECS_HUGE_PAGES
+
+/** @def FLECS_HUGE_PAGE_SIZE
+ * Size of a slab when FLECS_HUGE_PAGES is enabled. Allocations that are at 
+ * least this large are directly allocated with the page_alloc_ callback. */
+#ifndef FLECS_HUGE_PAGE_SIZE
+#define FLECS_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
 /** @def FLECS_ID_DESC_MAX
  * Maximum number of IDs to add in ecs_entity_desc_t / ecs_bulk_desc_t. */
 #ifndef FLECS_ID_DESC_MAX
@@ -383,6 +425,7 @@ extern "C" {
 #define EcsWorldMeasureSystemTime     (1u << 6)
 #define EcsWorldMultiThreaded         (1u << 7)
 #define EcsWorldFrameInProgress       (1u << 8)
+#define EcsWorldParallelMerge         (1u << 9)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// OS API flags
@@ -449,6 +492,8 @@ extern "C" {
         EcsIdHasOnTableCreate|EcsIdHasOnTableDelete|EcsIdSparse|\
         EcsIdOrderedChildren)
 #define EcsIdPrefabChildren            (1u << 26)
+#define EcsIdSoA                       (1u << 27)
+#define EcsIdDenseToggle               (1u << 28)
 
 #define EcsIdMarkedForDelete           (1u << 30)
 
@@ -567,7 +612,9 @@ extern "C" {
 #define EcsObserverBypassQuery         (1u << 7u)  /* Don't evaluate query for multi-component observer. */
 #define EcsObserverYieldOnCreate       (1u << 8u)  /* Yield matching entities when creating observer. */
 #define EcsObserverYieldOnDelete       (1u << 9u)  /* Yield matching entities when deleting observer. */
+#define EcsObserverCoalesce            (1u << 10u) /* Store events and deliver them when flushed. */
 #define EcsObserverKeepAlive           (1u << 11u) /* Observer keeps component alive (same value as EcsTermKeepAlive). */
+#define EcsObserverMultiThreaded       (1u << 12u) /* Deliver coalesced events on worker threads. */
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Table flags (used by ecs_table_t::flags)
@@ -606,6 +653,7 @@ extern "C" {
 #define EcsTableEdgeReparent           (1u << 28u)
 #define EcsTableMarkedForDelete        (1u << 29u)
 #define EcsTableNotEmpty               (1u << 30u) /* Does the table have entities. */
+#define EcsTableHasDenseToggle         (1u << 31u) /* Are enabled rows stored at the start of the table. */
 
 /* Composite table flags */
 #define EcsTableHasLifecycle     (EcsTableHasCtors | EcsTableHasDtors)
@@ -2081,6 +2129,18 @@ bool flecs_sparse_has(
     const ecs_sparse_t *sparse,
     uint64_t id);
 
+/** Prefetch the sparse index and element of an ID.
+ * This does not load the memory of the element, but hints the CPU that it will
+ * be accessed soon. Use this when iterating IDs in an order that doesn't match
+ * their memory layout, like when iterating the dense array.
+ *
+ * @param sparse The sparse set.
+ * @param id The ID to prefetch.
+ */
+void flecs_sparse_prefetch(
+    const ecs_sparse_t *sparse,
+    uint64_t id);
+
 /** Get element by sparse ID, regardless of whether the element is alive or not.
  *
  * @param sparse The sparse set to retrieve from.
@@ -2332,6 +2392,14 @@ typedef struct ecs_block_allocator_chunk_header_t {
     struct ecs_block_allocator_chunk_header_t *next; /**< Next free chunk. */
 } ecs_block_allocator_chunk_header_t;
 
+#if defined(FLECS_HUGE_PAGES) && !defined(FLECS_USE_OS_ALLOC)
+/** Arena that provides the blocks of block allocators from large slabs. */
+typedef struct ecs_page_arena_t {
+    struct ecs_page_slab_t *slab; /**< Current slab (head of slab list). */
+    int32_t used; /**< Number of bytes used in the current slab. */
+} ecs_page_arena_t;
+#endif
+
 /** Block allocator that returns fixed-size memory blocks. */
 typedef struct ecs_block_allocator_t {
     int32_t data_size; /**< Size of each allocation. */
@@ -2341,6 +2409,9 @@ typedef struct ecs_block_allocator_t {
     int32_t block_size; /**< Total size of each allocated block. */
     ecs_block_allocator_chunk_header_t *head; /**< Head of the free chunk list. */
     ecs_block_allocator_block_t *block_head; /**< Head of the allocated block list. */
+#ifdef FLECS_HUGE_PAGES
+    ecs_page_arena_t *arena; /**< Arena that provides blocks (optional). */
+#endif
 #ifdef FLECS_SANITIZE
     int32_t alloc_count; /**< Number of outstanding allocations (sanitizer only). */
     ecs_map_t *outstanding; /**< Map of outstanding allocations (sanitizer only). */
@@ -2391,6 +2462,26 @@ FLECS_API
 void flecs_ballocator_fini(
     ecs_block_allocator_t *ba);
 
+#if defined(FLECS_HUGE_PAGES) && !defined(FLECS_USE_OS_ALLOC)
+/** Free the slabs of a page arena. 
+ * Block allocators that use the arena must be deinitialized first.
+ *
+ * @param arena The arena.
+ */
+FLECS_API
+void flecs_page_arena_fini(
+    ecs_page_arena_t *arena);
+#endif
+
+/** Free the blocks of a block allocator if it has no outstanding allocations.
+ *
+ * @param ba The block allocator.
+ * @return The number of bytes freed.
+ */
+FLECS_API
+int64_t flecs_ballocator_reclaim(
+    ecs_block_allocator_t *ba);
+
 /** Free a block allocator created with flecs_ballocator_new().
  *
  * @param ba The block allocator to free.
@@ -2938,6 +3029,9 @@ struct ecs_allocator_t {
 #ifndef FLECS_USE_OS_ALLOC
     ecs_block_allocator_t chunks; /**< Block allocator for chunk storage. */
     struct ecs_sparse_t sizes; /**< Sparse set mapping size to block allocator. */
+#ifdef FLECS_HUGE_PAGES
+    ecs_page_arena_t arena; /**< Arena for blocks of block allocators. */
+#endif
 #else
     bool dummy; /**< Unused member for OS allocator fallback. */
 #endif
@@ -3493,6 +3587,17 @@ typedef
 void* (*ecs_os_api_calloc_t)(
     ecs_size_t size);
 
+/** OS API page_alloc function type. */
+typedef
+void* (*ecs_os_api_page_alloc_t)(
+    ecs_size_t size);
+
+/** OS API page_free function type. */
+typedef
+void (*ecs_os_api_page_free_t)(
+    void *ptr,
+    ecs_size_t size);
+
 /** OS API strdup function type. */
 typedef
 char* (*ecs_os_api_strdup_t)(
@@ -3692,6 +3797,8 @@ typedef struct ecs_os_api_t {
     ecs_os_api_realloc_t realloc_;                 /**< realloc callback. */
     ecs_os_api_calloc_t calloc_;                   /**< calloc callback. */
     ecs_os_api_free_t free_;                       /**< free callback. */
+    ecs_os_api_page_alloc_t page_alloc_;           /**< page_alloc callback (optional). */
+    ecs_os_api_page_free_t page_free_;             /**< page_free callback (optional). */
 
     /* Strings */
     ecs_os_api_strdup_t strdup_;                   /**< strdup callback. */
@@ -3842,6 +3949,12 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#ifndef ecs_os_page_alloc
+#define ecs_os_page_alloc(size) ecs_os_api.page_alloc_(size)
+#endif
+#ifndef ecs_os_page_free
+#define ecs_os_page_free(ptr, size) ecs_os_api.page_free_(ptr, size)
+#endif
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -3892,7 +4005,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_zeromem(ptr) ecs_os_memset(ptr, 0, ECS_SIZEOF(*ptr))
 
 #define ecs_os_memdup_t(ptr, T) ecs_os_memdup(ptr, ECS_SIZEOF(T))
-#define ecs_os_memdup_n(ptr, T, count) ecs_os_memdup(ptr, ECS_SIZEOF(T) * count)
+#define ecs_os_memdup_n(ptr, T, count) ecs_os_memdup(ptr, ECS_SIZEOF(T) * (count))
 
 #define ecs_offset(ptr, T, index)\
     ECS_CAST(T*, ECS_OFFSET(ptr, ECS_SIZEOF(T) * index))
@@ -4786,6 +4899,10 @@ typedef struct ecs_page_iter_t {
 typedef struct ecs_worker_iter_t {
     int32_t index;
     int32_t count;
+    int32_t *cursor;             /* Shared chunk counter (dynamic iterator) */
+    int32_t chunk_size;          /* Max number of entities per chunk */
+    int32_t chunk;               /* Index of next chunk in chained iterator */
+    bool split;                  /* Chained iterator only returns results for worker */
 } ecs_worker_iter_t;
 
 /* Inlined element stored in a table cache. */
@@ -4836,6 +4953,7 @@ typedef struct ecs_query_iter_t {
     int32_t cur, all_cur;                     /* Indices into tables and all_tables. */
 
     ecs_query_op_profile_t *profile;
+    struct ecs_query_partition_t *partition;  /* Tables iterated by worker (worker iterators). */
 
     int16_t op;                               /* Currently iterated query plan operation (index into ops). */
     bool iter_single_group;
@@ -6052,6 +6170,11 @@ typedef struct ecs_bulk_desc_t {
                          * same time as 'data', the elements in the data array
                          * must correspond with the ids in the table's type. */
 
+    bool parallel;     /**< Construct and initialize component values on the
+                        * worker threads of the world (see ecs_set_threads()).
+                        * Constructors and copy/move hooks of the components
+                        * must be safe to run concurrently for different
+                        * values. */
 } ecs_bulk_desc_t;
 
 /** Used with ecs_component_init().
@@ -6231,6 +6354,43 @@ struct ecs_iter_t {
  */
 #define EcsQueryGroupByDesc           (1u << 10u)
 
+/** Order terms by their estimated number of matched tables.
+ * When this flag is set, the query planner starts evaluating queries from the
+ * terms that match the fewest tables, instead of evaluating terms in the order
+ * in which they appear in the query. Only terms with a fixed id and $this 
+ * source that don't use traversal are reordered, and terms are never reordered
+ * across optional terms.
+ * 
+ * The number of matched tables is estimated when the query is created. Terms 
+ * that are evaluated together by a single instruction are reordered each time
+ * the query is iterated, which means that these terms automatically follow 
+ * changes in the number of tables. The choices of the planner are shown by
+ * ecs_query_plan().
+ * 
+ * Using this flag can change the order in which results are returned. The flag
+ * has no effect for queries that are entirely cached.
+ * 
+ * \ingroup queries
+ */
+#define EcsQueryPlanByCost            (1u << 5u)
+
+/** Distribute tables across workers when iterating with worker iterators.
+ * By default, ecs_worker_iter() and ecs_dynamic_worker_iter() evaluate the
+ * entire query on each worker, and split up the entities of each result across
+ * workers. When this flag is set for an uncached query, the operation that
+ * finds the tables for $this is partitioned instead, so that each worker only
+ * evaluates the remaining query terms for its own tables. This reduces the
+ * cost of evaluating queries that match many tables, but each table is
+ * iterated by a single worker.
+ * 
+ * Queries that don't start with a $this term with a fixed or pair wildcard id
+ * fall back to splitting up entities. The flag has no effect for cached
+ * queries.
+ * 
+ * \ingroup queries
+ */
+#define EcsQueryPartitionTables       (1u << 0u)
+
 /** Used with ecs_query_init().
  * 
  * \ingroup queries
@@ -6331,6 +6491,37 @@ typedef struct ecs_observer_desc_t {
      * ecs_observer_init() will not return an entity handle. */
     bool global_observer;
 
+    /** Coalesce events. Instead of invoking the callback when an event is
+     * emitted, the observer stores the entities for which it received events,
+     * and delivers them when the observer is flushed with ecs_observer_flush().
+     * Repeated events for the same entity are delivered once, and an OnAdd
+     * followed by an OnRemove for the same entity cancel out. Events are
+     * delivered in batches of adjacent entities in the same table, with the
+     * component values at the time of the flush. OnRemove events are delivered
+     * after the component is removed, and don't have field data.
+     *
+     * Coalescing is supported for OnAdd, OnRemove and OnSet events, for
+     * observers that only match $this. */
+    bool coalesce;
+
+    /** Pipeline phase in which a coalesced observer is flushed. When set, a
+     * system is created in the phase that flushes the observer each frame. The
+     * system is created as a child of the observer entity. */
+    ecs_entity_t coalesce_phase;
+
+    /** Deliver the events of a coalesced observer on multiple threads. When the
+     * observer is flushed and the world has worker threads, the batches for
+     * different tables are delivered in parallel, each on the stage of the
+     * thread that delivers it. Operations invoked by the callback are deferred
+     * and merged after all events were delivered. The callback may only write
+     * to the fields of the entities it is invoked for. This is not checked,
+     * and the inout kind of the observer terms is not used to schedule the
+     * delivery. Worlds that use task threads deliver the events on the thread
+     * that flushes the observer.
+     *
+     * Requires coalesce. */
+    bool multi_threaded;
+
     /** Callback to invoke on an event, invoked when the observer matches. */
     ecs_iter_action_t callback;
 
@@ -6471,6 +6662,7 @@ typedef struct ecs_world_info_t {
     int64_t systems_ran_total;        /**< Total number of systems run. */
     int64_t observers_ran_total;      /**< Total number of times an observer was invoked. */
     int64_t queries_ran_total;        /**< Total number of times a query was evaluated. */
+    int64_t compact_reclaimed_total;  /**< Total number of bytes reclaimed by ecs_compact(). */
 
     int32_t tag_id_count;             /**< Number of tag (no data) IDs in the world. */
     int32_t component_id_count;       /**< Number of component (data) IDs in the world. */
@@ -6494,6 +6686,7 @@ typedef struct ecs_world_info_t {
         int64_t other_count;           /**< Other commands processed. */
         int64_t batched_entity_count;  /**< Entities for which commands were batched. */
         int64_t batched_command_count; /**< Commands batched. */
+        int64_t parallel_merged_count; /**< Commands merged in parallel by worker threads. */
     } cmd;                             /**< Command statistics. */
 
     const char *name_prefix;          /**< Value set by ecs_set_name_prefix(). Used
@@ -6936,6 +7129,19 @@ FLECS_API extern const ecs_entity_t EcsSparse;
 /** Mark component as non-fragmenting. */
 FLECS_API extern const ecs_entity_t EcsDontFragment;
 
+/** Mark component as structure-of-arrays. A SoA component does not have a
+ * column of its own. Its data is stored in the components it adds with (With,
+ * component) pairs, which are removed together with the SoA component. The meta
+ * addon uses this trait to store each member of a struct in its own column. */
+FLECS_API extern const ecs_entity_t EcsSoA;
+
+/** Mark toggleable component as dense. Tables with a dense toggle component
+ * store the entities that have the component enabled before the entities that
+ * have it disabled, so queries iterate them as a single range of rows. Enabling
+ * or disabling the component moves the entity inside its table. Implies
+ * CanToggle. */
+FLECS_API extern const ecs_entity_t EcsDenseToggle;
+
 /** Marker used to indicate `$var == ...` matching in queries. */
 FLECS_API extern const ecs_entity_t EcsPredEq;
 
@@ -7262,6 +7468,28 @@ void ecs_set_default_query_flags(
     ecs_world_t *world,
     ecs_flags32_t flags);
 
+/** Set the minimum alignment of component columns.
+ * Tables created after this operation allocate the storage of each component
+ * column with at least the specified alignment. The storage of an aligned 
+ * column is padded to a multiple of the alignment. This ensures that vector
+ * loads on column data don't split cache lines, and that the columns of 
+ * different tables don't share cache lines.
+ *
+ * Components with an alignment larger than the specified value use the 
+ * alignment of the component. To align the columns of a single component,
+ * register the component with a larger alignment (in C++, with alignas).
+ *
+ * The alignment of a column can be retrieved with 
+ * ecs_table_get_column_alignment().
+ *
+ * @param world The world.
+ * @param alignment The alignment (a power of two, or 0 for default alignment).
+ */
+FLECS_API
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    int32_t alignment);
+
 /** @} */
 
 /**
@@ -7789,6 +8017,70 @@ int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc);
 
+/** Used with ecs_compact(). */
+typedef struct ecs_compact_desc_t {
+    /** Amount of time operation is allowed to spend. If zero, the operation 
+     * completes the current compaction pass. */
+    double time_budget_seconds;
+
+    /** Free table data when a table was empty for this number of passes 
+     * (0 = never). */
+    uint16_t clear_generation;
+
+    /** Delete table when a table was empty for this number of passes
+     * (0 = never). */
+    uint16_t delete_generation;
+
+    /** Free entity index pages that have no alive entities. This forgets the
+     * generation of ids on those pages, and invalidates ecs_record_t pointers
+     * and refs for entities that are no longer alive. */
+    bool shrink_entity_index;
+} ecs_compact_desc_t;
+
+/** Incrementally free unused memory.
+ * This operation does the same kind of cleanup as ecs_shrink(), but spreads
+ * it out over multiple calls so that it can run each frame without causing
+ * a hitch. A compaction pass consists of the following phases:
+ * - Shrink tables that use at most half of their capacity, leaving room for
+ *   half of the table count to be added without growing the table. Clear or
+ *   delete tables that stayed empty for the configured generations.
+ * - Free unused capacity of the table storage and entity index, and 
+ *   optionally free entity index pages without alive entities.
+ * - Release the blocks of world and stage block allocators that have no 
+ *   outstanding allocations.
+ *
+ * When the time budget is exceeded the operation returns, and the next call
+ * continues where the previous call left off. Time is measured between 
+ * tables and allocators, so a single large table or allocator can exceed the
+ * budget.
+ *
+ * This operation cannot be called while the world is in readonly or deferred
+ * mode. The number of reclaimed bytes is added to the compact_reclaimed_total
+ * member of ecs_world_info_t, and reported by the stats addon.
+ *
+ * @param world The world.
+ * @param desc Configuration parameters.
+ * @return The number of bytes reclaimed by this call.
+ * 
+ * @see ecs_set_compaction()
+ */
+FLECS_API
+int64_t ecs_compact(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc);
+
+/** Run compaction at the end of each frame.
+ * When set, ecs_frame_end() (called by ecs_progress()) calls ecs_compact() 
+ * with the provided parameters. The time budget applies to each frame.
+ *
+ * @param world The world.
+ * @param desc Configuration parameters, or NULL to disable compaction.
+ */
+FLECS_API
+void ecs_set_compaction(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc);
+
 /** Get the world from a poly.
  *
  * @param poly A pointer to a poly object.
@@ -8018,6 +8310,15 @@ ecs_entity_t ecs_entity_init(
  * that is owned by the application, and then use this array to populate the
  * entities.
  *
+ * When the parallel option is set and the world has worker threads, the
+ * operation allocates ids and grows the table columns on the calling thread,
+ * after which the main and worker threads each construct and initialize a
+ * range of the new component values. OnAdd and OnSet hooks and observers, and
+ * components that are not stored in table columns, are handled on the calling
+ * thread once for the entire batch. Entities that inherit components
+ * are always initialized on the calling thread. The operation cannot be
+ * called while a pipeline is running.
+ *
  * @param world The world.
  * @param desc Bulk creation parameters.
  * @return An array with the list of entity IDs created or populated.
@@ -8365,6 +8666,33 @@ FLECS_ALWAYS_INLINE const void* ecs_get_id(
     ecs_entity_t entity,
     ecs_id_t component);
 
+/** Get immutable pointers to a component for multiple entities.
+ * This operation returns the same pointers as calling ecs_get_id() for each 
+ * entity, but is faster when looking up a component for many entities that 
+ * are not stored next to each other, such as relationship targets. The 
+ * lookups are pipelined, so that entity index records are fetched ahead of the
+ * entity that is being resolved, and component values are prefetched before 
+ * they are returned.
+ *
+ * All entities must be alive. If an entity does not have the component, its
+ * pointer is set to NULL. The ptrs_out array must have at least count elements.
+ *
+ * @param world The world.
+ * @param entities The entities for which to get the component.
+ * @param count The number of entities.
+ * @param component The component to get.
+ * @param ptrs_out Array that receives the component pointers.
+ *
+ * @see ecs_get_id()
+ */
+FLECS_API
+void ecs_get_many_id(
+    const ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t component,
+    const void **ptrs_out);
+
 /** Get a mutable pointer to a component.
  * This operation obtains a mutable pointer to the requested component. The
  * operation accepts the component entity ID.
@@ -10243,6 +10571,58 @@ const ecs_query_group_info_t* ecs_query_get_group_info(
     const ecs_query_t *query,
     uint64_t group_id);
 
+/** Used with ecs_query_propagate(). */
+typedef struct ecs_query_propagate_desc_t {
+    /** Callback invoked for the results of a hierarchy depth. */
+    ecs_iter_action_t callback;
+
+    /** Context passed to the callback (ecs_iter_t::ctx). */
+    void *ctx;
+
+    /** Distribute the results of each depth across worker threads. */
+    bool multi_threaded;
+} ecs_query_propagate_desc_t;
+
+/** Propagate values down a hierarchy with a cascade query.
+ * This operation invokes a callback for the results of a query with a cascade
+ * term one hierarchy depth at a time, which makes it possible to compute values
+ * that depend on the value of the parent, like a world transform. All results
+ * of a depth are processed before the results of the next depth.
+ *
+ * When multi_threaded is enabled and the world has worker threads, the results
+ * of each depth are distributed across the worker threads. Large results are
+ * split up, whereas small results (for example the per-entity results of 
+ * non-fragmenting hierarchies) are assigned to a single thread. The callback
+ * may only write component values of the iterated entities, and must not add
+ * or remove components.
+ *
+ * When the query was created with EcsQueryDetectChanges, results are skipped 
+ * when none of the fields read by the query changed since the last time it was
+ * propagated, and the parent of the result was not propagated in the same 
+ * call. This means that subtrees with unchanged inputs are skipped. Fields
+ * that are computed by the callback should be annotated as [out], so that
+ * writing them doesn't cause the results to be processed again.
+ *
+ * Example query for a transform system:
+ * 
+ * @code
+ * [out] WorldTransform(self), [in] LocalTransform(self), 
+ * [in] ?WorldTransform(cascade)
+ * @endcode
+ *
+ * The query must be cached, and the cascade term must use ascending order.
+ *
+ * @param world The world.
+ * @param query The query.
+ * @param desc Propagation parameters.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_query_propagate(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    const ecs_query_propagate_desc_t *desc);
+
 /** Struct returned by ecs_query_count(). */
 typedef struct ecs_query_count_t {
     int32_t results;      /**< Number of results returned by the query. */
@@ -10384,6 +10764,37 @@ const ecs_observer_t* ecs_observer_get(
     const ecs_world_t *world,
     ecs_entity_t observer);
 
+/** Deliver the events stored by a coalesced observer.
+ * This invokes the observer callback for the entities for which the observer
+ * received events since the last flush. Each entity receives at most one
+ * event of each kind, which is determined by the events that were received and
+ * whether the entity still matches the observer:
+ *
+ * - OnAdd, if the first received event was an OnAdd and the entity matches.
+ * - OnSet, if the entity matches and received an OnSet.
+ * - OnRemove, if the first received event was not an OnAdd, the entity
+ *   received an OnRemove and the entity no longer matches.
+ *
+ * An entity that was removed and added again is delivered as an OnSet if the
+ * observer observes OnSet, and as an OnRemove followed by an OnAdd otherwise.
+ *
+ * An entity only receives events that the observer observes.
+ *
+ * Events are delivered in batches of adjacent entities in the same table.
+ * Operations in the observer callback are deferred until the flush has
+ * completed. Events emitted by those operations are delivered by the next
+ * flush. If the observer is multi_threaded and the world has worker threads,
+ * the batches of different tables are delivered in parallel.
+ *
+ * @param world The world.
+ * @param observer The observer.
+ * @return The number of events delivered, counted per entity.
+ */
+FLECS_API
+int32_t ecs_observer_flush(
+    ecs_world_t *world,
+    ecs_entity_t observer);
+
 /** @} */
 
 /**
@@ -10724,6 +11135,15 @@ bool ecs_page_next(
  * stable between queries. Two queries that match the same table are guaranteed
  * to match the same entities in that table.
  *
+ * When the source iterator is a query iterator for a query that only matches
+ * sparse components, the source iterator only iterates the part of the sparse
+ * storage that belongs to the resource. The iterator must not have been 
+ * progressed before the worker iterator is created.
+ *
+ * When the source iterator is a query iterator for an uncached query with the
+ * EcsQueryPartitionTables flag, matched tables are divided across resources
+ * instead, and each table is iterated by a single resource.
+ *
  * The iterator must be iterated with ecs_worker_next().
  *
  * A worker iterator acts as a passthrough for data exposed by the parent
@@ -10751,6 +11171,49 @@ FLECS_API
 bool ecs_worker_next(
     ecs_iter_t *it);
 
+/** Create a dynamic worker iterator.
+ * Dynamic worker iterators divide matched entities across resources (usually
+ * threads) by splitting query results into chunks of at most chunk_size
+ * entities. Resources claim chunks from a counter that is shared between all
+ * iterators, so that a resource that finishes early continues with chunks that
+ * would otherwise have been processed by a busier resource.
+ *
+ * Each resource must create its iterator from an iterator that returns the 
+ * same results in the same order (typically an iterator for the same query).
+ * The shared cursor must be set to 0 before any of the resources start
+ * iterating, and must not be reset until all resources are done.
+ *
+ * Unlike ecs_worker_iter(), the distribution of entities across resources is
+ * not stable between queries or runs.
+ *
+ * Queries that only match sparse components claim chunks directly from their
+ * sparse storage. Uncached queries with the EcsQueryPartitionTables flag claim
+ * tables, which are returned in chunks of at most chunk_size entities to the
+ * resource that claimed the table.
+ *
+ * The iterator must be iterated with ecs_dynamic_worker_next().
+ *
+ * @param it The source iterator.
+ * @param cursor Chunk counter shared between all resources.
+ * @param chunk_size The maximum number of entities in a chunk.
+ * @return A dynamic worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_dynamic_worker_iter(
+    const ecs_iter_t *it,
+    int32_t *cursor,
+    int32_t chunk_size);
+
+/** Progress a dynamic worker iterator.
+ * Progress an iterator created by ecs_dynamic_worker_iter().
+ *
+ * @param it The iterator.
+ * @return True if the iterator has more results, false if not.
+ */
+FLECS_API
+bool ecs_dynamic_worker_next(
+    ecs_iter_t *it);
+
 /** Get data for a field.
  * This operation retrieves a pointer to an array of data that belongs to the
  * term in the query. The index refers to the location of the term in the query,
@@ -11066,6 +11529,21 @@ size_t ecs_table_get_column_size(
     const ecs_table_t *table,
     int32_t index);
 
+/** Get the column alignment from a table.
+ * This operation returns the alignment that is guaranteed for the component
+ * array returned by ecs_table_get_column() for the provided index. This is
+ * the largest of the component alignment and the column alignment that was
+ * configured with ecs_set_column_alignment() when the table was created.
+ *
+ * @param table The table.
+ * @param index The column index.
+ * @return The column alignment, or 0 if the index is not a component.
+ */
+FLECS_API
+int32_t ecs_table_get_column_alignment(
+    const ecs_table_t *table,
+    int32_t index);
+
 /** Return the number of entities in the table.
  * This operation returns the number of entities in the table.
  *
@@ -11853,6 +12331,11 @@ void ecs_table_clear_entities(
 #define ecs_get(world, entity, T)\
     (ECS_CAST(const T*, ecs_get_id(world, entity, ecs_id(T))))
 
+/** Get a component for multiple entities. */
+#define ecs_get_many(world, entities, count, T, ptrs_out)\
+    ecs_get_many_id(world, entities, count, ecs_id(T),\
+        ECS_CAST(const void**, ptrs_out))
+
 /** Get the first element of a pair. */
 #define ecs_get_pair(world, subject, First, second)\
     (ECS_CAST(const First*, ecs_get_id(world, subject,\
@@ -12457,6 +12940,9 @@ void ecs_table_clear_entities(
 #ifdef FLECS_NO_UNITS
 #undef FLECS_UNITS
 #endif
+#ifdef FLECS_NO_SNAPSHOT
+#undef FLECS_SNAPSHOT
+#endif
 #ifdef FLECS_NO_JSON
 #undef FLECS_JSON
 #endif
@@ -14242,6 +14728,51 @@ FLECS_API
 bool ecs_using_task_threads(
     ecs_world_t *world);
 
+/** Set how worker threads wait on each other.
+ * By default threads that wait for a pipeline operation to start or finish
+ * block on a condition variable. For applications that run many sync points
+ * per frame, the latency of waking up a blocked thread can add up.
+ *
+ * When spin_count and/or yield_count are set, a waiting thread first polls
+ * for spin_count iterations, then yields its time slice for yield_count
+ * iterations, before blocking on the condition variable. This reduces wake up
+ * latency at the cost of CPU time spent waiting.
+ *
+ * The setting is applied to threads created with ecs_set_threads() as well as
+ * ecs_set_task_threads(). Setting both values to 0 restores the default.
+ *
+ * @param world The world.
+ * @param spin_count The number of iterations to poll before yielding.
+ * @param yield_count The number of times to yield before blocking.
+ */
+FLECS_API
+void ecs_set_worker_spin(
+    ecs_world_t *world,
+    int32_t spin_count,
+    int32_t yield_count);
+
+/** Enable or disable merging commands in parallel.
+ * By default the commands enqueued by worker threads are merged by the main
+ * thread, one stage after another. When parallel merging is enabled, the 
+ * threads of a multithreaded sync point first partition the enqueued commands
+ * by entity, after which each thread moves the values of set/ensure commands
+ * in one partition into component storage.
+ * 
+ * This is only done for entities for which all enqueued commands assign 
+ * components the entity already has. Commands for other entities are handled
+ * by the merge on the main thread in the order in which they were enqueued.
+ * If any of the enqueued commands has hooks or observers, all commands are
+ * merged by the main thread, as hooks and observers could otherwise see values
+ * of commands that were enqueued after the command that invoked them.
+ * 
+ * @param world The world.
+ * @param enable Whether to enable parallel merging.
+ */
+FLECS_API
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Module
 ////////////////////////////////////////////////////////////////////////////////
@@ -14364,6 +14895,14 @@ typedef struct ecs_system_desc_t {
     /** If true, the system will be run on multiple threads. */
     bool multi_threaded;
 
+    /** If set, a multithreaded system that is run by a pipeline splits its 
+     * matched entities into chunks of at most chunk_size entities, which are
+     * claimed dynamically by worker threads that are done with their previous
+     * chunk. This balances work across threads when tables have very different
+     * sizes or when entities take different amounts of time to process. If not
+     * set, each table is divided equally between worker threads. */
+    int32_t chunk_size;
+
     /** If true, the system will have access to the actual world. Cannot be true at the
      * same time as multi_threaded. */
     bool immediate;
@@ -14428,6 +14967,12 @@ typedef struct ecs_system_t {
     /** Whether the system is multithreaded. */
     bool multi_threaded;
 
+    /** See ecs_system_desc_t. */
+    int32_t chunk_size;
+
+    /** Chunk counter shared by worker threads (if chunk_size is set). */
+    int32_t chunk_cursor;
+
     /** Whether the system is run in immediate mode. */
     bool immediate;
 
@@ -14774,6 +15319,9 @@ typedef struct ecs_world_stats_t {
         ecs_metric_t stack_alloc_count;    /**< Page allocations per frame. */
         ecs_metric_t stack_free_count;     /**< Page frees per frame. */
         ecs_metric_t stack_outstanding_alloc_count; /**< Difference between allocs and frees. */
+
+        /* Compaction data */
+        ecs_metric_t compact_reclaimed_bytes; /**< Bytes reclaimed by ecs_compact() per frame. */
     } memory;
 
     /* HTTP statistics */
@@ -14823,6 +15371,7 @@ typedef struct ecs_sync_stats_t {
     int64_t first_;                /**< Used for field iteration. Do not set. */
     ecs_metric_t time_spent;       /**< Time spent in sync point. */
     ecs_metric_t commands_enqueued; /**< Number of commands enqueued. */
+    ecs_metric_t wait_time;        /**< Time spent waiting for worker threads. */
     int64_t last_;                 /**< Used for field iteration. Do not set. */
 
     int32_t system_count;          /**< Number of systems before sync point. */
@@ -15799,6 +16348,289 @@ void FlecsAlertsImport(
 
 #endif
 
+#ifdef FLECS_SNAPSHOT
+#ifdef FLECS_NO_SNAPSHOT
+#error "FLECS_NO_SNAPSHOT failed: SNAPSHOT is required by other addons"
+#endif
+
+#ifdef FLECS_SNAPSHOT
+
+#ifndef FLECS_JSON
+#define FLECS_JSON
+#endif
+
+#ifndef FLECS_SNAPSHOT_H
+#define FLECS_SNAPSHOT_H
+
+/**
+ * @defgroup c_addons_snapshot Snapshot
+ * @ingroup c_addons
+ * Binary world snapshots.
+ *
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of the binary snapshot format. Snapshots with a different version
+ * cannot be restored. */
+#define ECS_SNAPSHOT_VERSION (1)
+
+/** Serialize world to a binary snapshot.
+ * This operation serializes all entities that are not builtin or part of a
+ * module, together with their component data. The format stores each table as
+ * a block that contains the table type, the entity ids and the table columns.
+ *
+ * Columns of components without lifecycle hooks are stored as raw bytes. Values
+ * of components with hooks are stored using their reflection data, which means
+ * that values of components with hooks but without reflection data are not
+ * stored. Entity names, symbols and aliases are stored as strings.
+ *
+ * The snapshot stores component ids, names and sizes, but does not store the
+ * component entities themselves. A snapshot can only be restored in a world
+ * that registered the same components with the same ids, for example by
+ * importing the same modules in the same order. Values of components that do
+ * not fragment tables (DontFragment) and the enabled state of toggled
+ * components are not stored.
+ *
+ * The format uses the native byte order and pointer size of the platform, and
+ * cannot be restored on a platform with a different byte order or pointer
+ * size.
+ *
+ * Snapshot sizes are stored as ecs_size_t, which limits the size of a snapshot
+ * to 2GB. The operation fails if the serialized world exceeds this size.
+ *
+ * The returned buffer must be freed with ecs_os_free().
+ *
+ * @param world The world.
+ * @param size_out Out parameter for the size of the snapshot in bytes.
+ * @return The snapshot data, or NULL if failed.
+ */
+FLECS_API
+void* ecs_world_to_binary(
+    const ecs_world_t *world,
+    ecs_size_t *size_out);
+
+/** Restore entities from a binary snapshot.
+ * This operation restores entities and component values from a snapshot that
+ * was created with ecs_world_to_binary(). Entities are restored with the ids
+ * (including generation) they had when the snapshot was taken.
+ *
+ * Before the world is modified, the operation verifies that the snapshot was
+ * created with a compatible version and platform, that the components in the
+ * snapshot have the same id, name and size in the world, and that none of the
+ * snapshot entities is alive in the world with a different generation.
+ *
+ * Entities in the snapshot that are not alive in the world are created in bulk:
+ * for each table in the snapshot the entities are added to the table at once,
+ * after which each raw column is copied directly from the snapshot data. This
+ * means that the snapshot data can be read from a memory-mapped file, without
+ * first copying or parsing it. Entities that are already alive are restored
+ * with regular add/set operations.
+ *
+ * Restoring a snapshot does not instantiate prefab hierarchies for instances,
+ * as instance children are part of the snapshot.
+ *
+ * @param world The world.
+ * @param data The snapshot data.
+ * @param size The size of the snapshot data.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_world_from_binary(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size);
+
+/** Same as ecs_world_from_binary(), but loads the snapshot from a file.
+ *
+ * @param world The world.
+ * @param filename The file from which to load the snapshot.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_world_from_binary_file(
+    ecs_world_t *world,
+    const char *filename);
+
+/** Replicator that produces binary diffs for the entities matched by a query.
+ * A replicator keeps track of the state that a client has acknowledged, so
+ * that each diff only contains what changed since that state. */
+typedef struct ecs_replicator_t ecs_replicator_t;
+
+/** Create a replicator.
+ * The replicator produces diffs for the entities matched by the query. The
+ * diffs contain all (non-builtin) ids of the tables matched by the query, not
+ * just the ids of the query fields. The query must outlive the replicator.
+ *
+ * @param world The world.
+ * @param query The query that selects the entities to replicate.
+ * @return The replicator.
+ */
+FLECS_API
+ecs_replicator_t* ecs_replicator_new(
+    ecs_world_t *world,
+    ecs_query_t *query);
+
+/** Free a replicator.
+ *
+ * @param replicator The replicator.
+ */
+FLECS_API
+void ecs_replicator_free(
+    ecs_replicator_t *replicator);
+
+/** Create a diff since the last acknowledged frame.
+ * A diff contains:
+ * - the entities that were deleted or no longer match the query
+ * - all ids and values of entities that are new, or that moved to a different
+ *   table (for example because a component was added)
+ * - the changed columns of entities that did not move to a different table
+ *
+ * Changes are detected with the same per-column change counters that are used
+ * by ecs_query_changed(). A column is changed when it is written by a set or
+ * modified operation, or by a query that writes the component. Values that are
+ * written without marking them as modified are not detected. Sparse components
+ * are always treated as changed. Values are encoded in the same way as in a
+ * binary snapshot.
+ *
+ * Each diff is relative to the last frame that was acknowledged with
+ * ecs_replicator_ack(). If no frame was acknowledged, the diff contains all
+ * matched entities. Applying a diff that was created after the diff that was
+ * last applied, but before it was acknowledged, is valid.
+ *
+ * The returned buffer must be freed with ecs_os_free().
+ *
+ * @param replicator The replicator.
+ * @param size_out Out parameter for the size of the diff in bytes.
+ * @param frame_out Out parameter for the frame of the diff (optional).
+ * @return The diff data, or NULL if failed.
+ */
+FLECS_API
+void* ecs_replicator_diff(
+    ecs_replicator_t *replicator,
+    ecs_size_t *size_out,
+    uint64_t *frame_out);
+
+/** Acknowledge a frame.
+ * Subsequent diffs will only contain changes since the acknowledged frame.
+ * Any frame returned by ecs_replicator_diff() that is newer than the last
+ * acknowledged frame can be acknowledged, so that a client with latency can
+ * acknowledge a frame while newer diffs are in flight. Acknowledging a frame
+ * that is older than the last acknowledged frame does nothing. The replicator
+ * keeps the state of at most 64 unacknowledged frames, older frames can no
+ * longer be acknowledged.
+ *
+ * @param replicator The replicator.
+ * @param frame The frame that was applied by the client.
+ */
+FLECS_API
+void ecs_replicator_ack(
+    ecs_replicator_t *replicator,
+    uint64_t frame);
+
+/** Apply a diff that was created with ecs_replicator_diff().
+ * Deleted entities are deleted, new entities are created in bulk in the same
+ * way as ecs_world_from_binary() restores entities. Existing entities that
+ * moved to a different table get the ids of the new table, and lose the ids
+ * that are no longer in their table. Changed values are assigned with set
+ * operations, which invokes OnSet hooks and observers.
+ *
+ * The same restrictions as for ecs_world_from_binary() apply: components must
+ * be registered with the same ids and sizes as in the source world.
+ *
+ * @param world The world.
+ * @param data The diff data.
+ * @param size The size of the diff data.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_world_apply_diff(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size);
+
+/** In-memory copy of the state of a world that the world can be restored to.
+ * Forks share copies of table columns that didn't change between forks. */
+typedef struct ecs_world_fork_t ecs_world_fork_t;
+
+/** Fork the world.
+ * A fork stores the entities and component values of the same tables that are
+ * stored by ecs_world_to_binary(). The operation copies the entity ids and
+ * component values of each table, except for columns that did not change
+ * since the previous fork was created. Those columns share the copy of the
+ * previous fork. When forks are created each frame, the cost of a fork is
+ * proportional to the number of tables plus the size of the columns that
+ * changed in that frame.
+ *
+ * Changes are detected with the same per-column change counters as used by
+ * ecs_replicator_diff(). While a fork exists, the columns of components that
+ * are returned by ecs_ensure(), ecs_get_mut() and ecs_emplace() are marked as
+ * changed, so that values written through these pointers are restored even if
+ * the application doesn't call ecs_modified(). Pointers must not be kept
+ * across a fork, and values written through other pointers (such as refs)
+ * must be marked as modified. Values of components that are stored outside
+ * of table columns (sparse, DontFragment) and the enabled state of toggled
+ * components are not stored.
+ *
+ * Tables that are deleted after the fork was created are recreated when the
+ * fork is restored. Forks must be freed before the world is deleted.
+ *
+ * @param world The world.
+ * @param prev A previous fork of the same world to share column copies with
+ *             (optional).
+ * @return The fork.
+ */
+FLECS_API
+ecs_world_fork_t* ecs_world_fork(
+    ecs_world_t *world,
+    const ecs_world_fork_t *prev);
+
+/** Restore the world to the state of a fork.
+ * This discards all changes made to the forked tables since the fork was
+ * created. Entities created after the fork are deleted, entities that were
+ * deleted are recreated with the same id, and entities that changed tables
+ * are moved back to their table. These structural changes emit OnAdd and
+ * OnRemove events. The values of columns that changed are then copied back
+ * without emitting OnSet events. Names and Parent components are assigned
+ * with regular set operations, so that lookup indices remain valid.
+ *
+ * The cost of a restore is proportional to the number of tables plus the
+ * columns and entities that changed. A fork can be restored more than once.
+ * Keeping the changes instead (commit) only requires freeing the fork.
+ *
+ * Entity ids that were recycled after the fork was created are not restored,
+ * which means that entities created after a restore can get different ids than
+ * the entities created after the fork.
+ *
+ * @param fork The fork to restore.
+ */
+FLECS_API
+void ecs_world_fork_restore(
+    const ecs_world_fork_t *fork);
+
+/** Free a fork.
+ *
+ * @param fork The fork to free.
+ */
+FLECS_API
+void ecs_world_fork_free(
+    ecs_world_fork_t *fork);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @} */
+
+#endif
+
+#endif
+
 #ifdef FLECS_JSON
 #ifdef FLECS_NO_JSON
 #error "FLECS_NO_JSON failed: JSON is required by other addons"
@@ -20541,6 +21373,12 @@ static const flecs::entity_t Sparse = EcsSparse;
 /** DontFragment storage tag. */
 static const flecs::entity_t DontFragment = EcsDontFragment;
 
+/** Structure-of-arrays storage tag. */
+static const flecs::entity_t SoA = EcsSoA;
+
+/** Dense toggle storage tag. */
+static const flecs::entity_t DenseToggle = EcsDenseToggle;
+
 /** PredEq query predicate. */
 static const flecs::entity_t PredEq = EcsPredEq;
 /** PredMatch query predicate. */
@@ -25444,6 +26282,16 @@ struct world {
         ecs_dim(world_, entity_count);
     }
 
+    /** Set the minimum alignment of component columns in new tables.
+     *
+     * @param alignment The alignment (a power of two, or 0 for default).
+     *
+     * @see ecs_set_column_alignment()
+     */
+    void set_column_alignment(int32_t alignment) const {
+        ecs_set_column_alignment(world_, alignment);
+    }
+
     /** Create a new entity id range.
      * @see ecs_entity_range_new()
      */
@@ -25635,6 +26483,33 @@ struct world {
     template <typename Func, if_t< is_callable<Func>::value > = 0 >
     void get(const Func& func) const;
 
+    /* get_many */
+
+    /** Get component for multiple entities.
+     * Pointers are set to nullptr for entities that don't have the component.
+     *
+     * @see ecs_get_many_id()
+     */
+    void get_many(flecs::id_t id, const flecs::entity_t *entities, 
+        size_t count, const void **out) const;
+
+    /** Get component for multiple entities.
+     * Pointers are set to nullptr for entities that don't have the component.
+     *
+     * @see ecs_get_many_id()
+     */
+    template <typename T>
+    void get_many(const flecs::entity_t *entities, size_t count, 
+        const T **out) const;
+
+    /** Get component for an array of entities.
+     *
+     * @see ecs_get_many_id()
+     */
+    template <typename T, size_t N>
+    void get_many(const flecs::entity_t (&entities)[N], 
+        const T* (&out)[N]) const;
+
     /* try_get_mut */
 
     /** Get mutable singleton component.
@@ -26603,6 +27478,16 @@ void set_task_threads(int32_t task_threads) const;
  */
 bool using_task_threads() const;
 
+/** Set how worker threads wait on each other.
+ * @see ecs_set_worker_spin()
+ */
+void set_worker_spin(int32_t spin_count, int32_t yield_count = 0) const;
+
+/** Enable or disable merging commands in parallel.
+ * @see ecs_set_parallel_merge()
+ */
+void set_parallel_merge(bool enable = true) const;
+
 /** @} */
 
 #   endif
@@ -31751,6 +32636,97 @@ public:
     Func func_;
 };
 
+// Type that handles passing whole columns to batched each callbacks.
+template <typename Func, typename ... Components>
+struct each_batch_delegate : public delegate {
+    using Terms = typename field_ptrs<Components ...>::array;
+
+    template < if_not_t< is_same< decay_t<Func>, decay_t<Func>& >::value > = 0>
+    explicit each_batch_delegate(Func&& func) noexcept
+        : func_(FLECS_MOV(func)) { }
+
+    explicit each_batch_delegate(const Func& func) noexcept
+        : func_(func) { }
+
+    // Invoke object directly. This operation is useful when the calling
+    // function has just constructed the delegate, such as what happens when
+    // iterating a query.
+    void invoke(ecs_iter_t *iter) const {
+        field_ptrs<Components...> terms;
+
+        iter->flags |= EcsIterCppEach;
+
+        size_t count = static_cast<size_t>(iter->count);
+        if (count == 0 && !iter->table) {
+            // If the query has no This terms, count can be 0. Pass through
+            // components as a batch with a single element.
+            count = 1;
+        }
+
+        ECS_TABLE_LOCK(iter->world, iter->table);
+
+        if (iter->ref_fields | iter->up_fields) {
+            // Fields that are not owned by the iterated entities don't point
+            // to an array with a value per entity. Pass the values for each
+            // entity as a batch with a single element.
+            terms.populate(iter);
+            for (size_t i = 0; i < count; i ++) {
+                invoke_callback(iter, 1, i, terms.fields_,
+                    std::index_sequence_for<Components...>{});
+            }
+        } else {
+            terms.populate_self(iter);
+            invoke_callback(iter, count, 0, terms.fields_,
+                std::index_sequence_for<Components...>{});
+        }
+
+        ECS_TABLE_UNLOCK(iter->world, iter->table);
+    }
+
+    // Static function that can be used as callback for systems/observers.
+    static void run(ecs_iter_t *iter) {
+        auto self = static_cast<const each_batch_delegate*>(iter->callback_ctx);
+        ecs_assert(self != nullptr, ECS_INTERNAL_ERROR, nullptr);
+        self->invoke(iter);
+    }
+
+private:
+    // Get pointer to the first element of the batch for a field.
+    template <typename T, typename A = base_arg_type_t<T>>
+    static A* get_ptr(const ecs_iter_t *iter, const _::field_ptr& field,
+        size_t row)
+    {
+        if (field.is_row) {
+            return static_cast<A*>(ecs_field_at_w_size(iter, sizeof(A),
+                field.index, static_cast<int32_t>(row)));
+        }
+
+        if (!field.ptr) {
+            // Optional field that isn't set, or a tag.
+            return nullptr;
+        }
+
+        if (field.is_ref) {
+            return static_cast<A*>(field.ptr);
+        }
+
+        return &static_cast<A*>(field.ptr)[row];
+    }
+
+    // func(size_t count, Components* ...)
+    template <size_t... Is>
+    void invoke_callback(const ecs_iter_t *iter, size_t count, size_t row,
+        Terms& fields, std::index_sequence<Is...>) const
+    {
+        (void)iter; (void)row; (void)fields;
+        func_(count, get_ptr< remove_reference_t<Components> >(
+            iter, fields[Is], row)...);
+    }
+
+public:
+    Func func_;
+};
+
 template <typename Func, typename T>
 struct validate_delegate : public delegate {
     template < if_not_t< is_same< decay_t<Func>, decay_t<Func>& >::value > = 0>
@@ -34000,6 +34976,15 @@ struct table {
         return ecs_table_get_column_size(table_, index);
     }
 
+    /** Get the column alignment.
+     *
+     * @param index The column index.
+     * @return The alignment that is guaranteed for the column's array.
+     */
+    int32_t column_alignment(int32_t index) const {
+        return ecs_table_get_column_alignment(table_, index);
+    }
+
     /** Get the depth for a given relationship.
      *
      * @param rel The relationship.
@@ -34160,6 +35145,30 @@ struct iterable {
         }
     }
 
+    /** Batched each iterator.
+     * The "each_batch" iterator accepts a function that is invoked once for
+     * each matched table (or table slice) with pointers to the first element
+     * of the component arrays. This lets the callback process components in a
+     * tight loop that the compiler can vectorize. The following function
+     * signature is valid:
+     *  - func(size_t count, Components* ...)
+     *
+     * When a field is not owned by the iterated entities (for example when it
+     * is matched on a parent), the function is invoked for each entity with a
+     * count of 1. Optional fields that are not set and tags are passed as
+     * nullptr.
+     *
+     * @param func The callback function.
+     */
+    template <typename Func>
+    void each_batch(Func&& func) const {
+        ecs_iter_t it = this->get_iter(nullptr);
+        ecs_iter_next_action_t next = this->next_action();
+        while (next(&it)) {
+            _::each_batch_delegate<Func, Components...>(func).invoke(&it);
+        }
+    }
+
     /** Run the iterator.
      * The "run" callback accepts a function that is invoked once for a query
      * with a valid iterator. The following signature is valid:
@@ -35584,6 +36593,18 @@ struct query_builder_i : term_builder_i<Base> {
         return *this;
     }
 
+    /** Order terms by their estimated number of matched tables. */
+    Base& plan_by_cost() {
+        desc_->flags |= EcsQueryPlanByCost;
+        return *this;
+    }
+
+    /** Distribute tables across workers for worker iterators. */
+    Base& partition_tables() {
+        desc_->flags |= EcsQueryPartitionTables;
+        return *this;
+    }
+
     /** Set the query expression string. */
     Base& expr(const char *expr) {
         ecs_check(expr_count_ == 0, ECS_INVALID_OPERATION,
@@ -36529,6 +37550,17 @@ public:
         return T(world_, &desc_);
     }
 
+    template <typename Func>
+    T each_batch(Func&& func) {
+        using Delegate = typename _::each_batch_delegate<
+            typename std::decay<Func>::type, Components...>;
+        auto ctx = FLECS_NEW(Delegate)(FLECS_FWD(func));
+        desc_.callback = Delegate::run;
+        desc_.callback_ctx = ctx;
+        desc_.callback_ctx_free = _::free_obj<Delegate>;
+        return T(world_, &desc_);
+    }
+
     template <typename Func>
     T run_each(Func&& func) {
         using Delegate = typename _::each_delegate<
@@ -36597,6 +37629,29 @@ struct observer_builder_i : query_builder_i<Base, Components ...> {
         return *this;
     }
 
+    /** Coalesce events, and deliver them when the observer is flushed.
+     * OnRemove events for coalesced observers don't have field data, which
+     * means they can't be used with each() callbacks that have components.
+     *
+     * @param phase Pipeline phase in which the observer is flushed (optional).
+     * @see ecs_observer_desc_t::coalesce
+     */
+    Base& coalesce(flecs::entity_t phase = 0) {
+        desc_->coalesce = true;
+        desc_->coalesce_phase = phase;
+        return *this;
+    }
+
+    /** Deliver the events of a coalesced observer on multiple threads.
+     *
+     * @param value If false, events are delivered on the flushing thread.
+     * @see ecs_observer_desc_t::multi_threaded
+     */
+    Base& multi_threaded(bool value = true) {
+        desc_->multi_threaded = value;
+        return *this;
+    }
+
     /** Set the observer flags. */
     Base& observer_flags(ecs_flags32_t flags) {
         desc_->flags_ |= flags;
@@ -36717,6 +37772,15 @@ struct observer final : entity
         return run_each_callback(CallbackComponents{}, FLECS_FWD(func));
     }
 
+    /** Deliver the events stored by a coalesced observer.
+     *
+     * @return The number of entities for which events were delivered.
+     * @see ecs_observer_flush()
+     */
+    int32_t flush() const {
+        return ecs_observer_flush(world_, id_);
+    }
+
     /** Get the query for this observer. */
     flecs::query<> query() const {
         return flecs::query<>(ecs_observer_get(world_, id_)->query);
@@ -37056,6 +38120,18 @@ public:
         return *this;
     }
 
+    /** Specify the chunk size for distributing entities across threads.
+     * When set, worker threads dynamically claim chunks of at most the
+     * specified number of entities, instead of each processing an equal
+     * part of each table.
+     *
+     * @param value The maximum number of entities in a chunk.
+     */
+    Base& chunk_size(int32_t value) {
+        desc_->chunk_size = value;
+        return *this;
+    }
+
     /** Specify whether the system should be run in an immediate (non-staged) context.
      *
      * @param value If false, the system will always run staged.
@@ -37658,6 +38734,17 @@ inline bool world::using_task_threads() const {
     return ecs_using_task_threads(world_);
 }
 
+inline void world::set_worker_spin(
+    int32_t spin_count, 
+    int32_t yield_count) const 
+{
+    ecs_set_worker_spin(world_, spin_count, yield_count);
+}
+
+inline void world::set_parallel_merge(bool enable) const {
+    ecs_set_parallel_merge(world_, enable);
+}
+
 }
 
 #endif
@@ -39345,6 +40432,30 @@ const First& world::get(Second second) const {
     return e.get<First>(second);
 }
 
+/** Get a component by ID for multiple entities. */
+inline void world::get_many(flecs::id_t id, const flecs::entity_t *entities, 
+    size_t count, const void **out) const 
+{
+    ecs_get_many_id(world_, entities, static_cast<int32_t>(count), id, out);
+}
+
+/** Get a component for multiple entities. */
+template <typename T>
+inline void world::get_many(const flecs::entity_t *entities, size_t count, 
+    const T **out) const 
+{
+    ecs_get_many_id(world_, entities, static_cast<int32_t>(count),
+        _::type<T>::id(world_), reinterpret_cast<const void**>(out));
+}
+
+/** Get a component for an array of entities. */
+template <typename T, size_t N>
+inline void world::get_many(const flecs::entity_t (&entities)[N], 
+    const T* (&out)[N]) const 
+{
+    this->get_many<T>(entities, N, out);
+}
+
 /** Try to get a mutable singleton component by ID (returns nullptr if not found). */
 inline void* world::try_get_mut(flecs::id_t id) const {
     flecs::entity e(world_, id);
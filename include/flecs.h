@@ -242,6 +242,7 @@
 #define FLECS_SCRIPT         /**< Flecs entity notation language. */
 // #define FLECS_SCRIPT_MATH /**< Math functions for Flecs script (may require linking with libm). */
 // #define FLECS_SCRIPT_PLATFORM /**< Platform constants for Flecs script. */
+#define FLECS_SNAPSHOT       /**< Binary world snapshots. */
 #define FLECS_SYSTEM         /**< System support. */
 #define FLECS_STATS          /**< Track runtime statistics. */
 #define FLECS_TIMER          /**< Timer support. */
@@ -303,12 +304,53 @@
 #define FLECS_ENTITY_PAGE_BITS 10
 #endif
 
+/** @def FLECS_ENTITY_RESERVE_COUNT
+ * Minimum number of entity ids for which storage is reserved in the entity
+ * index when the world enters multithreaded mode. Stages claim blocks of ids
+ * from the entity index when they create entities, and creating up to this
+ * number of entities doesn't reallocate entity index storage. If more entities
+ * were created during the previous multithreaded phase, storage for twice that
+ * number is reserved. */
+#ifndef FLECS_ENTITY_RESERVE_COUNT
+#define FLECS_ENTITY_RESERVE_COUNT 1024
+#endif
+
+/** @def FLECS_BULK_PARALLEL_MIN_COUNT
+ * Minimum number of entities per worker thread for which ecs_bulk_init() with
+ * the parallel option splits up initialization across worker threads. Below
+ * this number, the cost of waking up worker threads exceeds the gains. */
+#ifndef FLECS_BULK_PARALLEL_MIN_COUNT
+#define FLECS_BULK_PARALLEL_MIN_COUNT 1024
+#endif
+
 /** @def FLECS_USE_OS_ALLOC
  * When enabled, Flecs will use the OS allocator provided in the OS API directly
  * instead of the built-in block allocator. This can decrease memory utilization
  * as memory will be freed more often, at the cost of decreased performance. */
 // #define FLECS_USE_OS_ALLOC
 
+/** @def FLECS_HUGE_PAGES
+ * When enabled, world and stage allocators carve the blocks of their block
+ * allocators from large slabs, and allocate large objects (such as table
+ * columns with many entities) directly from the OS. Slabs and large objects 
+ * are allocated with the page_alloc_ callback of the OS API, which in the 
+ * POSIX implementation maps memory that is backed by huge pages on Linux. This
+ * reduces TLB misses when iterating worlds with many entities. 
+ * 
+ * Slabs are allocated lazily by the thread that first uses an allocator, which
+ * means that with the default first-touch NUMA policy of the OS, the memory of
+ * a stage allocator is placed on the node of the thread that uses the stage.
+ * Applications can provide their own page_alloc_ callback to explicitly bind
+ * memory to a node. */
+// #define FLECS_HUGE_PAGES
+
+/** @def FLECS_HUGE_PAGE_SIZE
+ * Size of a slab when FLECS_HUGE_PAGES is enabled. Allocations that are at 
+ * least this large are directly allocated with the page_alloc_ callback. */
+#ifndef FLECS_HUGE_PAGE_SIZE
+#define FLECS_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
 /** @def FLECS_ID_DESC_MAX
  * Maximum number of IDs to add in ecs_entity_desc_t / ecs_bulk_desc_t. */
 #ifndef FLECS_ID_DESC_MAX
@@ -1129,6 +1171,11 @@ typedef struct ecs_bulk_desc_t {
                          * same time as 'data', the elements in the data array
                          * must correspond with the ids in the table's type. */
 
+    bool parallel;     /**< Construct and initialize component values on the
+                        * worker threads of the world (see ecs_set_threads()).
+                        * Constructors and copy/move hooks of the components
+                        * must be safe to run concurrently for different
+                        * values. */
 } ecs_bulk_desc_t;
 
 /** Used with ecs_component_init().
@@ -1309,6 +1356,43 @@ struct ecs_iter_t {
  */
 #define EcsQueryGroupByDesc           (1u << 10u)
 
+/** Order terms by their estimated number of matched tables.
+ * When this flag is set, the query planner starts evaluating queries from the
+ * terms that match the fewest tables, instead of evaluating terms in the order
+ * in which they appear in the query. Only terms with a fixed id and $this 
+ * source that don't use traversal are reordered, and terms are never reordered
+ * across optional terms.
+ * 
+ * The number of matched tables is estimated when the query is created. Terms 
+ * that are evaluated together by a single instruction are reordered each time
+ * the query is iterated, which means that these terms automatically follow 
+ * changes in the number of tables. The choices of the planner are shown by
+ * ecs_query_plan().
+ * 
+ * Using this flag can change the order in which results are returned. The flag
+ * has no effect for queries that are entirely cached.
+ * 
+ * \ingroup queries
+ */
+#define EcsQueryPlanByCost            (1u << 5u)
+
+/** Distribute tables across workers when iterating with worker iterators.
+ * By default, ecs_worker_iter() and ecs_dynamic_worker_iter() evaluate the
+ * entire query on each worker, and split up the entities of each result across
+ * workers. When this flag is set for an uncached query, the operation that
+ * finds the tables for $this is partitioned instead, so that each worker only
+ * evaluates the remaining query terms for its own tables. This reduces the
+ * cost of evaluating queries that match many tables, but each table is
+ * iterated by a single worker.
+ * 
+ * Queries that don't start with a $this term with a fixed or pair wildcard id
+ * fall back to splitting up entities. The flag has no effect for cached
+ * queries.
+ * 
+ * \ingroup queries
+ */
+#define EcsQueryPartitionTables       (1u << 0u)
+
 
 /** Used with ecs_query_init().
  * 
@@ -1410,6 +1494,37 @@ typedef struct ecs_observer_desc_t {
      * ecs_observer_init() will not return an entity handle. */
     bool global_observer;
 
+    /** Coalesce events. Instead of invoking the callback when an event is
+     * emitted, the observer stores the entities for which it received events,
+     * and delivers them when the observer is flushed with ecs_observer_flush().
+     * Repeated events for the same entity are delivered once, and an OnAdd
+     * followed by an OnRemove for the same entity cancel out. Events are
+     * delivered in batches of adjacent entities in the same table, with the
+     * component values at the time of the flush. OnRemove events are delivered
+     * after the component is removed, and don't have field data.
+     *
+     * Coalescing is supported for OnAdd, OnRemove and OnSet events, for
+     * observers that only match $this. */
+    bool coalesce;
+
+    /** Pipeline phase in which a coalesced observer is flushed. When set, a
+     * system is created in the phase that flushes the observer each frame. The
+     * system is created as a child of the observer entity. */
+    ecs_entity_t coalesce_phase;
+
+    /** Deliver the events of a coalesced observer on multiple threads. When the
+     * observer is flushed and the world has worker threads, the batches for
+     * different tables are delivered in parallel, each on the stage of the
+     * thread that delivers it. Operations invoked by the callback are deferred
+     * and merged after all events were delivered. The callback may only write
+     * to the fields of the entities it is invoked for. This is not checked,
+     * and the inout kind of the observer terms is not used to schedule the
+     * delivery. Worlds that use task threads deliver the events on the thread
+     * that flushes the observer.
+     *
+     * Requires coalesce. */
+    bool multi_threaded;
+
     /** Callback to invoke on an event, invoked when the observer matches. */
     ecs_iter_action_t callback;
 
@@ -1551,6 +1666,7 @@ typedef struct ecs_world_info_t {
     int64_t systems_ran_total;        /**< Total number of systems run. */
     int64_t observers_ran_total;      /**< Total number of times an observer was invoked. */
     int64_t queries_ran_total;        /**< Total number of times a query was evaluated. */
+    int64_t compact_reclaimed_total;  /**< Total number of bytes reclaimed by ecs_compact(). */
 
     int32_t tag_id_count;             /**< Number of tag (no data) IDs in the world. */
     int32_t component_id_count;       /**< Number of component (data) IDs in the world. */
@@ -1574,6 +1690,7 @@ typedef struct ecs_world_info_t {
         int64_t other_count;           /**< Other commands processed. */
         int64_t batched_entity_count;  /**< Entities for which commands were batched. */
         int64_t batched_command_count; /**< Commands batched. */
+        int64_t parallel_merged_count; /**< Commands merged in parallel by worker threads. */
     } cmd;                             /**< Command statistics. */
 
     const char *name_prefix;          /**< Value set by ecs_set_name_prefix(). Used
@@ -1999,6 +2116,19 @@ FLECS_API extern const ecs_entity_t EcsSparse;
 /** Mark component as non-fragmenting. */
 FLECS_API extern const ecs_entity_t EcsDontFragment;
 
+/** Mark component as structure-of-arrays. A SoA component does not have a
+ * column of its own. Its data is stored in the components it adds with (With,
+ * component) pairs, which are removed together with the SoA component. The meta
+ * addon uses this trait to store each member of a struct in its own column. */
+FLECS_API extern const ecs_entity_t EcsSoA;
+
+/** Mark toggleable component as dense. Tables with a dense toggle component
+ * store the entities that have the component enabled before the entities that
+ * have it disabled, so queries iterate them as a single range of rows. Enabling
+ * or disabling the component moves the entity inside its table. Implies
+ * CanToggle. */
+FLECS_API extern const ecs_entity_t EcsDenseToggle;
+
 /** Marker used to indicate `$var == ...` matching in queries. */
 FLECS_API extern const ecs_entity_t EcsPredEq;
 
@@ -2325,6 +2455,28 @@ void ecs_set_default_query_flags(
     ecs_world_t *world,
     ecs_flags32_t flags);
 
+/** Set the minimum alignment of component columns.
+ * Tables created after this operation allocate the storage of each component
+ * column with at least the specified alignment. The storage of an aligned 
+ * column is padded to a multiple of the alignment. This ensures that vector
+ * loads on column data don't split cache lines, and that the columns of 
+ * different tables don't share cache lines.
+ *
+ * Components with an alignment larger than the specified value use the 
+ * alignment of the component. To align the columns of a single component,
+ * register the component with a larger alignment (in C++, with alignas).
+ *
+ * The alignment of a column can be retrieved with 
+ * ecs_table_get_column_alignment().
+ *
+ * @param world The world.
+ * @param alignment The alignment (a power of two, or 0 for default alignment).
+ */
+FLECS_API
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    int32_t alignment);
+
 /** @} */
 
 /**
@@ -2852,6 +3004,70 @@ int32_t ecs_delete_empty_tables(
     ecs_world_t *world,
     const ecs_delete_empty_tables_desc_t *desc);
 
+/** Used with ecs_compact(). */
+typedef struct ecs_compact_desc_t {
+    /** Amount of time operation is allowed to spend. If zero, the operation 
+     * completes the current compaction pass. */
+    double time_budget_seconds;
+
+    /** Free table data when a table was empty for this number of passes 
+     * (0 = never). */
+    uint16_t clear_generation;
+
+    /** Delete table when a table was empty for this number of passes
+     * (0 = never). */
+    uint16_t delete_generation;
+
+    /** Free entity index pages that have no alive entities. This forgets the
+     * generation of ids on those pages, and invalidates ecs_record_t pointers
+     * and refs for entities that are no longer alive. */
+    bool shrink_entity_index;
+} ecs_compact_desc_t;
+
+/** Incrementally free unused memory.
+ * This operation does the same kind of cleanup as ecs_shrink(), but spreads
+ * it out over multiple calls so that it can run each frame without causing
+ * a hitch. A compaction pass consists of the following phases:
+ * - Shrink tables that use at most half of their capacity, leaving room for
+ *   half of the table count to be added without growing the table. Clear or
+ *   delete tables that stayed empty for the configured generations.
+ * - Free unused capacity of the table storage and entity index, and 
+ *   optionally free entity index pages without alive entities.
+ * - Release the blocks of world and stage block allocators that have no 
+ *   outstanding allocations.
+ *
+ * When the time budget is exceeded the operation returns, and the next call
+ * continues where the previous call left off. Time is measured between 
+ * tables and allocators, so a single large table or allocator can exceed the
+ * budget.
+ *
+ * This operation cannot be called while the world is in readonly or deferred
+ * mode. The number of reclaimed bytes is added to the compact_reclaimed_total
+ * member of ecs_world_info_t, and reported by the stats addon.
+ *
+ * @param world The world.
+ * @param desc Configuration parameters.
+ * @return The number of bytes reclaimed by this call.
+ * 
+ * @see ecs_set_compaction()
+ */
+FLECS_API
+int64_t ecs_compact(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc);
+
+/** Run compaction at the end of each frame.
+ * When set, ecs_frame_end() (called by ecs_progress()) calls ecs_compact() 
+ * with the provided parameters. The time budget applies to each frame.
+ *
+ * @param world The world.
+ * @param desc Configuration parameters, or NULL to disable compaction.
+ */
+FLECS_API
+void ecs_set_compaction(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc);
+
 /** Get the world from a poly.
  *
  * @param poly A pointer to a poly object.
@@ -3081,6 +3297,15 @@ ecs_entity_t ecs_entity_init(
  * that is owned by the application, and then use this array to populate the
  * entities.
  *
+ * When the parallel option is set and the world has worker threads, the
+ * operation allocates ids and grows the table columns on the calling thread,
+ * after which the main and worker threads each construct and initialize a
+ * range of the new component values. OnAdd and OnSet hooks and observers, and
+ * components that are not stored in table columns, are handled on the calling
+ * thread once for the entire batch. Entities that inherit components
+ * are always initialized on the calling thread. The operation cannot be
+ * called while a pipeline is running.
+ *
  * @param world The world.
  * @param desc Bulk creation parameters.
  * @return An array with the list of entity IDs created or populated.
@@ -3428,6 +3653,33 @@ FLECS_ALWAYS_INLINE const void* ecs_get_id(
     ecs_entity_t entity,
     ecs_id_t component);
 
+/** Get immutable pointers to a component for multiple entities.
+ * This operation returns the same pointers as calling ecs_get_id() for each 
+ * entity, but is faster when looking up a component for many entities that 
+ * are not stored next to each other, such as relationship targets. The 
+ * lookups are pipelined, so that entity index records are fetched ahead of the
+ * entity that is being resolved, and component values are prefetched before 
+ * they are returned.
+ *
+ * All entities must be alive. If an entity does not have the component, its
+ * pointer is set to NULL. The ptrs_out array must have at least count elements.
+ *
+ * @param world The world.
+ * @param entities The entities for which to get the component.
+ * @param count The number of entities.
+ * @param component The component to get.
+ * @param ptrs_out Array that receives the component pointers.
+ *
+ * @see ecs_get_id()
+ */
+FLECS_API
+void ecs_get_many_id(
+    const ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t component,
+    const void **ptrs_out);
+
 /** Get a mutable pointer to a component.
  * This operation obtains a mutable pointer to the requested component. The
  * operation accepts the component entity ID.
@@ -5307,6 +5559,58 @@ const ecs_query_group_info_t* ecs_query_get_group_info(
     const ecs_query_t *query,
     uint64_t group_id);
 
+/** Used with ecs_query_propagate(). */
+typedef struct ecs_query_propagate_desc_t {
+    /** Callback invoked for the results of a hierarchy depth. */
+    ecs_iter_action_t callback;
+
+    /** Context passed to the callback (ecs_iter_t::ctx). */
+    void *ctx;
+
+    /** Distribute the results of each depth across worker threads. */
+    bool multi_threaded;
+} ecs_query_propagate_desc_t;
+
+/** Propagate values down a hierarchy with a cascade query.
+ * This operation invokes a callback for the results of a query with a cascade
+ * term one hierarchy depth at a time, which makes it possible to compute values
+ * that depend on the value of the parent, like a world transform. All results
+ * of a depth are processed before the results of the next depth.
+ *
+ * When multi_threaded is enabled and the world has worker threads, the results
+ * of each depth are distributed across the worker threads. Large results are
+ * split up, whereas small results (for example the per-entity results of 
+ * non-fragmenting hierarchies) are assigned to a single thread. The callback
+ * may only write component values of the iterated entities, and must not add
+ * or remove components.
+ *
+ * When the query was created with EcsQueryDetectChanges, results are skipped 
+ * when none of the fields read by the query changed since the last time it was
+ * propagated, and the parent of the result was not propagated in the same 
+ * call. This means that subtrees with unchanged inputs are skipped. Fields
+ * that are computed by the callback should be annotated as [out], so that
+ * writing them doesn't cause the results to be processed again.
+ *
+ * Example query for a transform system:
+ * 
+ * @code
+ * [out] WorldTransform(self), [in] LocalTransform(self), 
+ * [in] ?WorldTransform(cascade)
+ * @endcode
+ *
+ * The query must be cached, and the cascade term must use ascending order.
+ *
+ * @param world The world.
+ * @param query The query.
+ * @param desc Propagation parameters.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_query_propagate(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    const ecs_query_propagate_desc_t *desc);
+
 /** Struct returned by ecs_query_count(). */
 typedef struct ecs_query_count_t {
     int32_t results;      /**< Number of results returned by the query. */
@@ -5448,6 +5752,37 @@ const ecs_observer_t* ecs_observer_get(
     const ecs_world_t *world,
     ecs_entity_t observer);
 
+/** Deliver the events stored by a coalesced observer.
+ * This invokes the observer callback for the entities for which the observer
+ * received events since the last flush. Each entity receives at most one
+ * event of each kind, which is determined by the events that were received and
+ * whether the entity still matches the observer:
+ *
+ * - OnAdd, if the first received event was an OnAdd and the entity matches.
+ * - OnSet, if the entity matches and received an OnSet.
+ * - OnRemove, if the first received event was not an OnAdd, the entity
+ *   received an OnRemove and the entity no longer matches.
+ *
+ * An entity that was removed and added again is delivered as an OnSet if the
+ * observer observes OnSet, and as an OnRemove followed by an OnAdd otherwise.
+ *
+ * An entity only receives events that the observer observes.
+ *
+ * Events are delivered in batches of adjacent entities in the same table.
+ * Operations in the observer callback are deferred until the flush has
+ * completed. Events emitted by those operations are delivered by the next
+ * flush. If the observer is multi_threaded and the world has worker threads,
+ * the batches of different tables are delivered in parallel.
+ *
+ * @param world The world.
+ * @param observer The observer.
+ * @return The number of events delivered, counted per entity.
+ */
+FLECS_API
+int32_t ecs_observer_flush(
+    ecs_world_t *world,
+    ecs_entity_t observer);
+
 /** @} */
 
 /**
@@ -5788,6 +6123,15 @@ bool ecs_page_next(
  * stable between queries. Two queries that match the same table are guaranteed
  * to match the same entities in that table.
  *
+ * When the source iterator is a query iterator for a query that only matches
+ * sparse components, the source iterator only iterates the part of the sparse
+ * storage that belongs to the resource. The iterator must not have been 
+ * progressed before the worker iterator is created.
+ *
+ * When the source iterator is a query iterator for an uncached query with the
+ * EcsQueryPartitionTables flag, matched tables are divided across resources
+ * instead, and each table is iterated by a single resource.
+ *
  * The iterator must be iterated with ecs_worker_next().
  *
  * A worker iterator acts as a passthrough for data exposed by the parent
@@ -5815,6 +6159,49 @@ FLECS_API
 bool ecs_worker_next(
     ecs_iter_t *it);
 
+/** Create a dynamic worker iterator.
+ * Dynamic worker iterators divide matched entities across resources (usually
+ * threads) by splitting query results into chunks of at most chunk_size
+ * entities. Resources claim chunks from a counter that is shared between all
+ * iterators, so that a resource that finishes early continues with chunks that
+ * would otherwise have been processed by a busier resource.
+ *
+ * Each resource must create its iterator from an iterator that returns the 
+ * same results in the same order (typically an iterator for the same query).
+ * The shared cursor must be set to 0 before any of the resources start
+ * iterating, and must not be reset until all resources are done.
+ *
+ * Unlike ecs_worker_iter(), the distribution of entities across resources is
+ * not stable between queries or runs.
+ *
+ * Queries that only match sparse components claim chunks directly from their
+ * sparse storage. Uncached queries with the EcsQueryPartitionTables flag claim
+ * tables, which are returned in chunks of at most chunk_size entities to the
+ * resource that claimed the table.
+ *
+ * The iterator must be iterated with ecs_dynamic_worker_next().
+ *
+ * @param it The source iterator.
+ * @param cursor Chunk counter shared between all resources.
+ * @param chunk_size The maximum number of entities in a chunk.
+ * @return A dynamic worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_dynamic_worker_iter(
+    const ecs_iter_t *it,
+    int32_t *cursor,
+    int32_t chunk_size);
+
+/** Progress a dynamic worker iterator.
+ * Progress an iterator created by ecs_dynamic_worker_iter().
+ *
+ * @param it The iterator.
+ * @return True if the iterator has more results, false if not.
+ */
+FLECS_API
+bool ecs_dynamic_worker_next(
+    ecs_iter_t *it);
+
 /** Get data for a field.
  * This operation retrieves a pointer to an array of data that belongs to the
  * term in the query. The index refers to the location of the term in the query,
@@ -6130,6 +6517,21 @@ size_t ecs_table_get_column_size(
     const ecs_table_t *table,
     int32_t index);
 
+/** Get the column alignment from a table.
+ * This operation returns the alignment that is guaranteed for the component
+ * array returned by ecs_table_get_column() for the provided index. This is
+ * the largest of the component alignment and the column alignment that was
+ * configured with ecs_set_column_alignment() when the table was created.
+ *
+ * @param table The table.
+ * @param index The column index.
+ * @return The column alignment, or 0 if the index is not a component.
+ */
+FLECS_API
+int32_t ecs_table_get_column_alignment(
+    const ecs_table_t *table,
+    int32_t index);
+
 /** Return the number of entities in the table.
  * This operation returns the number of entities in the table.
  *
@@ -229,6 +229,12 @@ static const flecs::entity_t Sparse = EcsSparse;
 /** DontFragment storage tag. */
 static const flecs::entity_t DontFragment = EcsDontFragment;
 
+/** Structure-of-arrays storage tag. */
+static const flecs::entity_t SoA = EcsSoA;
+
+/** Dense toggle storage tag. */
+static const flecs::entity_t DenseToggle = EcsDenseToggle;
+
 /** PredEq query predicate. */
 static const flecs::entity_t PredEq = EcsPredEq;
 /** PredMatch query predicate. */
@@ -390,6 +390,97 @@ public:
     Func func_;
 };
 
+// Type that handles passing whole columns to batched each callbacks.
+template <typename Func, typename ... Components>
+struct each_batch_delegate : public delegate {
+    using Terms = typename field_ptrs<Components ...>::array;
+
+    template < if_not_t< is_same< decay_t<Func>, decay_t<Func>& >::value > = 0>
+    explicit each_batch_delegate(Func&& func) noexcept
+        : func_(FLECS_MOV(func)) { }
+
+    explicit each_batch_delegate(const Func& func) noexcept
+        : func_(func) { }
+
+    // Invoke object directly. This operation is useful when the calling
+    // function has just constructed the delegate, such as what happens when
+    // iterating a query.
+    void invoke(ecs_iter_t *iter) const {
+        field_ptrs<Components...> terms;
+
+        iter->flags |= EcsIterCppEach;
+
+        size_t count = static_cast<size_t>(iter->count);
+        if (count == 0 && !iter->table) {
+            // If the query has no This terms, count can be 0. Pass through
+            // components as a batch with a single element.
+            count = 1;
+        }
+
+        ECS_TABLE_LOCK(iter->world, iter->table);
+
+        if (iter->ref_fields | iter->up_fields) {
+            // Fields that are not owned by the iterated entities don't point
+            // to an array with a value per entity. Pass the values for each
+            // entity as a batch with a single element.
+            terms.populate(iter);
+            for (size_t i = 0; i < count; i ++) {
+                invoke_callback(iter, 1, i, terms.fields_,
+                    std::index_sequence_for<Components...>{});
+            }
+        } else {
+            terms.populate_self(iter);
+            invoke_callback(iter, count, 0, terms.fields_,
+                std::index_sequence_for<Components...>{});
+        }
+
+        ECS_TABLE_UNLOCK(iter->world, iter->table);
+    }
+
+    // Static function that can be used as callback for systems/observers.
+    static void run(ecs_iter_t *iter) {
+        auto self = static_cast<const each_batch_delegate*>(iter->callback_ctx);
+        ecs_assert(self != nullptr, ECS_INTERNAL_ERROR, nullptr);
+        self->invoke(iter);
+    }
+
+private:
+    // Get pointer to the first element of the batch for a field.
+    template <typename T, typename A = base_arg_type_t<T>>
+    static A* get_ptr(const ecs_iter_t *iter, const _::field_ptr& field,
+        size_t row)
+    {
+        if (field.is_row) {
+            return static_cast<A*>(ecs_field_at_w_size(iter, sizeof(A),
+                field.index, static_cast<int32_t>(row)));
+        }
+
+        if (!field.ptr) {
+            // Optional field that isn't set, or a tag.
+            return nullptr;
+        }
+
+        if (field.is_ref) {
+            return static_cast<A*>(field.ptr);
+        }
+
+        return &static_cast<A*>(field.ptr)[row];
+    }
+
+    // func(size_t count, Components* ...)
+    template <size_t... Is>
+    void invoke_callback(const ecs_iter_t *iter, size_t count, size_t row,
+        Terms& fields, std::index_sequence<Is...>) const
+    {
+        (void)iter; (void)row; (void)fields;
+        func_(count, get_ptr< remove_reference_t<Components> >(
+            iter, fields[Is], row)...);
+    }
+
+public:
+    Func func_;
+};
+
 template <typename Func, typename T>
 struct validate_delegate : public delegate {
     template < if_not_t< is_same< decay_t<Func>, decay_t<Func>& >::value > = 0>
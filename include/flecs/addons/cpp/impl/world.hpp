@@ -207,6 +207,30 @@ const First& world::get(Second second) const {
     return e.get<First>(second);
 }
 
+/** Get a component by ID for multiple entities. */
+inline void world::get_many(flecs::id_t id, const flecs::entity_t *entities, 
+    size_t count, const void **out) const 
+{
+    ecs_get_many_id(world_, entities, static_cast<int32_t>(count), id, out);
+}
+
+/** Get a component for multiple entities. */
+template <typename T>
+inline void world::get_many(const flecs::entity_t *entities, size_t count, 
+    const T **out) const 
+{
+    ecs_get_many_id(world_, entities, static_cast<int32_t>(count),
+        _::type<T>::id(world_), reinterpret_cast<const void**>(out));
+}
+
+/** Get a component for an array of entities. */
+template <typename T, size_t N>
+inline void world::get_many(const flecs::entity_t (&entities)[N], 
+    const T* (&out)[N]) const 
+{
+    this->get_many<T>(entities, N, out);
+}
+
 /** Try to get a mutable singleton component by ID (returns nullptr if not found). */
 inline void* world::try_get_mut(flecs::id_t id) const {
     flecs::entity e(world_, id);
@@ -51,6 +51,29 @@ struct observer_builder_i : query_builder_i<Base, Components ...> {
         return *this;
     }
 
+    /** Coalesce events, and deliver them when the observer is flushed.
+     * OnRemove events for coalesced observers don't have field data, which
+     * means they can't be used with each() callbacks that have components.
+     *
+     * @param phase Pipeline phase in which the observer is flushed (optional).
+     * @see ecs_observer_desc_t::coalesce
+     */
+    Base& coalesce(flecs::entity_t phase = 0) {
+        desc_->coalesce = true;
+        desc_->coalesce_phase = phase;
+        return *this;
+    }
+
+    /** Deliver the events of a coalesced observer on multiple threads.
+     *
+     * @param value If false, events are delivered on the flushing thread.
+     * @see ecs_observer_desc_t::multi_threaded
+     */
+    Base& multi_threaded(bool value = true) {
+        desc_->multi_threaded = value;
+        return *this;
+    }
+
     /** Set the observer flags. */
     Base& observer_flags(ecs_flags32_t flags) {
         desc_->flags_ |= flags;
@@ -71,6 +71,15 @@ struct observer final : entity
         return run_each_callback(CallbackComponents{}, FLECS_FWD(func));
     }
 
+    /** Deliver the events stored by a coalesced observer.
+     *
+     * @return The number of entities for which events were delivered.
+     * @see ecs_observer_flush()
+     */
+    int32_t flush() const {
+        return ecs_observer_flush(world_, id_);
+    }
+
     /** Get the query for this observer. */
     flecs::query<> query() const {
         return flecs::query<>(ecs_observer_get(world_, id_)->query);
@@ -85,4 +85,15 @@ inline bool world::using_task_threads() const {
     return ecs_using_task_threads(world_);
 }
 
+inline void world::set_worker_spin(
+    int32_t spin_count, 
+    int32_t yield_count) const 
+{
+    ecs_set_worker_spin(world_, spin_count, yield_count);
+}
+
+inline void world::set_parallel_merge(bool enable) const {
+    ecs_set_parallel_merge(world_, enable);
+}
+
 }
@@ -93,4 +93,14 @@ void set_task_threads(int32_t task_threads) const;
  */
 bool using_task_threads() const;
 
+/** Set how worker threads wait on each other.
+ * @see ecs_set_worker_spin()
+ */
+void set_worker_spin(int32_t spin_count, int32_t yield_count = 0) const;
+
+/** Enable or disable merging commands in parallel.
+ * @see ecs_set_parallel_merge()
+ */
+void set_parallel_merge(bool enable = true) const;
+
 /** @} */
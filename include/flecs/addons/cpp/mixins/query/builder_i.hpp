@@ -45,6 +45,18 @@ struct query_builder_i : term_builder_i<Base> {
         return *this;
     }
 
+    /** Order terms by their estimated number of matched tables. */
+    Base& plan_by_cost() {
+        desc_->flags |= EcsQueryPlanByCost;
+        return *this;
+    }
+
+    /** Distribute tables across workers for worker iterators. */
+    Base& partition_tables() {
+        desc_->flags |= EcsQueryPartitionTables;
+        return *this;
+    }
+
     /** Set the query expression string. */
     Base& expr(const char *expr) {
         ecs_check(expr_count_ == 0, ECS_INVALID_OPERATION,
@@ -63,6 +63,18 @@ public:
         return *this;
     }
 
+    /** Specify the chunk size for distributing entities across threads.
+     * When set, worker threads dynamically claim chunks of at most the
+     * specified number of entities, instead of each processing an equal
+     * part of each table.
+     *
+     * @param value The maximum number of entities in a chunk.
+     */
+    Base& chunk_size(int32_t value) {
+        desc_->chunk_size = value;
+        return *this;
+    }
+
     /** Specify whether the system should be run in an immediate (non-staged) context.
      *
      * @param value If false, the system will always run staged.
@@ -369,6 +369,15 @@ struct table {
         return ecs_table_get_column_size(table_, index);
     }
 
+    /** Get the column alignment.
+     *
+     * @param index The column index.
+     * @return The alignment that is guaranteed for the column's array.
+     */
+    int32_t column_alignment(int32_t index) const {
+        return ecs_table_get_column_alignment(table_, index);
+    }
+
     /** Get the depth for a given relationship.
      *
      * @param rel The relationship.
@@ -39,6 +39,30 @@ struct iterable {
         }
     }
 
+    /** Batched each iterator.
+     * The "each_batch" iterator accepts a function that is invoked once for
+     * each matched table (or table slice) with pointers to the first element
+     * of the component arrays. This lets the callback process components in a
+     * tight loop that the compiler can vectorize. The following function
+     * signature is valid:
+     *  - func(size_t count, Components* ...)
+     *
+     * When a field is not owned by the iterated entities (for example when it
+     * is matched on a parent), the function is invoked for each entity with a
+     * count of 1. Optional fields that are not set and tags are passed as
+     * nullptr.
+     *
+     * @param func The callback function.
+     */
+    template <typename Func>
+    void each_batch(Func&& func) const {
+        ecs_iter_t it = this->get_iter(nullptr);
+        ecs_iter_next_action_t next = this->next_action();
+        while (next(&it)) {
+            _::each_batch_delegate<Func, Components...>(func).invoke(&it);
+        }
+    }
+
     /** Run the iterator.
      * The "run" callback accepts a function that is invoked once for a query
      * with a valid iterator. The following signature is valid:
@@ -76,6 +76,17 @@ public:
         return T(world_, &desc_);
     }
 
+    template <typename Func>
+    T each_batch(Func&& func) {
+        using Delegate = typename _::each_batch_delegate<
+            typename std::decay<Func>::type, Components...>;
+        auto ctx = FLECS_NEW(Delegate)(FLECS_FWD(func));
+        desc_.callback = Delegate::run;
+        desc_.callback_ctx = ctx;
+        desc_.callback_ctx_free = _::free_obj<Delegate>;
+        return T(world_, &desc_);
+    }
+
     template <typename Func>
     T run_each(Func&& func) {
         using Delegate = typename _::each_delegate<
@@ -704,6 +704,16 @@ struct world {
         ecs_dim(world_, entity_count);
     }
 
+    /** Set the minimum alignment of component columns in new tables.
+     *
+     * @param alignment The alignment (a power of two, or 0 for default).
+     *
+     * @see ecs_set_column_alignment()
+     */
+    void set_column_alignment(int32_t alignment) const {
+        ecs_set_column_alignment(world_, alignment);
+    }
+
     /** Create a new entity id range.
      * @see ecs_entity_range_new()
      */
@@ -898,6 +908,34 @@ struct world {
     void get(const Func& func) const;
 
 
+    /* get_many */
+
+    /** Get component for multiple entities.
+     * Pointers are set to nullptr for entities that don't have the component.
+     *
+     * @see ecs_get_many_id()
+     */
+    void get_many(flecs::id_t id, const flecs::entity_t *entities, 
+        size_t count, const void **out) const;
+
+    /** Get component for multiple entities.
+     * Pointers are set to nullptr for entities that don't have the component.
+     *
+     * @see ecs_get_many_id()
+     */
+    template <typename T>
+    void get_many(const flecs::entity_t *entities, size_t count, 
+        const T **out) const;
+
+    /** Get component for an array of entities.
+     *
+     * @see ecs_get_many_id()
+     */
+    template <typename T, size_t N>
+    void get_many(const flecs::entity_t (&entities)[N], 
+        const T* (&out)[N]) const;
+
+
     /* try_get_mut */
 
     /** Get mutable singleton component.
@@ -386,6 +386,11 @@
 #define ecs_get(world, entity, T)\
     (ECS_CAST(const T*, ecs_get_id(world, entity, ecs_id(T))))
 
+/** Get a component for multiple entities. */
+#define ecs_get_many(world, entities, count, T, ptrs_out)\
+    ecs_get_many_id(world, entities, count, ecs_id(T),\
+        ECS_CAST(const void**, ptrs_out))
+
 /** Get the first element of a pair. */
 #define ecs_get_pair(world, subject, First, second)\
     (ECS_CAST(const First*, ecs_get_id(world, subject,\
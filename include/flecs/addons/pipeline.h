@@ -281,6 +281,51 @@ FLECS_API
 bool ecs_using_task_threads(
     ecs_world_t *world);
 
+/** Set how worker threads wait on each other.
+ * By default threads that wait for a pipeline operation to start or finish
+ * block on a condition variable. For applications that run many sync points
+ * per frame, the latency of waking up a blocked thread can add up.
+ *
+ * When spin_count and/or yield_count are set, a waiting thread first polls
+ * for spin_count iterations, then yields its time slice for yield_count
+ * iterations, before blocking on the condition variable. This reduces wake up
+ * latency at the cost of CPU time spent waiting.
+ *
+ * The setting is applied to threads created with ecs_set_threads() as well as
+ * ecs_set_task_threads(). Setting both values to 0 restores the default.
+ *
+ * @param world The world.
+ * @param spin_count The number of iterations to poll before yielding.
+ * @param yield_count The number of times to yield before blocking.
+ */
+FLECS_API
+void ecs_set_worker_spin(
+    ecs_world_t *world,
+    int32_t spin_count,
+    int32_t yield_count);
+
+/** Enable or disable merging commands in parallel.
+ * By default the commands enqueued by worker threads are merged by the main
+ * thread, one stage after another. When parallel merging is enabled, the 
+ * threads of a multithreaded sync point first partition the enqueued commands
+ * by entity, after which each thread moves the values of set/ensure commands
+ * in one partition into component storage.
+ * 
+ * This is only done for entities for which all enqueued commands assign 
+ * components the entity already has. Commands for other entities are handled
+ * by the merge on the main thread in the order in which they were enqueued.
+ * If any of the enqueued commands has hooks or observers, all commands are
+ * merged by the main thread, as hooks and observers could otherwise see values
+ * of commands that were enqueued after the command that invoked them.
+ * 
+ * @param world The world.
+ * @param enable Whether to enable parallel merging.
+ */
+FLECS_API
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Module
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,290 @@
+/**
+ * @file addons/snapshot.h
+ * @brief Binary world snapshot addon.
+ *
+ * The snapshot addon serializes the entities and component data of a world to
+ * a compact binary format, and restores a world from that format. Compared to
+ * JSON, component data of types without lifecycle hooks is stored as raw table
+ * column data, which is restored with a single copy per table column.
+ *
+ * The addon also provides a replicator, which produces binary diffs with the
+ * entities and columns that changed since a client acknowledged a diff, and
+ * world forks, which store the state of a world in memory so that it can be
+ * rolled back.
+ */
+
+#ifdef FLECS_SNAPSHOT
+
+#ifndef FLECS_JSON
+#define FLECS_JSON
+#endif
+
+#ifndef FLECS_SNAPSHOT_H
+#define FLECS_SNAPSHOT_H
+
+/**
+ * @defgroup c_addons_snapshot Snapshot
+ * @ingroup c_addons
+ * Binary world snapshots.
+ *
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of the binary snapshot format. Snapshots with a different version
+ * cannot be restored. */
+#define ECS_SNAPSHOT_VERSION (1)
+
+/** Serialize world to a binary snapshot.
+ * This operation serializes all entities that are not builtin or part of a
+ * module, together with their component data. The format stores each table as
+ * a block that contains the table type, the entity ids and the table columns.
+ *
+ * Columns of components without lifecycle hooks are stored as raw bytes. Values
+ * of components with hooks are stored using their reflection data, which means
+ * that values of components with hooks but without reflection data are not
+ * stored. Entity names, symbols and aliases are stored as strings.
+ *
+ * The snapshot stores component ids, names and sizes, but does not store the
+ * component entities themselves. A snapshot can only be restored in a world
+ * that registered the same components with the same ids, for example by
+ * importing the same modules in the same order. Values of components that do
+ * not fragment tables (DontFragment) and the enabled state of toggled
+ * components are not stored.
+ *
+ * The format uses the native byte order and pointer size of the platform, and
+ * cannot be restored on a platform with a different byte order or pointer
+ * size.
+ *
+ * Snapshot sizes are stored as ecs_size_t, which limits the size of a snapshot
+ * to 2GB. The operation fails if the serialized world exceeds this size.
+ *
+ * The returned buffer must be freed with ecs_os_free().
+ *
+ * @param world The world.
+ * @param size_out Out parameter for the size of the snapshot in bytes.
+ * @return The snapshot data, or NULL if failed.
+ */
+FLECS_API
+void* ecs_world_to_binary(
+    const ecs_world_t *world,
+    ecs_size_t *size_out);
+
+/** Restore entities from a binary snapshot.
+ * This operation restores entities and component values from a snapshot that
+ * was created with ecs_world_to_binary(). Entities are restored with the ids
+ * (including generation) they had when the snapshot was taken.
+ *
+ * Before the world is modified, the operation verifies that the snapshot was
+ * created with a compatible version and platform, that the components in the
+ * snapshot have the same id, name and size in the world, and that none of the
+ * snapshot entities is alive in the world with a different generation.
+ *
+ * Entities in the snapshot that are not alive in the world are created in bulk:
+ * for each table in the snapshot the entities are added to the table at once,
+ * after which each raw column is copied directly from the snapshot data. This
+ * means that the snapshot data can be read from a memory-mapped file, without
+ * first copying or parsing it. Entities that are already alive are restored
+ * with regular add/set operations.
+ *
+ * Restoring a snapshot does not instantiate prefab hierarchies for instances,
+ * as instance children are part of the snapshot.
+ *
+ * @param world The world.
+ * @param data The snapshot data.
+ * @param size The size of the snapshot data.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_world_from_binary(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size);
+
+/** Same as ecs_world_from_binary(), but loads the snapshot from a file.
+ *
+ * @param world The world.
+ * @param filename The file from which to load the snapshot.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_world_from_binary_file(
+    ecs_world_t *world,
+    const char *filename);
+
+/** Replicator that produces binary diffs for the entities matched by a query.
+ * A replicator keeps track of the state that a client has acknowledged, so
+ * that each diff only contains what changed since that state. */
+typedef struct ecs_replicator_t ecs_replicator_t;
+
+/** Create a replicator.
+ * The replicator produces diffs for the entities matched by the query. The
+ * diffs contain all (non-builtin) ids of the tables matched by the query, not
+ * just the ids of the query fields. The query must outlive the replicator.
+ *
+ * @param world The world.
+ * @param query The query that selects the entities to replicate.
+ * @return The replicator.
+ */
+FLECS_API
+ecs_replicator_t* ecs_replicator_new(
+    ecs_world_t *world,
+    ecs_query_t *query);
+
+/** Free a replicator.
+ *
+ * @param replicator The replicator.
+ */
+FLECS_API
+void ecs_replicator_free(
+    ecs_replicator_t *replicator);
+
+/** Create a diff since the last acknowledged frame.
+ * A diff contains:
+ * - the entities that were deleted or no longer match the query
+ * - all ids and values of entities that are new, or that moved to a different
+ *   table (for example because a component was added)
+ * - the changed columns of entities that did not move to a different table
+ *
+ * Changes are detected with the same per-column change counters that are used
+ * by ecs_query_changed(). A column is changed when it is written by a set or
+ * modified operation, or by a query that writes the component. Values that are
+ * written without marking them as modified are not detected. Sparse components
+ * are always treated as changed. Values are encoded in the same way as in a
+ * binary snapshot.
+ *
+ * Each diff is relative to the last frame that was acknowledged with
+ * ecs_replicator_ack(). If no frame was acknowledged, the diff contains all
+ * matched entities. Applying a diff that was created after the diff that was
+ * last applied, but before it was acknowledged, is valid.
+ *
+ * The returned buffer must be freed with ecs_os_free().
+ *
+ * @param replicator The replicator.
+ * @param size_out Out parameter for the size of the diff in bytes.
+ * @param frame_out Out parameter for the frame of the diff (optional).
+ * @return The diff data, or NULL if failed.
+ */
+FLECS_API
+void* ecs_replicator_diff(
+    ecs_replicator_t *replicator,
+    ecs_size_t *size_out,
+    uint64_t *frame_out);
+
+/** Acknowledge a frame.
+ * Subsequent diffs will only contain changes since the acknowledged frame.
+ * Any frame returned by ecs_replicator_diff() that is newer than the last
+ * acknowledged frame can be acknowledged, so that a client with latency can
+ * acknowledge a frame while newer diffs are in flight. Acknowledging a frame
+ * that is older than the last acknowledged frame does nothing. The replicator
+ * keeps the state of at most 64 unacknowledged frames, older frames can no
+ * longer be acknowledged.
+ *
+ * @param replicator The replicator.
+ * @param frame The frame that was applied by the client.
+ */
+FLECS_API
+void ecs_replicator_ack(
+    ecs_replicator_t *replicator,
+    uint64_t frame);
+
+/** Apply a diff that was created with ecs_replicator_diff().
+ * Deleted entities are deleted, new entities are created in bulk in the same
+ * way as ecs_world_from_binary() restores entities. Existing entities that
+ * moved to a different table get the ids of the new table, and lose the ids
+ * that are no longer in their table. Changed values are assigned with set
+ * operations, which invokes OnSet hooks and observers.
+ *
+ * The same restrictions as for ecs_world_from_binary() apply: components must
+ * be registered with the same ids and sizes as in the source world.
+ *
+ * @param world The world.
+ * @param data The diff data.
+ * @param size The size of the diff data.
+ * @return Zero if success, non-zero if failed.
+ */
+FLECS_API
+int ecs_world_apply_diff(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size);
+
+/** In-memory copy of the state of a world that the world can be restored to.
+ * Forks share copies of table columns that didn't change between forks. */
+typedef struct ecs_world_fork_t ecs_world_fork_t;
+
+/** Fork the world.
+ * A fork stores the entities and component values of the same tables that are
+ * stored by ecs_world_to_binary(). The operation copies the entity ids and
+ * component values of each table, except for columns that did not change
+ * since the previous fork was created. Those columns share the copy of the
+ * previous fork. When forks are created each frame, the cost of a fork is
+ * proportional to the number of tables plus the size of the columns that
+ * changed in that frame.
+ *
+ * Changes are detected with the same per-column change counters as used by
+ * ecs_replicator_diff(). While a fork exists, the columns of components that
+ * are returned by ecs_ensure(), ecs_get_mut() and ecs_emplace() are marked as
+ * changed, so that values written through these pointers are restored even if
+ * the application doesn't call ecs_modified(). Pointers must not be kept
+ * across a fork, and values written through other pointers (such as refs)
+ * must be marked as modified. Values of components that are stored outside
+ * of table columns (sparse, DontFragment) and the enabled state of toggled
+ * components are not stored.
+ *
+ * Tables that are deleted after the fork was created are recreated when the
+ * fork is restored. Forks must be freed before the world is deleted.
+ *
+ * @param world The world.
+ * @param prev A previous fork of the same world to share column copies with
+ *             (optional).
+ * @return The fork.
+ */
+FLECS_API
+ecs_world_fork_t* ecs_world_fork(
+    ecs_world_t *world,
+    const ecs_world_fork_t *prev);
+
+/** Restore the world to the state of a fork.
+ * This discards all changes made to the forked tables since the fork was
+ * created. Entities created after the fork are deleted, entities that were
+ * deleted are recreated with the same id, and entities that changed tables
+ * are moved back to their table. These structural changes emit OnAdd and
+ * OnRemove events. The values of columns that changed are then copied back
+ * without emitting OnSet events. Names and Parent components are assigned
+ * with regular set operations, so that lookup indices remain valid.
+ *
+ * The cost of a restore is proportional to the number of tables plus the
+ * columns and entities that changed. A fork can be restored more than once.
+ * Keeping the changes instead (commit) only requires freeing the fork.
+ *
+ * Entity ids that were recycled after the fork was created are not restored,
+ * which means that entities created after a restore can get different ids than
+ * the entities created after the fork.
+ *
+ * @param fork The fork to restore.
+ */
+FLECS_API
+void ecs_world_fork_restore(
+    const ecs_world_fork_t *fork);
+
+/** Free a fork.
+ *
+ * @param fork The fork to free.
+ */
+FLECS_API
+void ecs_world_fork_free(
+    ecs_world_fork_t *fork);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @} */
+
+#endif
@@ -147,6 +147,9 @@ typedef struct ecs_world_stats_t {
         ecs_metric_t stack_alloc_count;    /**< Page allocations per frame. */
         ecs_metric_t stack_free_count;     /**< Page frees per frame. */
         ecs_metric_t stack_outstanding_alloc_count; /**< Difference between allocs and frees. */
+
+        /* Compaction data */
+        ecs_metric_t compact_reclaimed_bytes; /**< Bytes reclaimed by ecs_compact() per frame. */
     } memory;
 
     /* HTTP statistics */
@@ -196,6 +199,7 @@ typedef struct ecs_sync_stats_t {
     int64_t first_;                /**< Used for field iteration. Do not set. */
     ecs_metric_t time_spent;       /**< Time spent in sync point. */
     ecs_metric_t commands_enqueued; /**< Number of commands enqueued. */
+    ecs_metric_t wait_time;        /**< Time spent waiting for worker threads. */
     int64_t last_;                 /**< Used for field iteration. Do not set. */
 
     int32_t system_count;          /**< Number of systems before sync point. */
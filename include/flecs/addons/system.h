@@ -96,6 +96,14 @@ typedef struct ecs_system_desc_t {
     /** If true, the system will be run on multiple threads. */
     bool multi_threaded;
 
+    /** If set, a multithreaded system that is run by a pipeline splits its 
+     * matched entities into chunks of at most chunk_size entities, which are
+     * claimed dynamically by worker threads that are done with their previous
+     * chunk. This balances work across threads when tables have very different
+     * sizes or when entities take different amounts of time to process. If not
+     * set, each table is divided equally between worker threads. */
+    int32_t chunk_size;
+
     /** If true, the system will have access to the actual world. Cannot be true at the
      * same time as multi_threaded. */
     bool immediate;
@@ -160,6 +168,12 @@ typedef struct ecs_system_t {
     /** Whether the system is multithreaded. */
     bool multi_threaded;
 
+    /** See ecs_system_desc_t. */
+    int32_t chunk_size;
+
+    /** Chunk counter shared by worker threads (if chunk_size is set). */
+    int32_t chunk_cursor;
+
     /** Whether the system is run in immediate mode. */
     bool immediate;
 
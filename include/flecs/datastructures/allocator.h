@@ -18,6 +18,9 @@ struct ecs_allocator_t {
 #ifndef FLECS_USE_OS_ALLOC
     ecs_block_allocator_t chunks; /**< Block allocator for chunk storage. */
     struct ecs_sparse_t sizes; /**< Sparse set mapping size to block allocator. */
+#ifdef FLECS_HUGE_PAGES
+    ecs_page_arena_t arena; /**< Arena for blocks of block allocators. */
+#endif
 #else
     bool dummy; /**< Unused member for OS allocator fallback. */
 #endif
@@ -22,6 +22,14 @@ typedef struct ecs_block_allocator_chunk_header_t {
     struct ecs_block_allocator_chunk_header_t *next; /**< Next free chunk. */
 } ecs_block_allocator_chunk_header_t;
 
+#if defined(FLECS_HUGE_PAGES) && !defined(FLECS_USE_OS_ALLOC)
+/** Arena that provides the blocks of block allocators from large slabs. */
+typedef struct ecs_page_arena_t {
+    struct ecs_page_slab_t *slab; /**< Current slab (head of slab list). */
+    int32_t used; /**< Number of bytes used in the current slab. */
+} ecs_page_arena_t;
+#endif
+
 /** Block allocator that returns fixed-size memory blocks. */
 typedef struct ecs_block_allocator_t {
     int32_t data_size; /**< Size of each allocation. */
@@ -31,6 +39,9 @@ typedef struct ecs_block_allocator_t {
     int32_t block_size; /**< Total size of each allocated block. */
     ecs_block_allocator_chunk_header_t *head; /**< Head of the free chunk list. */
     ecs_block_allocator_block_t *block_head; /**< Head of the allocated block list. */
+#ifdef FLECS_HUGE_PAGES
+    ecs_page_arena_t *arena; /**< Arena that provides blocks (optional). */
+#endif
 #ifdef FLECS_SANITIZE
     int32_t alloc_count; /**< Number of outstanding allocations (sanitizer only). */
     ecs_map_t *outstanding; /**< Map of outstanding allocations (sanitizer only). */
@@ -81,6 +92,26 @@ FLECS_API
 void flecs_ballocator_fini(
     ecs_block_allocator_t *ba);
 
+#if defined(FLECS_HUGE_PAGES) && !defined(FLECS_USE_OS_ALLOC)
+/** Free the slabs of a page arena. 
+ * Block allocators that use the arena must be deinitialized first.
+ *
+ * @param arena The arena.
+ */
+FLECS_API
+void flecs_page_arena_fini(
+    ecs_page_arena_t *arena);
+#endif
+
+/** Free the blocks of a block allocator if it has no outstanding allocations.
+ *
+ * @param ba The block allocator.
+ * @return The number of bytes freed.
+ */
+FLECS_API
+int64_t flecs_ballocator_reclaim(
+    ecs_block_allocator_t *ba);
+
 /** Free a block allocator created with flecs_ballocator_new().
  *
  * @param ba The block allocator to free.
@@ -217,6 +217,18 @@ bool flecs_sparse_has(
     const ecs_sparse_t *sparse,
     uint64_t id);
 
+/** Prefetch the sparse index and element of an ID.
+ * This does not load the memory of the element, but hints the CPU that it will
+ * be accessed soon. Use this when iterating IDs in an order that doesn't match
+ * their memory layout, like when iterating the dense array.
+ *
+ * @param sparse The sparse set.
+ * @param id The ID to prefetch.
+ */
+void flecs_sparse_prefetch(
+    const ecs_sparse_t *sparse,
+    uint64_t id);
+
 /** Get element by sparse ID, regardless of whether the element is alive or not.
  *
  * @param sparse The sparse set to retrieve from.
@@ -97,6 +97,17 @@ typedef
 void* (*ecs_os_api_calloc_t)(
     ecs_size_t size);
 
+/** OS API page_alloc function type. */
+typedef
+void* (*ecs_os_api_page_alloc_t)(
+    ecs_size_t size);
+
+/** OS API page_free function type. */
+typedef
+void (*ecs_os_api_page_free_t)(
+    void *ptr,
+    ecs_size_t size);
+
 /** OS API strdup function type. */
 typedef
 char* (*ecs_os_api_strdup_t)(
@@ -296,6 +307,8 @@ typedef struct ecs_os_api_t {
     ecs_os_api_realloc_t realloc_;                 /**< realloc callback. */
     ecs_os_api_calloc_t calloc_;                   /**< calloc callback. */
     ecs_os_api_free_t free_;                       /**< free callback. */
+    ecs_os_api_page_alloc_t page_alloc_;           /**< page_alloc callback (optional). */
+    ecs_os_api_page_free_t page_free_;             /**< page_free callback (optional). */
 
     /* Strings */
     ecs_os_api_strdup_t strdup_;                   /**< strdup callback. */
@@ -446,6 +459,12 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#ifndef ecs_os_page_alloc
+#define ecs_os_page_alloc(size) ecs_os_api.page_alloc_(size)
+#endif
+#ifndef ecs_os_page_free
+#define ecs_os_page_free(ptr, size) ecs_os_api.page_free_(ptr, size)
+#endif
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -496,7 +515,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_zeromem(ptr) ecs_os_memset(ptr, 0, ECS_SIZEOF(*ptr))
 
 #define ecs_os_memdup_t(ptr, T) ecs_os_memdup(ptr, ECS_SIZEOF(T))
-#define ecs_os_memdup_n(ptr, T, count) ecs_os_memdup(ptr, ECS_SIZEOF(T) * count)
+#define ecs_os_memdup_n(ptr, T, count) ecs_os_memdup(ptr, ECS_SIZEOF(T) * (count))
 
 #define ecs_offset(ptr, T, index)\
     ECS_CAST(T*, ECS_OFFSET(ptr, ECS_SIZEOF(T) * index))
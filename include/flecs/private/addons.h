@@ -51,6 +51,9 @@
 #ifdef FLECS_NO_UNITS
 #undef FLECS_UNITS
 #endif
+#ifdef FLECS_NO_SNAPSHOT
+#undef FLECS_SNAPSHOT
+#endif
 #ifdef FLECS_NO_JSON
 #undef FLECS_JSON
 #endif
@@ -158,6 +161,13 @@
 #include "../addons/alerts.h"
 #endif
 
+#ifdef FLECS_SNAPSHOT
+#ifdef FLECS_NO_SNAPSHOT
+#error "FLECS_NO_SNAPSHOT failed: SNAPSHOT is required by other addons"
+#endif
+#include "../addons/snapshot.h"
+#endif
+
 #ifdef FLECS_JSON
 #ifdef FLECS_NO_JSON
 #error "FLECS_NO_JSON failed: JSON is required by other addons"
@@ -24,6 +24,7 @@ extern "C" {
 #define EcsWorldMeasureSystemTime     (1u << 6)
 #define EcsWorldMultiThreaded         (1u << 7)
 #define EcsWorldFrameInProgress       (1u << 8)
+#define EcsWorldParallelMerge         (1u << 9)
 
 ////////////////////////////////////////////////////////////////////////////////
 //// OS API flags
@@ -92,6 +93,8 @@ extern "C" {
         EcsIdHasOnTableCreate|EcsIdHasOnTableDelete|EcsIdSparse|\
         EcsIdOrderedChildren)
 #define EcsIdPrefabChildren            (1u << 26)
+#define EcsIdSoA                       (1u << 27)
+#define EcsIdDenseToggle               (1u << 28)
 
 #define EcsIdMarkedForDelete           (1u << 30)
 
@@ -216,7 +219,9 @@ extern "C" {
 #define EcsObserverBypassQuery         (1u << 7u)  /* Don't evaluate query for multi-component observer. */
 #define EcsObserverYieldOnCreate       (1u << 8u)  /* Yield matching entities when creating observer. */
 #define EcsObserverYieldOnDelete       (1u << 9u)  /* Yield matching entities when deleting observer. */
+#define EcsObserverCoalesce            (1u << 10u) /* Store events and deliver them when flushed. */
 #define EcsObserverKeepAlive           (1u << 11u) /* Observer keeps component alive (same value as EcsTermKeepAlive). */
+#define EcsObserverMultiThreaded       (1u << 12u) /* Deliver coalesced events on worker threads. */
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Table flags (used by ecs_table_t::flags)
@@ -255,6 +260,7 @@ extern "C" {
 #define EcsTableEdgeReparent           (1u << 28u)
 #define EcsTableMarkedForDelete        (1u << 29u)
 #define EcsTableNotEmpty               (1u << 30u) /* Does the table have entities. */
+#define EcsTableHasDenseToggle         (1u << 31u) /* Are enabled rows stored at the start of the table. */
 
 /* Composite table flags */
 #define EcsTableHasLifecycle     (EcsTableHasCtors | EcsTableHasDtors)
@@ -96,6 +96,10 @@ typedef struct ecs_page_iter_t {
 typedef struct ecs_worker_iter_t {
     int32_t index;
     int32_t count;
+    int32_t *cursor;             /* Shared chunk counter (dynamic iterator) */
+    int32_t chunk_size;          /* Max number of entities per chunk */
+    int32_t chunk;               /* Index of next chunk in chained iterator */
+    bool split;                  /* Chained iterator only returns results for worker */
 } ecs_worker_iter_t;
 
 /* Inlined element stored in a table cache. */
@@ -146,6 +150,7 @@ typedef struct ecs_query_iter_t {
     int32_t cur, all_cur;                     /* Indices into tables and all_tables. */
 
     ecs_query_op_profile_t *profile;
+    struct ecs_query_partition_t *partition;  /* Tables iterated by worker (worker iterators). */
 
     int16_t op;                               /* Currently iterated query plan operation (index into ops). */
     bool iter_single_group;
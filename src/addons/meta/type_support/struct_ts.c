@@ -60,6 +60,105 @@ void flecs_set_struct_member(
     member->warning_range = m->warning_range;
 }
 
+/* Register the members of a struct with the SoA trait as components. Each
+ * member is added to the struct with a (With, member) pair, which stores the
+ * member in its own table column when the struct is added to an entity. */
+static
+int flecs_struct_init_soa(
+    ecs_world_t *world,
+    ecs_entity_t type)
+{
+    const EcsStruct *s = ecs_get(world, type, EcsStruct);
+    if (!s) {
+        return 0;
+    }
+
+    int32_t i, count = ecs_vec_count(&s->members);
+    for (i = 0; i < count; i ++) {
+        /* Reobtain struct, as registering members can modify the world */
+        EcsStruct *st = ecs_get_mut(world, type, EcsStruct);
+        ecs_assert(st != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_member_t *m = ecs_vec_get_t(&st->members, ecs_member_t, i);
+        ecs_entity_t member = m->member;
+
+        if (member == type) {
+            continue;
+        }
+
+        if (m->count > 1) {
+            char *path = ecs_get_path(world, type);
+            ecs_err("member '%s.%s' of SoA struct cannot be an array",
+                path, m->name);
+            ecs_os_free(path);
+            return -1;
+        }
+
+        const ecs_type_info_t *ti = ecs_get_type_info(world, m->type);
+        if (!ti) {
+            char *path = ecs_get_path(world, type);
+            ecs_err("type of member '%s.%s' is not a component", 
+                path, m->name);
+            ecs_os_free(path);
+            return -1;
+        }
+
+        if (!member) {
+            /* Member entity is used as component. EcsMember is assigned without
+             * calling modified, as the struct already contains the member. */
+            member = ecs_new_from_path(world, type, m->name);
+            EcsMember *mbr = ecs_ensure(world, member, EcsMember);
+            mbr->type = m->type;
+            mbr->count = m->count;
+            mbr->offset = m->offset;
+            mbr->unit = m->unit;
+
+            st = ecs_get_mut(world, type, EcsStruct);
+            ecs_vec_get_t(&st->members, ecs_member_t, i)->member = member;
+        }
+
+        if (!ecs_has(world, member, EcsComponent)) {
+            /* Use lifecycle callbacks of the member type. Contexts are owned
+             * by the member type, and are not freed by the member component. */
+            ecs_type_hooks_t hooks = ti->hooks;
+            hooks.on_add = NULL;
+            hooks.on_set = NULL;
+            hooks.on_remove = NULL;
+            hooks.on_replace = NULL;
+            hooks.on_validate = NULL;
+            hooks.ctx_free = NULL;
+            hooks.binding_ctx_free = NULL;
+            hooks.lifecycle_ctx_free = NULL;
+
+            ecs_component_init(world, &(ecs_component_desc_t){
+                .entity = member,
+                .type.size = ti->size,
+                .type.alignment = ti->alignment,
+                .type.hooks = hooks
+            });
+        }
+
+        /* Serialize member component with the serializer of the member type,
+         * so that member columns can be (de)serialized as values. */
+        const EcsTypeSerializer *ser = ecs_get(
+            world, m->type, EcsTypeSerializer);
+        if (ser && !ecs_has(world, member, EcsTypeSerializer)) {
+            ecs_set_ptr(world, member, EcsTypeSerializer, ser);
+        }
+
+        ecs_add_pair(world, type, EcsWith, member);
+    }
+
+    return 0;
+}
+
+static
+void flecs_struct_soa_on_add(ecs_iter_t *it) {
+    int32_t i, count = it->count;
+    for (i = 0; i < count; i ++) {
+        flecs_struct_init_soa(it->world, it->entities[i]);
+    }
+}
+
 static
 int flecs_add_member_to_struct(
     ecs_world_t *world,
@@ -291,6 +390,13 @@ int flecs_add_member_to_struct(
         ecs_modified(world, struct_type, EcsMember);
     }
 
+    /* Members added to SoA structs are stored in their own column */
+    if (ecs_owns_id(world, struct_type, EcsSoA)) {
+        if (flecs_struct_init_soa(world, struct_type)) {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
@@ -706,6 +812,16 @@ void flecs_meta_struct_init(
         .global_observer = true
     });
 
+    ecs_observer(world, {
+        .query.terms = {
+            { .id = EcsSoA }, 
+            { .id = ecs_id(EcsStruct), .inout = EcsInOutNone }
+        },
+        .events = {EcsOnAdd},
+        .callback = flecs_struct_soa_on_add,
+        .global_observer = true
+    });
+
     ecs_set(world, ecs_id(EcsStruct),  EcsDefaultChildComponent, {ecs_id(EcsMember)});
     ecs_add_pair(world, ecs_id(EcsStruct), EcsWith, ecs_id(EcsComponent));
     ecs_set(world, ecs_id(EcsMember),  EcsDefaultChildComponent, {ecs_id(EcsMember)});
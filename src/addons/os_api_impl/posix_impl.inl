@@ -6,6 +6,10 @@
 #include "pthread.h"
 #include <dlfcn.h>
 
+#if defined(__linux__) && defined(FLECS_HUGE_PAGES)
+#include <sys/mman.h>
+#endif
+
 #if defined(__APPLE__) && defined(__MACH__)
 #include <mach/mach_time.h>
 #elif defined(__EMSCRIPTEN__)
@@ -319,6 +323,56 @@ void posix_dlclose(ecs_os_dl_t lib) {
     dlclose((void*)(uintptr_t)lib);
 }
 
+#if defined(__linux__) && defined(FLECS_HUGE_PAGES)
+static
+void* posix_page_alloc(ecs_size_t size) {
+    size_t len = (size_t)size;
+    void *result;
+
+#ifdef MAP_HUGETLB
+    /* Use explicit huge pages if the system has reserved them */
+    if (!(len % FLECS_HUGE_PAGE_SIZE)) {
+        result = mmap(NULL, len, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (result != MAP_FAILED) {
+            return result;
+        }
+    }
+#endif
+
+    /* Transparent huge pages require memory that is aligned to the huge page
+     * size, so map more than requested and unmap the unaligned part. */
+    size_t align = (size_t)FLECS_HUGE_PAGE_SIZE;
+    void *ptr = mmap(NULL, len + align, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+    if (aligned != start) {
+        munmap(ptr, aligned - start);
+    }
+
+    size_t tail = (start + len + align) - (aligned + len);
+    if (tail) {
+        munmap((void*)(aligned + len), tail);
+    }
+
+    result = (void*)aligned;
+#ifdef MADV_HUGEPAGE
+    madvise(result, len, MADV_HUGEPAGE);
+#endif
+    return result;
+}
+
+static
+void posix_page_free(void *ptr, ecs_size_t size) {
+    munmap(ptr, (size_t)size);
+}
+#endif
+
 void ecs_set_os_api_impl(void) {
     ecs_os_set_api_defaults();
 
@@ -347,6 +401,10 @@ void ecs_set_os_api_impl(void) {
     api.dlopen_ = posix_dlopen;
     api.dlproc_ = posix_dlproc;
     api.dlclose_ = posix_dlclose;
+#if defined(__linux__) && defined(FLECS_HUGE_PAGES)
+    api.page_alloc_ = posix_page_alloc;
+    api.page_free_ = posix_page_free;
+#endif
 
     posix_time_setup();
 
@@ -168,6 +168,10 @@ void ecs_frame_end(
         flecs_stage_merge_post_frame(world, world->stages[i]);
     }
 
+    if (world->compact.enabled) {
+        ecs_compact(world, &world->compact.desc);
+    }
+
     flecs_stop_measure_frame(world);
 
     /* Reset command handler each frame */
@@ -19,6 +19,7 @@ static void flecs_pipeline_state_free(
         ecs_allocator_t *a = &world->allocator;
         ecs_vec_fini_t(a, &p->ops, ecs_pipeline_op_t);
         ecs_vec_fini_t(a, &p->systems, ecs_system_t*);
+        ecs_vec_fini_t(a, &p->barriers, bool);
         ecs_os_free(p);
     }
 }
@@ -250,6 +251,101 @@ bool flecs_pipeline_check_terms(
     return needs_merge;
 }
 
+/* Component access of a system that runs in a multithreaded operation. Used to
+ * determine whether systems in the same operation can run at the same time. */
+typedef struct ecs_pipeline_access_t {
+    ecs_id_t id;
+    bool write;
+    bool dynamic;               /* Whether system uses dynamic scheduling */
+} ecs_pipeline_access_t;
+
+static
+bool flecs_pipeline_system_is_dynamic(
+    const ecs_system_t *sys)
+{
+    return sys->multi_threaded && sys->chunk_size;
+}
+
+static
+bool flecs_pipeline_access_conflicts(
+    const ecs_pipeline_access_t *a,
+    const ecs_pipeline_access_t *b)
+{
+    if (!a->write && !b->write) {
+        return false;
+    }
+
+    return a->id == b->id || ecs_id_match(a->id, b->id) || 
+        ecs_id_match(b->id, a->id);
+}
+
+/* Test if a system conflicts with systems that may still be running on other
+ * threads. Systems that both use static scheduling never conflict, as they
+ * process the same entities on the same thread. */
+static
+bool flecs_pipeline_check_access(
+    ecs_allocator_t *a,
+    ecs_vec_t *running,
+    ecs_system_t *sys)
+{
+    bool dynamic = flecs_pipeline_system_is_dynamic(sys);
+    bool conflict = false;
+    int32_t added = ecs_vec_count(running);
+
+    ecs_query_t *q = sys->query;
+    int32_t t, term_count = q->term_count;
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &q->terms[t];
+        int16_t inout = term->inout;
+        if (inout == EcsInOutFilter || inout == EcsInOutNone) {
+            continue;
+        }
+
+        if (inout == EcsInOutDefault) {
+            if (ecs_term_match_0(term)) {
+                continue;
+            } else if (!ecs_term_match_this(term) || 
+                !(term->src.id & EcsSelf)) 
+            {
+                inout = EcsIn;
+            } else {
+                inout = EcsInOut;
+            }
+        }
+
+        ecs_pipeline_access_t access = {
+            .id = term->id,
+            .write = inout != EcsIn,
+            .dynamic = dynamic
+        };
+
+        int32_t i;
+        ecs_pipeline_access_t *cur = ecs_vec_first(running);
+        for (i = 0; i < added; i ++) {
+            if (!dynamic && !cur[i].dynamic) {
+                continue;
+            }
+            if (flecs_pipeline_access_conflicts(&access, &cur[i])) {
+                conflict = true;
+                break;
+            }
+        }
+
+        ecs_vec_append_t(a, running, ecs_pipeline_access_t)[0] = access;
+    }
+
+    if (conflict) {
+        /* Threads are synchronized before system runs, so only the access of
+         * this system remains relevant for subsequent systems. */
+        int32_t count = ecs_vec_count(running) - added;
+        ecs_pipeline_access_t *cur = ecs_vec_first(running);
+        ecs_os_memmove_n(cur, &cur[added], ecs_pipeline_access_t, count);
+        ecs_vec_set_count_t(a, running, ecs_pipeline_access_t, count);
+    }
+
+    return conflict;
+}
+
 static
 EcsPoly* flecs_pipeline_term_system(
     ecs_iter_t *it)
@@ -287,6 +383,11 @@ bool flecs_pipeline_build(
 
     ecs_vec_reset_t(a, &pq->ops, ecs_pipeline_op_t);
     ecs_vec_reset_t(a, &pq->systems, ecs_system_t*);
+    ecs_vec_reset_t(a, &pq->barriers, bool);
+
+    /* Access of systems in current operation since the last barrier */
+    ecs_vec_t running;
+    ecs_vec_init_t(a, &running, ecs_pipeline_access_t, 0);
 
     bool multi_threaded = false;
     bool immediate = false;
@@ -357,6 +458,7 @@ bool flecs_pipeline_build(
             }
 
             if (!op) {
+                ecs_vec_clear(&running);
                 op = ecs_vec_append_t(a, &pq->ops, ecs_pipeline_op_t);
                 op->offset = ecs_vec_count(&pq->systems);
                 op->count = 0;
@@ -364,6 +466,7 @@ bool flecs_pipeline_build(
                 op->immediate = false;
                 op->time_spent = 0;
                 op->commands_enqueued = 0;
+                op->wait_time = 0;
             }
 
             /* Don't increase count for inactive systems, as they are ignored by
@@ -374,6 +477,17 @@ bool flecs_pipeline_build(
                     op->multi_threaded = multi_threaded;
                     op->immediate = immediate;
                 }
+
+                /* Threads don't sync between systems in the same operation. If
+                 * a system conflicts with a system that could still be running
+                 * on another thread, insert a barrier. */
+                bool barrier = false;
+                if (op->multi_threaded) {
+                    barrier = flecs_pipeline_check_access(a, &running, sys);
+                }
+                ecs_vec_append_t(a, &pq->barriers, bool)[0] = 
+                    barrier && op->count;
+
                 op->count ++;
             }
         }
@@ -385,6 +499,7 @@ bool flecs_pipeline_build(
 
     ecs_map_fini(&ws.ids);
     ecs_map_fini(&ws.wildcard_ids);
+    ecs_vec_fini_t(a, &running, ecs_pipeline_access_t);
 
     op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
 
@@ -403,9 +518,14 @@ bool flecs_pipeline_build(
         int32_t i, count = ecs_vec_count(&pq->systems);
         int32_t op_index = 0, ran_since_merge = 0;
         ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+        bool *barriers = ecs_vec_first_t(&pq->barriers, bool);
         for (i = 0; i < count; i ++) {
             ecs_system_t *sys = systems[i];
             ecs_entity_t system = sys->query->entity;
+
+            if (barriers[i]) {
+                ecs_dbg("#[magenta]barrier#[reset]");
+            }
             ecs_assert(system != 0, ECS_INTERNAL_ERROR, NULL);
             (void)system;
 
@@ -543,6 +663,26 @@ void ecs_run_pipeline(
     }
 }
 
+/* Move values of commands enqueued by all threads into component storage, 
+ * before the main thread merges the remaining commands. Each thread first 
+ * partitions the commands of its own stage by entity, after which each thread 
+ * merges a single partition from all stages. */
+static
+void flecs_pipeline_merge_partition(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t stage_index,
+    int32_t stage_count)
+{
+    /* Wait until all threads are done enqueueing commands */
+    flecs_worker_barrier(world);
+    flecs_commands_partition(world, stage, stage_count);
+
+    /* Wait until all queues are partitioned */
+    flecs_worker_barrier(world);
+    flecs_commands_merge_partition(world, stage_index);
+}
+
 int32_t flecs_run_pipeline_ops(
     ecs_world_t* world,
     ecs_stage_t* stage,
@@ -558,11 +698,20 @@ int32_t flecs_run_pipeline_ops(
 
     int32_t count = ecs_vec_count(&pq->systems);
     ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    bool *barriers = ecs_vec_first_t(&pq->barriers, bool);
+    bool multi_threaded = world->flags & EcsWorldMultiThreaded;
     int32_t ran_since_merge = i - op->offset;
+    int32_t first = i;
 
     for (; i < count; i++) {
         ecs_system_t* sys = systems[i];
 
+        /* Wait for other threads if system conflicts with a system that could
+         * still be running on another thread. */
+        if (multi_threaded && barriers[i] && i != first) {
+            flecs_worker_barrier(world);
+        }
+
         /* Keep track of the last frame for which the system has run, so we
          * know from where to resume the schedule in case the schedule
          * changes during a merge. */
@@ -577,8 +726,15 @@ int32_t flecs_run_pipeline_ops(
             s = stage;
         }
 
+        /* If the system distributes its entities in chunks, workers claim
+         * chunks from a counter that was reset before the workers started */
+        int32_t *chunk_cursor = NULL;
+        if (sys->chunk_size && (world->flags & EcsWorldMultiThreaded)) {
+            chunk_cursor = &sys->chunk_cursor;
+        }
+
         flecs_run_system(world, s, sys->query->entity, sys, stage_index,
-            stage_count, delta_time, NULL);
+            stage_count, chunk_cursor, delta_time, NULL);
 
         ecs_os_linc(&world->info.systems_ran_total);
         ran_since_merge++;
@@ -589,9 +745,29 @@ int32_t flecs_run_pipeline_ops(
         }
     }
 
+    if (multi_threaded && !op->immediate && 
+        (world->flags & EcsWorldParallelMerge)) 
+    {
+        flecs_pipeline_merge_partition(world, stage, stage_index, stage_count);
+    }
+
     return i;
 }
 
+/* Reset chunk counters of systems in the current operation. Must be called
+ * before workers are signaled, as workers claim chunks from the counters. */
+static
+void flecs_pipeline_reset_chunks(
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_system_t **systems = ecs_vec_first_t(&pq->systems, ecs_system_t*);
+    int32_t i, end = op->offset + op->count;
+    for (i = pq->cur_i; i < end; i ++) {
+        systems[i]->chunk_cursor = 0;
+    }
+}
+
 void flecs_run_pipeline(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -639,6 +815,7 @@ void flecs_run_pipeline(
         ecs_assert(world->workers_waiting == 0, ECS_INTERNAL_ERROR, NULL);
 
         if (op_multi_threaded) {
+            flecs_pipeline_reset_chunks(pq);
             flecs_signal_workers(world);
         }
 
@@ -657,7 +834,16 @@ void flecs_run_pipeline(
         }
 
         if (op_multi_threaded) {
+            ecs_time_t wt = { 0 };
+            if (measure_time) {
+                ecs_time_measure(&wt);
+            }
+
             flecs_wait_for_sync(world);
+
+            if (measure_time) {
+                pq->cur_op->wait_time += ecs_time_measure(&wt);
+            }
         }
 
         if (!immediate) {
@@ -670,6 +856,8 @@ void flecs_run_pipeline(
             for (si = 0; si < stage_count; si ++) {
                 ecs_stage_t *s = world->stages[si];
                 pq->cur_op->commands_enqueued += ecs_vec_count(&s->cmd->queue);
+                world->info.cmd.parallel_merged_count += s->cmd_merged_count;
+                s->cmd_merged_count = 0;
             }
 
             ecs_readonly_end(world);
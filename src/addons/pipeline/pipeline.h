@@ -15,6 +15,7 @@ typedef struct ecs_pipeline_op_t {
     int32_t count;              /* Number of systems to run before next op */
     double time_spent;          /* Time spent merging commands for sync point */
     int64_t commands_enqueued;  /* Number of commands enqueued for sync point */
+    double wait_time;           /* Time main thread waited for workers */
     bool multi_threaded;        /* Whether systems can be run multi-threaded */
     bool immediate;           /* Whether systems run in immediate mode */
 } ecs_pipeline_op_t;
@@ -23,6 +24,7 @@ struct ecs_pipeline_state_t {
     ecs_query_t *query;         /* Pipeline query */
     ecs_vec_t ops;              /* Pipeline schedule */
     ecs_vec_t systems;          /* Vector with system ids */
+    ecs_vec_t barriers;         /* Whether threads sync before system (bool) */
 
     ecs_entity_t last_system;   /* Last system run by pipeline */
     int32_t match_count;        /* Used to track if rebuild is necessary */
@@ -77,4 +79,7 @@ void flecs_signal_workers(
 void flecs_wait_for_sync(
     ecs_world_t *world);
 
+void flecs_worker_barrier(
+    ecs_world_t *world);
+
 #endif
@@ -9,6 +9,66 @@
 #ifdef FLECS_PIPELINE
 #include "pipeline.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Read value that is concurrently modified by other threads with a relaxed
+ * atomic load. The value is only used as a hint to stop spinning, threads
+ * always check the actual condition while holding the sync mutex. */
+static
+int32_t flecs_worker_poll(
+    const int32_t *value)
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return (int32_t)__iso_volatile_load32((const volatile int*)value);
+#else
+    return *(const volatile int32_t*)value;
+#endif
+}
+
+/* Tell the CPU that the thread is in a spin loop, which reduces power usage
+ * and frees up resources for the other thread on the same core. */
+static
+void flecs_worker_pause(void) {
+#if (defined(__clang__) || defined(__GNUC__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__clang__) || defined(__GNUC__)) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    __yield();
+#endif
+}
+
+/* Spin and then yield until (*value == expect) equals the provided condition,
+ * or until the spin and yield budget runs out. */
+static
+void flecs_worker_spin(
+    const ecs_world_t *world,
+    const int32_t *value,
+    int32_t expect,
+    bool equal)
+{
+    int32_t i, spin_count = world->worker_spin_count;
+    int32_t count = spin_count + world->worker_yield_count;
+    for (i = 0; i < count; i ++) {
+        if ((flecs_worker_poll(value) == expect) == equal) {
+            break;
+        }
+
+        if (i >= spin_count) {
+            ecs_os_sleep(0, 0);
+        } else {
+            flecs_worker_pause();
+        }
+    }
+}
+
 /* Synchronize workers */
 static
 void flecs_sync_worker(
@@ -21,13 +81,22 @@ void flecs_sync_worker(
 
     /* Signal that thread is waiting */
     ecs_os_mutex_lock(world->sync_mutex);
+    int32_t epoch = world->workers_epoch;
     if (++world->workers_waiting == (stage_count - 1)) {
         /* Only signal main thread when all threads are waiting */
         ecs_os_cond_signal(world->sync_cond);
     }
 
+    if (world->worker_spin_count || world->worker_yield_count) {
+        ecs_os_mutex_unlock(world->sync_mutex);
+        flecs_worker_spin(world, &world->workers_epoch, epoch, false);
+        ecs_os_mutex_lock(world->sync_mutex);
+    }
+
     /* Wait until main thread signals that thread can continue */
-    ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+    while (epoch == world->workers_epoch) {
+        ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+    }
     ecs_os_mutex_unlock(world->sync_mutex);
 }
 
@@ -57,8 +126,13 @@ void* flecs_worker(void *arg) {
         ecs_entity_t old_scope = ecs_set_scope((ecs_world_t*)stage, 0);
 
         ecs_dbg_3("worker %d: run", stage->id);
-        flecs_run_pipeline_ops(world, stage, stage->id, world->stage_count, 
-            world->info.delta_time);
+        flecs_worker_job_t job = world->worker_job;
+        if (job) {
+            job(world, stage->id, world->stage_count, world->worker_job_ctx);
+        } else {
+            flecs_run_pipeline_ops(world, stage, stage->id, 
+                world->stage_count, world->info.delta_time);
+        }
 
         ecs_set_scope((ecs_world_t*)stage, old_scope);
 
@@ -149,8 +223,10 @@ void flecs_wait_for_sync(
 
     ecs_dbg_3("#[bold]pipeline: waiting for worker sync");
 
+    flecs_worker_spin(world, &world->workers_waiting, stage_count - 1, true);
+
     ecs_os_mutex_lock(world->sync_mutex);
-    if (world->workers_waiting != (stage_count - 1)) {
+    while (world->workers_waiting != (stage_count - 1)) {
         ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
     }
 
@@ -164,6 +240,38 @@ void flecs_wait_for_sync(
     ecs_dbg_3("#[bold]pipeline: workers synced");
 }
 
+/* Wait until all threads (main thread and workers) reach the barrier. Used to
+ * order systems within a pipeline operation that have conflicting access. */
+void flecs_worker_barrier(
+    ecs_world_t *world)
+{
+    int32_t stage_count = ecs_get_stage_count(world);
+    if (stage_count <= 1) {
+        return;
+    }
+
+    ecs_os_mutex_lock(world->sync_mutex);
+    int32_t generation = world->barrier_generation;
+    if (++world->barrier_waiting == stage_count) {
+        /* Last thread to arrive releases the others */
+        world->barrier_waiting = 0;
+        world->barrier_generation ++;
+        ecs_os_cond_broadcast(world->barrier_cond);
+    } else {
+        if (world->worker_spin_count || world->worker_yield_count) {
+            ecs_os_mutex_unlock(world->sync_mutex);
+            flecs_worker_spin(world, &world->barrier_generation, 
+                generation, false);
+            ecs_os_mutex_lock(world->sync_mutex);
+        }
+
+        while (generation == world->barrier_generation) {
+            ecs_os_cond_wait(world->barrier_cond, world->sync_mutex);
+        }
+    }
+    ecs_os_mutex_unlock(world->sync_mutex);
+}
+
 /* Signal workers that they can start/resume work */
 void flecs_signal_workers(
     ecs_world_t *world)
@@ -175,6 +283,7 @@ void flecs_signal_workers(
 
     ecs_dbg_3("#[bold]pipeline: signal workers");
     ecs_os_mutex_lock(world->sync_mutex);
+    world->workers_epoch ++;
     ecs_os_cond_broadcast(world->worker_cond);
     ecs_os_mutex_unlock(world->sync_mutex);
 }
@@ -223,7 +332,70 @@ void flecs_join_worker_threads(
     ecs_assert(world->workers_running == 0, ECS_INTERNAL_ERROR, NULL);
 }
 
+/* Test if world has worker threads that can run a job */
+static
+bool flecs_workers_idle(
+    ecs_world_t *world)
+{
+    /* Task threads only exist while a pipeline is running */
+    return ecs_get_stage_count(world) > 1 && world->worker_cond && 
+        !ecs_using_task_threads(world) && !(world->flags & EcsWorldReadonly);
+}
+
 /* -- Private functions -- */
+bool flecs_workers_run(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    int32_t stage_count = ecs_get_stage_count(world);
+
+    if (!flecs_workers_idle(world)) {
+        return false;
+    }
+
+    /* Make sure workers are running and ready */
+    flecs_wait_for_workers(world);
+
+    world->worker_job = job;
+    world->worker_job_ctx = ctx;
+    flecs_signal_workers(world);
+
+    job(world, 0, stage_count, ctx);
+
+    flecs_wait_for_sync(world);
+    world->worker_job = NULL;
+    world->worker_job_ctx = NULL;
+
+    return true;
+}
+
+bool flecs_workers_run_deferred(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx)
+{
+    flecs_poly_assert(world, ecs_world_t);
+
+    if (!flecs_workers_idle(world)) {
+        return false;
+    }
+
+    /* Stages can't be merged into a deferred world, so suspend deferring of
+     * the world while the job is running. */
+    ecs_suspend_readonly_state_t srs;
+    flecs_suspend_readonly(world, &srs);
+
+    flecs_stage_job_begin(world);
+    flecs_workers_run(world, job, ctx);
+    flecs_stage_job_end(world);
+
+    flecs_resume_readonly(world, &srs);
+
+    return true;
+}
+
 void flecs_workers_progress(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -269,6 +441,9 @@ void flecs_set_threads_internal(
             if (world->sync_cond) {
                 ecs_os_cond_free(world->sync_cond);
             }
+            if (world->barrier_cond) {
+                ecs_os_cond_free(world->barrier_cond);
+            }
             if (world->sync_mutex) {
                 ecs_os_mutex_free(world->sync_mutex);
             }
@@ -280,6 +455,7 @@ void flecs_set_threads_internal(
         if (threads > 1) {
             world->worker_cond = ecs_os_cond_new();
             world->sync_cond = ecs_os_cond_new();
+            world->barrier_cond = ecs_os_cond_new();
             world->sync_mutex = ecs_os_mutex_new();
             flecs_start_workers(world, threads);
         }
@@ -308,4 +484,34 @@ bool ecs_using_task_threads(
     return world->workers_use_task_api;
 }
 
+void ecs_set_parallel_merge(
+    ecs_world_t *world,
+    bool enable)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot change parallel merge while running a pipeline");
+    ECS_BIT_COND(world->flags, EcsWorldParallelMerge, enable);
+error:
+    return;
+}
+
+void ecs_set_worker_spin(
+    ecs_world_t *world,
+    int32_t spin_count,
+    int32_t yield_count)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(spin_count >= 0, ECS_INVALID_PARAMETER, 
+        "spin count cannot be negative");
+    ecs_check(yield_count >= 0, ECS_INVALID_PARAMETER, 
+        "yield count cannot be negative");
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot change worker spin while running a pipeline");
+    world->worker_spin_count = spin_count;
+    world->worker_yield_count = yield_count;
+error:
+    return;
+}
+
 #endif
@@ -1144,6 +1144,7 @@ void flecs_world_stats_to_json(
     ECS_COUNTER_APPEND(reply, stats, memory.stack_alloc_count, "Pages allocated by stack allocators");
     ECS_COUNTER_APPEND(reply, stats, memory.stack_free_count, "Pages freed by stack allocators");
     ECS_GAUGE_APPEND(reply, stats, memory.stack_outstanding_alloc_count, "Outstanding page allocations");
+    ECS_COUNTER_APPEND(reply, stats, memory.compact_reclaimed_bytes, "Bytes reclaimed by compaction");
 
     ECS_COUNTER_APPEND(reply, stats, http.request_received_count, "Received requests");
     ECS_COUNTER_APPEND(reply, stats, http.request_invalid_count, "Received invalid requests");
@@ -1199,6 +1200,7 @@ void flecs_sync_stats_to_json(
 
     ECS_GAUGE_APPEND_T(&reply->body, stats, time_spent, pstats->t, "");
     ECS_GAUGE_APPEND_T(&reply->body, stats, commands_enqueued, pstats->t, "");
+    ECS_GAUGE_APPEND_T(&reply->body, stats, wait_time, pstats->t, "");
 
     ecs_strbuf_list_pop(&reply->body, "}");
 }
@@ -0,0 +1,2705 @@
+/**
+ * @file addons/snapshot.c
+ * @brief Binary world snapshot addon.
+ *
+ * A snapshot starts with a header, followed by a block for each serialized
+ * table and a section with the components used by the tables. A table block
+ * contains the table type, an encoding for each id in the type, the entity ids
+ * and the values for each id that has data. Values of components without
+ * lifecycle hooks are stored as raw column data, aligned so that the data can
+ * be copied directly from a buffer (or memory-mapped file) into table storage.
+ *
+ * A diff uses the same table block encoding. A diff contains the entities that
+ * were deleted, a block with all ids for entities that are new in a table and
+ * a block with only the changed columns for entities that were already in the
+ * table when the previous diff was acknowledged.
+ */
+
+#include <errno.h>
+
+#include "../private_api.h"
+
+#ifdef FLECS_SNAPSHOT
+
+#define FLECS_SNAPSHOT_MAGIC (0x4e534c46) /* "FLSN" */
+#define FLECS_SNAPSHOT_BYTE_ORDER (0x01020304)
+#define FLECS_SNAPSHOT_COLUMN_ALIGN (16)
+#define FLECS_SNAPSHOT_ALIGN (8)
+#define FLECS_SNAPSHOT_DIFF_MAGIC (0x46444c46) /* "FLDF" */
+#define FLECS_REPLICATOR_MAX_PENDING (64)
+
+/* How the values for an id in a table block are stored */
+typedef enum ecs_snapshot_kind_t {
+    EcsSnapshotTag,        /* No values */
+    EcsSnapshotRaw,        /* Raw column data */
+    EcsSnapshotParent,     /* Raw EcsParent values, restored with ecs_set() */
+    EcsSnapshotName,       /* (Identifier, Name) strings */
+    EcsSnapshotSymbol,     /* (Identifier, Symbol) strings */
+    EcsSnapshotAlias,      /* (Identifier, Alias) strings */
+    EcsSnapshotJson,       /* Values serialized with reflection data */
+    EcsSnapshotSkip        /* Id is not stored (writer only) */
+} ecs_snapshot_kind_t;
+
+/* Common start of snapshot and diff headers */
+typedef struct ecs_snapshot_preamble_t {
+    uint32_t magic;
+    uint32_t byte_order;
+    uint32_t version;
+    uint32_t pointer_size;
+} ecs_snapshot_preamble_t;
+
+typedef struct ecs_snapshot_header_t {
+    ecs_snapshot_preamble_t preamble;
+    uint32_t table_count;
+    uint32_t component_count;
+    uint64_t components_offset;
+    uint64_t max_id;
+} ecs_snapshot_header_t;
+
+typedef struct ecs_snapshot_component_t {
+    uint64_t id;
+    int32_t size;
+    int32_t alignment;
+    int32_t name_length;
+    int32_t reserved;
+} ecs_snapshot_component_t;
+
+typedef struct ecs_snapshot_diff_header_t {
+    ecs_snapshot_preamble_t preamble;
+    uint32_t table_count;       /* Blocks with entities that are new in table */
+    uint32_t update_count;      /* Blocks with changed columns */
+    uint32_t deleted_count;
+    uint32_t component_count;
+    uint64_t components_offset;
+    uint64_t frame;
+} ecs_snapshot_diff_header_t;
+
+typedef struct ecs_snapshot_table_header_t {
+    int32_t id_count;
+    int32_t count;
+} ecs_snapshot_table_header_t;
+
+/* Table block in a snapshot that is being restored */
+typedef struct ecs_snapshot_table_t {
+    int32_t id_count;
+    int32_t count;
+    const ecs_id_t *ids;
+    const uint8_t *kinds;
+    const ecs_entity_t *entities;
+    int32_t blocks;        /* Offset into blocks vector of reader */
+} ecs_snapshot_table_t;
+
+typedef struct ecs_snapshot_reader_t {
+    const char *start;
+    const char *ptr;
+    const char *end;
+} ecs_snapshot_reader_t;
+
+/* Table that is being serialized, with sort key */
+typedef struct ecs_snapshot_sort_t {
+    ecs_table_t *table;
+    int32_t depth;
+} ecs_snapshot_sort_t;
+
+static
+void* flecs_snapshot_write(
+    ecs_vec_t *buf,
+    const void *data,
+    ecs_size_t size)
+{
+    void *dst = ecs_vec_grow_t(NULL, buf, char, size);
+    if (data) {
+        ecs_os_memcpy(dst, data, size);
+    } else {
+        ecs_os_memset(dst, 0, size);
+    }
+    return dst;
+}
+
+/* Snapshot sizes are stored as ecs_size_t, which limits a snapshot to 2GB.
+ * Check that data of the specified size fits before writing it. */
+static
+int flecs_snapshot_write_check(
+    const ecs_vec_t *buf,
+    int64_t size)
+{
+    if (size > (int64_t)INT32_MAX - ecs_vec_count(buf)) {
+        ecs_err("snapshot: data exceeds maximum snapshot size of 2GB");
+        return -1;
+    }
+    return 0;
+}
+
+static
+void flecs_snapshot_write_align(
+    ecs_vec_t *buf,
+    ecs_size_t alignment)
+{
+    int32_t count = ecs_vec_count(buf);
+    int32_t padding = ECS_ALIGN(count, alignment) - count;
+    if (padding) {
+        flecs_snapshot_write(buf, NULL, padding);
+    }
+}
+
+static
+bool flecs_snapshot_skip_parent(
+    const ecs_world_t *world,
+    ecs_entity_t parent)
+{
+    while (parent) {
+        if (parent == EcsFlecs || ecs_has_id(world, parent, EcsModule) ||
+            ecs_has(world, parent, EcsComponent))
+        {
+            return true;
+        }
+        parent = ecs_get_target(world, parent, EcsChildOf, 0);
+    }
+    return false;
+}
+
+/* Skip tables with builtin entities, modules, components and entities with
+ * poly objects (queries, observers, systems), which are created by code. */
+static
+bool flecs_snapshot_skip_table(
+    const ecs_world_t *world,
+    const ecs_table_t *table)
+{
+    if (!ecs_table_count(table)) {
+        return true;
+    }
+
+    if (table->flags & EcsTableHasBuiltins) {
+        return true;
+    }
+
+    int32_t i, count = table->type.count;
+    for (i = 0; i < count; i ++) {
+        ecs_id_t id = table->type.array[i];
+        if (id == ecs_id(EcsComponent) || id == EcsModule) {
+            return true;
+        }
+        if (ECS_IS_PAIR(id) && ECS_PAIR_FIRST(id) == ecs_id(EcsPoly)) {
+            return true;
+        }
+    }
+
+    if (table->flags & EcsTableHasChildOf) {
+        ecs_entity_t parent = ecs_pair_second(world,
+            table->type.array[table->childof_index]);
+        return flecs_snapshot_skip_parent(world, parent);
+    }
+
+    return false;
+}
+
+/* Tables are stored in order of hierarchy depth, so that parents are restored
+ * before their children. Prefabs are stored before other tables at the same
+ * depth, so that they are restored before their instances. */
+static
+int32_t flecs_snapshot_table_depth(
+    const ecs_world_t *world,
+    const ecs_table_t *table)
+{
+    int32_t depth = 0;
+
+    if (table->flags & EcsTableHasParent) {
+        int32_t i, count = table->type.count;
+        for (i = 0; i < count; i ++) {
+            ecs_id_t id = table->type.array[i];
+            if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+                depth = flecs_uto(int32_t, ECS_PAIR_SECOND(id));
+                break;
+            }
+        }
+    } else if (table->flags & EcsTableHasChildOf) {
+        ecs_entity_t parent = ecs_pair_second(world,
+            table->type.array[table->childof_index]);
+        depth = ecs_get_depth(world, parent, EcsChildOf) + 1;
+    }
+
+    return depth * 2 + !(table->flags & EcsTableIsPrefab);
+}
+
+static
+int flecs_snapshot_compare_table(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_snapshot_sort_t *t1 = ptr_1;
+    const ecs_snapshot_sort_t *t2 = ptr_2;
+    if (t1->depth != t2->depth) {
+        return (t1->depth > t2->depth) - (t1->depth < t2->depth);
+    }
+    return (t1->table->id > t2->table->id) - (t1->table->id < t2->table->id);
+}
+
+static
+ecs_snapshot_kind_t flecs_snapshot_id_kind(
+    const ecs_world_t *world,
+    ecs_id_t id,
+    const ecs_type_info_t **ti_out)
+{
+    *ti_out = NULL;
+
+    if (ECS_IS_VALUE_PAIR(id)) {
+        return EcsSnapshotTag;
+    }
+
+    if (ECS_IS_PAIR(id)) {
+        if (ECS_PAIR_FIRST(id) == ecs_id(EcsIdentifier)) {
+            *ti_out = ecs_get_type_info(world, id);
+            if (id == ecs_pair_t(EcsIdentifier, EcsName)) {
+                return EcsSnapshotName;
+            } else if (id == ecs_pair_t(EcsIdentifier, EcsSymbol)) {
+                return EcsSnapshotSymbol;
+            } else if (id == ecs_pair_t(EcsIdentifier, EcsAlias)) {
+                return EcsSnapshotAlias;
+            }
+            return EcsSnapshotSkip;
+        }
+    } else if (id & ECS_ID_FLAGS_MASK) {
+        return EcsSnapshotTag;
+    }
+
+    /* SoA components don't have a column. Their data is stored in the columns
+     * of the member components, which are serialized separately. */
+    ecs_component_record_t *cr = flecs_components_get(world, id);
+    if (cr && (cr->flags & EcsIdSoA)) {
+        return EcsSnapshotTag;
+    }
+
+    const ecs_type_info_t *ti = ecs_get_type_info(world, id);
+    if (!ti) {
+        return EcsSnapshotTag;
+    }
+
+    *ti_out = ti;
+
+    if (id == ecs_id(EcsParent)) {
+        return EcsSnapshotParent;
+    }
+
+    if (!ti->hooks.copy && !ti->hooks.move && !ti->hooks.dtor &&
+        !(ti->hooks.flags & ECS_TYPE_HOOK_COPY_ILLEGAL))
+    {
+        return EcsSnapshotRaw;
+    }
+
+    if (ecs_has(world, ti->component, EcsTypeSerializer)) {
+        return EcsSnapshotJson;
+    }
+
+    return EcsSnapshotSkip;
+}
+
+static
+const void* flecs_snapshot_get_ptr(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    int32_t column,
+    int32_t row,
+    ecs_id_t id,
+    ecs_size_t size)
+{
+    if (column != -1) {
+        return ECS_ELEM(ecs_table_get_column(table, column, 0), size, row);
+    } else {
+        /* Sparse component */
+        return ecs_get_id(world, ecs_table_entities(table)[row], id);
+    }
+}
+
+static
+int32_t flecs_snapshot_row(
+    const int32_t *rows,
+    int32_t index)
+{
+    return rows ? rows[index] : index;
+}
+
+static
+int flecs_snapshot_write_strings(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    const int32_t *rows,
+    int32_t count,
+    ecs_id_t id,
+    ecs_snapshot_kind_t kind,
+    const ecs_type_info_t *ti,
+    ecs_vec_t *buf)
+{
+    int32_t i;
+    int32_t column = ecs_table_get_column_index(world, table, id);
+    int32_t lengths = ecs_vec_count(buf);
+    if (flecs_snapshot_write_check(buf, 
+        (int64_t)count * ECS_SIZEOF(int32_t) + FLECS_SNAPSHOT_ALIGN)) 
+    {
+        return -1;
+    }
+
+    flecs_snapshot_write(buf, NULL, count * ECS_SIZEOF(int32_t));
+    flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+
+    for (i = 0; i < count; i ++) {
+        const void *ptr = flecs_snapshot_get_ptr(world, table, column,
+            flecs_snapshot_row(rows, i), id, ti->size);
+        const char *str = NULL;
+        char *json = NULL;
+
+        if (kind == EcsSnapshotJson) {
+            json = ecs_ptr_to_json(world, ti->component, ptr);
+            if (!json) {
+                char *id_str = ecs_id_str(world, id);
+                ecs_err("snapshot: failed to serialize value of '%s'", id_str);
+                ecs_os_free(id_str);
+                return -1;
+            }
+            str = json;
+        } else {
+            str = ((const EcsIdentifier*)ptr)->value;
+        }
+
+        int32_t length = -1;
+        if (str) {
+            length = ecs_os_strlen(str);
+            if (flecs_snapshot_write_check(buf, 
+                (int64_t)length + 1 + FLECS_SNAPSHOT_ALIGN)) 
+            {
+                ecs_os_free(json);
+                return -1;
+            }
+            flecs_snapshot_write(buf, str, length + 1);
+        }
+
+        int32_t *lengths_ptr = ECS_OFFSET(ecs_vec_first(buf), lengths);
+        lengths_ptr[i] = length;
+
+        ecs_os_free(json);
+    }
+
+    flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+
+    return 0;
+}
+
+/* Write a table block. When rows is NULL, all rows of the table are written,
+ * otherwise only the specified rows. When include is not NULL, only ids for
+ * which include is true are written. */
+static
+int flecs_snapshot_write_table(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    const int32_t *rows,
+    int32_t count,
+    const bool *include,
+    ecs_map_t *components,
+    ecs_vec_t *buf)
+{
+    int32_t i, id_count = 0, type_count = table->type.count;
+    uint8_t *kinds = ecs_os_malloc_n(uint8_t, type_count + 1);
+    const ecs_type_info_t **type_info = ecs_os_malloc_n(
+        const ecs_type_info_t*, type_count + 1);
+
+    /* Size of the block without strings, including worst case padding */
+    int64_t block_size = ECS_SIZEOF(ecs_snapshot_table_header_t) + 
+        FLECS_SNAPSHOT_ALIGN + (int64_t)count * ECS_SIZEOF(ecs_entity_t);
+
+    for (i = 0; i < type_count; i ++) {
+        kinds[i] = flecs_ito(uint8_t, flecs_snapshot_id_kind(
+            world, table->type.array[i], &type_info[i]));
+        if (include && !include[i]) {
+            kinds[i] = EcsSnapshotSkip;
+        }
+        if (kinds[i] != EcsSnapshotSkip) {
+            id_count ++;
+            block_size += ECS_SIZEOF(ecs_id_t) + 1;
+        }
+        if (kinds[i] == EcsSnapshotRaw || kinds[i] == EcsSnapshotParent) {
+            block_size += (int64_t)type_info[i]->size * count + 
+                FLECS_SNAPSHOT_COLUMN_ALIGN + FLECS_SNAPSHOT_ALIGN;
+        }
+    }
+
+    if (flecs_snapshot_write_check(buf, block_size)) {
+        goto error;
+    }
+
+    ecs_snapshot_table_header_t hdr = {
+        .id_count = id_count,
+        .count = count
+    };
+
+    flecs_snapshot_write(buf, &hdr, ECS_SIZEOF(hdr));
+
+    for (i = 0; i < type_count; i ++) {
+        if (kinds[i] != EcsSnapshotSkip) {
+            flecs_snapshot_write(buf, &table->type.array[i], ECS_SIZEOF(ecs_id_t));
+        }
+    }
+
+    for (i = 0; i < type_count; i ++) {
+        if (kinds[i] != EcsSnapshotSkip) {
+            flecs_snapshot_write(buf, &kinds[i], 1);
+        }
+    }
+
+    flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+
+    const ecs_entity_t *entities = ecs_table_entities(table);
+    if (!rows) {
+        flecs_snapshot_write(buf, entities, count * ECS_SIZEOF(ecs_entity_t));
+    } else {
+        for (i = 0; i < count; i ++) {
+            flecs_snapshot_write(buf, &entities[rows[i]], ECS_SIZEOF(ecs_entity_t));
+        }
+    }
+
+    for (i = 0; i < type_count; i ++) {
+        ecs_snapshot_kind_t kind = kinds[i];
+        if (kind == EcsSnapshotSkip || kind == EcsSnapshotTag) {
+            continue;
+        }
+
+        ecs_id_t id = table->type.array[i];
+        const ecs_type_info_t *ti = type_info[i];
+        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_map_ensure(components, id);
+
+        if (kind == EcsSnapshotRaw || kind == EcsSnapshotParent) {
+            ecs_size_t size = ti->size;
+            int32_t column = ecs_table_get_column_index(world, table, id);
+            flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_COLUMN_ALIGN);
+            if (column != -1 && !rows) {
+                flecs_snapshot_write(buf,
+                    ecs_table_get_column(table, column, 0), size * count);
+            } else {
+                int32_t row;
+                for (row = 0; row < count; row ++) {
+                    flecs_snapshot_write(buf, flecs_snapshot_get_ptr(world,
+                        table, column, flecs_snapshot_row(rows, row), id, size),
+                            size);
+                }
+            }
+            flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+        } else {
+            if (flecs_snapshot_write_strings(
+                world, table, rows, count, id, kind, ti, buf))
+            {
+                goto error;
+            }
+        }
+    }
+
+    ecs_os_free(kinds);
+    ecs_os_free(type_info);
+    return 0;
+error:
+    ecs_os_free(kinds);
+    ecs_os_free(type_info);
+    return -1;
+}
+
+static
+void flecs_snapshot_write_components(
+    const ecs_world_t *world,
+    ecs_map_t *components,
+    ecs_vec_t *buf)
+{
+    ecs_map_iter_t it = ecs_map_iter(components);
+    while (ecs_map_next(&it)) {
+        ecs_id_t id = ecs_map_key(&it);
+        const ecs_type_info_t *ti = ecs_get_type_info(world, id);
+        ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        char *path = ecs_get_path(world, ti->component);
+        ecs_snapshot_component_t c = {
+            .id = id,
+            .size = ti->size,
+            .alignment = ti->alignment,
+            .name_length = ecs_os_strlen(path) + 1
+        };
+
+        flecs_snapshot_write(buf, &c, ECS_SIZEOF(c));
+        flecs_snapshot_write(buf, path, c.name_length);
+        flecs_snapshot_write_align(buf, FLECS_SNAPSHOT_ALIGN);
+        ecs_os_free(path);
+    }
+}
+
+static
+void flecs_snapshot_init_preamble(
+    ecs_snapshot_preamble_t *preamble,
+    uint32_t magic)
+{
+    preamble->magic = magic;
+    preamble->byte_order = FLECS_SNAPSHOT_BYTE_ORDER;
+    preamble->version = ECS_SNAPSHOT_VERSION;
+    preamble->pointer_size = (uint32_t)sizeof(void*);
+}
+
+void* ecs_world_to_binary(
+    const ecs_world_t *world,
+    ecs_size_t *size_out)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size_out != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    world = ecs_get_world(world);
+    ecs_world_t *mut_world = ECS_CONST_CAST(ecs_world_t*, world);
+
+    /* Collect tables and sort them so parents are stored before children */
+    ecs_vec_t tables;
+    ecs_vec_init_t(NULL, &tables, ecs_snapshot_sort_t, 0);
+
+    const ecs_sparse_t *store = &world->store.tables;
+    int32_t i, table_count = flecs_sparse_count(store);
+    for (i = -1; i < table_count; i ++) {
+        ecs_table_t *table = i == -1 ? &mut_world->store.root :
+            flecs_sparse_get_dense_t(store, ecs_table_t, i);
+        if (i != -1 && table == &world->store.root) {
+            continue;
+        }
+        if (flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_snapshot_sort_t *elem = ecs_vec_append_t(
+            NULL, &tables, ecs_snapshot_sort_t);
+        elem->table = table;
+        elem->depth = flecs_snapshot_table_depth(world, table);
+    }
+
+    table_count = ecs_vec_count(&tables);
+    ecs_snapshot_sort_t *sorted = ecs_vec_first(&tables);
+    if (table_count > 1) {
+        qsort(sorted, flecs_itosize(table_count), sizeof(ecs_snapshot_sort_t),
+            flecs_snapshot_compare_table);
+    }
+
+    ecs_vec_t buf;
+    ecs_vec_init_t(NULL, &buf, char, 4096);
+
+    ecs_map_t components;
+    ecs_map_init(&components, &mut_world->allocator);
+
+    flecs_snapshot_write(&buf, NULL, ECS_SIZEOF(ecs_snapshot_header_t));
+
+    for (i = 0; i < table_count; i ++) {
+        if (flecs_snapshot_write_table(world, sorted[i].table, NULL,
+            ecs_table_count(sorted[i].table), NULL, &components, &buf))
+        {
+            goto error;
+        }
+    }
+
+    uint64_t components_offset = flecs_ito(uint64_t, ecs_vec_count(&buf));
+    flecs_snapshot_write_components(world, &components, &buf);
+
+    ecs_snapshot_header_t *hdr = ecs_vec_first(&buf);
+    flecs_snapshot_init_preamble(&hdr->preamble, FLECS_SNAPSHOT_MAGIC);
+    hdr->table_count = flecs_ito(uint32_t, table_count);
+    hdr->component_count = flecs_ito(uint32_t, components.count);
+    hdr->components_offset = components_offset;
+    hdr->max_id = flecs_entities_max_id(world);
+
+    ecs_map_fini(&components);
+    ecs_vec_fini_t(NULL, &tables, ecs_snapshot_sort_t);
+
+    *size_out = ecs_vec_count(&buf);
+    return ecs_vec_first(&buf);
+error:
+    ecs_map_fini(&components);
+    ecs_vec_fini_t(NULL, &tables, ecs_snapshot_sort_t);
+    ecs_vec_fini_t(NULL, &buf, char);
+    return NULL;
+}
+
+static
+const void* flecs_snapshot_read(
+    ecs_snapshot_reader_t *r,
+    ecs_size_t size)
+{
+    if (size < 0 || (r->end - r->ptr) < size) {
+        ecs_err("snapshot: unexpected end of data");
+        return NULL;
+    }
+
+    const void *result = r->ptr;
+    r->ptr += size;
+    return result;
+}
+
+/* Read an array. The count is checked against the remaining data before the
+ * size of the array is computed, so that a corrupt count can't overflow. */
+static
+const void* flecs_snapshot_read_n(
+    ecs_snapshot_reader_t *r,
+    ecs_size_t elem_size,
+    int64_t count)
+{
+    if (count < 0 || count > (r->end - r->ptr) / elem_size) {
+        ecs_err("snapshot: unexpected end of data");
+        return NULL;
+    }
+
+    return flecs_snapshot_read(r, (ecs_size_t)count * elem_size);
+}
+
+static
+int flecs_snapshot_read_align(
+    ecs_snapshot_reader_t *r,
+    ecs_size_t alignment)
+{
+    ecs_size_t offset = flecs_ito(ecs_size_t, r->ptr - r->start);
+    ecs_size_t padding = ECS_ALIGN(offset, alignment) - offset;
+    if (padding && !flecs_snapshot_read(r, padding)) {
+        return -1;
+    }
+    return 0;
+}
+
+static
+int flecs_snapshot_read_preamble(
+    const ecs_snapshot_preamble_t *preamble,
+    uint32_t magic,
+    const char *what)
+{
+    if (preamble->magic != magic) {
+        ecs_err("snapshot: data is not a %s", what);
+        return -1;
+    }
+
+    if (preamble->byte_order != FLECS_SNAPSHOT_BYTE_ORDER ||
+        preamble->pointer_size != sizeof(void*))
+    {
+        ecs_err("snapshot: %s was created on an incompatible platform", what);
+        return -1;
+    }
+
+    if (preamble->version != ECS_SNAPSHOT_VERSION) {
+        ecs_err("snapshot: unsupported version %u (expected %u)",
+            preamble->version, ECS_SNAPSHOT_VERSION);
+        return -1;
+    }
+
+    return 0;
+}
+
+static
+int flecs_snapshot_read_components(
+    ecs_world_t *world,
+    uint32_t component_count,
+    ecs_snapshot_reader_t *r)
+{
+    uint32_t i;
+    for (i = 0; i < component_count; i ++) {
+        const ecs_snapshot_component_t *c = flecs_snapshot_read(
+            r, ECS_SIZEOF(ecs_snapshot_component_t));
+        if (!c) {
+            return -1;
+        }
+
+        const char *name = flecs_snapshot_read(r, c->name_length);
+        if (!name || !c->name_length || name[c->name_length - 1]) {
+            ecs_err("snapshot: invalid component name");
+            return -1;
+        }
+
+        if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+            return -1;
+        }
+
+        const ecs_type_info_t *ti = NULL;
+        if (ecs_id_is_valid(world, c->id)) {
+            ti = ecs_get_type_info(world, c->id);
+        }
+
+        if (!ti) {
+            ecs_err("snapshot: component '%s' is not registered", name);
+            return -1;
+        }
+
+        if (ti->size != c->size || ti->alignment != c->alignment) {
+            ecs_err("snapshot: component '%s' has size %d and alignment %d, "
+                "snapshot has %d and %d", name, ti->size, ti->alignment,
+                c->size, c->alignment);
+            return -1;
+        }
+
+        char *path = ecs_get_path(world, ti->component);
+        bool match = !ecs_os_strcmp(path, name);
+        if (!match) {
+            ecs_err("snapshot: component id %u is '%s', snapshot has '%s'",
+                (uint32_t)ti->component, path, name);
+        }
+        ecs_os_free(path);
+        if (!match) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static
+int flecs_snapshot_read_strings(
+    ecs_snapshot_reader_t *r,
+    int32_t count)
+{
+    const int32_t *lengths = flecs_snapshot_read_n(
+        r, ECS_SIZEOF(int32_t), count);
+    if (!lengths || flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+        return -1;
+    }
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        int32_t length = lengths[i];
+        if (length < -1) {
+            ecs_err("snapshot: invalid string length");
+            return -1;
+        }
+        if (length == -1) {
+            continue;
+        }
+
+        const char *str = flecs_snapshot_read_n(r, 1, (int64_t)length + 1);
+        if (!str || str[length]) {
+            ecs_err("snapshot: invalid string");
+            return -1;
+        }
+    }
+
+    return flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN);
+}
+
+static
+bool flecs_snapshot_entity_exists(
+    const ecs_world_t *world,
+    const ecs_map_t *entities,
+    ecs_entity_t e)
+{
+    if (!e) {
+        return false;
+    }
+    return ecs_get_alive(world, (uint32_t)e) != 0 ||
+        ecs_map_get(entities, (uint32_t)e) != NULL;
+}
+
+static
+bool flecs_snapshot_id_exists(
+    const ecs_world_t *world,
+    const ecs_map_t *entities,
+    ecs_id_t id)
+{
+    if (ECS_IS_PAIR(id)) {
+        if (!flecs_snapshot_entity_exists(world, entities, ECS_PAIR_FIRST(id))) {
+            return false;
+        }
+        if (ECS_IS_VALUE_PAIR(id)) {
+            return true;
+        }
+        return flecs_snapshot_entity_exists(
+            world, entities, ECS_PAIR_SECOND(id));
+    }
+    return flecs_snapshot_entity_exists(world, entities, id & ECS_COMPONENT_MASK);
+}
+
+/* Parse a table block and verify that it can be restored. Entities that are
+ * alive with a different generation are only allowed if they are in the
+ * deleted map, which contains the entities that a diff deletes. */
+static
+int flecs_snapshot_read_table(
+    ecs_world_t *world,
+    ecs_snapshot_reader_t *r,
+    ecs_snapshot_table_t *t,
+    ecs_vec_t *blocks,
+    ecs_map_t *entities,
+    const ecs_map_t *deleted)
+{
+    const ecs_snapshot_table_header_t *hdr = flecs_snapshot_read(
+        r, ECS_SIZEOF(ecs_snapshot_table_header_t));
+    if (!hdr) {
+        return -1;
+    }
+
+    if (hdr->id_count < 0 || hdr->count < 0) {
+        ecs_err("snapshot: invalid table");
+        return -1;
+    }
+
+    t->id_count = hdr->id_count;
+    t->count = hdr->count;
+    t->ids = flecs_snapshot_read_n(r, ECS_SIZEOF(ecs_id_t), t->id_count);
+    t->kinds = flecs_snapshot_read(r, t->id_count);
+    if (!t->ids || !t->kinds) {
+        return -1;
+    }
+
+    if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+        return -1;
+    }
+
+    t->entities = flecs_snapshot_read_n(
+        r, ECS_SIZEOF(ecs_entity_t), t->count);
+    if (!t->entities) {
+        return -1;
+    }
+
+    int32_t i;
+    for (i = 0; i < t->count; i ++) {
+        ecs_entity_t e = t->entities[i];
+        ecs_entity_t alive = ecs_get_alive(world, (uint32_t)e);
+        if (alive && alive != e && !(deleted && ecs_map_get(deleted, alive))) {
+            ecs_err("snapshot: entity %u is alive with a different "
+                "generation (%u vs %u)", (uint32_t)e,
+                    (uint32_t)(alive >> 32), (uint32_t)(e >> 32));
+            return -1;
+        }
+
+        ecs_map_ensure(entities, (uint32_t)e);
+    }
+
+    t->blocks = ecs_vec_count(blocks);
+
+    for (i = 0; i < t->id_count; i ++) {
+        ecs_id_t id = t->ids[i];
+        ecs_snapshot_kind_t kind = t->kinds[i];
+        const void **block = ecs_vec_append_t(NULL, blocks, const void*);
+        *block = NULL;
+
+        if (kind == EcsSnapshotTag) {
+            continue;
+        }
+
+        if (kind >= EcsSnapshotSkip) {
+            ecs_err("snapshot: invalid value encoding");
+            return -1;
+        }
+
+        const ecs_type_info_t *ti = NULL;
+        if (ecs_id_is_valid(world, id)) {
+            ti = ecs_get_type_info(world, id);
+        }
+
+        if (!ti || !ti->size) {
+            ecs_err("snapshot: no component registered for table column");
+            return -1;
+        }
+
+        if (kind == EcsSnapshotRaw || kind == EcsSnapshotParent) {
+            if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_COLUMN_ALIGN)) {
+                return -1;
+            }
+
+            *block = flecs_snapshot_read_n(r, ti->size, t->count);
+            if (!*block) {
+                return -1;
+            }
+
+            if (flecs_snapshot_read_align(r, FLECS_SNAPSHOT_ALIGN)) {
+                return -1;
+            }
+        } else {
+            *block = r->ptr;
+            if (flecs_snapshot_read_strings(r, t->count)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Entities that are used in a type must have a table before the type is
+ * created, as creating a component record can add flags to entities. */
+static
+void flecs_snapshot_ensure_table(
+    ecs_world_t *world,
+    ecs_entity_t e)
+{
+    ecs_record_t *r = flecs_entities_get_any(world, e);
+    if (r && !r->table) {
+        flecs_add_to_root_table(world, ecs_get_alive(world, e));
+    }
+}
+
+static
+void flecs_snapshot_ensure_id(
+    ecs_world_t *world,
+    ecs_id_t id)
+{
+    if (ECS_IS_PAIR(id)) {
+        flecs_snapshot_ensure_table(world, ECS_PAIR_FIRST(id));
+        if (!ECS_IS_VALUE_PAIR(id)) {
+            flecs_snapshot_ensure_table(world, ECS_PAIR_SECOND(id));
+        }
+    } else {
+        flecs_snapshot_ensure_table(world, id & ECS_COMPONENT_MASK);
+    }
+}
+
+/* Cursor that walks the values of a string block, one row at a time */
+typedef struct ecs_snapshot_strings_t {
+    const int32_t *lengths;
+    const char *cur;
+} ecs_snapshot_strings_t;
+
+static
+void flecs_snapshot_strings_init(
+    ecs_snapshot_strings_t *s,
+    const char *start,
+    const void *block,
+    int32_t count)
+{
+    s->lengths = block;
+    ecs_size_t offset = flecs_ito(ecs_size_t,
+        ((const char*)block - start) + count * ECS_SIZEOF(int32_t));
+    s->cur = ECS_OFFSET(start, ECS_ALIGN(offset, FLECS_SNAPSHOT_ALIGN));
+}
+
+static
+const char* flecs_snapshot_strings_next(
+    ecs_snapshot_strings_t *s,
+    int32_t row)
+{
+    int32_t length = s->lengths[row];
+    if (length == -1) {
+        return NULL;
+    }
+
+    const char *result = s->cur;
+    s->cur += length + 1;
+    return result;
+}
+
+/* Restore values that are not copied in bulk for a single entity. When all is
+ * true, all ids of the table are restored with regular operations. */
+static
+int flecs_snapshot_restore_row(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    const void **blocks,
+    ecs_snapshot_strings_t *strings,
+    int32_t row,
+    bool all)
+{
+    ecs_entity_t e = t->entities[row];
+    int32_t i;
+
+    for (i = 0; i < t->id_count; i ++) {
+        ecs_id_t id = t->ids[i];
+        ecs_snapshot_kind_t kind = t->kinds[i];
+        const ecs_type_info_t *ti = NULL;
+        const char *str = NULL;
+
+        if ((kind == EcsSnapshotRaw && all) || kind == EcsSnapshotJson) {
+            ti = ecs_get_type_info(world, id);
+            ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+        }
+
+        if (kind == EcsSnapshotJson || (all && kind >= EcsSnapshotName)) {
+            str = flecs_snapshot_strings_next(&strings[i], row);
+        }
+
+        switch(kind) {
+        case EcsSnapshotTag:
+            if (all && !(ECS_IS_VALUE_PAIR(id) &&
+                ECS_PAIR_FIRST(id) == EcsParentDepth))
+            {
+                ecs_add_id(world, e, id);
+            }
+            break;
+        case EcsSnapshotRaw:
+            if (all) {
+                ecs_set_id(world, e, id, flecs_itosize(ti->size),
+                    ECS_ELEM(blocks[i], ti->size, row));
+            }
+            break;
+        case EcsSnapshotParent: {
+            const EcsParent *p = ECS_ELEM_T(blocks[i], EcsParent, row);
+            if (p->value) {
+                flecs_snapshot_ensure_table(world, p->value);
+            }
+            ecs_set_id(world, e, id, sizeof(EcsParent), p);
+            break;
+        }
+        case EcsSnapshotName:
+            if (all && str) {
+                ecs_set_name(world, e, str);
+            }
+            break;
+        case EcsSnapshotSymbol:
+            if (all && str) {
+                ecs_set_symbol(world, e, str);
+            }
+            break;
+        case EcsSnapshotAlias:
+            if (all && str) {
+                ecs_set_alias(world, e, str);
+            }
+            break;
+        case EcsSnapshotJson: {
+            void *ptr = ecs_ensure_id(world, e, id, flecs_itosize(ti->size));
+            if (str && !ecs_ptr_from_json(world, ti->component, ptr, str, NULL)) {
+                return -1;
+            }
+            ecs_modified_id(world, e, id);
+            break;
+        }
+        case EcsSnapshotSkip:
+        default:
+            ecs_abort(ECS_INTERNAL_ERROR, NULL);
+        }
+    }
+
+    return 0;
+}
+
+/* Remove ids from an entity that would have been stored, but that are not in
+ * the table block. Used by diffs, where an entity block contains all ids. */
+static
+void flecs_snapshot_remove_missing(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    ecs_entity_t e)
+{
+    const ecs_type_t *type = ecs_get_type(world, e);
+    if (!type || !type->count) {
+        return;
+    }
+
+    ecs_id_t *remove = ecs_os_malloc_n(ecs_id_t, type->count);
+    int32_t i, j, remove_count = 0;
+
+    for (i = 0; i < type->count; i ++) {
+        ecs_id_t id = type->array[i];
+        const ecs_type_info_t *ti;
+        if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+            continue;
+        }
+        if (flecs_snapshot_id_kind(world, id, &ti) == EcsSnapshotSkip) {
+            continue;
+        }
+        for (j = 0; j < t->id_count; j ++) {
+            if (t->ids[j] == id) {
+                break;
+            }
+        }
+        if (j == t->id_count) {
+            remove[remove_count ++] = id;
+        }
+    }
+
+    for (i = 0; i < remove_count; i ++) {
+        ecs_remove_id(world, e, remove[i]);
+    }
+
+    ecs_os_free(remove);
+}
+
+static
+int flecs_snapshot_restore_table(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    const void **blocks,
+    const char *start,
+    bool exact)
+{
+    int32_t i, id_count = t->id_count, count = t->count;
+    if (!count) {
+        return 0;
+    }
+
+    /* Ids that are restored in bulk. The Parent component is assigned with
+     * ecs_set(), which moves the entity to the table with the right depth. */
+    ecs_id_t *ids = ecs_os_malloc_n(ecs_id_t, id_count + 1);
+    int32_t *columns = ecs_os_malloc_n(int32_t, id_count + 1);
+    ecs_size_t *sizes = ecs_os_calloc_n(ecs_size_t, id_count + 1);
+    void **data = ecs_os_calloc_n(void*, id_count + 1);
+    ecs_snapshot_strings_t *strings = ecs_os_calloc_n(
+        ecs_snapshot_strings_t, id_count + 1);
+    uint32_t *flags = ecs_os_malloc_n(uint32_t, count);
+    int32_t bulk_count = 0;
+    bool restore_rows = false;
+    int result = -1;
+
+    for (i = 0; i < id_count; i ++) {
+        ecs_id_t id = t->ids[i];
+        ecs_snapshot_kind_t kind = t->kinds[i];
+
+        if (kind >= EcsSnapshotName) {
+            flecs_snapshot_strings_init(&strings[i], start, blocks[i], count);
+        }
+
+        if (kind == EcsSnapshotParent || kind == EcsSnapshotJson) {
+            restore_rows = true;
+        }
+
+        if (kind == EcsSnapshotParent) {
+            continue;
+        }
+        if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+            continue;
+        }
+
+        flecs_snapshot_ensure_id(world, id);
+
+        ids[bulk_count] = id;
+        columns[bulk_count] = i;
+        if (kind == EcsSnapshotRaw) {
+            sizes[bulk_count] = ecs_get_type_info(world, id)->size;
+        } else if (kind >= EcsSnapshotName && kind <= EcsSnapshotAlias) {
+            data[bulk_count] = ecs_os_malloc_n(EcsIdentifier, count);
+        }
+        bulk_count ++;
+    }
+
+    ecs_table_t *table = ecs_table_find(world, ids, bulk_count);
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_type_t bulk_type = { .array = ids, .count = bulk_count };
+    void **run_data = ecs_os_calloc_n(void*, bulk_count + 1);
+
+    int32_t row = 0;
+    while (row < count) {
+        ecs_record_t *r = flecs_entities_get(world, t->entities[row]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+
+        if (r->table) {
+            /* Entity already existed before the snapshot was restored */
+            if (exact) {
+                flecs_snapshot_remove_missing(world, t, t->entities[row]);
+            }
+            if (flecs_snapshot_restore_row(
+                world, t, blocks, strings, row, true))
+            {
+                goto error;
+            }
+            row ++;
+            continue;
+        }
+
+        /* Find run of entities that don't have a table yet */
+        int32_t run_start = row, run_count;
+        for (; row < count; row ++) {
+            r = flecs_entities_get(world, t->entities[row]);
+            if (r->table) {
+                break;
+            }
+            flags[row - run_start] = ECS_RECORD_TO_ROW_FLAGS(r->row);
+        }
+
+        run_count = row - run_start;
+
+        for (i = 0; i < bulk_count; i ++) {
+            int32_t column = columns[i];
+            ecs_snapshot_kind_t kind = t->kinds[column];
+            if (kind == EcsSnapshotRaw) {
+                run_data[i] = ECS_ELEM(ECS_CONST_CAST(void*, blocks[column]),
+                    sizes[i], run_start);
+            } else if (data[i]) {
+                /* Names are copied in bulk, so that they are added to the name
+                 * index by the OnSet hook of the identifier component. */
+                EcsIdentifier *names = data[i];
+                int32_t j;
+                for (j = 0; j < run_count; j ++) {
+                    ecs_os_zeromem(&names[j]);
+                    names[j].value = ECS_CONST_CAST(char*,
+                        flecs_snapshot_strings_next(
+                            &strings[column], run_start + j));
+                }
+                run_data[i] = names;
+            }
+        }
+
+        ecs_table_diff_t diff = {
+            .added.array = table->type.array,
+            .added.count = table->type.count,
+            .added_flags = table->flags & EcsTableAddEdgeFlags
+        };
+
+        flecs_bulk_new(world, table, &t->entities[run_start], &bulk_type,
+            run_count, run_data, false, false, NULL, &diff);
+
+        /* Restore flags that were added to records before the entities were
+         * added to the table, for example when used as a pair target. */
+        for (i = 0; i < run_count; i ++) {
+            r = flecs_entities_get(world, t->entities[run_start + i]);
+            r->row |= flags[i];
+        }
+
+        for (i = run_start; restore_rows && i < row; i ++) {
+            if (flecs_snapshot_restore_row(
+                world, t, blocks, strings, i, false))
+            {
+                goto error;
+            }
+        }
+    }
+
+    result = 0;
+error:
+    for (i = 0; i < bulk_count; i ++) {
+        ecs_os_free(data[i]);
+    }
+    ecs_os_free(run_data);
+    ecs_os_free(ids);
+    ecs_os_free(columns);
+    ecs_os_free(sizes);
+    ecs_os_free(data);
+    ecs_os_free(strings);
+    ecs_os_free(flags);
+    return result;
+}
+
+/* Make entities alive without adding them to a table, so they can be added to
+ * their tables in bulk. */
+static
+void flecs_snapshot_make_alive(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *tables,
+    uint32_t table_count)
+{
+    uint32_t i;
+    for (i = 0; i < table_count; i ++) {
+        const ecs_snapshot_table_t *t = &tables[i];
+        int32_t j;
+        for (j = 0; j < t->count; j ++) {
+            ecs_entity_t e = t->entities[j];
+            if (!ecs_is_alive(world, e)) {
+                flecs_entities_make_alive(world, e);
+                flecs_entities_ensure(world, e);
+            }
+        }
+    }
+}
+
+int ecs_world_from_binary(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(data != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot restore snapshot while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION,
+        "cannot restore snapshot while world is deferred");
+
+    if (((uintptr_t)data % FLECS_SNAPSHOT_ALIGN) != 0) {
+        ecs_err("snapshot: data must be aligned to %d bytes",
+            FLECS_SNAPSHOT_ALIGN);
+        return -1;
+    }
+
+    ecs_snapshot_reader_t r = {
+        .start = data,
+        .ptr = data,
+        .end = ECS_OFFSET(data, size)
+    };
+
+    const ecs_snapshot_header_t *hdr = flecs_snapshot_read(
+        &r, ECS_SIZEOF(ecs_snapshot_header_t));
+    if (!hdr) {
+        return -1;
+    }
+
+    if (flecs_snapshot_read_preamble(
+        &hdr->preamble, FLECS_SNAPSHOT_MAGIC, "snapshot"))
+    {
+        return -1;
+    }
+
+    if (hdr->components_offset > (uint64_t)size) {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    /* Verify that the snapshot can be restored before modifying the world */
+    ecs_snapshot_reader_t cr = r;
+    cr.ptr = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+    if (flecs_snapshot_read_components(world, hdr->component_count, &cr)) {
+        return -1;
+    }
+
+    r.end = cr.ptr = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+
+    /* Each table block starts with a header */
+    if (r.end < r.ptr || hdr->table_count > (uint64_t)(r.end - r.ptr) / 
+        sizeof(ecs_snapshot_table_header_t)) 
+    {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    int result = -1;
+    uint32_t i, table_count = hdr->table_count;
+    ecs_snapshot_table_t *tables = ecs_os_calloc_n(
+        ecs_snapshot_table_t, (int32_t)table_count + 1);
+    ecs_vec_t blocks;
+    ecs_vec_init_t(NULL, &blocks, const void*, 0);
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    for (i = 0; i < table_count; i ++) {
+        if (flecs_snapshot_read_table(world, &r, &tables[i], &blocks,
+            &entities, NULL))
+        {
+            goto cleanup;
+        }
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        int32_t j;
+        for (j = 0; j < t->id_count; j ++) {
+            if (!flecs_snapshot_id_exists(world, &entities, t->ids[j])) {
+                ecs_err("snapshot: table type contains entity that is not "
+                    "alive and not stored in snapshot");
+                goto cleanup;
+            }
+        }
+    }
+
+    flecs_snapshot_make_alive(world, tables, table_count);
+
+    /* Instance children are stored in the snapshot, so prevent adding an IsA
+     * relationship from instantiating prefab hierarchies. */
+    ecs_stage_t *stage = world->stages[0];
+    ecs_entity_t base = stage->base;
+    stage->base = EcsWildcard;
+
+    const void **block_ptrs = ecs_vec_first(&blocks);
+    for (i = 0; i < table_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        if (flecs_snapshot_restore_table(world, t, &block_ptrs[t->blocks],
+            data, false))
+        {
+            stage->base = base;
+            goto cleanup;
+        }
+    }
+
+    stage->base = base;
+
+    if (flecs_entities_max_id(world) < hdr->max_id) {
+        flecs_entities_max_id(world) = (uint32_t)hdr->max_id;
+    }
+
+    result = 0;
+cleanup:
+    ecs_map_fini(&entities);
+    ecs_vec_fini_t(NULL, &blocks, const void*);
+    ecs_os_free(tables);
+    return result;
+error:
+    return -1;
+}
+
+int ecs_world_from_binary_file(
+    ecs_world_t *world,
+    const char *filename)
+{
+    ecs_check(filename != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    FILE* file = ecs_os_fopen(filename, "rb");
+    if (!file) {
+        ecs_err("%s (%s)", ecs_os_strerror(errno), filename);
+        return -1;
+    }
+
+    ecs_vec_t buf;
+    ecs_vec_init_t(NULL, &buf, char, 0);
+    ecs_size_t read_size = 4096;
+    size_t read;
+
+    do {
+        void *dst = ecs_vec_grow_t(NULL, &buf, char, read_size);
+        read = ecs_os_fread(dst, 1, flecs_itosize(read_size), file);
+        ecs_vec_set_count_t(NULL, &buf, char,
+            ecs_vec_count(&buf) - read_size + flecs_uto(ecs_size_t, read));
+        read_size = ecs_vec_size(&buf);
+    } while (read);
+
+    ecs_os_fclose(file);
+
+    int result = ecs_world_from_binary(
+        world, ecs_vec_first(&buf), ecs_vec_count(&buf));
+    ecs_vec_fini_t(NULL, &buf, char);
+    return result;
+error:
+    return -1;
+}
+
+/* State of the replicated entities at a frame */
+typedef struct ecs_replicator_state_t {
+    ecs_map_t entities;        /* map<entity, table id> */
+    ecs_map_t tables;          /* map<table id, int32_t*> column dirty state */
+    uint64_t frame;
+} ecs_replicator_state_t;
+
+struct ecs_replicator_t {
+    ecs_world_t *world;
+    ecs_query_t *query;
+    ecs_replicator_state_t acked;
+    ecs_vec_t pending;         /* vec<ecs_replicator_state_t> unacked frames */
+    ecs_map_t sent;            /* map<entity, frame> sent since acked frame */
+    uint64_t frame;
+};
+
+/* Table matched by the replicator query while creating a diff */
+typedef struct ecs_replicator_table_t {
+    ecs_snapshot_sort_t sort;
+    ecs_vec_t added;           /* vec<int32_t> rows of entities new in table */
+    ecs_vec_t updated;         /* vec<int32_t> rows of acknowledged entities */
+} ecs_replicator_table_t;
+
+static
+void flecs_replicator_state_init(
+    ecs_world_t *world,
+    ecs_replicator_state_t *state)
+{
+    ecs_map_init(&state->entities, &world->allocator);
+    ecs_map_init(&state->tables, &world->allocator);
+    state->frame = 0;
+}
+
+static
+void flecs_replicator_state_fini(
+    ecs_replicator_state_t *state)
+{
+    ecs_map_iter_t it = ecs_map_iter(&state->tables);
+    while (ecs_map_next(&it)) {
+        ecs_os_free(ecs_map_ptr(&it));
+    }
+    ecs_map_fini(&state->tables);
+    ecs_map_fini(&state->entities);
+}
+
+ecs_replicator_t* ecs_replicator_new(
+    ecs_world_t *world,
+    ecs_query_t *query)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(query != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_replicator_t *result = ecs_os_calloc_t(ecs_replicator_t);
+    result->world = world;
+    result->query = query;
+    flecs_replicator_state_init(world, &result->acked);
+    ecs_vec_init_t(NULL, &result->pending, ecs_replicator_state_t, 0);
+    ecs_map_init(&result->sent, &world->allocator);
+    return result;
+error:
+    return NULL;
+}
+
+void ecs_replicator_free(
+    ecs_replicator_t *replicator)
+{
+    if (replicator) {
+        flecs_replicator_state_fini(&replicator->acked);
+        int32_t i, count = ecs_vec_count(&replicator->pending);
+        ecs_replicator_state_t *pending = ecs_vec_first(&replicator->pending);
+        for (i = 0; i < count; i ++) {
+            flecs_replicator_state_fini(&pending[i]);
+        }
+        ecs_vec_fini_t(NULL, &replicator->pending, ecs_replicator_state_t);
+        ecs_map_fini(&replicator->sent);
+        ecs_os_free(replicator);
+    }
+}
+
+void ecs_replicator_ack(
+    ecs_replicator_t *replicator,
+    uint64_t frame)
+{
+    ecs_check(replicator != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    /* Pending frames are stored in the order they were created */
+    int32_t i, count = ecs_vec_count(&replicator->pending);
+    ecs_replicator_state_t *pending = ecs_vec_first(&replicator->pending);
+    for (i = 0; i < count; i ++) {
+        if (pending[i].frame == frame) {
+            break;
+        }
+    }
+
+    if (!frame || i == count) {
+        return; /* Frame is already acknowledged, superseded or unknown */
+    }
+
+    /* Frames older than the acknowledged frame can no longer be acked */
+    flecs_replicator_state_fini(&replicator->acked);
+    replicator->acked = pending[i];
+    int32_t j;
+    for (j = 0; j < i; j ++) {
+        flecs_replicator_state_fini(&pending[j]);
+    }
+
+    int32_t remaining = count - i - 1;
+    ecs_os_memmove_n(pending, &pending[i + 1], ecs_replicator_state_t, 
+        remaining);
+    ecs_vec_set_count_t(NULL, &replicator->pending, ecs_replicator_state_t,
+        remaining);
+
+    /* Entities sent up to the acknowledged frame are either in the acked
+     * state, or were deleted by the acknowledged diff. */
+    ecs_vec_t removed;
+    ecs_vec_init_t(NULL, &removed, ecs_entity_t, 0);
+    ecs_map_iter_t it = ecs_map_iter(&replicator->sent);
+    while (ecs_map_next(&it)) {
+        if (ecs_map_value(&it) <= frame) {
+            ecs_vec_append_t(NULL, &removed, ecs_entity_t)[0] = 
+                ecs_map_key(&it);
+        }
+    }
+
+    count = ecs_vec_count(&removed);
+    ecs_entity_t *entities = ecs_vec_first(&removed);
+    for (i = 0; i < count; i ++) {
+        ecs_map_remove(&replicator->sent, entities[i]);
+    }
+    ecs_vec_fini_t(NULL, &removed, ecs_entity_t);
+error:
+    return;
+}
+
+static
+int flecs_replicator_compare_table(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_replicator_table_t *t1 = ptr_1;
+    const ecs_replicator_table_t *t2 = ptr_2;
+    return flecs_snapshot_compare_table(&t1->sort, &t2->sort);
+}
+
+/* Set operations skip change detection for components that aren't used by
+ * queries that detect changes. Flag the components of a replicated or forked
+ * table in the same way as a query with change detection does. */
+static
+void flecs_snapshot_track_table(
+    ecs_world_t *world,
+    const ecs_table_t *table)
+{
+    int32_t i, count = table->type.count;
+    for (i = 0; i < count; i ++) {
+        if (ecs_table_type_to_column_index(table, i) == -1) {
+            continue;
+        }
+
+        ecs_id_t id = table->type.array[i];
+        ecs_component_record_t *cr = flecs_components_get(world, id);
+        ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
+        cr->flags |= EcsIdHasOnSet;
+
+        if (id < FLECS_HI_COMPONENT_ID) {
+            world->non_trivial_set[id] = true;
+        }
+    }
+}
+
+/* Collect the rows of the tables matched by the query, and store the state
+ * that the diff is created for as pending state. */
+static
+void flecs_replicator_collect(
+    ecs_replicator_t *replicator,
+    ecs_replicator_state_t *pending,
+    ecs_vec_t *tables)
+{
+    ecs_world_t *world = replicator->world;
+    ecs_replicator_state_t *acked = &replicator->acked;
+
+    ecs_map_t table_index;
+    ecs_map_init(&table_index, &world->allocator);
+
+    ecs_iter_t it = ecs_query_iter(world, replicator->query);
+
+    /* Don't mark fields as dirty, this would make them show up as changed in
+     * the next diff. */
+    it.flags |= EcsIterNoData;
+
+    while (ecs_query_next(&it)) {
+        ecs_table_t *table = it.table;
+        if (!table || !it.count || flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_map_val_t *index = ecs_map_ensure(&table_index, table->id);
+        if (!index[0]) {
+            ecs_replicator_table_t *elem = ecs_vec_append_t(
+                NULL, tables, ecs_replicator_table_t);
+            elem->sort.table = table;
+            elem->sort.depth = flecs_snapshot_table_depth(world, table);
+            ecs_vec_init_t(NULL, &elem->added, int32_t, 0);
+            ecs_vec_init_t(NULL, &elem->updated, int32_t, 0);
+            index[0] = flecs_ito(uint64_t, ecs_vec_count(tables));
+
+            if (!ecs_map_get(&acked->tables, table->id)) {
+                flecs_snapshot_track_table(world, table);
+            }
+
+            int32_t *dirty_state = flecs_table_get_dirty_state(world, table);
+            int32_t *copy = ecs_os_memdup_n(
+                dirty_state, int32_t, table->column_count + 1);
+            ecs_map_insert_ptr(&pending->tables, table->id, copy);
+        }
+
+        ecs_replicator_table_t *elem = ecs_vec_get_t(tables,
+            ecs_replicator_table_t, flecs_uto(int32_t, index[0] - 1));
+
+        int32_t i;
+        for (i = 0; i < it.count; i ++) {
+            ecs_entity_t e = it.entities[i];
+            if (ecs_map_get(&pending->entities, e)) {
+                continue; /* Table is matched more than once */
+            }
+
+            ecs_map_insert(&pending->entities, e, table->id);
+
+            int32_t row = it.offset + i;
+            ecs_map_val_t *prev = ecs_map_get(&acked->entities, e);
+            if (prev && prev[0] == table->id) {
+                ecs_vec_append_t(NULL, &elem->updated, int32_t)[0] = row;
+            } else {
+                ecs_vec_append_t(NULL, &elem->added, int32_t)[0] = row;
+            }
+        }
+    }
+
+    ecs_map_fini(&table_index);
+}
+
+/* Determine which ids of a table have values that changed since the
+ * acknowledged frame. Returns whether any value changed. */
+static
+bool flecs_replicator_changed(
+    ecs_replicator_t *replicator,
+    const ecs_table_t *table,
+    bool *changed)
+{
+    const ecs_world_t *world = replicator->world;
+    const int32_t *prev = ecs_map_get_deref(
+        &replicator->acked.tables, int32_t, table->id);
+    const int32_t *dirty_state = table->dirty_state;
+    ecs_assert(dirty_state != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    bool result = false;
+    int32_t i, count = table->type.count;
+    for (i = 0; i < count; i ++) {
+        const ecs_type_info_t *ti;
+        ecs_snapshot_kind_t kind = flecs_snapshot_id_kind(
+            world, table->type.array[i], &ti);
+        if (kind == EcsSnapshotTag || kind == EcsSnapshotSkip) {
+            changed[i] = false;
+            continue;
+        }
+
+        int32_t column = ecs_table_type_to_column_index(table, i);
+        if (column == -1) {
+            /* Sparse components don't have change detection */
+            changed[i] = true;
+        } else {
+            changed[i] = !prev || prev[column + 1] != dirty_state[column + 1];
+        }
+
+        result |= changed[i];
+    }
+
+    return result;
+}
+
+static
+int flecs_replicator_write_rows(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    const ecs_vec_t *rows,
+    const bool *include,
+    ecs_map_t *components,
+    ecs_vec_t *buf)
+{
+    int32_t count = ecs_vec_count(rows);
+
+    /* Rows are collected in order, so if all rows of the table are written
+     * columns can be copied in bulk. */
+    const int32_t *row_ptr = NULL;
+    if (count != ecs_table_count(table)) {
+        row_ptr = ecs_vec_first_t(rows, int32_t);
+    }
+
+    return flecs_snapshot_write_table(
+        world, table, row_ptr, count, include, components, buf);
+}
+
+void* ecs_replicator_diff(
+    ecs_replicator_t *replicator,
+    ecs_size_t *size_out,
+    uint64_t *frame_out)
+{
+    ecs_check(replicator != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(size_out != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_world_t *world = replicator->world;
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot create diff while world is in readonly mode");
+
+    /* Drop the oldest unacknowledged frame if there are too many */
+    if (ecs_vec_count(&replicator->pending) == FLECS_REPLICATOR_MAX_PENDING) {
+        ecs_replicator_state_t *oldest = ecs_vec_first(&replicator->pending);
+        flecs_replicator_state_fini(oldest);
+        ecs_vec_remove_ordered(&replicator->pending, 
+            ECS_SIZEOF(ecs_replicator_state_t), 0);
+    }
+
+    ecs_replicator_state_t *pending = ecs_vec_append_t(
+        NULL, &replicator->pending, ecs_replicator_state_t);
+    flecs_replicator_state_init(world, pending);
+    pending->frame = ++ replicator->frame;
+
+    ecs_vec_t tables;
+    ecs_vec_init_t(NULL, &tables, ecs_replicator_table_t, 0);
+    flecs_replicator_collect(replicator, pending, &tables);
+
+    int32_t i, table_count = ecs_vec_count(&tables);
+    ecs_replicator_table_t *sorted = ecs_vec_first(&tables);
+    if (table_count > 1) {
+        qsort(sorted, flecs_itosize(table_count),
+            sizeof(ecs_replicator_table_t), flecs_replicator_compare_table);
+    }
+
+    ecs_vec_t buf;
+    ecs_vec_init_t(NULL, &buf, char, 4096);
+    ecs_map_t components;
+    ecs_map_init(&components, &world->allocator);
+    uint32_t added_count = 0, updated_count = 0, deleted_count = 0;
+    bool *changed = NULL;
+
+    flecs_snapshot_write(&buf, NULL, ECS_SIZEOF(ecs_snapshot_diff_header_t));
+
+    /* Entities that were deleted or no longer match the query. This includes
+     * entities that were sent in diffs that weren't acknowledged yet, so that
+     * a client can skip diffs. */
+    ecs_map_iter_t it = ecs_map_iter(&replicator->acked.entities);
+    while (ecs_map_next(&it)) {
+        ecs_entity_t e = ecs_map_key(&it);
+        if (!ecs_map_get(&pending->entities, e)) {
+            flecs_snapshot_write(&buf, &e, ECS_SIZEOF(ecs_entity_t));
+            deleted_count ++;
+        }
+    }
+
+    it = ecs_map_iter(&replicator->sent);
+    while (ecs_map_next(&it)) {
+        ecs_entity_t e = ecs_map_key(&it);
+        if (!ecs_map_get(&pending->entities, e) &&
+            !ecs_map_get(&replicator->acked.entities, e))
+        {
+            flecs_snapshot_write(&buf, &e, ECS_SIZEOF(ecs_entity_t));
+            deleted_count ++;
+        }
+    }
+
+    it = ecs_map_iter(&pending->entities);
+    while (ecs_map_next(&it)) {
+        ecs_map_ensure(&replicator->sent, ecs_map_key(&it))[0] = 
+            pending->frame;
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_replicator_table_t *t = &sorted[i];
+        if (!ecs_vec_count(&t->added)) {
+            continue;
+        }
+
+        if (flecs_replicator_write_rows(
+            world, t->sort.table, &t->added, NULL, &components, &buf))
+        {
+            goto error;
+        }
+
+        added_count ++;
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_replicator_table_t *t = &sorted[i];
+        const ecs_table_t *table = t->sort.table;
+        if (!ecs_vec_count(&t->updated)) {
+            continue;
+        }
+
+        changed = ecs_os_realloc_n(changed, bool, table->type.count);
+        if (!flecs_replicator_changed(replicator, table, changed)) {
+            continue;
+        }
+
+        if (flecs_replicator_write_rows(
+            world, table, &t->updated, changed, &components, &buf))
+        {
+            goto error;
+        }
+
+        updated_count ++;
+    }
+
+    uint64_t components_offset = flecs_ito(uint64_t, ecs_vec_count(&buf));
+    flecs_snapshot_write_components(world, &components, &buf);
+
+    ecs_snapshot_diff_header_t *hdr = ecs_vec_first(&buf);
+    flecs_snapshot_init_preamble(&hdr->preamble, FLECS_SNAPSHOT_DIFF_MAGIC);
+    hdr->table_count = added_count;
+    hdr->update_count = updated_count;
+    hdr->deleted_count = deleted_count;
+    hdr->component_count = flecs_ito(uint32_t, components.count);
+    hdr->components_offset = components_offset;
+    hdr->frame = replicator->frame;
+
+    if (frame_out) {
+        *frame_out = replicator->frame;
+    }
+
+    *size_out = ecs_vec_count(&buf);
+
+    ecs_os_free(changed);
+    ecs_map_fini(&components);
+    for (i = 0; i < table_count; i ++) {
+        ecs_vec_fini_t(NULL, &sorted[i].added, int32_t);
+        ecs_vec_fini_t(NULL, &sorted[i].updated, int32_t);
+    }
+    ecs_vec_fini_t(NULL, &tables, ecs_replicator_table_t);
+    return ecs_vec_first(&buf);
+error:
+    ecs_os_free(changed);
+    ecs_map_fini(&components);
+    for (i = 0; i < table_count; i ++) {
+        ecs_vec_fini_t(NULL, &sorted[i].added, int32_t);
+        ecs_vec_fini_t(NULL, &sorted[i].updated, int32_t);
+    }
+    ecs_vec_fini_t(NULL, &tables, ecs_replicator_table_t);
+    ecs_vec_fini_t(NULL, &buf, char);
+    return NULL;
+}
+
+/* Assign changed values to entities that are already in the right table */
+static
+int flecs_snapshot_update_table(
+    ecs_world_t *world,
+    const ecs_snapshot_table_t *t,
+    const void **blocks,
+    const char *start)
+{
+    ecs_snapshot_strings_t *strings = ecs_os_calloc_n(
+        ecs_snapshot_strings_t, t->id_count + 1);
+    int32_t i, result = 0;
+
+    for (i = 0; i < t->id_count; i ++) {
+        if (t->kinds[i] >= EcsSnapshotName) {
+            flecs_snapshot_strings_init(&strings[i], start, blocks[i], t->count);
+        }
+    }
+
+    for (i = 0; i < t->count; i ++) {
+        if (flecs_snapshot_restore_row(world, t, blocks, strings, i, true)) {
+            result = -1;
+            break;
+        }
+    }
+
+    ecs_os_free(strings);
+    return result;
+}
+
+int ecs_world_apply_diff(
+    ecs_world_t *world,
+    const void *data,
+    ecs_size_t size)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(data != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot apply diff while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION,
+        "cannot apply diff while world is deferred");
+
+    if (((uintptr_t)data % FLECS_SNAPSHOT_ALIGN) != 0) {
+        ecs_err("snapshot: data must be aligned to %d bytes",
+            FLECS_SNAPSHOT_ALIGN);
+        return -1;
+    }
+
+    ecs_snapshot_reader_t r = {
+        .start = data,
+        .ptr = data,
+        .end = ECS_OFFSET(data, size)
+    };
+
+    const ecs_snapshot_diff_header_t *hdr = flecs_snapshot_read(
+        &r, ECS_SIZEOF(ecs_snapshot_diff_header_t));
+    if (!hdr) {
+        return -1;
+    }
+
+    if (flecs_snapshot_read_preamble(
+        &hdr->preamble, FLECS_SNAPSHOT_DIFF_MAGIC, "diff"))
+    {
+        return -1;
+    }
+
+    if (hdr->components_offset > (uint64_t)size) {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    ecs_snapshot_reader_t cr = r;
+    cr.ptr = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+    if (flecs_snapshot_read_components(world, hdr->component_count, &cr)) {
+        return -1;
+    }
+
+    r.end = ECS_OFFSET(data, (ecs_size_t)hdr->components_offset);
+
+    /* Counts are validated against the remaining data, after which they fit
+     * in a 32 bit integer. */
+    const ecs_entity_t *deleted = flecs_snapshot_read_n(&r,
+        ECS_SIZEOF(ecs_entity_t), hdr->deleted_count);
+    if (!deleted) {
+        return -1;
+    }
+
+    /* Each table block starts with a header */
+    uint64_t block_count = (uint64_t)hdr->table_count + hdr->update_count;
+    if (r.end < r.ptr || block_count > (uint64_t)(r.end - r.ptr) / 
+        sizeof(ecs_snapshot_table_header_t)) 
+    {
+        ecs_err("snapshot: unexpected end of data");
+        return -1;
+    }
+
+    int result = -1;
+    int32_t i, deleted_count = (int32_t)hdr->deleted_count;
+    int32_t table_count = (int32_t)hdr->table_count;
+    int32_t total_count = (int32_t)block_count;
+    ecs_snapshot_table_t *tables = ecs_os_calloc_n(
+        ecs_snapshot_table_t, total_count + 1);
+    ecs_vec_t blocks;
+    ecs_vec_init_t(NULL, &blocks, const void*, 0);
+    ecs_map_t entities, deleted_map;
+    ecs_map_init(&entities, &world->allocator);
+    ecs_map_init(&deleted_map, &world->allocator);
+
+    for (i = 0; i < deleted_count; i ++) {
+        ecs_entity_t e = deleted[i];
+        if (e && ecs_is_alive(world, e)) {
+            ecs_map_ensure(&deleted_map, e);
+        }
+    }
+
+    /* Verify that the diff can be applied before modifying the world */
+    for (i = 0; i < total_count; i ++) {
+        if (flecs_snapshot_read_table(world, &r, &tables[i], &blocks,
+            &entities, &deleted_map))
+        {
+            goto cleanup;
+        }
+    }
+
+    for (i = 0; i < total_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        int32_t j;
+        for (j = 0; j < t->id_count; j ++) {
+            if (!flecs_snapshot_id_exists(world, &entities, t->ids[j])) {
+                ecs_err("snapshot: table type contains entity that is not "
+                    "alive and not stored in diff");
+                goto cleanup;
+            }
+        }
+
+        for (j = 0; i >= table_count && j < t->count; j ++) {
+            ecs_entity_t e = t->entities[j];
+            if (!ecs_is_alive(world, e) || ecs_map_get(&deleted_map, e)) {
+                ecs_err("snapshot: diff updates entity %u that is not alive",
+                    (uint32_t)e);
+                goto cleanup;
+            }
+        }
+    }
+
+    for (i = 0; i < deleted_count; i ++) {
+        ecs_entity_t e = deleted[i];
+        if (e && ecs_is_alive(world, e)) {
+            ecs_delete(world, e);
+        }
+    }
+
+    flecs_snapshot_make_alive(world, tables, flecs_ito(uint32_t, table_count));
+
+    /* Instance children are replicated, so prevent adding an IsA relationship
+     * from instantiating prefab hierarchies. */
+    ecs_stage_t *stage = world->stages[0];
+    ecs_entity_t base = stage->base;
+    stage->base = EcsWildcard;
+
+    const void **block_ptrs = ecs_vec_first(&blocks);
+    for (i = 0; i < total_count; i ++) {
+        ecs_snapshot_table_t *t = &tables[i];
+        int res;
+        if (i < table_count) {
+            res = flecs_snapshot_restore_table(world, t,
+                &block_ptrs[t->blocks], data, true);
+        } else {
+            res = flecs_snapshot_update_table(world, t,
+                &block_ptrs[t->blocks], data);
+        }
+        if (res) {
+            stage->base = base;
+            goto cleanup;
+        }
+    }
+
+    stage->base = base;
+    result = 0;
+cleanup:
+    ecs_map_fini(&deleted_map);
+    ecs_map_fini(&entities);
+    ecs_vec_fini_t(NULL, &blocks, const void*);
+    ecs_os_free(tables);
+    return result;
+error:
+    return -1;
+}
+
+/* Copy of the entity ids or component values of a table column. A copy is
+ * shared between forks for as long as the column doesn't change. */
+typedef struct ecs_fork_column_t {
+    const ecs_type_info_t *ti; /* NULL for entity ids */
+    void *data;
+    int32_t count;
+    int32_t dirty;             /* Dirty state of the column when copied */
+    int32_t refcount;
+} ecs_fork_column_t;
+
+/* How the values of a column are restored */
+typedef enum ecs_fork_kind_t {
+    EcsForkSkip,               /* Values are not restored */
+    EcsForkCopy,               /* Values are copied into the column */
+    EcsForkSet                 /* Values are assigned with a set operation */
+} ecs_fork_kind_t;
+
+typedef struct ecs_fork_table_t {
+    ecs_snapshot_sort_t sort;  /* Table pointer is only valid while forking */
+    uint64_t table_id;
+    ecs_type_t type;           /* Used to recreate the table if deleted */
+    ecs_fork_column_t *entities;
+    ecs_fork_column_t **columns; /* NULL for columns that aren't restored */
+    int32_t column_count;
+} ecs_fork_table_t;
+
+struct ecs_world_fork_t {
+    ecs_world_t *world;
+    ecs_vec_t tables;          /* vec<ecs_fork_table_t>, parents first */
+    ecs_map_t table_index;     /* map<table id, index in tables + 1> */
+};
+
+static
+ecs_fork_kind_t flecs_fork_column_kind(
+    ecs_table_t *table,
+    int32_t column)
+{
+    const ecs_type_info_t *ti = table->data.columns[column].ti;
+    if (ti->hooks.flags & ECS_TYPE_HOOK_COPY_ILLEGAL) {
+        return EcsForkSkip;
+    }
+
+    /* Components that are indexed by hooks must be assigned with regular
+     * operations, so that the indices stay in sync. */
+    ecs_id_t id = flecs_column_id(table, column);
+    if (id == ecs_id(EcsParent) ||
+        id == ecs_pair_t(EcsIdentifier, EcsName) ||
+        id == ecs_pair_t(EcsIdentifier, EcsSymbol) ||
+        id == ecs_pair_t(EcsIdentifier, EcsAlias))
+    {
+        return EcsForkSet;
+    }
+
+    if (ECS_IS_PAIR(id) && ECS_PAIR_FIRST(id) == ecs_id(EcsIdentifier)) {
+        return EcsForkSkip;
+    }
+
+    return EcsForkCopy;
+}
+
+static
+ecs_fork_column_t* flecs_fork_column_copy(
+    const void *src,
+    int32_t count,
+    int32_t dirty,
+    const ecs_type_info_t *ti)
+{
+    ecs_fork_column_t *result = ecs_os_calloc_t(ecs_fork_column_t);
+    result->ti = ti;
+    result->count = count;
+    result->dirty = dirty;
+    result->refcount = 1;
+
+    if (count) {
+        ecs_size_t size = ti ? ti->size : ECS_SIZEOF(ecs_entity_t);
+        result->data = ecs_os_malloc(size * count);
+        if (ti) {
+            flecs_type_info_copy_ctor(result->data, src, count, ti);
+        } else {
+            ecs_os_memcpy(result->data, src, size * count);
+        }
+    }
+
+    return result;
+}
+
+static
+ecs_fork_column_t* flecs_fork_column_share(
+    ecs_fork_column_t *column)
+{
+    column->refcount ++;
+    return column;
+}
+
+static
+void flecs_fork_column_release(
+    ecs_fork_column_t *column)
+{
+    if (!column || -- column->refcount) {
+        return;
+    }
+
+    if (column->ti && column->count) {
+        flecs_type_info_dtor(column->data, column->count, column->ti);
+    }
+
+    ecs_os_free(column->data);
+    ecs_os_free(column);
+}
+
+static
+const ecs_fork_table_t* flecs_fork_get_table(
+    const ecs_world_fork_t *fork,
+    const ecs_table_t *table)
+{
+    if (!fork) {
+        return NULL;
+    }
+
+    ecs_map_val_t *index = ecs_map_get(&fork->table_index, table->id);
+    if (!index) {
+        return NULL;
+    }
+
+    return ecs_vec_get_t(&fork->tables,
+        ecs_fork_table_t, flecs_uto(int32_t, index[0] - 1));
+}
+
+/* Get the table of a fork table if it wasn't deleted. Table ids contain a
+ * generation, so a recreated table doesn't match the id in the fork. */
+static
+ecs_table_t* flecs_fork_table_get_alive(
+    ecs_world_t *world,
+    const ecs_fork_table_t *ft)
+{
+    if (!ft->table_id) {
+        return &world->store.root;
+    }
+
+    ecs_table_t *table = flecs_sparse_get_t(
+        &world->store.tables, ecs_table_t, ft->table_id);
+    if (!table || table->id != ft->table_id) {
+        return NULL;
+    }
+
+    return table;
+}
+
+/* Copy the entity ids and values of a table. Copies of the previous fork are
+ * reused if the rows and column didn't change since the previous fork. */
+static
+void flecs_fork_table_init(
+    ecs_world_t *world,
+    ecs_fork_table_t *ft,
+    const ecs_fork_table_t *prev)
+{
+    ecs_table_t *table = ft->sort.table;
+    if (!prev) {
+        flecs_snapshot_track_table(world, table);
+    }
+
+    ft->table_id = table->id;
+    ft->type.count = table->type.count;
+    ft->type.array = ecs_os_memdup_n(
+        table->type.array, ecs_id_t, table->type.count);
+
+    int32_t *dirty = flecs_table_get_dirty_state(world, table);
+    int32_t i, count = ecs_table_count(table);
+
+    if (prev && prev->entities->dirty == dirty[0]) {
+        ft->entities = flecs_fork_column_share(prev->entities);
+    } else {
+        ft->entities = flecs_fork_column_copy(
+            ecs_table_entities(table), count, dirty[0], NULL);
+        prev = NULL; /* Rows changed, so values can't be shared */
+    }
+
+    int32_t column_count = table->column_count;
+    if (!column_count) {
+        return;
+    }
+
+    ft->columns = ecs_os_calloc_n(ecs_fork_column_t*, column_count);
+    ft->column_count = column_count;
+    for (i = 0; i < column_count; i ++) {
+        if (flecs_fork_column_kind(table, i) == EcsForkSkip) {
+            continue;
+        }
+
+        ecs_fork_column_t *prev_column = prev ? prev->columns[i] : NULL;
+        if (prev_column && prev_column->dirty == dirty[i + 1]) {
+            ft->columns[i] = flecs_fork_column_share(prev_column);
+        } else {
+            ecs_column_t *column = &table->data.columns[i];
+            ft->columns[i] = flecs_fork_column_copy(
+                column->data, count, dirty[i + 1], column->ti);
+        }
+    }
+}
+
+static
+void flecs_fork_table_fini(
+    ecs_fork_table_t *ft)
+{
+    int32_t i;
+    for (i = 0; ft->columns && i < ft->column_count; i ++) {
+        flecs_fork_column_release(ft->columns[i]);
+    }
+
+    ecs_os_free(ft->columns);
+    ecs_os_free(ft->type.array);
+    flecs_fork_column_release(ft->entities);
+}
+
+static
+int flecs_fork_compare_table(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const ecs_fork_table_t *t1 = ptr_1;
+    const ecs_fork_table_t *t2 = ptr_2;
+    return flecs_snapshot_compare_table(&t1->sort, &t2->sort);
+}
+
+ecs_world_fork_t* ecs_world_fork(
+    ecs_world_t *world,
+    const ecs_world_fork_t *prev)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot fork world while in readonly mode");
+    ecs_check(!prev || prev->world == world, ECS_INVALID_PARAMETER,
+        "previous fork was created for a different world");
+
+    ecs_world_fork_t *result = ecs_os_calloc_t(ecs_world_fork_t);
+    result->world = world;
+    world->fork_count ++;
+    ecs_vec_init_t(NULL, &result->tables, ecs_fork_table_t, 0);
+    ecs_map_init(&result->table_index, &world->allocator);
+
+    const ecs_sparse_t *store = &world->store.tables;
+    int32_t i, table_count = flecs_sparse_count(store);
+    for (i = -1; i < table_count; i ++) {
+        ecs_table_t *table = i == -1 ? &world->store.root :
+            flecs_sparse_get_dense_t(store, ecs_table_t, i);
+        if (i != -1 && table == &world->store.root) {
+            continue;
+        }
+        if (flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_fork_table_t *ft = ecs_vec_append_t(
+            NULL, &result->tables, ecs_fork_table_t);
+        ecs_os_zeromem(ft);
+        ft->sort.table = table;
+        ft->sort.depth = flecs_snapshot_table_depth(world, table);
+        flecs_fork_table_init(world, ft, flecs_fork_get_table(prev, table));
+    }
+
+    table_count = ecs_vec_count(&result->tables);
+    ecs_fork_table_t *tables = ecs_vec_first(&result->tables);
+    if (table_count > 1) {
+        qsort(tables, flecs_itosize(table_count), sizeof(ecs_fork_table_t),
+            flecs_fork_compare_table);
+    }
+
+    for (i = 0; i < table_count; i ++) {
+        ecs_map_insert(&result->table_index, tables[i].sort.table->id,
+            flecs_ito(uint64_t, i + 1));
+    }
+
+    return result;
+error:
+    return NULL;
+}
+
+void ecs_world_fork_free(
+    ecs_world_fork_t *fork)
+{
+    if (!fork) {
+        return;
+    }
+
+    int32_t i, count = ecs_vec_count(&fork->tables);
+    ecs_fork_table_t *tables = ecs_vec_first(&fork->tables);
+    for (i = 0; i < count; i ++) {
+        flecs_fork_table_fini(&tables[i]);
+    }
+
+    ecs_map_fini(&fork->table_index);
+    ecs_vec_fini_t(NULL, &fork->tables, ecs_fork_table_t);
+    fork->world->fork_count --;
+    ecs_os_free(fork);
+}
+
+/* Compute the ids that are added and removed when moving between tables */
+static
+void flecs_fork_type_diff(
+    const ecs_type_t *src,
+    const ecs_type_t *dst,
+    ecs_id_t *ids,
+    ecs_type_t *added,
+    ecs_type_t *removed)
+{
+    int32_t i_src = 0, i_dst = 0;
+    int32_t src_count = src->count, dst_count = dst->count;
+    added->array = ids;
+    added->count = 0;
+
+    /* Removed ids are stored at the end of the ids array */
+    removed->array = &ids[dst_count];
+    removed->count = 0;
+
+    while (i_src < src_count || i_dst < dst_count) {
+        ecs_id_t id_src = i_src < src_count ? src->array[i_src] : 0;
+        ecs_id_t id_dst = i_dst < dst_count ? dst->array[i_dst] : 0;
+        if (i_src < src_count && (i_dst == dst_count || id_src < id_dst)) {
+            removed->array[removed->count ++] = id_src;
+            i_src ++;
+        } else if (i_src == src_count || id_dst < id_src) {
+            added->array[added->count ++] = id_dst;
+            i_dst ++;
+        } else {
+            i_src ++;
+            i_dst ++;
+        }
+    }
+}
+
+/* Get the table that an entity is moved to before its Parent component is
+ * assigned, which moves the entity to the table with the right depth. */
+static
+ecs_table_t* flecs_fork_commit_table(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    if (!(table->flags & EcsTableHasParent)) {
+        return table;
+    }
+
+    int32_t i, count = 0;
+    ecs_id_t *ids = ecs_os_malloc_n(ecs_id_t, table->type.count);
+    for (i = 0; i < table->type.count; i ++) {
+        ecs_id_t id = table->type.array[i];
+        if (id == ecs_id(EcsParent)) {
+            continue;
+        }
+        if (ECS_IS_VALUE_PAIR(id) && ECS_PAIR_FIRST(id) == EcsParentDepth) {
+            continue;
+        }
+        ids[count ++] = id;
+    }
+
+    ecs_table_t *result = ecs_table_find(world, ids, count);
+    ecs_os_free(ids);
+    return result;
+}
+
+/* Make the entities of a table alive and move them to the table. If the table
+ * was deleted, it is recreated from the type stored in the fork. */
+static
+ecs_table_t* flecs_fork_restore_entities(
+    ecs_world_t *world,
+    const ecs_fork_table_t *ft,
+    ecs_table_t *table)
+{
+    ecs_table_t *dst = NULL;
+    const ecs_entity_t *entities = ft->entities->data;
+    int32_t i, count = ft->entities->count;
+    ecs_id_t *ids = NULL;
+    int32_t ids_size = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = entities[i];
+        if (!ecs_is_alive(world, e)) {
+            ecs_entity_t cur = ecs_get_alive(world, (uint32_t)e);
+            if (cur) {
+                ecs_delete(world, cur);
+            }
+            ecs_make_alive(world, e);
+        }
+    }
+
+    if (!table) {
+        table = flecs_table_find_or_create(world, 
+            &(ecs_type_t){ .array = ft->type.array, .count = ft->type.count });
+        flecs_snapshot_track_table(world, table);
+    }
+
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = entities[i];
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        if (r->table == table) {
+            continue;
+        }
+
+        if (!dst) {
+            dst = flecs_fork_commit_table(world, table);
+        }
+
+        ecs_type_t src_type = { 0 };
+        if (r->table) {
+            src_type = r->table->type;
+        }
+
+        int32_t size = src_type.count + dst->type.count;
+        if (size > ids_size) {
+            ids = ecs_os_realloc_n(ids, ecs_id_t, size);
+            ids_size = size;
+        }
+
+        ecs_type_t added, removed;
+        flecs_fork_type_diff(&src_type, &dst->type, ids, &added, &removed);
+        ecs_commit(world, e, NULL, dst, &added, &removed);
+
+        if (dst != table) {
+            int32_t column = table->component_map[ecs_id(EcsParent)] - 1;
+            ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+            ecs_set_id(world, e, ecs_id(EcsParent), sizeof(EcsParent),
+                ECS_ELEM_T(ft->columns[column]->data, EcsParent, i));
+        }
+    }
+
+    ecs_os_free(ids);
+    return table;
+}
+
+static
+bool flecs_fork_value_equals(
+    ecs_id_t id,
+    const void *a,
+    const void *b)
+{
+    if (id == ecs_id(EcsParent)) {
+        return ((const EcsParent*)a)->value == ((const EcsParent*)b)->value;
+    }
+
+    const char *str_a = ((const EcsIdentifier*)a)->value;
+    const char *str_b = ((const EcsIdentifier*)b)->value;
+    if (!str_a || !str_b) {
+        return str_a == str_b;
+    }
+
+    return !ecs_os_strcmp(str_a, str_b);
+}
+
+static
+void flecs_fork_set_value(
+    ecs_world_t *world,
+    ecs_entity_t e,
+    ecs_id_t id,
+    const void *value)
+{
+    if (id == ecs_id(EcsParent)) {
+        ecs_set_id(world, e, id, sizeof(EcsParent), value);
+        return;
+    }
+
+    const char *str = ((const EcsIdentifier*)value)->value;
+    if (id == ecs_pair_t(EcsIdentifier, EcsName)) {
+        ecs_set_name(world, e, str);
+    } else if (id == ecs_pair_t(EcsIdentifier, EcsSymbol)) {
+        ecs_set_symbol(world, e, str);
+    } else {
+        ecs_set_alias(world, e, str);
+    }
+}
+
+/* Restore the values of a table. If the rows of the table are the same as
+ * when the fork was created, only columns that changed are copied. */
+static
+void flecs_fork_restore_values(
+    ecs_world_t *world,
+    const ecs_fork_table_t *ft,
+    ecs_table_t *table,
+    bool rows_changed)
+{
+    const int32_t *dirty = flecs_table_get_dirty_state(world, table);
+    const ecs_entity_t *entities = ft->entities->data;
+    int32_t i, count = ft->entities->count;
+
+    /* Rows were changed, but entities could be in the same order again, for 
+     * example when an entity was created and deleted. */
+    bool same_order = !rows_changed || (ecs_table_count(table) == count &&
+        !ecs_os_memcmp(ecs_table_entities(table), entities, 
+            ECS_SIZEOF(ecs_entity_t) * count));
+
+    int32_t c, column_count = table->column_count;
+    for (c = 0; c < column_count; c ++) {
+        const ecs_fork_column_t *fc = ft->columns ? ft->columns[c] : NULL;
+        if (!fc || (!rows_changed && dirty[c + 1] == fc->dirty)) {
+            continue;
+        }
+
+        ecs_column_t *column = &table->data.columns[c];
+        const ecs_type_info_t *ti = column->ti;
+        ecs_size_t size = ti->size;
+
+        if (flecs_fork_column_kind(table, c) == EcsForkSet) {
+            ecs_id_t id = flecs_column_id(table, c);
+            for (i = 0; i < count; i ++) {
+                ecs_record_t *r = flecs_entities_get(world, entities[i]);
+                ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+                int32_t row = ECS_RECORD_TO_ROW(r->row);
+                const void *src = ECS_ELEM(fc->data, size, i);
+                if (!flecs_fork_value_equals(
+                    id, ECS_ELEM(column->data, size, row), src))
+                {
+                    flecs_fork_set_value(world, entities[i], id, src);
+                }
+            }
+            continue;
+        }
+
+        if (same_order) {
+            flecs_type_info_copy(column->data, fc->data, count, ti);
+        } else {
+            for (i = 0; i < count; i ++) {
+                ecs_record_t *r = flecs_entities_get(world, entities[i]);
+                ecs_assert(r->table == table, ECS_INTERNAL_ERROR, NULL);
+                int32_t row = ECS_RECORD_TO_ROW(r->row);
+                flecs_type_info_copy(ECS_ELEM(column->data, size, row),
+                    ECS_ELEM(fc->data, size, i), 1, ti);
+            }
+        }
+
+        flecs_table_mark_dirty(world, table, flecs_column_id(table, c));
+    }
+}
+
+void ecs_world_fork_restore(
+    const ecs_world_fork_t *fork)
+{
+    ecs_check(fork != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_world_t *world = fork->world;
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot restore fork while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION,
+        "cannot restore fork while world is deferred");
+
+    int32_t i, count = ecs_vec_count(&fork->tables);
+    const ecs_fork_table_t *tables = ecs_vec_first(&fork->tables);
+    bool *changed = ecs_os_calloc_n(bool, count + 1);
+    ecs_table_t **alive = ecs_os_calloc_n(ecs_table_t*, count + 1);
+
+    /* Entities of tables with rows that changed since the fork was created */
+    ecs_map_t entities;
+    ecs_map_init(&entities, &world->allocator);
+
+    for (i = 0; i < count; i ++) {
+        const ecs_fork_table_t *ft = &tables[i];
+        ecs_table_t *table = alive[i] = flecs_fork_table_get_alive(world, ft);
+        if (table && 
+            flecs_table_get_dirty_state(world, table)[0] == ft->entities->dirty)
+        {
+            continue;
+        }
+
+        changed[i] = true;
+        const ecs_entity_t *ids = ft->entities->data;
+        int32_t j;
+        for (j = 0; j < ft->entities->count; j ++) {
+            ecs_map_ensure(&entities, ids[j]);
+        }
+    }
+
+    /* Delete entities that were created after the fork. Only tables that are
+     * not in the fork or that have changed rows can contain such entities. */
+    ecs_vec_t deleted;
+    ecs_vec_init_t(NULL, &deleted, ecs_entity_t, 0);
+
+    const ecs_sparse_t *store = &world->store.tables;
+    int32_t table_count = flecs_sparse_count(store);
+    for (i = -1; i < table_count; i ++) {
+        ecs_table_t *table = i == -1 ? &world->store.root :
+            flecs_sparse_get_dense_t(store, ecs_table_t, i);
+        if (i != -1 && table == &world->store.root) {
+            continue;
+        }
+        if (flecs_snapshot_skip_table(world, table)) {
+            continue;
+        }
+
+        ecs_map_val_t *index = ecs_map_get(&fork->table_index, table->id);
+        if (index && !changed[index[0] - 1]) {
+            continue;
+        }
+
+        const ecs_entity_t *ids = ecs_table_entities(table);
+        int32_t j, table_entity_count = ecs_table_count(table);
+        for (j = 0; j < table_entity_count; j ++) {
+            if (!ecs_map_get(&entities, ids[j])) {
+                ecs_vec_append_t(NULL, &deleted, ecs_entity_t)[0] = ids[j];
+            }
+        }
+    }
+
+    const ecs_entity_t *deleted_ids = ecs_vec_first(&deleted);
+    for (i = 0; i < ecs_vec_count(&deleted); i ++) {
+        if (ecs_is_alive(world, deleted_ids[i])) {
+            ecs_delete(world, deleted_ids[i]);
+        }
+    }
+
+    /* Instance children are part of the fork, so prevent adding an IsA 
+     * relationship from instantiating prefab hierarchies. */
+    ecs_stage_t *stage = world->stages[0];
+    ecs_entity_t base = stage->base;
+    stage->base = EcsWildcard;
+
+    for (i = 0; i < count; i ++) {
+        if (changed[i]) {
+            alive[i] = flecs_fork_restore_entities(world, &tables[i], alive[i]);
+        }
+    }
+
+    stage->base = base;
+
+    for (i = 0; i < count; i ++) {
+        flecs_fork_restore_values(world, &tables[i], alive[i], changed[i]);
+    }
+
+    ecs_vec_fini_t(NULL, &deleted, ecs_entity_t);
+    ecs_map_fini(&entities);
+    ecs_os_free(alive);
+    ecs_os_free(changed);
+error:
+    return;
+}
+
+#endif
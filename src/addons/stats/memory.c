@@ -269,7 +269,8 @@ void ecs_component_record_memory_get(
         
         const ecs_reachable_cache_t *reachable = &pair->reachable;
         result->bytes_reachable_cache += 
-            ecs_vec_size(&reachable->ids) * ECS_SIZEOF(ecs_reachable_elem_t);
+            ecs_vec_size(&reachable->ids) * ECS_SIZEOF(ecs_reachable_elem_t) +
+            ecs_vec_size(&reachable->up) * ECS_SIZEOF(ecs_reachable_up_t);
     }
 }
 
@@ -319,6 +319,7 @@ void ecs_world_stats_get(
     ECS_COUNTER_RECORD(&s->memory.stack_alloc_count, t, ecs_stack_allocator_alloc_count);
     ECS_COUNTER_RECORD(&s->memory.stack_free_count, t, ecs_stack_allocator_free_count);
     ECS_GAUGE_RECORD(&s->memory.stack_outstanding_alloc_count, t, outstanding_allocs);
+    ECS_COUNTER_RECORD(&s->memory.compact_reclaimed_bytes, t, world->info.compact_reclaimed_total);
 
 #ifdef FLECS_HTTP
     ECS_COUNTER_RECORD(&s->http.request_received_count, t, ecs_http_request_received_count);
@@ -589,6 +590,7 @@ bool ecs_pipeline_stats_get(
                 ECS_COUNTER_RECORD(&el->time_spent, s->t, cur->time_spent);
                 ECS_COUNTER_RECORD(&el->commands_enqueued, s->t, 
                     cur->commands_enqueued);
+                ECS_COUNTER_RECORD(&el->wait_time, s->t, cur->wait_time);
 
                 el->system_count = cur->count;
                 el->multi_threaded = cur->multi_threaded;
@@ -26,6 +26,7 @@ ecs_entity_t flecs_run_system(
     ecs_system_t *system_data,
     int32_t stage_index,
     int32_t stage_count,    
+    int32_t *chunk_cursor,
     ecs_ftime_t delta_time,
     void *param) 
 {
@@ -98,7 +99,12 @@ ecs_entity_t flecs_run_system(
     }
 
     if (stage_count > 1 && system_data->multi_threaded) {
-        wit = ecs_worker_iter(it, stage_index, stage_count);
+        if (chunk_cursor) {
+            wit = ecs_dynamic_worker_iter(
+                it, chunk_cursor, system_data->chunk_size);
+        } else {
+            wit = ecs_worker_iter(it, stage_index, stage_count);
+        }
         it = &wit;
     }
 
@@ -171,7 +177,7 @@ ecs_entity_t ecs_run_worker(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
-        world, stage, system, system_data, stage_index, stage_count, 
+        world, stage, system, system_data, stage_index, stage_count, NULL,
         delta_time, param);
     flecs_defer_end(world, stage);
     return result;
@@ -188,7 +194,7 @@ ecs_entity_t ecs_run(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_defer_begin(world, stage);
     ecs_entity_t result = flecs_run_system(
-        world, stage, system, system_data, 0, 0, delta_time, param);
+        world, stage, system, system_data, 0, 0, NULL, delta_time, param);
     flecs_defer_end(world, stage);
     return result;
 }
@@ -279,6 +285,9 @@ ecs_entity_t ecs_system_init(
         "entity %s already is a system, use ecs_system_update() to modify",
             flecs_errstr(ecs_get_path(world, entity)));
 
+    ecs_check(desc->chunk_size >= 0, ECS_INVALID_PARAMETER,
+        "invalid chunk_size %d", desc->chunk_size);
+
     ecs_check(desc->callback != NULL || desc->run != NULL,
         ECS_INVALID_PARAMETER,
         "missing implementation for system %s (set .callback or .run)",
@@ -325,6 +334,7 @@ ecs_entity_t ecs_system_init(
     system->tick_source = desc->tick_source;
 
     system->multi_threaded = desc->multi_threaded;
+    system->chunk_size = desc->chunk_size;
     system->immediate = desc->immediate;
 
     system->name = ecs_get_path(world, entity);
@@ -435,6 +445,10 @@ ecs_entity_t ecs_system_update(
         system->multi_threaded = desc->multi_threaded;
     }
 
+    if (desc->chunk_size) {
+        system->chunk_size = desc->chunk_size;
+    }
+
     if (desc->immediate) {
         system->immediate = desc->immediate;
     }
@@ -23,6 +23,7 @@ ecs_entity_t flecs_run_system(
     ecs_system_t *system_data,
     int32_t stage_current,
     int32_t stage_count,
+    int32_t *chunk_cursor,
     ecs_ftime_t delta_time,
     void *param);
 
@@ -140,6 +140,11 @@ bool flecs_set_id_flag(
             flecs_component_record_init_exclusive(world, cr);
         }
 
+        if (flag == EcsIdSoA) {
+            /* SoA components don't have a column of their own */
+            flecs_component_set_type_info(world, cr, NULL);
+        }
+
         return true;
     }
 
@@ -1014,6 +1019,8 @@ void flecs_bootstrap(
     flecs_bootstrap_trait(world, EcsOnInstantiate);
     flecs_bootstrap_trait(world, EcsSparse);
     flecs_bootstrap_trait(world, EcsDontFragment);
+    flecs_bootstrap_trait(world, EcsSoA);
+    flecs_bootstrap_trait(world, EcsDenseToggle);
 
     flecs_bootstrap_tag(world, EcsRemove);
     flecs_bootstrap_tag(world, EcsDelete);
@@ -1154,6 +1161,16 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t dense_toggle_trait = { EcsIdDenseToggle, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsDenseToggle }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &dense_toggle_trait,
+        .global_observer = true
+    });
+
     static ecs_on_trait_ctx_t with_trait = { EcsIdWith, 0 };
     ecs_observer(world, {
         .query.terms = {
@@ -1176,6 +1193,16 @@ void flecs_bootstrap(
         .global_observer = true
     });
 
+    static ecs_on_trait_ctx_t soa_trait = { EcsIdSoA, 0 };
+    ecs_observer(world, {
+        .query.terms = {{ .id = EcsSoA }},
+        .query.flags = EcsQueryMatchPrefab|EcsQueryMatchDisabled,
+        .events = {EcsOnAdd},
+        .callback = flecs_register_trait,
+        .ctx = &soa_trait,
+        .global_observer = true
+    });
+
     static ecs_on_trait_ctx_t dont_fragment_trait = { EcsIdDontFragment, 0 };
     ecs_observer(world, {
         .query.terms = {{ .id = EcsDontFragment }},
@@ -1279,6 +1306,9 @@ void flecs_bootstrap(
 
     /* DontFragment components are always sparse */
     ecs_add_pair(world, EcsDontFragment, EcsWith, EcsSparse);
+
+    /* DenseToggle components can be toggled */
+    ecs_add_pair(world, EcsDenseToggle, EcsWith, EcsCanToggle);
     
     /* Modules are singletons */
     ecs_add_pair(world, EcsModule, EcsWith, EcsSingleton);
@@ -1289,6 +1319,7 @@ void flecs_bootstrap(
     ecs_add_pair(world, EcsOnDelete, EcsOnInstantiate, EcsDontInherit);
     ecs_add_pair(world, EcsExclusive, EcsOnInstantiate, EcsDontInherit);
     ecs_add_pair(world, EcsDontFragment, EcsOnInstantiate, EcsDontInherit);
+    ecs_add_pair(world, EcsSoA, EcsOnInstantiate, EcsDontInherit);
 
     /* Acyclic/Traversable components */
     ecs_add_id(world, EcsIsA, EcsTraversable);
@@ -441,6 +441,14 @@ void* flecs_defer_ensure(
         "bad size for component in ensure");
 
     ecs_table_t *table = r->table;
+
+    /* If the world has forks, return a copy of an existing value so that the
+     * column is marked as changed when the value is merged. */
+    void *existing = world->fork_count ? ptr.ptr : NULL;
+    if (existing) {
+        ptr.ptr = NULL;
+    }
+
     if (!ptr.ptr) {
         ecs_stack_t *stack = &stage->cmd->stack;
         cmd->kind = EcsCmdEnsure;
@@ -449,8 +457,8 @@ void* flecs_defer_ensure(
             flecs_stack_alloc(stack, size, ti->alignment);
 
         /* Check if entity inherits component */
-        void *base = NULL;
-        if (table && (table->flags & EcsTableHasIsA)) {
+        void *base = existing;
+        if (!base && table && (table->flags & EcsTableHasIsA)) {
             ecs_component_record_t *cr = flecs_components_get(world, id);
             base = flecs_get_base_component(world, table, id, cr, 0);
         }
@@ -459,7 +467,7 @@ void* flecs_defer_ensure(
             /* Normal ctor */
             flecs_type_info_ctor(ptr.ptr, 1, ti);
         } else {
-            /* Override */
+            /* Override, or copy of existing value */
             flecs_type_info_copy_ctor(ptr.ptr, base, 1, ti);
         }
     } else {
@@ -1056,6 +1064,7 @@ void flecs_cmd_batch_for_entity(
                         cmd->kind = EcsCmdModified;
                     } else {
                         /* If this was an ensure, nothing's left to be done */
+                        flecs_mark_dirty_if_forked(world, r->table, cmd->id);
                         cmd->kind = EcsCmdSkip;
                     }
                 } else {
@@ -1385,6 +1394,357 @@ bool flecs_defer_end(
     return false;
 }
 
+/* Test if there are observers for an id for any of the builtin events. */
+static
+bool flecs_cmd_observers_exist(
+    ecs_world_t *world,
+    ecs_id_t id)
+{
+    const ecs_observable_t *o = &world->observable;
+    return flecs_observers_exist(o, id, EcsOnAdd) ||
+        flecs_observers_exist(o, id, EcsOnRemove) ||
+        flecs_observers_exist(o, id, EcsOnSet) ||
+        flecs_observers_exist(o, id, EcsWildcard);
+}
+
+/* Test if an id is matched by observers for wildcard ids. These don't set the
+ * observer flags on the component record of the id itself. */
+static
+bool flecs_cmd_wildcard_observers_exist(
+    ecs_world_t *world,
+    ecs_id_t id)
+{
+    if (flecs_cmd_observers_exist(world, EcsAny)) {
+        return true;
+    }
+
+    if (ECS_IS_PAIR(id)) {
+        return flecs_cmd_observers_exist(world, 
+                ecs_pair(EcsWildcard, ECS_PAIR_SECOND(id))) ||
+            flecs_cmd_observers_exist(world, 
+                ecs_pair(ECS_PAIR_FIRST(id), EcsWildcard)) ||
+            flecs_cmd_observers_exist(world, 
+                ecs_pair(EcsWildcard, EcsWildcard));
+    }
+
+    return flecs_cmd_observers_exist(world, EcsWildcard);
+}
+
+/* Test if merging a command can invoke hooks or observers. These can read and
+ * write any component of any entity, so values may only be moved into storage
+ * before the (serial) merge if no command has side effects. */
+static
+bool flecs_cmd_has_side_effects(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    switch(cmd->kind) {
+    case EcsCmdSkip:
+        return false;
+    case EcsCmdClone:
+    case EcsCmdBulkNew:
+    case EcsCmdPath:
+    case EcsCmdDelete:
+    case EcsCmdClear:
+    case EcsCmdOnDeleteAction:
+    case EcsCmdEvent:
+        return true;
+    case EcsCmdSet:
+    case EcsCmdEnsure:
+    case EcsCmdAdd:
+    case EcsCmdAddModified:
+    case EcsCmdRemove:
+    case EcsCmdModified:
+    case EcsCmdModifiedNoHook:
+    case EcsCmdSetDontFragment:
+    case EcsCmdEmplace:
+    case EcsCmdEnsureDontFragment:
+    case EcsCmdEnable:
+    case EcsCmdDisable:
+        break;
+    }
+
+    if (!cmd->id) {
+        return false;
+    }
+
+    if (flecs_cmd_wildcard_observers_exist(world, cmd->id)) {
+        return true;
+    }
+
+    ecs_component_record_t *cr = flecs_components_get(world, cmd->id);
+    if (!cr) {
+        return false;
+    }
+
+    if (cr->flags & (EcsIdHasOnAdd|EcsIdHasOnRemove|EcsIdHasOnSet)) {
+        return true;
+    }
+
+    const ecs_type_info_t *ti = cr->type_info;
+    return ti && (ti->hooks.on_add || ti->hooks.on_set || 
+        ti->hooks.on_remove || ti->hooks.on_replace);
+}
+
+void flecs_commands_partition(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t partition_count)
+{
+    ecs_allocator_t *a = &stage->allocator;
+    ecs_vec_t *partitions = &stage->cmd_partitions;
+    int32_t i, count = ecs_vec_count(partitions);
+    if (count < partition_count) {
+        ecs_vec_set_count_t(a, partitions, ecs_vec_t, partition_count);
+        for (i = count; i < partition_count; i ++) {
+            ecs_vec_init_t(a, ecs_vec_get_t(partitions, ecs_vec_t, i), 
+                int32_t, 0);
+        }
+    }
+
+    ecs_vec_t *p = ecs_vec_first_t(partitions, ecs_vec_t);
+    for (i = 0; i < partition_count; i ++) {
+        ecs_vec_clear(&p[i]);
+    }
+
+    stage->cmd_merge_serial = false;
+
+    ecs_vec_t *queue = &stage->cmd->queue;
+    ecs_cmd_t *cmds = ecs_vec_first_t(queue, ecs_cmd_t);
+    count = ecs_vec_count(queue);
+    for (i = 0; i < count; i ++) {
+        ecs_cmd_t *cmd = &cmds[i];
+        if (flecs_cmd_has_side_effects(world, cmd)) {
+            /* Hooks, observers and OnDelete actions invoked by the merge could
+             * read or write values that would already have been moved. */
+            stage->cmd_merge_serial = true;
+            return;
+        }
+
+        ecs_entity_t e = cmd->entity;
+        if (!e) {
+            continue;
+        }
+
+        /* Partition by entity index, so that all commands for an entity end 
+         * up in the same partition regardless of which stage enqueued them. */
+        int32_t index = (int32_t)((uint32_t)e % (uint32_t)partition_count);
+        ecs_vec_append_t(a, &p[index], int32_t)[0] = i;
+    }
+}
+
+/* Return component storage for a command if the entity already has the 
+ * component in a table column, so that the command doesn't change the table of
+ * the entity. */
+static
+void* flecs_cmd_merge_dst(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd,
+    const ecs_type_info_t **ti_out)
+{
+    ecs_entity_t e = cmd->entity;
+    if (!flecs_entities_is_alive(world, e)) {
+        return NULL;
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_table_t *table = r->table;
+    if (!table) {
+        return NULL;
+    }
+
+    ecs_component_record_t *cr = flecs_components_get(world, cmd->id);
+    if (!cr || (cr->flags & (EcsIdSparse|EcsIdDontFragment))) {
+        return NULL;
+    }
+
+    const ecs_table_record_t *tr = flecs_component_get_table(cr, table);
+    if (!tr || tr->column == -1) {
+        return NULL;
+    }
+
+    ecs_column_t *column = &table->data.columns[tr->column];
+    *ti_out = column->ti;
+    return ECS_ELEM(column->data, column->ti->size, ECS_RECORD_TO_ROW(r->row));
+}
+
+/* Test if an add command doesn't change the table of the entity because it 
+ * already has the component. This uses existing edges in the table graph, which
+ * can be read concurrently while the merge runs in parallel. */
+static
+bool flecs_cmd_add_is_noop(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    ecs_entity_t e = cmd->entity;
+    if (!cmd->id || !flecs_entities_is_alive(world, e)) {
+        return false;
+    }
+
+    ecs_record_t *r = flecs_entities_get(world, e);
+    ecs_table_t *table = r->table;
+    if (!table) {
+        return false;
+    }
+
+    const ecs_graph_edge_t *edge = flecs_table_find_add_edge(
+        world, table, cmd->id);
+    return edge && (edge->to == table) && !edge->diff;
+}
+
+/* Test if command can be merged in parallel */
+static
+bool flecs_cmd_can_merge(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    const ecs_type_info_t *ti = NULL;
+    switch(cmd->kind) {
+    case EcsCmdSet:
+    case EcsCmdEnsure:
+        /* Value must be moved from the command into storage. Don't merge if 
+         * the component has an on_replace hook, as it must be invoked with the
+         * previous value before it's overwritten. */
+        if (!cmd->is._1.value) {
+            return false;
+        }
+        if (!flecs_cmd_merge_dst(world, cmd, &ti)) {
+            return false;
+        }
+        if (cmd->kind == EcsCmdEnsure && world->fork_count) {
+            /* Column must be marked as changed, which is not thread safe */
+            return false;
+        }
+        return !ti->hooks.on_replace && (ti->size == cmd->is._1.size);
+    case EcsCmdAddModified:
+        /* Value was already assigned, only check that add is a noop */
+        return flecs_cmd_merge_dst(world, cmd, &ti) != NULL;
+    case EcsCmdModified:
+    case EcsCmdModifiedNoHook:
+        return true;
+    case EcsCmdAdd:
+        return flecs_cmd_add_is_noop(world, cmd);
+    case EcsCmdClone:
+    case EcsCmdBulkNew:
+    case EcsCmdRemove:
+    case EcsCmdSetDontFragment:
+    case EcsCmdEmplace:
+    case EcsCmdEnsureDontFragment:
+    case EcsCmdPath:
+    case EcsCmdDelete:
+    case EcsCmdClear:
+    case EcsCmdOnDeleteAction:
+    case EcsCmdEnable:
+    case EcsCmdDisable:
+    case EcsCmdEvent:
+    case EcsCmdSkip:
+        break;
+    }
+    return false;
+}
+
+/* Move values of set/ensure commands in a partition into component storage.
+ * This is only done for entities for which all commands in the partition are
+ * value commands for components the entity already has, which guarantees that
+ * the commands don't change the table of the entity. Commands are processed in stage
+ * order, so that the last enqueued value wins, like with a serial merge. Set
+ * commands are converted to modified commands, so that the merge that follows
+ * still marks the columns as changed. Partitions are only merged in parallel if
+ * none of the commands have hooks or observers. */
+void flecs_commands_merge_partition(
+    ecs_world_t *world,
+    int32_t partition)
+{
+    int32_t s, stage_count = world->stage_count;
+    for (s = 0; s < stage_count; s ++) {
+        if (world->stages[s]->cmd_merge_serial) {
+            return;
+        }
+    }
+
+    ecs_stage_t *stage = world->stages[partition];
+    ecs_map_t serial;
+    ecs_map_init(&serial, &stage->allocator);
+
+    /* Find entities with commands that can't be merged in parallel */
+    for (s = 0; s < stage_count; s ++) {
+        ecs_stage_t *src = world->stages[s];
+        ecs_cmd_t *cmds = ecs_vec_first_t(&src->cmd->queue, ecs_cmd_t);
+        ecs_vec_t *indices = ecs_vec_get_t(
+            &src->cmd_partitions, ecs_vec_t, partition);
+        int32_t *index = ecs_vec_first_t(indices, int32_t);
+        int32_t i, count = ecs_vec_count(indices);
+
+        for (i = 0; i < count; i ++) {
+            ecs_cmd_t *cmd = &cmds[index[i]];
+            if (!flecs_cmd_can_merge(world, cmd)) {
+                ecs_map_ensure(&serial, cmd->entity);
+            }
+        }
+    }
+
+    /* Move values into storage */
+    for (s = 0; s < stage_count; s ++) {
+        ecs_stage_t *src = world->stages[s];
+        ecs_cmd_t *cmds = ecs_vec_first_t(&src->cmd->queue, ecs_cmd_t);
+        ecs_vec_t *indices = ecs_vec_get_t(
+            &src->cmd_partitions, ecs_vec_t, partition);
+        int32_t *index = ecs_vec_first_t(indices, int32_t);
+        int32_t i, count = ecs_vec_count(indices);
+
+        for (i = 0; i < count; i ++) {
+            ecs_cmd_t *cmd = &cmds[index[i]];
+            if (ecs_map_get(&serial, cmd->entity)) {
+                continue;
+            }
+
+            /* All commands for the entity are handled here, so the merge
+             * doesn't need to batch them. */
+            if (cmd->next_for_entity < 0) {
+                cmd->next_for_entity *= -1;
+            }
+
+            ecs_cmd_kind_t kind = cmd->kind;
+            if (kind == EcsCmdAddModified) {
+                /* Entity already has the component */
+                cmd->kind = EcsCmdModified;
+                continue;
+            }
+
+            if (kind == EcsCmdAdd) {
+                /* Entity already has the component */
+                cmd->kind = EcsCmdSkip;
+                continue;
+            }
+
+            if (kind != EcsCmdSet && kind != EcsCmdEnsure) {
+                continue;
+            }
+
+            const ecs_type_info_t *ti = NULL;
+            void *dst = flecs_cmd_merge_dst(world, cmd, &ti);
+            ecs_assert(dst != NULL, ECS_INTERNAL_ERROR, NULL);
+
+            void *ptr = cmd->is._1.value;
+            bool move_hook = ti->hooks.move != NULL;
+            flecs_type_info_move(dst, ptr, 1, ti);
+            if (move_hook) {
+                flecs_type_info_dtor(ptr, 1, ti);
+            }
+
+            flecs_stack_free(ptr, cmd->is._1.size);
+            cmd->is._1.value = NULL;
+
+            /* Same as batched commands: set is reduced to modified, and there 
+             * is nothing left to do for ensure. */
+            cmd->kind = (kind == EcsCmdSet) ? EcsCmdModified : EcsCmdSkip;
+            stage->cmd_merged_count ++;
+        }
+    }
+
+    ecs_map_fini(&serial);
+}
+
 /* Discard commands from queue without executing them. */
 bool flecs_defer_purge(
     ecs_world_t *world,
@@ -202,5 +202,16 @@ void flecs_enqueue(
     ecs_world_t *world,
     ecs_stage_t *stage,
     ecs_event_desc_t *desc);
+
+/* Partition commands in stage queue by entity for parallel merge. */
+void flecs_commands_partition(
+    ecs_world_t *world,
+    ecs_stage_t *stage,
+    int32_t partition_count);
+
+/* Move component values of commands in partition into component storage. */
+void flecs_commands_merge_partition(
+    ecs_world_t *world,
+    int32_t partition);
  
 #endif
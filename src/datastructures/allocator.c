@@ -31,6 +31,10 @@ void flecs_allocator_init(
     flecs_ballocator_init_n(&a->chunks, ecs_block_allocator_t,
         FLECS_SPARSE_PAGE_SIZE);
     flecs_sparse_init_t(&a->sizes, NULL, &a->chunks, ecs_block_allocator_t);
+#ifdef FLECS_HUGE_PAGES
+    ecs_os_zeromem(&a->arena);
+    a->chunks.arena = &a->arena;
+#endif
 #endif
 }
 
@@ -50,6 +54,9 @@ void flecs_allocator_fini(
     flecs_sparse_fini(&a->sizes);
 
     flecs_ballocator_fini(&a->chunks);
+#ifdef FLECS_HUGE_PAGES
+    flecs_page_arena_fini(&a->arena);
+#endif
 #endif
 }
 
@@ -74,6 +81,9 @@ ecs_block_allocator_t* flecs_allocator_get(
         result = flecs_sparse_ensure_fast_t(&a->sizes, 
             ecs_block_allocator_t, (uint32_t)hash);
         flecs_ballocator_init(result, size);
+#ifdef FLECS_HUGE_PAGES
+        result->arena = &a->arena;
+#endif
     }
 
     ecs_assert(result->data_size == size, ECS_INTERNAL_ERROR, NULL);
@@ -25,6 +25,82 @@ int64_t ecs_block_allocator_free_count = 0;
  * allocation sizes, which are more likely to be reused. */
 #define FLECS_MIN_CHUNKS_PER_BLOCK 1
 
+#ifdef FLECS_HUGE_PAGES
+
+/* Header of a slab allocated by a page arena */
+typedef struct ecs_page_slab_t {
+    struct ecs_page_slab_t *next;
+    bool os_page; /* Allocated with ecs_os_page_alloc */
+} ecs_page_slab_t;
+
+#define FLECS_PAGE_SLAB_HEADER ECS_ALIGN(ECS_SIZEOF(ecs_page_slab_t), 16)
+
+static
+void* flecs_page_alloc(
+    ecs_size_t size,
+    bool *os_page)
+{
+    if (ecs_os_api.page_alloc_) {
+        void *result = ecs_os_page_alloc(size);
+        if (result) {
+            *os_page = true;
+            return result;
+        }
+    }
+
+    *os_page = false;
+    return ecs_os_malloc(size);
+}
+
+static
+void* flecs_page_arena_alloc(
+    ecs_page_arena_t *arena,
+    ecs_size_t size)
+{
+    ecs_assert(size <= (FLECS_HUGE_PAGE_SIZE - FLECS_PAGE_SLAB_HEADER),
+        ECS_INTERNAL_ERROR, NULL);
+
+    /* Blocks are never returned to the arena, they're owned by the block
+     * allocator until the arena is freed. */
+    if (!arena->slab || ((arena->used + size) > FLECS_HUGE_PAGE_SIZE)) {
+        bool os_page;
+        ecs_page_slab_t *slab = flecs_page_alloc(FLECS_HUGE_PAGE_SIZE, &os_page);
+        slab->next = arena->slab;
+        slab->os_page = os_page;
+        arena->slab = slab;
+        arena->used = FLECS_PAGE_SLAB_HEADER;
+    }
+
+    void *result = ECS_OFFSET(arena->slab, arena->used);
+    arena->used += ECS_ALIGN(size, 16);
+    return result;
+}
+
+void flecs_page_arena_fini(
+    ecs_page_arena_t *arena)
+{
+    ecs_page_slab_t *slab = arena->slab, *next;
+    for (; slab; slab = next) {
+        next = slab->next;
+        if (slab->os_page) {
+            ecs_os_page_free(slab, FLECS_HUGE_PAGE_SIZE);
+        } else {
+            ecs_os_free(slab);
+        }
+    }
+
+    arena->slab = NULL;
+    arena->used = 0;
+}
+
+/* Large allocations from an allocator with an arena are directly allocated as
+ * pages, which avoids fragmenting huge pages with large table columns. */
+#define flecs_balloc_is_page(ba)\
+    ((ba)->arena && ecs_os_api.page_alloc_ &&\
+        ((ba)->data_size >= FLECS_HUGE_PAGE_SIZE))
+
+#endif
+
 static
 ecs_block_allocator_chunk_header_t* flecs_balloc_block(
     ecs_block_allocator_t *allocator)
@@ -33,9 +109,17 @@ ecs_block_allocator_chunk_header_t* flecs_balloc_block(
         return NULL;
     }
 
-    ecs_block_allocator_block_t *block = 
-        ecs_os_malloc(ECS_SIZEOF(ecs_block_allocator_block_t) +
+    ecs_block_allocator_block_t *block;
+#ifdef FLECS_HUGE_PAGES
+    if (allocator->arena) {
+        block = flecs_page_arena_alloc(allocator->arena, 
+            ECS_SIZEOF(ecs_block_allocator_block_t) + allocator->block_size);
+    } else
+#endif
+    {
+        block = ecs_os_malloc(ECS_SIZEOF(ecs_block_allocator_block_t) +
             allocator->block_size);
+    }
     ecs_block_allocator_chunk_header_t *first_chunk = ECS_OFFSET(block, 
         ECS_SIZEOF(ecs_block_allocator_block_t));
 
@@ -84,6 +168,9 @@ void flecs_ballocator_init(
     ba->block_size = ba->chunks_per_block * ba->chunk_size;
     ba->head = NULL;
     ba->block_head = NULL;
+#ifdef FLECS_HUGE_PAGES
+    ba->arena = NULL;
+#endif
 #endif
 }
 
@@ -127,6 +214,58 @@ void flecs_ballocator_fini(
 #endif
 
     ecs_block_allocator_block_t *block;
+    for (block = ba->block_head; block;) {
+        ecs_block_allocator_block_t *next = block->next;
+#ifdef FLECS_HUGE_PAGES
+        /* Blocks from an arena are freed together with the arena */
+        if (!ba->arena)
+#endif
+        {
+            ecs_os_free(block);
+        }
+        ecs_os_linc(&ecs_block_allocator_free_count);
+        block = next;
+    }
+
+    ba->block_head = NULL;
+#endif
+}
+
+int64_t flecs_ballocator_reclaim(
+    ecs_block_allocator_t *ba)
+{
+    ecs_assert(ba != NULL, ECS_INTERNAL_ERROR, NULL);
+    (void)ba;
+
+#ifndef FLECS_USE_OS_ALLOC
+#ifdef FLECS_HUGE_PAGES
+    if (ba->arena) {
+        /* Blocks can only be returned by freeing the arena */
+        return 0;
+    }
+#endif
+
+    int32_t block_count = 0;
+    ecs_block_allocator_block_t *block;
+    for (block = ba->block_head; block; block = block->next) {
+        block_count ++;
+    }
+
+    if (!block_count) {
+        return 0;
+    }
+
+    /* Blocks can only be freed if all chunks are in the free list */
+    int32_t free_count = 0;
+    ecs_block_allocator_chunk_header_t *chunk;
+    for (chunk = ba->head; chunk; chunk = chunk->next) {
+        free_count ++;
+    }
+
+    if (free_count != (block_count * ba->chunks_per_block)) {
+        return 0;
+    }
+
     for (block = ba->block_head; block;) {
         ecs_block_allocator_block_t *next = block->next;
         ecs_os_free(block);
@@ -134,7 +273,13 @@ void flecs_ballocator_fini(
         block = next;
     }
 
+    ba->head = NULL;
     ba->block_head = NULL;
+
+    return (int64_t)block_count * 
+        (ba->block_size + ECS_SIZEOF(ecs_block_allocator_block_t));
+#else
+    return 0;
 #endif
 }
 
@@ -165,6 +310,16 @@ void* flecs_balloc_w_dbg_info(
 #else
 
     if (ba->chunks_per_block <= FLECS_MIN_CHUNKS_PER_BLOCK) {
+#ifdef FLECS_HUGE_PAGES
+        if (flecs_balloc_is_page(ba)) {
+            result = ecs_os_page_alloc(ba->data_size);
+            if (result) {
+                return result;
+            }
+            /* Don't fall back to malloc, as the chunk couldn't be freed */
+            ecs_abort(ECS_OUT_OF_MEMORY, NULL);
+        }
+#endif
         return ecs_os_malloc(ba->data_size);
     }
 
@@ -248,6 +403,12 @@ void flecs_bfree_w_dbg_info(
     }
 
     if (ba->chunks_per_block <= FLECS_MIN_CHUNKS_PER_BLOCK) {
+#ifdef FLECS_HUGE_PAGES
+        if (flecs_balloc_is_page(ba)) {
+            ecs_os_page_free(memory, ba->data_size);
+            return;
+        }
+#endif
         ecs_os_free(memory);
         return;
     }
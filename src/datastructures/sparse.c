@@ -625,6 +625,26 @@ bool flecs_sparse_has(
     return dense && (dense < sparse->count);
 }
 
+void flecs_sparse_prefetch(
+    const ecs_sparse_t *sparse,
+    uint64_t id)
+{
+    ecs_assert(sparse != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    uint64_t index = (uint32_t)id;
+    ecs_sparse_page_t *page = flecs_sparse_get_page(sparse, 
+        FLECS_SPARSE_PAGE(index));
+    if (!page || !page->sparse) {
+        return;
+    }
+
+    int32_t offset = FLECS_SPARSE_OFFSET(id);
+    flecs_prefetch(&page->sparse[offset]);
+    if (page->data) {
+        flecs_prefetch(DATA(page->data, sparse->size, offset));
+    }
+}
+
 int32_t flecs_sparse_count(
     const ecs_sparse_t *sparse)
 {
@@ -222,6 +222,16 @@ void flecs_move_entity(
     record->table = dst_table;
     record->row = ECS_ROW_TO_RECORD(dst_row, record->row & ECS_ROW_FLAGS_MASK);
 
+    if (dst_table->flags & EcsTableHasDenseToggle) {
+        if (emplace_id) {
+            /* Emplaced value isn't constructed yet, so it can't be swapped */
+            flecs_table_dense_toggle_invalidate(dst_table);
+        } else {
+            flecs_table_dense_toggle_sync(world, dst_table, dst_row);
+            dst_row = ECS_RECORD_TO_ROW(record->row);
+        }
+    }
+
     flecs_table_delete(world, src_table, src_row, false);
 
     flecs_actions_move_add(world, dst_table, src_table, dst_row, 1, diff,
@@ -296,6 +306,96 @@ void flecs_commit(
     return;
 }
 
+/* Range of new component values in a table that is initialized in parallel */
+typedef struct flecs_bulk_init_t {
+    ecs_table_t *table;
+    void **column_data;         /* Values per column, NULL to construct */
+    int32_t row;
+    int32_t count;
+    bool is_move;
+} flecs_bulk_init_t;
+
+/* Construct or initialize the part of the range that belongs to a thread */
+static
+void flecs_bulk_init_range(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    (void)world;
+    flecs_bulk_init_t *job = ctx;
+    ecs_table_t *table = job->table;
+    int32_t start = (int32_t)(
+        (int64_t)job->count * stage_index / stage_count);
+    int32_t end = (int32_t)(
+        (int64_t)job->count * (stage_index + 1) / stage_count);
+    int32_t count = end - start;
+    if (!count) {
+        return;
+    }
+
+    int32_t i, column_count = table->column_count;
+    for (i = 0; i < column_count; i ++) {
+        ecs_column_t *column = &table->data.columns[i];
+        const ecs_type_info_t *ti = column->ti;
+        void *ptr = ECS_ELEM(column->data, ti->size, job->row + start);
+
+        if (!job->column_data) {
+            flecs_type_info_ctor(ptr, count, ti);
+            continue;
+        }
+
+        void *src_ptr = job->column_data[i];
+        if (!src_ptr) {
+            continue;
+        }
+
+        src_ptr = ECS_ELEM(src_ptr, ti->size, start);
+        if (job->is_move) {
+            flecs_type_info_move(ptr, src_ptr, count, ti);
+        } else {
+            flecs_type_info_copy(ptr, src_ptr, count, ti);
+        }
+    }
+}
+
+/* Run bulk initialization job on worker threads, or on the calling thread if 
+ * the world has no worker threads. */
+static
+void flecs_bulk_init_run(
+    ecs_world_t *world,
+    flecs_bulk_init_t *job)
+{
+#ifdef FLECS_PIPELINE
+    if (flecs_workers_run(world, flecs_bulk_init_range, job)) {
+        return;
+    }
+#endif
+    flecs_bulk_init_range(world, 0, 1, job);
+}
+
+/* Test if the component values of a bulk operation should be initialized by
+ * worker threads. Tables with inherited components are excluded, as their
+ * values are constructed from the base component. */
+static
+bool flecs_bulk_init_parallel(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t count)
+{
+    if (!table->column_count || (table->flags & EcsTableHasIsA)) {
+        return false;
+    }
+
+    int32_t stage_count = ecs_get_stage_count(world);
+    if (stage_count <= 1) {
+        return false;
+    }
+
+    return (count / stage_count) >= FLECS_BULK_PARALLEL_MIN_COUNT;
+}
+
 const ecs_entity_t* flecs_bulk_new(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -304,6 +404,7 @@ const ecs_entity_t* flecs_bulk_new(
     int32_t count,
     void **component_data,
     bool is_move,
+    bool parallel,
     int32_t *row_out,
     ecs_table_diff_t *diff)
 {
@@ -317,7 +418,25 @@ const ecs_entity_t* flecs_bulk_new(
 
     flecs_defer_begin(world, world->stages[0]);
 
-    int32_t row = flecs_table_appendn(world, table, count, entities);
+    if (parallel) {
+        parallel = flecs_bulk_init_parallel(world, table, count);
+    }
+
+    int32_t row = flecs_table_appendn(world, table, count, entities, !parallel);
+
+    flecs_bulk_init_t job = {
+        .table = table,
+        .row = row,
+        .count = count,
+        .is_move = is_move
+    };
+
+    if (parallel) {
+        /* Construct values on worker threads, then invoke OnAdd hooks for the
+         * entire batch on this thread. */
+        flecs_bulk_init_run(world, &job);
+        flecs_table_invoke_on_add(world, table, row, count);
+    }
 
     ecs_type_t type = table->type;
     if (!type.count && !component_data) {
@@ -336,6 +455,11 @@ const ecs_entity_t* flecs_bulk_new(
         (component_data == NULL) ? 0 : EcsEventNoOnSet, true, 0, true);
 
     if (component_data) {
+        if (parallel) {
+            job.column_data = flecs_wcalloc_n(
+                world, void*, table->column_count);
+        }
+
         int32_t c_i;
         for (c_i = 0; c_i < component_ids->count; c_i ++) {
             void *src_ptr = component_data[c_i];
@@ -391,6 +515,13 @@ const ecs_entity_t* flecs_bulk_new(
                 int32_t index = tr->column;
                 ecs_column_t *column = &table->data.columns[index];
                 ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+
+                if (parallel) {
+                    /* Value is copied by worker threads */
+                    job.column_data[index] = src_ptr;
+                    continue;
+                }
+
                 ptr = ECS_ELEM(column->data, size, row);
 
                 if (is_move) {
@@ -401,6 +532,11 @@ const ecs_entity_t* flecs_bulk_new(
             }
         };
 
+        if (parallel) {
+            flecs_bulk_init_run(world, &job);
+            flecs_wfree_n(world, void*, table->column_count, job.column_data);
+        }
+
         int32_t j, storage_count = table->column_count;
         for (j = 0; j < storage_count; j ++) {
             ecs_id_t component = flecs_column_id(table, j);
@@ -502,12 +638,12 @@ void flecs_add_ids(
     flecs_table_diff_builder_init(world, &diff);
 
     ecs_table_t *table = ecs_get_table(world, entity);
-    int32_t i;
-    for (i = 0; i < count; i ++) {
-        ecs_id_t component = ids[i];
-        table = flecs_find_table_add(world, table, component, &diff);
+    if (!table) {
+        table = &world->store.root;
     }
 
+    table = flecs_find_table_add_ids(world, table, ids, count, &diff);
+
     ecs_table_diff_t table_diff;
     flecs_table_diff_build_noalloc(&diff, &table_diff);
     flecs_commit(world, entity, r, table, &table_diff, 0, 0);
@@ -595,10 +731,14 @@ flecs_component_ptr_t flecs_get_mut(
 
     flecs_component_ptr_t result;
 
+    if (!r->table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return (flecs_component_ptr_t){0};
+    }
+
     if (id < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[id]) {
             ecs_table_t *table = r->table;
-            ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
             ecs_assert(table->component_map != NULL, ECS_INTERNAL_ERROR, NULL);
             int16_t column_index = table->component_map[id];
             if (column_index > 0) {
@@ -709,6 +849,26 @@ const char* flecs_entity_invalid_reason(
             flecs_errstr_1(ecs_get_path(world, entity)), \
             flecs_id_invalid_reason(world, component))
 
+/* SoA components don't have a column, their data is stored in the columns of
+ * the member components. */
+#define flecs_assert_component_not_soa(world, component, function)\
+    ecs_check(!(flecs_component_get_flags(ecs_get_world(world), component) \
+        & EcsIdSoA), \
+        ECS_INVALID_OPERATION, \
+        "cannot call %s() for SoA component '%s' (use its members instead)", \
+            function, \
+            flecs_errstr(ecs_id_str(world, component)))
+
+void flecs_mark_dirty_if_forked(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_id_t component)
+{
+    if (world->fork_count) {
+        flecs_table_mark_dirty(world, table, component);
+    }
+}
+
 
 /* -- Public functions -- */
 
@@ -758,7 +918,12 @@ ecs_entity_t ecs_new(
 {
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    flecs_stage_from_world(&world);
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    if (world->flags & EcsWorldMultiThreaded) {
+        /* Entity is added to the root table when the stage is merged */
+        return flecs_stage_new_id(world, stage);
+    }
+
     ecs_entity_t e = flecs_new_id(world);
     flecs_add_to_root_table(world, e);
     return e;
@@ -837,8 +1002,8 @@ ecs_entity_t ecs_new_w_id(
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
     if (flecs_defer_cmd(stage)) {
-        ecs_entity_t e = ecs_new(world);
-        ecs_add_id(world, e, component);
+        ecs_entity_t e = ecs_new((ecs_world_t*)stage);
+        ecs_add_id((ecs_world_t*)stage, e, component);
         return e;
     }
 
@@ -1022,12 +1187,12 @@ int flecs_traverse_add(
 
     /* Add components from the 'add' array */
     if (desc->add) {
-        int32_t i = 0;
-        ecs_id_t component;
-
-        while ((component = desc->add[i ++])) {
-            table = flecs_find_table_add(world, table, component, &diff);
+        int32_t count = 0;
+        while (desc->add[count]) {
+            count ++;
         }
+
+        table = flecs_find_table_add_ids(world, table, desc->add, count, &diff);
     }
 
     /* Add components from the 'set' array */
@@ -1434,19 +1599,19 @@ const ecs_entity_t* ecs_bulk_init(
         flecs_table_diff_builder_init(world, &diff);
 
         int32_t i = 0;
-        ecs_id_t component;
-        while ((component = desc->ids[i])) {
-            table = flecs_find_table_add(world, table, component, &diff);
+        while (desc->ids[i]) {
             i ++;
         }
 
+        table = flecs_find_table_add_ids(world, table, desc->ids, i, &diff);
+
         ids.array = ECS_CONST_CAST(ecs_id_t*, desc->ids);
         ids.count = i;
 
         ecs_table_diff_t table_diff;
         flecs_table_diff_build_noalloc(&diff, &table_diff);
-        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, NULL, 
-            &table_diff);
+        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, 
+            desc->parallel, NULL, &table_diff);
         flecs_table_diff_builder_fini(world, &diff);
     } else {
         ecs_table_diff_t diff = {
@@ -1462,8 +1627,8 @@ const ecs_entity_t* ecs_bulk_init(
         ids.array = ECS_CONST_CAST(ecs_id_t*, desc->ids);
         ids.count = i;
 
-        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, NULL, 
-            &diff);
+        flecs_bulk_new(world, table, entities, &ids, count, desc->data, true, 
+            desc->parallel, NULL, &diff);
     }
 
     if (!sparse_count) {
@@ -1500,7 +1665,8 @@ const ecs_entity_t* ecs_bulk_new_w_id(
 
     ecs_table_diff_t td;
     flecs_table_diff_build_noalloc(&diff, &td);
-    ids = flecs_bulk_new(world, table, NULL, NULL, count, NULL, false, NULL, &td);
+    ids = flecs_bulk_new(
+        world, table, NULL, NULL, count, NULL, false, false, NULL, &td);
     flecs_table_diff_builder_fini(world, &diff);
     flecs_defer_end(world, stage);
 
@@ -1901,7 +2067,10 @@ const void* ecs_get_id(
     ecs_assert(r != NULL, ECS_INVALID_PARAMETER, NULL);
 
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return NULL;
+    }
 
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
@@ -1915,6 +2084,8 @@ const void* ecs_get_id(
         return NULL;
     }
 
+    flecs_assert_component_not_soa(world, component, "get");
+
     if (cr->flags & EcsIdDontFragment) {
         void *ptr = flecs_component_sparse_get(world, cr, table, entity);
         if (ptr) {
@@ -1940,6 +2111,111 @@ error:
     return NULL;
 }
 
+/* Number of entities for which records are fetched ahead in ecs_get_many_id */
+#define FLECS_GET_MANY_PREFETCH (8)
+
+void ecs_get_many_id(
+    const ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t component,
+    const void **ptrs_out)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(count >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || entities != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || ptrs_out != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_id_is_valid(world, component) || ecs_id_is_wildcard(component), 
+        ECS_INVALID_PARAMETER, NULL);
+
+    world = ecs_get_world(world);
+
+    int32_t i;
+    ecs_component_record_t *cr = NULL;
+    if (component >= FLECS_HI_COMPONENT_ID || 
+        world->non_trivial_lookup[component]) 
+    {
+        cr = flecs_components_get(world, component);
+        if (!cr) {
+            ecs_os_memset_n(ptrs_out, 0, void*, count);
+            return;
+        }
+
+        if (cr->flags & (EcsIdDontFragment|EcsIdSparse)) {
+            /* Components not stored in table columns */
+            for (i = 0; i < count; i ++) {
+                ptrs_out[i] = ecs_get_id(world, entities[i], component);
+            }
+            return;
+        }
+    }
+
+    /* Looking up a component is a chain of dependent loads (entity index page, 
+     * record, table column), which for entities that are scattered across 
+     * tables are likely all cache misses. Fetch records ahead of the entity 
+     * that is being resolved, and prefetch the component value so it is (more 
+     * likely) cached when the application reads it. */
+    for (i = 0; i < count && i < FLECS_GET_MANY_PREFETCH; i ++) {
+        flecs_entities_prefetch(world, entities[i]);
+    }
+
+    ecs_table_t *last_table = NULL;
+    const ecs_table_record_t *tr = NULL;
+
+    for (i = 0; i < count; i ++) {
+        if ((i + FLECS_GET_MANY_PREFETCH) < count) {
+            flecs_entities_prefetch(world, 
+                entities[i + FLECS_GET_MANY_PREFETCH]);
+        }
+
+        ecs_entity_t e = entities[i];
+        flecs_assert_entity_valid(world, e, "get_many");
+        ecs_record_t *r = flecs_entities_get(world, e);
+        ecs_assert(r != NULL, ECS_INVALID_PARAMETER, NULL);
+
+        ecs_table_t *table = r->table;
+        int32_t row = ECS_RECORD_TO_ROW(r->row);
+        void *ptr = NULL;
+
+        if (!table) {
+            ptrs_out[i] = NULL;
+            continue;
+        }
+
+        if (!cr) {
+            int16_t column_index = table->component_map[component];
+            if (column_index > 0) {
+                ecs_column_t *column = &table->data.columns[column_index - 1];
+                ptr = ECS_ELEM(column->data, column->ti->size, row);
+            }
+        } else {
+            /* Entities are often stored in a small number of tables, so only
+             * look up the table record when the table changes. */
+            if (table != last_table) {
+                tr = flecs_component_get_table(cr, table);
+                last_table = table;
+                ecs_check(!tr || tr->column != -1, ECS_INVALID_PARAMETER,
+                    "component '%s' passed to get_many() is a tag/zero sized",
+                        flecs_errstr(ecs_id_str(world, component)));
+            }
+
+            if (tr) {
+                ptr = flecs_table_get_component(table, tr->column, row).ptr;
+            } else {
+                ptr = flecs_get_base_component(world, table, component, cr, 0);
+            }
+        }
+
+        if (ptr) {
+            flecs_prefetch(ptr);
+        }
+
+        ptrs_out[i] = ptr;
+    }
+error:
+    return;
+}
+
 #ifdef FLECS_DEBUG
 static
 bool flecs_component_has_on_replace(
@@ -1965,6 +2241,7 @@ void* ecs_get_mut_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "get_mut");
     flecs_assert_component_valid(world, entity, component, "get_mut");
+    flecs_assert_component_not_soa(world, component, "get_mut");
     ecs_dbg_assert(!flecs_component_has_on_replace(world, component, "get_mut"), 
         ECS_INVALID_PARAMETER,
         "cannot call get_mut() for component '%s' which has an on_replace hook "
@@ -1978,6 +2255,13 @@ void* ecs_get_mut_id(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INVALID_PARAMETER, NULL);
 
+    if (!r->table) {
+        return NULL;
+    }
+
+    flecs_mark_dirty_if_forked(
+        ECS_CONST_CAST(ecs_world_t*, world), r->table, component);
+
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
             ecs_get_low_id(r->table, r, component);
@@ -2036,6 +2320,7 @@ void* ecs_ensure_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "ensure");
     flecs_assert_component_valid(world, entity, component, "ensure");
+    flecs_assert_component_not_soa(world, component, "ensure");
     ecs_dbg_assert(!flecs_component_has_on_replace(world, component, "ensure"),
         ECS_INVALID_PARAMETER,
         "cannot call ensure() for component '%s' which has an on_replace hook "
@@ -2058,6 +2343,7 @@ void* ecs_ensure_id(
             flecs_errstr(ecs_id_str(world, component)),
             flecs_errstr_2(ecs_get_path(world, entity)));
 
+    flecs_mark_dirty_if_forked(world, r->table, component);
     flecs_defer_end(world, stage);
     return result;
 error:
@@ -2074,6 +2360,7 @@ void* ecs_emplace_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "emplace");
     flecs_assert_component_valid(world, entity, component, "emplace");
+    flecs_assert_component_not_soa(world, component, "emplace");
     ecs_dbg_assert(!flecs_component_has_on_replace(world, component, "emplace"),
         ECS_INVALID_PARAMETER,
         "cannot call emplace() for component '%s' which has an on_replace hook "
@@ -2129,6 +2416,7 @@ void* ecs_emplace_id(
         *is_new = table != r->table;
     }
 
+    flecs_mark_dirty_if_forked(world, r->table, component);
     return ptr;
 error:
     return NULL;
@@ -2261,6 +2549,7 @@ void flecs_modified_id_if(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "modified");
     flecs_assert_component_valid(world, entity, component, "modified");
+    flecs_assert_component_not_soa(world, component, "modified");
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
@@ -2300,6 +2589,7 @@ void ecs_modified_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "modified");
     flecs_assert_component_valid(world, entity, component, "modified");
+    flecs_assert_component_not_soa(world, component, "modified");
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
@@ -2398,6 +2688,7 @@ void ecs_set_id(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     flecs_assert_entity_valid(world, entity, "set");
     flecs_assert_component_valid(world, entity, component, "set");
+    flecs_assert_component_not_soa(world, component, "set");
     ecs_check(size != 0, ECS_INVALID_PARAMETER, NULL);
     ecs_check(ptr != NULL, ECS_INVALID_PARAMETER, 
         "invalid call to set() for component '%s' and entity '%s': no "
@@ -2487,6 +2778,10 @@ void ecs_enable_id(
 
     flecs_bitset_set(bs, ECS_RECORD_TO_ROW(r->row), enable);
 
+    if (table->flags & EcsTableHasDenseToggle) {
+        flecs_table_dense_toggle_sync(world, table, ECS_RECORD_TO_ROW(r->row));
+    }
+
     flecs_defer_end(world, stage);
 error:
     return;
@@ -2507,7 +2802,9 @@ bool ecs_is_enabled_id(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        return false;
+    }
 
     ecs_bitset_t *bs = flecs_table_get_toggle(table, component);
     if (!bs) {
@@ -2595,7 +2892,10 @@ bool ecs_has_id(
     ecs_record_t *r = flecs_entities_get_any(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return false;
+    }
 
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
@@ -2673,7 +2973,10 @@ bool ecs_owns_id(
     ecs_record_t *r = flecs_entities_get_any(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        /* Entity was created in multithreaded mode and is not merged yet */
+        return false;
+    }
 
     if (component < FLECS_HI_COMPONENT_ID) {
         if (!world->non_trivial_lookup[component]) {
@@ -2800,7 +3103,9 @@ ecs_entity_t ecs_get_target(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        return 0;
+    }
 
     ecs_id_t wc = ecs_pair(rel, EcsWildcard);
     ecs_component_record_t *cr = flecs_components_get(world, wc);
@@ -2887,7 +3192,9 @@ ecs_entity_t ecs_get_parent(
     ecs_record_t *r = flecs_entities_get(world, entity);
     ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_table_t *table = r->table;
-    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (!table) {
+        return 0;
+    }
 
     if (table->flags & EcsTableHasParent) {
         int32_t column = table->component_map[ecs_id(EcsParent)];
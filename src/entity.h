@@ -34,6 +34,13 @@ flecs_component_ptr_t flecs_get_mut(
     ecs_record_t *r,
     ecs_size_t size);
 
+/* Mark component returned by ensure/get_mut as changed if the world has 
+ * forks, as the value can be written without calling modified. */
+void flecs_mark_dirty_if_forked(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_id_t component);
+
 /* Get component pointer. */
 void* flecs_get_component(
     const ecs_world_t *world,
@@ -54,6 +61,7 @@ const ecs_entity_t* flecs_bulk_new(
     int32_t count,
     void **c_info,
     bool move,
+    bool parallel,
     int32_t *row_out,
     ecs_table_diff_t *diff);
 
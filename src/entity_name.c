@@ -27,8 +27,7 @@ bool flecs_path_append(
     if (child && ecs_is_alive(world, child)) {
         ecs_record_t *r = flecs_entities_get(world, child);
         ecs_assert(r != NULL, ECS_INVALID_OPERATION, NULL);
-        ecs_assert(r->table != NULL, ECS_INTERNAL_ERROR, NULL);
-        bool hasName = r->table->flags & EcsTableHasName;
+        bool hasName = r->table && (r->table->flags & EcsTableHasName);
 
         if (hasName) {
             cur = ecs_get_target(world, child, EcsChildOf, 0);
@@ -379,7 +379,8 @@ void flecs_instantiate_children(
     int32_t child_row;
     diff.added_flags |= EcsTableEdgeReparent;
     const ecs_entity_t *i_children = flecs_bulk_new(world, i_table, child_ids,
-        &diff.added, child_range.count, component_data, false, &child_row, &diff);
+        &diff.added, child_range.count, component_data, false, false, &child_row,
+        &diff);
 
     flecs_instantiate_sparse(
         world, &child_range, children, i_table, i_children, child_row, false);
@@ -977,6 +977,22 @@ error:
     return false;
 }
 
+/* Forward results of a chained iterator that was split up per worker. */
+static
+bool flecs_worker_split_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    if (!ecs_iter_next(chain_it)) {
+        return false;
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    return true;
+}
+
 ecs_iter_t ecs_worker_iter(
     const ecs_iter_t *it,
     int32_t index,
@@ -1000,6 +1016,13 @@ ecs_iter_t ecs_worker_iter(
     result.fini = ecs_chained_iter_fini;
     result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
 
+    /* Iterators for sparse components and partitioned queries can be split up
+     * by the chained iterator, so that each worker only iterates its own 
+     * elements. */
+    result.priv_.iter.worker.split = flecs_query_trivial_sparse_split(
+        result.chain_it, index, count, NULL, 0) ||
+            flecs_query_partition_init(result.chain_it, index, count, NULL);
+
     return result;
 error:
     return (ecs_iter_t){ 0 };
@@ -1017,6 +1040,10 @@ bool ecs_worker_next(
     int32_t res_count = iter->count, res_index = iter->index;
     int32_t per_worker, first;
 
+    if (iter->split) {
+        return flecs_worker_split_next(it);
+    }
+
     do {
         if (!ecs_iter_next(chain_it)) {
             return false;
@@ -1065,3 +1092,148 @@ bool ecs_worker_next(
 error:
     return false;
 }
+
+ecs_iter_t ecs_dynamic_worker_iter(
+    const ecs_iter_t *it,
+    int32_t *cursor,
+    int32_t chunk_size)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(cursor != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunk_size > 0, ECS_INVALID_PARAMETER,
+        "invalid chunk size %d", chunk_size);
+
+    ecs_iter_t result = *it;
+    result.priv_.stack_cursor = NULL; /* Don't copy allocator cursor */
+
+    result.priv_.iter.worker = (ecs_worker_iter_t){
+        .cursor = cursor,
+        .chunk_size = chunk_size
+    };
+    result.next = ecs_dynamic_worker_next;
+    result.fini = ecs_chained_iter_fini;
+    result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
+    result.priv_.iter.worker.split = flecs_query_trivial_sparse_split(
+        result.chain_it, 0, 1, cursor, chunk_size) ||
+            flecs_query_partition_init(result.chain_it, 0, 1, cursor);
+
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+/* Forward results of a chained iterator that was split up per worker, in 
+ * chunks of at most chunk_size entities. */
+static
+bool flecs_dynamic_worker_split_next(
+    ecs_iter_t *it)
+{
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t first = iter->chunk;
+
+    /* A nonzero offset means that the current result has chunks left */
+    if (!first && !ecs_iter_next(chain_it)) {
+        return false;
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    int32_t count = it->count - first;
+    if (count > iter->chunk_size) {
+        count = iter->chunk_size;
+        iter->chunk = first + count;
+    } else {
+        iter->chunk = 0;
+    }
+
+    if (first) {
+        it->frame_offset += first;
+        it->count = count;
+        it->offset += first;
+
+        if (it->table) {
+            it->entities = &(ecs_table_entities(it->table)[it->offset]);
+        } else {
+            it->entities = &it->entities[first];
+        }
+    } else {
+        it->count = count;
+    }
+
+    return true;
+}
+
+static
+int32_t flecs_dynamic_worker_chunk_count(
+    const ecs_iter_t *it,
+    int32_t chunk_size)
+{
+    if (!it->count) {
+        /* Results without a table are passed to a single worker */
+        return it->table == NULL;
+    }
+
+    return (it->count + chunk_size - 1) / chunk_size;
+}
+
+bool ecs_dynamic_worker_next(
+    ecs_iter_t *it)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_dynamic_worker_next, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_iter_t *iter = &it->priv_.iter.worker;
+    int32_t chunk_size = iter->chunk_size;
+
+    if (iter->split) {
+        return flecs_dynamic_worker_split_next(it);
+    }
+
+    /* Claim the next chunk. All workers walk the results of the chained
+     * iterator in the same order, so a chunk index refers to the same entities
+     * for each worker. The iterator keeps track of the index of the first
+     * chunk after the current result of the chained iterator. */
+    int32_t claimed = ecs_os_ainc(iter->cursor) - 1;
+    while (claimed >= iter->chunk) {
+        if (!ecs_iter_next(chain_it)) {
+            return false;
+        }
+
+        iter->chunk += flecs_dynamic_worker_chunk_count(chain_it, chunk_size);
+    }
+
+    int32_t chunk_count = flecs_dynamic_worker_chunk_count(
+        chain_it, chunk_size);
+    int32_t first = (claimed - (iter->chunk - chunk_count)) * chunk_size;
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv_));
+
+    if (!it->count) {
+        return true;
+    }
+
+    int32_t count = it->count - first;
+    if (count > chunk_size) {
+        count = chunk_size;
+    }
+
+    it->frame_offset += first;
+    it->count = count;
+    it->offset += first;
+
+    if (it->table) {
+        it->entities = &(ecs_table_entities(it->table)[it->offset]);
+    } else {
+        it->entities = &it->entities[first];
+    }
+
+    return true;
+error:
+    return false;
+}
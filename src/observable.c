@@ -450,7 +450,9 @@ void flecs_emit_propagate_invalidate_tables(
     ecs_component_record_t *cur = tgt_cr;
     while ((cur = flecs_component_trav_next(cur))) {
         ecs_reachable_cache_t *rc = &cur->pair->reachable;
-        if (rc->current != rc->generation) {
+        if (rc->current != rc->generation && 
+            rc->up_current != rc->generation) 
+        {
             /* Subtree is already marked invalid */
             continue;
         }
@@ -35,6 +35,9 @@ typedef struct ecs_observer_impl_t {
     ecs_query_t *not_query;     /**< Query used to populate observer data when a
                                      term with a not operator triggers. */
 
+    ecs_map_t coalesced;        /**< Events stored by coalesced observer, 
+                                     map<entity, event flags> */
+
     /* Mixins */
     flecs_poly_dtor_t dtor;
 } ecs_observer_impl_t;
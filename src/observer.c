@@ -415,6 +415,44 @@ void flecs_observer_invoke(
     }
 }
 
+/* Events received by a coalesced observer for an entity */
+#define FLECS_COALESCE_ADD    (1u << 0) /* Received OnAdd */
+#define FLECS_COALESCE_REMOVE (1u << 1) /* Received OnRemove */
+#define FLECS_COALESCE_SET    (1u << 2) /* Received OnSet */
+#define FLECS_COALESCE_NEW    (1u << 3) /* First received event was OnAdd */
+
+/* Store event for coalesced observer, to be delivered by ecs_observer_flush */
+static
+void flecs_observer_coalesce(
+    ecs_world_t *world,
+    ecs_observer_t *o,
+    ecs_entity_t event,
+    const ecs_entity_t *entities,
+    int32_t count)
+{
+    ecs_observer_impl_t *impl = flecs_observer_impl(o);
+    ecs_flags32_t flag;
+    if (event == EcsOnAdd) {
+        flag = FLECS_COALESCE_ADD;
+    } else if (event == EcsOnRemove) {
+        flag = FLECS_COALESCE_REMOVE;
+    } else {
+        ecs_assert(event == EcsOnSet, ECS_INTERNAL_ERROR, NULL);
+        flag = FLECS_COALESCE_SET;
+    }
+
+    ecs_map_init_if(&impl->coalesced, &world->allocator);
+
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_map_val_t *events = ecs_map_ensure(&impl->coalesced, entities[i]);
+        if (!events[0] && (flag == FLECS_COALESCE_ADD)) {
+            events[0] = FLECS_COALESCE_NEW;
+        }
+        events[0] |= flag;
+    }
+}
+
 static
 void flecs_uni_observer_invoke(
     ecs_world_t *world,
@@ -472,7 +510,11 @@ void flecs_uni_observer_invoke(
 
         bool match_this = query->flags & EcsQueryMatchThis;
 
-        if (match_this) {
+        if (impl->flags & EcsObserverCoalesce) {
+            ecs_assert(match_this, ECS_INTERNAL_ERROR, NULL);
+            flecs_observer_coalesce(world, o, it->event, it->entities, 
+                it->count);
+        } else if (match_this) {
             /* Invoke observer for $this field */
             flecs_observer_invoke(o, it);
             ecs_os_inc(&query->eval_count);
@@ -661,6 +703,14 @@ void flecs_multi_observer_invoke(
         impl->last_event_id[0] = it->event_cur;
         impl->last_event_field = pivot_field_bit;
 
+        if (impl->flags & EcsObserverCoalesce) {
+            flecs_observer_coalesce(world, o, it->event, it->entities, 
+                it->count);
+            user_it.flags |= EcsIterSkip; /* Prevent change detection on fini */
+            ecs_iter_fini(&user_it);
+            goto done;
+        }
+
         /* Patch data from original iterator. If the observer query has
          * wildcards which triggered the original event, the component id that
          * got matched by ecs_query_has_range may not be the same as the one
@@ -931,6 +981,9 @@ int flecs_multi_observer_init(
     child_desc.run_ctx = NULL;
     child_desc.run_ctx_free = NULL;
     child_desc.yield_existing = false;
+    child_desc.coalesce = false;
+    child_desc.coalesce_phase = 0;
+    child_desc.multi_threaded = false;
     child_desc.flags_ &= ~(EcsObserverYieldOnCreate|EcsObserverYieldOnDelete);
     ecs_os_zeromem(&child_desc.entity);
     ecs_os_zeromem(&child_desc.query.terms);
@@ -1223,7 +1276,8 @@ ecs_observer_t* flecs_observer_init(
         .ids = ids
     };
 
-    if (desc->events[0] != EcsMonitor) {
+    /* Coalesced observers use the query to get the data for flushed events */
+    if (desc->events[0] != EcsMonitor && !desc->coalesce) {
         bool simple = false;
 #ifndef FLECS_SANITIZE
         simple = flecs_query_finalize_simple(
@@ -1352,6 +1406,25 @@ ecs_observer_t* flecs_observer_init(
     ecs_check(o->event_count != 0, ECS_INVALID_PARAMETER,
         "observer must have at least one event");
 
+    if (desc->coalesce) {
+        ecs_check(!(impl->flags & EcsObserverIsMonitor), ECS_INVALID_PARAMETER,
+            "monitor observers cannot be coalesced");
+        ecs_check(query->flags & EcsQueryMatchOnlyThis, ECS_UNSUPPORTED,
+            "coalesced observers can only match $this");
+        for (i = 0; i < o->event_count; i ++) {
+            ecs_entity_t event = o->events[i];
+            ecs_check(event == EcsOnAdd || event == EcsOnRemove || 
+                event == EcsOnSet, ECS_UNSUPPORTED,
+                    "coalesced observers only support OnAdd, OnRemove and "
+                    "OnSet events");
+        }
+
+        impl->flags |= EcsObserverCoalesce;
+        if (desc->multi_threaded) {
+            impl->flags |= EcsObserverMultiThreaded;
+        }
+    }
+
     bool multi = false;
 
     if (query->term_count == 1 && !desc->last_event_id) {
@@ -1387,6 +1460,431 @@ error:
     return NULL;
 }
 
+/* Entity stored by a coalesced observer, ordered by table and row on flush */
+typedef struct ecs_coalesced_elem_t {
+    ecs_table_t *table;
+    int32_t row;
+    ecs_flags32_t events;
+    bool matched;
+    ecs_entity_t entity;
+} ecs_coalesced_elem_t;
+
+static
+int flecs_coalesced_elem_cmp(
+    const void *ptr_a,
+    const void *ptr_b)
+{
+    const ecs_coalesced_elem_t *a = ptr_a;
+    const ecs_coalesced_elem_t *b = ptr_b;
+
+    if (a->table != b->table) {
+        /* Deleted entities are ordered first */
+        if (!a->table) {
+            return -1;
+        }
+        if (!b->table) {
+            return 1;
+        }
+        return (a->table->id > b->table->id) - (a->table->id < b->table->id);
+    }
+
+    return (a->row > b->row) - (a->row < b->row);
+}
+
+/* An entity that was removed and added again is delivered as OnSet if the
+ * observer observes OnSet, and as OnRemove followed by OnAdd otherwise. */
+static
+bool flecs_observer_coalesce_delivers(
+    ecs_flags32_t events,
+    ecs_flags32_t observed,
+    ecs_entity_t event,
+    bool matched)
+{
+    bool readded = (events & FLECS_COALESCE_REMOVE) && 
+        !(events & FLECS_COALESCE_NEW);
+    if (event == EcsOnAdd) {
+        return (events & FLECS_COALESCE_NEW) || (readded && 
+            (events & FLECS_COALESCE_ADD) && !(observed & FLECS_COALESCE_SET));
+    } else if (event == EcsOnSet) {
+        return (observed & FLECS_COALESCE_SET) && 
+            ((events & FLECS_COALESCE_SET) || readded);
+    } else {
+        return readded && (!matched || !(observed & FLECS_COALESCE_SET));
+    }
+}
+
+static
+void flecs_observer_coalesce_invoke(
+    ecs_observer_t *o,
+    ecs_iter_t *it,
+    ecs_entity_t event)
+{
+    it->event = event;
+    it->event_id = it->ids[0];
+    if (o->world->flags & EcsWorldMultiThreaded) {
+        it->event_cur = ecs_os_ainc(&o->world->event_id);
+    } else {
+        it->event_cur = ++ o->world->event_id;
+    }
+    it->system = o->entity;
+    it->ctx = o->ctx;
+    it->callback_ctx = o->callback_ctx;
+    it->run_ctx = o->run_ctx;
+    it->callback = o->callback;
+
+    if (o->run) {
+        ecs_iter_next_action_t next = it->next;
+        it->next = flecs_default_next_callback;
+        it->interrupted_by = 0;
+        o->run(it);
+        it->next = next;
+        it->interrupted_by = 0;
+    } else {
+        it->callback(it);
+    }
+}
+
+/* Deliver OnAdd and OnSet events for the entities of a query result */
+static
+int32_t flecs_observer_flush_result(
+    ecs_observer_t *o,
+    ecs_iter_t *it,
+    ecs_coalesced_elem_t *elems,
+    ecs_flags32_t observed)
+{
+    const ecs_entity_t events[] = { EcsOnAdd, EcsOnSet };
+    int32_t delivered = 0, i, count = it->count;
+
+    for (i = 0; i < count; i ++) {
+        elems[i].matched = true;
+    }
+
+    int32_t e;
+    for (e = 0; e < 2; e ++) {
+        ecs_entity_t event = events[e];
+
+        /* Invoke observer for each run of adjacent entities with the event */
+        i = 0;
+        while (i < count) {
+            if (!flecs_observer_coalesce_delivers(
+                elems[i].events, observed, event, true)) 
+            {
+                i ++;
+                continue;
+            }
+
+            int32_t start = i;
+            while (i < count && flecs_observer_coalesce_delivers(
+                elems[i].events, observed, event, true)) 
+            {
+                i ++;
+            }
+
+            ecs_iter_t user_it = *it;
+            user_it.offset = it->offset + start;
+            user_it.count = i - start;
+            user_it.entities = &it->entities[start];
+            flecs_observer_coalesce_invoke(o, &user_it, event);
+            delivered += user_it.count;
+        }
+    }
+
+    return delivered;
+}
+
+/* Deliver OnRemove events for the coalesced entities of a single table */
+static
+int32_t flecs_observer_flush_removed(
+    ecs_world_t *world,
+    ecs_observer_t *o,
+    ecs_table_t *table,
+    ecs_coalesced_elem_t *elems,
+    int32_t count,
+    ecs_flags32_t observed)
+{
+    int32_t i, delivered = 0;
+    ecs_allocator_t *a = flecs_stage_get_allocator(world);
+    ecs_vec_t removed;
+    ecs_vec_init_t(a, &removed, ecs_entity_t, 0);
+
+    for (i = 0; i < count; i ++) {
+        if (flecs_observer_coalesce_delivers(
+            elems[i].events, observed, EcsOnRemove, elems[i].matched)) 
+        {
+            ecs_vec_append_t(a, &removed, ecs_entity_t)[0] = elems[i].entity;
+        }
+    }
+
+    int32_t removed_count = ecs_vec_count(&removed);
+    if (removed_count) {
+        ecs_query_t *q = o->query;
+        ecs_iter_t it = ecs_query_iter(world, q);
+        it.table = table;
+        it.offset = 0;
+        it.count = removed_count;
+        it.entities = ecs_vec_first(&removed);
+        it.flags |= EcsIterIsValid | EcsIterSkip;
+        it.set_fields = 0;
+
+        /* Component values are no longer available */
+        int8_t f;
+        for (f = 0; f < q->field_count; f ++) {
+            it.ids[f] = q->ids[f];
+            ECS_CONST_CAST(int16_t*, it.columns)[f] = -1;
+        }
+
+        flecs_observer_coalesce_invoke(o, &it, EcsOnRemove);
+        ecs_iter_fini(&it);
+        delivered += removed_count;
+    }
+
+    ecs_vec_fini_t(a, &removed, ecs_entity_t);
+
+    return delivered;
+}
+
+/* Deliver events for the coalesced entities of a single table */
+static
+int32_t flecs_observer_flush_table(
+    ecs_world_t *world,
+    ecs_observer_t *o,
+    ecs_table_t *table,
+    ecs_coalesced_elem_t *elems,
+    int32_t count,
+    ecs_flags32_t observed)
+{
+    int32_t delivered = 0, i = 0;
+
+    /* Entities that were removed and added again get OnRemove before OnAdd */
+    if (!(observed & FLECS_COALESCE_SET)) {
+        delivered += flecs_observer_flush_removed(
+            world, o, table, elems, count, observed);
+    }
+
+    while (table && (i < count)) {
+        /* Find run of adjacent rows */
+        int32_t start = i ++;
+        while (i < count && (elems[i].row == (elems[i - 1].row + 1))) {
+            i ++;
+        }
+
+        ecs_table_range_t range = {
+            .table = table,
+            .offset = elems[start].row,
+            .count = i - start
+        };
+
+        ecs_iter_t it = ecs_query_iter(world, o->query);
+        ecs_iter_set_var_as_range(&it, 0, &range);
+        while (ecs_query_next(&it)) {
+            ecs_iter_skip(&it); /* Prevent change detection */
+            delivered += flecs_observer_flush_result(o, &it, 
+                &elems[start + it.offset - range.offset], observed);
+        }
+    }
+
+    /* Entities that no longer match get OnRemove */
+    if (observed & FLECS_COALESCE_SET) {
+        delivered += flecs_observer_flush_removed(
+            world, o, table, elems, count, observed);
+    }
+
+    return delivered;
+}
+
+typedef struct flecs_observer_flush_ctx_t {
+    ecs_world_t *world;             /* World, if single threaded */
+    ecs_observer_t *o;
+    ecs_coalesced_elem_t *elems;    /* Coalesced entities, sorted by table */
+    int32_t count;
+    ecs_flags32_t observed;
+    int32_t *delivered;             /* Delivered entities per thread */
+} flecs_observer_flush_ctx_t;
+
+/* Deliver events for the tables assigned to a thread. */
+static
+void flecs_observer_flush_run(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    flecs_observer_flush_ctx_t *fctx = ctx;
+    ecs_world_t *stage_world = fctx->world;
+    if (!stage_world) {
+        stage_world = ecs_get_stage(world, stage_index);
+    }
+
+    ecs_world_t *real_world = stage_world;
+    ecs_stage_t *stage = flecs_stage_from_world(&real_world);
+    ecs_entity_t old_system = flecs_stage_set_system(stage, fctx->o->entity);
+
+    ecs_coalesced_elem_t *elems = fctx->elems;
+    int32_t i, count = fctx->count, t = 0, delivered = 0;
+    for (i = 0; i < count; t ++) {
+        ecs_table_t *table = elems[i].table;
+        int32_t start = i ++;
+        while (i < count && elems[i].table == table) {
+            i ++;
+        }
+
+        /* Tables are assigned to threads round robin */
+        if ((t % stage_count) != stage_index) {
+            continue;
+        }
+
+        delivered += flecs_observer_flush_table(stage_world, fctx->o, table, 
+            &elems[start], i - start, fctx->observed);
+    }
+
+    flecs_stage_set_system(stage, old_system);
+
+    fctx->delivered[stage_index] = delivered;
+}
+
+int32_t ecs_observer_flush(
+    ecs_world_t *world,
+    ecs_entity_t observer)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_WHILE_READONLY,
+        NULL);
+
+    ecs_observer_t *o = ECS_CONST_CAST(ecs_observer_t*, 
+        ecs_observer_get(world, observer));
+    ecs_check(o != NULL, ECS_INVALID_PARAMETER, "entity is not an observer");
+
+    ecs_observer_impl_t *impl = flecs_observer_impl(o);
+    ecs_check(impl->flags & EcsObserverCoalesce, ECS_INVALID_PARAMETER,
+        "observer is not coalesced");
+
+    int32_t i, count = ecs_map_count(&impl->coalesced);
+    if (!count) {
+        return 0;
+    }
+
+    /* Copy stored entities, so that events emitted by the observer callback
+     * are stored for the next flush. */
+    ecs_allocator_t *a = &world->allocator;
+    ecs_coalesced_elem_t *elems = flecs_alloc_n(a, ecs_coalesced_elem_t, count);
+    ecs_map_iter_t mit = ecs_map_iter(&impl->coalesced);
+    i = 0;
+    while (ecs_map_next(&mit)) {
+        ecs_coalesced_elem_t *elem = &elems[i ++];
+        ecs_entity_t e = ecs_map_key(&mit);
+        elem->entity = e;
+        elem->events = (ecs_flags32_t)ecs_map_value(&mit);
+        elem->matched = false;
+        elem->table = NULL;
+        elem->row = 0;
+
+        if (ecs_is_alive(world, e)) {
+            ecs_record_t *r = flecs_entities_get(world, e);
+            elem->table = r->table;
+            elem->row = ECS_RECORD_TO_ROW(r->row);
+        }
+    }
+
+    ecs_map_clear(&impl->coalesced);
+
+    qsort(elems, flecs_itosize(count), ECS_SIZEOF(ecs_coalesced_elem_t), 
+        flecs_coalesced_elem_cmp);
+
+    ecs_flags32_t observed = 0;
+    for (i = 0; i < o->event_count; i ++) {
+        ecs_entity_t event = o->events[i];
+        if (event == EcsOnAdd) {
+            observed |= FLECS_COALESCE_ADD;
+        } else if (event == EcsOnRemove) {
+            observed |= FLECS_COALESCE_REMOVE;
+        } else if (event == EcsOnSet) {
+            observed |= FLECS_COALESCE_SET;
+        }
+    }
+
+    int32_t stage_count = ecs_get_stage_count(world);
+    int32_t *delivered = flecs_calloc_n(a, int32_t, stage_count);
+
+    flecs_observer_flush_ctx_t ctx = {
+        .world = world,
+        .o = o,
+        .elems = elems,
+        .count = count,
+        .observed = observed,
+        .delivered = delivered
+    };
+
+    bool ran = false;
+#ifdef FLECS_PIPELINE
+    /* Only use worker threads if there is more than one table */
+    if ((impl->flags & EcsObserverMultiThreaded) && 
+        (elems[0].table != elems[count - 1].table)) 
+    {
+        ctx.world = NULL;
+        ran = flecs_workers_run_deferred(world, flecs_observer_flush_run, &ctx);
+        ctx.world = world;
+    }
+#endif
+
+    if (!ran) {
+        ecs_defer_begin(world);
+        flecs_observer_flush_run(world, 0, 1, &ctx);
+        ecs_defer_end(world);
+    }
+
+    int32_t result = 0;
+    for (i = 0; i < stage_count; i ++) {
+        result += delivered[i];
+    }
+
+    flecs_free_n(a, int32_t, stage_count, delivered);
+    flecs_free_n(a, ecs_coalesced_elem_t, count, elems);
+
+    return result;
+error:
+    return 0;
+}
+
+#ifdef FLECS_SYSTEM
+static
+void flecs_observer_flush_system(
+    ecs_iter_t *it)
+{
+    ecs_observer_flush(it->world, ecs_get_parent(it->world, it->system));
+}
+#endif
+
+static
+int flecs_observer_flush_system_init(
+    ecs_world_t *world,
+    ecs_entity_t observer,
+    ecs_entity_t phase)
+{
+#ifdef FLECS_SYSTEM
+    ecs_entity_t system = ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .parent = observer,
+            .name = "Flush",
+            .add = ecs_ids( ecs_dependson(phase), phase )
+        }),
+        .callback = flecs_observer_flush_system,
+        .immediate = true
+    });
+
+    if (!system) {
+        return -1;
+    }
+
+    return 0;
+#else
+    (void)world;
+    (void)observer;
+    (void)phase;
+    ecs_err("coalesce_phase requires the system addon");
+    return -1;
+#endif
+}
+
 ecs_entity_t ecs_observer_init(
     ecs_world_t *world,
     const ecs_observer_desc_t *desc)
@@ -1399,6 +1897,13 @@ ecs_entity_t ecs_observer_init(
     ecs_check(!(world->flags & EcsWorldFini), ECS_INVALID_OPERATION,
         "cannot create observer while world is being deleted");
 
+    ecs_check(!desc->coalesce_phase || desc->coalesce, ECS_INVALID_PARAMETER,
+        "coalesce_phase requires coalesce");
+    ecs_check(!desc->multi_threaded || desc->coalesce, ECS_INVALID_PARAMETER,
+        "multi_threaded observers require coalesce");
+    ecs_check(!desc->coalesce || !desc->global_observer, 
+        ECS_INVALID_PARAMETER, "global observers cannot be coalesced");
+
     bool entity_created = false;
     entity = desc->entity;
     if (!entity && !desc->global_observer) {
@@ -1442,6 +1947,14 @@ ecs_entity_t ecs_observer_init(
         }
 
         flecs_poly_modified(world, entity, ecs_observer_t);
+
+        if (desc->coalesce_phase) {
+            if (flecs_observer_flush_system_init(
+                world, entity, desc->coalesce_phase)) 
+            {
+                goto error;
+            }
+        }
     }
 
     return entity;
@@ -1589,6 +2102,8 @@ void flecs_observer_fini(
         ecs_query_fini(impl->not_query);
     }
 
+    ecs_map_fini(&impl->coalesced);
+
     /* Cleanup context */
     if (o->ctx_free) {
         o->ctx_free(o->ctx);
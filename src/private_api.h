@@ -10,6 +10,12 @@
 #ifndef _POSIX_C_SOURCE
 #define _POSIX_C_SOURCE 200809L
 #endif
+#ifdef FLECS_HUGE_PAGES
+/* Exposes mmap flags and madvise, used to allocate huge pages */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#endif
 #endif
 
 #include <ctype.h>
@@ -127,6 +133,13 @@ uint64_t flecs_ito_(
 #define flecs_itoi16(value) flecs_ito(int16_t, (value))
 #define flecs_itoi32(value) flecs_ito(int32_t, (value))
 
+/* Hint to the CPU that memory will be read soon */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_prefetch(ptr) __builtin_prefetch(ptr)
+#else
+#define flecs_prefetch(ptr) (void)(ptr)
+#endif
+
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Utilities
@@ -7,6 +7,46 @@
 
 ECS_SORT_TABLE_WITH_COMPARE(_, flecs_query_cache_sort_table_generic, order_by, static)
 
+/* Maximum number of out of order rows for which a table is sorted with 
+ * insertion sort instead of quicksort. */
+#define FLECS_QUERY_SORT_INSERTION_MAX(count) (((count) >> 4) + 1)
+
+/* Sort a table that was sorted before with insertion sort. When only a few
+ * rows changed since the last time the table was sorted, this is much cheaper
+ * than sorting the entire table, as only the rows that are out of order are
+ * moved. The number of swaps is capped by the number of rows in the table, so
+ * that a table in which many rows changed falls back to a regular sort. 
+ * Returns false if the table is not sorted when the budget is exhausted. */
+static
+bool flecs_query_cache_insertion_sort_table(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_entity_t *entities,
+    void *ptr,
+    int32_t size,
+    int32_t count,
+    ecs_order_by_action_t compare)
+{
+    int32_t i, budget = count;
+
+    for (i = 1; i < count; i ++) {
+        int32_t j = i;
+        while (j && compare(entities[j - 1], ECS_ELEM(ptr, size, j - 1), 
+            entities[j], ECS_ELEM(ptr, size, j)) > 0) 
+        {
+            if (!budget) {
+                return false;
+            }
+
+            ecs_table_swap_rows(world, table, j - 1, j);
+            budget --;
+            j --;
+        }
+    }
+
+    return true;
+}
+
 static
 void flecs_query_cache_sort_table(
     ecs_world_t *world,
@@ -35,6 +75,32 @@ void flecs_query_cache_sort_table(
         ptr = column->data;
     }
 
+    /* Count rows that are out of order. Tables are re-sorted when any of
+     * their rows changed, which is often a small fraction of the table. */
+    int32_t i, unsorted = 0;
+    bool has_equal = false;
+    for (i = 1; i < count; i ++) {
+        int cmp = compare(entities[i - 1], ECS_ELEM(ptr, size, i - 1), 
+            entities[i], ECS_ELEM(ptr, size, i));
+        unsorted += cmp > 0;
+        has_equal |= cmp == 0;
+    }
+
+    /* Quicksort is not stable, and can reorder rows with equal values even if
+     * the table is already sorted. Only take the shortcuts if rows have 
+     * distinct values, so that the result is the same as with quicksort. */
+    if (!has_equal && !unsorted) {
+        return;
+    }
+
+    if (!has_equal && unsorted <= FLECS_QUERY_SORT_INSERTION_MAX(count)) {
+        if (flecs_query_cache_insertion_sort_table(
+            world, table, entities, ptr, size, count, compare))
+        {
+            return;
+        }
+    }
+
     if (sort) {
         sort(world, table, entities, ptr, size, 0, count - 1, compare);
     } else {
@@ -79,6 +145,57 @@ ecs_entity_t e_from_helper(
     }
 }
 
+/* Compare the current rows of two sort helpers. Rows that compare equal are
+ * ordered by helper index, so that entities with equal values are returned
+ * in the order of the tables in the cache. */
+static
+int flecs_query_cache_helper_compare(
+    sort_helper_t *helper,
+    int32_t h1,
+    int32_t h2,
+    ecs_order_by_action_t compare)
+{
+    int result = compare(
+        e_from_helper(&helper[h1]), ptr_from_helper(&helper[h1]),
+        e_from_helper(&helper[h2]), ptr_from_helper(&helper[h2]));
+    if (result) {
+        return result;
+    }
+
+    return (h1 > h2) - (h1 < h2);
+}
+
+static
+void flecs_query_cache_heap_sift_down(
+    sort_helper_t *helper,
+    int32_t *heap,
+    int32_t heap_count,
+    int32_t i,
+    ecs_order_by_action_t compare)
+{
+    for (;;) {
+        int32_t min = i, left = i * 2 + 1, right = left + 1;
+        if (left < heap_count && flecs_query_cache_helper_compare(
+            helper, heap[left], heap[min], compare) < 0) 
+        {
+            min = left;
+        }
+        if (right < heap_count && flecs_query_cache_helper_compare(
+            helper, heap[right], heap[min], compare) < 0) 
+        {
+            min = right;
+        }
+        if (min == i) {
+            break;
+        }
+
+        int32_t tmp = heap[i];
+        heap[i] = heap[min];
+        heap[min] = tmp;
+        i = min;
+    }
+}
+
 static
 void flecs_query_cache_build_sorted_table_range(
     ecs_query_cache_t *cache,
@@ -161,54 +278,51 @@ void flecs_query_cache_build_sorted_table_range(
         goto done;
     }
 
-    ecs_query_cache_match_t *cur = NULL;
-
-    bool proceed;
-    do {
-        int32_t j, min = 0;
-        proceed = true;
-
-        ecs_entity_t e1;
-        while (!(e1 = e_from_helper(&helper[min]))) {
-            min ++;
-            if (min == to_sort) {
-                proceed = false;
-                break;
-            }
-        }
+    /* Merge the sorted tables with a k-way merge. The heap contains the
+     * helpers that have rows left, with the helper that has the lowest row at
+     * the top. While the rows of the top helper remain lower than the rows of
+     * the other helpers, the heap doesn't change, which makes appending runs
+     * of rows from the same table cheap. */
+    int32_t *heap = flecs_alloc_n(&world->allocator, int32_t, to_sort);
+    int32_t heap_count = to_sort;
+    for (i = 0; i < to_sort; i ++) {
+        heap[i] = i;
+    }
 
-        if (!proceed) {
-            break;
-        }
+    for (i = heap_count / 2 - 1; i >= 0; i --) {
+        flecs_query_cache_heap_sift_down(helper, heap, heap_count, i, compare);
+    }
 
-        for (j = min + 1; j < to_sort; j++) {
-            ecs_entity_t e2 = e_from_helper(&helper[j]);
-            if (!e2) {
-                continue;
-            }
+    ecs_query_cache_match_t *cur = NULL;
 
-            const void *ptr1 = ptr_from_helper(&helper[min]);
-            const void *ptr2 = ptr_from_helper(&helper[j]);
+    while (heap_count) {
+        sort_helper_t *cur_helper = &helper[heap[0]];
 
-            if (compare(e1, ptr1, e2, ptr2) > 0) {
-                min = j;
-                e1 = e_from_helper(&helper[min]);
-            }
+        int32_t row_count = 1;
+        if (heap_count == 1) {
+            /* Last table with rows left, append remaining rows at once */
+            row_count = cur_helper->count - cur_helper->row;
         }
 
-        sort_helper_t *cur_helper = &helper[min];
         if (!cur || cur->base.columns != cur_helper->match->base.columns) {
             cur = ecs_vec_append_t(NULL, &cache->table_slices, 
                 ecs_query_cache_match_t);
             *cur = *(cur_helper->match);
             cur->_offset = cur_helper->row;
-            cur->_count = 1;
+            cur->_count = row_count;
         } else {
-            cur->_count ++;
+            cur->_count += row_count;
+        }
+
+        cur_helper->row += row_count;
+        if (cur_helper->row == cur_helper->count) {
+            heap[0] = heap[-- heap_count];
         }
 
-        cur_helper->row ++;
-    } while (proceed);
+        flecs_query_cache_heap_sift_down(helper, heap, heap_count, 0, compare);
+    }
+
+    flecs_free_n(&world->allocator, int32_t, to_sort, heap);
 
 done:
     flecs_free_n(&world->allocator, sort_helper_t, table_count, helper);
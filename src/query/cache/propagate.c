@@ -0,0 +1,239 @@
+/**
+ * @file query/cache/propagate.c
+ * @brief Propagate values down a hierarchy with a cascade query.
+ *
+ * Propagation iterates the groups of a cascade query in order of hierarchy
+ * depth. Each group is processed in two passes:
+ *
+ * - The calling thread iterates the group and determines which results must be
+ *   processed. A result is processed if the query doesn't detect changes, if
+ *   one of the fields read by the result changed, or if the table of a parent
+ *   was processed for a previous depth. Because this pass uses the regular
+ *   query iterator, the query monitors are synchronized and the written fields
+ *   are marked dirty, so that change detection for the next depth picks up the
+ *   changes to parents.
+ *
+ * - The results of the group are then iterated again by one or more threads,
+ *   which invoke the callback for the selected results. This pass skips change
+ *   detection, as it was already done by the first pass.
+ */
+
+#include "../../private_api.h"
+
+/* Minimum number of entities per thread for which results are split up across
+ * threads. Smaller results are assigned to a single thread. */
+#define FLECS_QUERY_PROPAGATE_SPLIT (64)
+
+typedef struct flecs_query_propagate_ctx_t {
+    ecs_world_t *world;             /* World or stage, if single threaded */
+    ecs_query_t *query;
+    const ecs_query_propagate_desc_t *desc;
+    uint64_t group_id;
+    const bool *selected;           /* Results selected for the group */
+    int32_t result_count;           /* Number of results in the group */
+} flecs_query_propagate_ctx_t;
+
+/* Test if the parent of a result was processed for a previous depth. This
+ * catches changes to parents for which the query doesn't keep a monitor, like
+ * parents of entities in non-fragmenting hierarchies. */
+static
+bool flecs_query_propagate_parent_written(
+    const ecs_iter_t *it,
+    const ecs_map_t *written)
+{
+    ecs_termset_t up_fields = it->up_fields;
+    if (!up_fields) {
+        return false;
+    }
+
+    int8_t i, field_count = it->field_count;
+    for (i = 0; i < field_count; i ++) {
+        if (!(up_fields & (1llu << i))) {
+            continue;
+        }
+
+        ecs_entity_t src = it->sources[i];
+        if (!src) {
+            continue;
+        }
+
+        ecs_record_t *r = flecs_entities_get(it->real_world, src);
+        if (r && r->table && ecs_map_get(written, r->table->id)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Select the results of a group that need to be processed. */
+static
+int32_t flecs_query_propagate_select(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    uint64_t group_id,
+    ecs_vec_t *selected,
+    ecs_map_t *written)
+{
+    ecs_allocator_t *a = &query->real_world->allocator;
+    bool detect_changes = query->flags & EcsQueryDetectChanges;
+    int32_t count = 0;
+
+    ecs_vec_clear(selected);
+
+    ecs_iter_t it = ecs_query_iter(world, query);
+    it.flags |= EcsIterMatchEmptyTables;
+    ecs_iter_set_group(&it, group_id);
+
+    while (ecs_query_next(&it)) {
+        bool select = it.count != 0;
+        if (select && detect_changes) {
+            select = ecs_iter_changed(&it) ||
+                flecs_query_propagate_parent_written(&it, written);
+        }
+
+        if (select) {
+            if (it.table) {
+                ecs_map_ensure(written, it.table->id);
+            }
+        } else {
+            ecs_iter_skip(&it);
+        }
+
+        ecs_vec_append_t(a, selected, bool)[0] = select;
+        count ++;
+    }
+
+    return count;
+}
+
+/* Invoke callback for the selected results of a group. */
+static
+void flecs_query_propagate_run(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx)
+{
+    flecs_query_propagate_ctx_t *pctx = ctx;
+    const ecs_query_propagate_desc_t *desc = pctx->desc;
+    ecs_world_t *stage = pctx->world;
+    if (!stage) {
+        stage = ecs_get_stage(world, stage_index);
+    }
+
+    ecs_iter_t it = ecs_query_iter(stage, pctx->query);
+    it.flags |= EcsIterMatchEmptyTables;
+    ecs_iter_set_group(&it, pctx->group_id);
+
+    /* Only iterate the results found by the first pass. Don't let the iterator
+     * run to completion, as that updates state for fixed query terms. */
+    int32_t r, result_count = pctx->result_count;
+    for (r = 0; r < result_count; r ++) {
+        if (!ecs_query_next(&it)) {
+            return;
+        }
+
+        /* Change detection was done by the first pass */
+        ecs_iter_skip(&it);
+
+        if (!pctx->selected[r]) {
+            continue;
+        }
+
+        ecs_iter_t slice = it;
+        slice.ctx = desc->ctx;
+
+        if (it.count >= (stage_count * FLECS_QUERY_PROPAGATE_SPLIT)) {
+            int32_t first = (int32_t)(
+                (int64_t)it.count * stage_index / stage_count);
+            int32_t last = (int32_t)(
+                (int64_t)it.count * (stage_index + 1) / stage_count);
+            slice.offset += first;
+            slice.count = last - first;
+            slice.entities = &it.entities[first];
+        } else if ((r % stage_count) != stage_index) {
+            continue;
+        }
+
+        desc->callback(&slice);
+    }
+
+    ecs_iter_fini(&it);
+}
+
+int ecs_query_propagate(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    const ecs_query_propagate_desc_t *desc)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_poly_assert(query, ecs_query_t);
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(desc->callback != NULL, ECS_INVALID_PARAMETER,
+        "missing callback for propagate");
+
+    ecs_query_impl_t *impl = flecs_query_impl(query);
+    ecs_query_cache_t *cache = impl->cache;
+    ecs_check(cache != NULL && cache->cascade_by, ECS_INVALID_PARAMETER,
+        "propagate requires a cached query with a cascade term");
+    ecs_check(!(cache->query->terms[cache->cascade_by - 1].src.id & EcsDesc),
+        ECS_INVALID_PARAMETER,
+        "propagate requires a cascade term with ascending order");
+
+    ecs_world_t *real_world = query->real_world;
+    ecs_allocator_t *a = &real_world->allocator;
+
+    /* Make sure the cache is up to date before iterating its groups */
+    if (!(ecs_world_get_flags(world) & EcsWorldReadonly) && 
+        (query->flags & EcsQueryHasRefs)) 
+    {
+        flecs_eval_component_monitors(real_world);
+    }
+
+    bool multi_threaded = desc->multi_threaded &&
+        flecs_poly_is(world, ecs_world_t) &&
+        !(world->flags & EcsWorldReadonly);
+
+    ecs_vec_t selected;
+    ecs_vec_init_t(a, &selected, bool, 0);
+    ecs_map_t written;
+    ecs_map_init(&written, a);
+
+    flecs_query_propagate_ctx_t ctx = {
+        .world = world,
+        .query = query,
+        .desc = desc
+    };
+
+    ecs_query_cache_group_t *group = cache->first_group;
+    for (; group; group = group->next) {
+        ctx.group_id = group->info.id;
+        ctx.result_count = flecs_query_propagate_select(
+            world, query, ctx.group_id, &selected, &written);
+        ctx.selected = ecs_vec_first_t(&selected, bool);
+
+#ifdef FLECS_PIPELINE
+        if (multi_threaded) {
+            ctx.world = NULL;
+            if (flecs_workers_run(real_world,
+                flecs_query_propagate_run, &ctx))
+            {
+                continue;
+            }
+            ctx.world = world;
+        }
+#else
+        (void)multi_threaded;
+#endif
+
+        flecs_query_propagate_run(world, 0, 1, &ctx);
+    }
+
+    ecs_map_fini(&written);
+    ecs_vec_fini_t(a, &selected, bool);
+
+    return 0;
+error:
+    return -1;
+}
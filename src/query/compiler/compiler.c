@@ -559,6 +559,103 @@ int32_t flecs_query_term_next_known(
     return -1;
 }
 
+int32_t flecs_query_term_cost(
+    const ecs_world_t *world,
+    const ecs_query_t *q,
+    const ecs_term_t *term)
+{
+    if (term->oper != EcsAnd || flecs_term_is_or(q, term)) {
+        return -1;
+    }
+
+    if (term->flags_ & (EcsTermIsScope|EcsTermIsMember|EcsTermIsToggle|
+        EcsTermDontFragment|EcsTermNonFragmentingChildOf|EcsTermTransitive|
+        EcsTermIdInherited|EcsTermReflexive|EcsTermMatchAny|EcsTermMatchAnySrc))
+    {
+        return -1;
+    }
+
+    if (!ecs_term_match_this(term) || 
+        ((term->src.id & EcsTraverseFlags) != EcsSelf)) 
+    {
+        return -1;
+    }
+
+    /* Only reorder terms with fixed ids. Terms with variables or predicates
+     * may depend on the order in which terms are evaluated. */
+    if (ecs_id_is_wildcard(term->id) || (term->first.id & EcsIsVariable) ||
+        (term->second.id & EcsIsVariable)) 
+    {
+        return -1;
+    }
+
+    ecs_entity_t first = ECS_TERM_REF_ID(&term->first);
+    if (first == EcsPredEq || first == EcsPredMatch || first == EcsPredLookup ||
+        first == EcsChildOf) 
+    {
+        return -1;
+    }
+
+    ecs_component_record_t *cr = flecs_components_get(world, term->id);
+    if (!cr) {
+        return 0;
+    }
+
+    return flecs_table_cache_count(&cr->cache);
+}
+
+/* Order the terms of a query by their estimated number of matched tables. Terms
+ * that can be reordered are moved to the front, and terms are never moved 
+ * across optional terms, which protects short-circuiting behavior. */
+static
+void flecs_query_order_by_cost(
+    ecs_world_t *world,
+    ecs_query_impl_t *query,
+    int32_t *order)
+{
+    ecs_query_t *q = &query->pub;
+    ecs_term_t *terms = q->terms;
+    int32_t i, j, term_count = q->term_count, start = 0;
+    int32_t cost[FLECS_TERM_COUNT_MAX];
+
+    for (i = 0; i < term_count; i ++) {
+        cost[i] = flecs_query_term_cost(world, q, &terms[i]);
+    }
+
+    for (i = 0; i <= term_count; i ++) {
+        if (i != term_count && terms[i].oper != EcsOptional) {
+            continue;
+        }
+
+        /* Terms that can be reordered go first, ordered by cost. Insertion 
+         * sort keeps the original order for terms with the same cost. */
+        int32_t count = 0;
+        for (j = start; j < i; j ++) {
+            if (cost[j] == -1) {
+                continue;
+            }
+
+            int32_t k = start + count;
+            while (k > start && cost[order[k - 1]] > cost[j]) {
+                order[k] = order[k - 1];
+                k --;
+            }
+
+            order[k] = j;
+            count ++;
+        }
+
+        for (j = start; j < i; j ++) {
+            if (cost[j] == -1) {
+                order[start + count] = j;
+                count ++;
+            }
+        }
+
+        start = i + 1;
+    }
+}
+
 /* If the first part of a query contains more than one trivial term, insert a
  * special instruction which batch-evaluates multiple terms. */
 static
@@ -1008,6 +1105,16 @@ int flecs_query_compile(
     /* Insert trivial term search if query allows for it */
     flecs_query_insert_trivial_search(query, &compiled, &ctx);
 
+    /* Order in which the remaining terms are compiled */
+    int32_t order[FLECS_TERM_COUNT_MAX];
+    for (i = 0; i < term_count; i ++) {
+        order[i] = i;
+    }
+
+    if (q->flags & EcsQueryPlanByCost) {
+        flecs_query_order_by_cost(world, query, order);
+    }
+
     /* If a query starts with one or more optional terms, first compile the non
      * optional terms. This prevents having to insert an instruction that 
      * matches the query against every entity in the storage. 
@@ -1024,10 +1131,10 @@ int flecs_query_compile(
     do {
         /* Compile remaining query terms to instructions */
         for (i = start_term; i < term_count; i ++) {
-            ecs_term_t *term = &terms[i];
-            int32_t compile = i;
+            ecs_term_t *term = &terms[order[i]];
+            int32_t compile = order[i];
 
-            if (compiled & (1ull << i)) {
+            if (compiled & (1ull << compile)) {
                 continue; /* Already compiled */
             }
 
@@ -1054,8 +1161,13 @@ int flecs_query_compile(
             if (can_reorder && ctx.written && 
                 flecs_query_term_is_unknown(query, term, &ctx)) 
             {
+                int32_t offset = i + 1;
+                if (q->flags & EcsQueryPlanByCost) {
+                    offset = 0; /* Terms are not compiled in term order */
+                }
+
                 int32_t term_index = flecs_query_term_next_known(
-                    query, &ctx, i + 1, compiled);
+                    query, &ctx, offset, compiled);
                 if (term_index != -1) {
                     term = &q->terms[term_index];
                     compile = term_index;
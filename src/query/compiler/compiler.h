@@ -14,6 +14,13 @@ int flecs_query_compile(
     ecs_stage_t *stage,
     ecs_query_impl_t *query);
 
+/* Estimate the number of tables matched by a term. Returns -1 if the term can't
+ * be reordered by the cost based planner. */
+int32_t flecs_query_term_cost(
+    const ecs_world_t *world,
+    const ecs_query_t *q,
+    const ecs_term_t *term);
+
 /* Compile single term */
 int flecs_query_compile_term(
     ecs_world_t *world,
@@ -893,6 +893,11 @@ int flecs_query_compile_begin_member_term(
         return -1;
     }
 
+    /* Members of SoA structs are stored as separate components */
+    if (ecs_owns_id(world, component, EcsSoA)) {
+        component = first_id;
+    }
+
     if (!ecs_has(world, component, EcsComponent)) {
         ecs_err("parent of member is not a component");
         return -1;
@@ -944,6 +949,12 @@ int flecs_query_compile_end_member_term(
     first_id = ECS_TERM_REF_ID(&term->first);
     const EcsMember *member = ecs_get(world, first_id, EcsMember);
     ecs_assert(member != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    /* Members of SoA structs are stored at the start of their own column */
+    int32_t offset = member->offset;
+    if (component == first_id) {
+        offset = 0;
+    }
     ecs_query_var_t *var = &impl->vars[op->src.var];
     const char *var_name = flecs_term_ref_var_name(&term->src);
     ecs_var_id_t evar = flecs_query_find_var_id(
@@ -961,7 +972,7 @@ int flecs_query_compile_end_member_term(
     ecs_query_op_t mbr_op = *op;
     mbr_op.kind = EcsQueryMemberEq;
     mbr_op.first.entity = /* Encode type size and member offset */
-        flecs_ito(uint32_t, member->offset) | 
+        flecs_ito(uint32_t, offset) | 
         (flecs_ito(uint64_t, comp->size) << 32);
 
     /* If this is a term with a Not operator, conditionally evaluate member on
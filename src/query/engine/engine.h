@@ -222,6 +222,28 @@ bool flecs_query_trivial_sparse_search(
     const ecs_query_run_ctx_t *ctx,
     bool redo);
 
+/* Let a trivial sparse iterator only return the results for a worker. Returns
+ * false if the iterator can't be split up. */
+bool flecs_query_trivial_sparse_split(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor,
+    int32_t chunk_size);
+
+/* Let an uncached query iterator only find the tables for a worker. Returns 
+ * false if the iterator can't be partitioned. */
+bool flecs_query_partition_init(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor);
+
+/* Advance partition to the next table found by the partitioned operation.
+ * Returns true if the table belongs to another worker. */
+bool flecs_query_partition_skip(
+    ecs_query_partition_t *partition);
+
 
 /* Hierarchy evaluation */
 
@@ -56,6 +56,14 @@ repeat:
             return false;
         }
 
+        ecs_query_partition_t *partition = ctx->qit->partition;
+        if (partition && (partition->op == ctx->op_index) &&
+            flecs_query_partition_skip(partition))
+        {
+            redo = false;
+            goto repeat;
+        }
+
         tr = elem->tr;
         op_ctx->column = elem->index;
         op_ctx->remaining = flecs_ito(int16_t, tr->count - 1);
@@ -357,6 +357,115 @@ bool flecs_query_trivial_cached_next(
     return false;
 }
 
+/* Find the operation that selects the tables for $this. Returns -1 if the
+ * query can't be partitioned. */
+static
+ecs_query_lbl_t flecs_query_partition_op(
+    const ecs_query_impl_t *impl)
+{
+    const ecs_query_op_t *ops = impl->ops;
+    int32_t i, count = impl->op_count;
+
+    for (i = 0; i < count; i ++) {
+        const ecs_query_op_t *op = &ops[i];
+        if (op->kind == EcsQuerySetIds || op->kind == EcsQuerySetId) {
+            continue;
+        }
+
+        /* The first operation must find tables for $this. Operations inside
+         * of control flow blocks could find tables for $this more than once. */
+        if (op->kind == EcsQueryTriv) {
+            return flecs_itolbl(i);
+        }
+
+        if (op->kind != EcsQueryAnd) {
+            return -1;
+        }
+
+        if (!(op->flags & (EcsQueryIsVar << EcsQuerySrc)) || 
+            (op->src.var != 0)) 
+        {
+            return -1;
+        }
+
+        /* Wildcards can match non-fragmenting components, which are returned
+         * per entity and not per table. */
+        ecs_id_t id = impl->pub.terms[op->term_index].id;
+        if (!ECS_IS_PAIR(id) && ecs_id_is_wildcard(id)) {
+            return -1;
+        }
+
+        return flecs_itolbl(i);
+    }
+
+    return -1;
+}
+
+bool flecs_query_partition_init(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor)
+{
+    if (it->next != ecs_query_next) {
+        return false;
+    }
+
+    if (!(it->query->flags & EcsQueryPartitionTables)) {
+        return false;
+    }
+
+    if (!cursor && count < 2) {
+        return false;
+    }
+
+    if (it->flags & (EcsIterIsValid|EcsIterCached|EcsIterTrivialSparse|
+        EcsIterTrivialTest)) 
+    {
+        return false;
+    }
+
+    if (it->constrained_vars & 1) {
+        return false; /* $this is not found by the query */
+    }
+
+    ecs_query_lbl_t op = -1;
+    if (!(it->flags & EcsIterTrivialSearch)) {
+        op = flecs_query_partition_op(flecs_query_impl(it->query));
+        if (op == -1) {
+            return false;
+        }
+    }
+
+    ecs_query_partition_t *partition = flecs_iter_calloc_t(
+        it, ecs_query_partition_t);
+    partition->cursor = cursor;
+    partition->index = index;
+    partition->count = count;
+    partition->claimed = -1;
+    partition->op = op;
+    it->priv_.iter.query.partition = partition;
+
+    return true;
+}
+
+bool flecs_query_partition_skip(
+    ecs_query_partition_t *partition)
+{
+    int32_t table = partition->table ++;
+    if (!partition->cursor) {
+        return (table % partition->count) != partition->index;
+    }
+
+    /* All workers walk the tables in the same order, so a claimed index refers
+     * to the same table for each worker. */
+    if (partition->claimed < table) {
+        partition->claimed = ecs_os_ainc(partition->cursor) - 1;
+    }
+
+    return partition->claimed != table;
+}
+
 void flecs_query_op_ctx_fini(
     ecs_iter_t *it,
     const ecs_query_op_t *op,
@@ -452,6 +561,11 @@ void flecs_query_iter_fini(
         }
     }
 
+    if (qit->partition) {
+        flecs_iter_free_t(qit->partition, ecs_query_partition_t);
+        qit->partition = NULL;
+    }
+
     flecs_query_iter_fini_ctx(it, qit);
     flecs_iter_free_n(qit->vars, ecs_var_t, var_count);
     flecs_iter_free_n(qit->written, ecs_write_flags_t, op_count);
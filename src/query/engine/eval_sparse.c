@@ -718,6 +718,32 @@ bool flecs_query_sparse(
     }
 }
 
+/* Claim the next range of the dense array of the lead component. */
+static
+bool flecs_query_trivial_sparse_next_range(
+    ecs_query_sparse_trivial_ctx_t *op_ctx,
+    int32_t count)
+{
+    if (!op_ctx->cursor) {
+        return false;
+    }
+
+    int32_t chunk_size = op_ctx->chunk_size;
+    int32_t claimed = ecs_os_ainc(op_ctx->cursor) - 1;
+    int32_t first = claimed * chunk_size;
+    if (first >= count) {
+        return false;
+    }
+
+    op_ctx->cur = first;
+    op_ctx->end = first + chunk_size;
+    if (op_ctx->end > count) {
+        op_ctx->end = count;
+    }
+
+    return true;
+}
+
 bool flecs_query_trivial_sparse_search(
     const ecs_query_run_ctx_t *ctx,
     bool redo)
@@ -747,46 +773,86 @@ bool flecs_query_trivial_sparse_search(
         }
 
         op_ctx->lead = lead;
-        op_ctx->cur = 0;
+
+        /* Each worker iterates its own part of the dense array */
+        int32_t count = flecs_sparse_count(op_ctx->sparse[lead]);
+        if (op_ctx->cursor) {
+            op_ctx->cur = op_ctx->end = 0;
+        } else if (op_ctx->worker_count > 1) {
+            int32_t index = op_ctx->worker_index;
+            int32_t worker_count = op_ctx->worker_count;
+            op_ctx->cur = (int32_t)((int64_t)count * index / worker_count);
+            op_ctx->end = (int32_t)(
+                (int64_t)count * (index + 1) / worker_count);
+        } else {
+            op_ctx->cur = 0;
+            op_ctx->end = count;
+        }
     }
 
     int8_t lead = op_ctx->lead;
     ecs_sparse_t *lead_sparse = op_ctx->sparse[lead];
     const uint64_t *ids = flecs_sparse_ids(lead_sparse);
-    int32_t cur = op_ctx->cur, count = flecs_sparse_count(lead_sparse);
+    int32_t count = flecs_sparse_count(lead_sparse);
     ecs_entity_t *entities = op_ctx->entities;
     int32_t n = 0;
 
-    for (; cur < count && n < FLECS_QUERY_SPARSE_BATCH_SIZE; cur ++) {
-        ecs_entity_t e = ids[cur];
+next_range: {
+        int32_t cur = op_ctx->cur, end = op_ctx->end;
+        if (end > count) {
+            end = count;
+        }
 
-        for (i = 0; i < field_count; i ++) {
-            if (i == lead) {
-                continue;
+        for (; cur < end && n < FLECS_QUERY_SPARSE_BATCH_SIZE; cur ++) {
+            /* Sparse elements are stored in pages indexed by entity id, which 
+             * means that iterating the dense array accesses them in random
+             * order. Prefetch elements before they are accessed. */
+            if ((cur + FLECS_QUERY_SPARSE_PREFETCH) < end) {
+                ecs_entity_t pe = ids[cur + FLECS_QUERY_SPARSE_PREFETCH];
+                for (i = 0; i < field_count; i ++) {
+                    flecs_sparse_prefetch(op_ctx->sparse[i], pe);
+                }
+                flecs_entities_prefetch(ctx->world, pe);
             }
-            if (!flecs_sparse_has(op_ctx->sparse[i], e)) {
-                goto next;
+
+            ecs_entity_t e = ids[cur];
+
+            for (i = 0; i < field_count; i ++) {
+                if (i == lead) {
+                    continue;
+                }
+                if (!flecs_sparse_has(op_ctx->sparse[i], e)) {
+                    goto next;
+                }
             }
-        }
 
-        {
-            ecs_record_t *r = flecs_entities_get(ctx->world, e);
-            ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
-            ecs_table_t *table = r->table;
-            ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
-            if (table->flags & 
-                (EcsTableNotQueryable|EcsTableIsPrefab|EcsTableIsDisabled))
             {
-                goto next;
+                ecs_record_t *r = flecs_entities_get(ctx->world, e);
+                ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+                ecs_table_t *table = r->table;
+                ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+                if (table->flags & 
+                    (EcsTableNotQueryable|EcsTableIsPrefab|EcsTableIsDisabled))
+                {
+                    goto next;
+                }
             }
-        }
 
-        entities[n ++] = e;
+            entities[n ++] = e;
 next:
-        continue;
-    }
+            continue;
+        }
+
+        op_ctx->cur = cur;
 
-    op_ctx->cur = cur;
+        /* When iterating chunks, don't return empty results for chunks that
+         * didn't match anything */
+        if (!n && cur >= end) {
+            if (flecs_query_trivial_sparse_next_range(op_ctx, count)) {
+                goto next_range;
+            }
+        }
+    }
 
     if (!n) {
         return false;
@@ -799,3 +865,33 @@ next:
 
     return true;
 }
+
+bool flecs_query_trivial_sparse_split(
+    ecs_iter_t *it,
+    int32_t index,
+    int32_t count,
+    int32_t *cursor,
+    int32_t chunk_size)
+{
+    if (it->next != ecs_query_next || !(it->flags & EcsIterTrivialSparse)) {
+        return false;
+    }
+
+    ecs_query_iter_t *qit = &it->priv_.iter.query;
+    if (!qit->op_ctx) {
+        return false;
+    }
+
+    ecs_query_sparse_trivial_ctx_t *op_ctx = &qit->op_ctx[0].is.sparse_trivial;
+    if (op_ctx->sparse) {
+        /* Iteration already started */
+        return false;
+    }
+
+    op_ctx->worker_index = index;
+    op_ctx->worker_count = count;
+    op_ctx->cursor = cursor;
+    op_ctx->chunk_size = chunk_size;
+
+    return true;
+}
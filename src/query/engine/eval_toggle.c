@@ -81,6 +81,68 @@ flecs_query_row_mask_t flecs_query_get_row_mask(
     return (flecs_query_row_mask_t){ mask, has_bitset };
 }
 
+/* Evaluate toggle fields for a table that stores rows with an enabled dense
+ * toggle before rows with a disabled dense toggle. If the dense toggle is the
+ * only toggle field with a bitset, the matching rows are a single range.
+ * Returns -1 if fields can't be evaluated with the partition, 0 if no rows
+ * match and 1 if the rows in range match. */
+static
+int32_t flecs_query_toggle_dense(
+    ecs_iter_t *it,
+    ecs_table_t *table,
+    ecs_flags64_t and_fields,
+    ecs_flags64_t not_fields,
+    ecs_query_toggle_ctx_t *op_ctx,
+    ecs_table_range_t *range)
+{
+    ecs_table__t *meta = table->_;
+    int32_t enabled = meta->dense_toggle_count;
+    if (enabled == -1) {
+        return -1;
+    }
+
+    ecs_bitset_t *dense = &meta->bs_columns[meta->dense_toggle];
+    int32_t first = range->offset, last = range->offset + range->count;
+    int32_t i, field_count = it->field_count;
+    ecs_flags64_t fields = and_fields | not_fields;
+
+    for (i = 0; i < field_count; i ++) {
+        uint64_t field_bit = 1llu << i;
+        if (!(fields & field_bit)) {
+            continue;
+        }
+
+        ecs_bitset_t *bs = flecs_table_get_toggle(table, it->ids[i]);
+        if (!bs) {
+            if ((not_fields & field_bit) && 
+                (op_ctx->prev_set_fields & field_bit)) 
+            {
+                return 0;
+            }
+            continue;
+        }
+
+        if (bs != dense) {
+            return -1;
+        }
+
+        if (not_fields & field_bit) {
+            it->set_fields &= (ecs_termset_t)~field_bit;
+            first = ECS_MAX(first, enabled);
+        } else {
+            last = ECS_MIN(last, enabled);
+        }
+    }
+
+    if (first >= last) {
+        return 0;
+    }
+
+    range->offset = first;
+    range->count = last - first;
+    return 1;
+}
+
 static
 bool flecs_query_toggle_for_up(
     ecs_iter_t *it,
@@ -182,6 +244,21 @@ bool flecs_query_toggle_cmp(
         cur = op_ctx->cur = range.offset;
         block_index = op_ctx->block_index = -1;
         last = range.offset + range.count;
+
+        if (table->flags & EcsTableHasDenseToggle) {
+            int32_t dense = flecs_query_toggle_dense(
+                it, table, and_fields, not_fields, op_ctx, &range);
+            if (dense != -1) {
+                /* Matching rows are a single range, no need to redo */
+                op_ctx->has_bitset = false;
+                if (!dense) {
+                    goto done;
+                }
+
+                flecs_query_src_set_range(op, &range, ctx);
+                return true;
+            }
+        }
     } else {
         if (!op_ctx->has_bitset) {
             goto done;
@@ -60,6 +60,67 @@ int32_t flecs_trav_type_offset_search(
     return -1;
 }
 
+/* Results of up traversal are stored in the reachable cache of the pair record
+ * for the traversed relationship and target, so that they can be reused by
+ * other iterators and in later frames. Results are stored for each visited
+ * target, which guarantees that an entity changing tables invalidates the
+ * results that depend on it (see flecs_emit_propagate_invalidate_tables). */
+static
+bool flecs_trav_up_index_get(
+    ecs_component_record_t *cr,
+    ecs_id_t with,
+    ecs_id_t rel,
+    ecs_trav_up_t *up)
+{
+    ecs_reachable_cache_t *rc = &cr->pair->reachable;
+    if (rc->up_current != rc->generation) {
+        return false;
+    }
+
+    ecs_reachable_up_t *elems = ecs_vec_first_t(&rc->up, ecs_reachable_up_t);
+    int32_t i, count = ecs_vec_count(&rc->up);
+    for (i = 0; i < count; i ++) {
+        ecs_reachable_up_t *elem = &elems[i];
+        if (elem->with == with && elem->rel == rel) {
+            up->src = elem->src;
+            up->id = elem->id;
+            up->tr = elem->tr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static
+void flecs_trav_up_index_set(
+    const ecs_world_t *world,
+    ecs_component_record_t *cr,
+    ecs_id_t with,
+    ecs_id_t rel,
+    const ecs_trav_up_t *up)
+{
+    /* Other threads may be reading from the index */
+    if ((world->flags & EcsWorldMultiThreaded) || world->worker_job) {
+        return;
+    }
+
+    ecs_world_t *unsafe_world = ECS_CONST_CAST(ecs_world_t*, world);
+    ecs_reachable_cache_t *rc = &cr->pair->reachable;
+    if (rc->up_current != rc->generation) {
+        ecs_vec_clear(&rc->up);
+        rc->up_current = rc->generation;
+    }
+
+    ecs_reachable_up_t *elem = ecs_vec_append_t(
+        &unsafe_world->allocator, &rc->up, ecs_reachable_up_t);
+    elem->with = with;
+    elem->rel = rel;
+    elem->src = up->src;
+    elem->id = up->id;
+    elem->tr = up->tr;
+}
+
 static
 ecs_trav_up_t* flecs_trav_table_up(
     const ecs_query_run_ctx_t *ctx,
@@ -219,12 +280,56 @@ ecs_trav_up_t* flecs_trav_table_up(
         return up;
     }
 
-    flecs_trav_table_up_w(ctx, a, cache, world, src, with, rel, cr_with,
-        cr_trav, up);
+    /* Sparse components can be added without changing tables, which doesn't
+     * invalidate the index. */
+    ecs_component_record_t *cr = NULL;
+    if (!(cr_with->flags & EcsIdDontFragment)) {
+        cr = flecs_components_get(world, 
+            ecs_pair(ECS_PAIR_FIRST(cr_trav->id), src));
+    }
+
+    if (!cr || !flecs_trav_up_index_get(cr, with, rel, up)) {
+        flecs_trav_table_up_w(ctx, a, cache, world, src, with, rel, cr_with,
+            cr_trav, up);
+        if (cr) {
+            flecs_trav_up_index_set(world, cr, with, rel, up);
+        }
+    }
+
     up->ready = true;
     return up;
 }
 
+static
+void flecs_trav_table_up_indexed(
+    const ecs_query_run_ctx_t *ctx,
+    ecs_allocator_t *a,
+    ecs_trav_up_cache_t *cache,
+    const ecs_world_t *world,
+    ecs_component_record_t *cr,
+    ecs_entity_t tgt,
+    ecs_id_t with,
+    ecs_id_t rel,
+    ecs_component_record_t *cr_with,
+    ecs_component_record_t *cr_trav,
+    ecs_trav_up_t *up)
+{
+    if (cr_with->flags & EcsIdDontFragment) {
+        cr = NULL;
+    }
+
+    if (cr && flecs_trav_up_index_get(cr, with, rel, up)) {
+        return;
+    }
+
+    flecs_trav_table_up_w(ctx, a, cache, world, tgt, with, rel, cr_with, 
+        cr_trav, up);
+
+    if (cr) {
+        flecs_trav_up_index_set(world, cr, with, rel, up);
+    }
+}
+
 ecs_trav_up_t* flecs_query_get_up_cache(
     const ecs_query_run_ctx_t *ctx,
     ecs_trav_up_cache_t *cache,
@@ -264,7 +369,8 @@ ecs_trav_up_t* flecs_query_get_up_cache(
             ecs_entity_t tgt = (uint32_t)p->value;
             ecs_trav_up_t *result = &cache->up;
             *result = (ecs_trav_up_t){0};
-            flecs_trav_table_up_w(ctx, a, cache, world, tgt,
+            flecs_trav_table_up_indexed(ctx, a, cache, world, 
+                flecs_components_get(world, ecs_childof(tgt)), tgt,
                 with, ecs_pair(trav, EcsWildcard), cr_with, cr_trav, result);
             if (result->src != 0) {
                 return result;
@@ -285,7 +391,8 @@ ecs_trav_up_t* flecs_query_get_up_cache(
         ecs_entity_t tgt = ECS_PAIR_SECOND(id);
         ecs_trav_up_t *result = &cache->up;
         *result = (ecs_trav_up_t){0};
-        flecs_trav_table_up_w(ctx, a, cache, world, tgt,
+        flecs_trav_table_up_indexed(ctx, a, cache, world, 
+            table->_->records[i].hdr.cr, tgt,
             with, ecs_pair(trav, EcsWildcard), cr_with, cr_trav, result);
         if (result->src != 0) {
             return result;
@@ -25,13 +25,35 @@ bool flecs_query_trivial_search_init(
         }
 
         ecs_assert(t != query->term_count, ECS_INTERNAL_ERROR, NULL);
-        op_ctx->start_from = t;
 
         ecs_component_record_t *cr = flecs_components_get(ctx->world, query->terms[t].id);
         if (!cr) {
             return false;
         }
 
+        if (query->flags & EcsQueryPlanByCost) {
+            /* Start from the term that matches the fewest tables */
+            int32_t i, first = t;
+            for (i = first + 1; i < query->term_count; i ++) {
+                if (term_set && !(term_set & (1llu << i))) {
+                    continue;
+                }
+
+                ecs_component_record_t *cr_i = flecs_components_get(
+                    ctx->world, query->terms[i].id);
+                if (!cr_i) {
+                    return false;
+                }
+
+                if (cr_i->cache.queryable_count < cr->cache.queryable_count) {
+                    cr = cr_i;
+                    t = i;
+                }
+            }
+        }
+
+        op_ctx->start_from = t;
+
         if (query->flags & EcsQueryMatchEmptyTables) {
             if (!flecs_table_cache_queryable_iter(&cr->cache, &op_ctx->it, 
                 EcsTableEmpty|EcsTableNotEmpty))
@@ -47,8 +69,11 @@ bool flecs_query_trivial_search_init(
         }
 
         /* Find next term to evaluate once */
-        for (t = t + 1; t < query->term_count; t ++) {
-            if (term_set & (1llu << t)) {
+        for (t = 0; t < query->term_count; t ++) {
+            if (t == op_ctx->start_from) {
+                continue;
+            }
+            if (!term_set || (term_set & (1llu << t))) {
                 break;
             }
         }
@@ -96,6 +121,13 @@ bool flecs_query_trivial_search(
             return false;
         }
 
+        ecs_query_partition_t *partition = ctx->qit->partition;
+        if (partition && (partition->op == ctx->op_index) &&
+            flecs_query_partition_skip(partition))
+        {
+            continue;
+        }
+
         ecs_table_t *table = elem->table;
         if (!flecs_table_bloom_filter_test(table, q_filter)) {
             continue;
@@ -103,7 +135,7 @@ bool flecs_query_trivial_search(
 
         int16_t *columns = ECS_CONST_CAST(int16_t*, it->columns);
         for (t = op_ctx->first_to_eval; t < term_count; t ++) {
-            if (!(term_set & (1llu << t))) {
+            if (!(term_set & (1llu << t)) || (t == op_ctx->start_from)) {
                 continue;
             }
 
@@ -151,6 +183,7 @@ bool flecs_query_is_trivial_search(
 
     uint64_t q_filter = q->bloom_filter;
     ecs_component_record_t **cr_cache = query->cr_cache;
+    int32_t start_from = op_ctx->start_from;
 
 next:
     {
@@ -160,13 +193,23 @@ next:
             return false;
         }
 
+        if (ctx->qit->partition && 
+            flecs_query_partition_skip(ctx->qit->partition)) 
+        {
+            goto next;
+        }
+
         ecs_table_t *table = elem->table;
         if (!flecs_table_bloom_filter_test(table, q_filter)) {
             goto next;
         }
 
         int16_t *columns = ECS_CONST_CAST(int16_t*, it->columns);
-        for (t = 1; t < term_count; t ++) {
+        for (t = op_ctx->first_to_eval; t < term_count; t ++) {
+            if (t == start_from) {
+                continue;
+            }
+
             ecs_component_record_t *cr = cr_cache[t];
             ecs_assert(cr != NULL, ECS_INTERNAL_ERROR, NULL);
 
@@ -183,8 +226,8 @@ next:
         it->table = table;
         it->count = ecs_table_count(table);
         it->entities = ecs_table_entities(table);
-        it->trs[0] = elem->tr;
-        columns[0] = elem->column;
+        it->trs[start_from] = elem->tr;
+        columns[start_from] = elem->column;
     }
 
     return true;
@@ -359,14 +359,36 @@ typedef struct {
     int32_t first_to_eval;
 } ecs_query_trivial_ctx_t;
 
+/* Partition of the tables found by an uncached query. Worker iterators use a
+ * partition to only evaluate a query for the tables of the worker. */
+typedef struct ecs_query_partition_t {
+    int32_t *cursor;            /* Shared table counter (dynamic partition) */
+    int32_t index;              /* Index of worker (static partition) */
+    int32_t count;              /* Number of workers (static partition) */
+    int32_t table;              /* Number of tables found by partitioned op */
+    int32_t claimed;            /* Last claimed table (dynamic partition) */
+    ecs_query_lbl_t op;         /* Partitioned op, -1 for trivial iterator */
+} ecs_query_partition_t;
+
 /* Trivial sparse iterator context */
 #define FLECS_QUERY_SPARSE_BATCH_SIZE (1024)
 
+/* Number of elements ahead of the iterated element that are prefetched */
+#define FLECS_QUERY_SPARSE_PREFETCH (8)
+
 typedef struct {
     ecs_sparse_t **sparse;
     ecs_entity_t *entities;
     int32_t cur;
+    int32_t end;                /* End of the iterated range in dense array */
     int8_t lead;
+
+    /* Worker partitioning of the dense array of the lead component. Set by
+     * worker iterators before iteration starts. */
+    int32_t worker_index;
+    int32_t worker_count;
+    int32_t *cursor;            /* Shared chunk counter (dynamic) */
+    int32_t chunk_size;
 } ecs_query_sparse_trivial_ctx_t;
 
 /* *From operator iterator context */
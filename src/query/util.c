@@ -308,6 +308,44 @@ void flecs_query_str_append_bitset(
     ecs_strbuf_list_pop(buf, "}");
 }
 
+/* Append the terms reordered by the cost based planner, in the order of their
+ * current estimated number of tables. */
+static
+void flecs_query_plan_cost(
+    const ecs_query_t *q,
+    ecs_strbuf_t *buf)
+{
+    int32_t i, j, count = 0, term_count = q->term_count;
+    int32_t cost[FLECS_TERM_COUNT_MAX], order[FLECS_TERM_COUNT_MAX];
+
+    for (i = 0; i < term_count; i ++) {
+        cost[i] = flecs_query_term_cost(q->real_world, q, &q->terms[i]);
+        if (cost[i] == -1) {
+            continue;
+        }
+
+        for (j = count; j > 0 && cost[order[j - 1]] > cost[i]; j --) {
+            order[j] = order[j - 1];
+        }
+
+        order[j] = i;
+        count ++;
+    }
+
+    if (!count) {
+        return;
+    }
+
+    ecs_strbuf_appendlit(buf, "#[normal]planned by cost (estimated tables):\n");
+    for (i = 0; i < count; i ++) {
+        const ecs_term_t *term = &q->terms[order[i]];
+        char *id_str = ecs_id_str(q->world, term->id);
+        ecs_strbuf_append(buf, "  #[yellow]%s#[reset] (%d)\n", 
+            id_str, cost[order[i]]);
+        ecs_os_free(id_str);
+    }
+}
+
 static
 void flecs_query_plan_w_profile(
     const ecs_query_t *q,
@@ -319,6 +357,9 @@ void flecs_query_plan_w_profile(
     int32_t i, count = impl->op_count, indent = 0;
     if (!count) {
         ecs_strbuf_append(buf, "");
+        if (q->flags & EcsQueryPlanByCost) {
+            flecs_query_plan_cost(q, buf);
+        }
         return; /* No plan */
     }
 
@@ -444,6 +485,10 @@ void flecs_query_plan_w_profile(
 
         ecs_strbuf_appendch(buf, '\n');
     }
+
+    if (q->flags & EcsQueryPlanByCost) {
+        flecs_query_plan_cost(q, buf);
+    }
 }
 
 char* ecs_query_plan_w_profile(
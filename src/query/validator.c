@@ -934,7 +934,13 @@ int flecs_term_finalize(
         if (ecs_id(EcsMember) != 0) {
             if (first_entity) {
                 if (ecs_has(world, first_entity, EcsMember)) {
-                    term->flags_ |= EcsTermIsMember;
+                    /* Members of SoA structs are components. They are only
+                     * matched as member when comparing the member value. */
+                    if (!ecs_has(world, first_entity, EcsComponent) || 
+                        ECS_TERM_REF_ID(second))
+                    {
+                        term->flags_ |= EcsTermIsMember;
+                    }
                 }
             }
         }
@@ -1321,6 +1327,10 @@ int flecs_query_finalize_terms(
             nodata_term = true;
         } else if (!ecs_get_type_info(world, term->id)) {
             nodata_term = true;
+        } else if (!ECS_IS_PAIR(term->id) && 
+            (flecs_component_get_flags(world, term->id) & EcsIdSoA)) 
+        {
+            nodata_term = true;
         } else if (term->flags_ & EcsTermIsMember) {
             nodata_term = true;
         } else if (scope_nesting) {
@@ -1828,6 +1838,11 @@ bool flecs_query_finalize_simple(
             type_info = flecs_determine_type_info_for_component(world, id);
         }
 
+        if (cr_flags & EcsIdSoA) {
+            /* Data of SoA component is stored in separate components */
+            type_info = NULL;
+        }
+
         bool cacheable = true, trivial = true;
 
         if (type_info) {
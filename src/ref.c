@@ -17,6 +17,11 @@ ecs_ref_t ecs_ref_init_id(
 
     world = ecs_get_world(world);
 
+    ecs_check(!(flecs_component_get_flags(world, id) & EcsIdSoA), 
+        ECS_INVALID_OPERATION, 
+        "cannot create ref for SoA component '%s' (use its members instead)",
+            flecs_errstr(ecs_id_str(world, id)));
+
     flecs_check_exclusive_world_access_read(world);
 
     ecs_record_t *record = flecs_entities_get(world, entity);
@@ -17,6 +17,112 @@
 
 #include "private_api.h"
 
+/* Number of reserved entity ids a stage claims at a time */
+#define FLECS_ENTITY_RESERVE_BLOCK (64)
+
+static
+void flecs_stage_commit_new_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    int32_t i, count = ecs_vec_count(&stage->new_ids);
+    ecs_entity_t *ids = ecs_vec_first_t(&stage->new_ids, ecs_entity_t);
+    for (i = 0; i < count; i ++) {
+        /* Entities created in multithreaded mode don't have a table yet. Add
+         * them to the root table before commands are merged, unless a command
+         * for the stage already deleted the entity. */
+        ecs_record_t *r = flecs_entities_try(world, ids[i]);
+        if (r && !r->table) {
+            flecs_add_to_root_table(world, ids[i]);
+        }
+    }
+
+    world->reserved_used += count;
+    ecs_vec_clear(&stage->new_ids);
+}
+
+/* Grow the entity index so that stages can claim ids without reallocating
+ * storage that other threads may be reading. */
+static
+void flecs_stage_reserve_ids(
+    ecs_world_t *world)
+{
+    int32_t count = world->reserved_count + 
+        ecs_get_stage_count(world) * FLECS_ENTITY_RESERVE_BLOCK;
+    flecs_entities_reserve(world, count, false);
+    world->reserved_used = 0;
+
+    if (!world->reserved_mutex && ecs_os_has_threading()) {
+        world->reserved_mutex = ecs_os_mutex_new();
+    }
+}
+
+static
+void flecs_stage_release_ids(
+    ecs_world_t *world)
+{
+    /* Release ids in reverse order, so that ids that weren't used are recycled
+     * in the same order as if they were never claimed. */
+    int32_t s, stage_count = ecs_get_stage_count(world);
+    for (s = stage_count - 1; s >= 0; s --) {
+        ecs_stage_t *stage = world->stages[s];
+        int32_t i, count = ecs_vec_count(&stage->reserved_ids);
+        ecs_entity_t *ids = ecs_vec_first_t(
+            &stage->reserved_ids, ecs_entity_t);
+        for (i = count - 1; i >= stage->reserved_cur; i --) {
+            flecs_entities_release(world, ids[i]);
+        }
+
+        ecs_vec_clear(&stage->reserved_ids);
+        stage->reserved_cur = 0;
+    }
+
+    flecs_entities_free_retired(world);
+
+    int32_t used = world->reserved_used * 2;
+    world->reserved_count = ECS_MAX(FLECS_ENTITY_RESERVE_COUNT, used);
+}
+
+/* Claim a block of ids from the entity index. Other threads may read the entity
+ * index at the same time, so its storage is grown without freeing arrays. */
+static
+void flecs_stage_claim_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (world->reserved_mutex) {
+        ecs_os_mutex_lock(world->reserved_mutex);
+    }
+
+    flecs_entities_reserve(world, FLECS_ENTITY_RESERVE_BLOCK, true);
+    const uint64_t *ids = flecs_entities_new_ids(
+        world, FLECS_ENTITY_RESERVE_BLOCK);
+
+    ecs_vec_set_count_t(&stage->allocator, &stage->reserved_ids, 
+        ecs_entity_t, FLECS_ENTITY_RESERVE_BLOCK);
+    ecs_os_memcpy_n(ecs_vec_first(&stage->reserved_ids), ids, 
+        ecs_entity_t, FLECS_ENTITY_RESERVE_BLOCK);
+    stage->reserved_cur = 0;
+
+    if (world->reserved_mutex) {
+        ecs_os_mutex_unlock(world->reserved_mutex);
+    }
+}
+
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (stage->reserved_cur == ecs_vec_count(&stage->reserved_ids)) {
+        flecs_stage_claim_ids(world, stage);
+    }
+
+    ecs_entity_t e = ecs_vec_get_t(&stage->reserved_ids, ecs_entity_t, 
+        stage->reserved_cur ++)[0];
+    ecs_vec_append_t(&stage->allocator, &stage->new_ids, ecs_entity_t)[0] = e;
+    return e;
+}
+
 static
 void flecs_stage_merge(
     ecs_world_t *world)
@@ -39,6 +145,7 @@ void flecs_stage_merge(
         /* Check for consistency when merging a single stage. */
         ecs_assert(stage->defer == 1, ECS_INVALID_OPERATION, 
             "mismatching defer_begin/defer_end detected");
+        flecs_stage_commit_new_ids(world, stage);
         flecs_defer_end(world, stage);
     } else {
         /* Merge all stages */
@@ -46,6 +153,7 @@ void flecs_stage_merge(
         for (i = 0; i < count; i ++) {
             ecs_stage_t *s = (ecs_stage_t*)ecs_get_stage(world, i);
             flecs_poly_assert(s, ecs_stage_t);
+            flecs_stage_commit_new_ids(world, s);
             flecs_defer_end(world, s);
         }
     }
@@ -109,6 +217,9 @@ ecs_stage_t* flecs_stage_new(
 
     ecs_allocator_t *a = &stage->allocator;
     ecs_vec_init_t(a, &stage->post_frame_actions, ecs_action_elem_t, 0);
+    ecs_vec_init_t(a, &stage->cmd_partitions, ecs_vec_t, 0);
+    ecs_vec_init_t(a, &stage->reserved_ids, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &stage->new_ids, ecs_entity_t, 0);
 
     int32_t i;
     for (i = 0; i < 2; i ++) {
@@ -134,6 +245,15 @@ void flecs_stage_free(
     
     ecs_vec_fini_t(a, &stage->post_frame_actions, ecs_action_elem_t);
     ecs_vec_fini(NULL, &stage->variables, 0);
+
+    int32_t p, p_count = ecs_vec_count(&stage->cmd_partitions);
+    ecs_vec_t *partitions = ecs_vec_first_t(&stage->cmd_partitions, ecs_vec_t);
+    for (p = 0; p < p_count; p ++) {
+        ecs_vec_fini_t(a, &partitions[p], int32_t);
+    }
+    ecs_vec_fini_t(a, &stage->cmd_partitions, ecs_vec_t);
+    ecs_vec_fini_t(a, &stage->reserved_ids, ecs_entity_t);
+    ecs_vec_fini_t(a, &stage->new_ids, ecs_entity_t);
     ecs_vec_fini(NULL, &stage->operations, 0);
 
     int32_t i;
@@ -312,6 +432,12 @@ bool ecs_readonly_begin(
 
     bool is_readonly = ECS_BIT_IS_SET(world->flags, EcsWorldReadonly);
 
+    /* Make room in the entity index for entities created by stages, so that
+     * claiming ids doesn't reallocate the entity index while it's shared. */
+    if (multi_threaded && !is_readonly) {
+        flecs_stage_reserve_ids(world);
+    }
+
     /* From this point on, the world is "locked" for mutations, and it is only 
      * allowed to enqueue commands from stages */
     ECS_BIT_SET(world->flags, EcsWorldReadonly);
@@ -334,10 +460,36 @@ void ecs_readonly_end(
     ecs_log_pop_3();
 
     flecs_stage_merge(world);
+    flecs_stage_release_ids(world);
 error:
     return;
 }
 
+void flecs_stage_job_begin(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i, count = ecs_get_stage_count(world);
+    for (i = 0; i < count; i ++) {
+        flecs_defer_begin(world, world->stages[i]);
+    }
+
+    flecs_stage_reserve_ids(world);
+
+    ECS_BIT_SET(world->flags, EcsWorldMultiThreaded);
+}
+
+void flecs_stage_job_end(
+    ecs_world_t *world)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ECS_BIT_CLEAR(world->flags, EcsWorldMultiThreaded);
+    flecs_stage_merge(world);
+    flecs_stage_release_ids(world);
+}
+
 ecs_world_t* flecs_suspend_readonly(
     const ecs_world_t *stage_world,
     ecs_suspend_readonly_state_t *state)
@@ -37,12 +37,22 @@ struct ecs_stage_t {
     ecs_commands_t *cmd;
     ecs_commands_t cmd_stack[2];     /* Two so we can flush one & populate the other */
     bool cmd_flushing;               /* Ensures only one defer_end call flushes */
+    bool cmd_merge_serial;           /* Queue can't be merged in parallel */
+    int32_t cmd_merged_count;        /* Commands merged in parallel by stage */
+    ecs_vec_t cmd_partitions;        /* vec<vec<int32_t>> commands by partition */
 
     /* Thread context */
     ecs_world_t *thread_ctx;         /* Points to stage when used as a thread stage */
     ecs_world_t *world;              /* Reference to world */
     ecs_os_thread_t thread;          /* Thread handle (0 if no threading is used) */
 
+    /* Block of entity ids claimed from the entity index to create entities in
+     * multithreaded mode, and entities created from them that must be added to
+     * the root table when the stage is merged. */
+    ecs_vec_t reserved_ids;
+    int32_t reserved_cur;
+    ecs_vec_t new_ids;
+
     /* One-shot actions to be executed after the merge */
     ecs_vec_t post_frame_actions;
 
@@ -79,6 +89,21 @@ ecs_entity_t flecs_stage_set_system(
     ecs_stage_t *stage,
     ecs_entity_t system);
 
+/* Defer operations on all stages and enter multithreaded mode, so that a job
+ * can invoke operations on the stages of worker threads while the world is not
+ * in readonly mode. */
+void flecs_stage_job_begin(
+    ecs_world_t *world);
+
+/* Leave multithreaded mode and merge the stages. */
+void flecs_stage_job_end(
+    ecs_world_t *world);
+
+/* Create entity id in multithreaded mode. */
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
 /* Get allocator from stage/world. */
 ecs_allocator_t* flecs_stage_get_allocator(
     ecs_world_t *world);
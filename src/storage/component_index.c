@@ -526,6 +526,7 @@ ecs_component_record_t* flecs_component_new(
         cr->pair = flecs_bcalloc_w_dbg_info(
             &world->allocators.pair_record, "ecs_pair_record_t");
         cr->pair->reachable.current = -1;
+        cr->pair->reachable.up_current = -1;
 
         rel = ECS_PAIR_FIRST(id);
         if (!is_value_pair) {
@@ -619,6 +620,11 @@ ecs_component_record_t* flecs_component_new(
         cr->flags |= flecs_component_get_flags_intern(
             world, id, rel, tgt, cr->type_info);
 
+        if (cr->flags & EcsIdSoA) {
+            /* Data of SoA components is stored in other components */
+            cr->type_info = NULL;
+        }
+
         /* Set flag that indicates entity is used as component/relationship. */
         flecs_add_flag(world, rel, EcsEntityIsId);
 
@@ -760,6 +766,8 @@ void flecs_component_free(
         flecs_name_index_free(cr->pair->name_index);
         ecs_vec_fini_t(&world->allocator, &cr->pair->reachable.ids, 
             ecs_reachable_elem_t);
+        ecs_vec_fini_t(&world->allocator, &cr->pair->reachable.up, 
+            ecs_reachable_up_t);
         flecs_bfree_w_dbg_info(&world->allocators.pair_record, 
                 cr->pair, "ecs_pair_record_t");
     }
@@ -871,6 +879,10 @@ bool flecs_component_set_type_info(
     ecs_component_record_t *cr,
     const ecs_type_info_t *ti)
 {
+    if (cr->flags & EcsIdSoA) {
+        ti = NULL;
+    }
+
     bool is_wildcard = ecs_id_is_wildcard(cr->id);
     if (!is_wildcard) {
         if (ti) {
@@ -21,10 +21,22 @@ typedef struct ecs_reachable_elem_t {
 #endif
 } ecs_reachable_elem_t;
 
+/* Source of a component found by up traversal, starting from the target of a
+ * pair record. */
+typedef struct ecs_reachable_up_t {
+    ecs_id_t with;                  /* Component that was searched for */
+    ecs_id_t rel;                   /* Traversed relationship, (R, *) */
+    ecs_entity_t src;               /* Entity with component, 0 if not found */
+    ecs_id_t id;                    /* Matched id on source */
+    ecs_table_record_t *tr;         /* Table record of id in source table */
+} ecs_reachable_up_t;
+
 typedef struct ecs_reachable_cache_t {
     int32_t generation;
     int32_t current;
+    int32_t up_current;             /* Generation for which up index is valid */
     ecs_vec_t ids; /* vec<reachable_elem_t> */
+    ecs_vec_t up;  /* vec<reachable_up_t> */
 } ecs_reachable_cache_t;
 
 /* Component index data that just applies to pairs */
@@ -38,6 +38,7 @@ void flecs_entity_index_init(
     ecs_vec_set_count_t(allocator, &index->dense, uint64_t, 1);
     ecs_vec_init_t(allocator, &index->pages, ecs_entity_index_page_t*, 0);
     ecs_vec_init_t(allocator, &index->ranges, ecs_entity_range_t*, 0);
+    ecs_vec_init_t(NULL, &index->retired, ecs_entity_index_retired_t, 0);
 }
 
 void flecs_entity_index_fini(
@@ -51,6 +52,9 @@ void flecs_entity_index_fini(
     }
     ecs_vec_fini_t(index->allocator, &index->pages, ecs_entity_index_page_t*);
 
+    flecs_entity_index_free_retired(index);
+    ecs_vec_fini_t(NULL, &index->retired, ecs_entity_index_retired_t);
+
     /* Free entity id ranges */
     {
         int32_t r, range_count = ecs_vec_count(&index->ranges);
@@ -113,6 +117,23 @@ ecs_record_t* flecs_entity_index_try_get_any(
     return r;
 }
 
+void flecs_entity_index_prefetch(
+    const ecs_entity_index_t *index,
+    uint64_t entity)
+{
+    uint32_t id = (uint32_t)entity;
+    int32_t page_index = (int32_t)(id >> FLECS_ENTITY_PAGE_BITS);
+    if (page_index >= ecs_vec_count(&index->pages)) {
+        return;
+    }
+
+    ecs_entity_index_page_t *page = ecs_vec_get_t(&index->pages,
+        ecs_entity_index_page_t*, page_index)[0];
+    if (page) {
+        flecs_prefetch(&page->records[id & FLECS_ENTITY_PAGE_MASK]);
+    }
+}
+
 ecs_record_t* flecs_entity_index_try_get(
     const ecs_entity_index_t *index,
     uint64_t entity)
@@ -223,7 +244,8 @@ ecs_entity_range_t* flecs_entity_index_find_range(
 static
 ecs_record_t* flecs_entity_index_remove_intern(
     ecs_entity_index_t *index,
-    uint64_t entity)
+    uint64_t entity,
+    bool inc_generation)
 {
     ecs_record_t *r = flecs_entity_index_try_get(index, entity);
     if (!r) {
@@ -242,7 +264,7 @@ ecs_record_t* flecs_entity_index_remove_intern(
     r->row = 0;
     r->dense = i_swap;
     ecs_vec_get_t(&index->dense, uint64_t, dense)[0] = e_swap;
-    e_swap_ptr[0] = ECS_GENERATION_INC(entity);
+    e_swap_ptr[0] = inc_generation ? ECS_GENERATION_INC(entity) : entity;
 
     ecs_assert(!flecs_entity_index_is_alive(index, entity),
         ECS_INTERNAL_ERROR, NULL);
@@ -254,7 +276,7 @@ void flecs_entity_index_remove(
     ecs_entity_index_t *index,
     uint64_t entity)
 {
-    ecs_record_t *r = flecs_entity_index_remove_intern(index, entity);
+    ecs_record_t *r = flecs_entity_index_remove_intern(index, entity, true);
     if (!r) {
         /* Entity was not alive, nothing else to be done. */
         return;
@@ -285,6 +307,13 @@ void flecs_entity_index_remove(
     }
 }
 
+void flecs_entity_index_release(
+    ecs_entity_index_t *index,
+    uint64_t entity)
+{
+    flecs_entity_index_remove_intern(index, entity, false);
+}
+
 void flecs_entity_index_set_range(
     ecs_entity_index_t *index,
     ecs_entity_range_t *range)
@@ -500,6 +529,65 @@ uint64_t* flecs_entity_index_new_ids(
     return ecs_vec_get_t(&index->dense, uint64_t, alive_count);
 }
 
+static
+void flecs_entity_index_grow(
+    ecs_entity_index_t *index,
+    ecs_vec_t *vec,
+    ecs_size_t elem_size,
+    int32_t elem_count,
+    bool shared)
+{
+    if (ecs_vec_size(vec) >= elem_count) {
+        return;
+    }
+
+    if (!shared) {
+        ecs_vec_set_min_size(index->allocator, vec, elem_size, elem_count);
+        return;
+    }
+
+    /* Other threads may be reading the array, so don't free it until the
+     * index is no longer shared. */
+    ecs_vec_t copy = ecs_vec_copy(index->allocator, vec, elem_size);
+    ecs_vec_set_min_size(index->allocator, &copy, elem_size, elem_count);
+
+    if (vec->array) {
+        ecs_entity_index_retired_t *retired = ecs_vec_append_t(
+            NULL, &index->retired, ecs_entity_index_retired_t);
+        retired->array = vec->array;
+        retired->size = elem_size * vec->size;
+    }
+
+    vec->size = copy.size;
+    vec->array = copy.array;
+}
+
+void flecs_entity_index_reserve(
+    ecs_entity_index_t *index,
+    int32_t count,
+    bool shared)
+{
+    flecs_entity_index_grow(index, &index->dense, ECS_SIZEOF(uint64_t), 
+        index->alive_count + count, shared);
+
+    uint64_t max_id = (uint64_t)index->max_id + flecs_ito(uint64_t, count);
+    max_id = ECS_MIN(max_id, UINT32_MAX);
+    flecs_entity_index_grow(index, &index->pages, 
+        ECS_SIZEOF(ecs_entity_index_page_t*), 
+        (int32_t)(max_id >> FLECS_ENTITY_PAGE_BITS) + 1, shared);
+}
+
+void flecs_entity_index_free_retired(
+    ecs_entity_index_t *index)
+{
+    int32_t i, count = ecs_vec_count(&index->retired);
+    ecs_entity_index_retired_t *retired = ecs_vec_first(&index->retired);
+    for (i = 0; i < count; i ++) {
+        flecs_free(index->allocator, retired[i].size, retired[i].array);
+    }
+    ecs_vec_clear(&index->retired);
+}
+
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
     int32_t size)
@@ -15,9 +15,16 @@ typedef struct ecs_entity_index_page_t {
     ecs_record_t records[FLECS_ENTITY_PAGE_SIZE];
 } ecs_entity_index_page_t;
 
+/* Array that was replaced while the index was shared between threads */
+typedef struct ecs_entity_index_retired_t {
+    void *array;
+    ecs_size_t size;                 /* Size of array in bytes */
+} ecs_entity_index_retired_t;
+
 typedef struct ecs_entity_index_t {
     ecs_vec_t dense;
     ecs_vec_t pages;
+    ecs_vec_t retired;               /* vec<ecs_entity_index_retired_t> */
     ecs_vec_t ranges;                /* vec<ecs_entity_range_t*> - sorted by min */
     ecs_entity_range_t *active_range;       /* Currently active range (NULL = off) */
     int32_t alive_count;
@@ -64,6 +71,17 @@ void flecs_entity_index_remove(
     ecs_entity_index_t *index,
     uint64_t entity);
 
+/* Make entity not alive without increasing its generation. Used for ids that
+ * were made alive, but that were never handed out to the application. */
+void flecs_entity_index_release(
+    ecs_entity_index_t *index,
+    uint64_t entity);
+
+/* Prefetch record for entity, if it exists */
+void flecs_entity_index_prefetch(
+    const ecs_entity_index_t *index,
+    uint64_t entity);
+
 /* Make entity alive */
 void flecs_entity_index_make_alive(
     ecs_entity_index_t *index,
@@ -98,6 +116,19 @@ uint64_t* flecs_entity_index_new_ids(
     ecs_entity_index_t *index,
     int32_t count);
 
+/* Grow index so that count ids can be created without reallocating the
+ * dense and page arrays. When shared is true, other threads may be reading the
+ * index, and arrays are copied instead of reallocated. The old arrays are freed
+ * by flecs_entity_index_free_retired(). */
+void flecs_entity_index_reserve(
+    ecs_entity_index_t *index,
+    int32_t count,
+    bool shared);
+
+/* Free arrays that were replaced while the index was shared */
+void flecs_entity_index_free_retired(
+    ecs_entity_index_t *index);
+
 /* Set size of index */
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
@@ -146,6 +177,8 @@ const uint64_t* flecs_entity_index_ids(
 #define flecs_entities_get_any(world, entity) flecs_entity_index_get_any(ecs_eis(world), entity)
 #define flecs_entities_ensure(world, entity) flecs_entity_index_ensure(ecs_eis(world), entity)
 #define flecs_entities_remove(world, entity) flecs_entity_index_remove(ecs_eis(world), entity)
+#define flecs_entities_prefetch(world, entity) flecs_entity_index_prefetch(ecs_eis(world), entity)
+#define flecs_entities_release(world, entity) flecs_entity_index_release(ecs_eis(world), entity)
 #define flecs_entities_make_alive(world, entity) flecs_entity_index_make_alive(ecs_eis(world), entity)
 #define flecs_entities_get_alive(world, entity) flecs_entity_index_get_alive(ecs_eis(world), entity)
 #define flecs_entities_is_alive(world, entity) flecs_entity_index_is_alive(ecs_eis(world), entity)
@@ -153,6 +186,8 @@ const uint64_t* flecs_entity_index_ids(
 #define flecs_entities_exists(world, entity) flecs_entity_index_exists(ecs_eis(world), entity)
 #define flecs_entities_new_id(world) flecs_entity_index_new_id(ecs_eis(world))
 #define flecs_entities_new_ids(world, count) flecs_entity_index_new_ids(ecs_eis(world), count)
+#define flecs_entities_reserve(world, count, shared) flecs_entity_index_reserve(ecs_eis(world), count, shared)
+#define flecs_entities_free_retired(world) flecs_entity_index_free_retired(ecs_eis(world))
 #define flecs_entities_max_id(world) (ecs_eis(world)->max_id)
 #define flecs_entities_set_size(world, size) flecs_entity_index_set_size(ecs_eis(world), size)
 #define flecs_entities_count(world) flecs_entity_index_count(ecs_eis(world))
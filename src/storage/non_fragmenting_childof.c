@@ -275,6 +275,14 @@ void flecs_on_replace_parent(ecs_iter_t *it) {
             flecs_update_component_monitors(world, 
                 &(ecs_type_t){ .count = 1, .array = &added },
                 &(ecs_type_t) { .count = 1, .array = &removed });
+
+            /* Entity didn't change tables, so reachable caches of its subtree
+             * aren't invalidated by the table move. */
+            ecs_component_record_t *cr_t = flecs_components_get(
+                world, ecs_pair(EcsWildcard, e));
+            if (cr_t) {
+                flecs_emit_propagate_invalidate_tables(world, cr_t);
+            }
         }
 
         flecs_journal_end();
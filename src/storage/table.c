@@ -21,6 +21,142 @@
 
 const int16_t flecs_table_empty_component_map[FLECS_HI_COMPONENT_ID] = {0};
 
+/* Alignment that is assumed to be guaranteed by ecs_os_malloc(). */
+#define FLECS_TABLE_MALLOC_ALIGN (2 * ECS_SIZEOF(void*))
+
+/* Get alignment of column storage. Returns 0 if the storage can be allocated
+ * with ecs_os_malloc(), which is the case for most columns. A column requires
+ * aligned storage when its component has a large alignment, or when the world
+ * had a column alignment configured when the table was created. */
+static
+int32_t flecs_table_column_align(
+    const ecs_table_t *table,
+    const ecs_type_info_t *ti)
+{
+    int32_t align = table->_->column_alignment;
+    if (ti->alignment > align) {
+        align = ti->alignment;
+    }
+
+    if (align <= FLECS_TABLE_MALLOC_ALIGN) {
+        return 0;
+    }
+
+    return align;
+}
+
+/* Allocate column storage. Aligned storage is over-allocated, and stores the
+ * pointer returned by ecs_os_malloc() right before the column array. The size
+ * is padded to a multiple of the alignment so that vector loads for the last
+ * elements in a column never read past the end of the allocation. */
+static
+void* flecs_table_column_alloc(
+    ecs_size_t size,
+    int32_t align)
+{
+    if (!align) {
+        return ecs_os_malloc(size);
+    }
+
+    ecs_assert(!(align & (align - 1)), ECS_INTERNAL_ERROR, NULL);
+
+    size = ECS_ALIGN(size, align);
+    char *ptr = ecs_os_malloc(size + align + ECS_SIZEOF(void*));
+    uintptr_t addr = (uintptr_t)(ptr + ECS_SIZEOF(void*));
+    addr = (addr + flecs_ito(uintptr_t, align - 1)) &
+        ~flecs_ito(uintptr_t, align - 1);
+
+    void **result = (void**)addr;
+    result[-1] = ptr;
+    return result;
+}
+
+static
+void flecs_table_column_free(
+    void *ptr,
+    int32_t align)
+{
+    if (ptr && align) {
+        ptr = ((void**)ptr)[-1];
+    }
+    ecs_os_free(ptr);
+}
+
+/* Same as ecs_vec_init(), but for column storage. */
+static
+void flecs_table_column_init(
+    ecs_vec_t *v,
+    ecs_size_t elem_size,
+    int32_t align,
+    int32_t elem_count)
+{
+    if (!align) {
+        ecs_vec_init(NULL, v, elem_size, elem_count);
+        return;
+    }
+
+    ecs_vec_init(NULL, v, elem_size, 0);
+    if (elem_count) {
+        v->array = flecs_table_column_alloc(elem_size * elem_count, align);
+        v->size = elem_count;
+    }
+}
+
+/* Same as ecs_vec_fini(), but for column storage. */
+static
+void flecs_table_column_fini(
+    ecs_vec_t *v,
+    ecs_size_t elem_size,
+    int32_t align)
+{
+    if (!align) {
+        ecs_vec_fini(NULL, v, elem_size);
+        return;
+    }
+
+    flecs_table_column_free(v->array, align);
+    v->array = NULL;
+    v->count = 0;
+    v->size = 0;
+}
+
+/* Same as ecs_vec_set_size(), but for column storage. */
+static
+void flecs_table_column_set_size(
+    ecs_vec_t *v,
+    ecs_size_t elem_size,
+    int32_t align,
+    int32_t elem_count)
+{
+    if (!align) {
+        ecs_vec_set_size(NULL, v, elem_size, elem_count);
+        return;
+    }
+
+    if (v->size == elem_count) {
+        return;
+    }
+
+    if (elem_count < v->count) {
+        elem_count = v->count;
+    }
+
+    elem_count = flecs_next_pow_of_2(elem_count);
+    if (elem_count < 2) {
+        elem_count = 2;
+    }
+
+    if (elem_count != v->size) {
+        void *array = flecs_table_column_alloc(elem_size * elem_count, align);
+        if (v->count) {
+            ecs_os_memcpy(array, v->array, elem_size * v->count);
+        }
+        flecs_table_column_free(v->array, align);
+        v->array = array;
+        v->size = elem_count;
+    }
+}
+
 /* Table sanity check to detect storage issues. Only enabled in SANITIZE mode as
  * this can severely slow down many ECS operations. */
 #ifdef FLECS_SANITIZE
@@ -59,8 +195,12 @@ void flecs_table_check_sanity(
             ecs_assert(table->data.columns[i].ti != NULL,
                 ECS_INTERNAL_ERROR, NULL);
             if (size) {
-                ecs_assert(table->data.columns[i].data != NULL, 
+                ecs_assert(table->data.columns[i].data != NULL,
                     ECS_INTERNAL_ERROR, NULL);
+                int32_t align = flecs_table_column_align(
+                    table, table->data.columns[i].ti);
+                ecs_assert(!align || !((uintptr_t)table->data.columns[i].data
+                    % flecs_ito(uintptr_t, align)), ECS_INTERNAL_ERROR, NULL);
             } else {
                 ecs_assert(table->data.columns[i].data == NULL, 
                     ECS_INTERNAL_ERROR, NULL);
@@ -310,6 +450,10 @@ void flecs_table_init_flags(
             table->trait_flags |= EcsIdSparse;
         } else if (id == EcsDontFragment) {
             table->trait_flags |= EcsIdDontFragment;
+        } else if (id == EcsSoA) {
+            table->trait_flags |= EcsIdSoA;
+        } else if (id == EcsDenseToggle) {
+            table->trait_flags |= EcsIdDenseToggle;
         } else if (id ==  EcsExclusive) {
             table->trait_flags |= EcsIdExclusive;   
         } else if (id == EcsTraversable) {
@@ -367,6 +511,17 @@ void flecs_table_init_flags(
                 if (!meta->bs_count) {
                     meta->bs_offset = flecs_ito(int16_t, i);
                 }
+
+                /* Rows are partitioned on the first dense toggle component.
+                 * Other dense toggle components use regular bitset toggles. */
+                if (!(table->flags & EcsTableHasDenseToggle) &&
+                    (flecs_component_get_flags(world, id & ECS_COMPONENT_MASK) 
+                        & EcsIdDenseToggle))
+                {
+                    table->flags |= EcsTableHasDenseToggle;
+                    meta->dense_toggle = meta->bs_count;
+                }
+
                 meta->bs_count ++;
             }
             if (ECS_HAS_ID_FLAG(id, AUTO_OVERRIDE)) {
@@ -560,6 +715,9 @@ void flecs_table_init(
     /* Make sure table->flags is initialized */
     flecs_table_init_flags(world, table);
 
+    /* Column alignment can't change for the lifetime of the table */
+    table->_->column_alignment = flecs_ito(int16_t, world->column_alignment);
+
     /* The following code walks the table type to discover which id records the
      * table needs to register table records with. 
      *
@@ -1186,7 +1344,8 @@ void flecs_table_fini_data(
             for (c = 0; c < column_count; c ++) {
                 ecs_column_t *column = &columns[c];
                 ecs_vec_t v = ecs_vec_from_column(column, table, column->ti->size);
-                ecs_vec_fini(NULL, &v, column->ti->size);
+                flecs_table_column_fini(&v, column->ti->size,
+                    flecs_table_column_align(table, column->ti));
                 column->data = NULL;
             }
 
@@ -1230,6 +1389,7 @@ void flecs_table_fini_data(
 
     table->data.count = 0;
     table->_->traversable_count = 0;
+    table->_->dense_toggle_count = 0;
     table->flags &= ~EcsTableHasTraversable;
     table->flags |= EcsTableEmpty;
     table->flags &= ~EcsTableNotEmpty;
@@ -1544,6 +1704,7 @@ void flecs_table_grow_column(
     int32_t column_index,
     ecs_vec_t *column,
     const ecs_type_info_t *ti,
+    int32_t align,
     int32_t to_add,
     int32_t dst_size,
     bool construct)
@@ -1565,7 +1726,7 @@ void flecs_table_grow_column(
 
         /* Create vector */
         ecs_vec_t dst;
-        ecs_vec_init(NULL, &dst, elem_size, dst_size);
+        flecs_table_column_init(&dst, elem_size, align, dst_size);
         dst.count = dst_count;
 
         void *src_buffer = column->array;
@@ -1581,13 +1742,13 @@ void flecs_table_grow_column(
         }
 
         /* Free old vector */
-        ecs_vec_fini(NULL, column, elem_size);
+        flecs_table_column_fini(column, elem_size, align);
 
         *column = dst;
     } else {
         /* If array won't realloc or has no move, simply add new elements */
         if (can_realloc) {
-            ecs_vec_set_size(NULL, column, elem_size, dst_size);
+            flecs_table_column_set_size(column, elem_size, align, dst_size);
         }
 
         ecs_vec_grow(NULL, column, elem_size, to_add);
@@ -1608,7 +1769,8 @@ int32_t flecs_table_grow_data(
     ecs_table_t *table,
     int32_t to_add,
     int32_t size,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     flecs_poly_assert(world, ecs_world_t);
 
@@ -1662,13 +1824,14 @@ int32_t flecs_table_grow_data(
         ecs_column_t *column = &columns[i];
         const ecs_type_info_t *ti = column->ti;
         ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, to_add, size, true);
+        flecs_table_grow_column(world, table, i, &v_column, ti,
+            flecs_table_column_align(table, ti), to_add, size, construct);
         ecs_assert(v_column.size == size, ECS_INTERNAL_ERROR, NULL);
         ecs_assert(v_column.size == v_entities.size, ECS_INTERNAL_ERROR, NULL);
         ecs_assert(v_column.count == v_entities.count, ECS_INTERNAL_ERROR, NULL);
         column->data = v_column.array;
 
-        if (to_add) {
+        if (to_add && construct) {
             flecs_table_invoke_add_hooks(
                 world, table, i, e, count, to_add, false);
         }
@@ -1738,7 +1901,10 @@ void flecs_table_fast_append(
         ecs_column_t *column = &columns[i];
         const ecs_type_info_t *ti = column->ti;
         ecs_vec_t v = ecs_vec_from_column(column, table, ti->size);
-        ecs_vec_append(NULL, &v, ti->size);
+        if (v.count == v.size) {
+            flecs_table_column_set_size(&v, ti->size,
+                flecs_table_column_align(table, ti), v.count + 1);
+        }
         column->data = v.array;
     }
 }
@@ -1809,7 +1975,8 @@ void flecs_table_append(
         ecs_column_t *column = &columns[i];
         const ecs_type_info_t *ti = column->ti;
         ecs_vec_t v_column = ecs_vec_from_column_ext(column, prev_count, prev_size, ti->size);
-        flecs_table_grow_column(world, table, i, &v_column, ti, 1, size, construct);
+        flecs_table_grow_column(world, table, i, &v_column, ti,
+            flecs_table_column_align(table, ti), 1, size, construct);
         column->data = v_column.array;
 
         ecs_iter_action_t on_add_hook;
@@ -1874,6 +2041,10 @@ void flecs_table_delete(
     count --;
     ecs_assert(row <= count, ECS_INTERNAL_ERROR, NULL);
 
+    if (table->flags & EcsTableHasDenseToggle) {
+        row = flecs_table_dense_toggle_delete(world, table, row);
+    }
+
     /* Move last entity id to row */
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t entity_to_move = entities[count];
@@ -2110,7 +2281,8 @@ int32_t flecs_table_appendn(
     ecs_world_t *world,
     ecs_table_t *table,
     int32_t to_add,
-    const ecs_entity_t *ids)
+    const ecs_entity_t *ids,
+    bool construct)
 {
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table bulk append"));
@@ -2126,20 +2298,44 @@ int32_t flecs_table_appendn(
     flecs_table_check_sanity(table);
     int32_t cur_count = ecs_table_count(table);
     int32_t result = flecs_table_grow_data(
-        world, table, to_add, cur_count + to_add, ids);
+        world, table, to_add, cur_count + to_add, ids, construct);
     flecs_table_check_sanity(table);
 
     return result;
 }
 
+/* Invoke OnAdd hooks for elements appended without constructing them */
+void flecs_table_invoke_on_add(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count)
+{
+    ecs_entity_t *entities = &table->data.entities[row];
+    int32_t i, column_count = table->column_count;
+    for (i = 0; i < column_count; i ++) {
+        flecs_table_invoke_add_hooks(
+            world, table, i, entities, row, count, false);
+    }
+}
+
 /* Shrink table storage to fit number of entities */
 bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table)
+{
+    return flecs_table_shrink_to(world, table, table->data.count);
+}
+
+bool flecs_table_shrink_to(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size)
 {
     ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
         FLECS_LOCKED_STORAGE_MSG("table shrink"));
+    ecs_assert(size >= table->data.count, ECS_INTERNAL_ERROR, NULL);
     (void)world;
 
     flecs_table_check_sanity(table);
@@ -2147,16 +2343,16 @@ bool flecs_table_shrink(
     bool has_payload = table->data.entities != NULL;
 
     int32_t count = table->data.count;
-    if (count == table->data.size) {
+    if (size >= table->data.size) {
         return has_payload;
     }
 
     ecs_column_t *columns = table->data.columns;
     ecs_entity_t *entities = table->data.entities;
 
-    if (count) {
+    if (size) {
         ecs_assert(table->data.entities != NULL, ECS_INTERNAL_ERROR, NULL);
-        table->data.entities = ecs_os_malloc_n(ecs_entity_t, count);
+        table->data.entities = ecs_os_malloc_n(ecs_entity_t, size);
         ecs_os_memcpy_n(table->data.entities, entities, ecs_entity_t, count);
     } else {
         table->data.entities = NULL;
@@ -2170,17 +2366,20 @@ bool flecs_table_shrink(
         ecs_size_t component_size = ti->size;
         void *data = columns[i].data;
 
-        if (count) {
-            columns[i].data = ecs_os_malloc(component_size * count);
+        int32_t align = flecs_table_column_align(table, ti);
+
+        if (size) {
+            columns[i].data = flecs_table_column_alloc(
+                component_size * size, align);
             flecs_type_info_ctor_move_dtor(columns[i].data, data, count, ti);
         } else {
             columns[i].data = NULL;
         }
 
-        ecs_os_free(data);
+        flecs_table_column_free(data, align);
     }
 
-    table->data.size = count;
+    table->data.size = size;
 
     flecs_table_mark_table_dirty(world, table, 0);
 
@@ -2209,55 +2408,23 @@ void flecs_table_swap_bitset_columns(
     }
 }
 
-/* Swap two rows in a table. Used for table sorting. */
+/* Swap entity ids, toggle bits and component values of two rows, without
+ * updating the entity records. */
 static
-void flecs_table_swap(
-    ecs_world_t *world,
+void flecs_table_swap_data(
     ecs_table_t *table,
     int32_t row_1,
     int32_t row_2)
-{    
-    (void)world;
-
-    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
-        FLECS_LOCKED_STORAGE_MSG("table swap"));
-    ecs_assert(row_1 >= 0, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(row_2 >= 0, ECS_INTERNAL_ERROR, NULL);
-
-    flecs_table_check_sanity(table);
-    
-    if (row_1 == row_2) {
-        return;
-    }
-
-    /* If the table is monitored, indicate that there has been a change */
-    flecs_table_mark_table_dirty(world, table, 0);    
-
+{
     ecs_entity_t *entities = table->data.entities;
     ecs_entity_t e1 = entities[row_1];
-    ecs_entity_t e2 = entities[row_2];
-
-    ecs_record_t *record_ptr_1 = flecs_entities_get(world, e1);
-    ecs_record_t *record_ptr_2 = flecs_entities_get(world, e2);
-
-    ecs_assert(record_ptr_1 != NULL, ECS_INTERNAL_ERROR, NULL);
-    ecs_assert(record_ptr_2 != NULL, ECS_INTERNAL_ERROR, NULL);
-
-    /* Keep track of row flags */
-    uint32_t flags_1 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_1->row);
-    uint32_t flags_2 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_2->row);
-
-    /* Swap entities & records */
-    entities[row_1] = e2;
+    entities[row_1] = entities[row_2];
     entities[row_2] = e1;
-    record_ptr_1->row = ECS_ROW_TO_RECORD(row_2, flags_1);
-    record_ptr_2->row = ECS_ROW_TO_RECORD(row_1, flags_2);
 
     flecs_table_swap_bitset_columns(table, row_1, row_2);
 
     ecs_column_t *columns = table->data.columns;
     if (!columns) {
-        flecs_table_check_sanity(table);
         return;
     }
 
@@ -2294,10 +2461,135 @@ void flecs_table_swap(
             flecs_type_info_move_dtor(el_2, tmp, 1, ti);
         }
     }
+}
+
+/* Swap two rows in a table. Used for table sorting. */
+static
+void flecs_table_swap(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row_1,
+    int32_t row_2)
+{    
+    (void)world;
+
+    ecs_assert(!table->_->lock, ECS_LOCKED_STORAGE, 
+        FLECS_LOCKED_STORAGE_MSG("table swap"));
+    ecs_assert(row_1 >= 0, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(row_2 >= 0, ECS_INTERNAL_ERROR, NULL);
+
+    flecs_table_check_sanity(table);
+    
+    if (row_1 == row_2) {
+        return;
+    }
+
+    /* If the table is monitored, indicate that there has been a change */
+    flecs_table_mark_table_dirty(world, table, 0);    
+
+    ecs_entity_t *entities = table->data.entities;
+    ecs_record_t *record_ptr_1 = flecs_entities_get(world, entities[row_1]);
+    ecs_record_t *record_ptr_2 = flecs_entities_get(world, entities[row_2]);
+
+    ecs_assert(record_ptr_1 != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(record_ptr_2 != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    /* Keep track of row flags */
+    uint32_t flags_1 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_1->row);
+    uint32_t flags_2 = ECS_RECORD_TO_ROW_FLAGS(record_ptr_2->row);
+
+    record_ptr_1->row = ECS_ROW_TO_RECORD(row_2, flags_1);
+    record_ptr_2->row = ECS_ROW_TO_RECORD(row_1, flags_2);
+
+    flecs_table_swap_data(table, row_1, row_2);
 
     flecs_table_check_sanity(table);
 }
 
+/* Partition all rows of a table on its dense toggle */
+static
+void flecs_table_dense_toggle_partition(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    ecs_table__t *meta = table->_;
+    ecs_bitset_t *bs = &meta->bs_columns[meta->dense_toggle];
+    int32_t first = 0, last = ecs_table_count(table) - 1;
+
+    while (first <= last) {
+        if (flecs_bitset_get(bs, first)) {
+            first ++;
+        } else if (!flecs_bitset_get(bs, last)) {
+            last --;
+        } else {
+            flecs_table_swap(world, table, first, last);
+        }
+    }
+
+    meta->dense_toggle_count = first;
+}
+
+void flecs_table_dense_toggle_sync(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row)
+{
+    if (!(table->flags & EcsTableHasDenseToggle)) {
+        return;
+    }
+
+    ecs_table__t *meta = table->_;
+    if (meta->dense_toggle_count == -1) {
+        flecs_table_dense_toggle_partition(world, table);
+        return;
+    }
+
+    ecs_bitset_t *bs = &meta->bs_columns[meta->dense_toggle];
+    int32_t enabled = meta->dense_toggle_count;
+    if (flecs_bitset_get(bs, row)) {
+        if (row >= enabled) {
+            flecs_table_swap(world, table, row, enabled);
+            meta->dense_toggle_count ++;
+        }
+    } else if (row < enabled) {
+        enabled = -- meta->dense_toggle_count;
+        flecs_table_swap(world, table, row, enabled);
+    }
+}
+
+void flecs_table_dense_toggle_invalidate(
+    ecs_table_t *table)
+{
+    if (table->flags & EcsTableHasDenseToggle) {
+        table->_->dense_toggle_count = -1;
+    }
+}
+
+int32_t flecs_table_dense_toggle_delete(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row)
+{
+    ecs_table__t *meta = table->_;
+    if (row >= meta->dense_toggle_count) {
+        /* Row is disabled, or rows are not partitioned */
+        return row;
+    }
+
+    /* Move the last enabled row to the deleted row, so the deleted row becomes
+     * the first disabled row. The record of the deleted entity is not updated,
+     * as it may already point to another table. */
+    int32_t last = -- meta->dense_toggle_count;
+    if (row != last) {
+        ecs_record_t *r = flecs_entities_get(world, table->data.entities[last]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        r->row = ECS_ROW_TO_RECORD(row, ECS_RECORD_TO_ROW_FLAGS(r->row));
+        flecs_table_swap_data(table, row, last);
+    }
+
+    return last;
+}
+
 static
 void flecs_table_merge_vec(
     ecs_vec_t *dst,
@@ -2337,6 +2629,8 @@ void flecs_table_merge_column(
     ecs_vec_t *src_vec,
     ecs_column_t *dst,
     ecs_column_t *src,
+    int32_t dst_align,
+    int32_t src_align,
     int32_t column_size)
 {
     const ecs_type_info_t *ti = dst->ti;
@@ -2344,8 +2638,9 @@ void flecs_table_merge_column(
     ecs_size_t elem_size = ti->size;
     int32_t dst_count = ecs_vec_count(dst_vec);
 
-    if (!dst_count) {
-        ecs_vec_fini(NULL, dst_vec, elem_size);
+    /* Storage can only be moved if both columns use the same alignment */
+    if (!dst_count && dst_align == src_align) {
+        flecs_table_column_fini(dst_vec, elem_size, dst_align);
         *dst_vec = *src_vec;
 
     /* If the new table is not empty, move the contents from the
@@ -2353,7 +2648,8 @@ void flecs_table_merge_column(
     } else {
         int32_t src_count = src_vec->count;
 
-        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, src_count, column_size, false);
+        flecs_table_grow_column(world, NULL, -1, dst_vec, ti, dst_align, 
+            src_count, column_size, false);
         void *dst_ptr = ECS_ELEM(dst_vec->array, elem_size, dst_count);
         void *src_ptr = src_vec->array;
 
@@ -2361,7 +2657,7 @@ void flecs_table_merge_column(
         ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
         flecs_type_info_ctor_move_dtor(dst_ptr, src_ptr, src_count, ti);
 
-        ecs_vec_fini(NULL, src_vec, elem_size);
+        flecs_table_column_fini(src_vec, elem_size, src_align);
     }
 
     dst->data = dst_vec->array;
@@ -2412,20 +2708,25 @@ void flecs_table_merge_data(
 
         if (dst_id == src_id) {
             flecs_table_merge_column(world, &dst_vec, &src_vec, dst_column, 
-                src_column, column_size);
+                src_column, flecs_table_column_align(dst_table, dst_column->ti),
+                flecs_table_column_align(src_table, src_column->ti),
+                column_size);
             flecs_table_mark_table_dirty(world, dst_table, i_new + 1);
             i_new ++;
             i_old ++;
         } else if (dst_id < src_id) {
             /* New column, make sure vector is large enough. */
-            ecs_vec_set_size(NULL, &dst_vec, dst_elem_size, column_size);
+            flecs_table_column_set_size(&dst_vec, dst_elem_size, 
+                flecs_table_column_align(dst_table, dst_column->ti),
+                column_size);
             dst_column->data = dst_vec.array;
             flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
             i_new ++;
         } else if (dst_id > src_id) {
             /* Old column does not occur in new table, destruct */
             flecs_table_invoke_dtor(src_column, 0, src_count);
-            ecs_vec_fini(NULL, &src_vec, src_elem_size);
+            flecs_table_column_fini(&src_vec, src_elem_size, 
+                flecs_table_column_align(src_table, src_column->ti));
             src_column->data = NULL;
             i_old ++;
         }
@@ -2440,7 +2741,8 @@ void flecs_table_merge_data(
         int32_t elem_size = column->ti->size;
         ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
         ecs_vec_t vec = ecs_vec_from_column(column, dst_table, elem_size);
-        ecs_vec_set_size(NULL, &vec, elem_size, column_size);
+        flecs_table_column_set_size(&vec, elem_size, 
+            flecs_table_column_align(dst_table, column->ti), column_size);
         column->data = vec.array;
         flecs_table_invoke_ctor(world, dst_table, i_new, dst_count, src_count);
     }
@@ -2452,7 +2754,8 @@ void flecs_table_merge_data(
         ecs_assert(elem_size != 0, ECS_INTERNAL_ERROR, NULL);
         flecs_table_invoke_dtor(column, 0, src_count);
         ecs_vec_t vec = ecs_vec_from_column(column, src_table, elem_size);
-        ecs_vec_fini(NULL, &vec, elem_size);
+        flecs_table_column_fini(&vec, elem_size, 
+            flecs_table_column_align(src_table, column->ti));
         column->data = vec.array;
     }    
 
@@ -2502,6 +2805,14 @@ void flecs_table_merge(
     /* Merge table columns */
     flecs_table_merge_data(world, dst_table, src_table, dst_count, src_count);
 
+    if (dst_table->flags & EcsTableHasDenseToggle) {
+        for (i = 0; i < src_count; i ++) {
+            flecs_table_dense_toggle_sync(world, dst_table, dst_count + i);
+        }
+    }
+
+    src_table->_->dense_toggle_count = 0;
+
     if (src_count) {
         flecs_table_traversable_add(dst_table, src_table->_->traversable_count);
         flecs_table_traversable_add(src_table, -src_table->_->traversable_count);
@@ -2923,6 +3234,28 @@ error:
     return 0;
 }
 
+int32_t ecs_table_get_column_alignment(
+    const ecs_table_t *table,
+    int32_t column)
+{
+    ecs_check(table != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(column < table->column_count, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(table->column_map != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    const ecs_type_info_t *ti = table->data.columns[column].ti;
+    int32_t align = flecs_table_column_align(table, ti);
+    if (!align) {
+        align = table->_->column_alignment;
+        if (ti->alignment > align) {
+            align = ti->alignment;
+        }
+    }
+
+    return align;
+error:
+    return 0;
+}
+
 int32_t ecs_table_count(
     const ecs_table_t *table)
 {
@@ -3013,6 +3346,9 @@ void ecs_table_swap_rows(
     int32_t row_2)
 {
     flecs_table_swap(world, table, row_1, row_2);
+
+    /* Rows are no longer partitioned until the next toggle */
+    flecs_table_dense_toggle_invalidate(table);
 }
 
 void* ecs_record_get_by_column(
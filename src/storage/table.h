@@ -8,6 +8,9 @@
 
 #include "table_graph.h"
 
+/* Maximum value for ecs_set_column_alignment() */
+#define FLECS_MAX_COLUMN_ALIGNMENT (4096)
+
 #ifdef FLECS_SANITIZE
 #define ecs_vec_from_column(arg_column, table, arg_elem_size) {\
     .array = (arg_column)->data,\
@@ -105,6 +108,10 @@ typedef struct ecs_table__t {
 
     int16_t bs_count;
     int16_t bs_offset;
+    int16_t column_alignment;        /* Minimum alignment of column storage */
+    int16_t dense_toggle;            /* Bitset column of dense toggle */
+    int32_t dense_toggle_count;      /* Enabled rows of dense toggle, -1 if rows
+                                      * are not partitioned. */
     ecs_bitset_t *bs_columns;        /* Bitset columns */
 
     struct ecs_table_record_t *records; /* Array with table records */
@@ -212,18 +219,33 @@ void flecs_table_move(
     ecs_id_t emplace_id);
 
 /* Grow table with specified number of records. Populate table with the
- * specified entity ids. */
+ * specified entity ids. If construct is false, the new elements are neither
+ * constructed nor passed to OnAdd hooks, which is then up to the caller. */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
     ecs_table_t *table,
     int32_t count,
-    const ecs_entity_t *ids);
+    const ecs_entity_t *ids,
+    bool construct);
+
+/* Invoke OnAdd hooks for elements that were appended without constructing */
+void flecs_table_invoke_on_add(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row,
+    int32_t count);
 
 /* Shrink table to contents */
 bool flecs_table_shrink(
     ecs_world_t *world,
     ecs_table_t *table);
 
+/* Shrink table storage to size, which must not be less than the table count */
+bool flecs_table_shrink_to(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t size);
+
 /* Get dirty state for table columns */
 int32_t* flecs_table_get_dirty_state(
     ecs_world_t *world,
@@ -274,6 +296,25 @@ ecs_bitset_t* flecs_table_get_toggle(
     ecs_table_t *table,
     ecs_id_t id);
 
+/* Move row to the enabled or disabled rows of a table with a dense toggle,
+ * depending on the value of its toggle bit. Partitions the entire table if the
+ * rows are not partitioned. */
+void flecs_table_dense_toggle_sync(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row);
+
+/* Mark rows of table with dense toggle as not partitioned */
+void flecs_table_dense_toggle_invalidate(
+    ecs_table_t *table);
+
+/* Prepare deleting a row from a table with a dense toggle. Returns the row that
+ * contains the deleted entity after preserving the partition. */
+int32_t flecs_table_dense_toggle_delete(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t row);
+
 ecs_id_t flecs_column_id(
     ecs_table_t *table,
     int32_t column_index);
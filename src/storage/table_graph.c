@@ -502,6 +502,144 @@ void flecs_table_diff_free(
     flecs_bfree(&world->allocators.table_diff, diff);
 }
 
+/* Kinds of transition cache elements */
+#define EcsGraphCacheAdd (1)
+#define EcsGraphCacheRemove (2)
+#define EcsGraphCacheAddMulti (3)
+
+static
+void flecs_graph_multi_edge_free(
+    ecs_world_t *world,
+    ecs_graph_multi_edge_t *multi)
+{
+    ecs_table_diff_t *diff = &multi->diff;
+    if (diff->added.count) {
+        flecs_wfree_n(world, ecs_id_t, diff->added.count, diff->added.array);
+    }
+    if (diff->removed.count) {
+        flecs_wfree_n(world, ecs_id_t, diff->removed.count, diff->removed.array);
+    }
+    flecs_wfree_n(world, ecs_id_t, multi->ids.count, multi->ids.array);
+    flecs_wfree_t(world, ecs_graph_multi_edge_t, multi);
+}
+
+static
+void flecs_graph_cache_elem_fini(
+    ecs_world_t *world,
+    ecs_graph_cache_elem_t *elem)
+{
+    if (elem->kind == EcsGraphCacheAddMulti) {
+        flecs_graph_multi_edge_free(world, elem->is.multi);
+    }
+    ecs_os_memset_t(elem, 0, ecs_graph_cache_elem_t);
+}
+
+static
+ecs_graph_cache_elem_t* flecs_graph_cache_set(
+    const ecs_graph_cache_t *cache,
+    uint64_t table,
+    uint64_t key,
+    int32_t kind)
+{
+    uint64_t h = (table * 0x9E3779B97F4A7C15) ^ key ^ (uint32_t)kind;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9;
+    h ^= h >> 29;
+    return &cache->elems[
+        (h & (FLECS_GRAPH_CACHE_SETS - 1)) * FLECS_GRAPH_CACHE_WAYS];
+}
+
+/* Find element in transition cache. Does not modify the cache. */
+static
+ecs_graph_cache_elem_t* flecs_graph_cache_get(
+    const ecs_graph_cache_t *cache,
+    uint64_t table,
+    uint64_t key,
+    int32_t kind)
+{
+    ecs_graph_cache_elem_t *set = flecs_graph_cache_set(
+        cache, table, key, kind);
+    int32_t i;
+    for (i = 0; i < FLECS_GRAPH_CACHE_WAYS; i ++) {
+        ecs_graph_cache_elem_t *elem = &set[i];
+        if (elem->key == key && elem->table == table && elem->kind == kind &&
+            elem->epoch == cache->epoch) 
+        {
+            return elem;
+        }
+    }
+    return NULL;
+}
+
+/* Insert element into the first way of a set. Existing elements move to the
+ * next way, the element in the last way is evicted. */
+static
+ecs_graph_cache_elem_t* flecs_graph_cache_insert(
+    ecs_world_t *world,
+    uint64_t table,
+    uint64_t key,
+    int32_t kind)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    ecs_graph_cache_elem_t *set = flecs_graph_cache_set(
+        cache, table, key, kind);
+
+    const int32_t last = FLECS_GRAPH_CACHE_WAYS - 1;
+    flecs_graph_cache_elem_fini(world, &set[last]);
+    ecs_os_memmove_n(&set[1], &set[0], ecs_graph_cache_elem_t, last);
+
+    ecs_graph_cache_elem_t *elem = &set[0];
+    elem->table = table;
+    elem->key = key;
+    elem->kind = kind;
+    elem->epoch = cache->epoch;
+    elem->is.edge = NULL;
+    return elem;
+}
+
+static
+void flecs_graph_cache_clear(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    int32_t i;
+    for (i = 0; i < FLECS_GRAPH_CACHE_SETS * FLECS_GRAPH_CACHE_WAYS; i ++) {
+        flecs_graph_cache_elem_fini(world, &cache->elems[i]);
+    }
+}
+
+/* Invalidate all elements in the transition cache. This happens when an edge
+ * is removed, or when flags are added to the diff of an edge. */
+static
+void flecs_graph_cache_invalidate(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    if (!(++ cache->epoch)) {
+        /* Don't match elements with an old epoch after wrapping around */
+        flecs_graph_cache_clear(world);
+    }
+}
+
+void flecs_graph_cache_init(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    cache->elems = flecs_wcalloc_n(world, ecs_graph_cache_elem_t, 
+        FLECS_GRAPH_CACHE_SETS * FLECS_GRAPH_CACHE_WAYS);
+    cache->epoch = 0;
+}
+
+void flecs_graph_cache_fini(
+    ecs_world_t *world)
+{
+    ecs_graph_cache_t *cache = &world->store.graph_cache;
+    flecs_graph_cache_clear(world);
+    flecs_wfree_n(world, ecs_graph_cache_elem_t, 
+        FLECS_GRAPH_CACHE_SETS * FLECS_GRAPH_CACHE_WAYS, cache->elems);
+    cache->elems = NULL;
+}
+
 static
 ecs_graph_edge_t* flecs_table_ensure_hi_edge(
     ecs_world_t *world,
@@ -559,6 +697,9 @@ void flecs_table_disconnect_edge(
     ecs_assert(edge->id == id, ECS_INTERNAL_ERROR, NULL);
     (void)id;
 
+    /* Edge may be stored in transition cache */
+    flecs_graph_cache_invalidate(world);
+
     /* Remove backref from destination table */
     ecs_graph_edge_hdr_t *next = edge->hdr.next;
     ecs_graph_edge_hdr_t *prev = edge->hdr.prev;
@@ -1043,6 +1184,46 @@ void flecs_add_with_property(
     }
 }
 
+/* Remove member columns added with (With, member) pairs together with a SoA
+ * component, as they store the data of the SoA component. Other (With, id)
+ * pairs of the component are not removed. */
+static
+void flecs_remove_soa_with_property(
+    ecs_world_t *world,
+    ecs_type_t *dst_type,
+    ecs_entity_t r)
+{
+    ecs_component_record_t *cr_with_wildcard = flecs_components_get(world,
+        ecs_pair(EcsWith, EcsWildcard));
+    if (!cr_with_wildcard) {
+        return;
+    }
+
+    ecs_table_t *table = ecs_get_table(world, r);
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    const ecs_table_record_t *tr = flecs_component_get_table(
+        cr_with_wildcard, table);
+    if (tr) {
+        int32_t i = tr->index, end = i + tr->count;
+        ecs_id_t *ids = table->type.array;
+
+        for (; i < end; i ++) {
+            ecs_entity_t member = ecs_get_alive(world, 
+                ECS_PAIR_SECOND(ids[i]));
+            if (!member || !ecs_has_pair(world, member, EcsChildOf, r)) {
+                continue;
+            }
+#ifdef FLECS_META
+            if (!ecs_has(world, member, EcsMember)) {
+                continue;
+            }
+#endif
+            flecs_type_remove(world, dst_type, member);
+        }
+    }
+}
+
 static
 ecs_table_t* flecs_find_table_with(
     ecs_world_t *world,
@@ -1161,6 +1342,8 @@ ecs_table_t* flecs_find_table_without(
     if (without == ecs_id(EcsParent)) {
         flecs_type_remove(world, &dst_type, 
             ecs_pair(EcsParentDepth, EcsWildcard));
+    } else if (cr && (cr->flags & EcsIdSoA) && !ECS_IS_PAIR(without)) {
+        flecs_remove_soa_with_property(world, &dst_type, without);
     }
 
     return flecs_table_ensure(world, &dst_type, true, node);
@@ -1270,6 +1453,34 @@ ecs_table_t* flecs_create_edge_for_add(
     return to;
 }
 
+/* Get edge for id. Edges for ids that don't use the low edge array are looked
+ * up in the transition cache before the edge map of the table. */
+static
+ecs_graph_edge_t* flecs_table_get_cached_edge(
+    ecs_world_t *world,
+    ecs_table_t *node,
+    ecs_graph_edges_t *edges,
+    ecs_id_t id,
+    int32_t kind)
+{
+    if (id < FLECS_HI_COMPONENT_ID) {
+        return flecs_table_ensure_edge(world, edges, id);
+    }
+
+    ecs_graph_cache_elem_t *elem = flecs_graph_cache_get(
+        &world->store.graph_cache, node->id, id, kind);
+    if (elem) {
+        ecs_assert(elem->is.edge->id == id, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(elem->is.edge->from == node, ECS_INTERNAL_ERROR, NULL);
+        return elem->is.edge;
+    }
+
+    ecs_graph_edge_t *edge = flecs_table_ensure_hi_edge(world, edges, id);
+    elem = flecs_graph_cache_insert(world, node->id, id, kind);
+    elem->is.edge = edge;
+    return edge;
+}
+
 ecs_table_t* flecs_table_traverse_remove(
     ecs_world_t *world,
     ecs_table_t *node,
@@ -1284,7 +1495,8 @@ ecs_table_t* flecs_table_traverse_remove(
     ecs_check(id_ptr[0] != 0, ECS_INVALID_PARAMETER, NULL);
 
     ecs_id_t id = id_ptr[0];
-    ecs_graph_edge_t *edge = flecs_table_ensure_edge(world, &node->node.remove, id);
+    ecs_graph_edge_t *edge = flecs_table_get_cached_edge(
+        world, node, &node->node.remove, id, EcsGraphCacheRemove);
     ecs_table_t *to = edge->to;
 
     if (!to) {
@@ -1323,7 +1535,8 @@ ecs_table_t* flecs_table_traverse_add(
     ecs_check(id_ptr[0] != 0, ECS_INVALID_PARAMETER, NULL);
 
     ecs_id_t id = id_ptr[0];
-    ecs_graph_edge_t *edge = flecs_table_ensure_edge(world, &node->node.add, id);
+    ecs_graph_edge_t *edge = flecs_table_get_cached_edge(
+        world, node, &node->node.add, id, EcsGraphCacheAdd);
     ecs_table_t *to = edge->to;
 
     if (!to) {
@@ -1379,6 +1592,9 @@ void flecs_table_edges_add_flags(
     ecs_graph_node_t *table_node = &table->node;
     ecs_graph_edge_hdr_t *node_refs = &table_node->refs;
 
+    /* Multi edges in the transition cache contain a copy of the flags */
+    flecs_graph_cache_invalidate(world);
+
     /* Add flags to incoming matching add edges */
     if (flags == EcsTableHasOnAdd) {
         ecs_graph_edge_hdr_t *next, *cur = node_refs->next;
@@ -1546,6 +1762,123 @@ error:
     return NULL;
 }
 
+static
+bool flecs_graph_multi_edge_match(
+    const ecs_graph_multi_edge_t *multi,
+    const ecs_id_t *ids,
+    int32_t count)
+{
+    if (multi->ids.count != count) {
+        return false;
+    }
+    return !ecs_os_memcmp(
+        multi->ids.array, ids, count * ECS_SIZEOF(ecs_id_t));
+}
+
+static
+ecs_id_t* flecs_graph_ids_copy(
+    ecs_world_t *world,
+    const ecs_id_t *ids,
+    int32_t count)
+{
+    if (!count) {
+        return NULL;
+    }
+    ecs_id_t *result = flecs_walloc_n(world, ecs_id_t, count);
+    ecs_os_memcpy_n(result, ids, ecs_id_t, count);
+    return result;
+}
+
+ecs_table_t* flecs_find_table_add_ids(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    const ecs_id_t *ids,
+    int32_t count,
+    ecs_table_diff_builder_t *diff)
+{
+    ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (count < 2) {
+        if (count) {
+            table = flecs_find_table_add(world, table, ids[0], diff);
+        }
+        return table;
+    }
+
+    uint64_t key = flecs_hash(ids, count * ECS_SIZEOF(ecs_id_t));
+    ecs_graph_cache_elem_t *elem = flecs_graph_cache_get(
+        &world->store.graph_cache, table->id, key, EcsGraphCacheAddMulti);
+    if (elem && flecs_graph_multi_edge_match(elem->is.multi, ids, count)) {
+        ecs_graph_multi_edge_t *multi = elem->is.multi;
+        flecs_table_diff_build_append_table(world, diff, &multi->diff);
+        return multi->to;
+    }
+
+    /* Traverse edges for individual ids */
+    ecs_table_diff_builder_t multi_diff = ECS_TABLE_DIFF_INIT;
+    flecs_table_diff_builder_init(world, &multi_diff);
+
+    uint64_t table_id = table->id;
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        table = flecs_find_table_add(world, table, ids[i], &multi_diff);
+        ecs_check(table != NULL, ECS_INVALID_PARAMETER, NULL);
+    }
+
+    ecs_table_diff_t td;
+    flecs_table_diff_build_noalloc(&multi_diff, &td);
+    flecs_table_diff_build_append_table(world, diff, &td);
+
+    ecs_graph_multi_edge_t *multi = flecs_walloc_t(
+        world, ecs_graph_multi_edge_t);
+    multi->to = table;
+    multi->diff = td;
+    multi->diff.added.array = flecs_graph_ids_copy(
+        world, td.added.array, td.added.count);
+    multi->diff.removed.array = flecs_graph_ids_copy(
+        world, td.removed.array, td.removed.count);
+    multi->ids.array = flecs_graph_ids_copy(world, ids, count);
+    multi->ids.count = count;
+
+    elem = flecs_graph_cache_insert(
+        world, table_id, key, EcsGraphCacheAddMulti);
+    elem->is.multi = multi;
+
+    flecs_table_diff_builder_fini(world, &multi_diff);
+    return table;
+error:
+    flecs_table_diff_builder_fini(world, &multi_diff);
+    return NULL;
+}
+
+const ecs_graph_edge_t* flecs_table_find_add_edge(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    ecs_id_t id)
+{
+    const ecs_graph_edges_t *edges = &table->node.add;
+    const ecs_graph_edge_t *edge = NULL;
+
+    if (id < FLECS_HI_COMPONENT_ID) {
+        if (edges->lo) {
+            edge = &edges->lo[id];
+        }
+    } else {
+        const ecs_graph_cache_elem_t *elem = flecs_graph_cache_get(
+            &world->store.graph_cache, table->id, id, EcsGraphCacheAdd);
+        if (elem) {
+            edge = elem->is.edge;
+        } else if (edges->hi) {
+            edge = ecs_map_get_deref(edges->hi, ecs_graph_edge_t, id);
+        }
+    }
+
+    if (edge && !edge->to) {
+        return NULL;
+    }
+
+    return edge;
+}
+
 /* Public convenience functions for traversing table graph */
 ecs_table_t* ecs_table_add_id(
     ecs_world_t *world,
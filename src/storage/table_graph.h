@@ -50,6 +50,42 @@ typedef struct ecs_graph_node_t {
     ecs_graph_edge_hdr_t refs;
 } ecs_graph_node_t;
 
+/* Number of sets and ways of the table graph transition cache */
+#define FLECS_GRAPH_CACHE_SETS (128)
+#define FLECS_GRAPH_CACHE_WAYS (4)
+
+/* Transition that adds multiple ids at once */
+typedef struct ecs_graph_multi_edge_t {
+    ecs_table_t *to;                 /* Destination table */
+    ecs_table_diff_t diff;           /* Combined diff of the individual edges */
+    ecs_type_t ids;                  /* Added ids */
+} ecs_graph_multi_edge_t;
+
+/* Element in transition cache */
+typedef struct ecs_graph_cache_elem_t {
+    uint64_t table;                  /* Source table id (includes generation) */
+    uint64_t key;                    /* Id, or hash of ids for multi edges */
+    uint32_t epoch;                  /* Cache epoch at which elem was stored */
+    int32_t kind;                    /* Add, remove or multi add (0 if unused) */
+    union {
+        ecs_graph_edge_t *edge;
+        ecs_graph_multi_edge_t *multi;
+    } is;
+} ecs_graph_cache_elem_t;
+
+/* Set associative cache for table transitions. Lookups for ids that don't use
+ * the low edge array of a table otherwise require a map lookup per transition.
+ * 
+ * Elements are only written while the world is not readonly, as that's also
+ * when edges are created. Lookups don't modify the cache, which means that
+ * threads can read it concurrently while the world is readonly. When an edge 
+ * is removed or its diff changes, the epoch is incremented which invalidates
+ * all existing elements. */
+typedef struct ecs_graph_cache_t {
+    ecs_graph_cache_elem_t *elems;   /* FLECS_GRAPH_CACHE_SETS * WAYS elems */
+    uint32_t epoch;
+} ecs_graph_cache_t;
+
 /** Add to existing type */
 void flecs_type_add(
     ecs_world_t *world,
@@ -113,6 +149,31 @@ ecs_table_t* flecs_find_table_add(
     ecs_id_t id,
     ecs_table_diff_builder_t *diff);
 
+/* Find table by adding multiple ids to current table. The transition is cached
+ * as a single edge, so that adding the same ids again only requires a single 
+ * lookup. */
+ecs_table_t* flecs_find_table_add_ids(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    const ecs_id_t *ids,
+    int32_t count,
+    ecs_table_diff_builder_t *diff);
+
+/* Find existing add edge without creating it. This doesn't modify the table 
+ * graph or transition cache, and is safe to call from multiple threads while
+ * the world is readonly. Returns NULL if the edge doesn't exist. */
+const ecs_graph_edge_t* flecs_table_find_add_edge(
+    const ecs_world_t *world,
+    const ecs_table_t *table,
+    ecs_id_t id);
+
+/* Init and fini transition cache */
+void flecs_graph_cache_init(
+    ecs_world_t *world);
+
+void flecs_graph_cache_fini(
+    ecs_world_t *world);
+
 void flecs_table_hashmap_init(
     ecs_world_t *world,
     ecs_hashmap_t *hm);
@@ -921,9 +921,10 @@ const ecs_type_info_t* ecs_get_type_info(
     world = ecs_get_world(world);
 
     ecs_component_record_t *cr = flecs_components_get(world, id);
-    if (cr) {
+    if (cr && !(cr->flags & EcsIdSoA)) {
         return cr->type_info;
     } else {
+        /* SoA components don't store data, but still have a type */
         return flecs_determine_type_info_for_component(world, id);
     }
 error:
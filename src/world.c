@@ -98,6 +98,8 @@ const ecs_entity_t EcsPanic =                       FLECS_HI_COMPONENT_ID + 56;
 /* Storage */
 const ecs_entity_t EcsSparse =                      FLECS_HI_COMPONENT_ID + 57;
 const ecs_entity_t EcsDontFragment =                FLECS_HI_COMPONENT_ID + 58;
+const ecs_entity_t EcsSoA =                         FLECS_HI_COMPONENT_ID + 124;
+const ecs_entity_t EcsDenseToggle =                 FLECS_HI_COMPONENT_ID + 125;
 
 /* Misc */
 const ecs_entity_t ecs_id(EcsDefaultChildComponent) = FLECS_HI_COMPONENT_ID + 59;
@@ -556,6 +558,9 @@ void flecs_init_store(
 
     /* Initialize table map */
     flecs_table_hashmap_init(world, &world->store.table_map);
+
+    /* Initialize table transition cache */
+    flecs_graph_cache_init(world);
 }
 
 static
@@ -716,6 +721,7 @@ void flecs_fini_store(ecs_world_t *world) {
     flecs_table_fini(world, &world->store.root);
     flecs_entities_clear(world);
     flecs_hashmap_fini(&world->store.table_map);
+    flecs_graph_cache_fini(world);
 
     ecs_assert(ecs_vec_count(&world->store.marked_ids) == 0, 
         ECS_INTERNAL_ERROR, NULL);
@@ -816,6 +822,9 @@ static const char *flecs_addons_info[] = {
 #ifdef FLECS_JSON
     "FLECS_JSON",
 #endif
+#ifdef FLECS_SNAPSHOT
+    "FLECS_SNAPSHOT",
+#endif
 #ifdef FLECS_DOC
     "FLECS_DOC",
 #endif
@@ -1060,6 +1069,7 @@ ecs_world_t *ecs_mini(void) {
     flecs_name_index_init(&world->symbols, a);
     ecs_vec_init_t(a, &world->fini_actions, ecs_action_elem_t, 0);
     ecs_vec_init_t(a, &world->component_ids, ecs_id_t, 0);
+    world->reserved_count = FLECS_ENTITY_RESERVE_COUNT;
 
     world->info.time_scale = 1.0;
     if (ecs_os_has_time()) {
@@ -1382,6 +1392,9 @@ int ecs_fini(
     ecs_set_stage_count(world, 0);
     ecs_map_fini(&world->prefab_child_indices);
     ecs_vec_fini_t(&world->allocator, &world->component_ids, ecs_id_t);
+    if (world->reserved_mutex) {
+        ecs_os_mutex_free(world->reserved_mutex);
+    }
     ecs_log_pop_1();
 
     flecs_world_allocators_fini(world);
@@ -1465,6 +1478,21 @@ void ecs_set_default_query_flags(
     world->default_query_flags = flags;
 }
 
+void ecs_set_column_alignment(
+    ecs_world_t *world,
+    int32_t alignment)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(alignment >= 0 && alignment <= FLECS_MAX_COLUMN_ALIGNMENT,
+        ECS_INVALID_PARAMETER, "column alignment must be between 0 and %d",
+            FLECS_MAX_COLUMN_ALIGNMENT);
+    ecs_check(!(alignment & (alignment - 1)), ECS_INVALID_PARAMETER,
+        "column alignment must be a power of two");
+    world->column_alignment = alignment;
+error:
+    return;
+}
+
 void* ecs_get_ctx(
     const ecs_world_t *world)
 {
@@ -1921,6 +1949,258 @@ done:
     return result;
 }
 
+/* Phases of a compaction pass */
+#define FLECS_COMPACT_TABLES (0)
+#define FLECS_COMPACT_STORAGE (1)
+#define FLECS_COMPACT_ALLOCATORS (2)
+
+/* Number of tables to compact before checking the time budget */
+#define FLECS_COMPACT_TABLES_PER_MEASURE (16)
+
+static
+int64_t flecs_compact_table_size(
+    const ecs_table_t *table)
+{
+    int64_t size = table->data.size;
+    int64_t result = size * ECS_SIZEOF(ecs_entity_t);
+    int32_t i, count = table->column_count;
+    for (i = 0; i < count; i ++) {
+        result += size * table->data.columns[i].ti->size;
+    }
+    return result;
+}
+
+static
+bool flecs_compact_budget_exceeded(
+    const ecs_time_t *start,
+    double time_budget_seconds)
+{
+    if (ECS_EQZERO(time_budget_seconds)) {
+        return false;
+    }
+
+    ecs_time_t cur = *start;
+    return ecs_time_measure(&cur) > time_budget_seconds;
+}
+
+static
+bool flecs_compact_tables(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc,
+    const ecs_time_t *start,
+    int64_t *reclaimed)
+{
+    int32_t i = world->compact.offset;
+    int32_t measure_after = FLECS_COMPACT_TABLES_PER_MEASURE;
+
+    while (i < flecs_sparse_count(&world->store.tables)) {
+        if (!(-- measure_after)) {
+            if (flecs_compact_budget_exceeded(
+                start, desc->time_budget_seconds)) 
+            {
+                world->compact.offset = i;
+                return false;
+            }
+            measure_after = FLECS_COMPACT_TABLES_PER_MEASURE;
+        }
+
+        ecs_table_t *table = flecs_sparse_get_dense_t(&world->store.tables,
+            ecs_table_t, i);
+        if (!table->id || table->_->lock) {
+            i ++;
+            continue;
+        }
+
+        int32_t count = ecs_table_count(table);
+        if (count) {
+            /* Table is in use, restart counting empty passes */
+            table->_->generation = 0;
+            if (count <= (table->data.size / 2)) {
+                /* Leave room to grow, so that a table with a count that 
+                 * fluctuates isn't shrunk and grown again on every pass. */
+                int64_t size = flecs_compact_table_size(table);
+                flecs_table_shrink_to(world, table, count + count / 2);
+                reclaimed[0] += size - flecs_compact_table_size(table);
+            }
+            i ++;
+            continue;
+        }
+
+        if (table->keep) {
+            i ++;
+            continue;
+        }
+
+        uint16_t gen = ++ table->_->generation;
+        if (desc->delete_generation && (gen > desc->delete_generation)) {
+            reclaimed[0] += flecs_compact_table_size(table) + 
+                ECS_SIZEOF(ecs_table_t);
+            /* Deleting the table moves the last table to this index */
+            flecs_table_fini(world, table);
+            continue;
+        }
+
+        if (desc->clear_generation && (gen > desc->clear_generation)) {
+            int64_t size = flecs_compact_table_size(table);
+            flecs_table_shrink(world, table);
+            reclaimed[0] += size - flecs_compact_table_size(table);
+        }
+
+        i ++;
+    }
+
+    return true;
+}
+
+static
+int64_t flecs_compact_storage(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc)
+{
+    ecs_entity_index_t *index = &world->store.entity_index;
+    int32_t i, page_count = ecs_vec_count(&index->pages);
+    ecs_entity_index_page_t **pages = ecs_vec_first_t(&index->pages,
+        ecs_entity_index_page_t*);
+
+    int64_t size = ecs_vec_size(&index->dense) * ECS_SIZEOF(uint64_t);
+    size += ecs_vec_size(&index->pages) * ECS_SIZEOF(ecs_entity_index_page_t*);
+    for (i = 0; i < page_count; i ++) {
+        if (pages[i]) {
+            size += ECS_SIZEOF(ecs_entity_index_page_t);
+        }
+    }
+
+    if (desc->shrink_entity_index) {
+        flecs_entity_index_shrink(index);
+    } else {
+        ecs_vec_reclaim_t(index->allocator, &index->dense, uint64_t);
+    }
+
+    page_count = ecs_vec_count(&index->pages);
+    pages = ecs_vec_first_t(&index->pages, ecs_entity_index_page_t*);
+    size -= ecs_vec_size(&index->dense) * ECS_SIZEOF(uint64_t);
+    size -= ecs_vec_size(&index->pages) * ECS_SIZEOF(ecs_entity_index_page_t*);
+    for (i = 0; i < page_count; i ++) {
+        if (pages[i]) {
+            size -= ECS_SIZEOF(ecs_entity_index_page_t);
+        }
+    }
+
+    ecs_map_reclaim(&world->store.table_map.impl);
+    flecs_sparse_shrink(&world->store.tables);
+
+    return size;
+}
+
+static
+int64_t flecs_compact_allocator(
+    ecs_allocator_t *a)
+{
+    int64_t result = 0;
+#ifndef FLECS_USE_OS_ALLOC
+    int32_t i, count = flecs_sparse_count(&a->sizes);
+    for (i = 0; i < count; i ++) {
+        ecs_block_allocator_t *ba = flecs_sparse_get_dense_t(
+            &a->sizes, ecs_block_allocator_t, i);
+        result += flecs_ballocator_reclaim(ba);
+    }
+#else
+    (void)a;
+#endif
+    return result;
+}
+
+static
+bool flecs_compact_allocators(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc,
+    const ecs_time_t *start,
+    int64_t *reclaimed)
+{
+    /* Offset 0 is the world allocator, the other offsets are stages */
+    int32_t i = world->compact.offset;
+    for (; i <= world->stage_count; i ++) {
+        if (flecs_compact_budget_exceeded(start, desc->time_budget_seconds)) {
+            world->compact.offset = i;
+            return false;
+        }
+
+        if (!i) {
+            reclaimed[0] += flecs_compact_allocator(&world->allocator);
+        } else {
+            reclaimed[0] += flecs_compact_allocator(
+                &world->stages[i - 1]->allocator);
+        }
+    }
+
+    return true;
+}
+
+int64_t ecs_compact(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+    ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION,
+        "cannot compact while world is in readonly mode");
+    ecs_check(!world->stages[0]->defer, ECS_INVALID_OPERATION,
+        "cannot compact while world is deferred");
+
+    ecs_os_perf_trace_push("flecs.compact");
+
+    ecs_time_t start = {0};
+    if (ECS_NEQZERO(desc->time_budget_seconds)) {
+        ecs_time_measure(&start);
+    }
+
+    int64_t reclaimed = 0;
+
+    if (world->compact.phase == FLECS_COMPACT_TABLES) {
+        if (!flecs_compact_tables(world, desc, &start, &reclaimed)) {
+            goto done;
+        }
+        world->compact.phase = FLECS_COMPACT_STORAGE;
+        world->compact.offset = 0;
+    }
+
+    if (world->compact.phase == FLECS_COMPACT_STORAGE) {
+        reclaimed += flecs_compact_storage(world, desc);
+        world->compact.phase = FLECS_COMPACT_ALLOCATORS;
+        world->compact.offset = 0;
+    }
+
+    if (world->compact.phase == FLECS_COMPACT_ALLOCATORS) {
+        if (!flecs_compact_allocators(world, desc, &start, &reclaimed)) {
+            goto done;
+        }
+        world->compact.phase = FLECS_COMPACT_TABLES;
+        world->compact.offset = 0;
+    }
+
+done:
+    world->info.compact_reclaimed_total += reclaimed;
+    ecs_os_perf_trace_pop("flecs.compact");
+    return reclaimed;
+error:
+    return 0;
+}
+
+void ecs_set_compaction(
+    ecs_world_t *world,
+    const ecs_compact_desc_t *desc)
+{
+    flecs_poly_assert(world, ecs_world_t);
+
+    if (desc) {
+        world->compact.desc = *desc;
+        world->compact.enabled = true;
+    } else {
+        ecs_os_zeromem(&world->compact.desc);
+        world->compact.enabled = false;
+    }
+}
+
 ecs_entities_t ecs_get_entities(
     const ecs_world_t *world)
 {
@@ -61,6 +61,9 @@ typedef struct ecs_store_t {
     /* Root table */
     ecs_table_t root;
 
+    /* Cache for table graph transitions */
+    ecs_graph_cache_t graph_cache;
+
     /* Records cache */
     ecs_vec_t records;
 
@@ -81,6 +84,14 @@ typedef struct ecs_action_elem_t {
 
 typedef struct ecs_pipeline_state_t ecs_pipeline_state_t;
 
+/* Job that worker threads run instead of the pipeline. Each thread is passed
+ * its stage index, so that the job can split up the work. */
+typedef void (*flecs_worker_job_t)(
+    ecs_world_t *world,
+    int32_t stage_index,
+    int32_t stage_count,
+    void *ctx);
+
 /** The world stores and manages all ECS data. An application can have more than
  * one world, but data is not shared between worlds. */
 struct ecs_world_t {
@@ -169,12 +180,25 @@ struct ecs_world_t {
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
     ecs_os_cond_t sync_cond;         /* Signal that worker thread job is done */
+    ecs_os_cond_t barrier_cond;      /* Signal that threads passed a barrier */
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t barrier_waiting;         /* Number of threads waiting on barrier */
+    int32_t barrier_generation;      /* Number of barriers passed */
+    int32_t workers_epoch;           /* Number of times workers were signaled */
+    int32_t worker_spin_count;       /* Iterations to poll before yielding */
+    int32_t worker_yield_count;      /* Iterations to yield before blocking */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
+    flecs_worker_job_t worker_job;   /* Job for the workers to execute, if set */
+    void *worker_job_ctx;            /* Context passed to worker job */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
 
+    /* Entity ids that stages create in multithreaded mode */
+    ecs_os_mutex_t reserved_mutex;   /* Mutex for claiming ids from entity index */
+    int32_t reserved_count;          /* Ids to reserve entity index storage for */
+    int32_t reserved_used;           /* Ids used during multithreaded phase */
+
     /* -- Exclusive access -- */
     ecs_os_thread_id_t exclusive_access; /* If set, world can only be mutated by thread */
     const char *exclusive_thread_name;   /* Name of thread with exclusive access (used for debugging) */
@@ -193,9 +217,24 @@ struct ecs_world_t {
     /* -- Default query flags -- */
     ecs_flags32_t default_query_flags;
 
+    /* -- Minimum alignment of component columns in new tables -- */
+    int32_t column_alignment;
+
     /* Count that increases when component monitors change */
     int32_t monitor_generation;
 
+    /* Number of forks that weren't freed yet. While forks exist, values of
+     * components returned by ensure/get_mut are marked as changed. */
+    int32_t fork_count;
+
+    /* -- Incremental compaction -- */
+    struct {
+        ecs_compact_desc_t desc;     /* Settings for compaction at end of frame */
+        bool enabled;                /* Compact at end of frame */
+        int32_t phase;               /* Phase of current compaction pass */
+        int32_t offset;              /* Position in current phase */
+    } compact;
+
     /* -- Allocators -- */
     ecs_world_allocators_t allocators; /* Static allocation sizes */
     ecs_allocator_t allocator;       /* Dynamic allocation sizes */
@@ -209,6 +248,20 @@ struct ecs_world_t {
     ecs_vec_t fini_actions;          /* Callbacks to execute when world exits */
 };
 
+/* Run job on main thread and worker threads outside of a pipeline. Returns
+ * false without running the job if the world has no idle worker threads. */
+bool flecs_workers_run(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx);
+
+/* Same as flecs_workers_run, but operations invoked by the job on the stage of
+ * a thread are deferred, and merged after the job has finished. */
+bool flecs_workers_run_deferred(
+    ecs_world_t *world,
+    flecs_worker_job_t job,
+    void *ctx);
+
 /* Get current stage. */
 ecs_stage_t* flecs_stage_from_world(
     ecs_world_t **world_ptr);
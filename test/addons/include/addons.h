@@ -65,6 +65,27 @@ typedef struct Self {
     ecs_entity_t value;
 } Self;
 
+typedef struct StringComponent {
+    char *value;
+} StringComponent;
+
+void StringComponent_copy(
+    void *dst_ptr,
+    const void *src_ptr,
+    int32_t count,
+    const ecs_type_info_t *type_info);
+
+void StringComponent_move(
+    void *dst_ptr,
+    void *src_ptr,
+    int32_t count,
+    const ecs_type_info_t *type_info);
+
+void StringComponent_dtor(
+    void *ptr,
+    int32_t count,
+    const ecs_type_info_t *type_info);
+
 void probe_system_w_ctx(
     ecs_iter_t *it,
     Probe *ctx);
@@ -0,0 +1,715 @@
+#include <addons.h>
+
+static ECS_COMPONENT_DECLARE(Position);
+static ECS_COMPONENT_DECLARE(Velocity);
+static ECS_COMPONENT_DECLARE(StringComponent);
+static ECS_DECLARE(Tag);
+
+static
+void Move(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    const Velocity *v = ecs_field(it, Velocity, 1);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x += v[i].x;
+        p[i].y += v[i].y;
+    }
+}
+
+void Fork_restore_value(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+    test_assert(fork != NULL);
+
+    ecs_set(world, e, Position, {30, 40});
+
+    ecs_world_fork_restore(fork);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_value_from_ensure(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {100, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    /* Value is written without calling modified */
+    Position *p = ecs_ensure(world, e, Position);
+    test_assert(p != NULL);
+    p->x = 200;
+
+    ecs_world_fork_restore(fork);
+
+    const Position *r = ecs_get(world, e, Position);
+    test_assert(r != NULL);
+    test_int(r->x, 100);
+    test_int(r->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_value_from_get_mut(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {100, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    Position *p = ecs_get_mut(world, e, Position);
+    test_assert(p != NULL);
+    p->x = 200;
+
+    ecs_world_fork_restore(fork);
+
+    const Position *r = ecs_get(world, e, Position);
+    test_assert(r != NULL);
+    test_int(r->x, 100);
+    test_int(r->y, 20);
+
+    /* Fork can be restored again after writing through a new pointer */
+    p = ecs_get_mut(world, e, Position);
+    p->x = 300;
+
+    ecs_world_fork_restore(fork);
+
+    r = ecs_get(world, e, Position);
+    test_int(r->x, 100);
+    test_int(r->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_value_from_deferred_ensure(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {100, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_defer_begin(world);
+    Position *p = ecs_ensure(world, e, Position);
+    test_assert(p != NULL);
+    p->x = 200;
+    p->y = 20;
+    ecs_defer_end(world);
+
+    const Position *r = ecs_get(world, e, Position);
+    test_int(r->x, 200);
+
+    ecs_world_fork_restore(fork);
+
+    r = ecs_get(world, e, Position);
+    test_assert(r != NULL);
+    test_int(r->x, 100);
+    test_int(r->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_no_changes(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_add(world, e2, Tag);
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, e1));
+    test_assert(ecs_is_alive(world, e2));
+    test_assert(!ecs_has(world, e1, Tag));
+    test_assert(ecs_has(world, e2, Tag));
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    p = ecs_get(world, e2, Position);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_value_from_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ECS_SYSTEM(world, Move, EcsOnUpdate, Position, [in] Velocity);
+
+    ecs_entity_t e = ecs_insert(world,
+        ecs_value(Position, {10, 20}),
+        ecs_value(Velocity, {1, 2}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 12);
+    test_int(p->y, 24);
+
+    ecs_world_fork_restore(fork);
+
+    p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_new_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_entity_t e3 = ecs_new_w(world, Tag);
+    ecs_entity_t e4 = ecs_new(world);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, e1));
+    test_assert(!ecs_is_alive(world, e2));
+    test_assert(!ecs_is_alive(world, e3));
+    test_assert(!ecs_is_alive(world, e4));
+    test_int(ecs_count(world, Position), 1);
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_deleted_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_entity_t e3 = ecs_new(world);
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_delete(world, e1);
+    ecs_delete(world, e3);
+    test_assert(!ecs_is_alive(world, e1));
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, e1));
+    test_assert(ecs_is_alive(world, e2));
+    test_assert(ecs_is_alive(world, e3));
+    test_int(ecs_count(world, Position), 2);
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    p = ecs_get(world, e2, Position);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_deleted_recycled_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_delete(world, e1);
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    test_int((uint32_t)e1, (uint32_t)e2);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, e1));
+    test_assert(!ecs_is_alive(world, e2));
+    test_int(ecs_count(world, Position), 1);
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_added_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_set(world, e, Velocity, {1, 2});
+    ecs_set(world, e, Position, {30, 40});
+    ecs_add(world, e, Tag);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_has(world, e, Position));
+    test_assert(!ecs_has(world, e, Velocity));
+    test_assert(!ecs_has(world, e, Tag));
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_removed_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e = ecs_insert(world,
+        ecs_value(Position, {10, 20}),
+        ecs_value(Velocity, {1, 2}));
+    ecs_add(world, e, Tag);
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_remove(world, e, Velocity);
+    ecs_remove(world, e, Tag);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_has(world, e, Position));
+    test_assert(ecs_has(world, e, Velocity));
+    test_assert(ecs_has(world, e, Tag));
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    const Velocity *v = ecs_get(world, e, Velocity);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_twice(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_set(world, e, Position, {30, 40});
+    ecs_world_fork_restore(fork);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_set(world, e, Position, {50, 60});
+    ecs_new_w(world, Position);
+    ecs_world_fork_restore(fork);
+
+    p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    test_int(ecs_count(world, Position), 1);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_w_prev(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_insert(world,
+        ecs_value(Position, {10, 20}),
+        ecs_value(Velocity, {1, 2}));
+
+    ecs_world_fork_t *fork_1 = ecs_world_fork(world, NULL);
+
+    ecs_set(world, e, Velocity, {3, 4});
+
+    /* Shares Position column with first fork */
+    ecs_world_fork_t *fork_2 = ecs_world_fork(world, fork_1);
+
+    ecs_set(world, e, Position, {30, 40});
+    ecs_set(world, e, Velocity, {5, 6});
+
+    ecs_world_fork_restore(fork_2);
+    {
+        const Position *p = ecs_get(world, e, Position);
+        test_int(p->x, 10);
+        test_int(p->y, 20);
+        const Velocity *v = ecs_get(world, e, Velocity);
+        test_int(v->x, 3);
+        test_int(v->y, 4);
+    }
+
+    ecs_world_fork_restore(fork_1);
+    {
+        const Position *p = ecs_get(world, e, Position);
+        test_int(p->x, 10);
+        test_int(p->y, 20);
+        const Velocity *v = ecs_get(world, e, Velocity);
+        test_int(v->x, 1);
+        test_int(v->y, 2);
+    }
+
+    /* Shared copies remain valid after the previous fork is freed */
+    ecs_world_fork_free(fork_1);
+
+    ecs_world_fork_restore(fork_2);
+    {
+        const Position *p = ecs_get(world, e, Position);
+        test_int(p->x, 10);
+        test_int(p->y, 20);
+        const Velocity *v = ecs_get(world, e, Velocity);
+        test_int(v->x, 3);
+        test_int(v->y, 4);
+    }
+
+    ecs_world_fork_free(fork_2);
+    ecs_fini(world);
+}
+
+void Fork_restore_name(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_entity(world, { .name = "foo" });
+    ecs_set(world, e, Position, {10, 20});
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_set_name(world, e, "bar");
+    test_uint(ecs_lookup(world, "bar"), e);
+
+    ecs_world_fork_restore(fork);
+
+    test_str(ecs_get_name(world, e), "foo");
+    test_uint(ecs_lookup(world, "foo"), e);
+    test_uint(ecs_lookup(world, "bar"), 0);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_deleted_named_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_entity(world, { .name = "foo" });
+    ecs_set(world, e, Position, {10, 20});
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_delete(world, e);
+    test_uint(ecs_lookup(world, "foo"), 0);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, e));
+    test_str(ecs_get_name(world, e), "foo");
+    test_uint(ecs_lookup(world, "foo"), e);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_deleted_hierarchy(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t parent = ecs_entity(world, { .name = "parent" });
+    ecs_entity_t child = ecs_entity(world, { .name = "parent.child" });
+    ecs_set(world, child, Position, {10, 20});
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_delete(world, parent);
+    test_assert(!ecs_is_alive(world, child));
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, parent));
+    test_assert(ecs_is_alive(world, child));
+    test_assert(ecs_has_pair(world, child, EcsChildOf, parent));
+    test_uint(ecs_lookup(world, "parent.child"), child);
+
+    const Position *p = ecs_get(world, child, Position);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_non_fragmenting_parent(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t parent_1 = ecs_entity(world, { .name = "parent_1" });
+    ecs_entity_t parent_2 = ecs_entity(world, { .name = "parent_2" });
+    ecs_entity_t child = ecs_insert(world, ecs_value(EcsParent, {parent_1}));
+    ecs_set_name(world, child, "child");
+    ecs_entity_t gc = ecs_insert(world, ecs_value(EcsParent, {child}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_set(world, child, EcsParent, {parent_2});
+    test_uint(ecs_get_parent(world, child), parent_2);
+    ecs_delete(world, gc);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, gc));
+    test_uint(ecs_get_parent(world, child), parent_1);
+    test_uint(ecs_get_parent(world, gc), child);
+    test_uint(ecs_lookup(world, "parent_1.child"), child);
+    test_uint(ecs_lookup(world, "parent_2.child"), 0);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_component_w_hooks(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, StringComponent);
+    ecs_set_hooks(world, StringComponent, {
+        .copy = ecs_copy(StringComponent),
+        .move = ecs_move(StringComponent),
+        .dtor = ecs_dtor(StringComponent)
+    });
+
+    ecs_entity_t e1 = ecs_new(world);
+    ecs_entity_t e2 = ecs_new(world);
+    ecs_set(world, e1, StringComponent, {"foo"});
+    ecs_set(world, e2, StringComponent, {"bar"});
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_set(world, e1, StringComponent, {"hello"});
+    ecs_delete(world, e2);
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_is_alive(world, e2));
+    const StringComponent *ptr = ecs_get(world, e1, StringComponent);
+    test_assert(ptr != NULL);
+    test_str(ptr->value, "foo");
+    ptr = ecs_get(world, e2, StringComponent);
+    test_assert(ptr != NULL);
+    test_str(ptr->value, "bar");
+
+    ecs_world_fork_free(fork);
+
+    ptr = ecs_get(world, e1, StringComponent);
+    test_str(ptr->value, "foo");
+
+    ecs_fini(world);
+}
+
+static int fork_on_add = 0;
+static int fork_on_remove = 0;
+
+static
+void ForkOnAdd(ecs_iter_t *it) {
+    fork_on_add += it->count;
+}
+
+static
+void ForkOnRemove(ecs_iter_t *it) {
+    fork_on_remove += it->count;
+}
+
+void Fork_restore_w_observers(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_delete(world, e1);
+    ecs_insert(world, ecs_value(Position, {30, 40}));
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd },
+        .callback = ForkOnAdd
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnRemove },
+        .callback = ForkOnRemove
+    });
+
+    ecs_world_fork_restore(fork);
+
+    test_int(fork_on_add, 1);
+    test_int(fork_on_remove, 1);
+    test_assert(ecs_is_alive(world, e1));
+    test_int(ecs_count(world, Position), 1);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+void Fork_restore_after_table_delete(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_insert(world,
+        ecs_value(Position, {10, 20}),
+        ecs_value(Velocity, {1, 2}));
+
+    ecs_world_fork_t *fork = ecs_world_fork(world, NULL);
+
+    ecs_remove(world, e, Velocity);
+
+    /* Table is kept alive by fork */
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+
+    ecs_world_fork_restore(fork);
+
+    test_assert(ecs_has(world, e, Velocity));
+    const Velocity *v = ecs_get(world, e, Velocity);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    ecs_world_fork_free(fork);
+    ecs_fini(world);
+}
+
+#define FORK_FRAMES (8)
+
+void Fork_rollback_frames(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ECS_SYSTEM(world, Move, EcsOnUpdate, Position, [in] Velocity);
+
+    int i;
+    ecs_entity_t entities[16];
+    for (i = 0; i < 16; i ++) {
+        entities[i] = ecs_insert(world,
+            ecs_value(Position, {0, 0}),
+            ecs_value(Velocity, {i, i * 2}));
+    }
+
+    /* Fork each frame, sharing unchanged columns with the previous fork */
+    ecs_world_fork_t *forks[FORK_FRAMES] = {0};
+    for (i = 0; i < FORK_FRAMES; i ++) {
+        forks[i] = ecs_world_fork(world, i ? forks[i - 1] : NULL);
+        ecs_progress(world, 0);
+    }
+
+    for (i = 0; i < 16; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_int(p->x, i * FORK_FRAMES);
+        test_int(p->y, i * 2 * FORK_FRAMES);
+    }
+
+    /* Roll back 5 frames, change input and resimulate */
+    ecs_world_fork_restore(forks[FORK_FRAMES - 5]);
+
+    for (i = 0; i < 16; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_int(p->x, i * (FORK_FRAMES - 5));
+        test_int(p->y, i * 2 * (FORK_FRAMES - 5));
+    }
+
+    ecs_set(world, entities[0], Velocity, {1, 1});
+
+    for (i = 0; i < 5; i ++) {
+        ecs_progress(world, 0);
+    }
+
+    {
+        const Position *p = ecs_get(world, entities[0], Position);
+        test_int(p->x, 5);
+        test_int(p->y, 5);
+        p = ecs_get(world, entities[3], Position);
+        test_int(p->x, 3 * FORK_FRAMES);
+        test_int(p->y, 6 * FORK_FRAMES);
+    }
+
+    for (i = 0; i < FORK_FRAMES; i ++) {
+        ecs_world_fork_free(forks[i]);
+    }
+
+    ecs_fini(world);
+}
@@ -854,7 +854,9 @@ void test_combs_100_entity_2_types(int THREADS) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, ENTITIES / 2);
     ecs_entity_t ids_1[50];
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * ENTITIES / 2);
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, ENTITIES / 2);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, ENTITIES / 2);
+    ecs_entity_t ids_2[50];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * ENTITIES / 2);
 
     for (i = 0; i < ENTITIES / 2; i ++) {
         ecs_set(world, ids_1[i], Position, {1, 2});
@@ -915,7 +917,9 @@ void MultiThread_change_thread_count(void) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, ENTITIES / 2);
     ecs_entity_t ids_1[50];
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * ENTITIES / 2);
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, ENTITIES / 2);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, ENTITIES / 2);
+    ecs_entity_t ids_2[50];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * ENTITIES / 2);
 
     for (i = 0; i < ENTITIES / 2; i ++) {
         ecs_set(world, ids_1[i], Position, {1, 2});
@@ -1386,3 +1390,2088 @@ void MultiThread_run_single_thread_on_main(void) {
 
     ecs_fini(world);
 }
+
+static int chunk_too_large_count = 0;
+
+static void ProgressChunk(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int32_t *chunk_size = it->param;
+
+    if (it->count > *chunk_size) {
+        ecs_os_ainc(&chunk_too_large_count);
+    }
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+static
+void test_chunked_system(int32_t THREADS, int32_t CHUNK_SIZE) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t system = ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = ProgressChunk,
+        .ctx = &CHUNK_SIZE,
+        .multi_threaded = true,
+        .chunk_size = CHUNK_SIZE
+    });
+
+    test_int(ecs_system_get(world, system)->chunk_size, CHUNK_SIZE);
+
+    /* Tables with very different sizes */
+    int i, ENTITIES = 1000 + 10 + 3;
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_insert(world, ecs_value(Position, {0, 0}));
+        if (i >= 1000) {
+            ecs_add(world, handles[i], TagA);
+        }
+        if (i >= 1010) {
+            ecs_add(world, handles[i], TagB);
+        }
+    }
+
+    set_worker_kind(world, THREADS);
+    chunk_too_large_count = 0;
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    test_int(chunk_too_large_count, 0);
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+void MultiThread_2_thread_chunked_system(void) {
+    test_chunked_system(2, 16);
+}
+
+void MultiThread_6_thread_chunked_system(void) {
+    test_chunked_system(6, 16);
+}
+
+void MultiThread_6_thread_chunked_system_chunk_size_1(void) {
+    test_chunked_system(6, 1);
+}
+
+void MultiThread_chunked_system_w_fixed_src(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position), .src.id = e }},
+        .callback = dummy,
+        .multi_threaded = true,
+        .chunk_size = 4
+    });
+
+    set_worker_kind(world, 3);
+
+    main_thread = ecs_os_thread_self();
+
+    ecs_progress(world, 0);
+    test_int(invoked_count, 1);
+
+    ecs_progress(world, 0);
+    test_int(invoked_count, 2);
+
+    ecs_fini(world);
+}
+
+void MultiThread_chunked_system_w_multiple_systems(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int32_t chunk_size = 3;
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = ProgressChunk,
+        .ctx = &chunk_size,
+        .multi_threaded = true,
+        .chunk_size = chunk_size
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = ProgressChunk,
+        .ctx = &chunk_size,
+        .multi_threaded = true,
+        .chunk_size = chunk_size
+    });
+
+    int i, ENTITIES = 100;
+    ecs_entity_t handles[100];
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    set_worker_kind(world, 4);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 4);
+    }
+
+    ecs_fini(world);
+}
+
+static int32_t write_done_count = 0;
+static int32_t read_before_write_count = 0;
+
+static void WritePosition(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        /* Make the system slow enough for other threads to catch up */
+        ecs_os_sleep(0, 100 * 1000);
+        p[i].x = 10;
+        ecs_os_ainc(&write_done_count);
+    }
+}
+
+static void ReadPosition(ecs_iter_t *it) {
+    const Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        if (p[i].x != 10) {
+            ecs_os_ainc(&read_before_write_count);
+        }
+    }
+}
+
+void MultiThread_chunked_systems_w_conflicting_access(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position), .inout = EcsOut }},
+        .callback = WritePosition,
+        .multi_threaded = true,
+        .chunk_size = 1
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .callback = ReadPosition,
+        .multi_threaded = true,
+        .chunk_size = 1
+    });
+
+    int i;
+    for (i = 0; i < 20; i ++) {
+        ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    set_worker_kind(world, 4);
+
+    ecs_progress(world, 0);
+
+    test_int(write_done_count, 20);
+    test_int(read_before_write_count, 0);
+
+    ecs_fini(world);
+}
+
+void MultiThread_chunked_and_static_systems_w_conflicting_access(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position), .inout = EcsOut }},
+        .callback = WritePosition,
+        .multi_threaded = true,
+        .chunk_size = 1
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .callback = ReadPosition,
+        .multi_threaded = true
+    });
+
+    int i;
+    for (i = 0; i < 20; i ++) {
+        ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    set_worker_kind(world, 4);
+
+    ecs_progress(world, 0);
+
+    test_int(write_done_count, 20);
+    test_int(read_before_write_count, 0);
+
+    ecs_fini(world);
+}
+
+static int32_t system_b_started = 0;
+static int32_t system_a_timed_out = 0;
+
+static void WaitForSystemB(ecs_iter_t *it) {
+    (void)it;
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        if (ecs_os_ainc(&system_b_started) > 1) {
+            return;
+        }
+        ecs_os_adec(&system_b_started);
+        ecs_os_sleep(0, 1000 * 1000);
+    }
+    ecs_os_ainc(&system_a_timed_out);
+}
+
+static void StartSystemB(ecs_iter_t *it) {
+    (void)it;
+    ecs_os_ainc(&system_b_started);
+}
+
+void MultiThread_chunked_systems_w_independent_access(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = WaitForSystemB,
+        .multi_threaded = true,
+        .chunk_size = 100
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Velocity) }},
+        .callback = StartSystemB,
+        .multi_threaded = true,
+        .chunk_size = 100
+    });
+
+    ecs_insert(world, ecs_value(Position, {0, 0}));
+    ecs_insert(world, ecs_value(Velocity, {0, 0}));
+
+    set_worker_kind(world, 2);
+
+    ecs_progress(world, 0);
+
+    /* System A only returns once system B has started, which can only happen
+     * when both systems run at the same time on different threads. */
+    test_int(system_a_timed_out, 0);
+
+    ecs_fini(world);
+}
+
+static
+void test_worker_spin(int32_t THREADS, int32_t SPIN, int32_t YIELD) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Progress,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsPostUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Progress,
+        .multi_threaded = true
+    });
+
+    int i, ENTITIES = 100;
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    set_worker_kind(world, THREADS);
+    ecs_set_worker_spin(world, SPIN, YIELD);
+
+    int f, FRAMES = 50;
+    for (f = 0; f < FRAMES; f ++) {
+        ecs_progress(world, 0);
+    }
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, FRAMES * 2);
+    }
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_w_worker_spin(void) {
+    test_worker_spin(6, 1000, 0);
+}
+
+void MultiThread_6_thread_w_worker_yield(void) {
+    test_worker_spin(6, 0, 10);
+}
+
+void MultiThread_6_thread_w_worker_spin_and_yield(void) {
+    test_worker_spin(6, 100, 10);
+}
+
+void MultiThread_worker_spin_w_conflicting_access(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int32_t chunk_size = 3;
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = ProgressChunk,
+        .ctx = &chunk_size,
+        .multi_threaded = true,
+        .chunk_size = chunk_size
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = ProgressChunk,
+        .ctx = &chunk_size,
+        .multi_threaded = true,
+        .chunk_size = chunk_size
+    });
+
+    int i, ENTITIES = 100;
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_insert(world, ecs_value(Position, {0, 0}));
+    }
+
+    set_worker_kind(world, 4);
+    ecs_set_worker_spin(world, 100, 10);
+
+    int f, FRAMES = 10;
+    for (f = 0; f < FRAMES; f ++) {
+        ecs_progress(world, 0);
+    }
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, FRAMES * 2);
+    }
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+static ecs_os_api_sleep_t worker_sleep_orig;
+static int32_t worker_sleep_count = 0;
+
+static
+void CountWorkerSleep(int32_t sec, int32_t nanosec) {
+    ecs_os_ainc(&worker_sleep_count);
+    worker_sleep_orig(sec, nanosec);
+}
+
+static
+int32_t test_worker_idle_yields(int32_t SPIN, int32_t YIELD) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = Progress,
+        .multi_threaded = true
+    });
+
+    ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    set_worker_kind(world, 4);
+    ecs_set_worker_spin(world, SPIN, YIELD);
+
+    worker_sleep_orig = ecs_os_api.sleep_;
+    ecs_os_api.sleep_ = CountWorkerSleep;
+
+    ecs_progress(world, 0);
+
+    /* Give workers time to run out of their spin and yield budget */
+    worker_sleep_orig(0, 50 * 1000 * 1000);
+
+    /* Idle workers must be blocked, and no longer yield */
+    int32_t count = worker_sleep_count;
+    worker_sleep_orig(0, 50 * 1000 * 1000);
+    test_int(worker_sleep_count, count);
+
+    ecs_os_api.sleep_ = worker_sleep_orig;
+    worker_sleep_count = 0;
+
+    ecs_fini(world);
+
+    return count;
+}
+
+void MultiThread_worker_idle_default_no_spin(void) {
+    /* By default workers block without spinning or yielding */
+    test_int(test_worker_idle_yields(0, 0), 0);
+}
+
+void MultiThread_worker_idle_w_spin_blocks(void) {
+    test_worker_idle_yields(1000, 10);
+}
+
+static ecs_entity_t merge_targets[64];
+static int32_t merge_target_count = 0;
+static int32_t merge_on_set_count = 0;
+
+static void SetTargets(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < merge_target_count; j ++) {
+            if ((j % ecs_get_stage_count(it->world)) == stage_id) {
+                const Position *p = ecs_get(it->world, merge_targets[j], Position);
+                ecs_set(it->world, merge_targets[j], Position, {p->x + 1, p->y});
+            }
+        }
+    }
+}
+
+static void SetTargetsFromAllStages(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < merge_target_count; j ++) {
+            ecs_set(it->world, merge_targets[j], Position, {stage_id, j});
+        }
+    }
+}
+
+static ecs_id_t merge_target_pair = 0;
+
+static void AddPairAndSetTargets(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < merge_target_count; j ++) {
+            if ((j % ecs_get_stage_count(it->world)) == stage_id) {
+                const Position *p = ecs_get(it->world, merge_targets[j], Position);
+                ecs_add_id(it->world, merge_targets[j], merge_target_pair);
+                ecs_set(it->world, merge_targets[j], Position, {p->x + 1, p->y});
+            }
+        }
+    }
+}
+
+static void RemoveAndSetTarget(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        if (stage_id == 0) {
+            ecs_remove(it->world, merge_targets[0], Position);
+            ecs_remove_all(it->world, ecs_id(Position));
+        } else if (stage_id == 1) {
+            ecs_set(it->world, merge_targets[0], Position, {10, 20});
+            ecs_set(it->world, merge_targets[1], Position, {30, 40});
+        }
+    }
+}
+
+static void OnSetPosition(ecs_iter_t *it) {
+    ecs_os_ainc(&merge_on_set_count);
+}
+
+void MultiThread_parallel_merge_set(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetTargets,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    int i;
+    merge_target_count = 64;
+    for (i = 0; i < merge_target_count; i ++) {
+        merge_targets[i] = ecs_insert(world, ecs_value(Position, {0, i}));
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 1);
+        test_int(p->y, i);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 2);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_set_w_observer(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetTargets,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = OnSetPosition
+    });
+
+    int i;
+    merge_target_count = 64;
+    for (i = 0; i < merge_target_count; i ++) {
+        merge_targets[i] = ecs_insert(world, ecs_value(Position, {0, i}));
+    }
+
+    merge_on_set_count = 0;
+
+    ecs_progress(world, 0);
+
+    test_int(merge_on_set_count, merge_target_count);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 1);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_set_from_all_stages(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetTargetsFromAllStages,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    int i;
+    merge_target_count = 16;
+    for (i = 0; i < merge_target_count; i ++) {
+        merge_targets[i] = ecs_insert(world, ecs_value(Position, {-1, -1}));
+    }
+
+    ecs_progress(world, 0);
+
+    /* Value of last stage wins, same as a serial merge */
+    for (i = 0; i < merge_target_count; i ++) {
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 5);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_set_new_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetTargetsFromAllStages,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    int i;
+    merge_target_count = 16;
+    for (i = 0; i < merge_target_count; i ++) {
+        /* Half of the entities don't have the component yet */
+        if (i % 2) {
+            merge_targets[i] = ecs_insert(world, ecs_value(Position, {-1, -1}));
+        } else {
+            merge_targets[i] = ecs_new(world);
+        }
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 5);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_remove_and_set(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = RemoveAndSetTarget,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 2);
+
+    set_worker_kind(world, 2);
+    ecs_set_parallel_merge(world, true);
+
+    merge_target_count = 2;
+    merge_targets[0] = ecs_insert(world, ecs_value(Position, {1, 2}));
+    merge_targets[1] = ecs_insert(world, ecs_value(Position, {3, 4}));
+
+    ecs_progress(world, 0);
+
+    /* Set is enqueued by stage 1, after the remove of stage 0 */
+    const Position *p = ecs_get(world, merge_targets[0], Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    p = ecs_get(world, merge_targets[1], Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_add_existing_pair(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = AddPairAndSetTargets,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    ecs_entity_t rel = ecs_new(world);
+    ecs_entity_t tgt = ecs_new(world);
+    merge_target_pair = ecs_pair(rel, tgt);
+
+    int i;
+    merge_target_count = 64;
+    for (i = 0; i < merge_target_count; i ++) {
+        merge_targets[i] = ecs_insert(world, ecs_value(Position, {0, i}));
+        /* Half of the entities already have the pair */
+        if (i % 2) {
+            ecs_add_id(world, merge_targets[i], merge_target_pair);
+        }
+    }
+
+    ecs_table_t *table = ecs_get_table(world, merge_targets[1]);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        test_assert(ecs_has_id(world, merge_targets[i], merge_target_pair));
+        test_assert(ecs_get_table(world, merge_targets[i]) == table);
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 1);
+        test_int(p->y, i);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        test_assert(ecs_get_table(world, merge_targets[i]) == table);
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 2);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+static ecs_entity_t merge_velocity = 0;
+
+static void SetPositionAndVelocity(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    if (stage_id == 0) {
+        ecs_set(it->world, merge_targets[0], Position, {1, 2});
+    } else if (stage_id == 1) {
+        Velocity v = {2, 0};
+        ecs_set_id(it->world, merge_targets[0], merge_velocity, 
+            sizeof(Velocity), &v);
+    }
+}
+
+static void OnSetPositionIncVelocity(ecs_iter_t *it) {
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        const Velocity *v = ecs_get_id(
+            it->world, it->entities[i], merge_velocity);
+        Velocity nv = {v->x + 100, 0};
+        ecs_set_id(it->world, it->entities[i], merge_velocity, 
+            sizeof(Velocity), &nv);
+    }
+}
+
+static
+float test_parallel_merge_observer_writes(bool parallel) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetPositionAndVelocity,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 2);
+
+    set_worker_kind(world, 2);
+    ecs_set_parallel_merge(world, parallel);
+
+    ECS_COMPONENT(world, Velocity);
+    merge_velocity = ecs_id(Velocity);
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = OnSetPositionIncVelocity
+    });
+
+    merge_target_count = 1;
+    merge_targets[0] = ecs_insert(world, 
+        ecs_value(Position, {0, 0}), ecs_value(Velocity, {0, 0}));
+
+    ecs_progress(world, 0);
+
+    float result = ecs_get(world, merge_targets[0], Velocity)->x;
+
+    ecs_fini(world);
+
+    return result;
+}
+
+void MultiThread_parallel_merge_observer_writes_set_component(void) {
+    /* The OnSet observer for the value of stage 0 writes a component that is
+     * also set by stage 1, so the result must match a serial merge. */
+    float serial = test_parallel_merge_observer_writes(false);
+    float parallel = test_parallel_merge_observer_writes(true);
+    test_flt(parallel, serial);
+}
+
+static ecs_entity_t merge_order_rel = 0;
+static float merge_order[8];
+static int32_t merge_order_count = 0;
+
+static void SetTargetInStageOrder(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    Position p = {stage_id + 1, 0};
+    if (merge_order_rel) {
+        ecs_set_pair(it->world, merge_targets[0], Position, merge_order_rel, 
+            {p.x, p.y});
+    } else {
+        ecs_set_ptr(it->world, merge_targets[0], Position, &p);
+    }
+}
+
+static void OnSetRecordOrder(ecs_iter_t *it) {
+    ecs_id_t id = ecs_id(Position);
+    if (merge_order_rel) {
+        id = ecs_pair(ecs_id(Position), merge_order_rel);
+    }
+
+    if (it->event_id != id) {
+        return;
+    }
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        const Position *p = ecs_get_id(it->world, it->entities[i], id);
+        test_assert(merge_order_count < 8);
+        merge_order[merge_order_count ++] = p->x;
+    }
+}
+
+static
+void test_parallel_merge_observer_order(
+    bool parallel,
+    bool pair)
+{
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetTargetInStageOrder,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 2);
+
+    set_worker_kind(world, 2);
+    ecs_set_parallel_merge(world, parallel);
+
+    merge_order_rel = pair ? ecs_new(world) : 0;
+    merge_target_count = 1;
+    merge_targets[0] = ecs_new(world);
+    if (pair) {
+        ecs_set_pair(world, merge_targets[0], Position, merge_order_rel, {0, 0});
+    } else {
+        ecs_set(world, merge_targets[0], Position, {0, 0});
+    }
+
+    /* Wildcard observers don't set observer flags on the component record */
+    ecs_observer(world, {
+        .query.terms = {{ pair 
+            ? ecs_pair(ecs_id(Position), EcsWildcard) : EcsWildcard }},
+        .events = { EcsOnSet },
+        .callback = OnSetRecordOrder
+    });
+
+    merge_order_count = 0;
+
+    ecs_progress(world, 0);
+
+    ecs_fini(world);
+}
+
+void MultiThread_parallel_merge_wildcard_observer_order(void) {
+    /* Values must be observed in the order they were set, like with a serial
+     * merge. */
+    test_parallel_merge_observer_order(true, false);
+    test_int(merge_order_count, 2);
+    test_flt(merge_order[0], 1);
+    test_flt(merge_order[1], 2);
+
+    test_parallel_merge_observer_order(false, false);
+    test_int(merge_order_count, 2);
+    test_flt(merge_order[0], 1);
+    test_flt(merge_order[1], 2);
+}
+
+void MultiThread_parallel_merge_pair_wildcard_observer_order(void) {
+    test_parallel_merge_observer_order(true, true);
+    test_int(merge_order_count, 2);
+    test_flt(merge_order[0], 1);
+    test_flt(merge_order[1], 2);
+
+    test_parallel_merge_observer_order(false, true);
+    test_int(merge_order_count, 2);
+    test_flt(merge_order[0], 1);
+    test_flt(merge_order[1], 2);
+}
+
+void MultiThread_parallel_merge_merged_count(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = SetTargets,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    int i;
+    merge_target_count = 64;
+    for (i = 0; i < merge_target_count; i ++) {
+        merge_targets[i] = ecs_insert(world, ecs_value(Position, {0, i}));
+    }
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+    test_int(info->cmd.parallel_merged_count, 0);
+
+    ecs_progress(world, 0);
+
+    /* Each target is set once per frame */
+    test_int(info->cmd.parallel_merged_count, merge_target_count);
+
+    ecs_progress(world, 0);
+    test_int(info->cmd.parallel_merged_count, 2 * merge_target_count);
+
+    /* Observer for any component prevents merging in parallel */
+    ecs_observer(world, {
+        .query.terms = {{ EcsWildcard }},
+        .events = { EcsOnSet },
+        .callback = OnSetPosition
+    });
+
+    merge_on_set_count = 0;
+    ecs_progress(world, 0);
+    test_int(info->cmd.parallel_merged_count, 2 * merge_target_count);
+    test_int(merge_on_set_count, merge_target_count);
+
+    ecs_set_parallel_merge(world, false);
+    ecs_progress(world, 0);
+    test_int(info->cmd.parallel_merged_count, 2 * merge_target_count);
+
+    for (i = 0; i < merge_target_count; i ++) {
+        const Position *p = ecs_get(world, merge_targets[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 4);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+static int32_t new_entity_count = 0;
+
+static void NewEntities(ecs_iter_t *it) {
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < new_entity_count; j ++) {
+            ecs_entity_t e = ecs_new(it->world);
+            test_assert(e != 0);
+            ecs_set(it->world, e, Position, {stage_id, j});
+        }
+    }
+}
+
+static void NewEntitiesWithId(ecs_iter_t *it) {
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < new_entity_count; j ++) {
+            ecs_entity_t e = ecs_new_w_id(it->world, ecs_id(Position));
+            test_assert(e != 0);
+        }
+    }
+}
+
+static void NewAndDeleteEntities(ecs_iter_t *it) {
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < new_entity_count; j ++) {
+            ecs_entity_t e = ecs_new(it->world);
+            ecs_set(it->world, e, Position, {10, 20});
+            if (j % 2) {
+                ecs_delete(it->world, e);
+            }
+        }
+    }
+}
+
+static int32_t new_entity_read_count = 0;
+
+static void NewEntitiesRead(ecs_iter_t *it) {
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_entity_t e = ecs_new(it->world);
+        test_assert(e != 0);
+        test_assert(ecs_is_alive(it->world, e));
+        ecs_set(it->world, e, Position, {10, 20});
+
+        /* Entity is not merged yet, so it doesn't have any components */
+        test_assert(!ecs_has(it->world, e, Position));
+        test_assert(!ecs_owns(it->world, e, Position));
+        test_assert(ecs_get(it->world, e, Position) == NULL);
+        test_assert(ecs_get_parent(it->world, e) == 0);
+        test_assert(ecs_get_target(it->world, e, EcsIsA, 0) == 0);
+        test_assert(ecs_get_name(it->world, e) == NULL);
+        test_assert(ecs_get_table(it->world, e) == NULL);
+
+        char *path = ecs_get_path(it->world, e);
+        test_assert(path != NULL);
+        ecs_os_free(path);
+
+        ecs_os_ainc(&new_entity_read_count);
+    }
+}
+
+static
+void test_new_entities(ecs_world_t *world, int32_t expect) {
+    test_int(ecs_count(world, Position), expect);
+
+    int32_t found[6][200] = {{0}};
+    ecs_iter_t it = ecs_each(world, Position);
+    while (ecs_each_next(&it)) {
+        Position *p = ecs_field(&it, Position, 0);
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            test_assert(ecs_is_alive(world, it.entities[i]));
+            test_assert(p[i].x >= 0 && p[i].x < 6);
+            test_assert(p[i].y >= 0 && p[i].y < 200);
+            found[(int)p[i].x][(int)p[i].y] ++;
+        }
+    }
+
+    int s, i;
+    for (s = 0; s < 6; s ++) {
+        for (i = 0; i < new_entity_count; i ++) {
+            test_int(found[s][i], expect / (6 * new_entity_count));
+        }
+    }
+}
+
+void MultiThread_new_entities_from_workers(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewEntities,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    new_entity_count = 100;
+    ecs_progress(world, 0);
+    test_new_entities(world, 600);
+
+    ecs_progress(world, 0);
+    test_new_entities(world, 1200);
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_entities_from_workers_read(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewEntitiesRead,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+
+    new_entity_read_count = 0;
+    ecs_progress(world, 0);
+    test_int(new_entity_read_count, 6);
+
+    /* Entities have their components after the merge */
+    ecs_iter_t it = ecs_each(world, Position);
+    int32_t count = 0;
+    while (ecs_each_next(&it)) {
+        Position *p = ecs_field(&it, Position, 0);
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            test_assert(ecs_has(world, it.entities[i], Position));
+            test_int(p[i].x, 10);
+            test_int(p[i].y, 20);
+        }
+        count += it.count;
+    }
+    test_int(count, 6);
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_entities_from_workers_grow(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewEntities,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    new_entity_count = 100;
+    ecs_progress(world, 0);
+    test_new_entities(world, 600);
+
+    /* More ids than initially reserved */
+    new_entity_count = 150;
+    ecs_delete_with(world, ecs_id(Position));
+    ecs_progress(world, 0);
+    test_new_entities(world, 900);
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_entities_from_workers_exceed_reserved(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewEntitiesWithId,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    /* More ids than reserved are created in a single phase */
+    new_entity_count = FLECS_ENTITY_RESERVE_COUNT;
+    ecs_progress(world, 0);
+    test_int(ecs_count(world, Position), 6 * FLECS_ENTITY_RESERVE_COUNT);
+
+    ecs_progress(world, 0);
+    test_int(ecs_count(world, Position), 12 * FLECS_ENTITY_RESERVE_COUNT);
+
+    ecs_iter_t it = ecs_each(world, Position);
+    while (ecs_each_next(&it)) {
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            test_assert(ecs_is_alive(world, it.entities[i]));
+        }
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_w_id_from_workers(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewEntitiesWithId,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    new_entity_count = 50;
+    ecs_progress(world, 0);
+    test_int(ecs_count(world, Position), 300);
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_and_delete_from_workers(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewAndDeleteEntities,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    new_entity_count = 50;
+    ecs_progress(world, 0);
+    test_int(ecs_count(world, Position), 150);
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_entities_unused_ids_recycled(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ Tag }},
+        .callback = NewEntities,
+        .multi_threaded = true
+    });
+
+    /* One driver entity per thread */
+    ecs_bulk_new_w_id(world, Tag, 6);
+
+    set_worker_kind(world, 6);
+    ecs_set_parallel_merge(world, true);
+
+    new_entity_count = 0;
+    ecs_entity_t e = ecs_new(world);
+    ecs_delete(world, e);
+    int32_t alive = ecs_get_entities(world).alive_count;
+
+    ecs_progress(world, 0);
+
+    /* Reserved ids that weren't used are no longer alive */
+    test_int(ecs_get_entities(world).alive_count, alive);
+    test_assert(!ecs_is_alive(world, e));
+
+    /* Recycled id is not affected by reservation */
+    ecs_entity_t e2 = ecs_new(world);
+    test_assert(e2 != e);
+    test_int((uint32_t)e2, (uint32_t)e);
+
+    ecs_fini(world);
+}
+
+static int32_t bulk_ctor_invoked = 0;
+static int32_t bulk_ctor_count = 0;
+static int32_t bulk_move_invoked = 0;
+static int32_t bulk_on_add_invoked = 0;
+static int32_t bulk_on_add_count = 0;
+
+typedef struct {
+    int32_t value;
+} Counter;
+
+static ECS_COMPONENT_DECLARE(Counter);
+
+static
+void Counter_ctor(void *ptr, int32_t count, const ecs_type_info_t *ti) {
+    (void)ti;
+    Counter *c = ptr;
+    int i;
+    for (i = 0; i < count; i ++) {
+        c[i].value = 10;
+        ecs_os_ainc(&bulk_ctor_count);
+    }
+    ecs_os_ainc(&bulk_ctor_invoked);
+}
+
+static
+void Counter_move(void *dst_ptr, void *src_ptr, int32_t count, 
+    const ecs_type_info_t *ti) 
+{
+    (void)ti;
+    Counter *dst = dst_ptr, *src = src_ptr;
+    int i;
+    for (i = 0; i < count; i ++) {
+        dst[i].value = src[i].value;
+        src[i].value = 0;
+    }
+    ecs_os_ainc(&bulk_move_invoked);
+}
+
+static
+void Counter_on_add(ecs_iter_t *it) {
+    bulk_on_add_invoked ++;
+    bulk_on_add_count += it->count;
+
+    /* Value is constructed before OnAdd hook */
+    Counter *c = ecs_field(it, Counter, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        test_int(c[i].value, 10);
+    }
+}
+
+void MultiThread_bulk_init_parallel(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    set_worker_kind(world, 4);
+
+    int32_t i, count = 4 * FLECS_BULK_PARALLEL_MIN_COUNT + 3;
+    Position *p = ecs_os_malloc_n(Position, count);
+    for (i = 0; i < count; i ++) {
+        p[i].x = i;
+        p[i].y = i * 2;
+    }
+
+    const ecs_entity_t *ids = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = count,
+        .ids = { ecs_id(Position) },
+        .data = (void*[]){ p },
+        .parallel = true
+    });
+    test_assert(ids != NULL);
+
+    ecs_entity_t *entities = ecs_os_memdup_n(ids, ecs_entity_t, count);
+    test_int(ecs_count(world, Position), count);
+
+    for (i = 0; i < count; i ++) {
+        const Position *ptr = ecs_get(world, entities[i], Position);
+        test_assert(ptr != NULL);
+        test_int(ptr->x, i);
+        test_int(ptr->y, i * 2);
+    }
+
+    /* Workers can still run the pipeline */
+    ecs_progress(world, 0);
+
+    ecs_os_free(entities);
+    ecs_os_free(p);
+    ecs_fini(world);
+}
+
+void MultiThread_bulk_init_parallel_w_hooks(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Counter);
+
+    ecs_set_hooks(world, Counter, {
+        .ctor = Counter_ctor,
+        .move = Counter_move,
+        .on_add = Counter_on_add
+    });
+
+    set_worker_kind(world, 4);
+
+    int32_t i, count = 4 * FLECS_BULK_PARALLEL_MIN_COUNT;
+    Counter *c = ecs_os_malloc_n(Counter, count);
+    for (i = 0; i < count; i ++) {
+        c[i].value = i + 100;
+    }
+
+    const ecs_entity_t *ids = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = count,
+        .ids = { ecs_id(Counter) },
+        .data = (void*[]){ c },
+        .parallel = true
+    });
+    test_assert(ids != NULL);
+
+    /* Task threads only exist while running a pipeline, so values are 
+     * initialized on the calling thread. */
+    int32_t invoked = 4;
+    if (ecs_using_task_threads(world)) {
+        invoked = 1;
+    }
+
+    test_int(bulk_ctor_invoked, invoked);
+    test_int(bulk_ctor_count, count);
+    test_int(bulk_move_invoked, invoked);
+    test_int(bulk_on_add_invoked, 1);
+    test_int(bulk_on_add_count, count);
+
+    for (i = 0; i < count; i ++) {
+        const Counter *ptr = ecs_get(world, ids[i], Counter);
+        test_assert(ptr != NULL);
+        test_int(ptr->value, i + 100);
+        test_int(c[i].value, 0);
+    }
+
+    ecs_os_free(c);
+    ecs_fini(world);
+}
+
+static int32_t bulk_on_set_invoked = 0;
+static int32_t bulk_on_set_count = 0;
+
+static
+void BulkOnSet(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        test_int(p[i].x, 1);
+        test_int(p[i].y, 2);
+    }
+
+    bulk_on_set_invoked ++;
+    bulk_on_set_count += it->count;
+}
+
+void MultiThread_bulk_init_parallel_w_observer(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    set_worker_kind(world, 4);
+
+    bulk_on_set_invoked = 0;
+    bulk_on_set_count = 0;
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = BulkOnSet
+    });
+
+    int32_t i, count = 4 * FLECS_BULK_PARALLEL_MIN_COUNT;
+    Position *p = ecs_os_malloc_n(Position, count);
+    for (i = 0; i < count; i ++) {
+        p[i] = (Position){1, 2};
+    }
+
+    ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = count,
+        .ids = { ecs_id(Position) },
+        .data = (void*[]){ p },
+        .parallel = true
+    });
+
+    test_int(bulk_on_set_invoked, 1);
+    test_int(bulk_on_set_count, count);
+    test_int(ecs_count(world, Position), count);
+
+    ecs_os_free(p);
+    ecs_fini(world);
+}
+
+void MultiThread_bulk_init_parallel_below_min_count(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Counter);
+
+    ecs_set_hooks(world, Counter, {
+        .ctor = Counter_ctor,
+        .move = Counter_move,
+        .on_add = Counter_on_add
+    });
+
+    set_worker_kind(world, 4);
+
+    int32_t i, count = FLECS_BULK_PARALLEL_MIN_COUNT;
+    Counter *c = ecs_os_malloc_n(Counter, count);
+    for (i = 0; i < count; i ++) {
+        c[i].value = i;
+    }
+
+    const ecs_entity_t *ids = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = count,
+        .ids = { ecs_id(Counter) },
+        .data = (void*[]){ c },
+        .parallel = true
+    });
+    test_assert(ids != NULL);
+
+    /* Initialized on the calling thread */
+    test_int(bulk_ctor_invoked, 1);
+    test_int(bulk_ctor_count, count);
+    test_int(bulk_move_invoked, 1);
+    test_int(bulk_on_add_invoked, 1);
+
+    for (i = 0; i < count; i ++) {
+        const Counter *ptr = ecs_get(world, ids[i], Counter);
+        test_assert(ptr != NULL);
+        test_int(ptr->value, i);
+    }
+
+    ecs_os_free(c);
+    ecs_fini(world);
+}
+
+void MultiThread_bulk_init_parallel_w_tag_and_sparse(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    set_worker_kind(world, 4);
+
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t Sparse = ecs_component(world, {
+        .entity = ecs_entity(world, { .name = "SparsePosition" }),
+        .type.size = ECS_SIZEOF(Position),
+        .type.alignment = ECS_ALIGNOF(Position)
+    });
+    ecs_add_id(world, Sparse, EcsSparse);
+
+    int32_t i, count = 4 * FLECS_BULK_PARALLEL_MIN_COUNT;
+    Position *p = ecs_os_malloc_n(Position, count);
+    Position *s = ecs_os_malloc_n(Position, count);
+    for (i = 0; i < count; i ++) {
+        p[i] = (Position){i, 0};
+        s[i] = (Position){0, i};
+    }
+
+    const ecs_entity_t *ids = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+        .count = count,
+        .ids = { ecs_id(Position), Tag, Sparse },
+        .data = (void*[]){ p, NULL, s },
+        .parallel = true
+    });
+    test_assert(ids != NULL);
+
+    for (i = 0; i < count; i ++) {
+        test_assert(ecs_has(world, ids[i], Tag));
+        const Position *ptr = ecs_get(world, ids[i], Position);
+        test_assert(ptr != NULL);
+        test_int(ptr->x, i);
+        ptr = ecs_get_id(world, ids[i], Sparse);
+        test_assert(ptr != NULL);
+        test_int(ptr->y, i);
+    }
+
+    ecs_os_free(p);
+    ecs_os_free(s);
+    ecs_fini(world);
+}
+
+static int32_t propagate_invoked = 0;
+
+static
+void PropagatePosition(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    const Velocity *v = ecs_field(it, Velocity, 1);
+    const Position *parent = ecs_field(it, Position, 2);
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x = v[i].x;
+        p[i].y = v[i].y;
+        if (parent) {
+            p[i].x += parent->x;
+            p[i].y += parent->y;
+        }
+    }
+
+    ecs_os_ainc(&propagate_invoked);
+}
+
+void MultiThread_propagate_parallel(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    set_worker_kind(world, 4);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[out] Position(self), [in] Velocity(self), "
+                "[in] ?Position(cascade ChildOf)",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectChanges
+    });
+    test_assert(q != NULL);
+
+    /* Enough children per depth to split them up across threads */
+    int32_t i, count = 1000;
+    ecs_entity_t root = ecs_insert(world, 
+        ecs_value(Position, {0, 0}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t *children = ecs_os_malloc_n(ecs_entity_t, count);
+    ecs_entity_t *grandchildren = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        children[i] = ecs_new_w_pair(world, EcsChildOf, root);
+        ecs_set(world, children[i], Position, {0, 0});
+        ecs_set(world, children[i], Velocity, {i, 1});
+        grandchildren[i] = ecs_new_w_pair(world, EcsChildOf, children[i]);
+        ecs_set(world, grandchildren[i], Position, {0, 0});
+        ecs_set(world, grandchildren[i], Velocity, {1, i});
+    }
+
+    ecs_query_propagate_desc_t desc = { 
+        .callback = PropagatePosition,
+        .multi_threaded = true
+    };
+
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_assert(propagate_invoked != 0);
+
+    for (i = 0; i < count; i ++) {
+        const Position *p = ecs_get(world, children[i], Position);
+        test_int(p->x, 1 + i);
+        test_int(p->y, 3);
+        p = ecs_get(world, grandchildren[i], Position);
+        test_int(p->x, 2 + i);
+        test_int(p->y, 3 + i);
+    }
+
+    propagate_invoked = 0;
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(propagate_invoked, 0);
+
+    ecs_set(world, root, Velocity, {10, 20});
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_assert(propagate_invoked != 0);
+
+    for (i = 0; i < count; i ++) {
+        const Position *p = ecs_get(world, children[i], Position);
+        test_int(p->x, 10 + i);
+        test_int(p->y, 21);
+        p = ecs_get(world, grandchildren[i], Position);
+        test_int(p->x, 11 + i);
+        test_int(p->y, 21 + i);
+    }
+
+    ecs_os_free(children);
+    ecs_os_free(grandchildren);
+    ecs_query_fini(q);
+    ecs_fini(world);
+}
+
+static
+void ProgressSparse(ecs_iter_t *it) {
+    int32_t *chunk_size = it->param;
+    if (*chunk_size && it->count > *chunk_size) {
+        ecs_os_ainc(&chunk_too_large_count);
+    }
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        Position *p = ecs_field_at(it, Position, 0, i);
+        p->x ++;
+    }
+}
+
+static
+void test_sparse_system(int32_t THREADS, int32_t CHUNK_SIZE) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ecs_add_id(world, ecs_id(Position), EcsDontFragment);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .callback = ProgressSparse,
+        .ctx = &CHUNK_SIZE,
+        .multi_threaded = true,
+        .chunk_size = CHUNK_SIZE
+    });
+
+    int i, ENTITIES = 5000;
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new(world);
+        ecs_set(world, handles[i], Position, {0, 0});
+    }
+
+    set_worker_kind(world, THREADS);
+    chunk_too_large_count = 0;
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    test_int(chunk_too_large_count, 0);
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+void MultiThread_4_thread_sparse_system(void) {
+    test_sparse_system(4, 0);
+}
+
+void MultiThread_4_thread_chunked_sparse_system(void) {
+    test_sparse_system(4, 100);
+}
+
+static
+void ProgressPartition(ecs_iter_t *it) {
+    int32_t *chunk_size = it->param;
+    if (*chunk_size && it->count > *chunk_size) {
+        ecs_os_ainc(&chunk_too_large_count);
+    }
+
+    Position *p = ecs_field(it, Position, 0);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+static
+void test_partition_system(int32_t THREADS, int32_t CHUNK_SIZE) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .query.terms = {{ ecs_id(Position) }},
+        .query.cache_kind = EcsQueryCacheNone,
+        .query.flags = EcsQueryPartitionTables,
+        .callback = ProgressPartition,
+        .ctx = &CHUNK_SIZE,
+        .multi_threaded = true,
+        .chunk_size = CHUNK_SIZE
+    });
+
+    int i, TABLES = 50, ENTITIES = 5000;
+    ecs_entity_t *tags = ecs_os_malloc_n(ecs_entity_t, TABLES);
+    for (i = 0; i < TABLES; i ++) {
+        tags[i] = ecs_new(world);
+    }
+
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new(world);
+        ecs_set(world, handles[i], Position, {0, 0});
+        ecs_add_id(world, handles[i], tags[i % TABLES]);
+    }
+
+    set_worker_kind(world, THREADS);
+    chunk_too_large_count = 0;
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    test_int(chunk_too_large_count, 0);
+
+    ecs_os_free(handles);
+    ecs_os_free(tags);
+
+    ecs_fini(world);
+}
+
+void MultiThread_4_thread_partition_tables_system(void) {
+    test_partition_system(4, 0);
+}
+
+void MultiThread_4_thread_chunked_partition_tables_system(void) {
+    test_partition_system(4, 30);
+}
+
+static int32_t coalesced_invoked = 0;
+static int32_t coalesced_count = 0;
+static int32_t coalesced_stages[8];
+
+static
+void CoalescedSetVelocity(ecs_iter_t *it) {
+    const Position *p = ecs_field(it, Position, 0);
+    ecs_id_t velocity = *(ecs_id_t*)it->ctx;
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        Velocity v = { p[i].x, p[i].y };
+        ecs_set_id(it->world, it->entities[i], velocity, sizeof(Velocity), &v);
+    }
+
+    int32_t stage_id = ecs_stage_get_id(it->world);
+    test_assert(stage_id >= 0 && stage_id < 8);
+    ecs_os_ainc(&coalesced_stages[stage_id]);
+
+    ecs_os_ainc(&coalesced_invoked);
+    for (i = 0; i < it->count; i ++) {
+        ecs_os_ainc(&coalesced_count);
+    }
+}
+
+void MultiThread_coalesced_observer_parallel(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    set_worker_kind(world, 4);
+
+    ecs_id_t velocity = ecs_id(Velocity);
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .events = { EcsOnSet },
+        .callback = CoalescedSetVelocity,
+        .coalesce = true,
+        .multi_threaded = true,
+        .ctx = &velocity
+    });
+    test_assert(o != 0);
+
+    int32_t i, count = 100, table_count = 8;
+    ecs_entity_t *entities = ecs_os_malloc_n(ecs_entity_t, count);
+    ecs_entity_t *tags = ecs_os_malloc_n(ecs_entity_t, table_count);
+    for (i = 0; i < table_count; i ++) {
+        tags[i] = ecs_new(world);
+    }
+
+    /* Spread entities across tables */
+    for (i = 0; i < count; i ++) {
+        entities[i] = ecs_new_w_id(world, tags[i % table_count]);
+        ecs_set(world, entities[i], Position, {i, i * 2});
+        ecs_set(world, entities[i], Position, {i + 1, i * 2});
+    }
+
+    test_int(coalesced_invoked, 0);
+    test_int(ecs_observer_flush(world, o), count);
+    test_assert(coalesced_invoked >= table_count);
+    test_int(coalesced_count, count);
+
+    /* Batches were delivered on more than one stage. Task threads only exist
+     * while the pipeline runs, so the flush delivers on the main thread. */
+    int32_t stages_used = 0;
+    for (i = 0; i < 8; i ++) {
+        if (coalesced_stages[i]) {
+            stages_used ++;
+        }
+    }
+    if (ecs_using_task_threads(world)) {
+        test_int(stages_used, 1);
+    } else {
+        test_assert(stages_used > 1);
+    }
+
+    for (i = 0; i < count; i ++) {
+        const Velocity *v = ecs_get(world, entities[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, i + 1);
+        test_int(v->y, i * 2);
+    }
+
+    coalesced_invoked = 0;
+    coalesced_count = 0;
+    test_int(ecs_observer_flush(world, o), 0);
+    test_int(coalesced_invoked, 0);
+
+    ecs_os_free(tags);
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static
+void CoalescedNewEntity(ecs_iter_t *it) {
+    ecs_id_t velocity = *(ecs_id_t*)it->ctx;
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_entity_t e = ecs_new_w_pair(it->world, EcsChildOf, it->entities[i]);
+        Velocity v = { 1, 2 };
+        ecs_set_id(it->world, e, velocity, sizeof(Velocity), &v);
+    }
+}
+
+void MultiThread_coalesced_observer_parallel_new_entity(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    set_worker_kind(world, 4);
+
+    ecs_id_t velocity = ecs_id(Velocity);
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd },
+        .callback = CoalescedNewEntity,
+        .coalesce = true,
+        .multi_threaded = true,
+        .ctx = &velocity
+    });
+    test_assert(o != 0);
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+    ECS_TAG(world, TagC);
+
+    ecs_entity_t e1 = ecs_new_w(world, Position);
+    ecs_entity_t e2 = ecs_new_w(world, TagA);
+    ecs_add(world, e2, Position);
+    ecs_entity_t e3 = ecs_new_w(world, TagB);
+    ecs_add(world, e3, Position);
+    ecs_entity_t e4 = ecs_new_w(world, TagC);
+    ecs_add(world, e4, Position);
+
+    test_int(ecs_observer_flush(world, o), 4);
+
+    ecs_entity_t parents[] = { e1, e2, e3, e4 };
+    int32_t i;
+    for (i = 0; i < 4; i ++) {
+        ecs_iter_t it = ecs_children(world, parents[i]);
+        test_assert(ecs_children_next(&it));
+        test_int(it.count, 1);
+        test_assert(ecs_is_alive(world, it.entities[0]));
+        const Velocity *v = ecs_get(world, it.entities[0], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, 1);
+        test_int(v->y, 2);
+        test_assert(!ecs_children_next(&it));
+    }
+
+    ecs_entity_t e5 = ecs_new(world);
+    ecs_add(world, e5, Position);
+    test_assert(ecs_new(world) != 0);
+
+    ecs_fini(world);
+}
+
+void MultiThread_coalesced_observer_parallel_phase(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, TagA);
+
+    set_worker_kind(world, 4);
+
+    ecs_id_t velocity = ecs_id(Velocity);
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .events = { EcsOnSet },
+        .callback = CoalescedSetVelocity,
+        .coalesce = true,
+        .coalesce_phase = EcsPostUpdate,
+        .multi_threaded = true,
+        .ctx = &velocity
+    });
+    test_assert(o != 0);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_add(world, e2, TagA);
+
+    ecs_progress(world, 0);
+
+    const Velocity *v = ecs_get(world, e1, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 10);
+    test_int(v->y, 20);
+
+    v = ecs_get(world, e2, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 30);
+    test_int(v->y, 40);
+
+    ecs_set(world, e1, Position, {50, 60});
+    ecs_progress(world, 0);
+
+    v = ecs_get(world, e1, Velocity);
+    test_int(v->x, 50);
+    test_int(v->y, 60);
+
+    ecs_fini(world);
+}
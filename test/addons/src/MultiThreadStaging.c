@@ -43,7 +43,9 @@ void MultiThreadStaging_2_threads_add_to_current(void) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, 100);
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * 100);
 
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, 100);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, 100);
+    ecs_entity_t ids_2[100];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * 100);
 
     ecs_set_threads(world, 2);
 
@@ -86,7 +88,9 @@ void MultiThreadStaging_3_threads_add_to_current(void) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, 100);
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * 100);
 
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, 100);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, 100);
+    ecs_entity_t ids_2[100];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * 100);
 
     ecs_set_threads(world, 3);
 
@@ -129,7 +133,9 @@ void MultiThreadStaging_4_threads_add_to_current(void) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, 100);
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * 100);
 
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, 100);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, 100);
+    ecs_entity_t ids_2[100];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * 100);
 
     ecs_set_threads(world, 4);
 
@@ -172,7 +178,9 @@ void MultiThreadStaging_5_threads_add_to_current(void) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, 100);
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * 100);
 
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, 100);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, 100);
+    ecs_entity_t ids_2[100];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * 100);
 
     ecs_set_threads(world, 5);
 
@@ -215,7 +223,9 @@ void MultiThreadStaging_6_threads_add_to_current(void) {
     const ecs_entity_t *temp_ids_1 = ecs_bulk_new(world, Position, 100);
     memcpy(ids_1, temp_ids_1, sizeof(ecs_entity_t) * 100);
 
-    const ecs_entity_t *ids_2 = bulk_new_w_type(world, Type, 100);
+    const ecs_entity_t *temp_ids_2 = bulk_new_w_type(world, Type, 100);
+    ecs_entity_t ids_2[100];
+    memcpy(ids_2, temp_ids_2, sizeof(ecs_entity_t) * 100);
 
     ecs_set_threads(world, 6);
 
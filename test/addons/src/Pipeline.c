@@ -3535,3 +3535,65 @@ void Pipeline_update_pipeline_replaces_existing(void) {
 
     ecs_fini(world);
 }
+
+static
+void CoalescedObserver(ecs_iter_t *it) {
+    probe_system_w_ctx(it, it->ctx);
+}
+
+static
+void SetPositionTwice(ecs_iter_t *it) {
+    ecs_entity_t e = *(ecs_entity_t*)it->ctx;
+    ecs_set(it->world, e, Position, {1, 2});
+    ecs_set(it->world, e, Position, {3, 4});
+}
+
+void Pipeline_coalesced_observer_phase(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = CoalescedObserver,
+        .coalesce = true,
+        .coalesce_phase = EcsPostUpdate,
+        .ctx = &ctx
+    });
+    test_assert(o != 0);
+    test_assert(ecs_lookup_child(world, o, "Flush") != 0);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Position, {20, 30});
+    test_int(ctx.invoked, 0);
+
+    ecs_progress(world, 0);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_uint(ctx.e[0], e);
+
+    ecs_progress(world, 0);
+    test_int(ctx.invoked, 1);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { 
+            .add = ecs_ids(ecs_dependson(EcsOnUpdate)) 
+        }),
+        .callback = SetPositionTwice,
+        .ctx = &e
+    });
+
+    ecs_progress(world, 0);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 2);
+    test_uint(ctx.e[1], e);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 3);
+    test_int(p->y, 4);
+
+    ecs_fini(world);
+}
@@ -0,0 +1,1008 @@
+#include <addons.h>
+
+static ECS_COMPONENT_DECLARE(Position);
+static ECS_COMPONENT_DECLARE(Velocity);
+static ECS_COMPONENT_DECLARE(StringComponent);
+static ECS_DECLARE(Tag);
+
+static
+ecs_query_t* position_query(
+    ecs_world_t *world)
+{
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+    test_assert(q != NULL);
+    return q;
+}
+
+/* Create diff, apply it to the destination world and acknowledge it */
+static
+void sync(
+    ecs_replicator_t *r,
+    ecs_world_t *dst)
+{
+    ecs_size_t size = 0;
+    uint64_t frame = 0;
+    void *data = ecs_replicator_diff(r, &size, &frame);
+    test_assert(data != NULL);
+    test_assert(frame != 0);
+    test_int(ecs_world_apply_diff(dst, data, size), 0);
+    ecs_os_free(data);
+    ecs_replicator_ack(r, frame);
+}
+
+/* Size of a diff that doesn't contain any entities */
+static
+ecs_size_t empty_diff_size(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_size_t size = 0;
+    void *data = ecs_replicator_diff(r, &size, NULL);
+    test_assert(data != NULL);
+    ecs_os_free(data);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(world);
+    return size;
+}
+
+typedef struct set_count_t {
+    int32_t position;
+    int32_t velocity;
+} set_count_t;
+
+static
+void OnSetPosition(ecs_iter_t *it) {
+    set_count_t *ctx = it->ctx;
+    ctx->position += it->count;
+}
+
+static
+void OnSetVelocity(ecs_iter_t *it) {
+    set_count_t *ctx = it->ctx;
+    ctx->velocity += it->count;
+}
+
+static
+void count_sets(
+    ecs_world_t *world,
+    set_count_t *ctx)
+{
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = OnSetPosition,
+        .ctx = ctx
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_id(Velocity) }},
+        .events = { EcsOnSet },
+        .callback = OnSetVelocity,
+        .ctx = ctx
+    });
+}
+
+void Replication_initial_diff(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world,
+        ecs_value(Position, {30, 40}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Velocity, {3, 4}));
+    ecs_add(world, e2, Tag);
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    ECS_TAG_DEFINE(dst, Tag);
+    sync(r, dst);
+
+    test_assert(ecs_is_alive(dst, e1));
+    test_assert(ecs_is_alive(dst, e2));
+    test_assert(!ecs_is_alive(dst, e3));
+
+    const Position *p = ecs_get(dst, e1, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    p = ecs_get(dst, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    const Velocity *v = ecs_get(dst, e2, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1); test_int(v->y, 2);
+    test_assert(ecs_has(dst, e2, Tag));
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_no_changes(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_insert(world, ecs_value(Position, {30, 40}), ecs_value(Velocity, {1, 2}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    set_count_t ctx = {0};
+    count_sets(dst, &ctx);
+
+    sync(r, dst);
+    test_int(ctx.position, 2);
+    test_int(ctx.velocity, 1);
+
+    sync(r, dst);
+    test_int(ctx.position, 2);
+    test_int(ctx.velocity, 1);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_no_changes_empty_diff(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int32_t i;
+    for (i = 0; i < 1000; i ++) {
+        ecs_insert(world, ecs_value(Position, {i, i * 2}));
+    }
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+    ecs_size_t empty_size = empty_diff_size();
+
+    ecs_size_t size = 0;
+    uint64_t frame = 0;
+    void *data = ecs_replicator_diff(r, &size, &frame);
+    test_assert(data != NULL);
+    test_assert(size > 1000 * ECS_SIZEOF(Position));
+    ecs_os_free(data);
+    ecs_replicator_ack(r, frame);
+
+    /* Unchanged entities don't produce rows */
+    for (i = 0; i < 3; i ++) {
+        data = ecs_replicator_diff(r, &size, &frame);
+        test_assert(data != NULL);
+        test_int(size, empty_size);
+        ecs_os_free(data);
+        ecs_replicator_ack(r, frame);
+    }
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(world);
+}
+
+void Replication_changed_column(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e1 = ecs_insert(world,
+        ecs_value(Position, {10, 20}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e2 = ecs_insert(world,
+        ecs_value(Position, {30, 40}), ecs_value(Velocity, {3, 4}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {50, 60}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    sync(r, dst);
+
+    set_count_t ctx = {0};
+    count_sets(dst, &ctx);
+
+    ecs_set(world, e1, Position, {11, 21});
+
+    sync(r, dst);
+
+    /* Only the Position column of the table with e1 and e2 is sent */
+    test_int(ctx.position, 2);
+    test_int(ctx.velocity, 0);
+
+    const Position *p = ecs_get(dst, e1, Position);
+    test_int(p->x, 11); test_int(p->y, 21);
+    p = ecs_get(dst, e2, Position);
+    test_int(p->x, 30); test_int(p->y, 40);
+    p = ecs_get(dst, e3, Position);
+    test_int(p->x, 50); test_int(p->y, 60);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_modified(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    Position *p = ecs_ensure(world, e, Position);
+    p->x = 11;
+    ecs_modified(world, e, Position);
+
+    sync(r, dst);
+
+    const Position *dp = ecs_get(dst, e, Position);
+    test_int(dp->x, 11); test_int(dp->y, 20);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_query_write_not_changed(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    /* Position is an [inout] field, which marks the column dirty when the
+     * query is iterated by the application, but not by the replicator. */
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    set_count_t ctx = {0};
+    count_sets(dst, &ctx);
+
+    sync(r, dst);
+    test_int(ctx.position, 1);
+
+    sync(r, dst);
+    test_int(ctx.position, 1);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        Position *p = ecs_field(&it, Position, 0);
+        p[0].x ++;
+    }
+
+    sync(r, dst);
+    test_int(ctx.position, 2);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_new_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    sync(r, dst);
+
+    set_count_t ctx = {0};
+    count_sets(dst, &ctx);
+
+    ecs_entity_t e2 = ecs_insert(world,
+        ecs_value(Position, {30, 40}), ecs_value(Velocity, {1, 2}));
+
+    sync(r, dst);
+
+    /* Only the new entity is sent */
+    test_int(ctx.position, 1);
+    test_int(ctx.velocity, 1);
+
+    test_assert(ecs_is_alive(dst, e2));
+    const Position *p = ecs_get(dst, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    p = ecs_get(dst, e1, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_delete_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+    test_assert(ecs_is_alive(dst, e1));
+    test_assert(ecs_is_alive(dst, e2));
+
+    ecs_delete(world, e1);
+
+    sync(r, dst);
+    test_assert(!ecs_is_alive(dst, e1));
+    test_assert(ecs_is_alive(dst, e2));
+
+    const Position *p = ecs_get(dst, e2, Position);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_recycled_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    ecs_delete(world, e1);
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    test_assert((uint32_t)e1 == (uint32_t)e2);
+    test_assert(e1 != e2);
+
+    sync(r, dst);
+    test_assert(!ecs_is_alive(dst, e1));
+    test_assert(ecs_is_alive(dst, e2));
+
+    const Position *p = ecs_get(dst, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_add_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    ECS_TAG_DEFINE(dst, Tag);
+    sync(r, dst);
+    test_assert(!ecs_has(dst, e, Velocity));
+
+    ecs_set(world, e, Velocity, {1, 2});
+    ecs_add(world, e, Tag);
+
+    sync(r, dst);
+    test_assert(ecs_has(dst, e, Tag));
+
+    const Velocity *v = ecs_get(dst, e, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1); test_int(v->y, 2);
+
+    const Position *p = ecs_get(dst, e, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_remove_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e = ecs_insert(world,
+        ecs_value(Position, {10, 20}), ecs_value(Velocity, {1, 2}));
+    ecs_add(world, e, Tag);
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    ECS_TAG_DEFINE(dst, Tag);
+    sync(r, dst);
+    test_assert(ecs_has(dst, e, Velocity));
+    test_assert(ecs_has(dst, e, Tag));
+
+    ecs_remove(world, e, Velocity);
+    ecs_remove(world, e, Tag);
+
+    sync(r, dst);
+    test_assert(!ecs_has(dst, e, Velocity));
+    test_assert(!ecs_has(dst, e, Tag));
+
+    const Position *p = ecs_get(dst, e, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_no_longer_matches(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    ecs_remove(world, e1, Position);
+
+    sync(r, dst);
+    test_assert(!ecs_is_alive(dst, e1));
+    test_assert(ecs_is_alive(dst, e2));
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_unacked_diff(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    ecs_set(world, e1, Position, {11, 21});
+
+    /* Diff is lost and not acknowledged */
+    ecs_size_t size = 0;
+    uint64_t frame = 0;
+    void *data = ecs_replicator_diff(r, &size, &frame);
+    test_assert(data != NULL);
+    ecs_os_free(data);
+
+    ecs_delete(world, e2);
+
+    /* Next diff contains changes since the last acknowledged frame */
+    sync(r, dst);
+
+    const Position *p = ecs_get(dst, e1, Position);
+    test_int(p->x, 11); test_int(p->y, 21);
+    test_assert(!ecs_is_alive(dst, e2));
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_apply_unacked_diffs(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+
+    ecs_size_t size_1 = 0, size_2 = 0;
+    uint64_t frame_1 = 0, frame_2 = 0;
+    void *data_1 = ecs_replicator_diff(r, &size_1, &frame_1);
+    test_assert(data_1 != NULL);
+
+    ecs_delete(world, e2);
+    ecs_set(world, e1, Position, {11, 21});
+
+    void *data_2 = ecs_replicator_diff(r, &size_2, &frame_2);
+    test_assert(data_2 != NULL);
+    test_assert(frame_2 > frame_1);
+
+    test_int(ecs_world_apply_diff(dst, data_1, size_1), 0);
+    test_assert(ecs_is_alive(dst, e2));
+    test_int(ecs_world_apply_diff(dst, data_2, size_2), 0);
+    test_assert(!ecs_is_alive(dst, e2));
+
+    const Position *p = ecs_get(dst, e1, Position);
+    test_int(p->x, 11); test_int(p->y, 21);
+
+    /* Acknowledging an older frame after a newer frame does nothing */
+    ecs_replicator_ack(r, frame_2);
+    ecs_replicator_ack(r, frame_1);
+
+    ecs_os_free(data_1);
+    ecs_os_free(data_2);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_ack_old_frame(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+
+    ecs_size_t size_1 = 0, size_2 = 0;
+    uint64_t frame_1 = 0, frame_2 = 0;
+    void *data_1 = ecs_replicator_diff(r, &size_1, &frame_1);
+    test_assert(data_1 != NULL);
+
+    ecs_set(world, e, Position, {11, 21});
+
+    /* Diff is lost */
+    ecs_os_free(ecs_replicator_diff(r, &size_2, &frame_2));
+    test_assert(frame_2 > frame_1);
+
+    /* Client acknowledges first frame after the second diff was created */
+    test_int(ecs_world_apply_diff(dst, data_1, size_1), 0);
+    ecs_os_free(data_1);
+    ecs_replicator_ack(r, frame_1);
+
+    const Position *p = ecs_get(dst, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    /* Diff is relative to the first frame */
+    sync(r, dst);
+
+    p = ecs_get(dst, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 11); test_int(p->y, 21);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_ack_frames_w_latency(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+    ecs_size_t empty_size = empty_diff_size();
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+
+    /* Acks arrive two frames after the diff was created */
+    void *data[3] = {0};
+    ecs_size_t size[3] = {0};
+    uint64_t frame[3] = {0};
+    int32_t i;
+    for (i = 0; i < 3; i ++) {
+        data[i] = ecs_replicator_diff(r, &size[i], &frame[i]);
+        test_assert(data[i] != NULL);
+        test_int(ecs_world_apply_diff(dst, data[i], size[i]), 0);
+        if (i >= 2) {
+            ecs_replicator_ack(r, frame[i - 2]);
+        }
+    }
+
+    /* Nothing was acknowledged when the diffs were created */
+    test_assert(size[0] > empty_size);
+    test_assert(size[1] > empty_size);
+    test_assert(size[2] > empty_size);
+
+    /* Acknowledged baseline advances while diffs are in flight */
+    ecs_replicator_ack(r, frame[1]);
+    ecs_size_t next_size = 0;
+    uint64_t next_frame = 0;
+    void *next = ecs_replicator_diff(r, &next_size, &next_frame);
+    test_assert(next != NULL);
+    test_int(next_size, empty_size);
+    ecs_os_free(next);
+
+    ecs_set(world, e, Position, {11, 21});
+    ecs_replicator_ack(r, frame[2]);
+    next = ecs_replicator_diff(r, &next_size, &next_frame);
+    test_assert(next != NULL);
+    test_assert(next_size > empty_size);
+    test_int(ecs_world_apply_diff(dst, next, next_size), 0);
+    ecs_os_free(next);
+
+    const Position *p = ecs_get(dst, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 11); test_int(p->y, 21);
+
+    for (i = 0; i < 3; i ++) {
+        ecs_os_free(data[i]);
+    }
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_hierarchy(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t parent = ecs_entity(world, { .name = "parent" });
+    ecs_set(world, parent, Position, {10, 20});
+    ecs_entity_t child = ecs_entity(world, { .name = "parent.child" });
+    ecs_set(world, child, Position, {30, 40});
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    test_assert(ecs_lookup(dst, "parent") == parent);
+    test_assert(ecs_lookup(dst, "parent.child") == child);
+    test_assert(ecs_has_pair(dst, child, EcsChildOf, parent));
+
+    ecs_set_name(world, child, "child_2");
+
+    sync(r, dst);
+    test_assert(ecs_lookup(dst, "parent.child") == 0);
+    test_assert(ecs_lookup(dst, "parent.child_2") == child);
+
+    ecs_delete(world, parent);
+
+    sync(r, dst);
+    test_assert(!ecs_is_alive(dst, parent));
+    test_assert(!ecs_is_alive(dst, child));
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+static
+void register_string_component(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, StringComponent);
+
+    ecs_struct(world, {
+        .entity = ecs_id(StringComponent),
+        .members = {
+            { .name = "value", .type = ecs_id(ecs_string_t) }
+        }
+    });
+}
+
+void Replication_component_w_reflection(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    register_string_component(world);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+    StringComponent *ptr = ecs_ensure(world, e, StringComponent);
+    ptr->value = ecs_os_strdup("Hello");
+    ecs_modified(world, e, StringComponent);
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    register_string_component(dst);
+    sync(r, dst);
+
+    const StringComponent *c = ecs_get(dst, e, StringComponent);
+    test_assert(c != NULL);
+    test_str(c->value, "Hello");
+
+    ptr = ecs_ensure(world, e, StringComponent);
+    ecs_os_free(ptr->value);
+    ptr->value = ecs_os_strdup("World");
+    ecs_modified(world, e, StringComponent);
+
+    sync(r, dst);
+
+    c = ecs_get(dst, e, StringComponent);
+    test_assert(c != NULL);
+    test_str(c->value, "World");
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_soa_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ecs_struct(world, {
+        .entity = ecs_id(Position),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) }
+        }
+    });
+    ecs_add_id(world, ecs_id(Position), EcsSoA);
+
+    ecs_entity_t x = ecs_lookup(world, "Position.x");
+    ecs_entity_t y = ecs_lookup(world, "Position.y");
+    test_assert(x != 0);
+    test_assert(y != 0);
+
+    ecs_entity_t e = ecs_new_w(world, Position);
+    ecs_f32_t vx = 10, vy = 20;
+    ecs_set_id(world, e, x, sizeof(ecs_f32_t), &vx);
+    ecs_set_id(world, e, y, sizeof(ecs_f32_t), &vy);
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ecs_struct(dst, {
+        .entity = ecs_id(Position),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) }
+        }
+    });
+    ecs_add_id(dst, ecs_id(Position), EcsSoA);
+    sync(r, dst);
+
+    test_assert(ecs_has(dst, e, Position));
+    const ecs_f32_t *px = ecs_get_id(dst, e, x);
+    test_assert(px != NULL);
+    test_flt(*px, 10);
+    const ecs_f32_t *py = ecs_get_id(dst, e, y);
+    test_assert(py != NULL);
+    test_flt(*py, 20);
+
+    vx = 11;
+    ecs_set_id(world, e, x, sizeof(ecs_f32_t), &vx);
+    sync(r, dst);
+
+    px = ecs_get_id(dst, e, x);
+    test_assert(px != NULL);
+    test_flt(*px, 11);
+    py = ecs_get_id(dst, e, y);
+    test_assert(py != NULL);
+    test_flt(*py, 20);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_many_entities(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t entities[1000];
+    int32_t i;
+    for (i = 0; i < 1000; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i * 2}));
+    }
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    for (i = 0; i < 1000; i += 10) {
+        ecs_set(world, entities[i], Position, {i + 1, i});
+    }
+
+    sync(r, dst);
+
+    for (i = 0; i < 1000; i ++) {
+        const Position *p = ecs_get(dst, entities[i], Position);
+        test_assert(p != NULL);
+        if (!(i % 10)) {
+            test_int(p->x, i + 1); test_int(p->y, i);
+        } else {
+            test_int(p->x, i); test_int(p->y, i * 2);
+        }
+    }
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_apply_snapshot_as_diff(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_apply_diff(dst, data, size) != 0);
+    ecs_os_free(data);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_update_entity_not_alive(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    sync(r, dst);
+
+    ecs_delete(dst, e);
+    ecs_set(world, e, Position, {11, 21});
+
+    ecs_size_t size = 0;
+    void *data = ecs_replicator_diff(r, &size, NULL);
+    test_assert(data != NULL);
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_apply_diff(dst, data, size) != 0);
+    ecs_os_free(data);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Replication_corrupt_deleted_count(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_query_t *q = position_query(world);
+    ecs_replicator_t *r = ecs_replicator_new(world, q);
+
+    ecs_size_t size = 0;
+    void *data = ecs_replicator_diff(r, &size, NULL);
+    test_assert(data != NULL);
+    test_assert(size >= 48);
+
+    /* Diff without tables, for which the size of the deleted entity array
+     * overflows a 32 bit integer. */
+    uint64_t buf[16] = {0};
+    ecs_os_memcpy(buf, data, 48);
+    ecs_os_free(data);
+
+    uint32_t *hdr = (uint32_t*)buf;
+    hdr[4] = 0; /* table_count */
+    hdr[5] = 0; /* update_count */
+    hdr[6] = 0x20000001; /* deleted_count */
+    hdr[7] = 0; /* component_count */
+    buf[4] = sizeof(buf); /* components_offset */
+
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_apply_diff(world, buf, ECS_SIZEOF(buf)) != 0);
+
+    /* Table counts that exceed the remaining data */
+    hdr[4] = UINT32_MAX;
+    hdr[5] = UINT32_MAX;
+    hdr[6] = 0;
+    test_assert(ecs_world_apply_diff(world, buf, ECS_SIZEOF(buf)) != 0);
+
+    ecs_replicator_free(r);
+    ecs_query_fini(q);
+    ecs_fini(world);
+}
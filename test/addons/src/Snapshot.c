@@ -0,0 +1,689 @@
+#include <addons.h>
+
+static ECS_COMPONENT_DECLARE(Position);
+static ECS_COMPONENT_DECLARE(Velocity);
+static ECS_COMPONENT_DECLARE(Mass);
+static ECS_COMPONENT_DECLARE(StringComponent);
+static ECS_DECLARE(Tag);
+static ECS_DECLARE(Rel);
+
+static
+void Dummy(ecs_iter_t *it) {
+    (void)it;
+}
+
+/* Restore snapshot of src world in dst world */
+static
+void restore(
+    ecs_world_t *src,
+    ecs_world_t *dst)
+{
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(src, &size);
+    test_assert(data != NULL);
+    test_assert(size != 0);
+
+    test_int(ecs_world_from_binary(dst, data, size), 0);
+    ecs_os_free(data);
+}
+
+void Snapshot_empty_world(void) {
+    ecs_world_t *world = ecs_init();
+    int32_t count = ecs_count_id(world, EcsAny);
+
+    ecs_world_t *dst = ecs_init();
+    restore(world, dst);
+    test_int(ecs_count_id(dst, EcsAny), count);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_entity_t e3 = ecs_insert(world,
+        ecs_value(Position, {50, 60}), ecs_value(Velocity, {1, 2}));
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Velocity);
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, e1));
+    test_assert(ecs_is_alive(dst, e2));
+    test_assert(ecs_is_alive(dst, e3));
+
+    const Position *p = ecs_get(dst, e1, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+    test_assert(!ecs_has(dst, e1, Velocity));
+
+    p = ecs_get(dst, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    p = ecs_get(dst, e3, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 50); test_int(p->y, 60);
+    const Velocity *v = ecs_get(dst, e3, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 1); test_int(v->y, 2);
+
+    test_int(ecs_count(dst, Position), 3);
+    test_int(ecs_count(dst, Velocity), 1);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_many_entities(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int32_t i;
+    ecs_entity_t entities[1000];
+    for (i = 0; i < 1000; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {
+            (float)i, (float)(i * 2) }));
+    }
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    restore(world, dst);
+
+    test_int(ecs_count(dst, Position), 1000);
+
+    for (i = 0; i < 1000; i ++) {
+        const Position *p = ecs_get(dst, entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_entity_t e = ecs_new(dst);
+    for (i = 0; i < 1000; i ++) {
+        test_assert(e != entities[i]);
+    }
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_tag(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e = ecs_new_w_id(world, Tag);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_TAG_DEFINE(dst, Tag);
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, e));
+    test_assert(ecs_has_id(dst, e, Tag));
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_pair(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG_DEFINE(world, Rel);
+
+    ecs_entity_t tgt = ecs_new(world);
+    ecs_entity_t e = ecs_new_w_pair(world, Rel, tgt);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_TAG_DEFINE(dst, Rel);
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, e));
+    test_assert(ecs_is_alive(dst, tgt));
+    test_assert(ecs_has_pair(dst, e, Rel, tgt));
+    test_assert(ecs_get_target(dst, e, Rel, 0) == tgt);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_pair_target_stored_after_source(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Rel);
+
+    /* Create source table before target table */
+    ecs_entity_t tgt = ecs_new(world);
+    ecs_entity_t e = ecs_new_w_pair(world, Rel, tgt);
+    ecs_set(world, tgt, Position, {10, 20});
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_TAG_DEFINE(dst, Rel);
+    restore(world, dst);
+
+    test_assert(ecs_has_pair(dst, e, Rel, tgt));
+    const Position *p = ecs_get(dst, tgt, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    test_int(ecs_count_id(dst, ecs_pair(Rel, EcsWildcard)), 1);
+    ecs_iter_t it = ecs_each_pair(dst, Rel, tgt);
+    test_bool(ecs_each_next(&it), true);
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e);
+    test_bool(ecs_each_next(&it), false);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_name(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t e = ecs_entity(world, { .name = "foo" });
+    ecs_set_alias(world, e, "bar");
+
+    ecs_world_t *dst = ecs_init();
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, e));
+    test_str(ecs_get_name(dst, e), "foo");
+    test_uint(ecs_lookup(dst, "foo"), e);
+    test_uint(ecs_lookup(dst, "bar"), e);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_hierarchy(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t parent = ecs_entity(world, { .name = "parent" });
+    ecs_entity_t child = ecs_entity(world, { .name = "parent.child" });
+    ecs_entity_t grandchild = ecs_entity(world, { .name = "parent.child.gc" });
+    ecs_set(world, grandchild, Position, {10, 20});
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    restore(world, dst);
+
+    test_uint(ecs_lookup(dst, "parent"), parent);
+    test_uint(ecs_lookup(dst, "parent.child"), child);
+    test_uint(ecs_lookup(dst, "parent.child.gc"), grandchild);
+    test_assert(ecs_has_pair(dst, child, EcsChildOf, parent));
+    test_assert(ecs_has_pair(dst, grandchild, EcsChildOf, child));
+
+    const Position *p = ecs_get(dst, grandchild, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    ecs_iter_t it = ecs_children(dst, parent);
+    test_bool(ecs_children_next(&it), true);
+    test_int(it.count, 1);
+    test_uint(it.entities[0], child);
+    test_bool(ecs_children_next(&it), false);
+
+    ecs_delete(dst, parent);
+    test_assert(!ecs_is_alive(dst, child));
+    test_assert(!ecs_is_alive(dst, grandchild));
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_non_fragmenting_hierarchy(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t parent = ecs_entity(world, { .name = "parent" });
+    ecs_entity_t child = ecs_insert(world, ecs_value(EcsParent, {parent}));
+    ecs_set_name(world, child, "child");
+    ecs_entity_t gc = ecs_insert(world, ecs_value(EcsParent, {child}));
+
+    ecs_world_t *dst = ecs_init();
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, child));
+    test_assert(ecs_is_alive(dst, gc));
+    test_uint(ecs_get_parent(dst, child), parent);
+    test_uint(ecs_get_parent(dst, gc), child);
+    test_uint(ecs_lookup(dst, "parent.child"), child);
+
+    ecs_delete(dst, parent);
+    test_assert(!ecs_is_alive(dst, child));
+    test_assert(!ecs_is_alive(dst, gc));
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_prefab_instance(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t base = ecs_entity(world, { .name = "base" });
+    ecs_add_id(world, base, EcsPrefab);
+    ecs_set(world, base, Position, {10, 20});
+    ecs_entity_t base_child = ecs_entity(world, { .name = "base.child" });
+    ecs_add_id(world, base_child, EcsPrefab);
+
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, base);
+    ecs_entity_t inst_child = ecs_lookup_from(world, inst, "child");
+    test_assert(inst_child != 0);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    restore(world, dst);
+
+    test_assert(ecs_has_pair(dst, inst, EcsIsA, base));
+    test_uint(ecs_lookup_from(dst, inst, "child"), inst_child);
+
+    int32_t count = 0;
+    ecs_iter_t it = ecs_children(dst, inst);
+    while (ecs_children_next(&it)) {
+        count += it.count;
+    }
+    test_int(count, 1);
+
+    const Position *p = ecs_get(dst, inst, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_entity_generation(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_delete(world, e);
+    e = ecs_new_w_id(world, Tag);
+    test_assert((uint32_t)(e >> 32) != 0);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_TAG_DEFINE(dst, Tag);
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, e));
+    test_assert(ecs_has_id(dst, e, Tag));
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_sparse_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ECS_COMPONENT_DEFINE(world, Mass);
+    ecs_add_id(world, ecs_id(Mass), EcsSparse);
+
+    ecs_entity_t e1 = ecs_insert(world,
+        ecs_value(Position, {10, 20}), ecs_value(Mass, {100}));
+    ecs_entity_t e2 = ecs_insert(world,
+        ecs_value(Position, {30, 40}), ecs_value(Mass, {200}));
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, Mass);
+    ecs_add_id(dst, ecs_id(Mass), EcsSparse);
+    test_int(ecs_world_from_binary(dst, data, size), 0);
+    ecs_os_free(data);
+
+    const Mass *m = ecs_get(dst, e1, Mass);
+    test_assert(m != NULL);
+    test_int(*m, 100);
+    m = ecs_get(dst, e2, Mass);
+    test_assert(m != NULL);
+    test_int(*m, 200);
+
+    const Position *p = ecs_get(dst, e2, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_soa_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ecs_struct(world, {
+        .entity = ecs_id(Position),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) }
+        }
+    });
+    ecs_add_id(world, ecs_id(Position), EcsSoA);
+
+    ecs_entity_t x = ecs_lookup(world, "Position.x");
+    ecs_entity_t y = ecs_lookup(world, "Position.y");
+    test_assert(x != 0);
+    test_assert(y != 0);
+
+    ecs_entity_t e = ecs_new_w(world, Position);
+    ecs_f32_t vx = 10, vy = 20;
+    ecs_set_id(world, e, x, sizeof(ecs_f32_t), &vx);
+    ecs_set_id(world, e, y, sizeof(ecs_f32_t), &vy);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ecs_struct(dst, {
+        .entity = ecs_id(Position),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) }
+        }
+    });
+    ecs_add_id(dst, ecs_id(Position), EcsSoA);
+    test_uint(ecs_lookup(dst, "Position.x"), x);
+    test_uint(ecs_lookup(dst, "Position.y"), y);
+    restore(world, dst);
+
+    test_assert(ecs_has(dst, e, Position));
+
+    const ecs_f32_t *px = ecs_get_id(dst, e, x);
+    test_assert(px != NULL);
+    test_flt(*px, 10);
+    const ecs_f32_t *py = ecs_get_id(dst, e, y);
+    test_assert(py != NULL);
+    test_flt(*py, 20);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_component_w_reflection(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, StringComponent);
+    ecs_struct(world, {
+        .entity = ecs_id(StringComponent),
+        .members = {
+            { .name = "value", .type = ecs_id(ecs_string_t) }
+        }
+    });
+
+    ecs_entity_t e = ecs_new(world);
+    StringComponent *ptr = ecs_ensure(world, e, StringComponent);
+    ptr->value = ecs_os_strdup("Hello World");
+    ecs_modified(world, e, StringComponent);
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, StringComponent);
+    ecs_struct(dst, {
+        .entity = ecs_id(StringComponent),
+        .members = {
+            { .name = "value", .type = ecs_id(ecs_string_t) }
+        }
+    });
+    test_int(ecs_world_from_binary(dst, data, size), 0);
+    ecs_os_free(data);
+
+    const StringComponent *c = ecs_get(dst, e, StringComponent);
+    test_assert(c != NULL);
+    test_str(c->value, "Hello World");
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_component_w_hooks_no_reflection(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, StringComponent);
+    ecs_set_hooks(world, StringComponent, {
+        .ctor = flecs_default_ctor,
+        .copy = ecs_copy(StringComponent),
+        .move = ecs_move(StringComponent),
+        .dtor = ecs_dtor(StringComponent)
+    });
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+    StringComponent *ptr = ecs_ensure(world, e, StringComponent);
+    ptr->value = ecs_os_strdup("Hello World");
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    ECS_COMPONENT_DEFINE(dst, StringComponent);
+    ecs_set_hooks(dst, StringComponent, {
+        .ctor = flecs_default_ctor,
+        .copy = ecs_copy(StringComponent),
+        .move = ecs_move(StringComponent),
+        .dtor = ecs_dtor(StringComponent)
+    });
+    test_int(ecs_world_from_binary(dst, data, size), 0);
+    ecs_os_free(data);
+
+    test_assert(ecs_is_alive(dst, e));
+    test_assert(ecs_has(dst, e, Position));
+    test_assert(!ecs_has(dst, e, StringComponent));
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_restore_alive_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_set(world, e, Position, {30, 40});
+    ecs_add(world, e, Velocity);
+
+    test_int(ecs_world_from_binary(world, data, size), 0);
+    ecs_os_free(data);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+    test_assert(ecs_has(world, e, Velocity));
+
+    ecs_fini(world);
+}
+
+void Snapshot_skip_builtin(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_query_t *q = ecs_query(world, { .terms = {{ EcsAny }}});
+    ecs_entity_t s = ecs_system(world, {
+        .entity = ecs_entity(world, { .name = "MySystem" }),
+        .query.terms = {{ EcsAny }},
+        .callback = Dummy
+    });
+    test_assert(s != 0);
+    ecs_entity_t e = ecs_new(world);
+
+    ecs_world_t *dst = ecs_init();
+    restore(world, dst);
+
+    test_assert(ecs_is_alive(dst, e));
+    test_assert(!ecs_is_alive(dst, s));
+
+    ecs_query_fini(q);
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_from_file(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_set_name(world, e, "foo");
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    FILE *f = fopen("snapshot_from_file.bin", "wb");
+    test_assert(f != NULL);
+    test_int(fwrite(data, 1, (size_t)size, f), size);
+    fclose(f);
+    ecs_os_free(data);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+    test_int(ecs_world_from_binary_file(dst, "snapshot_from_file.bin"), 0);
+    remove("snapshot_from_file.bin");
+
+    test_uint(ecs_lookup(dst, "foo"), e);
+    const Position *p = ecs_get(dst, e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10); test_int(p->y, 20);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_component_size_mismatch(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+    ecs_entity_t c = ecs_component(dst, {
+        .entity = ecs_entity(dst, { .name = "Position" }),
+        .type.size = ECS_SIZEOF(Position) * 2,
+        .type.alignment = ECS_ALIGNOF(Position)
+    });
+
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_from_binary(dst, data, size) != 0);
+    test_int(ecs_count_id(dst, c), 0);
+    ecs_os_free(data);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_missing_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_from_binary(dst, data, size) != 0);
+    test_assert(!ecs_is_alive(dst, e));
+    ecs_os_free(data);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_invalid_data(void) {
+    ecs_world_t *world = ecs_init();
+
+    uint64_t data[16] = {0};
+
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_from_binary(world, data, ECS_SIZEOF(data)) != 0);
+
+    ecs_fini(world);
+}
+
+void Snapshot_truncated_data(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+
+    ecs_world_t *dst = ecs_init();
+    ECS_COMPONENT_DEFINE(dst, Position);
+
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_from_binary(dst, data, size / 2) != 0);
+    test_assert(!ecs_is_alive(dst, e));
+    ecs_os_free(data);
+
+    ecs_fini(dst);
+    ecs_fini(world);
+}
+
+void Snapshot_corrupt_table_count(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_size_t size = 0;
+    void *data = ecs_world_to_binary(world, &size);
+    test_assert(data != NULL);
+    test_assert(size >= 40);
+
+    /* Snapshot with a single table block, for which the size of the entity
+     * array overflows a 32 bit integer. The table block follows the 40 byte
+     * snapshot header. */
+    uint64_t buf[16] = {0};
+    ecs_os_memcpy(buf, data, 40);
+    ecs_os_free(data);
+
+    uint32_t *hdr = (uint32_t*)buf;
+    hdr[4] = 1; /* table_count */
+    hdr[5] = 0; /* component_count */
+    buf[3] = sizeof(buf); /* components_offset */
+
+    int32_t *table_hdr = ECS_OFFSET(buf, 40);
+    table_hdr[0] = 0;
+    table_hdr[1] = 0x20000001;
+
+    ecs_log_set_level(-4);
+    test_assert(ecs_world_from_binary(world, buf, ECS_SIZEOF(buf)) != 0);
+
+    ecs_fini(world);
+}
@@ -283,3 +283,70 @@ void Stats_progress_stats_systems_w_empty_table_flag(void) {
 
     ecs_fini(world);
 }
+
+static void SleepOnWorker(ecs_iter_t *it) {
+    if (ecs_stage_get_id(it->world) != 0) {
+        ecs_os_sleep(0, 10 * 1000 * 1000);
+    }
+}
+
+void Stats_get_pipeline_stats_w_wait_time(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = ecs_ids( ecs_dependson(EcsOnUpdate) )}),
+        .callback = SleepOnWorker,
+        .multi_threaded = true
+    });
+
+    ecs_set_threads(world, 2);
+    ecs_measure_system_time(world, true);
+
+    ecs_entity_t pipeline = ecs_get_pipeline(world);
+    test_assert(pipeline != 0);
+
+    ecs_progress(world, 0);
+
+    ecs_pipeline_stats_t stats = {0};
+    test_bool(ecs_pipeline_stats_get(world, pipeline, &stats), true);
+
+    test_int(ecs_vec_count(&stats.sync_points), 1);
+    ecs_sync_stats_t *sync = ecs_vec_first_t(&stats.sync_points, ecs_sync_stats_t);
+    test_bool(sync->multi_threaded, true);
+    test_assert(sync->wait_time.counter.value[0] > 0);
+
+    ecs_pipeline_stats_fini(&stats);
+
+    ecs_fini(world);
+}
+
+void Stats_get_world_stats_compact_reclaimed(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    int i;
+    ecs_entity_t entities[100];
+    for (i = 0; i < 100; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+    for (i = 0; i < 100; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    ecs_world_stats_t stats = {0};
+    ecs_world_stats_get(world, &stats);
+    test_int(stats.memory.compact_reclaimed_bytes.counter.value[stats.t], 0);
+
+    int64_t reclaimed = ecs_compact(world, &(ecs_compact_desc_t){
+        .clear_generation = 1 });
+    reclaimed += ecs_compact(world, &(ecs_compact_desc_t){
+        .clear_generation = 1 });
+    test_assert(reclaimed > 0);
+
+    ecs_world_stats_get(world, &stats);
+    test_int(stats.memory.compact_reclaimed_bytes.counter.value[stats.t], 
+        reclaimed);
+
+    ecs_fini(world);
+}
@@ -117,6 +117,7 @@ void Pipeline_set_time_scale_w_stage(void);
 void Pipeline_set_time_scale_w_readonly(void);
 void Pipeline_init_failure_preserves_user_entity(void);
 void Pipeline_update_pipeline_replaces_existing(void);
+void Pipeline_coalesced_observer_phase(void);
 
 // Testsuite 'SystemMisc'
 void SystemMisc_invalid_not_without_id(void);
@@ -343,6 +344,8 @@ void Stats_get_pipeline_stats_w_task_system(void);
 void Stats_get_not_alive_entity_count(void);
 void Stats_progress_stats_systems(void);
 void Stats_progress_stats_systems_w_empty_table_flag(void);
+void Stats_get_pipeline_stats_w_wait_time(void);
+void Stats_get_world_stats_compact_reclaimed(void);
 
 // Testsuite 'Memory'
 void Memory_query_memory_no_cache(void);
@@ -416,6 +419,50 @@ void MultiThread_bulk_new_in_no_readonly_w_multithread(void);
 void MultiThread_bulk_new_in_no_readonly_w_multithread_2(void);
 void MultiThread_run_first_worker_on_main(void);
 void MultiThread_run_single_thread_on_main(void);
+void MultiThread_2_thread_chunked_system(void);
+void MultiThread_6_thread_chunked_system(void);
+void MultiThread_6_thread_chunked_system_chunk_size_1(void);
+void MultiThread_chunked_system_w_fixed_src(void);
+void MultiThread_chunked_system_w_multiple_systems(void);
+void MultiThread_chunked_systems_w_conflicting_access(void);
+void MultiThread_chunked_and_static_systems_w_conflicting_access(void);
+void MultiThread_chunked_systems_w_independent_access(void);
+void MultiThread_6_thread_w_worker_spin(void);
+void MultiThread_6_thread_w_worker_yield(void);
+void MultiThread_6_thread_w_worker_spin_and_yield(void);
+void MultiThread_worker_spin_w_conflicting_access(void);
+void MultiThread_parallel_merge_set(void);
+void MultiThread_parallel_merge_set_w_observer(void);
+void MultiThread_parallel_merge_set_from_all_stages(void);
+void MultiThread_parallel_merge_set_new_component(void);
+void MultiThread_parallel_merge_remove_and_set(void);
+void MultiThread_new_entities_from_workers(void);
+void MultiThread_new_entities_from_workers_read(void);
+void MultiThread_new_entities_from_workers_grow(void);
+void MultiThread_new_w_id_from_workers(void);
+void MultiThread_new_and_delete_from_workers(void);
+void MultiThread_new_entities_unused_ids_recycled(void);
+void MultiThread_bulk_init_parallel(void);
+void MultiThread_bulk_init_parallel_w_hooks(void);
+void MultiThread_bulk_init_parallel_w_observer(void);
+void MultiThread_bulk_init_parallel_below_min_count(void);
+void MultiThread_bulk_init_parallel_w_tag_and_sparse(void);
+void MultiThread_parallel_merge_add_existing_pair(void);
+void MultiThread_propagate_parallel(void);
+void MultiThread_4_thread_sparse_system(void);
+void MultiThread_4_thread_chunked_sparse_system(void);
+void MultiThread_4_thread_partition_tables_system(void);
+void MultiThread_4_thread_chunked_partition_tables_system(void);
+void MultiThread_coalesced_observer_parallel(void);
+void MultiThread_coalesced_observer_parallel_new_entity(void);
+void MultiThread_coalesced_observer_parallel_phase(void);
+void MultiThread_worker_idle_default_no_spin(void);
+void MultiThread_worker_idle_w_spin_blocks(void);
+void MultiThread_parallel_merge_observer_writes_set_component(void);
+void MultiThread_parallel_merge_wildcard_observer_order(void);
+void MultiThread_parallel_merge_pair_wildcard_observer_order(void);
+void MultiThread_parallel_merge_merged_count(void);
+void MultiThread_new_entities_from_workers_exceed_reserved(void);
 
 // Testsuite 'MultiThreadStaging'
 void MultiThreadStaging_setup(void);
@@ -596,6 +643,79 @@ void Alerts_member_range_from_var_after_remove(void);
 void Alerts_retained_alert_w_dead_source(void);
 void Alerts_alert_counts(void);
 
+// Testsuite 'Snapshot'
+void Snapshot_empty_world(void);
+void Snapshot_component(void);
+void Snapshot_many_entities(void);
+void Snapshot_tag(void);
+void Snapshot_pair(void);
+void Snapshot_pair_target_stored_after_source(void);
+void Snapshot_name(void);
+void Snapshot_hierarchy(void);
+void Snapshot_non_fragmenting_hierarchy(void);
+void Snapshot_prefab_instance(void);
+void Snapshot_entity_generation(void);
+void Snapshot_sparse_component(void);
+void Snapshot_soa_component(void);
+void Snapshot_component_w_reflection(void);
+void Snapshot_component_w_hooks_no_reflection(void);
+void Snapshot_restore_alive_entity(void);
+void Snapshot_skip_builtin(void);
+void Snapshot_from_file(void);
+void Snapshot_component_size_mismatch(void);
+void Snapshot_missing_component(void);
+void Snapshot_invalid_data(void);
+void Snapshot_truncated_data(void);
+void Snapshot_corrupt_table_count(void);
+
+// Testsuite 'Replication'
+void Replication_initial_diff(void);
+void Replication_no_changes(void);
+void Replication_no_changes_empty_diff(void);
+void Replication_changed_column(void);
+void Replication_modified(void);
+void Replication_query_write_not_changed(void);
+void Replication_new_entity(void);
+void Replication_delete_entity(void);
+void Replication_recycled_entity(void);
+void Replication_add_component(void);
+void Replication_remove_component(void);
+void Replication_no_longer_matches(void);
+void Replication_unacked_diff(void);
+void Replication_apply_unacked_diffs(void);
+void Replication_ack_old_frame(void);
+void Replication_ack_frames_w_latency(void);
+void Replication_hierarchy(void);
+void Replication_component_w_reflection(void);
+void Replication_soa_component(void);
+void Replication_many_entities(void);
+void Replication_apply_snapshot_as_diff(void);
+void Replication_update_entity_not_alive(void);
+void Replication_corrupt_deleted_count(void);
+
+// Testsuite 'Fork'
+void Fork_restore_value(void);
+void Fork_restore_value_from_ensure(void);
+void Fork_restore_value_from_get_mut(void);
+void Fork_restore_value_from_deferred_ensure(void);
+void Fork_restore_no_changes(void);
+void Fork_restore_value_from_system(void);
+void Fork_restore_new_entity(void);
+void Fork_restore_deleted_entity(void);
+void Fork_restore_deleted_recycled_entity(void);
+void Fork_restore_added_component(void);
+void Fork_restore_removed_component(void);
+void Fork_restore_twice(void);
+void Fork_restore_w_prev(void);
+void Fork_restore_name(void);
+void Fork_restore_deleted_named_entity(void);
+void Fork_restore_deleted_hierarchy(void);
+void Fork_restore_non_fragmenting_parent(void);
+void Fork_restore_component_w_hooks(void);
+void Fork_restore_w_observers(void);
+void Fork_restore_after_table_delete(void);
+void Fork_rollback_frames(void);
+
 bake_test_case Doc_testcases[] = {
     {
         "get_set_name",
@@ -1023,6 +1143,10 @@ bake_test_case Pipeline_testcases[] = {
     {
         "update_pipeline_replaces_existing",
         Pipeline_update_pipeline_replaces_existing
+    },
+    {
+        "coalesced_observer_phase",
+        Pipeline_coalesced_observer_phase
     }
 };
 
@@ -1864,6 +1988,14 @@ bake_test_case Stats_testcases[] = {
     {
         "progress_stats_systems_w_empty_table_flag",
         Stats_progress_stats_systems_w_empty_table_flag
+    },
+    {
+        "get_pipeline_stats_w_wait_time",
+        Stats_get_pipeline_stats_w_wait_time
+    },
+    {
+        "get_world_stats_compact_reclaimed",
+        Stats_get_world_stats_compact_reclaimed
     }
 };
 
@@ -2133,6 +2265,182 @@ bake_test_case MultiThread_testcases[] = {
     {
         "run_single_thread_on_main",
         MultiThread_run_single_thread_on_main
+    },
+    {
+        "2_thread_chunked_system",
+        MultiThread_2_thread_chunked_system
+    },
+    {
+        "6_thread_chunked_system",
+        MultiThread_6_thread_chunked_system
+    },
+    {
+        "6_thread_chunked_system_chunk_size_1",
+        MultiThread_6_thread_chunked_system_chunk_size_1
+    },
+    {
+        "chunked_system_w_fixed_src",
+        MultiThread_chunked_system_w_fixed_src
+    },
+    {
+        "chunked_system_w_multiple_systems",
+        MultiThread_chunked_system_w_multiple_systems
+    },
+    {
+        "chunked_systems_w_conflicting_access",
+        MultiThread_chunked_systems_w_conflicting_access
+    },
+    {
+        "chunked_and_static_systems_w_conflicting_access",
+        MultiThread_chunked_and_static_systems_w_conflicting_access
+    },
+    {
+        "chunked_systems_w_independent_access",
+        MultiThread_chunked_systems_w_independent_access
+    },
+    {
+        "6_thread_w_worker_spin",
+        MultiThread_6_thread_w_worker_spin
+    },
+    {
+        "6_thread_w_worker_yield",
+        MultiThread_6_thread_w_worker_yield
+    },
+    {
+        "6_thread_w_worker_spin_and_yield",
+        MultiThread_6_thread_w_worker_spin_and_yield
+    },
+    {
+        "worker_spin_w_conflicting_access",
+        MultiThread_worker_spin_w_conflicting_access
+    },
+    {
+        "parallel_merge_set",
+        MultiThread_parallel_merge_set
+    },
+    {
+        "parallel_merge_set_w_observer",
+        MultiThread_parallel_merge_set_w_observer
+    },
+    {
+        "parallel_merge_set_from_all_stages",
+        MultiThread_parallel_merge_set_from_all_stages
+    },
+    {
+        "parallel_merge_set_new_component",
+        MultiThread_parallel_merge_set_new_component
+    },
+    {
+        "parallel_merge_remove_and_set",
+        MultiThread_parallel_merge_remove_and_set
+    },
+    {
+        "new_entities_from_workers",
+        MultiThread_new_entities_from_workers
+    },
+    {
+        "new_entities_from_workers_read",
+        MultiThread_new_entities_from_workers_read
+    },
+    {
+        "new_entities_from_workers_grow",
+        MultiThread_new_entities_from_workers_grow
+    },
+    {
+        "new_w_id_from_workers",
+        MultiThread_new_w_id_from_workers
+    },
+    {
+        "new_and_delete_from_workers",
+        MultiThread_new_and_delete_from_workers
+    },
+    {
+        "new_entities_unused_ids_recycled",
+        MultiThread_new_entities_unused_ids_recycled
+    },
+    {
+        "bulk_init_parallel",
+        MultiThread_bulk_init_parallel
+    },
+    {
+        "bulk_init_parallel_w_hooks",
+        MultiThread_bulk_init_parallel_w_hooks
+    },
+    {
+        "bulk_init_parallel_w_observer",
+        MultiThread_bulk_init_parallel_w_observer
+    },
+    {
+        "bulk_init_parallel_below_min_count",
+        MultiThread_bulk_init_parallel_below_min_count
+    },
+    {
+        "bulk_init_parallel_w_tag_and_sparse",
+        MultiThread_bulk_init_parallel_w_tag_and_sparse
+    },
+    {
+        "parallel_merge_add_existing_pair",
+        MultiThread_parallel_merge_add_existing_pair
+    },
+    {
+        "propagate_parallel",
+        MultiThread_propagate_parallel
+    },
+    {
+        "4_thread_sparse_system",
+        MultiThread_4_thread_sparse_system
+    },
+    {
+        "4_thread_chunked_sparse_system",
+        MultiThread_4_thread_chunked_sparse_system
+    },
+    {
+        "4_thread_partition_tables_system",
+        MultiThread_4_thread_partition_tables_system
+    },
+    {
+        "4_thread_chunked_partition_tables_system",
+        MultiThread_4_thread_chunked_partition_tables_system
+    },
+    {
+        "coalesced_observer_parallel",
+        MultiThread_coalesced_observer_parallel
+    },
+    {
+        "coalesced_observer_parallel_new_entity",
+        MultiThread_coalesced_observer_parallel_new_entity
+    },
+    {
+        "coalesced_observer_parallel_phase",
+        MultiThread_coalesced_observer_parallel_phase
+    },
+    {
+        "worker_idle_default_no_spin",
+        MultiThread_worker_idle_default_no_spin
+    },
+    {
+        "worker_idle_w_spin_blocks",
+        MultiThread_worker_idle_w_spin_blocks
+    },
+    {
+        "parallel_merge_observer_writes_set_component",
+        MultiThread_parallel_merge_observer_writes_set_component
+    },
+    {
+        "parallel_merge_wildcard_observer_order",
+        MultiThread_parallel_merge_wildcard_observer_order
+    },
+    {
+        "parallel_merge_pair_wildcard_observer_order",
+        MultiThread_parallel_merge_pair_wildcard_observer_order
+    },
+    {
+        "parallel_merge_merged_count",
+        MultiThread_parallel_merge_merged_count
+    },
+    {
+        "new_entities_from_workers_exceed_reserved",
+        MultiThread_new_entities_from_workers_exceed_reserved
     }
 };
 
@@ -2809,6 +3117,283 @@ bake_test_case Alerts_testcases[] = {
     }
 };
 
+bake_test_case Snapshot_testcases[] = {
+    {
+        "empty_world",
+        Snapshot_empty_world
+    },
+    {
+        "component",
+        Snapshot_component
+    },
+    {
+        "many_entities",
+        Snapshot_many_entities
+    },
+    {
+        "tag",
+        Snapshot_tag
+    },
+    {
+        "pair",
+        Snapshot_pair
+    },
+    {
+        "pair_target_stored_after_source",
+        Snapshot_pair_target_stored_after_source
+    },
+    {
+        "name",
+        Snapshot_name
+    },
+    {
+        "hierarchy",
+        Snapshot_hierarchy
+    },
+    {
+        "non_fragmenting_hierarchy",
+        Snapshot_non_fragmenting_hierarchy
+    },
+    {
+        "prefab_instance",
+        Snapshot_prefab_instance
+    },
+    {
+        "entity_generation",
+        Snapshot_entity_generation
+    },
+    {
+        "sparse_component",
+        Snapshot_sparse_component
+    },
+    {
+        "soa_component",
+        Snapshot_soa_component
+    },
+    {
+        "component_w_reflection",
+        Snapshot_component_w_reflection
+    },
+    {
+        "component_w_hooks_no_reflection",
+        Snapshot_component_w_hooks_no_reflection
+    },
+    {
+        "restore_alive_entity",
+        Snapshot_restore_alive_entity
+    },
+    {
+        "skip_builtin",
+        Snapshot_skip_builtin
+    },
+    {
+        "from_file",
+        Snapshot_from_file
+    },
+    {
+        "component_size_mismatch",
+        Snapshot_component_size_mismatch
+    },
+    {
+        "missing_component",
+        Snapshot_missing_component
+    },
+    {
+        "invalid_data",
+        Snapshot_invalid_data
+    },
+    {
+        "truncated_data",
+        Snapshot_truncated_data
+    },
+    {
+        "corrupt_table_count",
+        Snapshot_corrupt_table_count
+    }
+};
+
+bake_test_case Replication_testcases[] = {
+    {
+        "initial_diff",
+        Replication_initial_diff
+    },
+    {
+        "no_changes",
+        Replication_no_changes
+    },
+    {
+        "no_changes_empty_diff",
+        Replication_no_changes_empty_diff
+    },
+    {
+        "changed_column",
+        Replication_changed_column
+    },
+    {
+        "modified",
+        Replication_modified
+    },
+    {
+        "query_write_not_changed",
+        Replication_query_write_not_changed
+    },
+    {
+        "new_entity",
+        Replication_new_entity
+    },
+    {
+        "delete_entity",
+        Replication_delete_entity
+    },
+    {
+        "recycled_entity",
+        Replication_recycled_entity
+    },
+    {
+        "add_component",
+        Replication_add_component
+    },
+    {
+        "remove_component",
+        Replication_remove_component
+    },
+    {
+        "no_longer_matches",
+        Replication_no_longer_matches
+    },
+    {
+        "unacked_diff",
+        Replication_unacked_diff
+    },
+    {
+        "apply_unacked_diffs",
+        Replication_apply_unacked_diffs
+    },
+    {
+        "ack_old_frame",
+        Replication_ack_old_frame
+    },
+    {
+        "ack_frames_w_latency",
+        Replication_ack_frames_w_latency
+    },
+    {
+        "hierarchy",
+        Replication_hierarchy
+    },
+    {
+        "component_w_reflection",
+        Replication_component_w_reflection
+    },
+    {
+        "soa_component",
+        Replication_soa_component
+    },
+    {
+        "many_entities",
+        Replication_many_entities
+    },
+    {
+        "apply_snapshot_as_diff",
+        Replication_apply_snapshot_as_diff
+    },
+    {
+        "update_entity_not_alive",
+        Replication_update_entity_not_alive
+    },
+    {
+        "corrupt_deleted_count",
+        Replication_corrupt_deleted_count
+    }
+};
+
+bake_test_case Fork_testcases[] = {
+    {
+        "restore_value",
+        Fork_restore_value
+    },
+    {
+        "restore_value_from_ensure",
+        Fork_restore_value_from_ensure
+    },
+    {
+        "restore_value_from_get_mut",
+        Fork_restore_value_from_get_mut
+    },
+    {
+        "restore_value_from_deferred_ensure",
+        Fork_restore_value_from_deferred_ensure
+    },
+    {
+        "restore_no_changes",
+        Fork_restore_no_changes
+    },
+    {
+        "restore_value_from_system",
+        Fork_restore_value_from_system
+    },
+    {
+        "restore_new_entity",
+        Fork_restore_new_entity
+    },
+    {
+        "restore_deleted_entity",
+        Fork_restore_deleted_entity
+    },
+    {
+        "restore_deleted_recycled_entity",
+        Fork_restore_deleted_recycled_entity
+    },
+    {
+        "restore_added_component",
+        Fork_restore_added_component
+    },
+    {
+        "restore_removed_component",
+        Fork_restore_removed_component
+    },
+    {
+        "restore_twice",
+        Fork_restore_twice
+    },
+    {
+        "restore_w_prev",
+        Fork_restore_w_prev
+    },
+    {
+        "restore_name",
+        Fork_restore_name
+    },
+    {
+        "restore_deleted_named_entity",
+        Fork_restore_deleted_named_entity
+    },
+    {
+        "restore_deleted_hierarchy",
+        Fork_restore_deleted_hierarchy
+    },
+    {
+        "restore_non_fragmenting_parent",
+        Fork_restore_non_fragmenting_parent
+    },
+    {
+        "restore_component_w_hooks",
+        Fork_restore_component_w_hooks
+    },
+    {
+        "restore_w_observers",
+        Fork_restore_w_observers
+    },
+    {
+        "restore_after_table_delete",
+        Fork_restore_after_table_delete
+    },
+    {
+        "rollback_frames",
+        Fork_rollback_frames
+    }
+};
+
 const char* MultiThread_worker_kind_param[] = {"thread", "task"};
 bake_test_param MultiThread_params[] = {
     {"worker_kind", (char**)MultiThread_worker_kind_param, 2}
@@ -2831,7 +3416,7 @@ static bake_test_suite suites[] = {
         "Pipeline",
         NULL,
         NULL,
-        94,
+        95,
         Pipeline_testcases
     },
     {
@@ -2908,7 +3493,7 @@ static bake_test_suite suites[] = {
         "Stats",
         NULL,
         NULL,
-        13,
+        15,
         Stats_testcases
     },
     {
@@ -2929,7 +3514,7 @@ static bake_test_suite suites[] = {
         "MultiThread",
         MultiThread_setup,
         NULL,
-        50,
+        94,
         MultiThread_testcases,
         1,
         MultiThread_params
@@ -2984,9 +3569,30 @@ static bake_test_suite suites[] = {
         NULL,
         36,
         Alerts_testcases
+    },
+    {
+        "Snapshot",
+        NULL,
+        NULL,
+        23,
+        Snapshot_testcases
+    },
+    {
+        "Replication",
+        NULL,
+        NULL,
+        23,
+        Replication_testcases
+    },
+    {
+        "Fork",
+        NULL,
+        NULL,
+        21,
+        Fork_testcases
     }
 };
 
 int main(int argc, char *argv[]) {
-    return bake_test_run("addons", argc, argv, suites, 23);
+    return bake_test_run("addons", argc, argv, suites, 26);
 }
@@ -91,3 +91,18 @@ const ecs_entity_t* bulk_new_w_type(
     
     return result;
 }
+
+ECS_COPY(StringComponent, dst, src, {
+    ecs_os_free(dst->value);
+    dst->value = ecs_os_strdup(src->value);
+})
+
+ECS_MOVE(StringComponent, dst, src, {
+    ecs_os_free(dst->value);
+    dst->value = src->value;
+    src->value = NULL;
+})
+
+ECS_DTOR(StringComponent, ptr, {
+    ecs_os_free(ptr->value);
+})
@@ -396,3 +396,166 @@ void Get_component_get_sparse_w_wildcard(void) {
     test_expect_abort();
     ecs_get_sparse_id(world, e, ecs_pair(ecs_id(Position), EcsWildcard), sizeof(Position));
 }
+
+void Get_component_get_many(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[64];
+    int i;
+    for (i = 0; i < 64; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i * 2}));
+    }
+
+    const Position *ptrs[64];
+    ecs_get_many(world, entities, 64, Position, ptrs);
+
+    for (i = 0; i < 64; i ++) {
+        test_assert(ptrs[i] == ecs_get(world, entities[i], Position));
+        test_int(ptrs[i]->x, i);
+        test_int(ptrs[i]->y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Get_component_get_many_different_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t entities[30];
+    int i;
+    for (i = 0; i < 30; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, 0}));
+        if (i % 3 == 1) {
+            ecs_add(world, entities[i], Velocity);
+        } else if (i % 3 == 2) {
+            ecs_add(world, entities[i], Foo);
+        }
+    }
+
+    /* Lookup in reverse, so entities are not in storage order */
+    ecs_entity_t reversed[30];
+    for (i = 0; i < 30; i ++) {
+        reversed[i] = entities[29 - i];
+    }
+
+    const Position *ptrs[30];
+    ecs_get_many(world, reversed, 30, Position, ptrs);
+
+    for (i = 0; i < 30; i ++) {
+        test_assert(ptrs[i] != NULL);
+        test_int(ptrs[i]->x, 29 - i);
+    }
+
+    ecs_fini(world);
+}
+
+void Get_component_get_many_not_found(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t entities[3] = {
+        ecs_insert(world, ecs_value(Position, {10, 20})),
+        ecs_new(world),
+        ecs_insert(world, ecs_value(Velocity, {1, 2}))
+    };
+
+    const Position *ptrs[3];
+    ecs_get_many(world, entities, 3, Position, ptrs);
+
+    test_assert(ptrs[0] != NULL);
+    test_int(ptrs[0]->x, 10);
+    test_assert(ptrs[1] == NULL);
+    test_assert(ptrs[2] == NULL);
+
+    ecs_fini(world);
+}
+
+void Get_component_get_many_pair(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tgt);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t entities[3] = {
+        ecs_insert(world, ecs_pair_value(Position, Tgt, {10, 20})),
+        ecs_insert(world, ecs_pair_value(Position, Tgt, {30, 40})),
+        ecs_new_w(world, Foo)
+    };
+
+    const void *ptrs[3];
+    ecs_get_many_id(world, entities, 3, ecs_pair_t(Position, Tgt), ptrs);
+
+    test_assert(ptrs[0] != NULL);
+    test_int(((const Position*)ptrs[0])->x, 10);
+    test_assert(ptrs[1] != NULL);
+    test_int(((const Position*)ptrs[1])->x, 30);
+    test_assert(ptrs[2] == NULL);
+
+    ecs_fini(world);
+}
+
+void Get_component_get_many_inherited(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ecs_add_pair(world, ecs_id(Position), EcsOnInstantiate, EcsInherit);
+
+    ecs_entity_t base = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t entities[3] = {
+        ecs_new_w_pair(world, EcsIsA, base),
+        ecs_insert(world, ecs_value(Position, {30, 40})),
+        ecs_new_w_pair(world, EcsIsA, base)
+    };
+
+    const Position *ptrs[3];
+    ecs_get_many(world, entities, 3, Position, ptrs);
+
+    test_assert(ptrs[0] == ecs_get(world, base, Position));
+    test_int(ptrs[1]->x, 30);
+    test_assert(ptrs[2] == ecs_get(world, base, Position));
+
+    ecs_fini(world);
+}
+
+void Get_component_get_many_sparse(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ecs_add_id(world, ecs_id(Position), EcsSparse);
+
+    ecs_entity_t entities[3] = {
+        ecs_insert(world, ecs_value(Position, {10, 20})),
+        ecs_new(world),
+        ecs_insert(world, ecs_value(Position, {30, 40}))
+    };
+
+    const Position *ptrs[3];
+    ecs_get_many(world, entities, 3, Position, ptrs);
+
+    test_assert(ptrs[0] != NULL);
+    test_int(ptrs[0]->x, 10);
+    test_assert(ptrs[1] == NULL);
+    test_assert(ptrs[2] != NULL);
+    test_int(ptrs[2]->x, 30);
+
+    ecs_fini(world);
+}
+
+void Get_component_get_many_no_entities(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_get_many(world, NULL, 0, Position, NULL);
+
+    ecs_fini(world);
+}
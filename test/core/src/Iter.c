@@ -2991,3 +2991,402 @@ void Iter_to_str(void) {
 
     ecs_fini(world);
 }
+
+void Iter_dynamic_worker_iter(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_new(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new(world); ecs_set(world, e3, Self, {e3});
+    ecs_entity_t e4 = ecs_new(world); ecs_set(world, e4, Self, {e4});
+    ecs_entity_t e5 = ecs_new(world); ecs_set(world, e5, Self, {e5});
+
+    ecs_add(world, e4, TagA);
+    ecs_add(world, e5, TagA);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    int32_t cursor = 0;
+    ecs_iter_t it = ecs_query_iter(world, q);
+    ecs_iter_t pit = ecs_dynamic_worker_iter(&it, &cursor, 2);
+
+    {
+        test_bool(ecs_dynamic_worker_next(&pit), true);
+        test_int(pit.count, 2);
+        test_int(pit.entities[0], e1);
+        test_int(pit.entities[1], e2);
+
+        Self *ptr = ecs_field(&pit, Self, 0);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e1);
+        test_int(ptr[1].value, e2);
+    }
+
+    {
+        test_bool(ecs_dynamic_worker_next(&pit), true);
+        test_int(pit.count, 1);
+        test_int(pit.entities[0], e3);
+
+        Self *ptr = ecs_field(&pit, Self, 0);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e3);
+    }
+
+    {
+        test_bool(ecs_dynamic_worker_next(&pit), true);
+        test_int(pit.count, 2);
+        test_int(pit.entities[0], e4);
+        test_int(pit.entities[1], e5);
+
+        Self *ptr = ecs_field(&pit, Self, 0);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e4);
+        test_int(ptr[1].value, e5);
+    }
+
+    test_bool(ecs_dynamic_worker_next(&pit), false);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_dynamic_worker_iter_2_workers(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_new(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new(world); ecs_set(world, e3, Self, {e3});
+    ecs_entity_t e4 = ecs_new(world); ecs_set(world, e4, Self, {e4});
+    ecs_entity_t e5 = ecs_new(world); ecs_set(world, e5, Self, {e5});
+
+    ecs_add(world, e5, TagA);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    int32_t cursor = 0;
+    ecs_iter_t it_1 = ecs_query_iter(world, q);
+    ecs_iter_t pit_1 = ecs_dynamic_worker_iter(&it_1, &cursor, 3);
+    ecs_iter_t it_2 = ecs_query_iter(world, q);
+    ecs_iter_t pit_2 = ecs_dynamic_worker_iter(&it_2, &cursor, 3);
+
+    /* Worker 2 claims chunks while worker 1 is still busy */
+    test_bool(ecs_dynamic_worker_next(&pit_2), true);
+    test_int(pit_2.count, 3);
+    test_int(pit_2.entities[0], e1);
+    test_int(pit_2.entities[1], e2);
+    test_int(pit_2.entities[2], e3);
+
+    test_bool(ecs_dynamic_worker_next(&pit_2), true);
+    test_int(pit_2.count, 1);
+    test_int(pit_2.entities[0], e4);
+    {
+        Self *ptr = ecs_field(&pit_2, Self, 0);
+        test_int(ptr[0].value, e4);
+    }
+
+    /* Worker 1 gets the chunk that remains */
+    test_bool(ecs_dynamic_worker_next(&pit_1), true);
+    test_int(pit_1.count, 1);
+    test_int(pit_1.entities[0], e5);
+    {
+        Self *ptr = ecs_field(&pit_1, Self, 0);
+        test_int(ptr[0].value, e5);
+    }
+
+    test_bool(ecs_dynamic_worker_next(&pit_1), false);
+    test_bool(ecs_dynamic_worker_next(&pit_2), false);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_dynamic_worker_iter_w_fini(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_query_t *f = ecs_query(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {20, 30}));
+    ecs_add(world, e2, Foo);
+
+    int32_t cursor = 0;
+    ecs_iter_t it = ecs_query_iter(world, f);
+    ecs_iter_t pit = ecs_dynamic_worker_iter(&it, &cursor, 16);
+    test_bool(true, ecs_dynamic_worker_next(&pit));
+    test_int(pit.count, 1);
+    test_int(pit.entities[0], e1);
+    ecs_iter_fini(&pit);
+
+    ecs_query_fini(f);
+
+    ecs_fini(world);
+}
+
+static
+void test_partition_tables(
+    ecs_world_t *world,
+    ecs_query_t *q,
+    const ecs_entity_t *entities,
+    int32_t entity_count,
+    int8_t self_field,
+    int32_t worker_count)
+{
+    int32_t i, w, total = 0, table_count = 0;
+    int32_t found[8] = {0};
+    ecs_table_t *tables[8] = {0};
+    int32_t table_worker[8] = {0};
+
+    for (w = 0; w < worker_count; w ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        ecs_iter_t pit = ecs_worker_iter(&it, w, worker_count);
+        while (ecs_worker_next(&pit)) {
+            test_assert(pit.table != NULL);
+            test_int(pit.count, ecs_table_count(pit.table));
+
+            /* Each table is iterated by a single worker */
+            for (i = 0; i < table_count; i ++) {
+                if (tables[i] == pit.table) {
+                    break;
+                }
+            }
+
+            if (i == table_count) {
+                tables[table_count] = pit.table;
+                table_worker[table_count ++] = w;
+            } else {
+                test_int(table_worker[i], w);
+            }
+
+            Self *ptr = ecs_field(&pit, Self, self_field);
+            for (i = 0; i < pit.count; i ++) {
+                test_int(ptr[i].value, pit.entities[i]);
+
+                int32_t e;
+                for (e = 0; e < entity_count; e ++) {
+                    if (entities[e] == pit.entities[i]) {
+                        found[e] ++;
+                    }
+                }
+            }
+
+            total += pit.count;
+        }
+    }
+
+    test_int(total, entity_count);
+    for (i = 0; i < entity_count; i ++) {
+        test_int(found[i], 1);
+    }
+}
+
+void Iter_worker_iter_partition_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+
+    ecs_entity_t entities[8];
+    int32_t i;
+    for (i = 0; i < 8; i ++) {
+        ecs_entity_t e = entities[i] = ecs_new(world);
+        ecs_set(world, e, Self, {e});
+        if (i >= 2) {
+            ecs_add_id(world, e, ecs_new(world));
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }},
+        .flags = EcsQueryPartitionTables
+    });
+
+    test_partition_tables(world, q, entities, 8, 0, 2);
+    test_partition_tables(world, q, entities, 8, 0, 3);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_partition_tables_w_not(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t entities[6], tag = 0;
+    int32_t i;
+    for (i = 0; i < 6; i ++) {
+        ecs_entity_t e = entities[i] = ecs_new(world);
+        ecs_set(world, e, Self, {e});
+        ecs_add(world, e, TagA);
+
+        /* Two entities per table */
+        if (!(i % 2)) {
+            tag = ecs_new(world);
+        }
+        ecs_add_id(world, e, tag);
+    }
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Self, {e});
+    ecs_add(world, e, TagA);
+    ecs_add(world, e, TagB);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {
+            { ecs_id(Self) }, { TagA }, { TagB, .oper = EcsNot }
+        },
+        .flags = EcsQueryPartitionTables
+    });
+
+    test_partition_tables(world, q, entities, 6, 0, 2);
+    test_partition_tables(world, q, entities, 6, 0, 4);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_partition_tables_w_pair(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, Rel);
+
+    ecs_entity_t entities[6], tgt = 0;
+    int32_t i;
+    for (i = 0; i < 6; i ++) {
+        ecs_entity_t e = entities[i] = ecs_new(world);
+        ecs_set(world, e, Self, {e});
+
+        /* Two entities per table */
+        if (!(i % 2)) {
+            tgt = ecs_new(world);
+        }
+        ecs_add_pair(world, e, Rel, tgt);
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {
+            { ecs_pair(Rel, EcsWildcard) }, { ecs_id(Self) }
+        },
+        .flags = EcsQueryPartitionTables
+    });
+
+    test_partition_tables(world, q, entities, 6, 1, 2);
+    test_partition_tables(world, q, entities, 6, 1, 3);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_iter_partition_tables_w_or(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t e1 = ecs_new(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new(world); ecs_set(world, e3, Self, {e3});
+    ecs_entity_t e4 = ecs_new(world); ecs_set(world, e4, Self, {e4});
+
+    ecs_add(world, e1, TagA);
+    ecs_add(world, e2, TagA);
+    ecs_add(world, e3, TagB);
+    ecs_add(world, e4, TagB);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {
+            { TagA, .oper = EcsOr }, { TagB }, { ecs_id(Self) }
+        },
+        .flags = EcsQueryPartitionTables
+    });
+
+    /* Query can't be partitioned, entities are split up instead */
+    int32_t w, total = 0;
+    for (w = 0; w < 2; w ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        ecs_iter_t pit = ecs_worker_iter(&it, w, 2);
+        while (ecs_worker_next(&pit)) {
+            test_int(pit.count, 1);
+            total += pit.count;
+        }
+    }
+
+    test_int(total, 4);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Iter_dynamic_worker_iter_partition_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_new(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new(world); ecs_set(world, e3, Self, {e3});
+    ecs_entity_t e4 = ecs_new(world); ecs_set(world, e4, Self, {e4});
+    ecs_entity_t e5 = ecs_new(world); ecs_set(world, e5, Self, {e5});
+
+    ecs_add(world, e4, TagA);
+    ecs_add(world, e5, TagA);
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Self) }, { TagA, .oper = EcsNot }},
+        .flags = EcsQueryPartitionTables
+    });
+
+    int32_t cursor = 0;
+    ecs_iter_t it_1 = ecs_query_iter(world, q);
+    ecs_iter_t pit_1 = ecs_dynamic_worker_iter(&it_1, &cursor, 2);
+    ecs_iter_t it_2 = ecs_query_iter(world, q);
+    ecs_iter_t pit_2 = ecs_dynamic_worker_iter(&it_2, &cursor, 2);
+
+    /* Worker 2 claims the first table, and gets all of its chunks */
+    test_bool(ecs_dynamic_worker_next(&pit_2), true);
+    test_int(pit_2.count, 2);
+    test_int(pit_2.entities[0], e1);
+    test_int(pit_2.entities[1], e2);
+
+    /* Table with TagA doesn't match, no tables left for worker 1 */
+    test_bool(ecs_dynamic_worker_next(&pit_1), false);
+
+    test_bool(ecs_dynamic_worker_next(&pit_2), true);
+    test_int(pit_2.count, 1);
+    test_int(pit_2.entities[0], e3);
+    {
+        Self *ptr = ecs_field(&pit_2, Self, 0);
+        test_int(ptr[0].value, e3);
+    }
+
+    test_bool(ecs_dynamic_worker_next(&pit_2), false);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
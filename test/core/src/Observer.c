@@ -14103,3 +14103,369 @@ void Observer_propagate_on_set_2_lvls_2_terms(void) {
 
     ecs_fini(world);
 }
+
+static Position coalesce_last_value;
+static bool coalesce_has_value;
+
+static
+void Observer_coalesced(ecs_iter_t *it) {
+    probe_system_w_ctx(it, it->ctx);
+
+    Position *p = ecs_field(it, Position, 0);
+    coalesce_has_value = p != NULL;
+    if (p) {
+        coalesce_last_value = p[it->count - 1];
+    }
+}
+
+void Observer_coalesce_on_set(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Position, {20, 30});
+    ecs_set(world, e, Position, {30, 40});
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_uint(ctx.e[0], e);
+    test_uint(ctx.event, EcsOnSet);
+    test_uint(ctx.event_id, ecs_id(Position));
+    test_uint(ctx.system, o);
+    test_bool(coalesce_has_value, true);
+    test_int(coalesce_last_value.x, 30);
+    test_int(coalesce_last_value.y, 40);
+
+    test_int(ecs_observer_flush(world, o), 0);
+    test_int(ctx.invoked, 1);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_on_set_table_batch(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {20, 30}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {30, 40}));
+    ecs_set(world, e3, Position, {40, 50});
+    ecs_set(world, e1, Position, {50, 60});
+    ecs_set(world, e2, Position, {60, 70});
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 3);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 3);
+    test_uint(ctx.e[0], e1);
+    test_uint(ctx.e[1], e2);
+    test_uint(ctx.e[2], e3);
+    test_int(coalesce_last_value.x, 40);
+    test_int(coalesce_last_value.y, 50);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_add_remove(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd, EcsOnRemove },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_add(world, e, Position);
+    ecs_remove(world, e, Position);
+    ecs_add(world, e, Position);
+    ecs_remove(world, e, Position);
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 0);
+    test_int(ctx.invoked, 0);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_on_add_on_set(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd, EcsOnSet },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Position, {20, 30});
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 2);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 2);
+    test_uint(ctx.e[0], e);
+    test_uint(ctx.e[1], e);
+    test_uint(ctx.event, EcsOnSet);
+    test_int(coalesce_last_value.x, 20);
+    test_int(coalesce_last_value.y, 30);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_on_remove(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd, EcsOnRemove },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_remove(world, e, Position);
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_uint(ctx.e[0], e);
+    test_uint(ctx.event, EcsOnRemove);
+    test_bool(coalesce_has_value, false);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_remove_add(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnRemove, EcsOnSet },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_remove(world, e, Position);
+    ecs_set(world, e, Position, {20, 30});
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_uint(ctx.e[0], e);
+    test_uint(ctx.event, EcsOnSet);
+    test_int(coalesce_last_value.x, 20);
+    test_int(coalesce_last_value.y, 30);
+
+    ecs_fini(world);
+}
+
+static ecs_entity_t coalesce_events[4];
+static bool coalesce_values[4];
+
+static
+void Observer_coalesced_w_order(ecs_iter_t *it) {
+    Probe *ctx = it->ctx;
+    test_assert(ctx->invoked < 4);
+    coalesce_events[ctx->invoked] = it->event;
+    coalesce_values[ctx->invoked] = ecs_field(it, Position, 0) != NULL;
+    Observer_coalesced(it);
+}
+
+void Observer_coalesce_remove_add_no_set(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnAdd, EcsOnRemove },
+        .callback = Observer_coalesced_w_order,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_remove(world, e, Position);
+    ecs_set(world, e, Position, {20, 30});
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 2);
+    test_int(ctx.invoked, 2);
+    test_int(ctx.count, 2);
+    test_uint(ctx.e[0], e);
+    test_uint(ctx.e[1], e);
+    test_uint(coalesce_events[0], EcsOnRemove);
+    test_bool(coalesce_values[0], false);
+    test_uint(coalesce_events[1], EcsOnAdd);
+    test_bool(coalesce_values[1], true);
+    test_int(coalesce_last_value.x, 20);
+    test_int(coalesce_last_value.y, 30);
+
+    test_int(ecs_observer_flush(world, o), 0);
+    test_int(ctx.invoked, 2);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {20, 30}));
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnRemove, EcsOnSet },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_set(world, e1, Position, {30, 40});
+    ecs_delete(world, e1);
+    ecs_delete(world, e2);
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 2);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 2);
+    probe_has_entity(&ctx, e1);
+    probe_has_entity(&ctx, e2);
+    test_uint(ctx.event, EcsOnRemove);
+    test_bool(coalesce_has_value, false);
+
+    ecs_fini(world);
+}
+
+void Observer_coalesce_2_terms(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }},
+        .events = { EcsOnSet },
+        .callback = Observer_coalesced,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e1 = ecs_insert(world, 
+        ecs_value(Position, {10, 20}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {20, 30}));
+    ecs_set(world, e1, Position, {30, 40});
+    ecs_set(world, e1, Velocity, {3, 4});
+    ecs_set(world, e2, Position, {40, 50});
+    test_int(ctx.invoked, 0);
+
+    test_int(ecs_observer_flush(world, o), 1);
+    test_int(ctx.invoked, 1);
+    test_int(ctx.count, 1);
+    test_uint(ctx.e[0], e1);
+    test_uint(ctx.event, EcsOnSet);
+    test_int(coalesce_last_value.x, 30);
+    test_int(coalesce_last_value.y, 40);
+
+    ecs_fini(world);
+}
+
+static
+void Observer_coalesced_set(ecs_iter_t *it) {
+    probe_system_w_ctx(it, it->ctx);
+
+    Position *p = ecs_field(it, Position, 0);
+    int32_t i;
+    for (i = 0; i < it->count; i ++) {
+        Position v = {p[i].x + 1, p[i].y};
+        ecs_set_id(it->world, it->entities[i], ecs_field_id(it, 0), 
+            sizeof(Position), &v);
+    }
+}
+
+void Observer_coalesce_set_in_callback(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    Probe ctx = {0};
+    ecs_entity_t o = ecs_observer(world, {
+        .query.terms = {{ ecs_id(Position) }},
+        .events = { EcsOnSet },
+        .callback = Observer_coalesced_set,
+        .coalesce = true,
+        .ctx = &ctx
+    });
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+
+    test_int(ecs_observer_flush(world, o), 1);
+    test_int(ctx.invoked, 1);
+    {
+        const Position *p = ecs_get(world, e, Position);
+        test_int(p->x, 11);
+    }
+
+    test_int(ecs_observer_flush(world, o), 1);
+    test_int(ctx.invoked, 2);
+    {
+        const Position *p = ecs_get(world, e, Position);
+        test_int(p->x, 12);
+    }
+
+    ecs_fini(world);
+}
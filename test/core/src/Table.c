@@ -1063,3 +1063,317 @@ void Table_empty_flag_on_delete_delete_children(void) {
 
     ecs_fini(world);
 }
+
+void Table_get_column_alignment(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t ecs_id(Mass) = ecs_component(world, {
+        .entity = ecs_new(world),
+        .type.size = 4,
+        .type.alignment = 4
+    });
+
+    ecs_entity_t e1 = ecs_new(world);
+    ecs_set(world, e1, Position, {10, 20});
+    ecs_set(world, e1, Mass, {1});
+
+    ecs_table_t *table = ecs_get_table(world, e1);
+    test_assert(table != NULL);
+
+    test_int(ECS_ALIGNOF(Position), ecs_table_get_column_alignment(table, 0));
+    test_int(4, ecs_table_get_column_alignment(table, 1));
+
+    ecs_fini(world);
+}
+
+void Table_column_alignment_world(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_column_alignment(world, 64);
+
+    ecs_entity_t entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = ecs_new(world);
+        ecs_set(world, entities[i], Position, {i, i * 2});
+        ecs_set(world, entities[i], Velocity, {i * 3, i * 4});
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    test_assert(table != NULL);
+    test_int(ecs_table_count(table), 100);
+
+    for (int c = 0; c < 2; c ++) {
+        test_int(64, ecs_table_get_column_alignment(table, c));
+        void *ptr = ecs_table_get_column(table, c, 0);
+        test_assert(ptr != NULL);
+        test_assert(((uintptr_t)ptr % 64) == 0);
+    }
+
+    for (int i = 0; i < 50; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    ecs_shrink(world);
+
+    for (int c = 0; c < 2; c ++) {
+        void *ptr = ecs_table_get_column(table, c, 0);
+        test_assert(ptr != NULL);
+        test_assert(((uintptr_t)ptr % 64) == 0);
+    }
+
+    for (int i = 50; i < 100; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+        const Velocity *v = ecs_get(world, entities[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, i * 3);
+        test_int(v->y, i * 4);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_column_alignment_component(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t ecs_id(Mass) = ecs_component(world, {
+        .entity = ecs_new(world),
+        .type.size = 4,
+        .type.alignment = 64
+    });
+
+    ecs_entity_t entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = ecs_new(world);
+        ecs_set(world, entities[i], Position, {i, i * 2});
+        ecs_set(world, entities[i], Mass, {i});
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    test_assert(table != NULL);
+
+    test_int(ECS_ALIGNOF(Position), ecs_table_get_column_alignment(table, 0));
+    test_int(64, ecs_table_get_column_alignment(table, 1));
+
+    void *ptr = ecs_table_get_column(table, 1, 0);
+    test_assert(ptr != NULL);
+    test_assert(((uintptr_t)ptr % 64) == 0);
+
+    for (int i = 0; i < 100; i ++) {
+        const Mass *m = ecs_get(world, entities[i], Mass);
+        test_assert(m != NULL);
+        test_int(*m, i);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_column_alignment_merge_w_unaligned(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    /* Create table before setting the alignment */
+    ecs_entity_t e = ecs_new(world);
+    ecs_set(world, e, Position, {0, 0});
+    ecs_table_t *dst = ecs_get_table(world, e);
+    ecs_delete(world, e);
+    test_int(ecs_table_count(dst), 0);
+
+    ecs_set_column_alignment(world, 64);
+
+    ecs_entity_t entities[10];
+    for (int i = 0; i < 10; i ++) {
+        entities[i] = ecs_new_w(world, Tag);
+        ecs_set(world, entities[i], Position, {i, i * 2});
+    }
+
+    ecs_table_t *src = ecs_get_table(world, entities[0]);
+    test_assert(src != dst);
+    test_int(64, ecs_table_get_column_alignment(src, 0));
+    test_int(ECS_ALIGNOF(Position), ecs_table_get_column_alignment(dst, 0));
+
+    ecs_delete(world, Tag);
+
+    test_int(ecs_table_count(dst), 10);
+    for (int i = 0; i < 10; i ++) {
+        test_assert(ecs_get_table(world, entities[i]) == dst);
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_add_pair_cached_edge(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, Tgt);
+
+    ecs_entity_t e1 = ecs_new(world);
+    ecs_add_pair(world, e1, Rel, Tgt);
+    ecs_entity_t e2 = ecs_new(world);
+    ecs_add_pair(world, e2, Rel, Tgt);
+
+    test_assert(ecs_has_pair(world, e1, Rel, Tgt));
+    test_assert(ecs_has_pair(world, e2, Rel, Tgt));
+    test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e2));
+
+    ecs_remove_pair(world, e1, Rel, Tgt);
+    ecs_remove_pair(world, e2, Rel, Tgt);
+    test_assert(!ecs_has_pair(world, e1, Rel, Tgt));
+    test_assert(!ecs_has_pair(world, e2, Rel, Tgt));
+    test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e2));
+
+    ecs_fini(world);
+}
+
+void Table_add_pair_cached_edge_after_table_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t tgt = ecs_new(world);
+    ecs_entity_t e1 = ecs_new_w(world, Foo);
+    ecs_add_pair(world, e1, Rel, tgt);
+    ecs_table_t *table = ecs_get_table(world, e1);
+    test_assert(table != NULL);
+
+    /* Deletes table with (Rel, tgt) */
+    ecs_delete(world, tgt);
+    test_assert(!ecs_has_pair(world, e1, Rel, tgt));
+    test_assert(ecs_has(world, e1, Foo));
+
+    tgt = ecs_new(world);
+    ecs_add_pair(world, e1, Rel, tgt);
+    test_assert(ecs_has_pair(world, e1, Rel, tgt));
+    test_assert(ecs_has(world, e1, Foo));
+
+    ecs_entity_t e2 = ecs_new_w(world, Foo);
+    ecs_add_pair(world, e2, Rel, tgt);
+    test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e2));
+
+    ecs_fini(world);
+}
+
+void Table_add_ids_cached_edge(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, Tgt);
+
+    ecs_entity_t e1 = ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_id(Position), ecs_pair(Rel, Tgt))
+    });
+    ecs_entity_t e2 = ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_id(Position), ecs_pair(Rel, Tgt))
+    });
+
+    test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e2));
+    test_assert(ecs_has(world, e2, Foo));
+    test_assert(ecs_has(world, e2, Position));
+    test_assert(ecs_has_pair(world, e2, Rel, Tgt));
+    test_int(ecs_get_type(world, e2)->count, 3);
+
+    /* Different order of ids */
+    ecs_entity_t e3 = ecs_entity(world, {
+        .add = ecs_ids(ecs_pair(Rel, Tgt), Foo, ecs_id(Position))
+    });
+    test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e3));
+
+    /* Subset of ids */
+    ecs_entity_t e4 = ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_id(Position))
+    });
+    test_assert(ecs_get_table(world, e1) != ecs_get_table(world, e4));
+    test_int(ecs_get_type(world, e4)->count, 2);
+
+    ecs_fini(world);
+}
+
+static int cached_edge_invoked = 0;
+
+static void CachedEdgeObserver(ecs_iter_t *it) {
+    cached_edge_invoked += it->count;
+}
+
+void Table_add_ids_cached_edge_w_new_observer(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, Tgt);
+
+    ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_pair(Rel, Tgt))
+    });
+
+    ecs_observer(world, {
+        .query.terms = {{ ecs_pair(Rel, Tgt) }},
+        .events = { EcsOnAdd },
+        .callback = CachedEdgeObserver
+    });
+
+    test_int(cached_edge_invoked, 0);
+
+    ecs_entity_t e = ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_pair(Rel, Tgt))
+    });
+    test_int(cached_edge_invoked, 1);
+    test_assert(ecs_has_pair(world, e, Rel, Tgt));
+
+    ecs_fini(world);
+}
+
+void Table_add_ids_cached_edge_after_table_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Foo);
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, Tgt);
+
+    ecs_entity_t e = ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_pair(Rel, Tgt))
+    });
+    ecs_table_t *table = ecs_get_table(world, e);
+    ecs_delete(world, e);
+    test_int(ecs_table_count(table), 0);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+    int32_t table_count = info->table_count;
+
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+    ecs_delete_empty_tables(world, &(ecs_delete_empty_tables_desc_t){
+        .delete_generation = 1
+    });
+    test_assert(info->table_count < table_count);
+
+    e = ecs_entity(world, {
+        .add = ecs_ids(Foo, ecs_pair(Rel, Tgt))
+    });
+    test_assert(ecs_has(world, e, Foo));
+    test_assert(ecs_has_pair(world, e, Rel, Tgt));
+    test_int(ecs_get_type(world, e)->count, 2);
+    test_int(ecs_table_count(ecs_get_table(world, e)), 1);
+
+    ecs_fini(world);
+}
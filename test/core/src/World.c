@@ -4432,3 +4432,249 @@ void World_delete_empty_tables_return_value(void) {
 
     ecs_fini(world);
 }
+
+void World_compact_delete_empty_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+    int32_t old_table_count = info->table_count;
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new_w_pair(world, Rel, ecs_new(world));
+        ecs_delete(world, e);
+    }
+
+    test_int(info->table_count, old_table_count + 10);
+
+    ecs_compact_desc_t desc = { .delete_generation = 1 };
+    ecs_compact(world, &desc); /* Increase to 1 */
+    test_int(info->table_count, old_table_count + 10);
+
+    int64_t reclaimed = ecs_compact(world, &desc); /* Delete */
+    test_assert(info->table_count < old_table_count);
+    test_assert(reclaimed > 0);
+    test_assert(info->compact_reclaimed_total >= reclaimed);
+
+    ecs_fini(world);
+}
+
+void World_compact_shrink_table(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[1000];
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    for (i = 100; i < 1000; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    test_assert(ecs_table_size(table) >= 1000);
+
+    int64_t reclaimed = ecs_compact(world, &(ecs_compact_desc_t){0});
+    test_assert(reclaimed > 0);
+    test_int(ecs_table_size(table), 150);
+    test_int(ecs_table_count(table), 100);
+
+    for (i = 0; i < 100; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void World_compact_shrink_table_fluctuating_count(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[1000];
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    for (i = 100; i < 1000; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    ecs_compact(world, &(ecs_compact_desc_t){0});
+    test_int(ecs_table_size(table), 150);
+
+    /* Removing entities doesn't shrink the table again */
+    for (i = 80; i < 100; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+
+    test_int(ecs_compact(world, &(ecs_compact_desc_t){0}), 0);
+    test_int(ecs_table_size(table), 150);
+    test_int(ecs_table_count(table), 80);
+
+    /* Adding entities doesn't grow the table */
+    for (i = 80; i < 150; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+    }
+
+    test_int(ecs_compact(world, &(ecs_compact_desc_t){0}), 0);
+    test_int(ecs_table_size(table), 150);
+    test_int(ecs_table_count(table), 150);
+
+    for (i = 0; i < 150; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, i);
+    }
+
+    ecs_fini(world);
+}
+
+void World_compact_clear_empty_table(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_table_t *table = ecs_get_table(world, e);
+    ecs_delete(world, e);
+
+    test_assert(ecs_table_size(table) != 0);
+
+    ecs_compact_desc_t desc = { .clear_generation = 1 };
+    ecs_compact(world, &desc);
+    test_assert(ecs_table_size(table) != 0);
+
+    ecs_compact(world, &desc);
+    test_int(ecs_table_size(table), 0);
+
+    /* Table is cleared, not deleted */
+    e = ecs_insert(world, ecs_value(Position, {30, 40}));
+    test_assert(ecs_get_table(world, e) == table);
+
+    ecs_fini(world);
+}
+
+void World_compact_nonempty_table_resets_generation(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+
+    ecs_entity_t tgt = ecs_new(world);
+    ecs_entity_t e = ecs_new_w_pair(world, Rel, tgt);
+    ecs_table_t *table = ecs_get_table(world, e);
+    ecs_remove_pair(world, e, Rel, tgt);
+
+    ecs_compact_desc_t desc = { .delete_generation = 1 };
+    ecs_compact(world, &desc); /* Increase to 1 */
+
+    ecs_add_pair(world, e, Rel, tgt);
+    test_assert(ecs_get_table(world, e) == table);
+    ecs_compact(world, &desc); /* Reset */
+
+    ecs_remove_pair(world, e, Rel, tgt);
+    int32_t table_count = info->table_count;
+    ecs_compact(world, &desc); /* Increase to 1 */
+    test_int(info->table_count, table_count);
+
+    ecs_compact(world, &desc); /* Delete */
+    test_int(info->table_count, table_count - 1);
+
+    ecs_fini(world);
+}
+
+void World_compact_time_budget(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+
+    int i;
+    for (i = 0; i < 200; i ++) {
+        ecs_entity_t e = ecs_new_w_pair(world, Rel, ecs_new(world));
+        ecs_delete(world, e);
+    }
+
+    /* Full pass increases generation of all empty tables */
+    ecs_compact(world, &(ecs_compact_desc_t){ .delete_generation = 1 });
+    int32_t table_count = info->table_count;
+
+    ecs_compact_desc_t desc = { 
+        .delete_generation = 1, 
+        .time_budget_seconds = 0.000000001
+    };
+
+    ecs_compact(world, &desc);
+    test_assert(info->table_count < table_count);
+    test_assert(info->table_count > (table_count - 200));
+
+    /* Subsequent calls continue where the previous call left off */
+    for (i = 0; i < 100; i ++) {
+        ecs_compact(world, &desc);
+    }
+
+    test_assert(info->table_count <= (table_count - 200));
+
+    ecs_fini(world);
+}
+
+void World_compact_on_frame_end(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Rel);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new_w_pair(world, Rel, ecs_new(world));
+        ecs_delete(world, e);
+    }
+
+    int32_t table_count = info->table_count;
+
+    ecs_set_compaction(world, &(ecs_compact_desc_t){ .delete_generation = 1 });
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    test_assert(info->table_count <= (table_count - 10));
+    test_assert(info->compact_reclaimed_total > 0);
+
+    /* Disable compaction */
+    ecs_set_compaction(world, NULL);
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new_w_pair(world, Rel, ecs_new(world));
+        ecs_delete(world, e);
+    }
+
+    table_count = info->table_count;
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    test_int(info->table_count, table_count);
+
+    ecs_fini(world);
+}
+
+void World_compact_deferred(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ecs_defer_begin(world);
+
+    test_expect_abort();
+    ecs_compact(world, &(ecs_compact_desc_t){0});
+}
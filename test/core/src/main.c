@@ -316,6 +316,14 @@ void Iter_rule_page_iter_w_fini(void);
 void Iter_rule_worker_iter_w_fini(void);
 void Iter_to_str_before_next(void);
 void Iter_to_str(void);
+void Iter_dynamic_worker_iter(void);
+void Iter_dynamic_worker_iter_2_workers(void);
+void Iter_dynamic_worker_iter_w_fini(void);
+void Iter_worker_iter_partition_tables(void);
+void Iter_worker_iter_partition_tables_w_not(void);
+void Iter_worker_iter_partition_tables_w_pair(void);
+void Iter_worker_iter_partition_tables_w_or(void);
+void Iter_dynamic_worker_iter_partition_tables(void);
 
 // Testsuite 'Search'
 void Search_search(void);
@@ -1218,6 +1226,13 @@ void Get_component_get_sparse_w_pair(void);
 void Get_component_get_sparse_w_non_sparse(void);
 void Get_component_get_sparse_w_inherit(void);
 void Get_component_get_sparse_w_wildcard(void);
+void Get_component_get_many(void);
+void Get_component_get_many_different_tables(void);
+void Get_component_get_many_not_found(void);
+void Get_component_get_many_pair(void);
+void Get_component_get_many_inherited(void);
+void Get_component_get_many_sparse(void);
+void Get_component_get_many_no_entities(void);
 
 // Testsuite 'Reference'
 void Reference_setup(void);
@@ -2382,6 +2397,16 @@ void Observer_multi_term_on_set_w_base_and_3_instances_in_different_tables(void)
 void Observer_propagate_isa_two_bases_dirty_reachable_cache(void);
 void Observer_propagate_on_set_2_lvls(void);
 void Observer_propagate_on_set_2_lvls_2_terms(void);
+void Observer_coalesce_on_set(void);
+void Observer_coalesce_on_set_table_batch(void);
+void Observer_coalesce_add_remove(void);
+void Observer_coalesce_on_add_on_set(void);
+void Observer_coalesce_on_remove(void);
+void Observer_coalesce_remove_add(void);
+void Observer_coalesce_remove_add_no_set(void);
+void Observer_coalesce_delete(void);
+void Observer_coalesce_2_terms(void);
+void Observer_coalesce_set_in_callback(void);
 
 // Testsuite 'ObserverOnSet'
 void ObserverOnSet_set_1_of_1(void);
@@ -2882,6 +2907,14 @@ void World_delete_empty_tables_w_offset(void);
 void World_delete_empty_tables_w_offset_out_of_range(void);
 void World_delete_empty_tables_w_offset_wrap_around(void);
 void World_delete_empty_tables_return_value(void);
+void World_compact_delete_empty_tables(void);
+void World_compact_shrink_table(void);
+void World_compact_shrink_table_fluctuating_count(void);
+void World_compact_clear_empty_table(void);
+void World_compact_nonempty_table_resets_generation(void);
+void World_compact_time_budget(void);
+void World_compact_on_frame_end(void);
+void World_compact_deferred(void);
 
 // Testsuite 'ExclusiveAccess'
 void ExclusiveAccess_self(void);
@@ -3345,6 +3378,15 @@ void Table_empty_flag_clear(void);
 void Table_empty_flag_bulk_init(void);
 void Table_empty_flag_table_clear(void);
 void Table_empty_flag_on_delete_delete_children(void);
+void Table_get_column_alignment(void);
+void Table_column_alignment_world(void);
+void Table_column_alignment_component(void);
+void Table_column_alignment_merge_w_unaligned(void);
+void Table_add_pair_cached_edge(void);
+void Table_add_pair_cached_edge_after_table_delete(void);
+void Table_add_ids_cached_edge(void);
+void Table_add_ids_cached_edge_w_new_observer(void);
+void Table_add_ids_cached_edge_after_table_delete(void);
 
 // Testsuite 'Poly'
 void Poly_on_set_poly_observer(void);
@@ -4632,6 +4674,38 @@ bake_test_case Iter_testcases[] = {
     {
         "to_str",
         Iter_to_str
+    },
+    {
+        "dynamic_worker_iter",
+        Iter_dynamic_worker_iter
+    },
+    {
+        "dynamic_worker_iter_2_workers",
+        Iter_dynamic_worker_iter_2_workers
+    },
+    {
+        "dynamic_worker_iter_w_fini",
+        Iter_dynamic_worker_iter_w_fini
+    },
+    {
+        "worker_iter_partition_tables",
+        Iter_worker_iter_partition_tables
+    },
+    {
+        "worker_iter_partition_tables_w_not",
+        Iter_worker_iter_partition_tables_w_not
+    },
+    {
+        "worker_iter_partition_tables_w_pair",
+        Iter_worker_iter_partition_tables_w_pair
+    },
+    {
+        "worker_iter_partition_tables_w_or",
+        Iter_worker_iter_partition_tables_w_or
+    },
+    {
+        "dynamic_worker_iter_partition_tables",
+        Iter_dynamic_worker_iter_partition_tables
     }
 };
 
@@ -8154,6 +8228,34 @@ bake_test_case Get_component_testcases[] = {
     {
         "get_sparse_w_wildcard",
         Get_component_get_sparse_w_wildcard
+    },
+    {
+        "get_many",
+        Get_component_get_many
+    },
+    {
+        "get_many_different_tables",
+        Get_component_get_many_different_tables
+    },
+    {
+        "get_many_not_found",
+        Get_component_get_many_not_found
+    },
+    {
+        "get_many_pair",
+        Get_component_get_many_pair
+    },
+    {
+        "get_many_inherited",
+        Get_component_get_many_inherited
+    },
+    {
+        "get_many_sparse",
+        Get_component_get_many_sparse
+    },
+    {
+        "get_many_no_entities",
+        Get_component_get_many_no_entities
     }
 };
 
@@ -12734,6 +12836,46 @@ bake_test_case Observer_testcases[] = {
     {
         "propagate_on_set_2_lvls_2_terms",
         Observer_propagate_on_set_2_lvls_2_terms
+    },
+    {
+        "coalesce_on_set",
+        Observer_coalesce_on_set
+    },
+    {
+        "coalesce_on_set_table_batch",
+        Observer_coalesce_on_set_table_batch
+    },
+    {
+        "coalesce_add_remove",
+        Observer_coalesce_add_remove
+    },
+    {
+        "coalesce_on_add_on_set",
+        Observer_coalesce_on_add_on_set
+    },
+    {
+        "coalesce_on_remove",
+        Observer_coalesce_on_remove
+    },
+    {
+        "coalesce_remove_add",
+        Observer_coalesce_remove_add
+    },
+    {
+        "coalesce_remove_add_no_set",
+        Observer_coalesce_remove_add_no_set
+    },
+    {
+        "coalesce_delete",
+        Observer_coalesce_delete
+    },
+    {
+        "coalesce_2_terms",
+        Observer_coalesce_2_terms
+    },
+    {
+        "coalesce_set_in_callback",
+        Observer_coalesce_set_in_callback
     }
 };
 
@@ -14687,6 +14829,38 @@ bake_test_case World_testcases[] = {
     {
         "delete_empty_tables_return_value",
         World_delete_empty_tables_return_value
+    },
+    {
+        "compact_delete_empty_tables",
+        World_compact_delete_empty_tables
+    },
+    {
+        "compact_shrink_table",
+        World_compact_shrink_table
+    },
+    {
+        "compact_shrink_table_fluctuating_count",
+        World_compact_shrink_table_fluctuating_count
+    },
+    {
+        "compact_clear_empty_table",
+        World_compact_clear_empty_table
+    },
+    {
+        "compact_nonempty_table_resets_generation",
+        World_compact_nonempty_table_resets_generation
+    },
+    {
+        "compact_time_budget",
+        World_compact_time_budget
+    },
+    {
+        "compact_on_frame_end",
+        World_compact_on_frame_end
+    },
+    {
+        "compact_deferred",
+        World_compact_deferred
     }
 };
 
@@ -16492,6 +16666,42 @@ bake_test_case Table_testcases[] = {
     {
         "empty_flag_on_delete_delete_children",
         Table_empty_flag_on_delete_delete_children
+    },
+    {
+        "get_column_alignment",
+        Table_get_column_alignment
+    },
+    {
+        "column_alignment_world",
+        Table_column_alignment_world
+    },
+    {
+        "column_alignment_component",
+        Table_column_alignment_component
+    },
+    {
+        "column_alignment_merge_w_unaligned",
+        Table_column_alignment_merge_w_unaligned
+    },
+    {
+        "add_pair_cached_edge",
+        Table_add_pair_cached_edge
+    },
+    {
+        "add_pair_cached_edge_after_table_delete",
+        Table_add_pair_cached_edge_after_table_delete
+    },
+    {
+        "add_ids_cached_edge",
+        Table_add_ids_cached_edge
+    },
+    {
+        "add_ids_cached_edge_w_new_observer",
+        Table_add_ids_cached_edge_w_new_observer
+    },
+    {
+        "add_ids_cached_edge_after_table_delete",
+        Table_add_ids_cached_edge_after_table_delete
     }
 };
 
@@ -16790,7 +17000,7 @@ static bake_test_suite suites[] = {
         "Iter",
         NULL,
         NULL,
-        62,
+        70,
         Iter_testcases
     },
     {
@@ -16890,7 +17100,7 @@ static bake_test_suite suites[] = {
         "Get_component",
         Get_component_setup,
         NULL,
-        21,
+        28,
         Get_component_testcases
     },
     {
@@ -16974,7 +17184,7 @@ static bake_test_suite suites[] = {
         "Observer",
         NULL,
         NULL,
-        355,
+        365,
         Observer_testcases
     },
     {
@@ -17023,7 +17233,7 @@ static bake_test_suite suites[] = {
         "World",
         World_setup,
         NULL,
-        176,
+        184,
         World_testcases
     },
     {
@@ -17072,7 +17282,7 @@ static bake_test_suite suites[] = {
         "Table",
         NULL,
         NULL,
-        41,
+        50,
         Table_testcases
     },
     {
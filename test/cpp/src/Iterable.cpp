@@ -84,6 +84,41 @@ void Iterable_worker_each(void) {
     test_int(count, 2);
 }
 
+void Iterable_worker_each_partition_tables(void) {
+    flecs::world ecs;
+
+    struct Tag { };
+
+    auto e1 = ecs.entity(); e1.set<Self>({e1});
+    auto e2 = ecs.entity(); e2.set<Self>({e2});
+    auto e3 = ecs.entity(); e3.set<Self>({e3});
+    auto e4 = ecs.entity(); e4.set<Self>({e4}).add<Tag>();
+    auto e5 = ecs.entity(); e5.set<Self>({e5}).add<Tag>();
+
+    auto q = ecs.query_builder<Self>()
+        .partition_tables()
+        .build();
+
+    int32_t count = 0;
+    q.worker(0, 2).each([&](flecs::entity e, Self& self) {
+        count ++;
+        test_assert(e != e4);
+        test_assert(e != e5);
+        test_assert(e == self.value);
+    });
+
+    test_int(count, 3);
+
+    count = 0;
+    q.worker(1, 2).each([&](flecs::entity e, Self& self) {
+        count ++;
+        test_assert(e == e4 || e == e5);
+        test_assert(e == self.value);
+    });
+
+    test_int(count, 2);
+}
+
 void Iterable_worker_iter(void) {
     flecs::world ecs;
 
@@ -1711,3 +1711,55 @@ void Meta_ecs_struct_macro_no_reflection_for_plain_struct(void) {
     test_assert(c != 0);
     test_assert(!ecs.entity(c).has<flecs::Struct>());
 }
+
+void Meta_soa_struct(void) {
+    flecs::world ecs;
+
+    struct Particle {
+        float x;
+        float y;
+    };
+
+    auto c = ecs.component<Particle>()
+        .member<float>("x")
+        .member<float>("y")
+        .add(flecs::SoA);
+
+    flecs::entity x = c.lookup("x");
+    flecs::entity y = c.lookup("y");
+    test_assert(x != 0);
+    test_assert(y != 0);
+    test_assert(x.has<flecs::Component>());
+    test_assert(y.has<flecs::Component>());
+
+    flecs::entity e1 = ecs.entity().add<Particle>();
+    flecs::entity e2 = ecs.entity().add<Particle>();
+    test_assert(e1.has(x));
+    test_assert(e1.has(y));
+
+    float v1 = 10, v2 = 20;
+    e1.set_ptr(x, &v1);
+    e2.set_ptr(x, &v2);
+
+    auto q = ecs.query_builder()
+        .with(x)
+        .build();
+
+    int32_t count = 0;
+    q.run([&](flecs::iter& it) {
+        while (it.next()) {
+            const float *fx = static_cast<const float*>(
+                ecs_field_w_size(it.c_ptr(), sizeof(float), 0));
+            test_int(it.count(), 2);
+            test_flt(fx[0], 10);
+            test_flt(fx[1], 20);
+            count += static_cast<int32_t>(it.count());
+        }
+    });
+
+    test_int(count, 2);
+
+    e1.remove<Particle>();
+    test_assert(!e1.has(x));
+    test_assert(!e1.has(y));
+}
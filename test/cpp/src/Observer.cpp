@@ -1862,3 +1862,83 @@ void Observer_reuse_observer_builder(void) {
     test_int(count_1, 2);
     test_int(count_2, 1);
 }
+
+void Observer_coalesce(void) {
+    flecs::world ecs;
+
+    int invoked = 0, count = 0;
+    auto o = ecs.observer<Position>()
+        .event(flecs::OnSet)
+        .coalesce()
+        .run([&](flecs::iter& it) {
+            while (it.next()) {
+                auto p = it.field<Position>(0);
+                invoked ++;
+                count += static_cast<int>(it.count());
+                test_int(p[0].x, 30);
+            }
+        });
+
+    flecs::entity e = ecs.entity().set(Position{10, 20});
+    e.set(Position{20, 30});
+    e.set(Position{30, 40});
+    test_int(invoked, 0);
+
+    test_int(o.flush(), 1);
+    test_int(invoked, 1);
+    test_int(count, 1);
+
+    test_int(o.flush(), 0);
+    test_int(invoked, 1);
+}
+
+void Observer_coalesce_phase(void) {
+    flecs::world ecs;
+
+    int invoked = 0;
+    ecs.observer<Position>()
+        .event(flecs::OnSet)
+        .coalesce(flecs::PostUpdate)
+        .each([&](Position& p) {
+            invoked ++;
+            test_int(p.x, 20);
+        });
+
+    flecs::entity e = ecs.entity().set(Position{10, 20});
+    e.set(Position{20, 30});
+    test_int(invoked, 0);
+
+    ecs.progress();
+    test_int(invoked, 1);
+
+    ecs.progress();
+    test_int(invoked, 1);
+}
+
+void Observer_coalesce_multi_threaded(void) {
+    flecs::world ecs;
+
+    ecs.component<Velocity>();
+    ecs.set_threads(4);
+
+    flecs::observer o = ecs.observer<const Position>()
+        .event(flecs::OnSet)
+        .coalesce()
+        .multi_threaded()
+        .each([](flecs::entity e, const Position& p) {
+            e.set(Velocity{p.x, p.y});
+        });
+
+    flecs::entity e1 = ecs.entity().set(Position{10, 20});
+    flecs::entity e2 = ecs.entity().add<Tag>().set(Position{30, 40});
+
+    test_int(o.flush(), 2);
+
+    test_assert(e1.has<Velocity>());
+    test_int(e1.get<Velocity>().x, 10);
+    test_int(e1.get<Velocity>().y, 20);
+
+    test_assert(e2.has<Velocity>());
+    test_int(e2.get<Velocity>().x, 30);
+    test_int(e2.get<Velocity>().y, 40);
+}
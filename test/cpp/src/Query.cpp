@@ -4647,3 +4647,150 @@ void Query_sparse_query_dynamic_dont_inherit(void) {
     test_int(count, 2);
     test_int(q.count(), 2);
 }
+
+void Query_each_batch(void) {
+    flecs::world world;
+
+    auto e1 = world.entity().set<Position>({10, 20}).set<Velocity>({1, 2});
+    auto e2 = world.entity().set<Position>({20, 30}).set<Velocity>({1, 2});
+    auto e3 = world.entity().set<Position>({30, 40}).set<Velocity>({1, 2})
+        .add<Tag>();
+
+    auto q = world.query<Position, const Velocity>();
+
+    int32_t invoked = 0, count = 0;
+    q.each_batch([&](size_t n, Position *p, const Velocity *v) {
+        for (size_t i = 0; i < n; i ++) {
+            p[i].x += v[i].x;
+            p[i].y += v[i].y;
+        }
+        count += static_cast<int32_t>(n);
+        invoked ++;
+    });
+
+    test_int(invoked, 2);
+    test_int(count, 3);
+
+    const Position *p = e1.try_get<Position>();
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    p = e2.try_get<Position>();
+    test_int(p->x, 21);
+    test_int(p->y, 32);
+
+    p = e3.try_get<Position>();
+    test_int(p->x, 31);
+    test_int(p->y, 42);
+}
+
+void Query_each_batch_optional(void) {
+    flecs::world world;
+
+    auto e1 = world.entity().set<Position>({10, 20}).set<Velocity>({1, 2});
+    auto e2 = world.entity().set<Position>({20, 30});
+
+    auto q = world.query<Position, const Velocity*>();
+
+    int32_t invoked = 0;
+    q.each_batch([&](size_t n, Position *p, const Velocity *v) {
+        test_int(n, 1);
+        if (v) {
+            p[0].x += v[0].x;
+            p[0].y += v[0].y;
+        } else {
+            p[0].x ++;
+        }
+        invoked ++;
+    });
+
+    test_int(invoked, 2);
+
+    const Position *p = e1.try_get<Position>();
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    p = e2.try_get<Position>();
+    test_int(p->x, 21);
+    test_int(p->y, 30);
+}
+
+void Query_each_batch_w_tag(void) {
+    flecs::world world;
+
+    auto e1 = world.entity().set<Position>({10, 20}).add<Tag>();
+    auto e2 = world.entity().set<Position>({20, 30}).add<Tag>();
+
+    auto q = world.query<Position, Tag>();
+
+    int32_t invoked = 0;
+    q.each_batch([&](size_t n, Position *p, Tag *t) {
+        test_int(n, 2);
+        test_assert(t == nullptr);
+        for (size_t i = 0; i < n; i ++) {
+            p[i].x ++;
+        }
+        invoked ++;
+    });
+
+    test_int(invoked, 1);
+    test_int(e1.try_get<Position>()->x, 11);
+    test_int(e2.try_get<Position>()->x, 21);
+}
+
+void Query_each_batch_w_up(void) {
+    flecs::world world;
+
+    auto parent = world.entity().set<Velocity>({1, 2});
+    auto e1 = world.entity().child_of(parent).set<Position>({10, 20});
+    auto e2 = world.entity().child_of(parent).set<Position>({20, 30});
+
+    auto q = world.query_builder<Position, const Velocity>()
+        .term_at(1).up()
+        .build();
+
+    int32_t invoked = 0;
+    q.each_batch([&](size_t n, Position *p, const Velocity *v) {
+        test_int(n, 1);
+        test_int(v->x, 1);
+        test_int(v->y, 2);
+        p->x += v->x;
+        p->y += v->y;
+        invoked ++;
+    });
+
+    test_int(invoked, 2);
+
+    const Position *p = e1.try_get<Position>();
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    p = e2.try_get<Position>();
+    test_int(p->x, 21);
+    test_int(p->y, 32);
+}
+
+void Query_each_batch_w_pair(void) {
+    flecs::world world;
+
+    auto e1 = world.entity().set<Position, Tag>({10, 20});
+    auto e2 = world.entity().set<Position, Tag>({20, 30});
+
+    auto q = world.query<flecs::pair<Position, Tag>>();
+
+    int32_t invoked = 0;
+    q.each_batch([&](size_t n, Position *p) {
+        test_int(n, 2);
+        for (size_t i = 0; i < n; i ++) {
+            p[i].x ++;
+        }
+        invoked ++;
+    });
+
+    test_int(invoked, 1);
+
+    const Position *p = e1.try_get<Position, Tag>();
+    test_int(p->x, 11);
+    p = e2.try_get<Position, Tag>();
+    test_int(p->x, 21);
+}
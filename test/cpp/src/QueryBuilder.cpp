@@ -5843,3 +5843,40 @@ void QueryBuilder_pred_match(void) {
 
     test_int(count, 1);
 }
+
+void QueryBuilder_plan_by_cost(void) {
+    flecs::world ecs;
+
+    struct Rare { };
+
+    for (int i = 0; i < 10; i ++) {
+        ecs.entity().add<Position>().add<Velocity>().add(ecs.entity());
+    }
+
+    flecs::entity e = ecs.entity()
+        .set<Position>({10, 20})
+        .set<Velocity>({1, 2})
+        .add<Rare>();
+
+    auto q = ecs.query_builder<Position, const Velocity>()
+        .with<Rare>()
+        .plan_by_cost()
+        .build();
+
+    test_assert(q.c_ptr()->flags & EcsQueryPlanByCost);
+
+    int32_t count = 0;
+    q.each([&](flecs::entity qe, Position& p, const Velocity& v) {
+        test_assert(qe == e);
+        p.x += v.x;
+        p.y += v.y;
+        count ++;
+    });
+
+    test_int(count, 1);
+
+    const Position *p = e.try_get<Position>();
+    test_assert(p != NULL);
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+}
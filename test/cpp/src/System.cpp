@@ -2528,3 +2528,105 @@ void System_run_w_0_src_query(void) {
     world.progress();
     test_int(count, 1);
 }
+
+void System_multithread_system_w_chunk_size(void) {
+    flecs::world world;
+
+    world.set_threads(4);
+
+    flecs::entity entities[50];
+    for (int i = 0; i < 50; i ++) {
+        entities[i] = world.entity().set<Position>({10, 20});
+    }
+
+    auto s = world.system<Position>()
+        .multi_threaded()
+        .chunk_size(8)
+        .each([](Position& p) {
+            p.x ++;
+        });
+
+    test_int(ecs_system_get(world, s)->chunk_size, 8);
+
+    world.progress();
+
+    for (int i = 0; i < 50; i ++) {
+        const Position *p = entities[i].try_get<Position>();
+        test_int(p->x, 11);
+        test_int(p->y, 20);
+    }
+}
+
+void System_multithread_system_w_parallel_merge(void) {
+    flecs::world world;
+
+    world.set_threads(4);
+    world.set_parallel_merge();
+
+    flecs::entity entities[50];
+    for (int i = 0; i < 50; i ++) {
+        entities[i] = world.entity()
+            .set<Position>({10, 20})
+            .set<std::string>("Hello");
+    }
+
+    int32_t on_set_count = 0;
+    world.observer<std::string>()
+        .event(flecs::OnSet)
+        .each([&](std::string&) {
+            on_set_count ++;
+        });
+
+    world.system<Position>()
+        .multi_threaded()
+        .each([](flecs::entity e, Position& p) {
+            e.set<std::string>("World");
+            e.set<Position>({p.x + 1, p.y});
+        });
+
+    world.progress();
+
+    test_int(on_set_count, 50);
+
+    for (int i = 0; i < 50; i ++) {
+        const Position *p = entities[i].try_get<Position>();
+        test_int(p->x, 11);
+        test_int(p->y, 20);
+        test_str(entities[i].get<std::string>().c_str(), "World");
+    }
+}
+
+void System_each_batch(void) {
+    flecs::world world;
+
+    auto e1 = world.entity().set<Position>({10, 20}).set<Velocity>({1, 2});
+    auto e2 = world.entity().set<Position>({20, 30}).set<Velocity>({3, 4});
+    auto e3 = world.entity().set<Position>({30, 40}).set<Velocity>({5, 6})
+        .add<Tag>();
+
+    int32_t invoked = 0;
+    world.system<Position, const Velocity>()
+        .each_batch([&](size_t n, Position *p, const Velocity *v) {
+            for (size_t i = 0; i < n; i ++) {
+                p[i].x += v[i].x;
+                p[i].y += v[i].y;
+            }
+            invoked ++;
+        });
+
+    world.progress();
+
+    test_int(invoked, 2);
+
+    const Position *p = e1.try_get<Position>();
+    test_int(p->x, 11);
+    test_int(p->y, 22);
+
+    p = e2.try_get<Position>();
+    test_int(p->x, 23);
+    test_int(p->y, 34);
+
+    p = e3.try_get<Position>();
+    test_int(p->x, 35);
+    test_int(p->y, 46);
+}
@@ -816,3 +816,51 @@ void Table_clear_entities(void) {
     test_int(table.count(), 0);
     test_int(table.size(), 2);
 }
+
+struct alignas(64) AlignedPosition {
+    float x;
+    float y;
+};
+
+void Table_column_alignment(void) {
+    flecs::world ecs;
+
+    flecs::entity e = ecs.entity()
+        .set<Position>({10, 20})
+        .set<AlignedPosition>({30, 40});
+
+    flecs::table table = e.table();
+    test_int(table.column_alignment(0), alignof(Position));
+    test_int(table.column_alignment(1), 64);
+
+    const void *ptr = table.get<AlignedPosition>();
+    test_assert(ptr != nullptr);
+    test_assert((reinterpret_cast<uintptr_t>(ptr) % 64) == 0);
+}
+
+void Table_column_alignment_w_lifecycle(void) {
+    flecs::world ecs;
+
+    ecs.set_column_alignment(64);
+
+    flecs::entity entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = ecs.entity()
+            .set<Position>({10, 20})
+            .set<std::string>(std::to_string(i));
+    }
+
+    flecs::table table = entities[0].table();
+    test_int(table.column_alignment(0), 64);
+    test_int(table.column_alignment(1), 64);
+
+    for (int32_t c = 0; c < 2; c ++) {
+        const void *ptr = ecs_table_get_column(table, c, 0);
+        test_assert((reinterpret_cast<uintptr_t>(ptr) % 64) == 0);
+    }
+
+    for (int i = 0; i < 100; i ++) {
+        test_str(entities[i].get<std::string>().c_str(), 
+            std::to_string(i).c_str());
+    }
+}
@@ -2273,3 +2273,55 @@ void World_get_type_info_R_T_tag(void) {
     const flecs::type_info_t *ti = world.type_info<Tag, Tgt>();
     test_assert(ti == nullptr);
 }
+
+void World_get_many(void) {
+    flecs::world world;
+
+    flecs::entity_t entities[3] = {
+        world.entity().set<Position>({10, 20}),
+        world.entity().add<Velocity>(),
+        world.entity().set<Position>({30, 40})
+    };
+
+    const Position *ptrs[3];
+    world.get_many<Position>(entities, 3, ptrs);
+
+    test_assert(ptrs[0] != nullptr);
+    test_int(ptrs[0]->x, 10);
+    test_int(ptrs[0]->y, 20);
+    test_assert(ptrs[1] == nullptr);
+    test_assert(ptrs[2] != nullptr);
+    test_int(ptrs[2]->x, 30);
+    test_int(ptrs[2]->y, 40);
+}
+
+void World_get_many_array(void) {
+    flecs::world world;
+
+    flecs::entity_t entities[2] = {
+        world.entity().set<Position>({10, 20}),
+        world.entity().set<Position>({30, 40})
+    };
+
+    const Position *ptrs[2];
+    world.get_many(entities, ptrs);
+
+    test_int(ptrs[0]->x, 10);
+    test_int(ptrs[1]->x, 30);
+}
+
+void World_get_many_id(void) {
+    flecs::world world;
+
+    flecs::entity_t entities[2] = {
+        world.entity().set<Position>({10, 20}),
+        world.entity()
+    };
+
+    const void *ptrs[2];
+    world.get_many(world.id<Position>(), entities, 2, ptrs);
+
+    test_assert(ptrs[0] != nullptr);
+    test_int(static_cast<const Position*>(ptrs[0])->x, 10);
+    test_assert(ptrs[1] == nullptr);
+}
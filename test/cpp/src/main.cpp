@@ -662,6 +662,9 @@ void System_lookup_and_update_run(void);
 void System_lookup_and_update_ctx(void);
 void System_set_group(void);
 void System_run_w_0_src_query(void);
+void System_multithread_system_w_chunk_size(void);
+void System_multithread_system_w_parallel_merge(void);
+void System_each_batch(void);
 
 // Testsuite 'Event'
 void Event_evt_1_id_entity(void);
@@ -701,6 +704,7 @@ void Iterable_page_each(void);
 void Iterable_page_iter(void);
 void Iterable_worker_each(void);
 void Iterable_worker_iter(void);
+void Iterable_worker_each_partition_tables(void);
 
 // Testsuite 'Query'
 void Query_term_each_component(void);
@@ -868,6 +872,11 @@ void Query_sparse_query_convert_to_query_1_term(void);
 void Query_sparse_query_convert_to_query_3_terms(void);
 void Query_world_each_sparse(void);
 void Query_world_each_sparse_w_entity(void);
+void Query_each_batch(void);
+void Query_each_batch_optional(void);
+void Query_each_batch_w_tag(void);
+void Query_each_batch_w_up(void);
+void Query_each_batch_w_pair(void);
 
 // Testsuite 'QueryBuilder'
 void QueryBuilder_setup(void);
@@ -1060,6 +1069,7 @@ void QueryBuilder_query_w_this_second(void);
 void QueryBuilder_pred_eq(void);
 void QueryBuilder_pred_eq_name(void);
 void QueryBuilder_pred_match(void);
+void QueryBuilder_plan_by_cost(void);
 
 // Testsuite 'SystemBuilder'
 void SystemBuilder_builder_assign_same_type(void);
@@ -1167,6 +1177,9 @@ void Observer_fixed_src_w_each(void);
 void Observer_fixed_src_w_run(void);
 void Observer_untyped_field(void);
 void Observer_reuse_observer_builder(void);
+void Observer_coalesce(void);
+void Observer_coalesce_phase(void);
+void Observer_coalesce_multi_threaded(void);
 
 // Testsuite 'ComponentLifecycle'
 void ComponentLifecycle_ctor_on_add(void);
@@ -1509,6 +1522,9 @@ void World_get_type_info_T_tag(void);
 void World_get_type_info_r_t_tag(void);
 void World_get_type_info_R_t_tag(void);
 void World_get_type_info_R_T_tag(void);
+void World_get_many(void);
+void World_get_many_array(void);
+void World_get_many_id(void);
 
 // Testsuite 'Singleton'
 void Singleton_set_get_singleton(void);
@@ -1637,6 +1653,7 @@ void Meta_ecs_struct_macro_idempotent(void);
 void Meta_ecs_enum_macro(void);
 void Meta_ecs_bitmask_macro(void);
 void Meta_ecs_struct_macro_no_reflection_for_plain_struct(void);
+void Meta_soa_struct(void);
 
 // Testsuite 'Table'
 void Table_each(void);
@@ -1679,6 +1696,8 @@ void Table_lock(void);
 void Table_unlock(void);
 void Table_has_flags(void);
 void Table_clear_entities(void);
+void Table_column_alignment(void);
+void Table_column_alignment_w_lifecycle(void);
 
 // Testsuite 'ComponentTraits'
 void ComponentTraits_dont_fragment_explicit(void);
@@ -4298,6 +4317,18 @@ bake_test_case System_testcases[] = {
     {
         "run_w_0_src_query",
         System_run_w_0_src_query
+    },
+    {
+        "multithread_system_w_chunk_size",
+        System_multithread_system_w_chunk_size
+    },
+    {
+        "multithread_system_w_parallel_merge",
+        System_multithread_system_w_parallel_merge
+    },
+    {
+        "each_batch",
+        System_each_batch
     }
 };
 
@@ -4444,6 +4475,10 @@ bake_test_case Iterable_testcases[] = {
     {
         "worker_iter",
         Iterable_worker_iter
+    },
+    {
+        "worker_each_partition_tables",
+        Iterable_worker_each_partition_tables
     }
 };
 
@@ -5107,6 +5142,26 @@ bake_test_case Query_testcases[] = {
     {
         "world_each_sparse_w_entity",
         Query_world_each_sparse_w_entity
+    },
+    {
+        "each_batch",
+        Query_each_batch
+    },
+    {
+        "each_batch_optional",
+        Query_each_batch_optional
+    },
+    {
+        "each_batch_w_tag",
+        Query_each_batch_w_tag
+    },
+    {
+        "each_batch_w_up",
+        Query_each_batch_w_up
+    },
+    {
+        "each_batch_w_pair",
+        Query_each_batch_w_pair
     }
 };
 
@@ -5866,6 +5921,10 @@ bake_test_case QueryBuilder_testcases[] = {
     {
         "pred_match",
         QueryBuilder_pred_match
+    },
+    {
+        "plan_by_cost",
+        QueryBuilder_plan_by_cost
     }
 };
 
@@ -6284,6 +6343,18 @@ bake_test_case Observer_testcases[] = {
     {
         "reuse_observer_builder",
         Observer_reuse_observer_builder
+    },
+    {
+        "coalesce",
+        Observer_coalesce
+    },
+    {
+        "coalesce_phase",
+        Observer_coalesce_phase
+    },
+    {
+        "coalesce_multi_threaded",
+        Observer_coalesce_multi_threaded
     }
 };
 
@@ -7622,6 +7693,18 @@ bake_test_case World_testcases[] = {
     {
         "get_type_info_R_T_tag",
         World_get_type_info_R_T_tag
+    },
+    {
+        "get_many",
+        World_get_many
+    },
+    {
+        "get_many_array",
+        World_get_many_array
+    },
+    {
+        "get_many_id",
+        World_get_many_id
     }
 };
 
@@ -8124,6 +8207,10 @@ bake_test_case Meta_testcases[] = {
     {
         "ecs_struct_macro_no_reflection_for_plain_struct",
         Meta_ecs_struct_macro_no_reflection_for_plain_struct
+    },
+    {
+        "soa_struct",
+        Meta_soa_struct
     }
 };
 
@@ -8287,6 +8374,14 @@ bake_test_case Table_testcases[] = {
     {
         "clear_entities",
         Table_clear_entities
+    },
+    {
+        "column_alignment",
+        Table_column_alignment
+    },
+    {
+        "column_alignment_w_lifecycle",
+        Table_column_alignment_w_lifecycle
     }
 };
 
@@ -8508,7 +8603,7 @@ static bake_test_suite suites[] = {
         "System",
         NULL,
         NULL,
-        79,
+        82,
         System_testcases
     },
     {
@@ -8522,21 +8617,21 @@ static bake_test_suite suites[] = {
         "Iterable",
         NULL,
         NULL,
-        4,
+        5,
         Iterable_testcases
     },
     {
         "Query",
         NULL,
         NULL,
-        165,
+        170,
         Query_testcases
     },
     {
         "QueryBuilder",
         QueryBuilder_setup,
         NULL,
-        189,
+        190,
         QueryBuilder_testcases,
         1,
         QueryBuilder_params
@@ -8552,7 +8647,7 @@ static bake_test_suite suites[] = {
         "Observer",
         NULL,
         NULL,
-        73,
+        76,
         Observer_testcases
     },
     {
@@ -8594,7 +8689,7 @@ static bake_test_suite suites[] = {
         "World",
         NULL,
         NULL,
-        128,
+        131,
         World_testcases
     },
     {
@@ -8608,14 +8703,14 @@ static bake_test_suite suites[] = {
         "Meta",
         NULL,
         NULL,
-        75,
+        76,
         Meta_testcases
     },
     {
         "Table",
         NULL,
         NULL,
-        40,
+        42,
         Table_testcases
     },
     {
@@ -1589,6 +1589,42 @@ void DeserializeFromJson_deser_entity_1_component_1_member(void) {
     ecs_fini(world);
 }
 
+void DeserializeFromJson_deser_entity_soa_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t ecs_id(Position) = ecs_struct_init(world, &(ecs_struct_desc_t){
+        .entity = ecs_entity(world, {.name = "Position"}),
+        .members = {
+            {"x", ecs_id(ecs_i32_t)},
+            {"y", ecs_id(ecs_i32_t)}
+        }
+    });
+
+    ecs_add_id(world, ecs_id(Position), EcsSoA);
+
+    ecs_entity_t x = ecs_lookup(world, "Position.x");
+    ecs_entity_t y = ecs_lookup(world, "Position.y");
+    test_assert(x != 0);
+    test_assert(y != 0);
+
+    ecs_entity_t e = ecs_new(world);
+    const char *ptr = ecs_entity_from_json(world, e, 
+        "{\"tags\": [\"Position\"], "
+        "\"components\": {\"Position.x\": 10, \"Position.y\": 20}}", NULL);
+    test_assert(ptr != NULL);
+    test_assert(ptr[0] == '\0');
+
+    test_assert(ecs_has(world, e, Position));
+    const ecs_i32_t *px = ecs_get_id(world, e, x);
+    test_assert(px != NULL);
+    test_int(*px, 10);
+    const ecs_i32_t *py = ecs_get_id(world, e, y);
+    test_assert(py != NULL);
+    test_int(*py, 20);
+
+    ecs_fini(world);
+}
+
 void DeserializeFromJson_deser_entity_1_component_1_member_w_spaces(void) {
     ecs_world_t *world = ecs_init();
 
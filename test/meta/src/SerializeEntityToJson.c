@@ -628,6 +628,41 @@ void SerializeEntityToJson_serialize_w_2_components(void) {
     ecs_fini(world);
 }
 
+void SerializeEntityToJson_serialize_w_soa_component(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t ecs_id(Position) = ecs_struct(world, {
+        .entity = ecs_entity(world, {.name = "Position"}),
+        .members = {
+            {"x", ecs_id(ecs_i32_t)},
+            {"y", ecs_id(ecs_i32_t)}
+        }
+    });
+
+    ecs_add_id(world, ecs_id(Position), EcsSoA);
+
+    ecs_entity_t x = ecs_lookup(world, "Position.x");
+    ecs_entity_t y = ecs_lookup(world, "Position.y");
+    test_assert(x != 0);
+    test_assert(y != 0);
+
+    ecs_entity_t e = ecs_entity(world, { .name = "Foo" });
+    ecs_add(world, e, Position);
+    *(ecs_i32_t*)ecs_ensure_id(world, e, x, sizeof(ecs_i32_t)) = 10;
+    *(ecs_i32_t*)ecs_ensure_id(world, e, y, sizeof(ecs_i32_t)) = 20;
+
+    ecs_entity_to_json_desc_t desc = ECS_ENTITY_TO_JSON_INIT;
+    desc.serialize_values = true;
+
+    char *json = ecs_entity_to_json(world, e, &desc);
+    test_assert(json != NULL);
+    test_json(json, "{\"name\":\"Foo\", \"tags\":[\"Position\"], \"components\":{\"Position.x\":10, \"Position.y\":20}}");
+
+    ecs_os_free(json);
+
+    ecs_fini(world);
+}
+
 void SerializeEntityToJson_serialize_w_primitive_component(void) {
     ecs_world_t *world = ecs_init();
 
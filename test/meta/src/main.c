@@ -682,6 +682,7 @@ void DeserializeFromJson_ser_deser_entity_named(void);
 void DeserializeFromJson_ser_deser_entity_named_child(void);
 void DeserializeFromJson_ser_deser_entity_namespaced_component(void);
 void DeserializeFromJson_deser_entity_1_component_1_member(void);
+void DeserializeFromJson_deser_entity_soa_component(void);
 void DeserializeFromJson_deser_entity_1_component_1_member_w_spaces(void);
 void DeserializeFromJson_deser_entity_1_component_2_members(void);
 void DeserializeFromJson_deser_entity_2_components(void);
@@ -954,6 +955,7 @@ void SerializeEntityToJson_serialize_component_tag_pair_w_manual_override(void);
 void SerializeEntityToJson_serialize_w_nested_base(void);
 void SerializeEntityToJson_serialize_w_1_component(void);
 void SerializeEntityToJson_serialize_w_2_components(void);
+void SerializeEntityToJson_serialize_w_soa_component(void);
 void SerializeEntityToJson_serialize_w_primitive_component(void);
 void SerializeEntityToJson_serialize_w_enum_component(void);
 void SerializeEntityToJson_serialize_w_struct_and_enum_component(void);
@@ -4070,6 +4072,10 @@ bake_test_case DeserializeFromJson_testcases[] = {
         "deser_entity_1_component_1_member",
         DeserializeFromJson_deser_entity_1_component_1_member
     },
+    {
+        "deser_entity_soa_component",
+        DeserializeFromJson_deser_entity_soa_component
+    },
     {
         "deser_entity_1_component_1_member_w_spaces",
         DeserializeFromJson_deser_entity_1_component_1_member_w_spaces
@@ -5148,6 +5154,10 @@ bake_test_case SerializeEntityToJson_testcases[] = {
         "serialize_w_2_components",
         SerializeEntityToJson_serialize_w_2_components
     },
+    {
+        "serialize_w_soa_component",
+        SerializeEntityToJson_serialize_w_soa_component
+    },
     {
         "serialize_w_primitive_component",
         SerializeEntityToJson_serialize_w_primitive_component
@@ -7117,7 +7127,7 @@ static bake_test_suite suites[] = {
         "DeserializeFromJson",
         NULL,
         NULL,
-        201,
+        202,
         DeserializeFromJson_testcases
     },
     {
@@ -7131,7 +7141,7 @@ static bake_test_suite suites[] = {
         "SerializeEntityToJson",
         NULL,
         NULL,
-        100,
+        101,
         SerializeEntityToJson_testcases
     },
     {
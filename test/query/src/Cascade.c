@@ -2042,3 +2042,252 @@ void Cascade_cascade_in_or_chain(void) {
 
     ecs_fini(world);
 }
+
+static
+void Propagate(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 0);
+    const Velocity *v = ecs_field(it, Velocity, 1);
+    const Position *parent = ecs_field(it, Position, 2);
+    int32_t *count = it->ctx;
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x = v[i].x;
+        p[i].y = v[i].y;
+        if (parent) {
+            p[i].x += parent->x;
+            p[i].y += parent->y;
+        }
+    }
+
+    *count += it->count;
+}
+
+void Cascade_propagate_3_levels(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[out] Position(self), [in] Velocity(self), "
+                "[in] ?Position(cascade ChildOf)",
+        .cache_kind = EcsQueryCacheAuto
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e0 = ecs_insert(world, 
+        ecs_value(Position, {0, 0}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e1 = ecs_new_w_pair(world, EcsChildOf, e0);
+    ecs_set(world, e1, Position, {0, 0});
+    ecs_set(world, e1, Velocity, {2, 4});
+    ecs_entity_t e2 = ecs_new_w_pair(world, EcsChildOf, e1);
+    ecs_set(world, e2, Position, {0, 0});
+    ecs_set(world, e2, Velocity, {3, 6});
+
+    int32_t count = 0;
+    test_int(0, ecs_query_propagate(world, q, &(ecs_query_propagate_desc_t){
+        .callback = Propagate,
+        .ctx = &count
+    }));
+    test_int(count, 3);
+
+    {
+        const Position *p = ecs_get(world, e0, Position);
+        test_int(p->x, 1); test_int(p->y, 2);
+    }
+    {
+        const Position *p = ecs_get(world, e1, Position);
+        test_int(p->x, 3); test_int(p->y, 6);
+    }
+    {
+        const Position *p = ecs_get(world, e2, Position);
+        test_int(p->x, 6); test_int(p->y, 12);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Cascade_propagate_w_change_detection(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[out] Position(self), [in] Velocity(self), "
+                "[in] ?Position(cascade ChildOf)",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectChanges
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e0 = ecs_insert(world, 
+        ecs_value(Position, {0, 0}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e1 = ecs_new_w_pair(world, EcsChildOf, e0);
+    ecs_set(world, e1, Position, {0, 0});
+    ecs_set(world, e1, Velocity, {2, 4});
+    ecs_entity_t e2 = ecs_new_w_pair(world, EcsChildOf, e1);
+    ecs_set(world, e2, Position, {0, 0});
+    ecs_set(world, e2, Velocity, {3, 6});
+
+    ecs_query_propagate_desc_t desc = { .callback = Propagate };
+    int32_t count = 0;
+    desc.ctx = &count;
+
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 3);
+
+    count = 0;
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 0);
+
+    ecs_set(world, e1, Velocity, {4, 8});
+
+    count = 0;
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 2);
+
+    {
+        const Position *p = ecs_get(world, e0, Position);
+        test_int(p->x, 1); test_int(p->y, 2);
+    }
+    {
+        const Position *p = ecs_get(world, e1, Position);
+        test_int(p->x, 5); test_int(p->y, 10);
+    }
+    {
+        const Position *p = ecs_get(world, e2, Position);
+        test_int(p->x, 8); test_int(p->y, 16);
+    }
+
+    count = 0;
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 0);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Cascade_propagate_non_fragmenting(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[out] Position(self), [in] Velocity(self), "
+                "[in] ?Position(cascade ChildOf)",
+        .cache_kind = EcsQueryCacheAuto
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e0 = ecs_insert(world, 
+        ecs_value(Position, {0, 0}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {0, 0}), 
+        ecs_value(Velocity, {2, 4}), ecs_value(EcsParent, {e0}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {0, 0}), 
+        ecs_value(Velocity, {3, 6}), ecs_value(EcsParent, {e1}));
+
+    int32_t count = 0;
+    test_int(0, ecs_query_propagate(world, q, &(ecs_query_propagate_desc_t){
+        .callback = Propagate,
+        .ctx = &count
+    }));
+    test_int(count, 3);
+
+    {
+        const Position *p = ecs_get(world, e0, Position);
+        test_int(p->x, 1); test_int(p->y, 2);
+    }
+    {
+        const Position *p = ecs_get(world, e1, Position);
+        test_int(p->x, 3); test_int(p->y, 6);
+    }
+    {
+        const Position *p = ecs_get(world, e2, Position);
+        test_int(p->x, 6); test_int(p->y, 12);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Cascade_propagate_non_fragmenting_w_change_detection(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "[out] Position(self), [in] Velocity(self), "
+                "[in] ?Position(cascade ChildOf)",
+        .cache_kind = EcsQueryCacheAuto,
+        .flags = EcsQueryDetectChanges
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e0 = ecs_insert(world, 
+        ecs_value(Position, {0, 0}), ecs_value(Velocity, {1, 2}));
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {0, 0}), 
+        ecs_value(Velocity, {2, 4}), ecs_value(EcsParent, {e0}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {0, 0}), 
+        ecs_value(Velocity, {3, 6}), ecs_value(EcsParent, {e1}));
+
+    ecs_query_propagate_desc_t desc = { .callback = Propagate };
+    int32_t count = 0;
+    desc.ctx = &count;
+
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 3);
+
+    count = 0;
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 0);
+
+    ecs_set(world, e0, Velocity, {2, 3});
+
+    count = 0;
+    test_int(0, ecs_query_propagate(world, q, &desc));
+    test_int(count, 3);
+
+    {
+        const Position *p = ecs_get(world, e0, Position);
+        test_int(p->x, 2); test_int(p->y, 3);
+    }
+    {
+        const Position *p = ecs_get(world, e1, Position);
+        test_int(p->x, 4); test_int(p->y, 7);
+    }
+    {
+        const Position *p = ecs_get(world, e2, Position);
+        test_int(p->x, 7); test_int(p->y, 13);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Cascade_propagate_no_cascade(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = EcsQueryCacheAuto
+    });
+    test_assert(q != NULL);
+
+    test_expect_abort();
+    ecs_query_propagate(world, q, &(ecs_query_propagate_desc_t){
+        .callback = Propagate
+    });
+}
@@ -7304,3 +7304,126 @@ void DontFragment_trivial_sparse_desc_terms(void) {
 
     ecs_fini(world);
 }
+
+void DontFragment_trivial_sparse_worker_iter_split(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ecs_add_id(world, ecs_id(Position), EcsDontFragment);
+    ecs_add_id(world, ecs_id(Velocity), EcsDontFragment);
+
+    int32_t i, count = 3000;
+    ecs_entity_t *entities = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = entities[i] = ecs_new(world);
+        ecs_set(world, e, Position, {i, 0});
+        if (i % 3) {
+            ecs_set(world, e, Velocity, {1, 2});
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, Velocity",
+        .cache_kind = cache_kind
+    });
+    test_assert(q != NULL);
+
+    int32_t *matched = ecs_os_calloc_n(int32_t, count);
+    int32_t w, workers = 3;
+    for (w = 0; w < workers; w ++) {
+        int32_t worker_matched = 0;
+        ecs_iter_t it = ecs_query_iter(world, q);
+        ecs_iter_t wit = ecs_worker_iter(&it, w, workers);
+        while (ecs_worker_next(&wit)) {
+            test_assert(wit.count > 1);
+            for (i = 0; i < wit.count; i ++) {
+                Position *p = ecs_field_at(&wit, Position, 0, i);
+                test_assert(p != NULL);
+                test_assert(wit.entities[i] == entities[(int32_t)p->x]);
+                test_assert(p->x >= (w * count / workers));
+                test_assert(p->x < ((w + 1) * count / workers));
+                matched[(int32_t)p->x] ++;
+                worker_matched ++;
+            }
+        }
+
+        /* Each worker only iterates its own part of the sparse set */
+        test_assert(worker_matched < count);
+    }
+
+    for (i = 0; i < count; i ++) {
+        test_int(matched[i], (i % 3) != 0);
+    }
+
+    ecs_os_free(matched);
+    ecs_os_free(entities);
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void DontFragment_trivial_sparse_dynamic_worker_iter(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ecs_add_id(world, ecs_id(Position), EcsDontFragment);
+    ecs_add_id(world, ecs_id(Velocity), EcsDontFragment);
+
+    int32_t i, count = 3000;
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, Position, {i, 0});
+        if (i % 3) {
+            ecs_set(world, e, Velocity, {1, 2});
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, Velocity",
+        .cache_kind = cache_kind
+    });
+    test_assert(q != NULL);
+
+    int32_t *matched = ecs_os_calloc_n(int32_t, count);
+    int32_t w, workers = 3, cursor = 0;
+    ecs_iter_t it[3], wit[3];
+    for (w = 0; w < workers; w ++) {
+        it[w] = ecs_query_iter(world, q);
+        wit[w] = ecs_dynamic_worker_iter(&it[w], &cursor, 100);
+    }
+
+    /* Interleave workers, as if they run concurrently */
+    bool done[3] = {false};
+    int32_t done_count = 0;
+    while (done_count != workers) {
+        for (w = 0; w < workers; w ++) {
+            if (done[w]) {
+                continue;
+            }
+
+            if (!ecs_dynamic_worker_next(&wit[w])) {
+                done[w] = true;
+                done_count ++;
+                continue;
+            }
+
+            test_assert(wit[w].count <= 100);
+            for (i = 0; i < wit[w].count; i ++) {
+                Position *p = ecs_field_at(&wit[w], Position, 0, i);
+                test_assert(p != NULL);
+                matched[(int32_t)p->x] ++;
+            }
+        }
+    }
+
+    for (i = 0; i < count; i ++) {
+        test_int(matched[i], (i % 3) != 0);
+    }
+
+    ecs_os_free(matched);
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
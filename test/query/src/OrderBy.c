@@ -2419,3 +2419,154 @@ void OrderBy_sort_w_scope_term(void) {
 
     ecs_fini(world);
 }
+
+static
+int32_t test_sorted_positions(
+    ecs_world_t *world,
+    ecs_query_t *q)
+{
+    int32_t count = 0;
+    float prev = 0;
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        Position *p = ecs_field(&it, Position, 0);
+        for (int i = 0; i < it.count; i ++) {
+            if (count) {
+                test_assert(prev <= p[i].x);
+            }
+            prev = p[i].x;
+            count ++;
+        }
+    }
+
+    return count;
+}
+
+void OrderBy_sort_after_set_few_rows(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .order_by = ecs_id(Position),
+        .order_by_callback = compare_position
+    });
+
+    test_int(test_sorted_positions(world, q), 100);
+
+    ecs_set(world, entities[10], Position, {50.5, 0});
+    ecs_set(world, entities[90], Position, {-1, 0});
+
+    test_int(test_sorted_positions(world, q), 100);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_assert(ecs_query_next(&it));
+    test_assert(it.entities[0] == entities[90]);
+    test_assert(it.entities[51] == entities[10]);
+    ecs_iter_fini(&it);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void OrderBy_sort_after_set_all_rows(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t entities[100];
+    for (int i = 0; i < 100; i ++) {
+        entities[i] = ecs_insert(world, ecs_value(Position, {(float)i, 0}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .order_by = ecs_id(Position),
+        .order_by_callback = compare_position
+    });
+
+    test_int(test_sorted_positions(world, q), 100);
+
+    for (int i = 0; i < 100; i ++) {
+        ecs_set(world, entities[i], Position, {(float)(100 - i), 0});
+    }
+
+    test_int(test_sorted_positions(world, q), 100);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_assert(ecs_query_next(&it));
+    test_assert(it.entities[0] == entities[99]);
+    test_assert(it.entities[99] == entities[0]);
+    ecs_iter_fini(&it);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void OrderBy_sort_after_add_to_sorted_table(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    for (int i = 0; i < 100; i ++) {
+        ecs_insert(world, ecs_value(Position, {(float)i + 1, 0}));
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .order_by = ecs_id(Position),
+        .order_by_callback = compare_position
+    });
+
+    test_int(test_sorted_positions(world, q), 100);
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {0, 0}));
+
+    test_int(test_sorted_positions(world, q), 101);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_assert(ecs_query_next(&it));
+    test_assert(it.entities[0] == e);
+    ecs_iter_fini(&it);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void OrderBy_sort_many_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t tags[10];
+    for (int t = 0; t < 10; t ++) {
+        tags[t] = ecs_new(world);
+    }
+
+    for (int i = 0; i < 200; i ++) {
+        ecs_entity_t e = ecs_new_w_id(world, tags[(i * 7) % 10]);
+        ecs_set(world, e, Position, {(float)((i * 37) % 101), 0});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .order_by = ecs_id(Position),
+        .order_by_callback = compare_position
+    });
+
+    test_int(test_sorted_positions(world, q), 200);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
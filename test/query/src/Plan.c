@@ -3795,3 +3795,212 @@ void Plan_self_up_w_custom_rel_cached(void) {
 
     ecs_fini(world);
 }
+
+static
+void populate_plan_by_cost(
+    ecs_world_t *world,
+    ecs_entity_t ecs_id(Position),
+    ecs_entity_t ecs_id(Velocity),
+    ecs_entity_t Rare,
+    ecs_entity_t Likes)
+{
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, Position, {i, 0});
+        ecs_set(world, e, Velocity, {1, 1});
+        ecs_add_id(world, e, ecs_new(world));
+    }
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_add_pair(world, e, Likes, e);
+    ecs_add_id(world, e, Rare);
+    ecs_set(world, e, Position, {10, 0});
+    ecs_set(world, e, Velocity, {1, 1});
+}
+
+void Plan_plan_by_cost(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Rare);
+    ECS_TAG(world, Likes);
+
+    populate_plan_by_cost(world, ecs_id(Position), ecs_id(Velocity), Rare, Likes);
+
+    /* MatchPrefab disables the instruction that evaluates trivial terms */
+    ecs_query_t *r = ecs_query(world, {
+        .expr = "Position, Velocity, (Likes, $x), Rare",
+        .flags = EcsQueryPlanByCost|EcsQueryMatchPrefab
+    });
+
+    test_assert(r != NULL);
+
+    ecs_log_enable_colors(false);
+
+    const char *expect = 
+    HEAD " 0. [-1,  1]  setids       "
+    LINE " 1. [ 0,  2]  and          $[this]          (Rare)"
+    LINE " 2. [ 1,  3]  and          $[this]          (Velocity)"
+    LINE " 3. [ 2,  4]  and          $[this]          (Position)"
+    LINE " 4. [ 3,  5]  and          $[this]          (Likes, $x)"
+    LINE " 5. [ 4,  6]  yield        "
+    LINE "planned by cost (estimated tables):"
+    LINE "  Rare (3)"
+    LINE "  Velocity (12)"
+    LINE "  Position (14)"
+    LINE "";
+    char *plan = ecs_query_plan(r);
+
+    test_str(expect, plan);
+    ecs_os_free(plan);
+
+    ecs_iter_t it = ecs_query_iter(world, r);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_assert(ecs_has_id(world, it.entities[0], Rare));
+    test_uint(ecs_pair(Likes, it.entities[0]), ecs_field_id(&it, 2));
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(r);
+
+    ecs_fini(world);
+}
+
+void Plan_plan_by_cost_trivial(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Rare);
+    ECS_TAG(world, Likes);
+
+    populate_plan_by_cost(world, ecs_id(Position), ecs_id(Velocity), Rare, Likes);
+
+    ecs_query_t *r = ecs_query(world, {
+        .expr = "Position, Velocity, (Likes, $x), Rare",
+        .flags = EcsQueryPlanByCost
+    });
+
+    test_assert(r != NULL);
+
+    ecs_log_enable_colors(false);
+
+    const char *expect = 
+    HEAD " 0. [-1,  1]  setids       "
+    LINE " 1. [ 0,  2]  triv         {0,1,3}"
+    LINE " 2. [ 1,  3]  and          $[this]          (Likes, $x)"
+    LINE " 3. [ 2,  4]  yield        "
+    LINE "planned by cost (estimated tables):"
+    LINE "  Rare (3)"
+    LINE "  Velocity (12)"
+    LINE "  Position (14)"
+    LINE "";
+    char *plan = ecs_query_plan(r);
+
+    test_str(expect, plan);
+    ecs_os_free(plan);
+
+    ecs_iter_t it = ecs_query_iter(world, r);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_assert(ecs_has_id(world, it.entities[0], Rare));
+    Position *p = ecs_field(&it, Position, 0);
+    Velocity *v = ecs_field(&it, Velocity, 1);
+    test_int(p->x, 10);
+    test_int(v->x, 1);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(r);
+
+    ecs_fini(world);
+}
+
+void Plan_plan_by_cost_w_optional(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Rare);
+    ECS_TAG(world, Likes);
+
+    populate_plan_by_cost(world, ecs_id(Position), ecs_id(Velocity), Rare, Likes);
+
+    /* Terms are not reordered across optional terms */
+    ecs_query_t *r = ecs_query(world, {
+        .expr = "Position, Velocity, ?Likes, Rare",
+        .flags = EcsQueryPlanByCost|EcsQueryMatchPrefab
+    });
+
+    test_assert(r != NULL);
+
+    ecs_log_enable_colors(false);
+
+    const char *expect = 
+    HEAD " 0. [-1,  1]  setids       "
+    LINE " 1. [ 0,  2]  and          $[this]          (Velocity)"
+    LINE " 2. [ 1,  3]  and          $[this]          (Position)"
+    LINE " 3. [ 2,  5]  option       "
+    LINE " 4. [ 3,  5]   and          $[this]         (Likes)"
+    LINE " 5. [ 3,  6]  end          $[this]          (Likes)"
+    LINE " 6. [ 5,  7]  and          $[this]          (Rare)"
+    LINE " 7. [ 6,  8]  yield        "
+    LINE "planned by cost (estimated tables):"
+    LINE "  Rare (3)"
+    LINE "  Velocity (12)"
+    LINE "  Position (14)"
+    LINE "";
+    char *plan = ecs_query_plan(r);
+
+    test_str(expect, plan);
+    ecs_os_free(plan);
+
+    ecs_query_fini(r);
+
+    ecs_fini(world);
+}
+
+void Plan_plan_by_cost_trivial_after_change(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t e1 = ecs_new_w(world, Foo);
+    ecs_set(world, e1, Position, {1, 0});
+
+    ecs_query_t *r = ecs_query(world, {
+        .expr = "Position, Foo",
+        .flags = EcsQueryPlanByCost
+    });
+
+    test_assert(r != NULL);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        ecs_entity_t e = ecs_new(world);
+        ecs_set(world, e, Position, {0, 0});
+        ecs_add_id(world, e, ecs_new(world));
+    }
+
+    /* Term that matches the fewest tables changes after query creation */
+    for (i = 0; i < 20; i ++) {
+        ecs_entity_t e = ecs_new_w(world, Foo);
+        ecs_add_id(world, e, ecs_new(world));
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, r);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e1, it.entities[0]);
+    Position *p = ecs_field(&it, Position, 0);
+    test_int(p->x, 1);
+    test_uint(ecs_id(Position), ecs_field_id(&it, 0));
+    test_uint(Foo, ecs_field_id(&it, 1));
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(r);
+
+    ecs_fini(world);
+}
@@ -0,0 +1,496 @@
+#include <query.h>
+
+typedef struct {
+    float x;
+    float y;
+    double mass;
+} Particle;
+
+typedef struct {
+    ecs_entity_t value;
+} Movement;
+
+typedef struct {
+    char *value;
+} Label;
+
+static ECS_COMPONENT_DECLARE(Particle);
+
+static void register_particle(
+    ecs_world_t *world)
+{
+    ECS_COMPONENT_DEFINE(world, Particle);
+
+    ecs_struct(world, {
+        .entity = ecs_id(Particle),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) },
+            { "mass", ecs_id(ecs_f64_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(Particle), EcsSoA);
+}
+
+void SoA_soa_members_are_components(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    ecs_entity_t x = ecs_lookup(world, "Particle.x");
+    ecs_entity_t y = ecs_lookup(world, "Particle.y");
+    ecs_entity_t mass = ecs_lookup(world, "Particle.mass");
+    test_assert(x != 0);
+    test_assert(y != 0);
+    test_assert(mass != 0);
+
+    const EcsComponent *c = ecs_get(world, x, EcsComponent);
+    test_assert(c != NULL);
+    test_int(c->size, ECS_SIZEOF(ecs_f32_t));
+    test_int(c->alignment, ECS_ALIGNOF(ecs_f32_t));
+
+    c = ecs_get(world, mass, EcsComponent);
+    test_assert(c != NULL);
+    test_int(c->size, ECS_SIZEOF(ecs_f64_t));
+    test_int(c->alignment, ECS_ALIGNOF(ecs_f64_t));
+
+    test_assert(ecs_has_pair(world, ecs_id(Particle), EcsWith, x));
+    test_assert(ecs_has_pair(world, ecs_id(Particle), EcsWith, y));
+    test_assert(ecs_has_pair(world, ecs_id(Particle), EcsWith, mass));
+
+    /* Struct keeps its reflection data */
+    const EcsComponent *pc = ecs_get(world, ecs_id(Particle), EcsComponent);
+    test_assert(pc != NULL);
+    test_int(pc->size, ECS_SIZEOF(Particle));
+    test_assert(ecs_get_type_info(world, ecs_id(Particle)) != NULL);
+
+    ecs_fini(world);
+}
+
+void SoA_add_soa_component(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    ecs_entity_t x = ecs_lookup(world, "Particle.x");
+    ecs_entity_t y = ecs_lookup(world, "Particle.y");
+    ecs_entity_t mass = ecs_lookup(world, "Particle.mass");
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_add(world, e, Particle);
+    test_assert(ecs_has(world, e, Particle));
+    test_assert(ecs_has_id(world, e, x));
+    test_assert(ecs_has_id(world, e, y));
+    test_assert(ecs_has_id(world, e, mass));
+
+    /* Particle doesn't have a column, members do */
+    ecs_table_t *table = ecs_get_table(world, e);
+    test_int(ecs_table_column_count(table), 3);
+    test_assert(ecs_get(world, e, Particle) == NULL);
+
+    ecs_f32_t vx = 10;
+    ecs_f64_t vmass = 30;
+    ecs_set_id(world, e, x, sizeof(ecs_f32_t), &vx);
+    ecs_set_id(world, e, mass, sizeof(ecs_f64_t), &vmass);
+
+    const ecs_f32_t *px = ecs_get_id(world, e, x);
+    test_assert(px != NULL);
+    test_flt(*px, 10);
+    const ecs_f64_t *pmass = ecs_get_id(world, e, mass);
+    test_assert(pmass != NULL);
+    test_flt(*pmass, 30);
+
+    ecs_fini(world);
+}
+
+void SoA_remove_soa_component(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+    ECS_TAG(world, Foo);
+
+    register_particle(world);
+
+    ecs_entity_t x = ecs_lookup(world, "Particle.x");
+    ecs_entity_t y = ecs_lookup(world, "Particle.y");
+    ecs_entity_t mass = ecs_lookup(world, "Particle.mass");
+
+    ecs_entity_t e = ecs_new_w(world, Foo);
+    ecs_add(world, e, Particle);
+    test_assert(ecs_has_id(world, e, x));
+
+    ecs_remove(world, e, Particle);
+    test_assert(!ecs_has(world, e, Particle));
+    test_assert(!ecs_has_id(world, e, x));
+    test_assert(!ecs_has_id(world, e, y));
+    test_assert(!ecs_has_id(world, e, mass));
+    test_assert(ecs_has(world, e, Foo));
+
+    ecs_fini(world);
+}
+
+void SoA_remove_soa_component_w_with(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+    ECS_TAG(world, Foo);
+
+    register_particle(world);
+    ecs_add_pair(world, ecs_id(Particle), EcsWith, Foo);
+
+    ecs_entity_t x = ecs_lookup(world, "Particle.x");
+
+    ecs_entity_t e = ecs_new(world);
+    ecs_add(world, e, Particle);
+    test_assert(ecs_has_id(world, e, x));
+    test_assert(ecs_has(world, e, Foo));
+
+    /* Only member columns are removed with the SoA component */
+    ecs_remove(world, e, Particle);
+    test_assert(!ecs_has(world, e, Particle));
+    test_assert(!ecs_has_id(world, e, x));
+    test_assert(ecs_has(world, e, Foo));
+
+    ecs_fini(world);
+}
+
+void SoA_query_member_field(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    ecs_entity_t x = ecs_lookup(world, "Particle.x");
+    ecs_entity_t mass = ecs_lookup(world, "Particle.mass");
+
+    ecs_entity_t e[3];
+    int i;
+    for (i = 0; i < 3; i ++) {
+        e[i] = ecs_new_w(world, Particle);
+        ecs_f32_t vx = (ecs_f32_t)(i + 1);
+        ecs_f64_t vmass = (ecs_f64_t)(i + 10);
+        ecs_set_id(world, e[i], x, sizeof(ecs_f32_t), &vx);
+        ecs_set_id(world, e[i], mass, sizeof(ecs_f64_t), &vmass);
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Particle.x, Particle.mass"
+    });
+    test_assert(q != NULL);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 3);
+    test_uint(ecs_field_id(&it, 0), x);
+    test_uint(ecs_field_id(&it, 1), mass);
+    test_int(ecs_field_size(&it, 0), ECS_SIZEOF(ecs_f32_t));
+    test_int(ecs_field_size(&it, 1), ECS_SIZEOF(ecs_f64_t));
+
+    ecs_f32_t *fx = ecs_field_w_size(&it, sizeof(ecs_f32_t), 0);
+    ecs_f64_t *fmass = ecs_field_w_size(&it, sizeof(ecs_f64_t), 1);
+    test_assert(fx != NULL);
+    test_assert(fmass != NULL);
+    for (i = 0; i < 3; i ++) {
+        test_uint(it.entities[i], e[i]);
+        test_flt(fx[i], i + 1);
+        test_flt(fmass[i], i + 10);
+    }
+
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void SoA_query_member_and_soa_component(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+    ECS_TAG(world, Foo);
+
+    register_particle(world);
+
+    ecs_entity_t y = ecs_lookup(world, "Particle.y");
+
+    ecs_entity_t e1 = ecs_new_w(world, Particle);
+    ecs_entity_t e2 = ecs_new_w(world, Particle);
+    ecs_add(world, e2, Foo);
+    ecs_entity_t e3 = ecs_new_w(world, Foo);
+    ecs_add_id(world, e3, y);
+
+    ecs_f32_t v1 = 1, v2 = 2, v3 = 3;
+    ecs_set_id(world, e1, y, sizeof(ecs_f32_t), &v1);
+    ecs_set_id(world, e2, y, sizeof(ecs_f32_t), &v2);
+    ecs_set_id(world, e3, y, sizeof(ecs_f32_t), &v3);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Particle, Particle.y"
+    });
+    test_assert(q != NULL);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    int32_t count = 0;
+    ecs_f32_t sum = 0;
+    while (ecs_query_next(&it)) {
+        test_int(ecs_field_size(&it, 0), 0);
+        ecs_f32_t *fy = ecs_field_w_size(&it, sizeof(ecs_f32_t), 1);
+        test_assert(fy != NULL);
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            test_assert(it.entities[i] != e3);
+            sum += fy[i];
+        }
+        count += it.count;
+    }
+
+    test_int(count, 2);
+    test_flt(sum, 3);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void SoA_member_entities_created(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    const EcsStruct *s = ecs_get(world, ecs_id(Particle), EcsStruct);
+    test_assert(s != NULL);
+    test_int(ecs_vec_count(&s->members), 3);
+
+    ecs_member_t *members = ecs_vec_first(&s->members);
+    test_assert(members[0].member != 0);
+    test_assert(members[1].member != 0);
+    test_assert(members[2].member != 0);
+    test_uint(members[0].member, ecs_lookup(world, "Particle.x"));
+    test_uint(members[1].member, ecs_lookup(world, "Particle.y"));
+    test_uint(members[2].member, ecs_lookup(world, "Particle.mass"));
+
+    /* Struct layout is not changed by creating member entities */
+    test_int(members[0].offset, 0);
+    test_int(members[1].offset, 4);
+    test_int(members[2].offset, 8);
+
+    const EcsType *t = ecs_get(world, ecs_id(Particle), EcsType);
+    test_assert(t != NULL);
+    test_bool(t->partial, false);
+
+    const EcsMember *m = ecs_get(world, members[1].member, EcsMember);
+    test_assert(m != NULL);
+    test_uint(m->type, ecs_id(ecs_f32_t));
+    test_int(m->offset, 4);
+
+    ecs_fini(world);
+}
+
+void SoA_soa_before_members(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    ECS_COMPONENT(world, Particle);
+
+    ecs_add_id(world, ecs_id(Particle), EcsSoA);
+
+    ecs_struct(world, {
+        .entity = ecs_id(Particle),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) },
+            { "mass", ecs_id(ecs_f64_t) }
+        }
+    });
+
+    ecs_entity_t x = ecs_lookup(world, "Particle.x");
+    ecs_entity_t y = ecs_lookup(world, "Particle.y");
+    ecs_entity_t mass = ecs_lookup(world, "Particle.mass");
+    test_assert(x != 0);
+    test_assert(y != 0);
+    test_assert(mass != 0);
+    test_assert(ecs_has(world, x, EcsComponent));
+    test_assert(ecs_has(world, y, EcsComponent));
+    test_assert(ecs_has(world, mass, EcsComponent));
+
+    ecs_entity_t e = ecs_new_w(world, Particle);
+    test_assert(ecs_has_id(world, e, x));
+    test_assert(ecs_has_id(world, e, y));
+    test_assert(ecs_has_id(world, e, mass));
+
+    const EcsType *t = ecs_get(world, ecs_id(Particle), EcsType);
+    test_assert(t != NULL);
+    test_bool(t->partial, false);
+
+    ecs_fini(world);
+}
+
+void SoA_member_w_string(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    ECS_COMPONENT(world, Label);
+
+    ecs_struct(world, {
+        .entity = ecs_id(Label),
+        .members = {
+            { "value", ecs_id(ecs_string_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(Label), EcsSoA);
+
+    ecs_entity_t value = ecs_lookup(world, "Label.value");
+    test_assert(value != 0);
+
+    const ecs_type_info_t *ti = ecs_get_type_info(world, value);
+    test_assert(ti != NULL);
+    test_assert(ti->hooks.copy != NULL);
+    test_assert(ti->hooks.dtor != NULL);
+
+    ecs_entity_t e = ecs_new_w(world, Label);
+    ecs_string_t str = "Hello";
+    ecs_set_id(world, e, value, sizeof(ecs_string_t), &str);
+
+    const ecs_string_t *ptr = ecs_get_id(world, e, value);
+    test_assert(ptr != NULL);
+    test_str(*ptr, "Hello");
+    test_assert(*ptr != str);
+
+    ecs_entity_t e2 = ecs_clone(world, 0, e, true);
+    ptr = ecs_get_id(world, e2, value);
+    test_assert(ptr != NULL);
+    test_str(*ptr, "Hello");
+
+    ecs_remove(world, e, Label);
+    test_assert(!ecs_has_id(world, e, value));
+
+    ecs_fini(world);
+}
+
+void SoA_member_eq_soa_member(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    ECS_COMPONENT(world, Movement);
+
+    ecs_struct(world, {
+        .entity = ecs_id(Movement),
+        .members = {
+            { "value", ecs_id(ecs_entity_t) }
+        }
+    });
+
+    ecs_add_id(world, ecs_id(Movement), EcsSoA);
+
+    ecs_entity_t Running = ecs_entity(world, { .name = "Running" });
+    ecs_entity_t Walking = ecs_entity(world, { .name = "Walking" });
+
+    ecs_entity_t value = ecs_lookup(world, "Movement.value");
+    test_assert(value != 0);
+
+    ecs_entity_t e1 = ecs_new_w(world, Movement);
+    ecs_entity_t e2 = ecs_new_w(world, Movement);
+    ecs_entity_t e3 = ecs_new_w(world, Movement);
+    ecs_set_id(world, e1, value, sizeof(ecs_entity_t), &Running);
+    ecs_set_id(world, e2, value, sizeof(ecs_entity_t), &Walking);
+    ecs_set_id(world, e3, value, sizeof(ecs_entity_t), &Running);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "(Movement.value, Running)"
+    });
+    test_assert(q != NULL);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e1, it.entities[0]);
+    test_bool(true, ecs_query_next(&it));
+    test_int(1, it.count);
+    test_uint(e3, it.entities[0]);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void SoA_add_soa_to_used_component(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    ECS_COMPONENT(world, Particle);
+
+    ecs_struct(world, {
+        .entity = ecs_id(Particle),
+        .members = {
+            { "x", ecs_id(ecs_f32_t) },
+            { "y", ecs_id(ecs_f32_t) },
+            { "mass", ecs_id(ecs_f64_t) }
+        }
+    });
+
+    ecs_new_w(world, Particle);
+
+    test_expect_abort();
+    ecs_add_id(world, ecs_id(Particle), EcsSoA);
+}
+
+void SoA_set_soa_component(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    ecs_entity_t e = ecs_new(world);
+
+    test_expect_abort();
+    ecs_set(world, e, Particle, {1, 2, 3});
+}
+
+void SoA_ensure_soa_component(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    ecs_entity_t e = ecs_new(world);
+
+    test_expect_abort();
+    ecs_ensure(world, e, Particle);
+}
+
+void SoA_get_mut_soa_component(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    ECS_IMPORT(world, FlecsMeta);
+
+    register_particle(world);
+
+    ecs_entity_t e = ecs_new_w(world, Particle);
+
+    test_expect_abort();
+    ecs_get_mut(world, e, Particle);
+}
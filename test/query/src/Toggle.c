@@ -6241,3 +6241,386 @@ void Toggle_this_toggle_after_or_chain(void) {
 
     ecs_fini(world);
 }
+
+void Toggle_dense_has_can_toggle(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    test_assert(ecs_has_id(world, ecs_id(Position), EcsCanToggle));
+
+    ecs_entity_t e = ecs_insert(world, ecs_value(Position, {10, 20}));
+    ecs_enable_component(world, e, Position, false);
+    test_bool(ecs_is_enabled(world, e, Position), false);
+    ecs_enable_component(world, e, Position, true);
+    test_bool(ecs_is_enabled(world, e, Position), true);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_enabled(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    ecs_entity_t e[8];
+    int i;
+    for (i = 0; i < 8; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {i, i * 2}));
+        ecs_enable_component(world, e[i], Position, true);
+    }
+
+    ecs_enable_component(world, e[1], Position, false);
+    ecs_enable_component(world, e[4], Position, false);
+    ecs_enable_component(world, e[6], Position, false);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    /* Enabled entities are returned as a single result */
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 5);
+
+    bool found[8] = {0};
+    Position *p = ecs_field(&it, Position, 0);
+    for (i = 0; i < it.count; i ++) {
+        int32_t index = (int32_t)p[i].x;
+        test_assert(index >= 0 && index < 8);
+        test_uint(it.entities[i], e[index]);
+        test_int(p[i].y, index * 2);
+        found[index] = true;
+    }
+    test_bool(false, ecs_query_next(&it));
+
+    for (i = 0; i < 8; i ++) {
+        test_bool(found[i], i != 1 && i != 4 && i != 6);
+        test_bool(ecs_is_enabled(world, e[i], Position), found[i]);
+        const Position *ptr = ecs_get(world, e[i], Position);
+        test_int(ptr->x, i);
+        test_int(ptr->y, i * 2);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_disabled(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_add_id(world, ecs_id(Velocity), EcsDenseToggle);
+
+    ecs_entity_t e1 = ecs_insert(world, 
+        ecs_value(Position, {1, 2}), ecs_value(Velocity, {1, 1}));
+    ecs_entity_t e2 = ecs_insert(world, 
+        ecs_value(Position, {2, 3}), ecs_value(Velocity, {2, 2}));
+    ecs_entity_t e3 = ecs_insert(world, 
+        ecs_value(Position, {3, 4}), ecs_value(Velocity, {3, 3}));
+
+    ecs_enable_component(world, e1, Velocity, true);
+    ecs_enable_component(world, e2, Velocity, false);
+    ecs_enable_component(world, e3, Velocity, true);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, !Velocity",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e2);
+    test_bool(false, ecs_field_is_set(&it, 1));
+    Position *p = ecs_field(&it, Position, 0);
+    test_int(p[0].x, 2);
+    test_int(p[0].y, 3);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_enable_component(world, e1, Velocity, false);
+
+    it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 2);
+    test_assert(it.entities[0] == e1 || it.entities[1] == e1);
+    test_assert(it.entities[0] == e2 || it.entities[1] == e2);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_w_bitset_toggle(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+    ecs_add_id(world, ecs_id(Velocity), EcsCanToggle);
+
+    ecs_entity_t e1 = ecs_insert(world, 
+        ecs_value(Position, {1, 2}), ecs_value(Velocity, {1, 1}));
+    ecs_entity_t e2 = ecs_insert(world, 
+        ecs_value(Position, {2, 3}), ecs_value(Velocity, {2, 2}));
+    ecs_entity_t e3 = ecs_insert(world, 
+        ecs_value(Position, {3, 4}), ecs_value(Velocity, {3, 3}));
+
+    ecs_enable_component(world, e1, Position, true);
+    ecs_enable_component(world, e2, Position, false);
+    ecs_enable_component(world, e3, Position, true);
+    ecs_enable_component(world, e1, Velocity, false);
+    ecs_enable_component(world, e2, Velocity, true);
+    ecs_enable_component(world, e3, Velocity, true);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, Velocity",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e3);
+    Position *p = ecs_field(&it, Position, 0);
+    Velocity *v = ecs_field(&it, Velocity, 1);
+    test_int(p[0].x, 3);
+    test_int(v[0].x, 3);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_delete_enabled(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    ecs_entity_t e[4];
+    int i;
+    for (i = 0; i < 4; i ++) {
+        e[i] = ecs_insert(world, ecs_value(Position, {i, i}));
+        ecs_enable_component(world, e[i], Position, i != 3);
+    }
+
+    ecs_delete(world, e[0]);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 2);
+    test_assert(it.entities[0] == e[1] || it.entities[1] == e[1]);
+    test_assert(it.entities[0] == e[2] || it.entities[1] == e[2]);
+    test_bool(false, ecs_query_next(&it));
+
+    test_bool(ecs_is_enabled(world, e[3], Position), false);
+    for (i = 1; i < 4; i ++) {
+        const Position *p = ecs_get(world, e[i], Position);
+        test_int(p->x, i);
+    }
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_move_enabled(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {1, 1}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {2, 2}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {3, 3}));
+    ecs_add(world, e3, Tag);
+
+    ecs_enable_component(world, e1, Position, true);
+    ecs_enable_component(world, e2, Position, false);
+    ecs_enable_component(world, e3, Position, false);
+
+    /* Enabled entity moves to table with disabled entity */
+    ecs_add(world, e1, Tag);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position, Tag",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e1);
+    Position *p = ecs_field(&it, Position, 0);
+    test_int(p[0].x, 1);
+    test_bool(false, ecs_query_next(&it));
+
+    test_bool(ecs_is_enabled(world, e1, Position), true);
+    test_bool(ecs_is_enabled(world, e2, Position), false);
+    test_bool(ecs_is_enabled(world, e3, Position), false);
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_merge_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {1, 1}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {2, 2}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {3, 3}));
+    ecs_entity_t e4 = ecs_insert(world, ecs_value(Position, {4, 4}));
+    ecs_add(world, e3, Tag);
+    ecs_add(world, e4, Tag);
+
+    ecs_enable_component(world, e1, Position, false);
+    ecs_enable_component(world, e2, Position, false);
+    ecs_enable_component(world, e3, Position, true);
+    ecs_enable_component(world, e4, Position, false);
+
+    /* Merges table with Tag into table without Tag */
+    ecs_delete(world, Tag);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e3);
+    Position *p = ecs_field(&it, Position, 0);
+    test_int(p[0].x, 3);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_sort(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {3, 2}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {2, 2}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {1, 2}));
+    ecs_entity_t e4 = ecs_insert(world, ecs_value(Position, {0, 2}));
+
+    ecs_enable_component(world, e1, Position, true);
+    ecs_enable_component(world, e2, Position, true);
+    ecs_enable_component(world, e3, Position, false);
+    ecs_enable_component(world, e4, Position, false);
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .order_by = ecs_id(Position),
+        .order_by_callback = compare_position,
+        .cache_kind = cache_kind
+    });
+
+    /* Sorting breaks up the partition, rows are evaluated with bitset */
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_assert(ecs_query_next(&it));
+    test_int(it.count, 2);
+    test_assert(it.entities[0] == e2);
+    test_assert(it.entities[1] == e1);
+    test_assert(!ecs_query_next(&it));
+
+    /* Toggling partitions the table again */
+    ecs_enable_component(world, e3, Position, true);
+
+    ecs_query_t *q_unsorted = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    it = ecs_query_iter(world, q_unsorted);
+    test_assert(ecs_query_next(&it));
+    test_int(it.count, 3);
+    test_assert(!ecs_query_next(&it));
+
+    it = ecs_query_iter(world, q);
+    test_assert(ecs_query_next(&it));
+    test_int(it.count, 3);
+    test_assert(it.entities[0] == e3);
+    test_assert(it.entities[1] == e2);
+    test_assert(it.entities[2] == e1);
+    test_assert(!ecs_query_next(&it));
+
+    test_bool(ecs_is_enabled(world, e4, Position), false);
+
+    ecs_query_fini(q);
+    ecs_query_fini(q_unsorted);
+
+    ecs_fini(world);
+}
+
+void Toggle_dense_this_deferred(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_add_id(world, ecs_id(Position), EcsDenseToggle);
+
+    ecs_entity_t e1 = ecs_insert(world, ecs_value(Position, {1, 1}));
+    ecs_entity_t e2 = ecs_insert(world, ecs_value(Position, {2, 2}));
+    ecs_entity_t e3 = ecs_insert(world, ecs_value(Position, {3, 3}));
+
+    ecs_query_t *q = ecs_query(world, {
+        .expr = "Position",
+        .cache_kind = cache_kind
+    });
+
+    ecs_defer_begin(world);
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            ecs_enable_component(world, it.entities[i], Position, 
+                it.entities[i] != e2);
+        }
+    }
+    ecs_defer_end(world);
+
+    it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 2);
+    test_assert(it.entities[0] == e1 || it.entities[1] == e1);
+    test_assert(it.entities[0] == e3 || it.entities[1] == e3);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_query_fini(q);
+
+    ecs_fini(world);
+}
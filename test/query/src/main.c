@@ -868,6 +868,10 @@ void Plan_up_w_custom_rel(void);
 void Plan_up_w_custom_rel_cached(void);
 void Plan_self_up_w_custom_rel(void);
 void Plan_self_up_w_custom_rel_cached(void);
+void Plan_plan_by_cost(void);
+void Plan_plan_by_cost_trivial(void);
+void Plan_plan_by_cost_w_optional(void);
+void Plan_plan_by_cost_trivial_after_change(void);
 
 // Testsuite 'Variables'
 void Variables_setup(void);
@@ -1683,6 +1687,12 @@ void Traversal_this_or_w_self_up_childof_w_tag(void);
 void Traversal_this_written_or_w_self_up_childof(void);
 void Traversal_up_w_isa_component_recycled(void);
 void Traversal_up_after_pair_target_delete(void);
+void Traversal_up_after_parent_add(void);
+void Traversal_up_after_parent_remove(void);
+void Traversal_up_after_reparent(void);
+void Traversal_up_after_reparent_non_fragmenting(void);
+void Traversal_up_after_base_remove(void);
+void Traversal_up_after_source_delete(void);
 
 // Testsuite 'Cascade'
 void Cascade_parent_cascade(void);
@@ -1722,6 +1732,11 @@ void Cascade_parent_component_n_parents_for_depth_after_query(void);
 void Cascade_cascade_optional_change_detection_after_remove(void);
 void Cascade_two_cascade_terms(void);
 void Cascade_cascade_in_or_chain(void);
+void Cascade_propagate_3_levels(void);
+void Cascade_propagate_w_change_detection(void);
+void Cascade_propagate_non_fragmenting(void);
+void Cascade_propagate_non_fragmenting_w_change_detection(void);
+void Cascade_propagate_no_cascade(void);
 
 // Testsuite 'Cached'
 void Cached_fixed_src_wildcard_before_cache(void);
@@ -2230,6 +2245,15 @@ void Toggle_toggle_0_src_only_term(void);
 void Toggle_toggle_0_src(void);
 void Toggle_remove_toggle_from_table_w_other_toggle_and_entity(void);
 void Toggle_this_toggle_after_or_chain(void);
+void Toggle_dense_has_can_toggle(void);
+void Toggle_dense_this_enabled(void);
+void Toggle_dense_this_disabled(void);
+void Toggle_dense_this_w_bitset_toggle(void);
+void Toggle_dense_this_delete_enabled(void);
+void Toggle_dense_this_move_enabled(void);
+void Toggle_dense_this_merge_tables(void);
+void Toggle_dense_this_sort(void);
+void Toggle_dense_this_deferred(void);
 
 // Testsuite 'Sparse'
 void Sparse_setup(void);
@@ -2410,6 +2434,8 @@ void DontFragment_1_sparse_written_up_w_non_fragmenting_childof(void);
 void DontFragment_1_sparse_written_self_up_w_non_fragmenting_childof(void);
 void DontFragment_src_var_w_trait_on_dont_fragment_tag(void);
 void DontFragment_src_var_w_trait_on_dont_fragment_tag_anonymous(void);
+void DontFragment_trivial_sparse_worker_iter_split(void);
+void DontFragment_trivial_sparse_dynamic_worker_iter(void);
 
 // Testsuite 'NonFragmentingChildOf'
 void NonFragmentingChildOf_setup(void);
@@ -2786,6 +2812,10 @@ void OrderBy_order_empty_table_only_2_tables(void);
 void OrderBy_sort_w_or_term_before_order_by_term(void);
 void OrderBy_sort_after_set_shared_component(void);
 void OrderBy_sort_w_scope_term(void);
+void OrderBy_sort_after_set_few_rows(void);
+void OrderBy_sort_after_set_all_rows(void);
+void OrderBy_sort_after_add_to_sorted_table(void);
+void OrderBy_sort_many_tables(void);
 
 // Testsuite 'OrderByEntireTable'
 void OrderByEntireTable_sort_by_component(void);
@@ -2885,6 +2915,22 @@ void QueryStr_pred_neq_m(void);
 void QueryStr_not_childof_any(void);
 void QueryStr_childof_0(void);
 
+// Testsuite 'SoA'
+void SoA_soa_members_are_components(void);
+void SoA_add_soa_component(void);
+void SoA_remove_soa_component(void);
+void SoA_remove_soa_component_w_with(void);
+void SoA_query_member_field(void);
+void SoA_query_member_and_soa_component(void);
+void SoA_member_entities_created(void);
+void SoA_soa_before_members(void);
+void SoA_member_w_string(void);
+void SoA_member_eq_soa_member(void);
+void SoA_add_soa_to_used_component(void);
+void SoA_set_soa_component(void);
+void SoA_ensure_soa_component(void);
+void SoA_get_mut_soa_component(void);
+
 bake_test_case Validator_testcases[] = {
     {
         "validate_1_term",
@@ -6284,6 +6330,22 @@ bake_test_case Plan_testcases[] = {
     {
         "self_up_w_custom_rel_cached",
         Plan_self_up_w_custom_rel_cached
+    },
+    {
+        "plan_by_cost",
+        Plan_plan_by_cost
+    },
+    {
+        "plan_by_cost_trivial",
+        Plan_plan_by_cost_trivial
+    },
+    {
+        "plan_by_cost_w_optional",
+        Plan_plan_by_cost_w_optional
+    },
+    {
+        "plan_by_cost_trivial_after_change",
+        Plan_plan_by_cost_trivial_after_change
     }
 };
 
@@ -9489,6 +9551,30 @@ bake_test_case Traversal_testcases[] = {
     {
         "up_after_pair_target_delete",
         Traversal_up_after_pair_target_delete
+    },
+    {
+        "up_after_parent_add",
+        Traversal_up_after_parent_add
+    },
+    {
+        "up_after_parent_remove",
+        Traversal_up_after_parent_remove
+    },
+    {
+        "up_after_reparent",
+        Traversal_up_after_reparent
+    },
+    {
+        "up_after_reparent_non_fragmenting",
+        Traversal_up_after_reparent_non_fragmenting
+    },
+    {
+        "up_after_base_remove",
+        Traversal_up_after_base_remove
+    },
+    {
+        "up_after_source_delete",
+        Traversal_up_after_source_delete
     }
 };
 
@@ -9640,6 +9726,26 @@ bake_test_case Cascade_testcases[] = {
     {
         "cascade_in_or_chain",
         Cascade_cascade_in_or_chain
+    },
+    {
+        "propagate_3_levels",
+        Cascade_propagate_3_levels
+    },
+    {
+        "propagate_w_change_detection",
+        Cascade_propagate_w_change_detection
+    },
+    {
+        "propagate_non_fragmenting",
+        Cascade_propagate_non_fragmenting
+    },
+    {
+        "propagate_non_fragmenting_w_change_detection",
+        Cascade_propagate_non_fragmenting_w_change_detection
+    },
+    {
+        "propagate_no_cascade",
+        Cascade_propagate_no_cascade
     }
 };
 
@@ -11639,6 +11745,42 @@ bake_test_case Toggle_testcases[] = {
     {
         "this_toggle_after_or_chain",
         Toggle_this_toggle_after_or_chain
+    },
+    {
+        "dense_has_can_toggle",
+        Toggle_dense_has_can_toggle
+    },
+    {
+        "dense_this_enabled",
+        Toggle_dense_this_enabled
+    },
+    {
+        "dense_this_disabled",
+        Toggle_dense_this_disabled
+    },
+    {
+        "dense_this_w_bitset_toggle",
+        Toggle_dense_this_w_bitset_toggle
+    },
+    {
+        "dense_this_delete_enabled",
+        Toggle_dense_this_delete_enabled
+    },
+    {
+        "dense_this_move_enabled",
+        Toggle_dense_this_move_enabled
+    },
+    {
+        "dense_this_merge_tables",
+        Toggle_dense_this_merge_tables
+    },
+    {
+        "dense_this_sort",
+        Toggle_dense_this_sort
+    },
+    {
+        "dense_this_deferred",
+        Toggle_dense_this_deferred
     }
 };
 
@@ -12341,6 +12483,14 @@ bake_test_case DontFragment_testcases[] = {
     {
         "src_var_w_trait_on_dont_fragment_tag_anonymous",
         DontFragment_src_var_w_trait_on_dont_fragment_tag_anonymous
+    },
+    {
+        "trivial_sparse_worker_iter_split",
+        DontFragment_trivial_sparse_worker_iter_split
+    },
+    {
+        "trivial_sparse_dynamic_worker_iter",
+        DontFragment_trivial_sparse_dynamic_worker_iter
     }
 };
 
@@ -13831,6 +13981,22 @@ bake_test_case OrderBy_testcases[] = {
     {
         "sort_w_scope_term",
         OrderBy_sort_w_scope_term
+    },
+    {
+        "sort_after_set_few_rows",
+        OrderBy_sort_after_set_few_rows
+    },
+    {
+        "sort_after_set_all_rows",
+        OrderBy_sort_after_set_all_rows
+    },
+    {
+        "sort_after_add_to_sorted_table",
+        OrderBy_sort_after_add_to_sorted_table
+    },
+    {
+        "sort_many_tables",
+        OrderBy_sort_many_tables
     }
 };
 
@@ -14211,6 +14377,65 @@ bake_test_case QueryStr_testcases[] = {
     }
 };
 
+bake_test_case SoA_testcases[] = {
+    {
+        "soa_members_are_components",
+        SoA_soa_members_are_components
+    },
+    {
+        "add_soa_component",
+        SoA_add_soa_component
+    },
+    {
+        "remove_soa_component",
+        SoA_remove_soa_component
+    },
+    {
+        "remove_soa_component_w_with",
+        SoA_remove_soa_component_w_with
+    },
+    {
+        "query_member_field",
+        SoA_query_member_field
+    },
+    {
+        "query_member_and_soa_component",
+        SoA_query_member_and_soa_component
+    },
+    {
+        "member_entities_created",
+        SoA_member_entities_created
+    },
+    {
+        "soa_before_members",
+        SoA_soa_before_members
+    },
+    {
+        "member_w_string",
+        SoA_member_w_string
+    },
+    {
+        "member_eq_soa_member",
+        SoA_member_eq_soa_member
+    },
+    {
+        "add_soa_to_used_component",
+        SoA_add_soa_to_used_component
+    },
+    {
+        "set_soa_component",
+        SoA_set_soa_component
+    },
+    {
+        "ensure_soa_component",
+        SoA_ensure_soa_component
+    },
+    {
+        "get_mut_soa_component",
+        SoA_get_mut_soa_component
+    }
+};
+
 const char* Fuzzing_cache_kind_param[] = {"default", "auto"};
 bake_test_param Fuzzing_params[] = {
     {"cache_kind", (char**)Fuzzing_cache_kind_param, 2}
@@ -14326,7 +14551,7 @@ static bake_test_suite suites[] = {
         "Plan",
         NULL,
         NULL,
-        114,
+        118,
         Plan_testcases
     },
     {
@@ -14383,7 +14608,7 @@ static bake_test_suite suites[] = {
         "Traversal",
         Traversal_setup,
         NULL,
-        185,
+        191,
         Traversal_testcases,
         1,
         Traversal_params
@@ -14392,7 +14617,7 @@ static bake_test_suite suites[] = {
         "Cascade",
         NULL,
         NULL,
-        37,
+        42,
         Cascade_testcases
     },
     {
@@ -14429,7 +14654,7 @@ static bake_test_suite suites[] = {
         "Toggle",
         Toggle_setup,
         NULL,
-        165,
+        174,
         Toggle_testcases,
         1,
         Toggle_params
@@ -14447,7 +14672,7 @@ static bake_test_suite suites[] = {
         "DontFragment",
         DontFragment_setup,
         NULL,
-        141,
+        143,
         DontFragment_testcases,
         1,
         DontFragment_params
@@ -14465,7 +14690,7 @@ static bake_test_suite suites[] = {
         "OrderBy",
         NULL,
         NULL,
-        48,
+        52,
         OrderBy_testcases
     },
     {
@@ -14488,9 +14713,16 @@ static bake_test_suite suites[] = {
         NULL,
         35,
         QueryStr_testcases
+    },
+    {
+        "SoA",
+        NULL,
+        NULL,
+        14,
+        SoA_testcases
     }
 };
 
 int main(int argc, char *argv[]) {
-    return bake_test_run("query", argc, argv, suites, 26);
+    return bake_test_run("query", argc, argv, suites, 27);
 }